@@ -219,7 +219,16 @@ enum KmeansFlags {
         user-supplied labels instead of computing them from the initial centers. For the second and
         further attempts, use the random or semi-random centers. Use one of KMEANS_\*_CENTERS flag
         to specify the exact method.*/
-    KMEANS_USE_INITIAL_LABELS = 1
+    KMEANS_USE_INITIAL_LABELS = 1,
+    /** Use scalable k-means++ (k-means||) center initialization by Bahmani et al. [Bahmani2012].
+        It makes a few passes over the data instead of K passes of k-means++, so it is much faster
+        for the big number of clusters.*/
+    KMEANS_PARALLEL_CENTERS   = 4,
+    /** Update the centers by the random batches of samples (mini-batch k-means by Sculley [Sculley2010])
+        instead of the whole data on each iteration. The batch size is 1024 samples by default (it can be
+        changed by OPENCV_KMEANS_MINI_BATCH_SIZE configuration parameter), the iterations are limited by
+        criteria.maxCount only. Some clusters may be empty in the end.*/
+    KMEANS_MINI_BATCH         = 8
 };
 
 //! @} core_cluster
@@ -1087,6 +1096,41 @@ and the rows and cols are switched for ROTATE_90_CLOCKWISE and ROTATE_90_COUNTER
 */
 CV_EXPORTS_W void rotate(InputArray src, OutputArray dst, int rotateCode);
 
+//! Flags for cv::reorderImage
+enum ReorderFlags {
+    REORDER_FLIP_VERTICAL   = 1, //!< flip around the x-axis (after the transposition)
+    REORDER_FLIP_HORIZONTAL = 2, //!< flip around the y-axis (after the transposition)
+    REORDER_TRANSPOSE       = 4, //!< swap the rows and the columns
+    REORDER_ROTATE_90_CLOCKWISE        = REORDER_TRANSPOSE | REORDER_FLIP_HORIZONTAL, //!< same as ROTATE_90_CLOCKWISE
+    REORDER_ROTATE_180                 = REORDER_FLIP_VERTICAL | REORDER_FLIP_HORIZONTAL, //!< same as ROTATE_180
+    REORDER_ROTATE_90_COUNTERCLOCKWISE = REORDER_TRANSPOSE | REORDER_FLIP_VERTICAL, //!< same as ROTATE_90_COUNTERCLOCKWISE
+    REORDER_TO_PLANAR       = 8, //!< the output is a planar 1 x C x H x W blob (HWC -> CHW)
+    REORDER_FROM_PLANAR     = 16 //!< the input is a planar C x H x W (or 1 x C x H x W) array (CHW -> HWC)
+};
+
+/** @brief Transposes, flips or rotates the image, reorders its channels and changes its layout in one pass.
+
+The function combines cv::transpose, cv::flip, cv::rotate, cv::mixChannels and the conversion between
+the interleaved (HWC) and the planar (CHW) layouts, so e.g. the typical DNN preprocessing (rotation,
+BGR to RGB and HWC to NCHW) is done by a single pass over the data:
+@code
+    Mat blob;
+    reorderImage(frame, blob, REORDER_ROTATE_90_CLOCKWISE | REORDER_TO_PLANAR, {2, 1, 0});
+@endcode
+The image is processed by cache-sized tiles in parallel.
+@param src input image; a 2D array or, with #REORDER_FROM_PLANAR, a single-channel C x H x W
+or 1 x C x H x W array.
+@param dst output image of the same depth as src; with #REORDER_TO_PLANAR it is a 4D 1 x C x H x W
+array, where C is the number of the output channels. Preallocated output (e.g. a slice of a batch blob)
+is filled in place.
+@param flags combination of #ReorderFlags. The transposition is applied first, then the flips.
+@param channelOrder indices of the source channels for every output channel (the channels may be
+repeated or dropped), empty vector means the original order.
+@sa transpose, flip, rotate, mixChannels, transposeND
+*/
+CV_EXPORTS_W void reorderImage(InputArray src, OutputArray dst, int flags,
+                               const std::vector<int>& channelOrder = std::vector<int>());
+
 /** @brief Fills the output array with repeated copies of the input array.
 
 The function cv::repeat duplicates the input array one or more times along each of the two axes:
@@ -1706,6 +1750,17 @@ should be done separately if needed.
 */
 CV_EXPORTS_W void transpose(InputArray src, OutputArray dst);
 
+/** @brief Transpose for n-dimensional matrices.
+
+The function permutes the dimensions of the array, e.g. order {0, 2, 3, 1} converts a NCHW blob
+to NHWC and order {0, 3, 1, 2} converts it back. The array is processed by cache-sized tiles in parallel.
+@param src input array.
+@param order a permutation of [0,1,..,N-1] where N is the number of axes of src.
+The i'th axis of dst will correspond to the axis numbered order[i] of the input.
+@param dst output array of the same type as src.
+*/
+CV_EXPORTS_W void transposeND(InputArray src, const std::vector<int>& order, OutputArray dst);
+
 /** @brief Performs the matrix transformation of every array element.
 
 The function cv::transform performs the matrix transformation of every
@@ -1868,6 +1923,48 @@ will not do the work. Use SVD::solveZ instead.
 CV_EXPORTS_W bool solve(InputArray src1, InputArray src2,
                         OutputArray dst, int flags = DECOMP_LU);
 
+/** @brief Solves a batch of small linear systems.
+
+The function solves the independent systems \f$\texttt{src1}_i \cdot \texttt{dst}_i = \texttt{src2}_i\f$,
+i = 0..N-1, as cv::solve would do for each of them. The batch may be passed as:
+-   a 3D matrix of N x rows x cols size;
+-   a vector of N matrices (e.g. std::vector<Mat>) of the same size;
+-   a vector of N fixed-size matrices, e.g. std::vector<Matx33f>, which is seen as the N x 1
+    multi-channel matrix (the left-hand side matrices must be square then, the number of rows
+    of the right-hand side matrices is taken from them).
+
+For #DECOMP_LU and #DECOMP_CHOLESKY methods and square src1 matrices several systems are
+solved at once by the vectorized code, with the fixed-size code paths for up to 6x6 matrices.
+Other methods process the matrices one by one (in parallel).
+
+@param src1 batch of the left-hand side matrices, CV_32F or CV_64F.
+@param src2 batch of the right-hand side matrices of the same type and batch size.
+@param dst output batch of the solutions, it has the same layout as src2.
+@param status optional output vector of N CV_8U elements: 1 if the i-th system is solved, 0 if the
+matrix is singular (for #DECOMP_LU and #DECOMP_CHOLESKY methods; the solution is set to zero then).
+@param flags solution method (#DecompTypes)
+@return true if all the systems are solved.
+@sa solve, invertBatch
+*/
+CV_EXPORTS_W bool solveBatch(InputArray src1, InputArray src2, OutputArray dst,
+                             OutputArray status = noArray(), int flags = DECOMP_LU);
+
+/** @brief Inverts a batch of small matrices.
+
+The function inverts each matrix of the batch as cv::invert would do. See cv::solveBatch for the
+supported batch layouts and the notes on performance.
+
+@param src batch of the input matrices, CV_32F or CV_64F.
+@param dst output batch of the inverse (or pseudo-inverse) matrices, it has the same layout as src.
+@param status optional output vector of N CV_8U elements: 1 if the i-th matrix is inverted, 0 if
+it is singular (for #DECOMP_LU and #DECOMP_CHOLESKY methods; the result is set to zero then).
+@param flags inversion method (#DecompTypes)
+@return true if all the matrices are inverted.
+@sa invert, solveBatch
+*/
+CV_EXPORTS_W bool invertBatch(InputArray src, OutputArray dst,
+                              OutputArray status = noArray(), int flags = DECOMP_LU);
+
 /** @brief Sorts each row or each column of a matrix.
 
 The function cv::sort sorts each matrix row or each matrix column in
@@ -2023,6 +2120,14 @@ CV_EXPORTS_W void PCABackProject(InputArray data, InputArray mean,
 /** wrap SVD::compute */
 CV_EXPORTS_W void SVDecomp( InputArray src, OutputArray w, OutputArray u, OutputArray vt, int flags = 0 );
 
+/** @brief Computes SVD of each matrix of the batch.
+
+See cv::solveBatch for the supported batch layouts. The outputs have the same layout as src, e.g.
+for the vector of Matx33f the output w is the vector of Matx31f.
+@sa SVDecomp, SVD::compute
+*/
+CV_EXPORTS_W void SVDecompBatch( InputArray src, OutputArray w, OutputArray u, OutputArray vt, int flags = 0 );
+
 /** wrap SVD::backSubst */
 CV_EXPORTS_W void SVBackSubst( InputArray w, InputArray u, InputArray vt,
                                InputArray rhs, OutputArray dst );
@@ -2990,6 +3095,10 @@ Examples of this array can be:
 -   Mat points(count, 1, CV_32FC2);
 -   Mat points(1, count, CV_32FC2);
 -   std::vector\<cv::Point2f\> points(sampleCount);
+
+The data can also be a matrix of binary descriptors (CV_8U, one descriptor per row, e.g. ORB
+descriptors). In this case the Hamming distance is used, the centers are the bitwise majority of the
+cluster samples and the compactness is the sum of the Hamming distances to the centers.
 @param K Number of clusters to split the set by.
 @param bestLabels Input/output integer array that stores the cluster indices for every sample.
 @param criteria The algorithm termination criteria, that is, the maximum number of iterations and/or
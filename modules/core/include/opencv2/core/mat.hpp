@@ -2119,6 +2119,12 @@ public:
     static MatAllocator* getStdAllocator();
     static MatAllocator* getDefaultAllocator();
     static void setDefaultAllocator(MatAllocator* allocator);
+    /** @brief Returns allocator which keeps released buffers in per-thread caches (grouped by size classes).
+
+    Use it via setDefaultAllocator() or `OPENCV_MAT_ALLOCATOR=pool` environment variable.
+    @sa cv::utils::getMatPoolStatistics(), cv::utils::trimMatPool()
+    */
+    static MatAllocator* getPoolAllocator();
 
     //! internal use method: updates the continuity flag
     void updateContinuityFlag();
@@ -3531,6 +3537,12 @@ real-valued scalar ( double )):
 -   Matrix initializers ( Mat::eye(), Mat::zeros(), Mat::ones() ), matrix comma-separated
     initializers, matrix constructors and operators that extract sub-matrices (see Mat description).
 -   Mat_<destination_type>() constructors to cast the result to the proper type.
+
+Chains of the element-wise operations (arithmetics, scaling, scalars, comparisons, minimum, maximum
+and absolute value), e.g. `(A*0.5 + B*0.25 - C).mul(D)`, are not evaluated operation by operation:
+they are fused and computed in a single parallel pass over the data without intermediate matrices.
+The intermediate results are still rounded and saturated to the depth of the operands, as in the
+step-by-step evaluation.
 @note Comma-separated initializers and probably some other operations may require additional
 explicit Mat() or Mat_<T>() constructor calls to resolve a possible ambiguity.
 
@@ -316,9 +316,24 @@ public:
         FORMAT_XML  = (1<<3), //!< flag, XML format
         FORMAT_YAML = (2<<3), //!< flag, YAML format
         FORMAT_JSON = (3<<3), //!< flag, JSON format
+        FORMAT_BINARY = (4<<3), //!< flag, binary format. Arrays written by FileStorage::writeRaw() (e.g. data of Mat)
+        //!< are aligned in the file, so they are read from the mapped file without parsing (see also
+        //!< FileStorage::MAP_DATA). Only files are supported (no FileStorage::MEMORY, FileStorage::APPEND and compression).
 
         BASE64      = 64,     //!< flag, write rawdata in Base64 by default. (consider using WRITE_BASE64)
         WRITE_BASE64 = BASE64 | WRITE, //!< flag, enable both WRITE and BASE64
+        LAZY        = 128,    //!< flag, read mode only: memory-map the file, index its top-level nodes and
+        //!< parse each of them on the first access. Base64 data is decoded directly into the destination
+        //!< by FileNode::readRaw() (or Mat / std::vector readers), the nodes of the elements of such sequences
+        //!< are created on the first access to an element (FileNode::operator[](int), FileNodeIterator).
+        //!< As the nodes are parsed on access, the storage must not be read from several threads at once.
+        //!< Ignored for compressed files and FileStorage::MEMORY mode.
+        MAP_DATA    = 256,    //!< flag, read mode only, FileStorage::FORMAT_BINARY files: the matrices read from the
+        //!< storage (FileNode >> Mat) refer to the mapped file data instead of owning a copy of it. The mapping
+        //!< is private and kept while such matrices exist, so the file is never modified, but all the matrices
+        //!< read from the same node share the data: a modification of one of them is seen by the others.
+        //!< Matrices that are already allocated with the right size and type are still filled in place.
+        //!< Ignored if the file can't be mapped.
     };
     enum State
     {
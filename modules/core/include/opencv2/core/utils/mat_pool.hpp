@@ -0,0 +1,48 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#ifndef OPENCV_CORE_UTILS_MAT_POOL_HPP
+#define OPENCV_CORE_UTILS_MAT_POOL_HPP
+
+#include "../cvdef.h"
+
+namespace cv { namespace utils {
+
+//! @addtogroup core_utils
+//! @{
+
+/** @brief Counters of the pooling Mat allocator (see Mat::getPoolAllocator())
+
+Values are accumulated over all threads which have used the allocator.
+*/
+struct MatPoolStatistics
+{
+    uint64_t hits;          //!< allocations served from a thread cache
+    uint64_t misses;        //!< allocations which have fallen back to fastMalloc()
+    size_t residentBytes;   //!< memory kept in thread caches (free buffers only)
+    size_t residentBuffers; //!< number of free buffers kept in thread caches
+};
+
+/** @brief Returns current counters of the pooling Mat allocator */
+CV_EXPORTS MatPoolStatistics getMatPoolStatistics();
+
+/** @brief Resets hit / miss counters of the pooling Mat allocator */
+CV_EXPORTS void resetMatPoolStatistics();
+
+/** @brief Releases cached buffers of the pooling Mat allocator
+
+@param maxResidentBytes amount of memory which each thread cache is allowed to keep after the call.
+Default value releases all cached buffers.
+
+Buffers which are currently used by Mat objects are not affected.
+Limit for future caching is controlled via `Mat::getPoolAllocator()->getBufferPoolController()`
+or `OPENCV_MAT_POOL_THREAD_LIMIT` environment variable.
+*/
+CV_EXPORTS void trimMatPool(size_t maxResidentBytes = 0);
+
+//! @}
+
+}} // namespace
+
+#endif // OPENCV_CORE_UTILS_MAT_POOL_HPP
@@ -0,0 +1,76 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#ifndef OPENCV_CORE_UTILS_THREAD_POOL_HPP
+#define OPENCV_CORE_UTILS_THREAD_POOL_HPP
+
+#include "../cvdef.h"
+#include <vector>
+
+namespace cv { namespace utils {
+
+//! @addtogroup core_utils
+//! @{
+
+/** @brief Counters of the built-in (pthreads) thread pool worker
+
+The built-in thread pool is used by parallel_for_() when OpenCV is built without TBB / OpenMP and other parallel frameworks.
+Work-stealing mode is enabled via `OPENCV_THREAD_POOL_WORK_STEALING=1` environment variable: in this mode jobs from
+several caller threads (and nested parallel_for_() calls) are processed concurrently.
+*/
+struct ThreadPoolWorkerStatistics
+{
+    int workerId;
+    uint64_t executedJobs;  //!< number of parallel_for_() jobs processed by the worker
+    uint64_t executedTasks; //!< number of loop iterations (stripes) processed by the worker
+    uint64_t stolenJobs;    //!< jobs taken from queues of other workers (work-stealing mode only)
+    double busyTime;        //!< seconds spent in job processing
+    double idleTime;        //!< seconds spent in active or passive waiting
+};
+
+/** @brief Returns counters of the built-in thread pool workers
+
+@param[out] stats counters of worker threads (the caller threads are not included)
+@return false if the built-in thread pool is not available
+*/
+CV_EXPORTS bool getThreadPoolStatistics(CV_OUT std::vector<ThreadPoolWorkerStatistics>& stats);
+
+/** @brief Resets counters of the built-in thread pool workers */
+CV_EXPORTS void resetThreadPoolStatistics();
+
+/** @brief Placement of the built-in thread pool workers */
+enum ThreadPoolAffinity
+{
+    THREAD_POOL_AFFINITY_NONE  = 0, //!< workers are scheduled by OS (default)
+    THREAD_POOL_AFFINITY_CORES = 1, //!< each worker is pinned to its own CPU (the first allowed CPU is left for the caller thread)
+    THREAD_POOL_AFFINITY_NUMA  = 2  //!< workers are split into contiguous groups per NUMA node and pinned to CPUs of their node
+};
+
+/** @brief Changes placement of the built-in thread pool workers
+
+Applied to running workers immediately. Default value is controlled via `OPENCV_THREAD_POOL_AFFINITY`
+environment variable (`none`, `cores` or `numa`). Only CPUs from the process affinity mask are used.
+@return false if thread affinity is not supported on the current platform / parallel framework
+*/
+CV_EXPORTS bool setThreadPoolAffinity(ThreadPoolAffinity affinity);
+
+/** @brief Returns current placement of the built-in thread pool workers */
+CV_EXPORTS ThreadPoolAffinity getThreadPoolAffinity();
+
+/** @brief Touches memory pages of the buffer from parallel_for_() worker threads
+
+Operating systems allocate physical pages on the NUMA node of the thread which writes them first.
+Call this for large freshly allocated buffers before processing them with parallel_for_(), so pages are
+spread over the nodes of the workers instead of the node of the allocating thread.
+Buffer content is not preserved (the first byte of each page is overwritten).
+
+Mat allocators call this automatically for buffers larger than `OPENCV_MAT_FIRST_TOUCH_THRESHOLD` bytes (disabled by default).
+*/
+CV_EXPORTS void parallelFirstTouch(void* data, size_t size);
+
+//! @}
+
+}} // namespace
+
+#endif // OPENCV_CORE_UTILS_THREAD_POOL_HPP
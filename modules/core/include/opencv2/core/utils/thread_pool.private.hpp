@@ -0,0 +1,26 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#ifndef OPENCV_CORE_UTILS_THREAD_POOL_PRIVATE_HPP
+#define OPENCV_CORE_UTILS_THREAD_POOL_PRIVATE_HPP
+
+#include "opencv2/core/cvdef.h"
+
+namespace cv { namespace utils {
+
+/** @brief Switches the built-in thread pool between the regular and the work-stealing modes
+
+The default mode is controlled via `OPENCV_THREAD_POOL_WORK_STEALING` environment variable.
+The running workers are stopped and the next parallel_for_() call starts them in the new mode,
+so this must not be called concurrently with parallel_for_().
+@return false if the built-in thread pool is not available and the work-stealing mode is requested
+*/
+CV_EXPORTS bool setThreadPoolWorkStealing(bool enable);
+
+/** @brief Returns true if the built-in thread pool runs in the work-stealing mode */
+CV_EXPORTS bool getThreadPoolWorkStealing();
+
+}} // namespace
+
+#endif // OPENCV_CORE_UTILS_THREAD_POOL_PRIVATE_HPP
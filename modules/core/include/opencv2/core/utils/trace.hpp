@@ -7,6 +7,9 @@
 
 #include <opencv2/core/cvdef.h>
 
+#include <string>
+#include <vector>
+
 namespace cv {
 namespace utils {
 namespace trace {
@@ -32,6 +35,53 @@ namespace trace {
 //! Macro to trace argument value (expanded version)
 #define CV_TRACE_ARG_VALUE(arg_id, arg_name, value)
 
+//! Macro to account amount of processed data by the current region (aggregated statistics mode only)
+#define CV_TRACE_BYTES(bytes)
+
+/** @brief Aggregated counters of the trace region (function or named region)
+
+Counters are collected when aggregated statistics mode is enabled (see setStatisticsEnabled()).
+Time is inclusive: time of nested regions is included into the time of the parent region.
+*/
+struct TraceRegionStatistics
+{
+    std::string name;     //!< region name (function signature or CV_TRACE_REGION() name)
+    std::string filename; //!< source code filename
+    int line;             //!< source code line
+    uint64 calls;         //!< number of completed calls (summed over all threads)
+    double totalTime;     //!< total time of calls in seconds (summed over all threads)
+    double maxTime;       //!< the longest call in seconds
+    uint64 bytes;         //!< amount of data reported via CV_TRACE_BYTES() inside of the region
+};
+
+/** @brief Enables or disables aggregated statistics mode
+
+In this mode each thread accumulates call count, time and processed bytes of trace regions in own lock-free
+counters, no trace files are written. Overhead is a few timer reads per traced call.
+Mode can be switched at any moment, initial value is controlled via `OPENCV_TRACE_STATISTICS` environment variable.
+*/
+CV_EXPORTS void setStatisticsEnabled(bool enabled);
+
+/** @brief Returns true if aggregated statistics mode is enabled */
+CV_EXPORTS bool isStatisticsEnabled();
+
+/** @brief Returns aggregated counters of trace regions
+
+@param[out] stats regions with non-zero calls, sorted by total time (descending)
+*/
+CV_EXPORTS void getStatistics(CV_OUT std::vector<TraceRegionStatistics>& stats);
+
+/** @brief Resets aggregated counters of all threads */
+CV_EXPORTS void resetStatistics();
+
+/** @brief Writes the latest completed regions in Chrome trace event format (JSON)
+
+The file can be opened by chrome://tracing or https://ui.perfetto.dev.
+Each thread keeps `OPENCV_TRACE_STATISTICS_EVENTS` last regions (disabled by default, aggregated counters are written in any case).
+@return false if file can't be written or trace support is not available
+*/
+CV_EXPORTS bool writeChromeTrace(const std::string& filename);
+
 //! @cond IGNORED
 #define CV_TRACE_NS cv::utils::trace
 
@@ -136,6 +186,11 @@ CV_EXPORTS void traceArg(const TraceArg& arg, int64 value);
 //! @overload
 CV_EXPORTS void traceArg(const TraceArg& arg, double value);
 
+/** @brief Add amount of processed data to the current region (aggregated statistics mode)
+ * See CV_TRACE_BYTES macro
+ */
+CV_EXPORTS void traceBytes(size_t bytes);
+
 #define CV__TRACE_LOCATION_VARNAME(loc_id) CVAUX_CONCAT(CVAUX_CONCAT(__cv_trace_location_, loc_id), __LINE__)
 #define CV__TRACE_LOCATION_EXTRA_VARNAME(loc_id) CVAUX_CONCAT(CVAUX_CONCAT(__cv_trace_location_extra_, loc_id) , __LINE__)
 
@@ -227,6 +282,9 @@ CV_EXPORTS void traceArg(const TraceArg& arg, double value);
 #undef CV_TRACE_ARG
 #define CV_TRACE_ARG CV__TRACE_ARG
 
+#undef CV_TRACE_BYTES
+#define CV_TRACE_BYTES(bytes) CV_TRACE_NS::details::traceBytes((size_t)(bytes))
+
 #endif // OPENCV_DISABLE_TRACE
 
 #ifdef OPENCV_TRACE_VERBOSE
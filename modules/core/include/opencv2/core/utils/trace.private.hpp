@@ -15,6 +15,7 @@
 
 //! @cond IGNORED
 
+#include <atomic>
 #include <deque>
 #include <ostream>
 
@@ -53,6 +54,7 @@ namespace details {
 enum RegionFlag {
     REGION_FLAG__NEED_STACK_POP = (1 << 0),
     REGION_FLAG__ACTIVE = (1 << 1),
+    REGION_FLAG__STATISTICS = (1 << 2),  // region is accounted by aggregated statistics
 
     ENUM_REGION_FLAG_IMPL_FORCE_INT = INT_MAX
 };
@@ -231,6 +233,71 @@ std::ostream& operator<<(std::ostream& out, const RegionStatisticsStatus& s)
     return out;
 }
 
+//! Aggregated counters of the region location. Updated by the owner thread only (without RMW operations)
+struct RegionCounters
+{
+    std::atomic<uint64> calls;
+    std::atomic<int64> totalTicks;
+    std::atomic<int64> maxTicks;
+    std::atomic<uint64> bytes;
+
+    RegionCounters() : calls(0), totalTicks(0), maxTicks(0), bytes(0) {}
+
+    void reset()
+    {
+        calls.store(0, std::memory_order_relaxed);
+        totalTicks.store(0, std::memory_order_relaxed);
+        maxTicks.store(0, std::memory_order_relaxed);
+        bytes.store(0, std::memory_order_relaxed);
+    }
+};
+
+//! Completed region for timeline export (ring buffer entry)
+struct RegionEvent
+{
+    std::atomic<int64> beginTicks;
+    std::atomic<int64> durationTicks;
+    std::atomic<int> locationId;
+
+    RegionEvent() : beginTicks(0), durationTicks(0), locationId(0) {}
+};
+
+//! Aggregated statistics of the local thread (lock-free for the owner thread)
+struct RegionStatisticsThreadLocal
+{
+    enum {
+        BLOCK_SIZE = 256,   // counters are allocated by blocks, indexed by global_location_id
+        MAX_BLOCKS = 256,
+        MAX_DEPTH = 64      // deeper regions are not accounted
+    };
+
+    struct StackEntry
+    {
+        Region* region;
+        RegionCounters* counters;
+        int64 beginTicks;
+        int locationId;
+        int flags;
+    };
+
+    std::atomic<RegionCounters*> blocks[MAX_BLOCKS];
+    std::atomic<int> epoch;  // counters are reset lazily by the owner thread, see resetStatistics()
+
+    StackEntry stack[MAX_DEPTH];
+    int depth;
+
+    RegionEvent* events;
+    size_t eventsCapacity;
+    std::atomic<uint64> eventsCount;
+
+    RegionStatisticsThreadLocal();
+    ~RegionStatisticsThreadLocal();
+
+    RegionCounters* getCounters(int locationId);
+    void reset(int newEpoch);
+    void leave(int64 endTicks);
+};
+
 //! TraceManager for local thread
 struct TraceManagerThreadLocal
 {
@@ -267,6 +334,8 @@ struct TraceManagerThreadLocal
 
     mutable cv::Ptr<TraceStorage> storage;
 
+    RegionStatisticsThreadLocal statistics;
+
     TraceManagerThreadLocal() :
         threadID(cv::utils::getThreadID()),
         region_counter(0), totalSkippedEvents(0),
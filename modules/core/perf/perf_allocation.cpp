@@ -4,6 +4,7 @@
 
 #include "perf_precomp.hpp"
 #include <array>
+#include "opencv2/core/utils/mat_pool.hpp"
 
 using namespace perf;
 
@@ -45,4 +46,30 @@ PERF_TEST_P(MatDepth_tb, DISABLED_Allocation_Aligned,
     SANITY_CHECK_NOTHING();
 }
 
+typedef perf::TestBaseWithParam<tuple<MatType, bool> > MatAllocator_tb;
+
+PERF_TEST_P(MatAllocator_tb, MatCreateRelease,
+    testing::Combine(testing::Values(CV_8UC1, CV_8UC3, CV_32FC3), testing::Bool()))
+{
+    const int matType = get<0>(GetParam());
+    const bool usePool = get<1>(GetParam());
+    MatAllocator* allocator = usePool ? Mat::getPoolAllocator() : Mat::getStdAllocator();
+
+    const std::array<cv::Size, 20> sizes{ALLOC_MAT_SIZES};
+
+    declare.iterations(100);
+
+    TEST_CYCLE()
+    {
+        for (int i = 0; i < 1000; ++i)
+        {
+            Mat m;
+            m.allocator = allocator;
+            m.create(sizes[i % sizes.size()], matType);
+        }
+    }
+    cv::utils::trimMatPool();
+    SANITY_CHECK_NOTHING();
+}
+
 };
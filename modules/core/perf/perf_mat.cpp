@@ -166,4 +166,95 @@ PERF_TEST_P(Size_MatType, Mat_Transform,
     SANITY_CHECK(dst, 1e-6, ERROR_RELATIVE);
 }
 
+///////////// MatExpr ////////////////////////
+
+PERF_TEST_P(Size_MatType, MatExpr_ElementWiseChain,
+            testing::Combine(testing::Values(TYPICAL_MAT_SIZES),
+                             testing::Values(CV_8UC1, CV_16SC1, CV_32FC1, CV_32FC3, CV_64FC1))
+            )
+{
+    Size size = get<0>(GetParam());
+    int type = get<1>(GetParam());
+    Mat a(size, type), b(size, type), c(size, type), d(size, type), dst(size, type);
+
+    declare.in(a, b, c, d, WARMUP_RNG).out(dst);
+
+    TEST_CYCLE()
+    {
+        dst = (a*0.5 + b*0.25 - c).mul(d);
+    }
+
+    SANITY_CHECK_NOTHING();
+}
+
+
+///////////// Reorder ////////////////////////
+
+PERF_TEST_P(Size_MatType, transpose,
+            testing::Combine(testing::Values(TYPICAL_MAT_SIZES, sz2160p),
+                             testing::Values(CV_8UC1, CV_8UC3, CV_16UC1, CV_32FC1, CV_32FC3))
+            )
+{
+    Size size = get<0>(GetParam());
+    int type = get<1>(GetParam());
+    Mat src(size, type), dst(size.width, size.height, type);
+
+    declare.in(src, WARMUP_RNG).out(dst);
+
+    TEST_CYCLE()
+    {
+        cv::transpose(src, dst);
+    }
+
+    SANITY_CHECK_NOTHING();
+}
+
+typedef perf::TestBaseWithParam< tuple<Size, MatType, int> > Size_MatType_ReorderFlags;
+
+PERF_TEST_P(Size_MatType_ReorderFlags, reorderImage,
+            testing::Combine(testing::Values(sz1080p, sz2160p),
+                             testing::Values(CV_8UC3, CV_32FC3),
+                             testing::Values(0, (int)REORDER_ROTATE_90_CLOCKWISE, (int)REORDER_TO_PLANAR,
+                                             (int)(REORDER_ROTATE_90_CLOCKWISE | REORDER_FLIP_VERTICAL | REORDER_TO_PLANAR)))
+            )
+{
+    Size size = get<0>(GetParam());
+    int type = get<1>(GetParam());
+    int flags = get<2>(GetParam());
+    Mat src(size, type), dst;
+    std::vector<int> order;
+    order.push_back(2); order.push_back(1); order.push_back(0);
+
+    declare.in(src, WARMUP_RNG);
+
+    TEST_CYCLE()
+    {
+        cv::reorderImage(src, dst, flags, order);
+    }
+
+    SANITY_CHECK_NOTHING();
+}
+
+PERF_TEST_P(Size_MatType, transposeND_NCHW2NHWC,
+            testing::Combine(testing::Values(szVGA, sz1080p),
+                             testing::Values(CV_8UC1, CV_32FC1))
+            )
+{
+    Size size = get<0>(GetParam());
+    int type = get<1>(GetParam());
+    const int sz[] = { 1, 3, size.height, size.width };
+    Mat src(4, sz, type), dst;
+    std::vector<int> order;
+    order.push_back(0); order.push_back(2); order.push_back(3); order.push_back(1);
+
+    declare.in(src, WARMUP_RNG);
+
+    TEST_CYCLE()
+    {
+        cv::transposeND(src, order, dst);
+    }
+
+    SANITY_CHECK_NOTHING();
+}
+
 } // namespace
@@ -36,6 +36,25 @@ PERF_TEST_P(VectorLength, phase64f, testing::Values(128, 1000, 128*1024, 512*102
     SANITY_CHECK(angle, 5e-5);
 }
 
+typedef perf::TestBaseWithParam< testing::tuple<int, int> > SolveBatch;
+
+PERF_TEST_P(SolveBatch, LU, testing::Combine(testing::Values(3, 4, 6), testing::Values(CV_32F, CV_64F)))
+{
+    const int n = testing::get<0>(GetParam());
+    const int depth = testing::get<1>(GetParam());
+    const int N = 100000;
+    int sz[] = { N, n, n }, bsz[] = { N, n, 1 };
+    Mat A(3, sz, depth), B(3, bsz, depth), X;
+    randu(A, -1, 1);
+    randu(B, -1, 1);
+    for (int i = 0; i < N; i++)
+        Mat(n, n, depth, A.ptr(i)).diag() += n;
+
+    TEST_CYCLE() cv::solveBatch(A, B, X);
+
+    SANITY_CHECK_NOTHING();
+}
+
 typedef perf::TestBaseWithParam< testing::tuple<int, int, int> > KMeans;
 
 PERF_TEST_P_(KMeans, single_iter)
@@ -159,4 +178,70 @@ INSTANTIATE_TEST_CASE_P(/*nothing*/ , KMeans,
 
 }
 
+typedef perf::TestBaseWithParam< testing::tuple<int, int, int, int> > KMeans_Init;
+
+PERF_TEST_P_(KMeans_Init, flags)
+{
+    RNG& rng = theRNG();
+    const int K = testing::get<0>(GetParam());
+    const int dims = testing::get<1>(GetParam());
+    const int N = testing::get<2>(GetParam());
+    const int flags = testing::get<3>(GetParam());
+
+    Mat data(N, dims, CV_32F);
+    rng.fill(data, RNG::UNIFORM, -1, 1);
+
+    Mat labels, centers;
+
+    TEST_CYCLE()
+    {
+        kmeans(data, K, labels, TermCriteria(TermCriteria::MAX_ITER+TermCriteria::EPS, 10, 0),
+               1, flags, centers);
+    }
+
+    SANITY_CHECK_NOTHING();
+}
+
+INSTANTIATE_TEST_CASE_P(/*nothing*/ , KMeans_Init,
+    testing::Values(
+        // K clusters, dims, N points, flags
+        testing::make_tuple(256, 32, 100000, (int)KMEANS_PP_CENTERS),
+        testing::make_tuple(256, 32, 100000, (int)KMEANS_PARALLEL_CENTERS),
+        testing::make_tuple(256, 32, 100000, (int)(KMEANS_PARALLEL_CENTERS | KMEANS_MINI_BATCH)),
+        testing::make_tuple(1000, 64, 200000, (int)KMEANS_PARALLEL_CENTERS),
+        testing::make_tuple(1000, 64, 200000, (int)(KMEANS_PARALLEL_CENTERS | KMEANS_MINI_BATCH))
+    )
+);
+
+typedef perf::TestBaseWithParam< testing::tuple<int, int, int> > KMeans_Hamming;
+
+PERF_TEST_P_(KMeans_Hamming, mini_batch)
+{
+    RNG& rng = theRNG();
+    const int K = testing::get<0>(GetParam());
+    const int dims = testing::get<1>(GetParam());
+    const int N = testing::get<2>(GetParam());
+
+    Mat data(N, dims, CV_8U);
+    rng.fill(data, RNG::UNIFORM, 0, 256);
+
+    Mat labels, centers;
+
+    TEST_CYCLE()
+    {
+        kmeans(data, K, labels, TermCriteria(TermCriteria::MAX_ITER+TermCriteria::EPS, 10, 0),
+               1, KMEANS_PARALLEL_CENTERS | KMEANS_MINI_BATCH, centers);
+    }
+
+    SANITY_CHECK_NOTHING();
+}
+
+INSTANTIATE_TEST_CASE_P(/*nothing*/ , KMeans_Hamming,
+    testing::Values(
+        // K clusters, descriptor bytes, N points
+        testing::make_tuple(256, 32, 100000),
+        testing::make_tuple(1000, 32, 200000)
+    )
+);
+
 } // namespace
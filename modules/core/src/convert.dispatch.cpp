@@ -201,6 +201,7 @@ void Mat::convertTo(OutputArray _dst, int _type, double alpha, double beta) cons
     else
         _dst.create( dims, size, _type );
     Mat dst = _dst.getMat();
+    CV_TRACE_BYTES(src.total() * src.elemSize() + dst.total() * dst.elemSize());
 
     BinaryFunc func = noScale ? getConvertFunc(sdepth, ddepth) : getConvertScaleFunc(sdepth, ddepth);
     double scale[] = {alpha, beta};
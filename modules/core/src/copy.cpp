@@ -350,6 +350,7 @@ void Mat::copyTo( OutputArray _dst ) const
         Mat dst = _dst.getMat();
         if( data == dst.data )
             return;
+        CV_TRACE_BYTES(2 * total() * elemSize());
 
         if( rows > 0 && cols > 0 )
         {
@@ -51,6 +51,21 @@ namespace cv
 {
 
 static int CV_KMEANS_PARALLEL_GRANULARITY = (int)utils::getConfigurationParameterSizeT("OPENCV_KMEANS_PARALLEL_GRANULARITY", 1000);
+static int CV_KMEANS_MINI_BATCH_SIZE = (int)utils::getConfigurationParameterSizeT("OPENCV_KMEANS_MINI_BATCH_SIZE", 1024);
+
+// squared Euclidean distance between the float vectors
+struct KMeansL2
+{
+    typedef float T;
+    static inline double dist(const float* a, const float* b, int dims) { return hal::normL2Sqr_(a, b, dims); }
+};
+
+// Hamming distance between the binary descriptors, dims is the descriptor size in bytes
+struct KMeansHamming
+{
+    typedef uchar T;
+    static inline double dist(const uchar* a, const uchar* b, int dims) { return hal::normHamming(a, b, dims); }
+};
 
 static void generateRandomCenter(int dims, const Vec2f* box, float* center, RNG& rng)
 {
@@ -59,9 +74,32 @@ static void generateRandomCenter(int dims, const Vec2f* box, float* center, RNG&
         center[j] = ((float)rng*(1.f+margin*2.f)-margin)*(box[j][1] - box[j][0]) + box[j][0];
 }
 
+static void generateRandomCenters(const KMeansL2&, const Mat& data, Mat& centers, const Vec2f* box, RNG& rng)
+{
+    for (int k = 0; k < centers.rows; k++)
+        generateRandomCenter(data.cols, box, centers.ptr<float>(k), rng);
+}
+
+// binary centers can not be interpolated, so the random distinct samples are used instead
+static void generateRandomCenters(const KMeansHamming&, const Mat& data, Mat& centers, const Vec2f*, RNG& rng)
+{
+    const int N = data.rows, K = centers.rows;
+    std::vector<int> idx(N);
+    for (int i = 0; i < N; i++)
+        idx[i] = i;
+    for (int k = 0; k < K; k++)
+    {
+        std::swap(idx[k], idx[rng.uniform(k, N)]);
+        data.row(idx[k]).copyTo(centers.row(k));
+    }
+}
+
+template<class D>
 class KMeansPPDistanceComputer : public ParallelLoopBody
 {
 public:
+    typedef typename D::T T;
+
     KMeansPPDistanceComputer(float *tdist2_, const Mat& data_, const float *dist_, int ci_) :
         tdist2(tdist2_), data(data_), dist(dist_), ci(ci_)
     { }
@@ -75,7 +113,7 @@ public:
 
         for (int i = begin; i<end; i++)
         {
-            tdist2[i] = std::min(hal::normL2Sqr_(data.ptr<float>(i), data.ptr<float>(ci), dims), dist[i]);
+            tdist2[i] = std::min((float)D::dist(data.ptr<T>(i), data.ptr<T>(ci), dims), dist[i]);
         }
     }
 
@@ -91,11 +129,15 @@ private:
 /*
 k-means center initialization using the following algorithm:
 Arthur & Vassilvitskii (2007) k-means++: The Advantages of Careful Seeding
+
+If the weights are given, the i-th sample is counted weights[i] times.
 */
+template<class D>
 static void generateCentersPP(const Mat& data, Mat& _out_centers,
-                              int K, RNG& rng, int trials)
+                              int K, RNG& rng, int trials, const float* weights = 0)
 {
     CV_TRACE_FUNCTION();
+    typedef typename D::T T;
     const int dims = data.cols, N = data.rows;
     cv::AutoBuffer<int, 64> _centers(K);
     int* centers = &_centers[0];
@@ -103,12 +145,28 @@ static void generateCentersPP(const Mat& data, Mat& _out_centers,
     float* dist = &_dist[0], *tdist = dist + N, *tdist2 = tdist + N;
     double sum0 = 0;
 
-    centers[0] = (unsigned)rng % N;
+    if (weights)
+    {
+        double wsum = 0;
+        for (int i = 0; i < N; i++)
+            wsum += weights[i];
+        double p = (double)rng*wsum;
+        int ci = 0;
+        for (; ci < N - 1; ci++)
+        {
+            p -= weights[ci];
+            if (p <= 0)
+                break;
+        }
+        centers[0] = ci;
+    }
+    else
+        centers[0] = (unsigned)rng % N;
 
     for (int i = 0; i < N; i++)
     {
-        dist[i] = hal::normL2Sqr_(data.ptr<float>(i), data.ptr<float>(centers[0]), dims);
-        sum0 += dist[i];
+        dist[i] = (float)D::dist(data.ptr<T>(i), data.ptr<T>(centers[0]), dims);
+        sum0 += weights ? dist[i]*weights[i] : dist[i];
     }
 
     for (int k = 1; k < K; k++)
@@ -122,18 +180,24 @@ static void generateCentersPP(const Mat& data, Mat& _out_centers,
             int ci = 0;
             for (; ci < N - 1; ci++)
             {
-                p -= dist[ci];
+                p -= weights ? dist[ci]*weights[ci] : dist[ci];
                 if (p <= 0)
                     break;
             }
 
             parallel_for_(Range(0, N),
-                          KMeansPPDistanceComputer(tdist2, data, dist, ci),
+                          KMeansPPDistanceComputer<D>(tdist2, data, dist, ci),
                           (double)divUp((size_t)(dims * N), CV_KMEANS_PARALLEL_GRANULARITY));
             double s = 0;
-            for (int i = 0; i < N; i++)
+            if (weights)
             {
-                s += tdist2[i];
+                for (int i = 0; i < N; i++)
+                    s += tdist2[i]*weights[i];
+            }
+            else
+            {
+                for (int i = 0; i < N; i++)
+                    s += tdist2[i];
             }
 
             if (s < bestSum)
@@ -151,18 +215,135 @@ static void generateCentersPP(const Mat& data, Mat& _out_centers,
     }
 
     for (int k = 0; k < K; k++)
+        data.row(centers[k]).copyTo(_out_centers.row(k));
+}
+
+template<class D>
+class KMeansParallelDistanceComputer : public ParallelLoopBody
+{
+public:
+    typedef typename D::T T;
+
+    KMeansParallelDistanceComputer(float *dist_, int *nearest_, const Mat& data_, const int *candidates_,
+                                   int cbegin_, int cend_) :
+        dist(dist_), nearest(nearest_), data(data_), candidates(candidates_), cbegin(cbegin_), cend(cend_)
+    { }
+
+    void operator()( const cv::Range& range ) const CV_OVERRIDE
     {
-        const float* src = data.ptr<float>(centers[k]);
-        float* dst = _out_centers.ptr<float>(k);
-        for (int j = 0; j < dims; j++)
-            dst[j] = src[j];
+        CV_TRACE_FUNCTION();
+        const int dims = data.cols;
+
+        for (int i = range.start; i < range.end; i++)
+        {
+            const T* sample = data.ptr<T>(i);
+            float d = dist[i];
+            int c_best = nearest[i];
+            for (int c = cbegin; c < cend; c++)
+            {
+                float t = (float)D::dist(sample, data.ptr<T>(candidates[c]), dims);
+                if (t < d)
+                {
+                    d = t;
+                    c_best = c;
+                }
+            }
+            dist[i] = d;
+            nearest[i] = c_best;
+        }
+    }
+
+private:
+    KMeansParallelDistanceComputer& operator=(const KMeansParallelDistanceComputer&); // = delete
+
+    float *dist;
+    int *nearest;
+    const Mat& data;
+    const int *candidates;
+    const int cbegin, cend;
+};
+
+/*
+k-means center initialization using the following algorithm:
+Bahmani, Moseley, Vattani, Kumar, Vassilvitskii (2012) Scalable K-Means++
+
+A few passes over the data oversample ~2K candidates per pass, instead of K passes of k-means++.
+The candidates are weighted by the number of the samples closest to them and reduced to K centers
+by the weighted k-means++.
+*/
+template<class D>
+static void generateCentersParallel(const Mat& data, Mat& _out_centers,
+                                    int K, RNG& rng, int trials)
+{
+    CV_TRACE_FUNCTION();
+    const int dims = data.cols, N = data.rows;
+    const int rounds = 5;
+    const double oversampling = 2.0*K;
+    cv::AutoBuffer<float, 0> _dist(N);
+    cv::AutoBuffer<int, 0> _nearest(N);
+    float* dist = _dist.data();
+    int* nearest = _nearest.data();
+    std::vector<int> candidates;
+
+    candidates.push_back((unsigned)rng % N);
+    for (int i = 0; i < N; i++)
+    {
+        dist[i] = FLT_MAX;
+        nearest[i] = 0;
     }
+
+    for (int r = 0, cbegin = 0; ; r++)
+    {
+        const int cend = (int)candidates.size();
+        parallel_for_(Range(0, N),
+                      KMeansParallelDistanceComputer<D>(dist, nearest, data, &candidates[0], cbegin, cend),
+                      (double)divUp((size_t)(dims * N) * (cend - cbegin), CV_KMEANS_PARALLEL_GRANULARITY));
+        if (r == rounds)
+            break;
+
+        double phi = 0;
+        for (int i = 0; i < N; i++)
+            phi += dist[i];
+        if (!(phi <= DBL_MAX))
+            CV_Error(Error::StsNoConv, "kmeans: can't update cluster center (check input for huge or NaN values)");
+
+        // each sample is selected independently with probability oversampling*dist/phi
+        cbegin = cend;
+        for (int i = 0; i < N; i++)
+        {
+            if ((double)rng*phi < oversampling*dist[i])
+                candidates.push_back(i);
+        }
+        if ((int)candidates.size() == cbegin)
+            break;
+    }
+
+    const int C = (int)candidates.size();
+    if (C <= K)
+    {
+        for (int k = 0; k < K; k++)
+            data.row(k < C ? candidates[k] : (int)((unsigned)rng % N)).copyTo(_out_centers.row(k));
+        return;
+    }
+
+    cv::AutoBuffer<float, 0> weights(C);
+    for (int c = 0; c < C; c++)
+        weights[c] = 0.f;
+    for (int i = 0; i < N; i++)
+        weights[nearest[i]] += 1.f;
+
+    Mat cdata(C, dims, data.type());
+    for (int c = 0; c < C; c++)
+        data.row(candidates[c]).copyTo(cdata.row(c));
+    generateCentersPP<D>(cdata, _out_centers, K, rng, trials, weights.data());
 }
 
-template<bool onlyDistance>
+template<bool onlyDistance, class D>
 class KMeansDistanceComputer : public ParallelLoopBody
 {
 public:
+    typedef typename D::T T;
+
     KMeansDistanceComputer( double *distances_,
                             int *labels_,
                             const Mat& data_,
@@ -184,11 +365,11 @@ public:
 
         for (int i = begin; i < end; ++i)
         {
-            const float *sample = data.ptr<float>(i);
+            const T *sample = data.ptr<T>(i);
             if (onlyDistance)
             {
-                const float* center = centers.ptr<float>(labels[i]);
-                distances[i] = hal::normL2Sqr_(sample, center, dims);
+                const T* center = centers.ptr<T>(labels[i]);
+                distances[i] = D::dist(sample, center, dims);
                 continue;
             }
             else
@@ -198,8 +379,8 @@ public:
 
                 for (int k = 0; k < K; k++)
                 {
-                    const float* center = centers.ptr<float>(k);
-                    const double dist = hal::normL2Sqr_(sample, center, dims);
+                    const T* center = centers.ptr<T>(k);
+                    const double dist = D::dist(sample, center, dims);
 
                     if (min_dist > dist)
                     {
@@ -223,80 +404,337 @@ private:
     const Mat& centers;
 };
 
+// groups the sample indices by the labels (keeping the order): order[ofs[k]:ofs[k+1]] are the samples of k-th cluster
+static void sortByLabels(const int* labels, int N, int K, int* order, int* ofs)
+{
+    for (int k = 0; k <= K; k++)
+        ofs[k] = 0;
+    for (int i = 0; i < N; i++)
+        ofs[labels[i] + 1]++;
+    for (int k = 0; k < K; k++)
+        ofs[k + 1] += ofs[k];
+    for (int i = 0; i < N; i++)
+        order[ofs[labels[i]]++] = i;
+    for (int k = K; k > 0; k--)
+        ofs[k] = ofs[k - 1];
+    ofs[0] = 0;
 }
 
-double cv::kmeans( InputArray _data, int K,
-                   InputOutputArray _bestLabels,
-                   TermCriteria criteria, int attempts,
-                   int flags, OutputArray _centers )
+// computes the sums of the cluster samples, one cluster per task
+class KMeansCentersComputer : public ParallelLoopBody
 {
-    CV_INSTRUMENT_REGION();
-    const int SPP_TRIALS = 3;
-    Mat data0 = _data.getMat();
-    const bool isrow = data0.rows == 1;
-    const int N = isrow ? data0.cols : data0.rows;
-    const int dims = (isrow ? 1 : data0.cols)*data0.channels();
-    const int type = data0.depth();
+public:
+    KMeansCentersComputer(const Mat& data_, const int* order_, const int* ofs_, Mat& centers_)
+        : data(data_), order(order_), ofs(ofs_), centers(centers_)
+    { }
 
-    attempts = std::max(attempts, 1);
-    CV_Assert( data0.dims <= 2 && type == CV_32F && K > 0 );
-    CV_CheckGE(N, K, "Number of clusters should be more than number of elements");
+    void operator()(const Range& range) const CV_OVERRIDE
+    {
+        CV_TRACE_FUNCTION();
+        const int dims = data.cols;
 
-    Mat data(N, dims, CV_32F, data0.ptr(), isrow ? dims * sizeof(float) : static_cast<size_t>(data0.step));
+        for (int k = range.start; k < range.end; k++)
+        {
+            float* center = centers.ptr<float>(k);
+            for (int j = 0; j < dims; j++)
+                center[j] = 0.f;
 
-    _bestLabels.create(N, 1, CV_32S, -1, true);
+            for (int p = ofs[k]; p < ofs[k + 1]; p++)
+            {
+                const float* sample = data.ptr<float>(order[p]);
+                int j = 0;
+#if CV_SIMD
+                for (; j <= dims - v_float32::nlanes; j += v_float32::nlanes)
+                    v_store(center + j, vx_load(center + j) + vx_load(sample + j));
+#endif
+                for (; j < dims; j++)
+                    center[j] += sample[j];
+            }
+        }
+    }
 
-    Mat _labels, best_labels = _bestLabels.getMat();
-    if (flags & CV_KMEANS_USE_INITIAL_LABELS)
+private:
+    KMeansCentersComputer& operator=(const KMeansCentersComputer&); // = delete
+
+    const Mat& data;
+    const int* order;
+    const int* ofs;
+    Mat& centers;
+};
+
+// computes the bitwise majority of the cluster samples, one cluster per task
+class KMeansBinaryCentersComputer : public ParallelLoopBody
+{
+public:
+    KMeansBinaryCentersComputer(const Mat& data_, const int* order_, const int* ofs_, Mat& centers_)
+        : data(data_), order(order_), ofs(ofs_), centers(centers_)
+    { }
+
+    void operator()(const Range& range) const CV_OVERRIDE
     {
-        CV_Assert( (best_labels.cols == 1 || best_labels.rows == 1) &&
-                  best_labels.cols*best_labels.rows == N &&
-                  best_labels.type() == CV_32S &&
-                  best_labels.isContinuous());
-        best_labels.reshape(1, N).copyTo(_labels);
+        CV_TRACE_FUNCTION();
+        const int dims = data.cols;
+        cv::AutoBuffer<int, 0> _bitcount(dims*8);
+        int* bitcount = _bitcount.data();
+
+        for (int k = range.start; k < range.end; k++)
+        {
+            const int count = ofs[k + 1] - ofs[k];
+            if (count == 0)
+                continue;
+            for (int j = 0; j < dims*8; j++)
+                bitcount[j] = 0;
+            for (int p = ofs[k]; p < ofs[k + 1]; p++)
+            {
+                const uchar* sample = data.ptr<uchar>(order[p]);
+                for (int j = 0; j < dims; j++)
+                {
+                    int v = sample[j];
+                    for (int b = 0; b < 8; b++)
+                        bitcount[j*8 + b] += (v >> b) & 1;
+                }
+            }
+            uchar* center = centers.ptr<uchar>(k);
+            for (int j = 0; j < dims; j++)
+            {
+                int v = 0;
+                for (int b = 0; b < 8; b++)
+                    v |= (bitcount[j*8 + b]*2 > count) << b;
+                center[j] = (uchar)v;
+            }
+        }
+    }
+
+private:
+    KMeansBinaryCentersComputer& operator=(const KMeansBinaryCentersComputer&); // = delete
+
+    const Mat& data;
+    const int* order;
+    const int* ofs;
+    Mat& centers;
+};
+
+// recomputes the centers from the labels, returns the maximum center shift (if computeShift is set)
+static double updateCenters(const KMeansL2&, const Mat& data, int* labels, Mat& centers, const Mat& old_centers,
+                            int* counters, bool computeShift)
+{
+    const int N = data.rows, K = centers.rows, dims = data.cols;
+    double max_center_shift = computeShift ? 0.0 : DBL_MAX;
+
+    cv::AutoBuffer<int, 0> _order(N + K + 1);
+    int* order = _order.data(), *ofs = order + N;
+    sortByLabels(labels, N, K, order, ofs);
+    parallel_for_(Range(0, K), KMeansCentersComputer(data, order, ofs, centers),
+                  (double)divUp((size_t)(dims * N), CV_KMEANS_PARALLEL_GRANULARITY));
+    for (int k = 0; k < K; k++)
+        counters[k] = ofs[k + 1] - ofs[k];
+
+    cv::AutoBuffer<float, 64> _base_center(dims); // normalized
+    for (int k = 0; k < K; k++)
+    {
+        if (counters[k] != 0)
+            continue;
+
+        // if some cluster appeared to be empty then:
+        //   1. find the biggest cluster
+        //   2. find the farthest from the center point in the biggest cluster
+        //   3. exclude the farthest point from the biggest cluster and form a new 1-point cluster.
+        int max_k = 0;
+        for (int k1 = 1; k1 < K; k1++)
+        {
+            if (counters[max_k] < counters[k1])
+                max_k = k1;
+        }
+
+        double max_dist = 0;
+        int farthest_i = -1;
+        float* base_center = centers.ptr<float>(max_k);
+        float scale = 1.f/counters[max_k];
+        for (int j = 0; j < dims; j++)
+            _base_center[j] = base_center[j]*scale;
+
         for (int i = 0; i < N; i++)
         {
-            CV_Assert((unsigned)_labels.at<int>(i) < (unsigned)K);
+            if (labels[i] != max_k)
+                continue;
+            const float* sample = data.ptr<float>(i);
+            double dist = hal::normL2Sqr_(sample, _base_center.data(), dims);
+
+            if (max_dist <= dist)
+            {
+                max_dist = dist;
+                farthest_i = i;
+            }
+        }
+
+        counters[max_k]--;
+        counters[k]++;
+        labels[farthest_i] = k;
+
+        const float* sample = data.ptr<float>(farthest_i);
+        float* cur_center = centers.ptr<float>(k);
+        for (int j = 0; j < dims; j++)
+        {
+            base_center[j] -= sample[j];
+            cur_center[j] += sample[j];
         }
     }
-    else
+
+    for (int k = 0; k < K; k++)
     {
-        if (!((best_labels.cols == 1 || best_labels.rows == 1) &&
-             best_labels.cols*best_labels.rows == N &&
-             best_labels.type() == CV_32S &&
-             best_labels.isContinuous()))
+        float* center = centers.ptr<float>(k);
+        CV_Assert( counters[k] != 0 );
+
+        float scale = 1.f/counters[k];
+        for (int j = 0; j < dims; j++)
+            center[j] *= scale;
+
+        if (computeShift)
         {
-            _bestLabels.create(N, 1, CV_32S);
-            best_labels = _bestLabels.getMat();
+            double dist = 0;
+            const float* old_center = old_centers.ptr<float>(k);
+            for (int j = 0; j < dims; j++)
+            {
+                double t = center[j] - old_center[j];
+                dist += t*t;
+            }
+            max_center_shift = std::max(max_center_shift, dist);
         }
-        _labels.create(best_labels.size(), best_labels.type());
     }
-    int* labels = _labels.ptr<int>();
+    return max_center_shift;
+}
 
-    Mat centers(K, dims, type), old_centers(K, dims, type), temp(1, dims, type);
-    cv::AutoBuffer<int, 64> counters(K);
-    cv::AutoBuffer<double, 64> dists(N);
-    RNG& rng = theRNG();
+static double updateCenters(const KMeansHamming&, const Mat& data, int* labels, Mat& centers, const Mat& old_centers,
+                            int* counters, bool computeShift)
+{
+    const int N = data.rows, K = centers.rows, dims = data.cols;
+    double max_center_shift = computeShift ? 0.0 : DBL_MAX;
+
+    cv::AutoBuffer<int, 0> _order(N + K + 1);
+    int* order = _order.data(), *ofs = order + N;
+    sortByLabels(labels, N, K, order, ofs);
+    parallel_for_(Range(0, K), KMeansBinaryCentersComputer(data, order, ofs, centers),
+                  (double)divUp((size_t)(dims * 8 * N), CV_KMEANS_PARALLEL_GRANULARITY));
+    for (int k = 0; k < K; k++)
+        counters[k] = ofs[k + 1] - ofs[k];
 
-    if (criteria.type & TermCriteria::EPS)
-        criteria.epsilon = std::max(criteria.epsilon, 0.);
-    else
-        criteria.epsilon = FLT_EPSILON;
-    criteria.epsilon *= criteria.epsilon;
+    for (int k = 0; k < K; k++)
+    {
+        if (counters[k] != 0)
+            continue;
 
-    if (criteria.type & TermCriteria::COUNT)
-        criteria.maxCount = std::min(std::max(criteria.maxCount, 2), 100);
-    else
-        criteria.maxCount = 100;
+        // the empty cluster takes the farthest sample of the biggest cluster
+        int max_k = 0;
+        for (int k1 = 1; k1 < K; k1++)
+        {
+            if (counters[max_k] < counters[k1])
+                max_k = k1;
+        }
 
-    if (K == 1)
+        double max_dist = -1;
+        int farthest_i = -1;
+        const uchar* base_center = centers.ptr<uchar>(max_k);
+        for (int i = 0; i < N; i++)
+        {
+            if (labels[i] != max_k)
+                continue;
+            double dist = hal::normHamming(data.ptr<uchar>(i), base_center, dims);
+            if (max_dist <= dist)
+            {
+                max_dist = dist;
+                farthest_i = i;
+            }
+        }
+
+        counters[max_k]--;
+        counters[k]++;
+        labels[farthest_i] = k;
+        data.row(farthest_i).copyTo(centers.row(k));
+    }
+
+    if (computeShift)
     {
-        attempts = 1;
-        criteria.maxCount = 2;
+        for (int k = 0; k < K; k++)
+            max_center_shift = std::max(max_center_shift,
+                                        (double)hal::normHamming(centers.ptr<uchar>(k), old_centers.ptr<uchar>(k), dims));
     }
+    return max_center_shift;
+}
+
+/*
+mini-batch k-means update, see
+Sculley (2010) Web-Scale K-Means Clustering
+
+Each center moves towards the batch samples assigned to it with the per-center learning rate
+1/(number of the samples assigned to the center so far).
+*/
+static void updateCentersMiniBatch(const KMeansL2&, const Mat& batch, const int* labels, Mat& centers,
+                                   int* counters, Mat&)
+{
+    const int dims = batch.cols;
+    for (int i = 0; i < batch.rows; i++)
+    {
+        const int k = labels[i];
+        const float* sample = batch.ptr<float>(i);
+        float* center = centers.ptr<float>(k);
+        float eta = 1.f/++counters[k];
+        int j = 0;
+#if CV_SIMD
+        v_float32 veta = vx_setall_f32(eta);
+        for (; j <= dims - v_float32::nlanes; j += v_float32::nlanes)
+        {
+            v_float32 c = vx_load(center + j);
+            v_store(center + j, v_muladd(vx_load(sample + j) - c, veta, c));
+        }
+#endif
+        for (; j < dims; j++)
+            center[j] += (sample[j] - center[j])*eta;
+    }
+}
+
+// the binary centers are the bitwise majority of all the samples assigned to them so far
+static void updateCentersMiniBatch(const KMeansHamming&, const Mat& batch, const int* labels, Mat& centers,
+                                   int* counters, Mat& bitcounts)
+{
+    const int dims = batch.cols;
+    if (bitcounts.empty())
+        bitcounts = Mat::zeros(centers.rows, dims*8, CV_32S);
+    for (int i = 0; i < batch.rows; i++)
+    {
+        const int k = labels[i];
+        const uchar* sample = batch.ptr<uchar>(i);
+        uchar* center = centers.ptr<uchar>(k);
+        int* bitcount = bitcounts.ptr<int>(k);
+        const int count = ++counters[k];
+        for (int j = 0; j < dims; j++)
+        {
+            int v = sample[j], c = 0;
+            for (int b = 0; b < 8; b++)
+            {
+                bitcount[j*8 + b] += (v >> b) & 1;
+                c |= (bitcount[j*8 + b]*2 > count) << b;
+            }
+            center[j] = (uchar)c;
+        }
+    }
+}
+
+template<class D>
+static double kmeans_(const Mat& data, int K, Mat& _labels, Mat& best_labels,
+                      TermCriteria criteria, int attempts, int flags, OutputArray _centers)
+{
+    const int SPP_TRIALS = 3;
+    const int N = data.rows, dims = data.cols, type = data.type();
+    const D distance = D();
+    int* labels = _labels.ptr<int>();
+
+    Mat centers(K, dims, type), old_centers(K, dims, type);
+    cv::AutoBuffer<int, 64> counters(K);
+    cv::AutoBuffer<double, 64> dists(N);
+    RNG& rng = theRNG();
 
     cv::AutoBuffer<Vec2f, 64> box(dims);
-    if (!(flags & KMEANS_PP_CENTERS))
+    if (!(flags & (KMEANS_PP_CENTERS | KMEANS_PARALLEL_CENTERS)) && type == CV_32F)
     {
         {
             const float* sample = data.ptr<float>(0);
@@ -315,6 +753,18 @@ double cv::kmeans( InputArray _data, int K,
         }
     }
 
+    const bool miniBatch = (flags & KMEANS_MINI_BATCH) != 0 && K > 1;
+    const int batchSize = std::max(std::min(CV_KMEANS_MINI_BATCH_SIZE, N), 1);
+    Mat batch, bitcounts;
+    cv::AutoBuffer<int, 0> batch_labels;
+    cv::AutoBuffer<double, 0> batch_dists;
+    if (miniBatch)
+    {
+        batch.create(batchSize, dims, type);
+        batch_labels.allocate(batchSize);
+        batch_dists.allocate(batchSize);
+    }
+
     double best_compactness = DBL_MAX;
     for (int a = 0; a < attempts; a++)
     {
@@ -328,118 +778,59 @@ double cv::kmeans( InputArray _data, int K,
 
             if (iter == 0 && (a > 0 || !(flags & KMEANS_USE_INITIAL_LABELS)))
             {
-                if (flags & KMEANS_PP_CENTERS)
-                    generateCentersPP(data, centers, K, rng, SPP_TRIALS);
+                if (flags & KMEANS_PARALLEL_CENTERS)
+                    generateCentersParallel<D>(data, centers, K, rng, SPP_TRIALS);
+                else if (flags & KMEANS_PP_CENTERS)
+                    generateCentersPP<D>(data, centers, K, rng, SPP_TRIALS);
                 else
-                {
-                    for (int k = 0; k < K; k++)
-                        generateRandomCenter(dims, box.data(), centers.ptr<float>(k), rng);
-                }
+                    generateRandomCenters(distance, data, centers, box.data(), rng);
             }
-            else
+            else if (iter == 0 || !miniBatch)
             {
                 // compute centers
-                centers = Scalar(0);
-                for (int k = 0; k < K; k++)
-                    counters[k] = 0;
-
-                for (int i = 0; i < N; i++)
-                {
-                    const float* sample = data.ptr<float>(i);
-                    int k = labels[i];
-                    float* center = centers.ptr<float>(k);
-                    for (int j = 0; j < dims; j++)
-                        center[j] += sample[j];
-                    counters[k]++;
-                }
+                max_center_shift = updateCenters(distance, data, labels, centers, old_centers, counters.data(), iter > 0);
+            }
+            else
+            {
+                // update the centers by a random batch of samples
+                for (int i = 0; i < batchSize; i++)
+                    data.row(rng.uniform(0, N)).copyTo(batch.row(i));
+                parallel_for_(Range(0, batchSize), KMeansDistanceComputer<false, D>(batch_dists.data(), batch_labels.data(), batch, old_centers), (double)divUp((size_t)(dims * batchSize * K), CV_KMEANS_PARALLEL_GRANULARITY));
 
-                for (int k = 0; k < K; k++)
+                old_centers.copyTo(centers);
+                if (iter == 1)
                 {
-                    if (counters[k] != 0)
-                        continue;
-
-                    // if some cluster appeared to be empty then:
-                    //   1. find the biggest cluster
-                    //   2. find the farthest from the center point in the biggest cluster
-                    //   3. exclude the farthest point from the biggest cluster and form a new 1-point cluster.
-                    int max_k = 0;
-                    for (int k1 = 1; k1 < K; k1++)
-                    {
-                        if (counters[max_k] < counters[k1])
-                            max_k = k1;
-                    }
-
-                    double max_dist = 0;
-                    int farthest_i = -1;
-                    float* base_center = centers.ptr<float>(max_k);
-                    float* _base_center = temp.ptr<float>(); // normalized
-                    float scale = 1.f/counters[max_k];
-                    for (int j = 0; j < dims; j++)
-                        _base_center[j] = base_center[j]*scale;
-
-                    for (int i = 0; i < N; i++)
-                    {
-                        if (labels[i] != max_k)
-                            continue;
-                        const float* sample = data.ptr<float>(i);
-                        double dist = hal::normL2Sqr_(sample, _base_center, dims);
-
-                        if (max_dist <= dist)
-                        {
-                            max_dist = dist;
-                            farthest_i = i;
-                        }
-                    }
-
-                    counters[max_k]--;
-                    counters[k]++;
-                    labels[farthest_i] = k;
-
-                    const float* sample = data.ptr<float>(farthest_i);
-                    float* cur_center = centers.ptr<float>(k);
-                    for (int j = 0; j < dims; j++)
-                    {
-                        base_center[j] -= sample[j];
-                        cur_center[j] += sample[j];
-                    }
+                    bitcounts.release();
+                    for (int k = 0; k < K; k++)
+                        counters[k] = 0;
                 }
+                updateCentersMiniBatch(distance, batch, batch_labels.data(), centers, counters.data(), bitcounts);
 
                 for (int k = 0; k < K; k++)
-                {
-                    float* center = centers.ptr<float>(k);
-                    CV_Assert( counters[k] != 0 );
-
-                    float scale = 1.f/counters[k];
-                    for (int j = 0; j < dims; j++)
-                        center[j] *= scale;
-
-                    if (iter > 0)
-                    {
-                        double dist = 0;
-                        const float* old_center = old_centers.ptr<float>(k);
-                        for (int j = 0; j < dims; j++)
-                        {
-                            double t = center[j] - old_center[j];
-                            dist += t*t;
-                        }
-                        max_center_shift = std::max(max_center_shift, dist);
-                    }
-                }
+                    max_center_shift = std::max(max_center_shift, D::dist(centers.ptr<typename D::T>(k), old_centers.ptr<typename D::T>(k), dims));
             }
 
             bool isLastIter = (++iter == MAX(criteria.maxCount, 2) || max_center_shift <= criteria.epsilon);
 
             if (isLastIter)
             {
-                // don't re-assign labels to avoid creation of empty clusters
-                parallel_for_(Range(0, N), KMeansDistanceComputer<true>(dists.data(), labels, data, centers), (double)divUp((size_t)(dims * N), CV_KMEANS_PARALLEL_GRANULARITY));
+                if (miniBatch)
+                {
+                    // the labels of the whole data have not been computed yet
+                    parallel_for_(Range(0, N), KMeansDistanceComputer<false, D>(dists.data(), labels, data, centers), (double)divUp((size_t)(dims * N * K), CV_KMEANS_PARALLEL_GRANULARITY));
+                }
+                else
+                {
+                    // don't re-assign labels to avoid creation of empty clusters
+                    parallel_for_(Range(0, N), KMeansDistanceComputer<true, D>(dists.data(), labels, data, centers), (double)divUp((size_t)(dims * N), CV_KMEANS_PARALLEL_GRANULARITY));
+                }
                 compactness = sum(Mat(Size(N, 1), CV_64F, &dists[0]))[0];
                 break;
             }
-            else
+            else if (!miniBatch)
             {
                 // assign labels
-                parallel_for_(Range(0, N), KMeansDistanceComputer<false>(dists.data(), labels, data, centers), (double)divUp((size_t)(dims * N * K), CV_KMEANS_PARALLEL_GRANULARITY));
+                parallel_for_(Range(0, N), KMeansDistanceComputer<false, D>(dists.data(), labels, data, centers), (double)divUp((size_t)(dims * N * K), CV_KMEANS_PARALLEL_GRANULARITY));
             }
         }
 
@@ -459,3 +850,75 @@ double cv::kmeans( InputArray _data, int K,
 
     return best_compactness;
 }
+
+}
+
+double cv::kmeans( InputArray _data, int K,
+                   InputOutputArray _bestLabels,
+                   TermCriteria criteria, int attempts,
+                   int flags, OutputArray _centers )
+{
+    CV_INSTRUMENT_REGION();
+    Mat data0 = _data.getMat();
+    const bool isrow = data0.rows == 1;
+    const int N = isrow ? data0.cols : data0.rows;
+    const int dims = (isrow ? 1 : data0.cols)*data0.channels();
+    const int type = data0.depth();
+
+    attempts = std::max(attempts, 1);
+    CV_Assert( data0.dims <= 2 && (type == CV_32F || type == CV_8U) && K > 0 );
+    CV_CheckGE(N, K, "Number of clusters should be more than number of elements");
+
+    Mat data(N, dims, type, data0.ptr(), isrow ? dims * CV_ELEM_SIZE1(type) : static_cast<size_t>(data0.step));
+
+    _bestLabels.create(N, 1, CV_32S, -1, true);
+
+    Mat _labels, best_labels = _bestLabels.getMat();
+    if (flags & CV_KMEANS_USE_INITIAL_LABELS)
+    {
+        CV_Assert( (best_labels.cols == 1 || best_labels.rows == 1) &&
+                  best_labels.cols*best_labels.rows == N &&
+                  best_labels.type() == CV_32S &&
+                  best_labels.isContinuous());
+        best_labels.reshape(1, N).copyTo(_labels);
+        for (int i = 0; i < N; i++)
+        {
+            CV_Assert((unsigned)_labels.at<int>(i) < (unsigned)K);
+        }
+    }
+    else
+    {
+        if (!((best_labels.cols == 1 || best_labels.rows == 1) &&
+             best_labels.cols*best_labels.rows == N &&
+             best_labels.type() == CV_32S &&
+             best_labels.isContinuous()))
+        {
+            _bestLabels.create(N, 1, CV_32S);
+            best_labels = _bestLabels.getMat();
+        }
+        _labels.create(best_labels.size(), best_labels.type());
+    }
+
+    if (criteria.type & TermCriteria::EPS)
+        criteria.epsilon = std::max(criteria.epsilon, 0.);
+    else
+        criteria.epsilon = FLT_EPSILON;
+    criteria.epsilon *= criteria.epsilon;
+
+    // mini-batch iterations are cheap, so they are not limited by 100
+    const int maxCount = (flags & KMEANS_MINI_BATCH) ? INT_MAX : 100;
+    if (criteria.type & TermCriteria::COUNT)
+        criteria.maxCount = std::min(std::max(criteria.maxCount, 2), maxCount);
+    else
+        criteria.maxCount = 100;
+
+    if (K == 1)
+    {
+        attempts = 1;
+        criteria.maxCount = 2;
+    }
+
+    if (type == CV_8U)
+        return kmeans_<KMeansHamming>(data, K, _labels, best_labels, criteria, attempts, flags, _centers);
+    return kmeans_<KMeansL2>(data, K, _labels, best_labels, criteria, attempts, flags, _centers);
+}
@@ -0,0 +1,332 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html
+
+
+#include "precomp.hpp"
+
+#include "lapack_batch.simd.hpp"
+#include "lapack_batch.simd_declarations.hpp" // defines CV_CPU_DISPATCH_MODES_ALL=AVX2,...,BASELINE based on CMakeLists.txt content
+
+namespace cv {
+
+static bool solveBatch32f(const uchar* const* A, const size_t* astep, const uchar* const* B, const size_t* bstep,
+                          uchar* const* X, const size_t* xstep, uchar* status, int count, int n, int k, int method)
+{
+    CV_CPU_DISPATCH(solveBatch32f, (A, astep, B, bstep, X, xstep, status, count, n, k, method),
+        CV_CPU_DISPATCH_MODES_ALL);
+}
+
+static bool solveBatch64f(const uchar* const* A, const size_t* astep, const uchar* const* B, const size_t* bstep,
+                          uchar* const* X, const size_t* xstep, uchar* status, int count, int n, int k, int method)
+{
+    CV_CPU_DISPATCH(solveBatch64f, (A, astep, B, bstep, X, xstep, status, count, n, k, method),
+        CV_CPU_DISPATCH_MODES_ALL);
+}
+
+namespace {
+
+// the largest matrices solved by the vectorized batch code, the bigger ones are solved one by one
+enum { BATCH_MAX_SIZE = 16 };
+// number of the matrices processed by a single parallel task
+enum { BATCH_BLOCK_SIZE = 64 };
+
+/* Batch of the matrices of the same size and type. The supported layouts:
+   - 3D matrix N x rows x cols,
+   - vector of N 2D matrices,
+   - N-element multi-channel array (e.g. std::vector<Matx33f>), each element is a rows x cols matrix. */
+struct MatBatch
+{
+    enum { BATCH_3D = 0, BATCH_VECTOR, BATCH_CHANNELS };
+
+    MatBatch() : layout(BATCH_3D), count(0), rows(0), cols(0), depth(-1) {}
+
+    // rows < 0 means that the multi-channel elements are square matrices
+    void init(InputArray arr, int _rows)
+    {
+        ptrs.clear();
+        steps.clear();
+        if( arr.isMatVector() )
+        {
+            layout = BATCH_VECTOR;
+            arr.getMatVector(mats);
+            count = (int)mats.size();
+            CV_Assert( count > 0 );
+            rows = mats[0].rows;
+            cols = mats[0].cols;
+            depth = mats[0].type();
+            for( int i = 0; i < count; i++ )
+            {
+                const Mat& m = mats[i];
+                CV_Assert( m.dims == 2 && m.rows == rows && m.cols == cols && m.type() == depth );
+                ptrs.push_back(m.data);
+                steps.push_back(m.step[0]);
+            }
+        }
+        else
+        {
+            Mat m = arr.getMat();
+            mats.assign(1, m);
+            if( m.dims == 3 )
+            {
+                layout = BATCH_3D;
+                CV_Assert( m.channels() == 1 );
+                count = m.size[0];
+                rows = m.size[1];
+                cols = m.size[2];
+                for( int i = 0; i < count; i++ )
+                {
+                    ptrs.push_back(m.ptr(i));
+                    steps.push_back(m.step[1]);
+                }
+            }
+            else
+            {
+                layout = BATCH_CHANNELS;
+                CV_Assert( m.dims == 2 && m.isContinuous() && (m.rows == 1 || m.cols == 1) );
+                int cn = m.channels();
+                count = (int)m.total();
+                rows = _rows >= 0 ? _rows : cvRound(std::sqrt((double)cn));
+                CV_Assert( rows > 0 && cn % rows == 0 );
+                cols = cn / rows;
+                CV_Assert( _rows >= 0 || rows == cols );
+                for( int i = 0; i < count; i++ )
+                {
+                    ptrs.push_back(m.data + i*m.elemSize());
+                    steps.push_back(cols*m.elemSize1());
+                }
+            }
+            depth = m.depth();
+        }
+        CV_Assert( depth == CV_32F || depth == CV_64F );
+    }
+
+    // allocates the batch of the same layout as the template one
+    void create(OutputArray arr, const MatBatch& tmpl, int _rows, int _cols)
+    {
+        layout = tmpl.layout;
+        count = tmpl.count;
+        rows = _rows;
+        cols = _cols;
+        depth = tmpl.depth;
+        ptrs.resize(count);
+        steps.resize(count);
+        if( layout == BATCH_VECTOR )
+        {
+            arr.create(count, 1, depth);
+            mats.resize(count);
+            for( int i = 0; i < count; i++ )
+            {
+                arr.create(rows, cols, depth, i);
+                mats[i] = arr.getMat(i);
+                ptrs[i] = mats[i].data;
+                steps[i] = mats[i].step[0];
+            }
+        }
+        else if( layout == BATCH_3D )
+        {
+            int sz[] = { count, rows, cols };
+            arr.create(3, sz, depth);
+            Mat m = arr.getMat();
+            mats.assign(1, m);
+            for( int i = 0; i < count; i++ )
+            {
+                ptrs[i] = m.ptr(i);
+                steps[i] = m.step[1];
+            }
+        }
+        else
+        {
+            arr.create(count, 1, CV_MAKETYPE(depth, rows*cols));
+            Mat m = arr.getMat();
+            mats.assign(1, m);
+            CV_Assert( m.isContinuous() );
+            for( int i = 0; i < count; i++ )
+            {
+                ptrs[i] = m.data + i*m.elemSize();
+                steps[i] = cols*m.elemSize1();
+            }
+        }
+    }
+
+    Mat getMat(int i) const
+    {
+        return Mat(rows, cols, depth, ptrs[i], steps[i]);
+    }
+
+    int layout, count, rows, cols, depth;
+    std::vector<uchar*> ptrs;
+    std::vector<size_t> steps;
+    std::vector<Mat> mats;
+};
+
+class SolveBatchInvoker : public ParallelLoopBody
+{
+public:
+    SolveBatchInvoker(const MatBatch& _a, const MatBatch* _b, MatBatch& _x, uchar* _status, int _method)
+        : a(_a), b(_b), x(_x), status(_status), method(_method)
+    {
+        vectorized = (method == DECOMP_LU || method == DECOMP_CHOLESKY) &&
+                     a.rows == a.cols && a.rows <= BATCH_MAX_SIZE;
+    }
+
+    void operator()(const Range& range) const CV_OVERRIDE
+    {
+        int i0 = range.start*BATCH_BLOCK_SIZE, i1 = std::min(range.end*BATCH_BLOCK_SIZE, a.count);
+        if( vectorized )
+        {
+            const uchar* const* A = &a.ptrs[i0];
+            const uchar* const* B = b ? &b->ptrs[i0] : 0;
+            const size_t* bstep = b ? &b->steps[i0] : 0;
+            bool ok = a.depth == CV_32F ?
+                solveBatch32f(A, &a.steps[i0], B, bstep, &x.ptrs[i0], &x.steps[i0], status + i0,
+                              i1 - i0, a.rows, x.cols, method) :
+                solveBatch64f(A, &a.steps[i0], B, bstep, &x.ptrs[i0], &x.steps[i0], status + i0,
+                              i1 - i0, a.rows, x.cols, method);
+            if( ok )
+                return;
+        }
+
+        for( int i = i0; i < i1; i++ )
+        {
+            Mat xi = x.getMat(i);
+            bool ok = b ? solve(a.getMat(i), b->getMat(i), xi, method) : invert(a.getMat(i), xi, method) != 0;
+            CV_Assert( xi.data == x.ptrs[i] );
+            if( !ok && (method == DECOMP_LU || method == DECOMP_CHOLESKY) )
+                xi = Scalar::all(0);
+            status[i] = (uchar)ok;
+        }
+    }
+
+protected:
+    const MatBatch& a;
+    const MatBatch* b;
+    MatBatch& x;
+    uchar* status;
+    int method;
+    bool vectorized;
+};
+
+class SVDBatchInvoker : public ParallelLoopBody
+{
+public:
+    SVDBatchInvoker(const MatBatch& _a, MatBatch& _w, MatBatch* _u, MatBatch* _vt, int _flags)
+        : a(_a), w(_w), u(_u), vt(_vt), flags(_flags) {}
+
+    void operator()(const Range& range) const CV_OVERRIDE
+    {
+        int i0 = range.start*BATCH_BLOCK_SIZE, i1 = std::min(range.end*BATCH_BLOCK_SIZE, a.count);
+        for( int i = i0; i < i1; i++ )
+        {
+            Mat ai = a.getMat(i), wi = w.getMat(i), ui, vti;
+            if( u )
+                ui = u->getMat(i);
+            if( vt )
+                vti = vt->getMat(i);
+            if( u && vt )
+                SVD::compute(ai, wi, ui, vti, flags);
+            else if( u )
+                SVD::compute(ai, wi, ui, noArray(), flags);
+            else if( vt )
+                SVD::compute(ai, wi, noArray(), vti, flags);
+            else
+                SVD::compute(ai, wi, flags);
+            CV_Assert( wi.data == w.ptrs[i] );
+        }
+    }
+
+protected:
+    const MatBatch& a;
+    MatBatch& w;
+    MatBatch* u;
+    MatBatch* vt;
+    int flags;
+};
+
+static bool solveBatch_(const MatBatch& a, const MatBatch* b, OutputArray _dst, OutputArray _status, int method)
+{
+    MatBatch x;
+    x.create(_dst, b ? *b : a, a.cols, b ? b->cols : a.rows);
+
+    std::vector<uchar> status_buf;
+    uchar* status;
+    if( _status.needed() )
+    {
+        _status.create(a.count, 1, CV_8U);
+        Mat m = _status.getMat();
+        CV_Assert( m.isContinuous() );
+        status = m.ptr();
+    }
+    else
+    {
+        status_buf.resize(a.count);
+        status = &status_buf[0];
+    }
+
+    int nblocks = (a.count + BATCH_BLOCK_SIZE - 1)/BATCH_BLOCK_SIZE;
+    parallel_for_(Range(0, nblocks), SolveBatchInvoker(a, b, x, status, method), nblocks);
+
+    for( int i = 0; i < a.count; i++ )
+        if( !status[i] )
+            return false;
+    return true;
+}
+
+}
+
+bool solveBatch( InputArray _src1, InputArray _src2, OutputArray _dst, OutputArray _status, int method )
+{
+    CV_INSTRUMENT_REGION();
+
+    MatBatch a, b;
+    a.init(_src1, -1);
+    b.init(_src2, a.rows);
+    CV_Assert( a.count == b.count && a.depth == b.depth && a.rows == b.rows );
+
+    return solveBatch_(a, &b, _dst, _status, method);
+}
+
+bool invertBatch( InputArray _src, OutputArray _dst, OutputArray _status, int method )
+{
+    CV_INSTRUMENT_REGION();
+
+    CV_Check(method, method == DECOMP_LU || method == DECOMP_SVD || method == DECOMP_EIG ||
+                     method == DECOMP_CHOLESKY,
+             "Unsupported method, see #DecompTypes");
+
+    MatBatch a;
+    a.init(_src, -1);
+    CV_Assert( method == DECOMP_SVD || a.rows == a.cols );
+
+    return solveBatch_(a, 0, _dst, _status, method);
+}
+
+void SVDecompBatch( InputArray _src, OutputArray _w, OutputArray _u, OutputArray _vt, int flags )
+{
+    CV_INSTRUMENT_REGION();
+
+    MatBatch a, w, u, vt;
+    a.init(_src, -1);
+    int m = a.rows, n = a.cols, nm = std::min(m, n);
+    bool full_uv = (flags & SVD::FULL_UV) != 0, no_uv = (flags & SVD::NO_UV) != 0;
+
+    w.create(_w, a, nm, 1);
+    if( no_uv )
+    {
+        _u.release();
+        _vt.release();
+    }
+    else
+    {
+        if( _u.needed() )
+            u.create(_u, a, m, full_uv ? m : nm);
+        if( _vt.needed() )
+            vt.create(_vt, a, full_uv ? n : nm, n);
+    }
+
+    int nblocks = (a.count + BATCH_BLOCK_SIZE - 1)/BATCH_BLOCK_SIZE;
+    parallel_for_(Range(0, nblocks), SVDBatchInvoker(a, w, !no_uv && _u.needed() ? &u : 0,
+                                                     !no_uv && _vt.needed() ? &vt : 0, flags), nblocks);
+}
+
+}
@@ -0,0 +1,243 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html
+
+#include "precomp.hpp"
+
+namespace cv {
+
+CV_CPU_OPTIMIZATION_NAMESPACE_BEGIN
+
+// Solves the square systems A[i]*X[i] = B[i], i = 0..count-1, several systems at once, one per SIMD lane.
+// A[i] is n x n, B[i] and X[i] are n x k (B == NULL means the identity matrix, i.e. inversion),
+// the steps are in bytes. status[i] is set to 1 if the system is solved, otherwise to 0 and X[i] is
+// filled with zeros. Returns false if the batch processing is not available for the type.
+bool solveBatch32f(const uchar* const* A, const size_t* astep, const uchar* const* B, const size_t* bstep,
+                   uchar* const* X, const size_t* xstep, uchar* status, int count, int n, int k, int method);
+bool solveBatch64f(const uchar* const* A, const size_t* astep, const uchar* const* B, const size_t* bstep,
+                   uchar* const* X, const size_t* xstep, uchar* status, int count, int n, int k, int method);
+
+#ifndef CV_CPU_OPTIMIZATION_DECLARATIONS_ONLY
+
+#if CV_SIMD
+
+// the systems of the batch are stored "lane-interleaved": the element (i, j) of the augmented matrix
+// [A | B] of the l-th system of the group is buf[(i*w + j)*VL + l]
+template<typename T, typename VT, int N>
+static void solveGroupLU(T* buf, int n_, int k, T eps, T* ok)
+{
+    const int VL = VT::nlanes;
+    const int n = N > 0 ? N : n_, w = n + k;
+    const VT vone = vx_setall<T>((T)1), veps = vx_setall<T>(eps);
+    VT vok = vone == vone;
+
+#define BUF_ELEM(i, j) (buf + ((i)*w + (j))*VL)
+
+    for( int i = 0; i < n; i++ )
+    {
+        // partial pivoting, the rows are swapped independently in each lane
+        VT vmax = v_abs(vx_load_aligned(BUF_ELEM(i, i))), vpiv = vx_setall<T>((T)i);
+        for( int j = i + 1; j < n; j++ )
+        {
+            VT a = v_abs(vx_load_aligned(BUF_ELEM(j, i)));
+            VT m = a > vmax;
+            vmax = v_select(m, a, vmax);
+            vpiv = v_select(m, vx_setall<T>((T)j), vpiv);
+        }
+        VT vsingular = vmax < veps;
+        vok = vok & ~vsingular;
+
+        for( int j = i + 1; j < n; j++ )
+        {
+            VT m = vpiv == vx_setall<T>((T)j);
+            if( !v_check_any(m) )
+                continue;
+            for( int c = i; c < w; c++ )
+            {
+                VT ri = vx_load_aligned(BUF_ELEM(i, c)), rj = vx_load_aligned(BUF_ELEM(j, c));
+                v_store_aligned(BUF_ELEM(i, c), v_select(m, rj, ri));
+                v_store_aligned(BUF_ELEM(j, c), v_select(m, ri, rj));
+            }
+        }
+
+        VT d = vone / v_select(vsingular, vone, vx_load_aligned(BUF_ELEM(i, i)));
+        v_store_aligned(BUF_ELEM(i, i), d);
+        for( int j = i + 1; j < n; j++ )
+        {
+            VT f = vx_load_aligned(BUF_ELEM(j, i)) * d;
+            for( int c = i + 1; c < w; c++ )
+                v_store_aligned(BUF_ELEM(j, c), vx_load_aligned(BUF_ELEM(j, c)) - f*vx_load_aligned(BUF_ELEM(i, c)));
+        }
+    }
+
+    for( int i = n - 1; i >= 0; i-- )
+    {
+        VT d = vx_load_aligned(BUF_ELEM(i, i));
+        for( int c = n; c < w; c++ )
+        {
+            VT s = vx_load_aligned(BUF_ELEM(i, c));
+            for( int j = i + 1; j < n; j++ )
+                s -= vx_load_aligned(BUF_ELEM(i, j))*vx_load_aligned(BUF_ELEM(j, c));
+            v_store_aligned(BUF_ELEM(i, c), s*d);
+        }
+    }
+
+    v_store_aligned(ok, vone & vok);
+}
+
+template<typename T, typename VT, int N>
+static void solveGroupCholesky(T* buf, int n_, int k, T eps, T* ok)
+{
+    const int VL = VT::nlanes;
+    const int n = N > 0 ? N : n_, w = n + k;
+    const VT vone = vx_setall<T>((T)1), veps = vx_setall<T>(eps);
+    VT vok = vone == vone;
+
+    // A = L*L^T, 1/L(i,i) is stored on the diagonal
+    for( int i = 0; i < n; i++ )
+    {
+        for( int j = 0; j < i; j++ )
+        {
+            VT s = vx_load_aligned(BUF_ELEM(i, j));
+            for( int p = 0; p < j; p++ )
+                s -= vx_load_aligned(BUF_ELEM(i, p))*vx_load_aligned(BUF_ELEM(j, p));
+            v_store_aligned(BUF_ELEM(i, j), s*vx_load_aligned(BUF_ELEM(j, j)));
+        }
+        VT s = vx_load_aligned(BUF_ELEM(i, i));
+        for( int p = 0; p < i; p++ )
+        {
+            VT t = vx_load_aligned(BUF_ELEM(i, p));
+            s -= t*t;
+        }
+        VT vbad = s < veps;
+        vok = vok & ~vbad;
+        v_store_aligned(BUF_ELEM(i, i), vone / v_sqrt(v_select(vbad, vone, s)));
+    }
+
+    for( int c = n; c < w; c++ )
+    {
+        // L*y = b
+        for( int i = 0; i < n; i++ )
+        {
+            VT s = vx_load_aligned(BUF_ELEM(i, c));
+            for( int p = 0; p < i; p++ )
+                s -= vx_load_aligned(BUF_ELEM(i, p))*vx_load_aligned(BUF_ELEM(p, c));
+            v_store_aligned(BUF_ELEM(i, c), s*vx_load_aligned(BUF_ELEM(i, i)));
+        }
+        // L^T*x = y
+        for( int i = n - 1; i >= 0; i-- )
+        {
+            VT s = vx_load_aligned(BUF_ELEM(i, c));
+            for( int p = i + 1; p < n; p++ )
+                s -= vx_load_aligned(BUF_ELEM(p, i))*vx_load_aligned(BUF_ELEM(p, c));
+            v_store_aligned(BUF_ELEM(i, c), s*vx_load_aligned(BUF_ELEM(i, i)));
+        }
+    }
+
+#undef BUF_ELEM
+
+    v_store_aligned(ok, vone & vok);
+}
+
+template<typename T, typename VT, int N>
+static void solveBatch_(const uchar* const* A, const size_t* astep, const uchar* const* B, const size_t* bstep,
+                        uchar* const* X, const size_t* xstep, uchar* status, int count, int n_, int k, int method, T eps)
+{
+    const int VL = VT::nlanes;
+    const int n = N > 0 ? N : n_, w = n + k;
+    AutoBuffer<T> _buf(n*w*VL + VL + CV_SIMD_WIDTH/sizeof(T));
+    T* buf = alignPtr(_buf.data(), CV_SIMD_WIDTH);
+    T* ok = buf + n*w*VL;
+
+    for( int i0 = 0; i0 < count; i0 += VL )
+    {
+        int nl = std::min(VL, count - i0);
+        for( int l = 0; l < VL; l++ )
+        {
+            // the missing systems of the last group are replaced with the identity ones
+            const T* a = l < nl ? (const T*)A[i0 + l] : 0;
+            const T* b = l < nl && B ? (const T*)B[i0 + l] : 0;
+            size_t as = l < nl ? astep[i0 + l]/sizeof(T) : 0;
+            size_t bs = b ? bstep[i0 + l]/sizeof(T) : 0;
+            for( int i = 0; i < n; i++ )
+            {
+                T* row = buf + i*w*VL + l;
+                for( int j = 0; j < n; j++ )
+                    row[j*VL] = a ? a[i*as + j] : (T)(i == j);
+                for( int j = 0; j < k; j++ )
+                    row[(n + j)*VL] = b ? b[i*bs + j] : (T)(i == j && (B == 0 || l >= nl));
+            }
+        }
+
+        if( method == DECOMP_CHOLESKY )
+            solveGroupCholesky<T, VT, N>(buf, n, k, eps, ok);
+        else
+            solveGroupLU<T, VT, N>(buf, n, k, eps, ok);
+
+        for( int l = 0; l < nl; l++ )
+        {
+            T* x = (T*)X[i0 + l];
+            size_t xs = xstep[i0 + l]/sizeof(T);
+            bool solved = ok[l] != 0;
+            status[i0 + l] = (uchar)solved;
+            for( int i = 0; i < n; i++ )
+            {
+                const T* row = buf + (i*w + n)*VL + l;
+                for( int j = 0; j < k; j++ )
+                    x[i*xs + j] = solved ? row[j*VL] : (T)0;
+            }
+        }
+    }
+}
+
+// the code is specialized for the small matrices, so the loops are unrolled by the compiler
+template<typename T, typename VT>
+static void solveBatchN(const uchar* const* A, const size_t* astep, const uchar* const* B, const size_t* bstep,
+                        uchar* const* X, const size_t* xstep, uchar* status, int count, int n, int k, int method, T eps)
+{
+    typedef void (*SolveBatchFunc)(const uchar* const*, const size_t*, const uchar* const*, const size_t*,
+                                   uchar* const*, const size_t*, uchar*, int, int, int, int, T);
+    static const SolveBatchFunc tab[] =
+    {
+        solveBatch_<T, VT, 0>, solveBatch_<T, VT, 1>, solveBatch_<T, VT, 2>, solveBatch_<T, VT, 3>,
+        solveBatch_<T, VT, 4>, solveBatch_<T, VT, 5>, solveBatch_<T, VT, 6>
+    };
+    tab[n < (int)(sizeof(tab)/sizeof(tab[0])) ? n : 0](A, astep, B, bstep, X, xstep, status, count, n, k, method, eps);
+}
+
+#endif // CV_SIMD
+
+bool solveBatch32f(const uchar* const* A, const size_t* astep, const uchar* const* B, const size_t* bstep,
+                   uchar* const* X, const size_t* xstep, uchar* status, int count, int n, int k, int method)
+{
+#if CV_SIMD
+    solveBatchN<float, v_float32>(A, astep, B, bstep, X, xstep, status, count, n, k, method,
+                                  method == DECOMP_CHOLESKY ? FLT_EPSILON : FLT_EPSILON*10);
+    vx_cleanup();
+    return true;
+#else
+    CV_UNUSED(A); CV_UNUSED(astep); CV_UNUSED(B); CV_UNUSED(bstep); CV_UNUSED(X); CV_UNUSED(xstep);
+    CV_UNUSED(status); CV_UNUSED(count); CV_UNUSED(n); CV_UNUSED(k); CV_UNUSED(method);
+    return false;
+#endif
+}
+
+bool solveBatch64f(const uchar* const* A, const size_t* astep, const uchar* const* B, const size_t* bstep,
+                   uchar* const* X, const size_t* xstep, uchar* status, int count, int n, int k, int method)
+{
+#if CV_SIMD_64F
+    solveBatchN<double, v_float64>(A, astep, B, bstep, X, xstep, status, count, n, k, method,
+                                   method == DECOMP_CHOLESKY ? DBL_EPSILON : DBL_EPSILON*100);
+    vx_cleanup();
+    return true;
+#else
+    CV_UNUSED(A); CV_UNUSED(astep); CV_UNUSED(B); CV_UNUSED(bstep); CV_UNUSED(X); CV_UNUSED(xstep);
+    CV_UNUSED(status); CV_UNUSED(count); CV_UNUSED(n); CV_UNUSED(k); CV_UNUSED(method);
+    return false;
+#endif
+}
+
+#endif // CV_CPU_OPTIMIZATION_DECLARATIONS_ONLY
+
+CV_CPU_OPTIMIZATION_NAMESPACE_END
+} // namespace
@@ -0,0 +1,205 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html
+
+
+#include "precomp.hpp"
+#include "matexpr_fused.hpp"
+
+#include "matexpr_fused.simd.hpp"
+#include "matexpr_fused.simd_declarations.hpp" // defines CV_CPU_DISPATCH_MODES_ALL=AVX2,...,BASELINE based on CMakeLists.txt content
+
+namespace cv {
+
+static void fusedExprRun32f(const MatExprGraph::Node* nodes, int nnodes, float** bufs, const float* const* sbufs, int len)
+{
+    CV_CPU_DISPATCH(fusedExprRun32f, (nodes, nnodes, bufs, sbufs, len),
+        CV_CPU_DISPATCH_MODES_ALL);
+}
+
+static void fusedExprRun64f(const MatExprGraph::Node* nodes, int nnodes, double** bufs, const double* const* sbufs, int len)
+{
+    CV_CPU_DISPATCH(fusedExprRun64f, (nodes, nnodes, bufs, sbufs, len),
+        CV_CPU_DISPATCH_MODES_ALL);
+}
+
+int MatExprGraph::addInput(const Mat& m)
+{
+    if( m.empty() || m.dims > 2 || m.depth() == CV_16F )
+        return -1;
+    if( inputs.empty() )
+        cn = m.channels();
+    else if( m.size() != inputs[0].size() || m.channels() != cn )
+        return -1;
+
+    for( size_t i = 0; i < nodes.size(); i++ )
+    {
+        const Node& node = nodes[i];
+        if( node.op != OP_INPUT )
+            continue;
+        const Mat& m0 = inputs[node.arg[0]];
+        if( m0.data == m.data && m0.step[0] == m.step[0] && m0.type() == m.type() )
+            return (int)i;
+    }
+
+    int idx = addNode(OP_INPUT, m.depth(), (int)inputs.size(), -1);
+    if( idx >= 0 )
+        inputs.push_back(m);
+    return idx;
+}
+
+int MatExprGraph::addNode(int op, int depth, int x, int y, double alpha, double beta, const Scalar& s, int cmpop)
+{
+    if( nodes.size() >= (size_t)MAX_NODES )
+        return -1;
+    Node node;
+    node.op = op;
+    node.depth = depth;
+    node.arg[0] = x;
+    node.arg[1] = y;
+    node.cmpop = cmpop;
+    node.alpha = alpha;
+    node.beta = beta;
+    node.s = s;
+    nodes.push_back(node);
+    return (int)nodes.size() - 1;
+}
+
+namespace {
+
+// number of elements processed by the graph at once, all the node buffers stay in the cache
+enum { FUSED_BLOCK_SIZE = 512 };
+
+class FusedExprInvoker : public ParallelLoopBody
+{
+public:
+    FusedExprInvoker(const MatExprGraph& _g, Mat& _dst, int _wdepth, int _cols, int _blockLen)
+        : g(_g), dst(_dst), wdepth(_wdepth), cols(_cols), blockLen(_blockLen)
+    {
+        blocksPerRow = (cols + blockLen - 1)/blockLen;
+    }
+
+    void operator()(const Range& range) const CV_OVERRIDE
+    {
+        const std::vector<MatExprGraph::Node>& nodes = g.nodes;
+        int i, nnodes = (int)nodes.size(), cn = g.cn;
+        size_t wsz = CV_ELEM_SIZE1(wdepth), bufsz = alignSize(blockLen*wsz, CV_SIMD_WIDTH > 0 ? CV_SIMD_WIDTH : 16);
+
+        AutoBuffer<uchar*> _ptrs(nnodes*3);
+        uchar** bufs = _ptrs.data();
+        uchar** own = bufs + nnodes;
+        uchar** sbufs = own + nnodes;
+        AutoBuffer<BinaryFunc> cvtTab(nnodes);
+
+        int nscalars = 0;
+        for( i = 0; i < nnodes; i++ )
+        {
+            int op = nodes[i].op;
+            nscalars += op == MatExprGraph::OP_AFFINE ||
+                (op != MatExprGraph::OP_INPUT && op != MatExprGraph::OP_RECIP && nodes[i].arg[1] < 0);
+        }
+        AutoBuffer<uchar> _buf((nnodes + nscalars)*bufsz + CV_MALLOC_ALIGN);
+        uchar* ptr = alignPtr(_buf.data(), CV_MALLOC_ALIGN);
+
+        for( i = 0; i < nnodes; i++, ptr += bufsz )
+        {
+            const MatExprGraph::Node& node = nodes[i];
+            own[i] = bufs[i] = ptr;
+            sbufs[i] = 0;
+            cvtTab[i] = node.op == MatExprGraph::OP_INPUT && node.depth != wdepth ? getConvertFunc(node.depth, wdepth) : 0;
+        }
+        for( i = 0; i < nnodes; i++ )
+        {
+            const MatExprGraph::Node& node = nodes[i];
+            if( node.op == MatExprGraph::OP_INPUT ||
+                (node.op != MatExprGraph::OP_AFFINE && (node.op == MatExprGraph::OP_RECIP || node.arg[1] >= 0)) )
+                continue;
+            sbufs[i] = ptr;
+            ptr += bufsz;
+            for( int j = 0; j < blockLen; j++ )
+            {
+                double v = node.s[j % cn];
+                if( wdepth == CV_32F )
+                    ((float*)sbufs[i])[j] = (float)v;
+                else
+                    ((double*)sbufs[i])[j] = v;
+            }
+        }
+
+        int ddepth = dst.depth();
+        size_t desz = CV_ELEM_SIZE1(ddepth);
+        BinaryFunc cvtDst = getConvertFunc(wdepth, ddepth);
+
+        for( int b = range.start; b < range.end; b++ )
+        {
+            int y = b / blocksPerRow, x = (b - y*blocksPerRow)*blockLen;
+            int len = std::min(blockLen, cols - x);
+
+            for( i = 0; i < nnodes; i++ )
+            {
+                const MatExprGraph::Node& node = nodes[i];
+                if( node.op != MatExprGraph::OP_INPUT )
+                    continue;
+                const Mat& src = g.inputs[node.arg[0]];
+                const uchar* sptr = src.ptr(y) + x*src.elemSize1();
+                if( !cvtTab[i] )
+                    bufs[i] = (uchar*)sptr;
+                else
+                    cvtTab[i](sptr, 0, 0, 0, own[i], 0, Size(len, 1), 0);
+            }
+
+            if( wdepth == CV_32F )
+                fusedExprRun32f(&nodes[0], nnodes, (float**)bufs, (const float* const*)sbufs, len);
+            else
+                fusedExprRun64f(&nodes[0], nnodes, (double**)bufs, (const double* const*)sbufs, len);
+
+            cvtDst(bufs[nnodes-1], 0, 0, 0, dst.ptr(y) + x*desz, 0, Size(len, 1), 0);
+        }
+    }
+
+protected:
+    const MatExprGraph& g;
+    Mat& dst;
+    int wdepth, cols, blockLen, blocksPerRow;
+};
+
+}
+
+void MatExprGraph::eval(Mat& dst, int ddepth) const
+{
+    CV_INSTRUMENT_REGION();
+
+    CV_Assert( !inputs.empty() && !nodes.empty() );
+    Size sz = inputs[0].size();
+    if( ddepth < 0 )
+        ddepth = nodes.back().depth;
+
+    // the intermediate results are computed in float, unless double is needed to represent them exactly
+    int wdepth = CV_32F;
+    for( size_t i = 0; i < nodes.size(); i++ )
+        if( nodes[i].depth == CV_32S || nodes[i].depth == CV_64F )
+            wdepth = CV_64F;
+
+    // the inputs are retained by the graph, so dst may be one of them
+    dst.create(sz, CV_MAKETYPE(ddepth, cn));
+
+    bool continuous = dst.isContinuous();
+    for( size_t i = 0; i < inputs.size(); i++ )
+        continuous = continuous && inputs[i].isContinuous();
+
+    int rows = sz.height, cols = sz.width*cn;
+    if( continuous )
+    {
+        cols *= rows;
+        rows = 1;
+    }
+    int blockLen = std::max(FUSED_BLOCK_SIZE/cn, 1)*cn;
+    int nblocks = rows*((cols + blockLen - 1)/blockLen);
+    if( nblocks == 0 )
+        return;
+
+    FusedExprInvoker invoker(*this, dst, wdepth, cols, blockLen);
+    parallel_for_(Range(0, nblocks), invoker, ((double)rows*cols)/(1 << 16));
+}
+
+}
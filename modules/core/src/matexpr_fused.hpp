@@ -0,0 +1,73 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html
+
+
+#ifndef SRC_MATEXPR_FUSED_HPP
+#define SRC_MATEXPR_FUSED_HPP
+
+#include "opencv2/core/mat.hpp"
+
+namespace cv {
+
+/* Chain of the element-wise matrix operations evaluated in a single pass (see MatOp_Fused).
+
+   The nodes are stored in the topological order, the last node is the result. The result of each
+   node is rounded and saturated to the node depth, so the graph produces the same values as
+   the step-by-step evaluation of the matrix expression, just without the intermediate matrices.
+   All the inputs have the same size and the same number of channels. */
+class MatExprGraph
+{
+public:
+    enum
+    {
+        OP_INPUT = 0,   //!< inputs[arg[0]]
+        OP_AFFINE,      //!< alpha*x + beta*y + s, y is optional
+        OP_MUL,         //!< alpha*x*y
+        OP_DIV,         //!< alpha*x/y, 0 if y == 0 and the depth is integer
+        OP_RECIP,       //!< alpha/x, 0 if x == 0 and the depth is integer
+        OP_MIN,         //!< min(x, y)
+        OP_MAX,         //!< max(x, y)
+        OP_ABSDIFF,     //!< |x - y|
+        OP_CMP          //!< x cmpop y ? 255 : 0
+    };
+
+    // maximum number of the nodes, longer chains are split into several graphs
+    enum { MAX_NODES = 32 };
+
+    struct Node
+    {
+        int op;
+        int depth;      //!< depth of the result
+        int arg[2];     //!< x and y nodes, if y is -1 then the binary operations use s instead of it
+        int cmpop;
+        double alpha, beta;
+        Scalar s;       //!< per-channel constant
+    };
+
+    MatExprGraph() : cn(0), rootStart(0) { rootArgs[0] = rootArgs[1] = -1; }
+
+    //! adds the input matrix (or finds the same one), returns the node index or -1 if it can not be fused
+    int addInput(const Mat& m);
+    //! returns the new node index or -1 if the graph is full
+    int addNode(int op, int depth, int x, int y, double alpha = 1, double beta = 0,
+                const Scalar& s = Scalar(), int cmpop = 0);
+
+    //! computes the last node into dst (converted to ddepth, if it is not negative)
+    void eval(Mat& dst, int ddepth = -1) const;
+
+    std::vector<Mat> inputs;
+    std::vector<Node> nodes;
+    int cn;
+
+    // the last operation of the expression as it was written (MatOp_AddEx, MatOp_Bin or MatOp_Cmp
+    // with the arguments replaced by the nodes), nodes[rootStart:] compute it for the default result
+    // type; it is lowered again when the result is requested in another type.
+    MatExpr root;
+    int rootArgs[2];
+    int rootStart;
+};
+
+}
+
+#endif
@@ -0,0 +1,253 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html
+
+#include "precomp.hpp"
+#include "matexpr_fused.hpp"
+
+namespace cv {
+
+CV_CPU_OPTIMIZATION_NAMESPACE_BEGIN
+
+// computes the non-input nodes of the graph over len elements; bufs[i] is the i-th node buffer
+// (the input nodes are already loaded), sbufs[i] is the per-channel constant of the i-th node
+// repeated over len elements (or NULL if it is not used by the node)
+void fusedExprRun32f(const MatExprGraph::Node* nodes, int nnodes, float** bufs, const float* const* sbufs, int len);
+void fusedExprRun64f(const MatExprGraph::Node* nodes, int nnodes, double** bufs, const double* const* sbufs, int len);
+
+#ifndef CV_CPU_OPTIMIZATION_DECLARATIONS_ONLY
+
+typedef MatExprGraph::Node FusedNode;
+
+template<typename T> static inline bool fusedCmp(int cmpop, T a, T b)
+{
+    switch( cmpop )
+    {
+    case CMP_EQ: return a == b;
+    case CMP_GT: return a > b;
+    case CMP_GE: return a >= b;
+    case CMP_LT: return a < b;
+    case CMP_LE: return a <= b;
+    default: return a != b;
+    }
+}
+
+template<typename T> static inline T fusedRound(T a) { return (T)cvRound(a); }
+
+template<typename T>
+static int fusedNodeSIMD(const FusedNode&, const T*, const T*, const T*, T*, int) { return 0; }
+
+template<typename T>
+static int fusedSaturateSIMD(T*, int, T, T) { return 0; }
+
+#if CV_SIMD
+static inline v_float32 v_fusedRound(const v_float32& a) { return v_cvt_f32(v_round(a)); }
+#endif
+#if CV_SIMD_64F
+static inline v_float64 v_fusedRound(const v_float64& a) { return v_cvt_f64(v_round(a)); }
+#endif
+
+#if CV_SIMD
+template<typename VT> static inline VT v_fusedCmp(int cmpop, const VT& a, const VT& b)
+{
+    switch( cmpop )
+    {
+    case CMP_EQ: return a == b;
+    case CMP_GT: return a > b;
+    case CMP_GE: return a >= b;
+    case CMP_LT: return a < b;
+    case CMP_LE: return a <= b;
+    default: return a != b;
+    }
+}
+
+template<typename T, typename VT>
+static int fusedNodeSIMD_(const FusedNode& node, const T* x, const T* y, const T* s, T* dst, int len)
+{
+    const int VECSZ = VT::nlanes;
+    const VT valpha = vx_setall<T>((T)node.alpha), vbeta = vx_setall<T>((T)node.beta);
+    const VT vzero = vx_setall<T>((T)0), v255 = vx_setall<T>((T)255);
+    const bool isint = node.depth < CV_32F;
+    int i = 0;
+
+    switch( node.op )
+    {
+    case MatExprGraph::OP_AFFINE:
+        if( y )
+            for( ; i <= len - VECSZ; i += VECSZ )
+                v_store(dst + i, v_muladd(vx_load(x + i), valpha, v_muladd(vx_load(y + i), vbeta, vx_load(s + i))));
+        else
+            for( ; i <= len - VECSZ; i += VECSZ )
+                v_store(dst + i, v_muladd(vx_load(x + i), valpha, vx_load(s + i)));
+        break;
+    case MatExprGraph::OP_MUL:
+        for( ; i <= len - VECSZ; i += VECSZ )
+            v_store(dst + i, vx_load(x + i) * valpha * vx_load(y + i));
+        break;
+    case MatExprGraph::OP_DIV:
+        for( ; i <= len - VECSZ; i += VECSZ )
+        {
+            VT vy = vx_load(y + i), r = vx_load(x + i) * valpha / vy;
+            v_store(dst + i, isint ? v_select(vy == vzero, vzero, r) : r);
+        }
+        break;
+    case MatExprGraph::OP_RECIP:
+        for( ; i <= len - VECSZ; i += VECSZ )
+        {
+            VT vx = vx_load(x + i), r = valpha / vx;
+            v_store(dst + i, isint ? v_select(vx == vzero, vzero, r) : r);
+        }
+        break;
+    case MatExprGraph::OP_MIN:
+        for( ; i <= len - VECSZ; i += VECSZ )
+            v_store(dst + i, v_min(vx_load(x + i), vx_load(y + i)));
+        break;
+    case MatExprGraph::OP_MAX:
+        for( ; i <= len - VECSZ; i += VECSZ )
+            v_store(dst + i, v_max(vx_load(x + i), vx_load(y + i)));
+        break;
+    case MatExprGraph::OP_ABSDIFF:
+        for( ; i <= len - VECSZ; i += VECSZ )
+            v_store(dst + i, v_absdiff(vx_load(x + i), vx_load(y + i)));
+        break;
+    case MatExprGraph::OP_CMP:
+        for( ; i <= len - VECSZ; i += VECSZ )
+            v_store(dst + i, v_fusedCmp(node.cmpop, vx_load(x + i), vx_load(y + i)) & v255);
+        break;
+    default:
+        break;
+    }
+    return i;
+}
+
+template<typename T, typename VT>
+static int fusedSaturateSIMD_(T* buf, int len, T minval, T maxval)
+{
+    const int VECSZ = VT::nlanes;
+    const VT vmin = vx_setall<T>(minval), vmax = vx_setall<T>(maxval);
+    int i = 0;
+    for( ; i <= len - VECSZ; i += VECSZ )
+        v_store(buf + i, v_fusedRound(v_min(v_max(vx_load(buf + i), vmin), vmax)));
+    return i;
+}
+
+template<>
+int fusedNodeSIMD<float>(const FusedNode& node, const float* x, const float* y, const float* s, float* dst, int len)
+{ return fusedNodeSIMD_<float, v_float32>(node, x, y, s, dst, len); }
+
+template<>
+int fusedSaturateSIMD<float>(float* buf, int len, float minval, float maxval)
+{ return fusedSaturateSIMD_<float, v_float32>(buf, len, minval, maxval); }
+#endif
+
+#if CV_SIMD_64F
+template<>
+int fusedNodeSIMD<double>(const FusedNode& node, const double* x, const double* y, const double* s, double* dst, int len)
+{ return fusedNodeSIMD_<double, v_float64>(node, x, y, s, dst, len); }
+
+template<>
+int fusedSaturateSIMD<double>(double* buf, int len, double minval, double maxval)
+{ return fusedSaturateSIMD_<double, v_float64>(buf, len, minval, maxval); }
+#endif
+
+template<typename T>
+static void fusedNode(const FusedNode& node, const T* x, const T* y, const T* s, T* dst, int len)
+{
+    const T alpha = (T)node.alpha, beta = (T)node.beta;
+    const bool isint = node.depth < CV_32F;
+    int i = fusedNodeSIMD<T>(node, x, y, s, dst, len);
+
+    switch( node.op )
+    {
+    case MatExprGraph::OP_AFFINE:
+        if( y )
+            for( ; i < len; i++ )
+                dst[i] = x[i]*alpha + (y[i]*beta + s[i]);
+        else
+            for( ; i < len; i++ )
+                dst[i] = x[i]*alpha + s[i];
+        break;
+    case MatExprGraph::OP_MUL:
+        for( ; i < len; i++ )
+            dst[i] = x[i]*alpha*y[i];
+        break;
+    case MatExprGraph::OP_DIV:
+        for( ; i < len; i++ )
+            dst[i] = isint && y[i] == 0 ? (T)0 : x[i]*alpha/y[i];
+        break;
+    case MatExprGraph::OP_RECIP:
+        for( ; i < len; i++ )
+            dst[i] = isint && x[i] == 0 ? (T)0 : alpha/x[i];
+        break;
+    case MatExprGraph::OP_MIN:
+        for( ; i < len; i++ )
+            dst[i] = std::min(x[i], y[i]);
+        break;
+    case MatExprGraph::OP_MAX:
+        for( ; i < len; i++ )
+            dst[i] = std::max(x[i], y[i]);
+        break;
+    case MatExprGraph::OP_ABSDIFF:
+        for( ; i < len; i++ )
+            dst[i] = std::abs(x[i] - y[i]);
+        break;
+    case MatExprGraph::OP_CMP:
+        for( ; i < len; i++ )
+            dst[i] = fusedCmp(node.cmpop, x[i], y[i]) ? (T)255 : (T)0;
+        break;
+    default:
+        CV_Error(Error::StsBadArg, "Unknown operation");
+    }
+}
+
+// emulates saturate_cast of the node result to the node depth
+template<typename T>
+static void fusedSaturate(T* buf, int len, int depth)
+{
+    static const double minval[] = { 0, SCHAR_MIN, 0, SHRT_MIN, INT_MIN };
+    static const double maxval[] = { UCHAR_MAX, SCHAR_MAX, USHRT_MAX, SHRT_MAX, INT_MAX };
+    int i = 0;
+    if( depth < CV_32F )
+    {
+        const T lo = (T)minval[depth], hi = (T)maxval[depth];
+        i = fusedSaturateSIMD<T>(buf, len, lo, hi);
+        for( ; i < len; i++ )
+            buf[i] = fusedRound(std::min(std::max(buf[i], lo), hi));
+    }
+    else if( depth == CV_32F && sizeof(T) > sizeof(float) )
+    {
+        for( ; i < len; i++ )
+            buf[i] = (T)(float)buf[i];
+    }
+}
+
+template<typename T>
+static void fusedExprRun(const FusedNode* nodes, int nnodes, T** bufs, const T* const* sbufs, int len)
+{
+    for( int i = 0; i < nnodes; i++ )
+    {
+        const FusedNode& node = nodes[i];
+        if( node.op == MatExprGraph::OP_INPUT )
+            continue;
+        const T* x = bufs[node.arg[0]];
+        const T* y = node.arg[1] >= 0 ? bufs[node.arg[1]] : node.op == MatExprGraph::OP_AFFINE ? 0 : sbufs[i];
+        fusedNode<T>(node, x, y, sbufs[i], bufs[i], len);
+        if( node.op != MatExprGraph::OP_CMP )
+            fusedSaturate<T>(bufs[i], len, node.depth);
+    }
+}
+
+void fusedExprRun32f(const FusedNode* nodes, int nnodes, float** bufs, const float* const* sbufs, int len)
+{
+    fusedExprRun<float>(nodes, nnodes, bufs, sbufs, len);
+}
+
+void fusedExprRun64f(const FusedNode* nodes, int nnodes, double** bufs, const double* const* sbufs, int len)
+{
+    fusedExprRun<double>(nodes, nnodes, bufs, sbufs, len);
+}
+
+#endif // CV_CPU_OPTIMIZATION_DECLARATIONS_ONLY
+
+CV_CPU_OPTIMIZATION_NAMESPACE_END
+} // namespace
@@ -4,6 +4,8 @@
 
 #include "precomp.hpp"
 #include "bufferpool.impl.hpp"
+#include <opencv2/core/utils/configuration.private.hpp>
+#include <opencv2/core/utils/thread_pool.hpp>
 
 namespace cv {
 
@@ -123,6 +125,14 @@ BufferPoolController* MatAllocator::getBufferPoolController(const char* id) cons
     return &dummy;
 }
 
+void matFirstTouchHint(void* data, size_t size)
+{
+    // disabled by default: useful on multi-socket systems with pinned workers (OPENCV_THREAD_POOL_AFFINITY=numa)
+    static size_t threshold = utils::getConfigurationParameterSizeT("OPENCV_MAT_FIRST_TOUCH_THRESHOLD", 0);
+    if (threshold > 0 && size >= threshold)
+        utils::parallelFirstTouch(data, size);
+}
+
 class StdMatAllocator CV_FINAL : public MatAllocator
 {
 public:
@@ -144,7 +154,12 @@ public:
             }
             total *= sizes[i];
         }
-        uchar* data = data0 ? (uchar*)data0 : (uchar*)fastMalloc(total);
+        uchar* data = (uchar*)data0;
+        if (!data)
+        {
+            data = (uchar*)fastMalloc(total);
+            matFirstTouchHint(data, total);
+        }
         UMatData* u = new UMatData(this);
         u->data = u->origdata = data;
         u->size = total;
@@ -188,7 +203,11 @@ MatAllocator* Mat::getDefaultAllocator()
         cv::AutoLock lock(cv::getInitializationMutex());
         if (g_matAllocator == NULL)
         {
-            g_matAllocator = getStdAllocator();
+            const cv::String allocatorName = utils::getConfigurationParameterString("OPENCV_MAT_ALLOCATOR", "");
+            if (allocatorName == "pool")
+                g_matAllocator = getPoolAllocator();
+            else
+                g_matAllocator = getStdAllocator();
         }
     }
     return g_matAllocator;
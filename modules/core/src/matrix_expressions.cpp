@@ -10,6 +10,7 @@
 // */
 
 #include "precomp.hpp"
+#include "matexpr_fused.hpp"
 #include <opencv2/core/utils/logger.hpp>
 
 namespace cv
@@ -103,6 +104,42 @@ public:
 
 static MatOp_Cmp g_MatOp_Cmp;
 
+// chain of the element-wise operations (see MatExprGraph), it is created instead of computing
+// the intermediate matrices when an element-wise expression becomes an operand of another one
+class MatOp_Fused CV_FINAL : public MatOp
+{
+public:
+    MatOp_Fused() {}
+    virtual ~MatOp_Fused() {}
+
+    bool elementWise(const MatExpr& /*expr*/) const CV_OVERRIDE { return true; }
+    void assign(const MatExpr& expr, Mat& m, int type=-1) const CV_OVERRIDE;
+
+    void roi(const MatExpr& expr, const Range& rowRange, const Range& colRange, MatExpr& res) const CV_OVERRIDE;
+    void diag(const MatExpr& expr, int d, MatExpr& res) const CV_OVERRIDE;
+
+    void add(const MatExpr& e1, const Scalar& s, MatExpr& res) const CV_OVERRIDE;
+    void subtract(const Scalar& s, const MatExpr& expr, MatExpr& res) const CV_OVERRIDE;
+    void multiply(const MatExpr& e1, double s, MatExpr& res) const CV_OVERRIDE;
+
+    Size size(const MatExpr& expr) const CV_OVERRIDE;
+    int type(const MatExpr& expr) const CV_OVERRIDE;
+
+    // makes the expression root (MatOp_AddEx, MatOp_Bin or MatOp_Cmp) with the operands ea and eb
+    // (used instead of root.a and root.b, if not NULL), falls back to the step-by-step evaluation
+    // of the operands if they can not be fused
+    static void makeExpr(MatExpr& res, const MatExpr& root, const MatExpr* ea, const MatExpr* eb);
+    // replaces the last operation of the fused expression e
+    static bool makeExpr(MatExpr& res, const MatExpr& e, const MatExpr& root);
+    // makes the expression computing the graph g
+    static void makeExpr(MatExpr& res, const Ptr<MatExprGraph>& g);
+
+    // the graph of the expression, it is stored in expr.c (see makeExpr)
+    static const MatExprGraph& graph(const MatExpr& expr);
+};
+
+static MatOp_Fused g_MatOp_Fused;
+
 class MatOp_GEMM CV_FINAL : public MatOp
 {
 public:
@@ -205,6 +242,7 @@ static inline bool isAddEx(const MatExpr& e) { return e.op == &g_MatOp_AddEx; }
 static inline bool isScaled(const MatExpr& e) { return isAddEx(e) && (!e.b.data || e.beta == 0) && e.s == Scalar(); }
 static inline bool isBin(const MatExpr& e, char c) { return e.op == &g_MatOp_Bin && e.flags == c; }
 static inline bool isCmp(const MatExpr& e) { return e.op == &g_MatOp_Cmp; }
+static inline bool isFused(const MatExpr& e) { return e.op == &g_MatOp_Fused; }
 static inline bool isReciprocal(const MatExpr& e) { return isBin(e,'/') && (!e.b.data || e.beta == 0); }
 static inline bool isT(const MatExpr& e) { return e.op == &g_MatOp_T; }
 static inline bool isInv(const MatExpr& e) { return e.op == &g_MatOp_Invert; }
@@ -213,6 +251,24 @@ static inline bool isSolve(const MatExpr& e) { return e.op == &g_MatOp_Solve; }
 static inline bool isMatProd(const MatExpr& e) { return e.op == &g_MatOp_GEMM && (!e.c.data || e.beta == 0); }
 static inline bool isInitializer(const MatExpr& e) { return e.op == getGlobalMatOpInitializer(); }
 
+// element-wise expression which can be an operand of MatOp_Fused instead of the temporary matrix
+static inline bool isFusable(const MatExpr& e)
+{
+    if( e.op == &g_MatOp_Bin )
+        return e.flags == '*' || e.flags == '/' || e.flags == 'm' || e.flags == 'M' ||
+               e.flags == 'n' || e.flags == 'N' || e.flags == 'a';
+    return isAddEx(e) || isCmp(e) || isFused(e);
+}
+
+static inline void makeBinExpr(MatExpr& res, char op, const Mat& a, const MatExpr* ea,
+                               const Mat& b, const MatExpr* eb, double scale)
+{
+    if( ea || eb )
+        MatOp_Fused::makeExpr(res, MatExpr(&g_MatOp_Bin, op, a, b, Mat(), scale, 1), ea, eb);
+    else
+        MatOp_Bin::makeExpr(res, op, a, b, scale);
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////
 
 MatOp::MatOp() {}
@@ -332,12 +388,15 @@ void MatOp::add(const MatExpr& e1, const MatExpr& e2, MatExpr& res) const
         double alpha = 1, beta = 1;
         Scalar s;
         Mat m1, m2;
+        const MatExpr *f1 = 0, *f2 = 0;
         if( isAddEx(e1) && (!e1.b.data || e1.beta == 0) )
         {
             m1 = e1.a;
             alpha = e1.alpha;
             s = e1.s;
         }
+        else if( isFusable(e1) )
+            f1 = &e1;
         else
             e1.op->assign(e1, m1);
 
@@ -347,9 +406,14 @@ void MatOp::add(const MatExpr& e1, const MatExpr& e2, MatExpr& res) const
             beta = e2.alpha;
             s += e2.s;
         }
+        else if( isFusable(e2) )
+            f2 = &e2;
         else
             e2.op->assign(e2, m2);
-        MatOp_AddEx::makeExpr(res, m1, m2, alpha, beta, s);
+        if( f1 || f2 )
+            MatOp_Fused::makeExpr(res, MatExpr(&g_MatOp_AddEx, 0, m1, m2, Mat(), alpha, beta, s), f1, f2);
+        else
+            MatOp_AddEx::makeExpr(res, m1, m2, alpha, beta, s);
     }
     else
         e2.op->add(e1, e2, res);
@@ -360,6 +424,12 @@ void MatOp::add(const MatExpr& expr1, const Scalar& s, MatExpr& res) const
 {
     CV_INSTRUMENT_REGION();
 
+    if( isFusable(expr1) )
+    {
+        MatOp_Fused::makeExpr(res, MatExpr(&g_MatOp_AddEx, 0, Mat(), Mat(), Mat(), 1, 0, s), &expr1, 0);
+        return;
+    }
+
     Mat m1;
     expr1.op->assign(expr1, m1);
     MatOp_AddEx::makeExpr(res, m1, Mat(), 1, 0, s);
@@ -375,12 +445,15 @@ void MatOp::subtract(const MatExpr& e1, const MatExpr& e2, MatExpr& res) const
         double alpha = 1, beta = -1;
         Scalar s;
         Mat m1, m2;
+        const MatExpr *f1 = 0, *f2 = 0;
         if( isAddEx(e1) && (!e1.b.data || e1.beta == 0) )
         {
             m1 = e1.a;
             alpha = e1.alpha;
             s = e1.s;
         }
+        else if( isFusable(e1) )
+            f1 = &e1;
         else
             e1.op->assign(e1, m1);
 
@@ -390,9 +463,14 @@ void MatOp::subtract(const MatExpr& e1, const MatExpr& e2, MatExpr& res) const
             beta = -e2.alpha;
             s -= e2.s;
         }
+        else if( isFusable(e2) )
+            f2 = &e2;
         else
             e2.op->assign(e2, m2);
-        MatOp_AddEx::makeExpr(res, m1, m2, alpha, beta, s);
+        if( f1 || f2 )
+            MatOp_Fused::makeExpr(res, MatExpr(&g_MatOp_AddEx, 0, m1, m2, Mat(), alpha, beta, s), f1, f2);
+        else
+            MatOp_AddEx::makeExpr(res, m1, m2, alpha, beta, s);
     }
     else
         e2.op->subtract(e1, e2, res);
@@ -403,6 +481,12 @@ void MatOp::subtract(const Scalar& s, const MatExpr& expr, MatExpr& res) const
 {
     CV_INSTRUMENT_REGION();
 
+    if( isFusable(expr) )
+    {
+        MatOp_Fused::makeExpr(res, MatExpr(&g_MatOp_AddEx, 0, Mat(), Mat(), Mat(), -1, 0, s), &expr, 0);
+        return;
+    }
+
     Mat m;
     expr.op->assign(expr, m);
     MatOp_AddEx::makeExpr(res, m, Mat(), -1, 0, s);
@@ -416,6 +500,7 @@ void MatOp::multiply(const MatExpr& e1, const MatExpr& e2, MatExpr& res, double
     if( this == e2.op )
     {
         Mat m1, m2;
+        const MatExpr *f1 = 0, *f2 = 0;
 
         if( isReciprocal(e1) )
         {
@@ -424,10 +509,12 @@ void MatOp::multiply(const MatExpr& e1, const MatExpr& e2, MatExpr& res, double
                 scale *= e2.alpha;
                 m2 = e2.a;
             }
+            else if( isFusable(e2) )
+                f2 = &e2;
             else
                 e2.op->assign(e2, m2);
 
-            MatOp_Bin::makeExpr(res, '/', m2, e1.a, scale/e1.alpha);
+            makeBinExpr(res, '/', m2, f2, e1.a, 0, scale/e1.alpha);
         }
         else
         {
@@ -437,6 +524,8 @@ void MatOp::multiply(const MatExpr& e1, const MatExpr& e2, MatExpr& res, double
                 m1 = e1.a;
                 scale *= e1.alpha;
             }
+            else if( isFusable(e1) )
+                f1 = &e1;
             else
                 e1.op->assign(e1, m1);
 
@@ -451,10 +540,12 @@ void MatOp::multiply(const MatExpr& e1, const MatExpr& e2, MatExpr& res, double
                 m2 = e2.a;
                 scale *= e2.alpha;
             }
+            else if( isFusable(e2) )
+                f2 = &e2;
             else
                 e2.op->assign(e2, m2);
 
-            MatOp_Bin::makeExpr(res, op, m1, m2, scale);
+            makeBinExpr(res, op, m1, f1, m2, f2, scale);
         }
     }
     else
@@ -466,6 +557,12 @@ void MatOp::multiply(const MatExpr& expr, double s, MatExpr& res) const
 {
     CV_INSTRUMENT_REGION();
 
+    if( isFusable(expr) )
+    {
+        MatOp_Fused::makeExpr(res, MatExpr(&g_MatOp_AddEx, 0, Mat(), Mat(), Mat(), s, 0), &expr, 0);
+        return;
+    }
+
     Mat m;
     expr.op->assign(expr, m);
     MatOp_AddEx::makeExpr(res, m, Mat(), s, 0);
@@ -483,6 +580,7 @@ void MatOp::divide(const MatExpr& e1, const MatExpr& e2, MatExpr& res, double sc
         else
         {
             Mat m1, m2;
+            const MatExpr *f1 = 0, *f2 = 0;
             char op = '/';
 
             if( isScaled(e1) )
@@ -490,6 +588,8 @@ void MatOp::divide(const MatExpr& e1, const MatExpr& e2, MatExpr& res, double sc
                 m1 = e1.a;
                 scale *= e1.alpha;
             }
+            else if( isFusable(e1) )
+                f1 = &e1;
             else
                 e1.op->assign(e1, m1);
 
@@ -504,9 +604,11 @@ void MatOp::divide(const MatExpr& e1, const MatExpr& e2, MatExpr& res, double sc
                 scale /= e2.alpha;
                 op = '*';
             }
+            else if( isFusable(e2) )
+                f2 = &e2;
             else
                 e2.op->assign(e2, m2);
-            MatOp_Bin::makeExpr(res, op, m1, m2, scale);
+            makeBinExpr(res, op, m1, f1, m2, f2, scale);
         }
     }
     else
@@ -518,6 +620,12 @@ void MatOp::divide(double s, const MatExpr& expr, MatExpr& res) const
 {
     CV_INSTRUMENT_REGION();
 
+    if( isFusable(expr) )
+    {
+        MatOp_Fused::makeExpr(res, MatExpr(&g_MatOp_Bin, '/', Mat(), Mat(), Mat(), s, 0), &expr, 0);
+        return;
+    }
+
     Mat m;
     expr.op->assign(expr, m);
     MatOp_Bin::makeExpr(res, '/', m, Mat(), s);
@@ -528,6 +636,12 @@ void MatOp::abs(const MatExpr& expr, MatExpr& res) const
 {
     CV_INSTRUMENT_REGION();
 
+    if( isFusable(expr) )
+    {
+        MatOp_Fused::makeExpr(res, MatExpr(&g_MatOp_Bin, 'a', Mat(), Mat(), Mat(), 1, 0, Scalar()), &expr, 0);
+        return;
+    }
+
     Mat m;
     expr.op->assign(expr, m);
     MatOp_Bin::makeExpr(res, 'a', m, Mat());
@@ -1522,6 +1636,301 @@ inline void MatOp_Cmp::makeExpr(MatExpr& res, int cmpop, const Mat& a, double al
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+namespace {
+
+// owns the graphs of the fused expressions: the graph is wrapped into a matrix header, which is kept
+// in MatExpr::c, so the graph is shared by the copies of the expression and deleted with the last of them
+class MatExprGraphAllocator CV_FINAL : public MatAllocator
+{
+public:
+    UMatData* allocate(int, const int*, int, void*, size_t*, AccessFlag, UMatUsageFlags) const CV_OVERRIDE
+    {
+        CV_Error(cv::Error::StsNotImplemented,
+                 "The holder of a matrix expression graph has no pixel data and can't allocate matrices");
+    }
+
+    bool allocate(UMatData* u, AccessFlag, UMatUsageFlags) const CV_OVERRIDE
+    {
+        return u != 0;
+    }
+
+    void deallocate(UMatData* u) const CV_OVERRIDE
+    {
+        if (!u)
+            return;
+        CV_Assert(u->urefcount == 0);
+        CV_Assert(u->refcount == 0);
+        delete (Ptr<MatExprGraph>*) u->userdata;
+        delete u;
+    }
+};
+
+static MatExprGraphAllocator& getMatExprGraphAllocator()
+{
+    CV_SINGLETON_LAZY_INIT_REF(MatExprGraphAllocator, new MatExprGraphAllocator())
+}
+
+} // namespace
+
+void MatOp_Fused::makeExpr(MatExpr& res, const Ptr<MatExprGraph>& g)
+{
+    CV_Assert( g );
+    Mat holder(1, (int)sizeof(MatExprGraph), CV_8U, (void*)g.get());
+    UMatData* u = new UMatData(&getMatExprGraphAllocator());
+    u->data = u->origdata = holder.data;
+    u->size = sizeof(MatExprGraph);
+    u->userdata = new Ptr<MatExprGraph>(g);
+    u->refcount = 1;
+    holder.u = u;
+    res = MatExpr(&g_MatOp_Fused, 0, Mat(), Mat(), holder, 1, 0);
+}
+
+const MatExprGraph& MatOp_Fused::graph(const MatExpr& e)
+{
+    CV_DbgAssert( isFused(e) && e.c.u && e.c.u->currAllocator == &getMatExprGraphAllocator() );
+    return **(const Ptr<MatExprGraph>*) e.c.u->userdata;
+}
+
+// appends the nodes computing the expression e (MatOp_AddEx, MatOp_Bin or MatOp_Cmp) with the operands
+// na and nb to the graph, the same way as the corresponding assign() does it for the result type _type.
+// e.a and e.b are not used. Returns the result node or -1 if the expression can not be fused.
+static int lowerExpr(MatExprGraph& g, const MatExpr& e, int na, int nb, int _type)
+{
+    typedef MatExprGraph G;
+
+    if( na < 0 )
+        return -1;
+    int depth = g.nodes[na].depth;
+    if( nb >= 0 && g.nodes[nb].depth != depth )
+        return -1;
+
+    if( isAddEx(e) )
+    {
+        bool direct = _type == -1 || _type == CV_MAKETYPE(depth, g.cn);
+        if( nb >= 0 )
+        {
+            if( e.s == Scalar() || !e.s.isReal() )
+            {
+                int n = g.addNode(G::OP_AFFINE, depth, na, nb, e.alpha, e.beta);
+                return e.s.isReal() || n < 0 ? n : g.addNode(G::OP_AFFINE, depth, n, -1, 1, 0, e.s);
+            }
+            return g.addNode(G::OP_AFFINE, depth, na, nb, e.alpha, e.beta, Scalar::all(e.s[0]));
+        }
+        if( e.s.isReal() && (!direct || fabs(e.alpha) != 1) )
+            return g.addNode(G::OP_AFFINE, direct ? depth : CV_MAT_DEPTH(_type), na, -1,
+                             e.alpha, 0, Scalar::all(e.s[0]));
+        if( e.alpha == 1 || e.alpha == -1 )
+            return g.addNode(G::OP_AFFINE, depth, na, -1, e.alpha, 0, e.s);
+        int n = g.addNode(G::OP_AFFINE, depth, na, -1, e.alpha, 0);
+        return n < 0 ? n : g.addNode(G::OP_AFFINE, depth, n, -1, 1, 0, e.s);
+    }
+
+    if( isCmp(e) )
+    {
+        if( nb >= 0 )
+            return g.addNode(G::OP_CMP, CV_8U, na, nb, 1, 0, Scalar(), e.flags);
+        return g.cn == 1 ? g.addNode(G::OP_CMP, CV_8U, na, -1, 1, 0, Scalar::all(e.alpha), e.flags) : -1;
+    }
+
+    if( e.op == &g_MatOp_Bin )
+    {
+        switch( e.flags )
+        {
+        case '*':
+            return nb >= 0 ? g.addNode(G::OP_MUL, depth, na, nb, e.alpha) : -1;
+        case '/':
+            return nb >= 0 ? g.addNode(G::OP_DIV, depth, na, nb, e.alpha) :
+                             g.addNode(G::OP_RECIP, depth, na, -1, e.alpha);
+        case 'm':
+        case 'M':
+            return nb >= 0 ? g.addNode(e.flags == 'm' ? G::OP_MIN : G::OP_MAX, depth, na, nb) : -1;
+        case 'n':
+        case 'N':
+            return g.addNode(e.flags == 'n' ? G::OP_MIN : G::OP_MAX, depth, na, -1, 1, 0, Scalar::all(e.s[0]));
+        case 'a':
+            return nb >= 0 ? g.addNode(G::OP_ABSDIFF, depth, na, nb) :
+                             g.addNode(G::OP_ABSDIFF, depth, na, -1, 1, 0, e.s);
+        default:
+            break;
+        }
+    }
+    return -1;
+}
+
+// appends the nodes computing the expression e to the graph, returns the result node or -1
+static int addExprNodes(MatExprGraph& g, const MatExpr& e)
+{
+    if( isIdentity(e) )
+        return g.addInput(e.a);
+
+    if( isFused(e) )
+    {
+        const MatExprGraph& src = MatOp_Fused::graph(e);
+        if( !g.inputs.empty() && (src.cn != g.cn || src.inputs[0].size() != g.inputs[0].size()) )
+            return -1;
+        if( g.nodes.size() + src.nodes.size() > (size_t)MatExprGraph::MAX_NODES )
+        {
+            // the chain is too long, compute this part separately
+            Mat m;
+            e.op->assign(e, m);
+            return g.addInput(m);
+        }
+        std::vector<int> remap(src.nodes.size());
+        for( size_t i = 0; i < src.nodes.size(); i++ )
+        {
+            const MatExprGraph::Node& node = src.nodes[i];
+            int idx = node.op == MatExprGraph::OP_INPUT ? g.addInput(src.inputs[node.arg[0]]) :
+                g.addNode(node.op, node.depth, remap[node.arg[0]], node.arg[1] >= 0 ? remap[node.arg[1]] : -1,
+                          node.alpha, node.beta, node.s, node.cmpop);
+            if( idx < 0 )
+                return -1;
+            remap[i] = idx;
+        }
+        return remap.back();
+    }
+
+    if( isFusable(e) )
+    {
+        int na = g.addInput(e.a), nb = -1;
+        if( e.b.data && (nb = g.addInput(e.b)) < 0 )
+            return -1;
+        return lowerExpr(g, e, na, nb, -1);
+    }
+    return -1;
+}
+
+void MatOp_Fused::assign(const MatExpr& e, Mat& m, int _type) const
+{
+    const MatExprGraph& g = graph(e);
+    if( _type != -1 )
+        CV_Assert( CV_MAT_CN(_type) == g.cn );
+
+    // only MatOp_AddEx::assign() depends on the result type: it computes the result directly in that
+    // type if the destination matrix is already allocated, otherwise it is converted after the operation
+    if( _type == -1 || _type == type(e) || !m.data || !isAddEx(g.root) )
+    {
+        g.eval(m, _type == -1 ? -1 : CV_MAT_DEPTH(_type));
+        return;
+    }
+
+    MatExprGraph temp = g;
+    temp.nodes.resize(g.rootStart);
+    CV_Assert( lowerExpr(temp, g.root, g.rootArgs[0], g.rootArgs[1], _type) >= 0 );
+    temp.eval(m, CV_MAT_DEPTH(_type));
+}
+
+void MatOp_Fused::roi(const MatExpr& e, const Range& rowRange, const Range& colRange, MatExpr& res) const
+{
+    Ptr<MatExprGraph> g = makePtr<MatExprGraph>(graph(e));
+    for( size_t i = 0; i < g->inputs.size(); i++ )
+        g->inputs[i] = g->inputs[i](rowRange, colRange);
+    makeExpr(res, g);
+}
+
+void MatOp_Fused::diag(const MatExpr& e, int d, MatExpr& res) const
+{
+    Ptr<MatExprGraph> g = makePtr<MatExprGraph>(graph(e));
+    for( size_t i = 0; i < g->inputs.size(); i++ )
+        g->inputs[i] = g->inputs[i].diag(d);
+    makeExpr(res, g);
+}
+
+// the scalar operations are merged into the last operation of the chain, as MatOp_AddEx and MatOp_Bin do it
+
+void MatOp_Fused::add(const MatExpr& e, const Scalar& s, MatExpr& res) const
+{
+    CV_INSTRUMENT_REGION();
+
+    MatExpr root = graph(e).root;
+    root.s += s;
+    if( !isAddEx(root) || !makeExpr(res, e, root) )
+        MatOp::add(e, s, res);
+}
+
+void MatOp_Fused::subtract(const Scalar& s, const MatExpr& e, MatExpr& res) const
+{
+    CV_INSTRUMENT_REGION();
+
+    MatExpr root = graph(e).root;
+    root.alpha = -root.alpha;
+    root.beta = -root.beta;
+    root.s = s - root.s;
+    if( !isAddEx(root) || !makeExpr(res, e, root) )
+        MatOp::subtract(s, e, res);
+}
+
+void MatOp_Fused::multiply(const MatExpr& e, double s, MatExpr& res) const
+{
+    CV_INSTRUMENT_REGION();
+
+    MatExpr root = graph(e).root;
+    bool merge = isAddEx(root) || isBin(root, '*') || isBin(root, '/');
+    root.alpha *= s;
+    if( isAddEx(root) )
+    {
+        root.beta *= s;
+        root.s *= s;
+    }
+    if( !merge || !makeExpr(res, e, root) )
+        MatOp::multiply(e, s, res);
+}
+
+Size MatOp_Fused::size(const MatExpr& e) const
+{
+    return graph(e).inputs[0].size();
+}
+
+int MatOp_Fused::type(const MatExpr& e) const
+{
+    return CV_MAKETYPE(graph(e).nodes.back().depth, graph(e).cn);
+}
+
+void MatOp_Fused::makeExpr(MatExpr& res, const MatExpr& root, const MatExpr* ea, const MatExpr* eb)
+{
+    Ptr<MatExprGraph> g = makePtr<MatExprGraph>();
+    int na = ea ? addExprNodes(*g, *ea) : g->addInput(root.a);
+    int nb = eb ? addExprNodes(*g, *eb) : root.b.data ? g->addInput(root.b) : -1;
+    int r = -1;
+    if( na >= 0 && (nb >= 0 || (!eb && !root.b.data)) )
+    {
+        g->root = MatExpr(root.op, root.flags, Mat(), Mat(), Mat(), root.alpha, root.beta, root.s);
+        g->rootArgs[0] = na;
+        g->rootArgs[1] = nb;
+        g->rootStart = (int)g->nodes.size();
+        r = lowerExpr(*g, g->root, na, nb, -1);
+    }
+
+    if( r < 0 )
+    {
+        // the operands have different sizes or types, the graph is full etc.:
+        // compute them separately, as the element-wise operations without fusion do
+        MatExpr e = root;
+        if( ea )
+            ea->op->assign(*ea, e.a);
+        if( eb )
+            eb->op->assign(*eb, e.b);
+        if( e.op == &g_MatOp_Bin )
+            e.beta = e.b.data ? 1 : 0;
+        res = e;
+        return;
+    }
+
+    makeExpr(res, g);
+}
+
+bool MatOp_Fused::makeExpr(MatExpr& res, const MatExpr& e, const MatExpr& root)
+{
+    Ptr<MatExprGraph> g = makePtr<MatExprGraph>(graph(e));
+    g->nodes.resize(g->rootStart);
+    g->root = root;
+    if( lowerExpr(*g, root, g->rootArgs[0], g->rootArgs[1], -1) < 0 )
+        return false;
+    makeExpr(res, g);
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 void MatOp_T::assign(const MatExpr& e, Mat& m, int _type) const
 {
     Mat temp, &dst = _type == -1 || _type == e.a.type() ? m : temp;
@@ -0,0 +1,318 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+
+#include <opencv2/core/utils/configuration.private.hpp>
+#include <opencv2/core/utils/tls.hpp>
+#include <opencv2/core/utils/mat_pool.hpp>
+
+#include "opencv2/core/bufferpool.hpp"
+
+namespace cv {
+
+namespace {
+
+// Size classes: 4 classes per power of two, the smallest class holds buffers up to 256 bytes
+static const int MAT_POOL_MIN_CLASS_SHIFT = 8;
+static const int MAT_POOL_CLASSES_PER_POW2 = 4;
+static const int MAT_POOL_NUM_CLASSES = ((int)sizeof(size_t)*8 - MAT_POOL_MIN_CLASS_SHIFT) * MAT_POOL_CLASSES_PER_POW2 + 1;
+
+static inline int getSizeClass(size_t size, size_t& capacity)
+{
+    if (size <= ((size_t)1 << MAT_POOL_MIN_CLASS_SHIFT))
+    {
+        capacity = (size_t)1 << MAT_POOL_MIN_CLASS_SHIFT;
+        return 0;
+    }
+    int p = 0;  // 2^p <= size-1 < 2^(p+1)
+    for (size_t v = size - 1; v > 1; v >>= 1)
+        p++;
+    const int stepShift = p - 2;
+    const size_t step = (size_t)1 << stepShift;
+    capacity = (size + step - 1) & ~(step - 1);
+    return (p - MAT_POOL_MIN_CLASS_SHIFT) * MAT_POOL_CLASSES_PER_POW2 + (int)(capacity >> stepShift) - MAT_POOL_CLASSES_PER_POW2;
+}
+
+static inline size_t getSizeClassCapacity(int idx)
+{
+    if (idx == 0)
+        return (size_t)1 << MAT_POOL_MIN_CLASS_SHIFT;
+    const int p = MAT_POOL_MIN_CLASS_SHIFT + (idx - 1) / MAT_POOL_CLASSES_PER_POW2;
+    const size_t m = (size_t)((idx - 1) % MAT_POOL_CLASSES_PER_POW2 + MAT_POOL_CLASSES_PER_POW2 + 1);
+    return m << (p - 2);
+}
+
+struct MatPoolThreadCache
+{
+    Mutex mutex;  // uncontended, except trim() / statistics requests from other threads
+    std::vector<void*> buffers[MAT_POOL_NUM_CLASSES];
+    size_t residentBytes;
+    size_t residentBuffers;
+    uint64_t hits;
+    uint64_t misses;
+
+    MatPoolThreadCache()
+        : residentBytes(0), residentBuffers(0), hits(0), misses(0)
+    {
+        // nothing
+    }
+    ~MatPoolThreadCache()
+    {
+        releaseBuffers(0);
+    }
+
+    // synchronized
+    void releaseBuffers(size_t limit)
+    {
+        for (int idx = MAT_POOL_NUM_CLASSES - 1; idx >= 0 && residentBytes > limit; idx--)
+        {
+            std::vector<void*>& list = buffers[idx];
+            const size_t capacity = getSizeClassCapacity(idx);
+            while (!list.empty() && residentBytes > limit)
+            {
+                fastFree(list.back());
+                list.pop_back();
+                CV_DbgAssert(residentBytes >= capacity);
+                residentBytes -= capacity;
+                residentBuffers--;
+            }
+            if (list.empty())
+                std::vector<void*>().swap(list);
+        }
+    }
+};
+
+class MatPoolTLSData : public TLSDataAccumulator<MatPoolThreadCache>
+{
+protected:
+    // cached memory of terminated threads is released immediately, counters are preserved
+    virtual void deleteDataInstance(void* pData) const CV_OVERRIDE
+    {
+        MatPoolThreadCache* cache = (MatPoolThreadCache*)pData;
+        {
+            AutoLock lock(cache->mutex);
+            cache->releaseBuffers(0);
+        }
+        TLSDataAccumulator<MatPoolThreadCache>::deleteDataInstance(pData);
+    }
+};
+
+class PoolMatAllocator CV_FINAL : public MatAllocator, public BufferPoolController
+{
+public:
+    PoolMatAllocator()
+        // buffer size limit is fixed: size class of the buffer is computed again on deallocation
+        : maxBufferSize(utils::getConfigurationParameterSizeT("OPENCV_MAT_POOL_MAX_BUFFER_SIZE", (size_t)64 << 20)),
+          maxThreadReservedSize(utils::getConfigurationParameterSizeT("OPENCV_MAT_POOL_THREAD_LIMIT", (size_t)256 << 20))
+    {
+        // nothing
+    }
+
+    UMatData* allocate(int dims, const int* sizes, int type,
+                       void* data0, size_t* step, AccessFlag /*flags*/, UMatUsageFlags /*usageFlags*/) const CV_OVERRIDE
+    {
+        size_t total = CV_ELEM_SIZE(type);
+        for( int i = dims-1; i >= 0; i-- )
+        {
+            if( step )
+            {
+                if( data0 && step[i] != CV_AUTOSTEP )
+                {
+                    CV_Assert(total <= step[i]);
+                    total = step[i];
+                }
+                else
+                    step[i] = total;
+            }
+            total *= sizes[i];
+        }
+        uchar* data = (uchar*)data0;
+        if (!data)
+        {
+            MatPoolThreadCache& cache = tls.getRef();
+            if (total <= maxBufferSize)
+            {
+                size_t capacity = 0;
+                int idx = getSizeClass(total, capacity);
+                {
+                    AutoLock lock(cache.mutex);
+                    std::vector<void*>& list = cache.buffers[idx];
+                    if (!list.empty())
+                    {
+                        data = (uchar*)list.back();
+                        list.pop_back();
+                        cache.residentBytes -= capacity;
+                        cache.residentBuffers--;
+                        cache.hits++;
+                    }
+                    else
+                    {
+                        cache.misses++;
+                    }
+                }
+                if (!data)
+                {
+                    data = (uchar*)fastMalloc(capacity);
+                    matFirstTouchHint(data, capacity);
+                }
+            }
+            else
+            {
+                {
+                    AutoLock lock(cache.mutex);
+                    cache.misses++;
+                }
+                data = (uchar*)fastMalloc(total);
+                matFirstTouchHint(data, total);
+            }
+        }
+        UMatData* u = new UMatData(this);
+        u->data = u->origdata = data;
+        u->size = total;
+        if(data0)
+            u->flags |= UMatData::USER_ALLOCATED;
+
+        return u;
+    }
+
+    bool allocate(UMatData* u, AccessFlag /*accessFlags*/, UMatUsageFlags /*usageFlags*/) const CV_OVERRIDE
+    {
+        if(!u) return false;
+        return true;
+    }
+
+    void deallocate(UMatData* u) const CV_OVERRIDE
+    {
+        if(!u)
+            return;
+
+        CV_Assert(u->urefcount == 0);
+        CV_Assert(u->refcount == 0);
+        if( !(u->flags & UMatData::USER_ALLOCATED) )
+        {
+            bool cached = false;
+            if (u->size <= maxBufferSize)
+            {
+                size_t capacity = 0;
+                int idx = getSizeClass(u->size, capacity);
+                MatPoolThreadCache& cache = tls.getRef();
+                AutoLock lock(cache.mutex);
+                if (cache.residentBytes + capacity <= maxThreadReservedSize)
+                {
+                    cache.buffers[idx].push_back(u->origdata);
+                    cache.residentBytes += capacity;
+                    cache.residentBuffers++;
+                    cached = true;
+                }
+            }
+            if (!cached)
+                fastFree(u->origdata);
+            u->origdata = 0;
+        }
+        delete u;
+    }
+
+    BufferPoolController* getBufferPoolController(const char* id) const CV_OVERRIDE
+    {
+        CV_UNUSED(id);
+        return const_cast<PoolMatAllocator*>(this);
+    }
+
+    // BufferPoolController interface: limits are applied to each thread cache
+    size_t getReservedSize() const CV_OVERRIDE
+    {
+        return getStatistics().residentBytes;
+    }
+    size_t getMaxReservedSize() const CV_OVERRIDE { return maxThreadReservedSize; }
+    void setMaxReservedSize(size_t size) CV_OVERRIDE
+    {
+        maxThreadReservedSize = size;
+        trim(size);
+    }
+    void freeAllReservedBuffers() CV_OVERRIDE
+    {
+        trim(0);
+    }
+
+    utils::MatPoolStatistics getStatistics() const
+    {
+        utils::MatPoolStatistics stats = {};
+        std::vector<MatPoolThreadCache*> caches;
+        tls.gather(caches);
+        for (size_t i = 0; i < caches.size(); i++)
+        {
+            MatPoolThreadCache& cache = *caches[i];
+            AutoLock lock(cache.mutex);
+            stats.hits += cache.hits;
+            stats.misses += cache.misses;
+            stats.residentBytes += cache.residentBytes;
+            stats.residentBuffers += cache.residentBuffers;
+        }
+        return stats;
+    }
+
+    void resetStatistics()
+    {
+        std::vector<MatPoolThreadCache*> caches;
+        tls.gather(caches);
+        for (size_t i = 0; i < caches.size(); i++)
+        {
+            MatPoolThreadCache& cache = *caches[i];
+            AutoLock lock(cache.mutex);
+            cache.hits = 0;
+            cache.misses = 0;
+        }
+    }
+
+    void trim(size_t limit)
+    {
+        std::vector<MatPoolThreadCache*> caches;
+        tls.gather(caches);
+        for (size_t i = 0; i < caches.size(); i++)
+        {
+            MatPoolThreadCache& cache = *caches[i];
+            AutoLock lock(cache.mutex);
+            cache.releaseBuffers(limit);
+        }
+    }
+
+protected:
+    const size_t maxBufferSize;
+    volatile size_t maxThreadReservedSize;
+    mutable MatPoolTLSData tls;
+};
+
+static PoolMatAllocator& getPoolMatAllocator()
+{
+    CV_SINGLETON_LAZY_INIT_REF(PoolMatAllocator, new PoolMatAllocator())
+}
+
+} // namespace
+
+MatAllocator* Mat::getPoolAllocator()
+{
+    return &getPoolMatAllocator();
+}
+
+namespace utils {
+
+MatPoolStatistics getMatPoolStatistics()
+{
+    return getPoolMatAllocator().getStatistics();
+}
+
+void resetMatPoolStatistics()
+{
+    getPoolMatAllocator().resetStatistics();
+}
+
+void trimMatPool(size_t maxResidentBytes)
+{
+    getPoolMatAllocator().trim(maxResidentBytes);
+}
+
+} // namespace utils
+
+} // namespace cv
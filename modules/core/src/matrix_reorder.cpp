@@ -0,0 +1,776 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html
+
+#include "precomp.hpp"
+
+/*
+Tiled reordering engine used by transposeND, reorderImage, transpose, rotate and flip.
+
+A reordering is described by the axes of the destination array (outer to inner). Every axis
+has the source step of the matching source axis (negative for the reversed axes) and optionally
+the table of the source indices (channel permutations). Adjacent axes that are contiguous in both
+arrays are merged, the inner contiguous axis is folded into the element. Then the inner
+destination axis selects the kernel:
+ - contiguous or reversed rows are copied,
+ - if another axis is contiguous in the source, the pair is transposed by L1-sized tiles with
+   SIMD micro-kernels (or (de)interleaved, when it is the short channel axis),
+ - everything else is gathered element by element.
+The tiles (or rows) of all the outer axes are processed in parallel.
+*/
+
+namespace cv {
+
+namespace {
+
+struct ReorderAxis
+{
+    int size;
+    size_t dstep;       // bytes
+    ptrdiff_t sstep;    // bytes, negative for the reversed axes
+    const int* tab;     // source indices of the destination indices (or 0)
+
+    inline ptrdiff_t sofs(int i) const { return (ptrdiff_t)(tab ? tab[i] : i)*sstep; }
+};
+
+enum { REORDER_MAX_AXES = CV_MAX_DIM + 2 };
+
+enum ReorderKind
+{
+    REORDER_KIND_COPY,          // inner axis is contiguous in both arrays
+    REORDER_KIND_REVERSE,       // inner axis is reversed in the source
+    REORDER_KIND_TRANSPOSE,     // another axis is contiguous in the source
+    REORDER_KIND_DEINTERLEAVE,  // ... and it is a short channel axis (to planar)
+    REORDER_KIND_INTERLEAVE,    // inner axis is a short channel axis of the planar source
+    REORDER_KIND_GATHER
+};
+
+//////////////////////////////////////// scalar kernels ////////////////////////////////////////
+
+// dst[k*dstep + j] = src[j*sstep + k], j < lines, k < len (in elements)
+template<typename T> static void
+transposeBlock_( const uchar* src, ptrdiff_t sstep, uchar* dst, ptrdiff_t dstep, int lines, int len )
+{
+    int j = 0;
+    for( ; j <= lines - 4; j += 4 )
+    {
+        const T* s0 = (const T*)(src + sstep*j);
+        const T* s1 = (const T*)(src + sstep*(j+1));
+        const T* s2 = (const T*)(src + sstep*(j+2));
+        const T* s3 = (const T*)(src + sstep*(j+3));
+        for( int k = 0; k < len; k++ )
+        {
+            T* d = (T*)(dst + dstep*k) + j;
+            d[0] = s0[k]; d[1] = s1[k]; d[2] = s2[k]; d[3] = s3[k];
+        }
+    }
+    for( ; j < lines; j++ )
+    {
+        const T* s0 = (const T*)(src + sstep*j);
+        for( int k = 0; k < len; k++ )
+            ((T*)(dst + dstep*k))[j] = s0[k];
+    }
+}
+
+template<typename T> static void
+reverseRow_( const uchar* src, uchar* dst, int len )
+{
+    const T* s = (const T*)src;
+    T* d = (T*)dst;
+    for( int j = 0; j < len; j++ )
+        d[j] = s[-j];
+}
+
+template<typename T> static void
+gatherRow_( const uchar* src, const ReorderAxis& ax, uchar* dst, int len )
+{
+    T* d = (T*)dst;
+    if( ax.tab )
+    {
+        for( int j = 0; j < len; j++ )
+            d[j] = *(const T*)(src + ax.tab[j]*ax.sstep);
+    }
+    else
+    {
+        for( int j = 0; j < len; j++ )
+            d[j] = *(const T*)(src + j*ax.sstep);
+    }
+}
+
+// the element is a single channel here
+template<typename T> static void
+deinterleave_( const uchar* src, const ReorderAxis& ax, const ReorderAxis& cax, uchar* dst, int len )
+{
+    for( int c = 0; c < cax.size; c++ )
+    {
+        const T* s = (const T*)(src + cax.sofs(c));
+        T* d = (T*)(dst + cax.dstep*c);
+        const ptrdiff_t step = ax.sstep / (ptrdiff_t)sizeof(T);
+        for( int j = 0; j < len; j++ )
+            d[j] = s[j*step];
+    }
+}
+
+template<typename T> static void
+interleave_( const uchar* src, const ReorderAxis& ax, const ReorderAxis& cax, uchar* dst, int len )
+{
+    const int cn = cax.size;
+    for( int c = 0; c < cn; c++ )
+    {
+        const T* s = (const T*)(src + cax.sofs(c));
+        T* d = (T*)dst + c;
+        const ptrdiff_t step = ax.sstep / (ptrdiff_t)sizeof(T);
+        for( int j = 0; j < len; j++ )
+            d[j*cn] = s[j*step];
+    }
+}
+
+//////////////////////////////////////// SIMD kernels ////////////////////////////////////////
+
+#if CV_SIMD128
+
+static inline void transpose16x16_8u( const uchar* src, ptrdiff_t sstep, uchar* dst, ptrdiff_t dstep )
+{
+    v_uint8x16 r[16], t[16];
+    for( int i = 0; i < 16; i++ )
+        r[i] = v_load(src + sstep*i);
+    // pairs of rows
+    for( int g = 0; g < 8; g++ )
+        v_zip(r[g*2], r[g*2+1], t[g], t[g+8]);
+    // quads of rows
+    v_uint16x8 u[16];
+    for( int h = 0; h < 16; h += 8 )
+        for( int g = 0; g < 4; g++ )
+            v_zip(v_reinterpret_as_u16(t[h+g*2]), v_reinterpret_as_u16(t[h+g*2+1]), u[h+g], u[h+g+4]);
+    // octets of rows
+    v_uint32x4 w[16];
+    for( int q = 0; q < 16; q += 4 )
+        for( int g = 0; g < 2; g++ )
+            v_zip(v_reinterpret_as_u32(u[q+g*2]), v_reinterpret_as_u32(u[q+g*2+1]), w[q+g], w[q+g+2]);
+    for( int p = 0; p < 16; p += 2 )
+    {
+        v_store(dst + dstep*p, v_reinterpret_as_u8(v_combine_low(w[p], w[p+1])));
+        v_store(dst + dstep*(p+1), v_reinterpret_as_u8(v_combine_high(w[p], w[p+1])));
+    }
+}
+
+static inline void transpose8x8_16u( const uchar* src, ptrdiff_t sstep, uchar* dst, ptrdiff_t dstep )
+{
+    v_uint16x8 r[8], t[8];
+    for( int i = 0; i < 8; i++ )
+        r[i] = v_load((const ushort*)(src + sstep*i));
+    for( int g = 0; g < 4; g++ )
+        v_zip(r[g*2], r[g*2+1], t[g], t[g+4]);
+    v_uint32x4 u[8];
+    for( int h = 0; h < 8; h += 4 )
+        for( int g = 0; g < 2; g++ )
+            v_zip(v_reinterpret_as_u32(t[h+g*2]), v_reinterpret_as_u32(t[h+g*2+1]), u[h+g], u[h+g+2]);
+    for( int p = 0; p < 8; p += 2 )
+    {
+        v_store((ushort*)(dst + dstep*p), v_reinterpret_as_u16(v_combine_low(u[p], u[p+1])));
+        v_store((ushort*)(dst + dstep*(p+1)), v_reinterpret_as_u16(v_combine_high(u[p], u[p+1])));
+    }
+}
+
+static inline void transpose4x4_32u( const uchar* src, ptrdiff_t sstep, uchar* dst, ptrdiff_t dstep )
+{
+    v_uint32x4 a0 = v_load((const unsigned*)src), a1 = v_load((const unsigned*)(src + sstep));
+    v_uint32x4 a2 = v_load((const unsigned*)(src + sstep*2)), a3 = v_load((const unsigned*)(src + sstep*3));
+    v_uint32x4 b0, b1, b2, b3;
+    v_transpose4x4(a0, a1, a2, a3, b0, b1, b2, b3);
+    v_store((unsigned*)dst, b0);
+    v_store((unsigned*)(dst + dstep), b1);
+    v_store((unsigned*)(dst + dstep*2), b2);
+    v_store((unsigned*)(dst + dstep*3), b3);
+}
+
+typedef void (*TransposeMicroKernel)( const uchar* src, ptrdiff_t sstep, uchar* dst, ptrdiff_t dstep );
+
+template<int esz, int V, TransposeMicroKernel kernel> static void
+transposeBlockSIMD( const uchar* src, ptrdiff_t sstep, uchar* dst, ptrdiff_t dstep, int lines, int len )
+{
+    typedef typename std::conditional<esz == 1, uchar, typename std::conditional<esz == 2, ushort, unsigned>::type>::type T;
+    int j = 0;
+    for( ; j <= lines - V; j += V )
+    {
+        int k = 0;
+        for( ; k <= len - V; k += V )
+            kernel(src + sstep*j + k*esz, sstep, dst + dstep*k + j*esz, dstep);
+        if( k < len )
+            transposeBlock_<T>(src + sstep*j + k*esz, sstep, dst + dstep*k + j*esz, dstep, V, len - k);
+    }
+    if( j < lines )
+        transposeBlock_<T>(src + sstep*j, sstep, dst + j*esz, dstep, lines - j, len);
+}
+
+template<typename VT> static void
+reverseRowSIMD( const uchar* src, uchar* dst, int len )
+{
+    typedef typename VT::lane_type T;
+    const int L = VT::nlanes;
+    const T* s = (const T*)src;
+    T* d = (T*)dst;
+    int j = 0;
+    for( ; j <= len - L; j += L )
+        v_store(d + j, v_reverse(v_load(s - j - (L - 1))));
+    for( ; j < len; j++ )
+        d[j] = s[-j];
+}
+
+// scn-channel source, the channel axis is gathered into the planes of dst
+template<typename VT> static void
+deinterleaveSIMD( const uchar* src, const ReorderAxis& ax, const ReorderAxis& cax, uchar* dst, int len )
+{
+    typedef typename VT::lane_type T;
+    const int L = VT::nlanes, esz = (int)sizeof(T);
+    const bool reversed = ax.sstep < 0;
+    const int scn = (int)(std::abs(ax.sstep) / esz);
+    const int dcn = cax.size;
+    int idx[4];
+    T* d[4];
+    for( int c = 0; c < dcn; c++ )
+    {
+        idx[c] = cax.tab ? cax.tab[c] : c;
+        d[c] = (T*)(dst + cax.dstep*c);
+    }
+
+    int j = 0;
+    for( ; j <= len - L; j += L )
+    {
+        const T* s = (const T*)src + (reversed ? -(ptrdiff_t)(j + L - 1)*scn : (ptrdiff_t)j*scn);
+        VT v[4];
+        if( scn == 2 )
+            v_load_deinterleave(s, v[0], v[1]);
+        else if( scn == 3 )
+            v_load_deinterleave(s, v[0], v[1], v[2]);
+        else
+            v_load_deinterleave(s, v[0], v[1], v[2], v[3]);
+        for( int c = 0; c < dcn; c++ )
+            v_store(d[c] + j, reversed ? v_reverse(v[idx[c]]) : v[idx[c]]);
+    }
+    if( j < len )
+        deinterleave_<T>(src + ax.sstep*j, ax, cax, (uchar*)(d[0] + j), len - j);
+}
+
+// dcn planes of the source are interleaved into dst
+template<typename VT> static void
+interleaveSIMD( const uchar* src, const ReorderAxis& ax, const ReorderAxis& cax, uchar* dst, int len )
+{
+    typedef typename VT::lane_type T;
+    const int L = VT::nlanes;
+    const bool reversed = ax.sstep < 0;
+    const int dcn = cax.size;
+    const T* s[4];
+    for( int c = 0; c < dcn; c++ )
+        s[c] = (const T*)(src + cax.sofs(c));
+    T* d = (T*)dst;
+
+    int j = 0;
+    for( ; j <= len - L; j += L )
+    {
+        VT v[4];
+        for( int c = 0; c < dcn; c++ )
+            v[c] = reversed ? v_reverse(v_load(s[c] - j - (L - 1))) : v_load(s[c] + j);
+        if( dcn == 2 )
+            v_store_interleave(d + j*dcn, v[0], v[1]);
+        else if( dcn == 3 )
+            v_store_interleave(d + j*dcn, v[0], v[1], v[2]);
+        else
+            v_store_interleave(d + j*dcn, v[0], v[1], v[2], v[3]);
+    }
+    if( j < len )
+        interleave_<T>(src + ax.sstep*j, ax, cax, (uchar*)(d + j*dcn), len - j);
+}
+
+#endif // CV_SIMD128
+
+//////////////////////////////////////// kernel tables ////////////////////////////////////////
+
+typedef void (*TransposeBlockFunc)( const uchar* src, ptrdiff_t sstep, uchar* dst, ptrdiff_t dstep, int lines, int len );
+typedef void (*ReverseRowFunc)( const uchar* src, uchar* dst, int len );
+typedef void (*GatherRowFunc)( const uchar* src, const ReorderAxis& ax, uchar* dst, int len );
+typedef void (*ChannelsFunc)( const uchar* src, const ReorderAxis& ax, const ReorderAxis& cax, uchar* dst, int len );
+
+struct ReorderFuncs
+{
+    TransposeBlockFunc transposeBlock;
+    ReverseRowFunc reverseRow;
+    GatherRowFunc gatherRow;
+};
+
+template<typename T> static ReorderFuncs makeReorderFuncs()
+{
+    ReorderFuncs f = { transposeBlock_<T>, reverseRow_<T>, gatherRow_<T> };
+    return f;
+}
+
+static bool getReorderFuncs( size_t esz, ReorderFuncs& f )
+{
+    switch( esz )
+    {
+    case 1: f = makeReorderFuncs<uchar>(); break;
+    case 2: f = makeReorderFuncs<ushort>(); break;
+    case 3: f = makeReorderFuncs<Vec3b>(); break;
+    case 4: f = makeReorderFuncs<int>(); break;
+    case 6: f = makeReorderFuncs<Vec3s>(); break;
+    case 8: f = makeReorderFuncs<int64>(); break;
+    case 12: f = makeReorderFuncs<Vec3i>(); break;
+    case 16: f = makeReorderFuncs<Vec4i>(); break;
+    case 24: f = makeReorderFuncs<Vec6i>(); break;
+    case 32: f = makeReorderFuncs<Vec8i>(); break;
+    default: return false;
+    }
+#if CV_SIMD128
+    if( esz == 1 )
+    {
+        f.transposeBlock = transposeBlockSIMD<1, 16, transpose16x16_8u>;
+        f.reverseRow = reverseRowSIMD<v_uint8x16>;
+    }
+    else if( esz == 2 )
+    {
+        f.transposeBlock = transposeBlockSIMD<2, 8, transpose8x8_16u>;
+        f.reverseRow = reverseRowSIMD<v_uint16x8>;
+    }
+    else if( esz == 4 )
+    {
+        f.transposeBlock = transposeBlockSIMD<4, 4, transpose4x4_32u>;
+        f.reverseRow = reverseRowSIMD<v_uint32x4>;
+    }
+#endif
+    return true;
+}
+
+static ChannelsFunc getDeinterleaveFunc( size_t esz )
+{
+#if CV_SIMD128
+    return esz == 1 ? deinterleaveSIMD<v_uint8x16> : esz == 2 ? deinterleaveSIMD<v_uint16x8> :
+           esz == 4 ? deinterleaveSIMD<v_uint32x4> : 0;
+#else
+    return esz == 1 ? deinterleave_<uchar> : esz == 2 ? deinterleave_<ushort> : esz == 4 ? deinterleave_<int> : 0;
+#endif
+}
+
+static ChannelsFunc getInterleaveFunc( size_t esz )
+{
+#if CV_SIMD128
+    return esz == 1 ? interleaveSIMD<v_uint8x16> : esz == 2 ? interleaveSIMD<v_uint16x8> :
+           esz == 4 ? interleaveSIMD<v_uint32x4> : 0;
+#else
+    return esz == 1 ? interleave_<uchar> : esz == 2 ? interleave_<ushort> : esz == 4 ? interleave_<int> : 0;
+#endif
+}
+
+//////////////////////////////////////// the engine ////////////////////////////////////////
+
+class ReorderInvoker : public ParallelLoopBody
+{
+public:
+    ReorderInvoker( const uchar* src_, uchar* dst_, const ReorderAxis* axes_, int naxes_, size_t esz_ )
+        : src(src_), dst(dst_), naxes(naxes_), esz(esz_), kind(REORDER_KIND_GATHER), e(-1)
+    {
+        for( int i = 0; i < naxes; i++ )
+            axes[i] = axes_[i];
+        simplify();
+        classify();
+    }
+
+    size_t jobs() const
+    {
+        size_t n = (size_t)divUp(axes[naxes-1].size, tileD);
+        if( e >= 0 )
+            n *= (size_t)divUp(axes[e].size, tileE);
+        for( int i = 0; i < naxes - 1; i++ )
+            if( i != e )
+                n *= (size_t)axes[i].size;
+        return n;
+    }
+
+    void operator()( const Range& range ) const CV_OVERRIDE
+    {
+        CV_TRACE_FUNCTION();
+        const ReorderAxis& dax = axes[naxes-1];
+        const int ntd = divUp(dax.size, tileD);
+        const int nte = e >= 0 ? divUp(axes[e].size, tileE) : 1;
+
+        for( int job = range.start; job < range.end; job++ )
+        {
+            int idx = job;
+            const int td = idx % ntd; idx /= ntd;
+            const int te = idx % nte; idx /= nte;
+            const uchar* sptr = src;
+            uchar* dptr = dst;
+            for( int i = naxes - 2; i >= 0; i-- )
+            {
+                if( i == e )
+                    continue;
+                const ReorderAxis& ax = axes[i];
+                const int k = idx % ax.size;
+                idx /= ax.size;
+                sptr += ax.sofs(k);
+                dptr += ax.dstep*k;
+            }
+
+            const int d0 = td*tileD, nd = std::min(tileD, dax.size - d0);
+            if( e < 0 )
+            {
+                sptr += dax.sstep*d0;
+                dptr += esz*d0;
+                if( kind == REORDER_KIND_COPY )
+                    memcpy(dptr, sptr, esz*nd);
+                else if( kind == REORDER_KIND_REVERSE )
+                    funcs.reverseRow(sptr, dptr, nd);
+                else
+                {
+                    ReorderAxis ax = dax;
+                    if( ax.tab )
+                    {
+                        sptr -= dax.sstep*d0;
+                        ax.tab += d0;
+                    }
+                    funcs.gatherRow(sptr, ax, dptr, nd);
+                }
+                continue;
+            }
+
+            const ReorderAxis& eax = axes[e];
+            const int e0 = te*tileE, ne = std::min(tileE, eax.size - e0);
+            if( kind == REORDER_KIND_TRANSPOSE )
+            {
+                // the source lines go along the inner destination axis
+                sptr += dax.sstep*d0;
+                dptr += esz*d0;
+                if( eax.sstep > 0 )
+                {
+                    sptr += eax.sstep*e0;
+                    dptr += eax.dstep*e0;
+                    funcs.transposeBlock(sptr, dax.sstep, dptr, (ptrdiff_t)eax.dstep, nd, ne);
+                }
+                else
+                {
+                    sptr += eax.sstep*(e0 + ne - 1);
+                    dptr += eax.dstep*(e0 + ne - 1);
+                    funcs.transposeBlock(sptr, dax.sstep, dptr, -(ptrdiff_t)eax.dstep, nd, ne);
+                }
+            }
+            else if( kind == REORDER_KIND_DEINTERLEAVE )
+            {
+                sptr += dax.sstep*d0;
+                dptr += esz*d0;
+                channelsFunc(sptr, dax, eax, dptr, nd);
+            }
+            else
+            {
+                CV_DbgAssert( kind == REORDER_KIND_INTERLEAVE );
+                sptr += eax.sstep*e0;
+                dptr += eax.dstep*e0;
+                channelsFunc(sptr, eax, dax, dptr, ne);
+            }
+        }
+    }
+
+private:
+    // merges the adjacent axes, which are contiguous in both arrays, and folds the inner one into the element
+    void simplify()
+    {
+        int n = 0;
+        for( int i = 0; i < naxes; i++ )
+        {
+            const ReorderAxis& ax = axes[i];
+            if( ax.size == 1 )
+                continue;
+            if( n > 0 )
+            {
+                ReorderAxis& prev = axes[n-1];
+                if( !prev.tab && !ax.tab && prev.dstep == ax.dstep*ax.size &&
+                    prev.sstep == ax.sstep*ax.size )
+                {
+                    prev.size *= ax.size;
+                    prev.dstep = ax.dstep;
+                    prev.sstep = ax.sstep;
+                    continue;
+                }
+            }
+            axes[n++] = ax;
+        }
+        naxes = n;
+
+        while( naxes > 0 && !axes[naxes-1].tab && axes[naxes-1].dstep == esz &&
+               axes[naxes-1].sstep == (ptrdiff_t)esz )
+        {
+            esz *= axes[naxes-1].size;
+            naxes--;
+        }
+        if( naxes == 0 || axes[naxes-1].dstep != esz )
+        {
+            // strided destination (e.g. a column or a diagonal): copy it element by element
+            ReorderAxis ax = { 1, esz, (ptrdiff_t)esz, 0 };
+            axes[naxes++] = ax;
+        }
+    }
+
+    void classify()
+    {
+        const ReorderAxis& dax = axes[naxes-1];
+        CV_Assert( dax.dstep == esz );
+        tileD = dax.size;
+        tileE = 1;
+
+        bool ok = getReorderFuncs(esz, funcs);
+        if( !dax.tab && dax.sstep == (ptrdiff_t)esz )
+        {
+            kind = REORDER_KIND_COPY;
+            return;
+        }
+        if( !ok )
+        {
+            // unusual element size: copy it by the smaller units
+            const size_t unit = esz % 4 == 0 ? 4 : esz % 2 == 0 ? 2 : 1;
+            CV_Assert( esz / unit <= (size_t)INT_MAX );
+            ReorderAxis ax = { (int)(esz / unit), unit, (ptrdiff_t)unit, 0 };
+            axes[naxes++] = ax;
+            esz = unit;
+            tileD = ax.size;
+            kind = REORDER_KIND_COPY;
+            return;
+        }
+        if( !dax.tab && dax.sstep == -(ptrdiff_t)esz )
+        {
+            kind = REORDER_KIND_REVERSE;
+            return;
+        }
+
+        // the axis, which is contiguous in the source
+        for( int i = naxes - 2; i >= 0; i-- )
+        {
+            if( std::abs(axes[i].sstep) == (ptrdiff_t)esz )
+            {
+                e = i;
+                break;
+            }
+        }
+        if( e < 0 )
+        {
+            kind = REORDER_KIND_GATHER;
+            return;
+        }
+
+        const ReorderAxis& eax = axes[e];
+        const bool simdSize = esz == 1 || esz == 2 || esz == 4;
+        const ptrdiff_t scn = std::abs(dax.sstep) / (ptrdiff_t)esz;
+        if( simdSize && !dax.tab && eax.sstep > 0 && eax.size <= 4 &&
+            std::abs(dax.sstep) == scn*(ptrdiff_t)esz && scn >= 2 && scn <= 4 && maxIndex(eax) < scn )
+        {
+            // interleaved pixels to the planes
+            kind = REORDER_KIND_DEINTERLEAVE;
+            channelsFunc = getDeinterleaveFunc(esz);
+            tileE = eax.size;
+            return;
+        }
+        if( simdSize && !eax.tab && e == naxes - 2 && dax.size >= 2 && dax.size <= 4 &&
+            eax.dstep == esz*dax.size )
+        {
+            // the planes to interleaved pixels
+            kind = REORDER_KIND_INTERLEAVE;
+            channelsFunc = getInterleaveFunc(esz);
+            tileE = eax.size;
+            return;
+        }
+        if( eax.tab || dax.tab )
+        {
+            e = -1;
+            kind = REORDER_KIND_GATHER;
+            return;
+        }
+
+        kind = REORDER_KIND_TRANSPOSE;
+        const int tile = std::max(16, (int)std::sqrt(16384./esz)) & -16;
+        tileD = std::min(tile, dax.size);
+        tileE = std::min(tile, eax.size);
+    }
+
+    static int maxIndex( const ReorderAxis& ax )
+    {
+        int m = ax.size - 1;
+        if( ax.tab )
+            for( int i = 0; i < ax.size; i++ )
+                m = std::max(m, ax.tab[i]);
+        return m;
+    }
+
+    ReorderInvoker& operator=(const ReorderInvoker&); // = delete
+
+    const uchar* src;
+    uchar* dst;
+    ReorderAxis axes[REORDER_MAX_AXES];
+    int naxes;
+    size_t esz;
+    ReorderKind kind;
+    int e;
+    int tileD, tileE;
+    ReorderFuncs funcs;
+    ChannelsFunc channelsFunc;
+};
+
+static void reorder( const uchar* src, uchar* dst, const ReorderAxis* axes, int naxes, size_t esz, size_t total )
+{
+    ReorderInvoker invoker(src, dst, axes, naxes, esz);
+    const size_t njobs = invoker.jobs();
+    CV_Assert( njobs <= (size_t)INT_MAX );
+    const size_t bytes = total*esz;
+    if( bytes < (1 << 17) || njobs == 1 )
+        invoker(Range(0, (int)njobs));
+    else
+        parallel_for_(Range(0, (int)njobs), invoker, (double)std::min(njobs, bytes >> 16));
+}
+
+} // namespace
+
+void transposeND( InputArray src_, const std::vector<int>& order, OutputArray dst_ )
+{
+    CV_INSTRUMENT_REGION();
+
+    Mat src = src_.getMat();
+    const int ndims = src.dims;
+    CV_CheckEQ(order.size(), (size_t)ndims, "Number of dimensions shouldn't change");
+
+    std::vector<int> newShape(ndims);
+    std::vector<uchar> used(ndims, 0);
+    for( int i = 0; i < ndims; i++ )
+    {
+        const int k = order[i];
+        CV_Assert( 0 <= k && k < ndims && !used[k] && "New order should be a valid permutation of the old one" );
+        used[k] = 1;
+        newShape[i] = src.size[k];
+    }
+
+    if( src.empty() )
+    {
+        dst_.release();
+        return;
+    }
+
+    if( dst_.getObj() == src_.getObj() || (dst_.kind() == _InputArray::MAT && dst_.getMat().data == src.data) )
+        src = src.clone();
+
+    dst_.create(ndims, newShape.data(), src.type());
+    Mat dst = dst_.getMat();
+
+    ReorderAxis axes[REORDER_MAX_AXES];
+    for( int i = 0; i < ndims; i++ )
+    {
+        ReorderAxis ax = { newShape[i], dst.step[i], (ptrdiff_t)src.step[order[i]], 0 };
+        axes[i] = ax;
+    }
+    reorder(src.ptr(), dst.ptr(), axes, ndims, src.elemSize(), src.total());
+}
+
+void reorderImage( InputArray src_, OutputArray dst_, int flags, const std::vector<int>& channelOrder )
+{
+    CV_INSTRUMENT_REGION();
+
+    const bool toPlanar = (flags & REORDER_TO_PLANAR) != 0, fromPlanar = (flags & REORDER_FROM_PLANAR) != 0;
+    const bool transposed = (flags & REORDER_TRANSPOSE) != 0;
+    CV_Assert( (flags & ~(REORDER_ROTATE_180 | REORDER_TRANSPOSE | REORDER_TO_PLANAR | REORDER_FROM_PLANAR)) == 0 );
+
+    Mat src = src_.getMat();
+    if( src.empty() )
+    {
+        dst_.release();
+        return;
+    }
+
+    // source axes: rows, columns, channels
+    const size_t esz1 = src.elemSize1();
+    const int depth = src.depth();
+    int rows, cols, scn;
+    ptrdiff_t ystep, xstep, cstep;
+    if( fromPlanar )
+    {
+        CV_CheckEQ(src.channels(), 1, "Planar source should be single-channel");
+        const int d = src.dims;
+        CV_Assert( d == 2 || d == 3 || (d == 4 && src.size[0] == 1) );
+        rows = src.size[d-2];
+        cols = src.size[d-1];
+        scn = d == 2 ? 1 : src.size[d-3];
+        ystep = (ptrdiff_t)src.step[d-2];
+        xstep = (ptrdiff_t)esz1;
+        cstep = d == 2 ? 0 : (ptrdiff_t)src.step[d-3];
+    }
+    else
+    {
+        CV_Assert( src.dims == 2 );
+        rows = src.rows;
+        cols = src.cols;
+        scn = src.channels();
+        ystep = (ptrdiff_t)src.step[0];
+        xstep = (ptrdiff_t)src.elemSize();
+        cstep = (ptrdiff_t)esz1;
+    }
+
+    const int* tab = 0;
+    int dcn = scn;
+    if( !channelOrder.empty() )
+    {
+        dcn = (int)channelOrder.size();
+        bool identity = dcn == scn;
+        for( int c = 0; c < dcn; c++ )
+        {
+            CV_Assert( 0 <= channelOrder[c] && channelOrder[c] < scn );
+            identity = identity && channelOrder[c] == c;
+        }
+        if( !identity )
+            tab = channelOrder.data();
+    }
+    CV_Assert( toPlanar || dcn <= CV_CN_MAX );
+
+    const int drows = transposed ? cols : rows, dcols = transposed ? rows : cols;
+    if( dst_.getObj() == src_.getObj() || (dst_.kind() == _InputArray::MAT && dst_.getMat().data == src.data) )
+        src = src.clone();
+
+    Mat dst;
+    if( toPlanar )
+    {
+        int sz[] = { 1, dcn, drows, dcols };
+        dst_.create(4, sz, depth);
+        dst = dst_.getMat();
+    }
+    else
+    {
+        dst_.create(drows, dcols, CV_MAKETYPE(depth, dcn));
+        dst = dst_.getMat();
+    }
+
+    const uchar* sptr = src.ptr();
+    ReorderAxis yax = { drows, 0, transposed ? xstep : ystep, 0 };
+    ReorderAxis xax = { dcols, 0, transposed ? ystep : xstep, 0 };
+    ReorderAxis cax = { dcn, 0, cstep, tab };
+    if( flags & REORDER_FLIP_VERTICAL )
+    {
+        sptr += yax.sstep*(drows - 1);
+        yax.sstep = -yax.sstep;
+    }
+    if( flags & REORDER_FLIP_HORIZONTAL )
+    {
+        sptr += xax.sstep*(dcols - 1);
+        xax.sstep = -xax.sstep;
+    }
+
+    ReorderAxis axes[3];
+    if( toPlanar )
+    {
+        cax.dstep = dst.step[1];
+        yax.dstep = dst.step[2];
+        xax.dstep = esz1;
+        axes[0] = cax; axes[1] = yax; axes[2] = xax;
+    }
+    else
+    {
+        yax.dstep = dst.step[0];
+        xax.dstep = dst.elemSize();
+        cax.dstep = esz1;
+        axes[0] = yax; axes[1] = xax; axes[2] = cax;
+    }
+    reorder(sptr, dst.ptr(), axes, 3, esz1, (size_t)drows*dcols*dcn);
+}
+
+} // namespace cv
@@ -9,62 +9,6 @@ namespace cv {
 
 ////////////////////////////////////// transpose /////////////////////////////////////////
 
-template<typename T> static void
-transpose_( const uchar* src, size_t sstep, uchar* dst, size_t dstep, Size sz )
-{
-    int i=0, j, m = sz.width, n = sz.height;
-
-    #if CV_ENABLE_UNROLLED
-    for(; i <= m - 4; i += 4 )
-    {
-        T* d0 = (T*)(dst + dstep*i);
-        T* d1 = (T*)(dst + dstep*(i+1));
-        T* d2 = (T*)(dst + dstep*(i+2));
-        T* d3 = (T*)(dst + dstep*(i+3));
-
-        for( j = 0; j <= n - 4; j += 4 )
-        {
-            const T* s0 = (const T*)(src + i*sizeof(T) + sstep*j);
-            const T* s1 = (const T*)(src + i*sizeof(T) + sstep*(j+1));
-            const T* s2 = (const T*)(src + i*sizeof(T) + sstep*(j+2));
-            const T* s3 = (const T*)(src + i*sizeof(T) + sstep*(j+3));
-
-            d0[j] = s0[0]; d0[j+1] = s1[0]; d0[j+2] = s2[0]; d0[j+3] = s3[0];
-            d1[j] = s0[1]; d1[j+1] = s1[1]; d1[j+2] = s2[1]; d1[j+3] = s3[1];
-            d2[j] = s0[2]; d2[j+1] = s1[2]; d2[j+2] = s2[2]; d2[j+3] = s3[2];
-            d3[j] = s0[3]; d3[j+1] = s1[3]; d3[j+2] = s2[3]; d3[j+3] = s3[3];
-        }
-
-        for( ; j < n; j++ )
-        {
-            const T* s0 = (const T*)(src + i*sizeof(T) + j*sstep);
-            d0[j] = s0[0]; d1[j] = s0[1]; d2[j] = s0[2]; d3[j] = s0[3];
-        }
-    }
-    #endif
-    for( ; i < m; i++ )
-    {
-        T* d0 = (T*)(dst + dstep*i);
-        j = 0;
-        #if CV_ENABLE_UNROLLED
-        for(; j <= n - 4; j += 4 )
-        {
-            const T* s0 = (const T*)(src + i*sizeof(T) + sstep*j);
-            const T* s1 = (const T*)(src + i*sizeof(T) + sstep*(j+1));
-            const T* s2 = (const T*)(src + i*sizeof(T) + sstep*(j+2));
-            const T* s3 = (const T*)(src + i*sizeof(T) + sstep*(j+3));
-
-            d0[j] = s0[0]; d0[j+1] = s1[0]; d0[j+2] = s2[0]; d0[j+3] = s3[0];
-        }
-        #endif
-        for( ; j < n; j++ )
-        {
-            const T* s0 = (const T*)(src + i*sizeof(T) + j*sstep);
-            d0[j] = s0[0];
-        }
-    }
-}
-
 template<typename T> static void
 transposeI_( uchar* data, size_t step, int n )
 {
@@ -77,13 +21,9 @@ transposeI_( uchar* data, size_t step, int n )
     }
 }
 
-typedef void (*TransposeFunc)( const uchar* src, size_t sstep, uchar* dst, size_t dstep, Size sz );
 typedef void (*TransposeInplaceFunc)( uchar* data, size_t step, int n );
 
 #define DEF_TRANSPOSE_FUNC(suffix, type) \
-static void transpose_##suffix( const uchar* src, size_t sstep, uchar* dst, size_t dstep, Size sz ) \
-{ transpose_<type>(src, sstep, dst, dstep, sz); } \
-\
 static void transposeI_##suffix( uchar* data, size_t step, int n ) \
 { transposeI_<type>(data, step, n); }
 
@@ -98,13 +38,6 @@ DEF_TRANSPOSE_FUNC(32sC4, Vec4i)
 DEF_TRANSPOSE_FUNC(32sC6, Vec6i)
 DEF_TRANSPOSE_FUNC(32sC8, Vec8i)
 
-static TransposeFunc transposeTab[] =
-{
-    0, transpose_8u, transpose_16u, transpose_8uC3, transpose_32s, 0, transpose_16uC3, 0,
-    transpose_32sC2, 0, 0, 0, transpose_32sC3, 0, 0, 0, transpose_32sC4,
-    0, 0, 0, 0, 0, 0, 0, transpose_32sC6, 0, 0, 0, 0, 0, 0, 0, transpose_32sC8
-};
-
 static TransposeInplaceFunc transposeInplaceTab[] =
 {
     0, transposeI_8u, transposeI_16u, transposeI_8uC3, transposeI_32s, 0, transposeI_16uC3, 0,
@@ -275,9 +208,8 @@ void transpose( InputArray _src, OutputArray _dst )
     }
     else
     {
-        TransposeFunc func = transposeTab[esz];
-        CV_Assert( func != 0 );
-        func( src.ptr(), src.step, dst.ptr(), dst.step, src.size() );
+        // tiled, see matrix_reorder.cpp
+        reorderImage(src, dst, REORDER_TRANSPOSE);
     }
 }
 
@@ -736,6 +668,13 @@ void flip( InputArray _src, OutputArray _dst, int flip_mode )
 
     size_t esz = CV_ELEM_SIZE(type);
 
+    if( flip_mode < 0 && dst.data != src.data )
+    {
+        // single pass instead of the vertical and horizontal ones
+        reorderImage(src, dst, REORDER_ROTATE_180);
+        return;
+    }
+
     if( flip_mode <= 0 )
         flipVert( src.ptr(), src.step, dst.ptr(), dst.step, src.size(), esz );
     else
@@ -749,18 +688,40 @@ void rotate(InputArray _src, OutputArray _dst, int rotateMode)
 {
     CV_Assert(_src.dims() <= 2);
 
+    if (_dst.isUMat())
+    {
+        switch (rotateMode)
+        {
+        case ROTATE_90_CLOCKWISE:
+            transpose(_src, _dst);
+            flip(_dst, _dst, 1);
+            break;
+        case ROTATE_180:
+            flip(_src, _dst, -1);
+            break;
+        case ROTATE_90_COUNTERCLOCKWISE:
+            transpose(_src, _dst);
+            flip(_dst, _dst, 0);
+            break;
+        default:
+            break;
+        }
+        return;
+    }
+
+    CV_INSTRUMENT_REGION();
+
+    // the transposition and the flip are done by a single pass, see matrix_reorder.cpp
     switch (rotateMode)
     {
     case ROTATE_90_CLOCKWISE:
-        transpose(_src, _dst);
-        flip(_dst, _dst, 1);
+        reorderImage(_src, _dst, REORDER_ROTATE_90_CLOCKWISE);
         break;
     case ROTATE_180:
-        flip(_src, _dst, -1);
+        reorderImage(_src, _dst, REORDER_ROTATE_180);
         break;
     case ROTATE_90_COUNTERCLOCKWISE:
-        transpose(_src, _dst);
-        flip(_dst, _dst, 0);
+        reorderImage(_src, _dst, REORDER_ROTATE_90_COUNTERCLOCKWISE);
         break;
     default:
         break;
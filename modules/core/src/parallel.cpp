@@ -44,6 +44,7 @@
 
 #include <opencv2/core/utils/configuration.private.hpp>
 #include <opencv2/core/utils/trace.private.hpp>
+#include <opencv2/core/utils/thread_pool.hpp>
 
 #include "opencv2/core/parallel/parallel_backend.hpp"
 #include "parallel/parallel.hpp"
@@ -145,6 +146,7 @@
 #  define CV_PARALLEL_FRAMEWORK "ms-concurrency"
 #elif defined HAVE_PTHREADS_PF
 #  define CV_PARALLEL_FRAMEWORK "pthreads"
+#  define CV_PARALLEL_FRAMEWORK_PTHREADS 1
 #endif
 
 #include <atomic>
@@ -495,6 +497,15 @@ void parallel_for_(const cv::Range& range, const cv::ParallelLoopBody& body, dou
     if (range.empty())
         return;
 
+#ifdef CV_PARALLEL_FRAMEWORK_PTHREADS
+    if (!cv::parallel::getCurrentParallelForAPI() && parallel_pthreads_is_work_stealing())
+    {
+        // work-stealing thread pool accepts nested and concurrent jobs
+        parallel_for_impl(range, body, nstripes);
+        return;
+    }
+#endif
+
     static std::atomic<bool> flagNestedParallelFor(false);
     bool isNotNestedRegion = !flagNestedParallelFor.load();
     if (isNotNestedRegion)
@@ -1012,6 +1023,45 @@ const char* currentParallelFramework()
 #endif
 }
 
+namespace {
+
+class FirstTouchBody : public ParallelLoopBody
+{
+public:
+    enum { PAGE_SIZE = 4096 };
+
+    FirstTouchBody(uchar* data_, size_t size_) : data(data_), size(size_) {}
+
+    void operator()(const Range& r) const CV_OVERRIDE
+    {
+        const size_t base = (size_t)data & ~(size_t)(PAGE_SIZE - 1);
+        for (int i = r.start; i < r.end; i++)
+        {
+            size_t ofs = base + (size_t)i * PAGE_SIZE;
+            uchar* p = ofs < (size_t)data ? data : (uchar*)ofs;  // the first page is not aligned
+            CV_DbgAssert(p < data + size);
+            *(volatile uchar*)p = 0;
+        }
+    }
+
+    uchar* data;
+    size_t size;
+};
+
+}  // namespace
+
+void utils::parallelFirstTouch(void* data, size_t size)
+{
+    if (!data || size == 0)
+        return;
+    const size_t begin = (size_t)data / FirstTouchBody::PAGE_SIZE;
+    const size_t end = ((size_t)data + size - 1) / FirstTouchBody::PAGE_SIZE + 1;
+    CV_Assert(end - begin <= (size_t)INT_MAX);
+    FirstTouchBody body((uchar*)data, size);
+    // one stripe per thread: neighbour pages are kept on the same node
+    parallel_for_(Range(0, (int)(end - begin)), body, getNumThreads());
+}
+
 }  // namespace cv::
 
 CV_IMPL void cvSetNumThreads(int nt)
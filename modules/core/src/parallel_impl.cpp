@@ -6,6 +6,9 @@
 
 #include "parallel_impl.hpp"
 
+#include <opencv2/core/utils/thread_pool.hpp>
+#include <opencv2/core/utils/thread_pool.private.hpp>
+
 #ifdef HAVE_PTHREADS_PF
 #include <pthread.h>
 
@@ -24,6 +27,12 @@
 //#define CV_USE_GLOBAL_WORKERS_COND_VAR  // not effective on many-core systems (10+)
 
 #include <atomic>
+#include <deque>
+#include <fstream>
+
+#if defined(__linux__) && !defined(__ANDROID__) && defined(CPU_SET)
+#define CV_THREAD_POOL_HAVE_AFFINITY 1  // pthread_setaffinity_np()
+#endif
 
 // Spin lock's OS-level yield
 #ifdef DECLARE_CV_YIELD
@@ -75,6 +84,87 @@ static int CV_MAIN_THREAD_ACTIVE_WAIT = (int)utils::getConfigurationParameterSiz
 
 static int CV_WORKER_ACTIVE_WAIT_THREADS_LIMIT = (int)utils::getConfigurationParameterSizeT("OPENCV_THREAD_POOL_ACTIVE_WAIT_THREADS_LIMIT", 0); // number of real cores
 
+// Work-stealing mode: jobs from several caller threads are processed concurrently (including nested parallel_for_() calls)
+static bool CV_THREAD_POOL_WORK_STEALING = utils::getConfigurationParameterBool("OPENCV_THREAD_POOL_WORK_STEALING", false);
+
+// Placement of worker threads: "none", "cores" or "numa"
+static utils::ThreadPoolAffinity getDefaultThreadPoolAffinity()
+{
+    const std::string mode = utils::getConfigurationParameterString("OPENCV_THREAD_POOL_AFFINITY", "none");
+    if (mode == "cores")
+        return utils::THREAD_POOL_AFFINITY_CORES;
+    if (mode == "numa")
+        return utils::THREAD_POOL_AFFINITY_NUMA;
+    if (!mode.empty() && mode != "none")
+        CV_LOG_WARNING(NULL, "OPENCV_THREAD_POOL_AFFINITY: unknown mode '" << mode << "', expected none / cores / numa");
+    return utils::THREAD_POOL_AFFINITY_NONE;
+}
+
+#ifdef CV_THREAD_POOL_HAVE_AFFINITY
+// Parses lists like "0-3,8,10-11" (see /sys/devices/system/node/node0/cpulist)
+static std::vector<int> parseCPUList(const std::string& str)
+{
+    std::vector<int> cpus;
+    std::istringstream ss(str);
+    std::string item;
+    while (std::getline(ss, item, ','))
+    {
+        int first = -1, last = -1;
+        int n = sscanf(item.c_str(), "%d-%d", &first, &last);
+        if (n < 1 || first < 0)
+            continue;
+        if (n == 1)
+            last = first;
+        for (int cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++)
+            cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+struct CPUTopology
+{
+    std::vector<int> cpus;  // CPUs of the process affinity mask
+    std::vector< std::vector<int> > nodes;  // allowed CPUs of each NUMA node (single node if NUMA info is not available)
+
+    CPUTopology()
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (sched_getaffinity(0, sizeof(set), &set) == 0)
+        {
+            for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+                if (CPU_ISSET(cpu, &set))
+                    cpus.push_back(cpu);
+        }
+        std::string online;
+        std::ifstream f("/sys/devices/system/node/online");
+        if (f.is_open())
+            std::getline(f, online);
+        std::vector<int> node_ids = parseCPUList(online);
+        for (size_t i = 0; i < node_ids.size(); i++)
+        {
+            std::ifstream nf(cv::format("/sys/devices/system/node/node%d/cpulist", node_ids[i]).c_str());
+            std::string line;
+            if (!nf.is_open() || !std::getline(nf, line))
+                continue;
+            std::vector<int> node_cpus = parseCPUList(line), allowed;
+            for (size_t j = 0; j < node_cpus.size(); j++)
+                if (std::find(cpus.begin(), cpus.end(), node_cpus[j]) != cpus.end())
+                    allowed.push_back(node_cpus[j]);
+            if (!allowed.empty())
+                nodes.push_back(allowed);
+        }
+        if (nodes.empty() && !cpus.empty())
+            nodes.push_back(cpus);
+    }
+
+    static const CPUTopology& instance()
+    {
+        CV_SINGLETON_LAZY_INIT_REF(CPUTopology, new CPUTopology())
+    }
+};
+#endif // CV_THREAD_POOL_HAVE_AFFINITY
+
 class WorkerThread;
 class ParallelJob;
 
@@ -103,6 +193,14 @@ public:
     bool reconfigure_(unsigned new_threads_count); // internal implementation
 
     void run(const Range& range, const ParallelLoopBody& body, double nstripes);
+    void run_stealing(const Range& range, const ParallelLoopBody& body, double nstripes);
+
+    Ptr<ParallelJob> steal(unsigned thief_id);
+
+    void applyAffinity(WorkerThread& thread);  // 'mutex' must be locked
+    bool setAffinity(utils::ThreadPoolAffinity mode);
+
+    void setWorkStealing(bool enable);
 
     size_t getNumOfThreads();
 
@@ -126,6 +224,11 @@ public:
 
     Ptr<ParallelJob> job;
 
+    std::atomic<bool> work_stealing;  // changed under 'mutex' when there are no workers
+    unsigned next_worker;  // work-stealing mode: first worker queue for the next job, guarded by 'mutex'
+
+    utils::ThreadPoolAffinity affinity;  // guarded by 'mutex'
+
 #ifdef CV_PROFILE_THREADS
     double tickFreq;
     int64 jobSubmitTime;
@@ -193,6 +296,7 @@ class WorkerThread
 public:
     ThreadPool& thread_pool;
     const unsigned id;
+    const bool work_stealing;  // mode of the pool when the worker is created
     pthread_t posix_thread;
     bool is_created;
 
@@ -201,6 +305,7 @@ public:
     std::atomic<bool> has_wake_signal;
 
     Ptr<ParallelJob> job;
+    std::deque< Ptr<ParallelJob> > jobs_queue;  // work-stealing mode: owner pops from front, thieves from back
 
     pthread_mutex_t mutex;
 #if !defined(CV_USE_GLOBAL_WORKERS_COND_VAR)
@@ -208,9 +313,30 @@ public:
     pthread_cond_t cond_thread_wake;
 #endif
 
+    // Always-on counters (complement ThreadStatistics which are available with CV_PROFILE_THREADS only)
+    struct WorkerStatistics
+    {
+        WorkerStatistics() { reset(); }
+        void reset()
+        {
+            executedJobs = 0;
+            executedTasks = 0;
+            stolenJobs = 0;
+            busyTicks = 0;
+            idleTicks = 0;
+        }
+        std::atomic<uint64> executedJobs;
+        std::atomic<uint64> executedTasks;
+        std::atomic<uint64> stolenJobs;
+        std::atomic<int64> busyTicks;
+        std::atomic<int64> idleTicks;
+    };
+    WorkerStatistics stat;
+
     WorkerThread(ThreadPool& thread_pool_, unsigned id_) :
         thread_pool(thread_pool_),
         id(id_),
+        work_stealing(thread_pool_.work_stealing),
         posix_thread(0),
         is_created(false),
         stop_thread(false),
@@ -270,12 +396,18 @@ public:
     }
 
     void thread_body();
+    void thread_body_stealing();
+    void process_job(Ptr<ParallelJob>& j_ptr, bool stolen);
     static void* thread_loop_wrapper(void* thread_object)
     {
 #ifdef OPENCV_WITH_ITT
         __itt_thread_set_name(cv::format("OpenCVThread-%03d", cv::utils::getThreadID()).c_str());
 #endif
-        ((WorkerThread*)thread_object)->thread_body();
+        WorkerThread* thread = (WorkerThread*)thread_object;
+        if (thread->work_stealing)
+            thread->thread_body_stealing();
+        else
+            thread->thread_body();
         return 0;
     }
 };
@@ -372,6 +504,7 @@ void WorkerThread::thread_body()
     CV_LOG_VERBOSE(NULL, 5, "Thread: new thread: " << id);
 
     bool allow_active_wait = true;
+    int64 idle_start = getTickCount();
 
 #ifdef CV_PROFILE_THREADS
     ThreadPool::ThreadStatistics& stat = thread_pool.threads_stat[id + 1];
@@ -430,13 +563,20 @@ void WorkerThread::thread_body()
                 {
                     int other = j->active_thread_count.fetch_add(1, std::memory_order_seq_cst);
                     CV_LOG_VERBOSE(NULL, 5, "Thread: processing new job (with " << other << " other threads)"); CV_UNUSED(other);
+                    int64 busy_start = getTickCount();
+                    this->stat.idleTicks.fetch_add(busy_start - idle_start, std::memory_order_relaxed);
 #ifdef CV_PROFILE_THREADS
-                    stat.threadExecuteStart = getTickCount();
+                    stat.threadExecuteStart = busy_start;
                     stat.executedTasks = j->execute(true);
                     stat.threadExecuteStop = getTickCount();
+                    unsigned executed_tasks = stat.executedTasks;
 #else
-                    j->execute(true);
+                    unsigned executed_tasks = j->execute(true);
 #endif
+                    idle_start = getTickCount();
+                    this->stat.busyTicks.fetch_add(idle_start - busy_start, std::memory_order_relaxed);
+                    this->stat.executedJobs.fetch_add(1, std::memory_order_relaxed);
+                    this->stat.executedTasks.fetch_add(executed_tasks, std::memory_order_relaxed);
                     int completed = j->completed_thread_count.fetch_add(1, std::memory_order_seq_cst) + 1;
                     int active = j->active_thread_count.load(std::memory_order_acquire);
                     if (CV_WORKER_ACTIVE_WAIT_THREADS_LIMIT > 0)
@@ -474,7 +614,108 @@ void WorkerThread::thread_body()
     }
 }
 
-ThreadPool::ThreadPool()
+void WorkerThread::process_job(Ptr<ParallelJob>& j_ptr, bool stolen)
+{
+    ParallelJob* j = j_ptr;
+    CV_LOG_VERBOSE(NULL, 5, "Thread: job size=" << j->range.size() << " done=" << j->current_task << " stolen=" << stolen);
+    if (j->current_task >= j->range.size())
+        return;  // outdated ticket: job is processed by other threads
+    stat.executedJobs.fetch_add(1, std::memory_order_relaxed);
+    if (stolen)
+        stat.stolenJobs.fetch_add(1, std::memory_order_relaxed);
+    j->active_thread_count.fetch_add(1, std::memory_order_seq_cst);
+    unsigned executed_tasks = j->execute(true);
+    stat.executedTasks.fetch_add(executed_tasks, std::memory_order_relaxed);
+    int completed = j->completed_thread_count.fetch_add(1, std::memory_order_seq_cst) + 1;
+    int active = j->active_thread_count.load(std::memory_order_acquire);
+    if (active == completed)
+    {
+        bool need_signal = !j->is_completed;
+        j->is_completed = true;
+        j = NULL; j_ptr.release();
+        if (need_signal)
+        {
+            CV_LOG_VERBOSE(NULL, 5, "Thread: job finished => notifying the caller threads");
+            pthread_mutex_lock(&thread_pool.mutex_notify);  // to avoid signal miss due pre-check condition
+            // empty
+            pthread_mutex_unlock(&thread_pool.mutex_notify);
+            pthread_cond_broadcast(&thread_pool.cond_thread_task_complete);  // several caller threads may wait
+        }
+    }
+}
+
+void WorkerThread::thread_body_stealing()
+{
+    (void)cv::utils::getThreadID(); // notify OpenCV about new thread
+    CV_LOG_VERBOSE(NULL, 5, "Thread: new thread (work-stealing mode): " << id);
+
+    bool allow_active_wait = true;
+    int64 idle_start = getTickCount();
+
+    while (!stop_thread)
+    {
+        Ptr<ParallelJob> j_ptr;
+        bool stolen = false;
+        pthread_mutex_lock(&mutex);
+        if (!jobs_queue.empty())
+        {
+            j_ptr = jobs_queue.front();
+            jobs_queue.pop_front();
+        }
+        pthread_mutex_unlock(&mutex);
+        if (!j_ptr)
+        {
+            j_ptr = thread_pool.steal(id);
+            stolen = !j_ptr.empty();
+        }
+        if (j_ptr)
+        {
+            int64 busy_start = getTickCount();
+            stat.idleTicks.fetch_add(busy_start - idle_start, std::memory_order_relaxed);
+            process_job(j_ptr, stolen);
+            idle_start = getTickCount();
+            stat.busyTicks.fetch_add(idle_start - busy_start, std::memory_order_relaxed);
+            allow_active_wait = true;
+            continue;
+        }
+
+        if (allow_active_wait && CV_WORKER_ACTIVE_WAIT > 0)
+        {
+            allow_active_wait = false;
+            for (int i = 0; i < CV_WORKER_ACTIVE_WAIT; i++)
+            {
+                if (has_wake_signal)
+                    break;
+                if (CV_ACTIVE_WAIT_PAUSE_LIMIT > 0 && (i < CV_ACTIVE_WAIT_PAUSE_LIMIT || (i & 1)))
+                    CV_PAUSE(16);
+                else
+                    CV_YIELD();
+            }
+            continue;  // check queues again
+        }
+
+        pthread_mutex_lock(&mutex);
+        while (!has_wake_signal && !stop_thread) // to handle spurious wakeups
+        {
+#if defined(CV_USE_GLOBAL_WORKERS_COND_VAR)
+            pthread_cond_wait(&thread_pool.cond_thread_wake, &mutex);
+#else
+            isActive = false;
+            pthread_cond_wait(&cond_thread_wake, &mutex);
+            isActive = true;
+#endif
+        }
+        has_wake_signal = false;
+        pthread_mutex_unlock(&mutex);
+        allow_active_wait = true;
+    }
+    stat.idleTicks.fetch_add(getTickCount() - idle_start, std::memory_order_relaxed);
+}
+
+ThreadPool::ThreadPool() :
+    work_stealing(CV_THREAD_POOL_WORK_STEALING),
+    next_worker(0),
+    affinity(getDefaultThreadPoolAffinity())
 {
 #ifdef CV_PROFILE_THREADS
     tickFreq = getTickFrequency();
@@ -531,6 +772,8 @@ bool ThreadPool::reconfigure_(unsigned new_threads_count)
         for (size_t i = threads.size(); i < new_threads_count; ++i)
         {
             threads.push_back(Ptr<WorkerThread>(new WorkerThread(*this, (unsigned)i))); // spawn more threads
+            if (affinity != utils::THREAD_POOL_AFFINITY_NONE)
+                applyAffinity(*(threads.back().get()));
         }
     }
     return false;
@@ -547,8 +790,177 @@ ThreadPool::~ThreadPool()
     pthread_mutex_destroy(&mutex_notify);
 }
 
+void ThreadPool::applyAffinity(WorkerThread& thread)
+{
+    if (!thread.is_created)
+        return;
+#ifdef CV_THREAD_POOL_HAVE_AFFINITY
+    const CPUTopology& topology = CPUTopology::instance();
+    if (topology.cpus.empty())
+        return;
+    // Caller thread is counted as thread #0: workers start from the next CPU / spread over the next nodes
+    const size_t idx = thread.id + 1;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (affinity == utils::THREAD_POOL_AFFINITY_CORES)
+    {
+        CPU_SET(topology.cpus[idx % topology.cpus.size()], &set);
+    }
+    else
+    {
+        const std::vector<int>* cpus = &topology.cpus;
+        if (affinity == utils::THREAD_POOL_AFFINITY_NUMA)
+        {
+            // contiguous blocks of threads per node: neighbour stripes are processed on the same node
+            const size_t nthreads = std::max((size_t)num_threads, threads.size() + 1);
+            const size_t node = std::min(idx * topology.nodes.size() / nthreads, topology.nodes.size() - 1);
+            cpus = &topology.nodes[node];
+        }
+        for (size_t i = 0; i < cpus->size(); i++)
+            CPU_SET((*cpus)[i], &set);
+    }
+    int res = pthread_setaffinity_np(thread.posix_thread, sizeof(set), &set);
+    if (res != 0)
+    {
+        CV_LOG_DEBUG(NULL, thread.id << ": Can't set thread affinity: res = " << res);
+    }
+#else
+    CV_UNUSED(thread);
+#endif
+}
+
+bool ThreadPool::setAffinity(utils::ThreadPoolAffinity mode)
+{
+#ifdef CV_THREAD_POOL_HAVE_AFFINITY
+    pthread_mutex_lock(&mutex);
+    if (mode != affinity)
+    {
+        affinity = mode;
+        for (size_t i = 0; i < threads.size(); ++i)
+            applyAffinity(*(threads[i].get()));
+    }
+    pthread_mutex_unlock(&mutex);
+    return true;
+#else
+    return mode == utils::THREAD_POOL_AFFINITY_NONE;
+#endif
+}
+
+void ThreadPool::setWorkStealing(bool enable)
+{
+    pthread_mutex_lock(&mutex);
+    if (enable != work_stealing)
+    {
+        // the workers run the loop of the mode they are created in, so they are restarted by the next job
+        reconfigure_(0);
+        work_stealing = enable;
+        next_worker = 0;
+    }
+    pthread_mutex_unlock(&mutex);
+}
+
+Ptr<ParallelJob> ThreadPool::steal(unsigned thief_id)
+{
+    Ptr<ParallelJob> j;
+    if (pthread_mutex_trylock(&mutex) != 0)
+        return j;  // pool is reconfigured or new job is submitted, don't wait
+    const size_t n = threads.size();
+    for (size_t k = 1; k < n && !j; k++)
+    {
+        WorkerThread& victim = *(threads[(thief_id + k) % n].get());
+        if (pthread_mutex_trylock(&victim.mutex) != 0)
+            continue;
+        if (!victim.jobs_queue.empty())
+        {
+            j = victim.jobs_queue.back();
+            victim.jobs_queue.pop_back();
+        }
+        pthread_mutex_unlock(&victim.mutex);
+    }
+    pthread_mutex_unlock(&mutex);
+    return j;
+}
+
+void ThreadPool::run_stealing(const Range& range, const ParallelLoopBody& body, double nstripes)
+{
+    CV_LOG_VERBOSE(NULL, 1, "Caller: new parallel job (work-stealing): num_threads=" << num_threads << "   range=" << range.size() << "   nstripes=" << nstripes);
+    if (!(getNumOfThreads() > 1 &&
+          (range.size() * nstripes >= 2 || (range.size() > 1 && nstripes <= 0))))
+    {
+        body(range);
+        return;
+    }
+
+    Ptr<ParallelJob> j_ptr(new ParallelJob(*this, range, body, nstripes));
+    ParallelJob& j = *j_ptr;
+
+    pthread_mutex_lock(&mutex);
+    reconfigure_(num_threads - 1);
+    {
+        // Each worker gets a ticket of the job in its own queue. Busy workers don't delay the job:
+        // idle workers steal tickets from their queues.
+        const size_t n = threads.size();
+        const size_t tickets = std::min(n, (size_t)(range.size() - 1));
+        const unsigned first = next_worker;
+        next_worker = (unsigned)((first + tickets) % std::max(n, (size_t)1));
+        for (size_t k = 0; k < tickets; k++)
+        {
+            WorkerThread& thread = *(threads[(first + k) % n].get());
+            pthread_mutex_lock(&thread.mutex);
+            thread.jobs_queue.push_back(j_ptr);
+            thread.has_wake_signal = true;
+#if !defined(CV_USE_GLOBAL_WORKERS_COND_VAR)
+            bool isActive = thread.isActive;
+#endif
+            pthread_mutex_unlock(&thread.mutex);
+#if !defined(CV_USE_GLOBAL_WORKERS_COND_VAR)
+            if (!isActive)
+                pthread_cond_signal(&thread.cond_thread_wake); // wake thread
+#endif
+        }
+#if defined(CV_USE_GLOBAL_WORKERS_COND_VAR)
+        pthread_cond_broadcast(&cond_thread_wake); // wake all threads
+#endif
+    }
+    pthread_mutex_unlock(&mutex);
+
+    j.execute(false);
+    CV_Assert(j.current_task >= j.range.size());
+    if (j.is_completed || j.active_thread_count == 0)
+    {
+        j.is_completed = true;
+    }
+    else
+    {
+        for (int i = 0; i < CV_MAIN_THREAD_ACTIVE_WAIT; i++)  // don't spin too much in any case (inaccurate getTickCount())
+        {
+            if (j.is_completed)
+                break;
+            if (CV_ACTIVE_WAIT_PAUSE_LIMIT > 0 && (i < CV_ACTIVE_WAIT_PAUSE_LIMIT || (i & 1)))
+                CV_PAUSE(16);
+            else
+                CV_YIELD();
+        }
+        if (!j.is_completed)
+        {
+            pthread_mutex_lock(&mutex_notify);
+            while (!j.is_completed)
+            {
+                pthread_cond_wait(&cond_thread_task_complete, &mutex_notify);
+            }
+            pthread_mutex_unlock(&mutex_notify);
+        }
+    }
+    CV_LOG_VERBOSE(NULL, 5, "Caller: job completed: " << j.active_thread_count << " " << j.completed_thread_count);
+}
+
 void ThreadPool::run(const Range& range, const ParallelLoopBody& body, double nstripes)
 {
+    if (work_stealing)
+    {
+        run_stealing(range, body, nstripes);
+        return;
+    }
     CV_LOG_VERBOSE(NULL, 1, "MainThread: new parallel job: num_threads=" << num_threads << "   range=" << range.size() << "   nstripes=" << nstripes << "   job=" << (void*)job);
 #ifdef CV_PROFILE_THREADS
     jobSubmitTime = getTickCount();
@@ -746,6 +1158,108 @@ void parallel_for_pthreads(const Range& range, const ParallelLoopBody& body, dou
     ThreadPool::instance().run(range, body, nstripes);
 }
 
+bool parallel_pthreads_is_work_stealing()
+{
+    return ThreadPool::instance().work_stealing;
+}
+
+namespace utils {
+
+bool getThreadPoolStatistics(std::vector<ThreadPoolWorkerStatistics>& stats)
+{
+    stats.clear();
+    ThreadPool& pool = ThreadPool::instance();
+    const double tickFreq = getTickFrequency();
+    pthread_mutex_lock(&pool.mutex);
+    stats.resize(pool.threads.size());
+    for (size_t i = 0; i < pool.threads.size(); ++i)
+    {
+        const WorkerThread::WorkerStatistics& s = pool.threads[i]->stat;
+        ThreadPoolWorkerStatistics& dst = stats[i];
+        dst.workerId = (int)pool.threads[i]->id;
+        dst.executedJobs = s.executedJobs.load(std::memory_order_relaxed);
+        dst.executedTasks = s.executedTasks.load(std::memory_order_relaxed);
+        dst.stolenJobs = s.stolenJobs.load(std::memory_order_relaxed);
+        dst.busyTime = s.busyTicks.load(std::memory_order_relaxed) / tickFreq;
+        dst.idleTime = s.idleTicks.load(std::memory_order_relaxed) / tickFreq;
+    }
+    pthread_mutex_unlock(&pool.mutex);
+    return true;
+}
+
+bool setThreadPoolAffinity(ThreadPoolAffinity affinity)
+{
+    return ThreadPool::instance().setAffinity(affinity);
+}
+
+ThreadPoolAffinity getThreadPoolAffinity()
+{
+    ThreadPool& pool = ThreadPool::instance();
+    pthread_mutex_lock(&pool.mutex);
+    ThreadPoolAffinity affinity = pool.affinity;
+    pthread_mutex_unlock(&pool.mutex);
+    return affinity;
 }
 
+void resetThreadPoolStatistics()
+{
+    ThreadPool& pool = ThreadPool::instance();
+    pthread_mutex_lock(&pool.mutex);
+    for (size_t i = 0; i < pool.threads.size(); ++i)
+        pool.threads[i]->stat.reset();
+    pthread_mutex_unlock(&pool.mutex);
+}
+
+bool setThreadPoolWorkStealing(bool enable)
+{
+    ThreadPool::instance().setWorkStealing(enable);
+    return true;
+}
+
+bool getThreadPoolWorkStealing()
+{
+    return ThreadPool::instance().work_stealing;
+}
+
+} // namespace utils
+
+}
+
+#else // HAVE_PTHREADS_PF
+
+namespace cv { namespace utils {
+
+bool getThreadPoolStatistics(std::vector<ThreadPoolWorkerStatistics>& stats)
+{
+    stats.clear();
+    return false;
+}
+
+void resetThreadPoolStatistics()
+{
+    // nothing
+}
+
+bool setThreadPoolAffinity(ThreadPoolAffinity affinity)
+{
+    return affinity == THREAD_POOL_AFFINITY_NONE;
+}
+
+ThreadPoolAffinity getThreadPoolAffinity()
+{
+    return THREAD_POOL_AFFINITY_NONE;
+}
+
+bool setThreadPoolWorkStealing(bool enable)
+{
+    return !enable;
+}
+
+bool getThreadPoolWorkStealing()
+{
+    return false;
+}
+
+}} // namespace
+
 #endif
@@ -11,6 +11,7 @@ unsigned defaultNumberOfThreads();
 void parallel_for_pthreads(const Range& range, const ParallelLoopBody& body, double nstripes);
 size_t parallel_pthreads_get_threads_num();
 void parallel_pthreads_set_threads_num(int num);
+bool parallel_pthreads_is_work_stealing();
 
 }
 
@@ -9,6 +9,20 @@
 #include <unordered_map>
 #include <iterator>
 
+#if defined _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#define CV_FS_HAVE_FILE_MAPPING 1
+#elif defined __unix__ || defined __APPLE__ || defined __HAIKU__
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define CV_FS_HAVE_FILE_MAPPING 1
+#endif
+
 namespace cv
 {
 
@@ -349,6 +363,127 @@ static inline void writeReal(uchar* p, double fval)
 
 
 
+// view of the whole file, used by FileStorage::LAZY mode and FileStorage::FORMAT_BINARY.
+// Pages are mapped copy-on-write, so matrices which refer to the mapped data can be modified.
+// If the file can not be mapped, it is read into memory.
+class FileStorageMapping
+{
+public:
+    FileStorageMapping() : data(0), size(0)
+#ifdef _WIN32
+        , hFile(INVALID_HANDLE_VALUE), hMapping(NULL), mapped(false)
+#elif defined CV_FS_HAVE_FILE_MAPPING
+        , mapped(false)
+#endif
+    {}
+
+    ~FileStorageMapping() { close(); }
+
+    bool open(const std::string& filename)
+    {
+        close();
+        if (map(filename))
+            return true;
+        close();
+
+        FILE* f = fopen(filename.c_str(), "rb");
+        if (!f)
+            return false;
+        bool ok = fseek(f, 0, SEEK_END) == 0;
+        long sz = ok ? ftell(f) : -1L;
+        ok = sz > 0 && fseek(f, 0, SEEK_SET) == 0;
+        if (ok)
+        {
+            copy.resize((size_t)sz);
+            ok = fread(&copy[0], 1, copy.size(), f) == copy.size();
+        }
+        fclose(f);
+        if (!ok)
+        {
+            close();
+            return false;
+        }
+        data = &copy[0];
+        size = copy.size();
+        return true;
+    }
+
+    void close()
+    {
+#if defined _WIN32
+        if (mapped)
+            UnmapViewOfFile(data);
+        if (hMapping)
+            CloseHandle(hMapping);
+        if (hFile != INVALID_HANDLE_VALUE)
+            CloseHandle(hFile);
+        hMapping = NULL;
+        hFile = INVALID_HANDLE_VALUE;
+        mapped = false;
+#elif defined CV_FS_HAVE_FILE_MAPPING
+        if (mapped)
+            munmap((void*)data, size);
+        mapped = false;
+#endif
+        std::vector<char>().swap(copy);
+        data = 0;
+        size = 0;
+    }
+
+    bool contains(const char* ptr) const { return ptr >= data && ptr < data + size; }
+
+    const char* data;
+    size_t size;
+protected:
+    bool map(const std::string& filename)
+    {
+#if defined _WIN32
+        hFile = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL, NULL);
+        if (hFile == INVALID_HANDLE_VALUE)
+            return false;
+        LARGE_INTEGER sz;
+        if (!GetFileSizeEx(hFile, &sz) || sz.QuadPart <= 0 || (uint64_t)sz.QuadPart > (uint64_t)(size_t)-1)
+            return false;
+        hMapping = CreateFileMappingA(hFile, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+        void* ptr = hMapping ? MapViewOfFile(hMapping, FILE_MAP_COPY, 0, 0, 0) : NULL;
+        if (!ptr)
+            return false;
+        data = (const char*)ptr;
+        size = (size_t)sz.QuadPart;
+        mapped = true;
+        return true;
+#elif defined CV_FS_HAVE_FILE_MAPPING
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat st;
+        void* ptr = MAP_FAILED;
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+            ptr = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (ptr == MAP_FAILED)
+            return false;
+        data = (const char*)ptr;
+        size = (size_t)st.st_size;
+        mapped = true;
+        return true;
+#else
+        CV_UNUSED(filename);
+        return false;
+#endif
+    }
+
+    std::vector<char> copy;
+#ifdef _WIN32
+    HANDLE hFile;
+    HANDLE hMapping;
+#endif
+#if defined CV_FS_HAVE_FILE_MAPPING
+    bool mapped;
+#endif
+};
+
 void FileStorage::Impl::init() {
     flags = 0;
     buffer.clear();
@@ -375,8 +510,19 @@ void FileStorage::Impl::init() {
     strbufv.clear();
     strbuf = 0;
     strbufsize = strbufpos = 0;
+    strbufsegs.clear();
+    strbufseg = 0;
+    strbufline = 0;
     roots.clear();
 
+    lazy_mode = false;
+    lazy_pending = false;
+    lazy_ofs = 0;
+    lazy_index.clear();
+    lazy_data.clear();
+    lazy_elements.clear();
+    mapping.release();
+
     fs_data.clear();
     fs_data_ptrs.clear();
     fs_data_blksz.clear();
@@ -408,7 +554,10 @@ void FileStorage::Impl::release(String *out) {
             while (write_stack.size() > 1) {
                 endWriteStruct();
             }
-            flush();
+            if (fmt == FileStorage::FORMAT_BINARY)
+                endWriteStruct(); // the end of the last document
+            else
+                flush();
             if (fmt == FileStorage::FORMAT_XML)
                 puts("</opencv_storage>\n");
             else if (fmt == FileStorage::FORMAT_JSON)
@@ -479,6 +628,10 @@ bool FileStorage::Impl::open(const char *filename_or_buf, int _flags, const char
     if (mem_mode && append)
         CV_Error(cv::Error::StsBadFlag, "FileStorage::APPEND and FileStorage::MEMORY are not currently compatible");
 
+    bool write_binary = write_mode && (_flags & FileStorage::FORMAT_MASK) == FileStorage::FORMAT_BINARY;
+    if (write_binary && (mem_mode || append))
+        CV_Error(cv::Error::StsBadFlag, "FileStorage::FORMAT_BINARY supports writing to files only (no FileStorage::APPEND and FileStorage::MEMORY)");
+
     flags = _flags;
 
     if (!mem_mode) {
@@ -490,6 +643,9 @@ bool FileStorage::Impl::open(const char *filename_or_buf, int _flags, const char
             if (append) {
                 CV_Error(cv::Error::StsNotImplemented, "Appending data to compressed file is not implemented");
             }
+            if (write_binary) {
+                CV_Error(cv::Error::StsNotImplemented, "Compression is not supported by FileStorage::FORMAT_BINARY");
+            }
             isGZ = true;
             compression = dot_pos[3];
             if (compression)
@@ -497,7 +653,7 @@ bool FileStorage::Impl::open(const char *filename_or_buf, int _flags, const char
         }
 
         if (!isGZ) {
-            file = fopen(filename.c_str(), !write_mode ? "rt" : !append ? "wt" : "a+t");
+            file = fopen(filename.c_str(), !write_mode ? "rt" : write_binary ? "wb" : !append ? "wt" : "a+t");
             if (!file)
                 return false;
         } else {
@@ -561,10 +717,12 @@ bool FileStorage::Impl::open(const char *filename_or_buf, int _flags, const char
         buffer.reserve(buf_size + 1024);
         buffer.resize(buf_size);
         bufofs = 0;
-        is_using_base64 = write_base64;
+        is_using_base64 = write_base64 && !write_binary;
         state_of_writing_base64 = FileStorage_API::Base64State::Uncertain;
 
-        if (fmt == FileStorage::FORMAT_XML) {
+        if (fmt == FileStorage::FORMAT_BINARY) {
+            emitter = createBinaryEmitter(this);
+        } else if (fmt == FileStorage::FORMAT_XML) {
             size_t file_size = file ? (size_t) ftell(file) : (size_t) 0;
             if (!append || file_size == 0) {
                 if (encoding && *encoding != '\0') {
@@ -662,17 +820,32 @@ bool FileStorage::Impl::open(const char *filename_or_buf, int _flags, const char
         if (mem_mode) {
             strbuf = (char *) filename_or_buf;
             strbufsize = strlen(strbuf);
+        } else if ((flags & FileStorage::LAZY) && file && mapFile()) {
+            strbuf = (char *) mapping->data;
+            strbufsize = mapping->size;
+            strbufpos = 0;
+            lazy_mode = true;
         }
 
         const char *yaml_signature = "%YAML";
         const char *json_signature = "{";
         const char *xml_signature = "<?xml";
+        const char *binary_signature = CV_FS_BINARY_SIGNATURE;
         char *buf = this->gets(16);
         CV_Assert(buf);
         char *bufPtr = cv_skip_BOM(buf);
         size_t bufOffset = bufPtr - buf;
 
-        if (strncmp(bufPtr, yaml_signature, strlen(yaml_signature)) == 0)
+        if (strncmp(buf, binary_signature, strlen(binary_signature)) == 0) {
+            fmt = FileStorage::FORMAT_BINARY;
+            if (!file && !mapping)
+                CV_Error(cv::Error::StsNotImplemented, "FileStorage::FORMAT_BINARY supports reading from uncompressed files only");
+            if (!mapping && !mapFile())
+                CV_Error(cv::Error::StsError, "Could not read the file");
+            strbuf = 0;
+            lazy_mode = false;
+        }
+        else if (strncmp(bufPtr, yaml_signature, strlen(yaml_signature)) == 0)
             fmt = FileStorage::FORMAT_YAML;
         else if (strncmp(bufPtr, json_signature, strlen(json_signature)) == 0)
             fmt = FileStorage::FORMAT_JSON;
@@ -685,6 +858,7 @@ bool FileStorage::Impl::open(const char *filename_or_buf, int _flags, const char
 
         rewind();
         strbufpos = bufOffset;
+        lazy_ofs = bufOffset;
         bufofs = 0;
 
         try {
@@ -709,11 +883,16 @@ bool FileStorage::Impl::open(const char *filename_or_buf, int _flags, const char
                 case FileStorage::FORMAT_JSON:
                     parser = createJSONParser(this);
                     break;
+                case FileStorage::FORMAT_BINARY:
+                    parser = createBinaryParser(this, mapping->data, mapping->size);
+                    break;
                 default:
                     parser = Ptr<FileStorageParser>();
             }
 
-            if (!parser.empty()) {
+            if (lazy_mode && buildLazyIndex()) {
+                lazy_pending = true;
+            } else if (!parser.empty()) {
                 ok = parser->parse(ptr);
                 if (ok) {
                     finalizeCollection(root_nodes);
@@ -737,8 +916,10 @@ bool FileStorage::Impl::open(const char *filename_or_buf, int _flags, const char
         // release resources that we do not need anymore
         closeFile();
         is_opened = true;
-        std::vector<char> tmpbuf;
-        std::swap(buffer, tmpbuf);
+        if (!lazy_mode) {
+            std::vector<char> tmpbuf;
+            std::swap(buffer, tmpbuf);
+        }
         bufofs = 0;
     }
     return ok;
@@ -770,6 +951,13 @@ char *FileStorage::Impl::getsFromFile(char *buf, int count) {
 
 char *FileStorage::Impl::gets(size_t maxCount) {
     if (strbuf) {
+        while (strbufpos >= strbufsize && strbufseg < strbufsegs.size()) {
+            strbuf = (char *) strbufsegs[strbufseg].first;
+            strbufsize = strbufsegs[strbufseg].second;
+            strbufpos = 0;
+            strbufseg++;
+        }
+        strbufline = strbuf + strbufpos;
         size_t i = strbufpos, len = strbufsize;
         const char *instr = strbuf;
         for (; i < len; i++) {
@@ -835,7 +1023,7 @@ bool FileStorage::Impl::eof() {
     if (dummy_eof)
         return true;
     if (strbuf)
-        return strbufpos >= strbufsize;
+        return strbufpos >= strbufsize && strbufseg >= strbufsegs.size();
     if (file)
         return feof(file) != 0;
 #if USE_ZLIB
@@ -860,6 +1048,9 @@ void FileStorage::Impl::closeFile() {
     gzfile = 0;
     strbuf = 0;
     strbufpos = 0;
+    strbufsegs.clear();
+    strbufseg = 0;
+    strbufline = 0;
     is_opened = false;
 }
 
@@ -970,7 +1161,7 @@ void FileStorage::Impl::startWriteStruct(const char *key, int struct_flags,
         && is_using_base64 && type_name == 0) {
         /* Uncertain whether output Base64 data */
         make_write_struct_delayed(key, struct_flags, type_name);
-    } else if (type_name && memcmp(type_name, "binary", 6) == 0) {
+    } else if (type_name && memcmp(type_name, "binary", 6) == 0 && fmt != FileStorage::FORMAT_BINARY) {
         /* Must output Base64 data */
         if ((FileNode::TYPE_MASK & struct_flags) != FileNode::SEQ)
             CV_Error(cv::Error::StsBadArg, "must set 'struct_flags |= CV_NODE_SEQ' if using Base64.");
@@ -1031,6 +1222,13 @@ void FileStorage::Impl::write(const String &key, const String &value) {
 void FileStorage::Impl::writeRawData(const std::string &dt, const void *_data, size_t len) {
     CV_Assert(write_mode);
 
+    if (fmt == FileStorage::FORMAT_BINARY) {
+        if (len > 0 && !_data)
+            CV_Error(cv::Error::StsNullPtr, "Null data pointer");
+        emitter->writeRawData(dt.c_str(), _data, len);
+        return;
+    }
+
     if (is_using_base64 || state_of_writing_base64 == FileStorage_API::Base64State::InUse) {
         writeRawDataBase64(_data, len, dt.c_str());
         return;
@@ -1275,11 +1473,15 @@ void FileStorage::Impl::writeRawDataBase64(const void *_data, size_t len, const
     base64_writer->write(_data, len, dt);
 }
 
+// In FileStorage::LAZY mode the const accessors parse the rest of the file on the first call, i.e. modify
+// the storage like FileStorage::operator[] does in this mode, so the reads must not run concurrently.
 FileNode FileStorage::Impl::getFirstTopLevelNode() const {
+    const_cast<FileStorage::Impl*>(this)->parseAllLazy();
     return roots.empty() ? FileNode() : roots[0];
 }
 
 FileNode FileStorage::Impl::root(int streamIdx) const {
+    const_cast<FileStorage::Impl*>(this)->parseAllLazy();
     return streamIdx >= 0 && streamIdx < (int) roots.size() ? roots[streamIdx] : FileNode();
 }
 
@@ -1722,6 +1924,57 @@ double FileStorage::Impl::Base64Decoder::getFloat64() {
     return fval;
 }
 
+size_t FileStorage::Impl::Base64Decoder::getBytes(uchar *dst, size_t len) {
+    size_t total = 0;
+    while (total < len) {
+        if (ofs >= decoded.size()) {
+            readMore(1);
+            if (ofs >= decoded.size())
+                break;
+        }
+        size_t n = std::min(decoded.size() - ofs, len - total);
+        if (dst)
+            memcpy(dst + total, &decoded[ofs], n);
+        ofs += n;
+        total += n;
+    }
+    return total;
+}
+
+size_t FileStorage::Impl::Base64Decoder::skipToEnd() {
+    CV_Assert(ofs <= decoded.size());
+    size_t nbytes = decoded.size() - ofs;
+    ofs = decoded.size();
+    if (eos)
+        return nbytes;
+
+    // the same accounting as in readMore(), but without decoding
+    size_t nchars = encoded.size();
+    char last0 = nchars > 1 ? encoded[nchars - 2] : '\0';
+    char last1 = nchars > 0 ? encoded[nchars - 1] : '\0';
+    encoded.clear();
+    for (;;) {
+        CV_Assert(!parser.empty() && ptr);
+        char *beg = 0, *end = 0;
+        bool ok = parser->getBase64Row(ptr, indent, beg, end);
+        ptr = end;
+        if (!ok || beg == end)
+            break;
+        nchars += end - beg;
+        last0 = end - beg > 1 ? end[-2] : last1;
+        last1 = end[-1];
+    }
+    eos = true;
+
+    size_t padded = (nchars + 3) & ~(size_t)3;
+    if (padded > nchars)
+        last0 = padded - nchars > 1 ? '=' : last1, last1 = '=';
+    nbytes += padded / 4 * 3;
+    if (padded > 0 && last1 == '=')
+        nbytes -= last0 == '=' ? 2 : 1;
+    return nbytes;
+}
+
 bool FileStorage::Impl::Base64Decoder::endOfStream() const { return eos; }
 
 char *FileStorage::Impl::Base64Decoder::getPtr() const { return ptr; }
@@ -1730,6 +1983,10 @@ char *FileStorage::Impl::Base64Decoder::getPtr() const { return ptr; }
 char *FileStorage::Impl::parseBase64(char *ptr, int indent, FileNode &collection) {
     const int BASE64_HDR_SIZE = 24;
     char dt[BASE64_HDR_SIZE + 1] = {0};
+    // in FileStorage::LAZY mode the data is decoded later by readLazyData() directly from the mapped file
+    bool lazy = lazy_mode && strbufline && mapping->contains(strbufline);
+    const char *lazy_src = strbufline;
+    int src_ofs = (int) (ptr - bufferStart());
     base64decoder.init(parser, ptr, indent);
 
     int i, k;
@@ -1748,6 +2005,31 @@ char *FileStorage::Impl::parseBase64(char *ptr, int indent, FileNode &collection
     int ival = 0;
     double fval = 0;
 
+    if (lazy) {
+        size_t nbytes = base64decoder.skipToEnd();
+        size_t nfields = 0, packed_size = 0;
+        for (k = 0; k < fmt_pair_count; k++) {
+            nfields += fmt_pairs[k * 2];
+            packed_size += (size_t) fmt_pairs[k * 2] * CV_ELEM_SIZE(fmt_pairs[k * 2 + 1]);
+        }
+        CV_Assert(packed_size > 0);
+        size_t count = nbytes / packed_size * nfields;
+        nbytes %= packed_size;
+        for (k = 0; k < fmt_pair_count; k++) {
+            size_t elem_size = CV_ELEM_SIZE(fmt_pairs[k * 2 + 1]);
+            for (i = 0; i < fmt_pairs[k * 2] && nbytes >= elem_size; i++, count++)
+                nbytes -= elem_size;
+        }
+
+        convertToCollection(FileNode::SEQ, collection);
+        if (count > 0) {
+            LazyData data = { lazy_src, src_ofs, indent, 0, std::string(dt), count };
+            addLazyData(collection, data);
+        }
+        finalizeCollection(collection);
+        return base64decoder.getPtr();
+    }
+
     for (;;) {
         for (k = 0; k < fmt_pair_count; k++) {
             int elem_type = fmt_pairs[k * 2 + 1];
@@ -1804,6 +2086,777 @@ char *FileStorage::Impl::parseBase64(char *ptr, int indent, FileNode &collection
     return base64decoder.getPtr();
 }
 
+// Top-level node scanners of FileStorage::LAZY mode. They only look for the boundaries of the top-level
+// nodes of the first document, anything unusual makes the storage fall back to parsing the whole file.
+
+static size_t skipLazySpaces(const char* s, size_t n, size_t pos)
+{
+    while (pos < n && cv_isspace(s[pos]))
+        pos++;
+    return pos;
+}
+
+static bool matchText(const char* s, size_t n, size_t pos, const char* text)
+{
+    size_t len = strlen(text);
+    return pos + len <= n && memcmp(s + pos, text, len) == 0;
+}
+
+static size_t findText(const char* s, size_t n, size_t pos, const char* text)
+{
+    const char* end = s + n;
+    const char* p = std::search(s + pos, end, text, text + strlen(text));
+    return p == end ? std::string::npos : (size_t)(p - s);
+}
+
+static bool indexYAML(const char* s, size_t n, size_t pos,
+                      std::unordered_map<std::string, FileStorage::Impl::LazyNode>& index)
+{
+    bool started = false;
+    size_t last = std::string::npos;
+    std::string lastKey;
+    while (pos < n)
+    {
+        const char* eol = (const char*)memchr(s + pos, '\n', n - pos);
+        size_t next = eol ? (size_t)(eol - s) + 1 : n;
+        char c = s[pos];
+        if (c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '#' || (!started && c == '%'))
+        {
+            pos = next;
+            continue;
+        }
+        if (matchText(s, n, pos, "---") || matchText(s, n, pos, "..."))
+        {
+            if (started)
+                break;
+            if (c == '.' || skipLazySpaces(s, next, pos + 3) != next)
+                return false;
+            started = true;
+            pos = next;
+            continue;
+        }
+        if (!cv_isalnum(c) && c != '_')
+            return false;
+        started = true;
+
+        size_t k = pos;
+        while (k < next && cv_isprint(s[k]) && s[k] != ':')
+            k++;
+        if (k == next || s[k] != ':')
+            return false;
+        size_t kend = k;
+        while (kend > pos && s[kend - 1] == ' ')
+            kend--;
+
+        if (last != std::string::npos)
+            index[lastKey].end = pos;
+        lastKey = std::string(s + pos, kend - pos);
+        if (index.count(lastKey))
+            return false;
+        FileStorage::Impl::LazyNode& node = index[lastKey];
+        node.begin = pos;
+        node.end = n;
+        node.parsed = false;
+        last = pos;
+        pos = next;
+    }
+    if (last != std::string::npos)
+        index[lastKey].end = pos;
+
+    // multiple documents are not indexed
+    for (; pos < n; pos++)
+    {
+        const char* eol = (const char*)memchr(s + pos, '\n', n - pos);
+        size_t next = eol ? (size_t)(eol - s) + 1 : n;
+        if (!matchText(s, n, pos, "...") && skipLazySpaces(s, next, pos) != next)
+            return false;
+        pos = next - 1;
+    }
+    return true;
+}
+
+static size_t skipJSONString(const char* s, size_t n, size_t pos)
+{
+    CV_DbgAssert(s[pos] == '"');
+    for (pos++; pos < n; pos++)
+    {
+        if (s[pos] == '\\')
+            pos++;
+        else if (s[pos] == '"')
+            return pos + 1;
+    }
+    return std::string::npos;
+}
+
+static bool indexJSON(const char* s, size_t n, size_t pos,
+                      std::unordered_map<std::string, FileStorage::Impl::LazyNode>& index)
+{
+    pos = skipLazySpaces(s, n, pos);
+    if (pos >= n || s[pos] != '{')
+        return false;
+    pos++;
+    for (;;)
+    {
+        pos = skipLazySpaces(s, n, pos);
+        if (pos >= n)
+            return false;
+        if (s[pos] == '}')
+            break;
+        if (s[pos] == ',')
+        {
+            pos++;
+            continue;
+        }
+        if (s[pos] != '"')
+            return false;
+
+        size_t begin = pos;
+        pos = skipJSONString(s, n, pos);
+        if (pos == std::string::npos)
+            return false;
+        std::string key(s + begin + 1, pos - begin - 2);
+        if (key.empty() || key.find('\\') != std::string::npos || index.count(key))
+            return false;
+        pos = skipLazySpaces(s, n, pos);
+        if (pos >= n || s[pos] != ':')
+            return false;
+
+        // find the end of the value
+        int depth = 0;
+        for (pos++; pos < n; pos++)
+        {
+            char c = s[pos];
+            if (c == '"')
+            {
+                pos = skipJSONString(s, n, pos);
+                if (pos == std::string::npos)
+                    return false;
+                pos--;
+            }
+            else if (c == '{' || c == '[')
+                depth++;
+            else if (c == '}' || c == ']')
+            {
+                if (depth == 0)
+                    break;
+                depth--;
+            }
+            else if (c == ',' && depth == 0)
+                break;
+            else if (c == '/')
+                return false;
+        }
+        if (pos >= n)
+            return false;
+
+        FileStorage::Impl::LazyNode& node = index[key];
+        node.begin = begin;
+        node.end = pos;
+        node.parsed = false;
+    }
+    return skipLazySpaces(s, n, pos + 1) == n;
+}
+
+static size_t skipXMLElement(const char* s, size_t n, size_t pos)
+{
+    int depth = 0;
+    while (pos < n)
+    {
+        const char* tag = (const char*)memchr(s + pos, '<', n - pos);
+        if (!tag)
+            break;
+        size_t lt = (size_t)(tag - s);
+        if (matchText(s, n, lt, "<!--"))
+        {
+            pos = findText(s, n, lt + 4, "-->");
+            if (pos == std::string::npos)
+                break;
+            pos += 3;
+            continue;
+        }
+        bool closing = lt + 1 < n && s[lt + 1] == '/';
+        char quote = 0;
+        for (pos = lt + 1; pos < n; pos++)
+        {
+            char c = s[pos];
+            if (quote)
+                quote = c == quote ? 0 : quote;
+            else if (c == '"' || c == '\'')
+                quote = c;
+            else if (c == '>')
+                break;
+        }
+        if (pos >= n)
+            break;
+        bool selfClosing = s[pos - 1] == '/';
+        pos++;
+        if (closing)
+            depth--;
+        else if (!selfClosing)
+            depth++;
+        if (depth <= 0)
+            return depth == 0 ? pos : std::string::npos;
+    }
+    return std::string::npos;
+}
+
+static bool indexXML(const char* s, size_t n, size_t pos,
+                     std::unordered_map<std::string, FileStorage::Impl::LazyNode>& index)
+{
+    pos = findText(s, n, pos, "<opencv_storage>");
+    if (pos == std::string::npos)
+        return false;
+    pos += strlen("<opencv_storage>");
+    for (;;)
+    {
+        pos = skipLazySpaces(s, n, pos);
+        if (pos >= n || s[pos] != '<')
+            return false;
+        if (matchText(s, n, pos, "<!--"))
+        {
+            pos = findText(s, n, pos + 4, "-->");
+            if (pos == std::string::npos)
+                return false;
+            pos += 3;
+            continue;
+        }
+        if (matchText(s, n, pos, "</opencv_storage>"))
+        {
+            pos += strlen("</opencv_storage>");
+            break;
+        }
+
+        size_t begin = pos, k = pos + 1;
+        while (k < n && (cv_isalnum(s[k]) || s[k] == '_' || s[k] == '-' || s[k] == '.'))
+            k++;
+        std::string key(s + begin + 1, k - begin - 1);
+        if (key.empty() || key == "_" || index.count(key))
+            return false;
+        pos = skipXMLElement(s, n, begin);
+        if (pos == std::string::npos)
+            return false;
+
+        FileStorage::Impl::LazyNode& node = index[key];
+        node.begin = begin;
+        node.end = pos;
+        node.parsed = false;
+    }
+
+    // multiple <opencv_storage> sections are not indexed
+    for (;;)
+    {
+        pos = skipLazySpaces(s, n, pos);
+        if (pos >= n)
+            return true;
+        if (!matchText(s, n, pos, "<!--"))
+            return false;
+        pos = findText(s, n, pos + 4, "-->");
+        if (pos == std::string::npos)
+            return false;
+        pos += 3;
+    }
+}
+
+bool FileStorage::Impl::mapFile() {
+    Ptr<FileStorageMapping> m = makePtr<FileStorageMapping>();
+    if (!m->open(filename))
+        return false;
+    mapping = m;
+    closeFile();
+    return true;
+}
+
+bool FileStorage::Impl::buildLazyIndex() {
+    CV_Assert(lazy_mode);
+    bool ok = false;
+    lazy_index.clear();
+    if (fmt == FileStorage::FORMAT_YAML)
+        ok = indexYAML(mapping->data, mapping->size, lazy_ofs, lazy_index);
+    else if (fmt == FileStorage::FORMAT_JSON)
+        ok = indexJSON(mapping->data, mapping->size, lazy_ofs, lazy_index);
+    else if (fmt == FileStorage::FORMAT_XML)
+        ok = indexXML(mapping->data, mapping->size, lazy_ofs, lazy_index);
+    if (!ok)
+        lazy_index.clear();
+    return ok;
+}
+
+void FileStorage::Impl::setStrbufSegments(const std::vector<std::pair<const char *, size_t> > &segments) {
+    strbufsegs = segments;
+    strbufseg = 0;
+    strbuf = segments.empty() ? 0 : (char *) "";
+    strbufsize = strbufpos = 0;
+    strbufline = 0;
+    dummy_eof = false;
+    bufofs = 0;
+    lineno = 0;
+    if (buffer.size() < 3)
+        buffer.resize(40);
+    char *ptr = bufferStart();
+    ptr[0] = ptr[1] = ptr[2] = '\0';
+}
+
+FileNode FileStorage::Impl::getLazyNode(const std::string &key) {
+    std::unordered_map<std::string, LazyNode>::iterator it = lazy_index.find(key);
+    if (it == lazy_index.end())
+        return FileNode();
+    LazyNode &lnode = it->second;
+    if (lnode.parsed)
+        return lnode.node;
+
+    // the node is parsed as a separate document with a single element,
+    // which is appended to the sequence of the root nodes
+    std::vector<std::pair<const char *, size_t> > segments;
+    static const char *xml_prefix = "<?xml version=\"1.0\"?>\n<opencv_storage>\n";
+    if (fmt == FileStorage::FORMAT_JSON)
+        segments.push_back(std::make_pair("{\n", (size_t) 2));
+    else if (fmt == FileStorage::FORMAT_XML)
+        segments.push_back(std::make_pair(xml_prefix, strlen(xml_prefix)));
+    segments.push_back(std::make_pair(mapping->data + lnode.begin, lnode.end - lnode.begin));
+    if (fmt == FileStorage::FORMAT_JSON)
+        segments.push_back(std::make_pair("\n}\n", (size_t) 3));
+    else if (fmt == FileStorage::FORMAT_XML)
+        segments.push_back(std::make_pair("\n</opencv_storage>\n", strlen("\n</opencv_storage>\n")));
+
+    // reserveNodeSpace() never changes the linear offset of the node, even if it is moved to a new block
+    size_t blockIdx = fs_data_ptrs.size() - 1, ofs = freeSpaceOfs;
+    FileNode root_nodes(fs_ext, 0, 0);
+    setStrbufSegments(segments);
+    try {
+        bool ok = parser->parse(bufferStart());
+        setStrbufSegments(std::vector<std::pair<const char *, size_t> >());
+        if (!ok)
+            CV_Error_(Error::StsParseError, ("Can't parse '%s' node of %s", key.c_str(), filename.c_str()));
+    }
+    catch (...) {
+        setStrbufSegments(std::vector<std::pair<const char *, size_t> >());
+        throw;
+    }
+    finalizeCollection(root_nodes);
+
+    normalizeNodeOfs(blockIdx, ofs);
+    FileNode doc(fs_ext, blockIdx, ofs);
+    CV_Assert(doc.isMap());
+    lnode.node = doc[key];
+    lnode.parsed = true;
+    return lnode.node;
+}
+
+void FileStorage::Impl::parseAllLazy() {
+    if (!lazy_pending)
+        return;
+    lazy_pending = false;
+
+    FileNode root_nodes(fs_ext, 0, 0);
+    size_t i, nroots0 = root_nodes.size();
+    setStrbufSegments(std::vector<std::pair<const char *, size_t> >(1,
+                      std::make_pair(mapping->data + lazy_ofs, mapping->size - lazy_ofs)));
+    bool ok = false;
+    try {
+        ok = parser->parse(bufferStart());
+        setStrbufSegments(std::vector<std::pair<const char *, size_t> >());
+    }
+    catch (...) {
+        setStrbufSegments(std::vector<std::pair<const char *, size_t> >());
+        throw;
+    }
+    if (!ok)
+        return;
+    finalizeCollection(root_nodes);
+
+    size_t nroots = root_nodes.size();
+    FileNodeIterator it = root_nodes.begin();
+    it += (int) nroots0;
+    for (i = nroots0; i < nroots; i++, ++it)
+        roots.push_back(*it);
+}
+
+void FileStorage::Impl::addLazyData(FileNode &collection, const LazyData &data) {
+    CV_Assert(collection.isSeq() && collection.size() == 0 && data.count > 0 && data.count <= (size_t) INT_MAX);
+    // SEQ node with 'count' elements, which keeps a single placeholder byte instead of them
+    size_t hdr_size = 1 + (collection.isNamed() ? 4 : 0);
+    uchar *cp = reserveNodeSpace(collection, hdr_size + 8 + 1);
+    writeInt(cp + hdr_size + 4, (int) data.count);
+    cp[hdr_size + 8] = (uchar) FileNode::NONE;
+    size_t blockIdx = collection.blockIdx, ofs = collection.ofs + hdr_size + 8;
+    normalizeNodeOfs(blockIdx, ofs);
+    lazy_data[std::make_pair(blockIdx, ofs)] = data;
+}
+
+const FileStorage::Impl::LazyData *FileStorage::Impl::findLazyData(size_t blockIdx, size_t ofs,
+                                                                   size_t count) const {
+    std::map<std::pair<size_t, size_t>, LazyData>::const_iterator it =
+            lazy_data.find(std::make_pair(blockIdx, ofs));
+    return it != lazy_data.end() && it->second.count == count ? &it->second : 0;
+}
+
+static inline double readBase64Value(FileStorage::Impl::Base64Decoder &decoder, int elem_type) {
+    switch (elem_type) {
+        case CV_8U:
+            return decoder.getUInt8();
+        case CV_8S:
+            return (schar) decoder.getUInt8();
+        case CV_16U:
+            return decoder.getUInt16();
+        case CV_16S:
+            return (short) decoder.getUInt16();
+        case CV_32S:
+            return decoder.getInt32();
+        case CV_32F: {
+            Cv32suf v;
+            v.i = decoder.getInt32();
+            return v.f;
+        }
+        case CV_64F:
+            return decoder.getFloat64();
+        case CV_16F:
+            return (float) float16_t::fromBits(decoder.getUInt16());
+        default:
+            CV_Error(Error::StsUnsupportedFormat, "Unsupported type");
+    }
+}
+
+static inline double readRawValue(const uchar *data, int elem_type) {
+    switch (elem_type) {
+        case CV_8U:
+            return *(const uchar *) data;
+        case CV_8S:
+            return *(const schar *) data;
+        case CV_16U:
+            return *(const ushort *) data;
+        case CV_16S:
+            return *(const short *) data;
+        case CV_32S:
+            return *(const int *) data;
+        case CV_32F:
+            return *(const float *) data;
+        case CV_64F:
+            return *(const double *) data;
+        case CV_16F:
+            return (float) *(const float16_t *) data;
+        default:
+            CV_Error(Error::StsUnsupportedFormat, "Unsupported type");
+    }
+}
+
+static inline void writeRawValue(uchar *data, int elem_type, double val) {
+    switch (elem_type) {
+        case CV_8U:
+            *(uchar *) data = saturate_cast<uchar>(val);
+            break;
+        case CV_8S:
+            *(schar *) data = saturate_cast<schar>(val);
+            break;
+        case CV_16U:
+            *(ushort *) data = saturate_cast<ushort>(val);
+            break;
+        case CV_16S:
+            *(short *) data = saturate_cast<short>(val);
+            break;
+        case CV_32S:
+            *(int *) data = saturate_cast<int>(val);
+            break;
+        case CV_32F:
+            *(float *) data = (float) val;
+            break;
+        case CV_64F:
+            *(double *) data = val;
+            break;
+        case CV_16F:
+            *(float16_t *) data = float16_t((float) val);
+            break;
+        default:
+            CV_Error(Error::StsUnsupportedFormat, "Unsupported type");
+    }
+}
+
+// expands format pairs into the list of the structure fields
+static void getFormatFields(const char *dt, std::vector<int> &fields) {
+    int fmt_pairs[CV_FS_MAX_FMT_PAIRS * 2];
+    int fmt_pair_count = fs::decodeFormat(dt, fmt_pairs, CV_FS_MAX_FMT_PAIRS);
+    fields.clear();
+    for (int k = 0; k < fmt_pair_count; k++)
+        fields.insert(fields.end(), fmt_pairs[k * 2], fmt_pairs[k * 2 + 1]);
+}
+
+// offsets of the structure fields in memory (see fs::calcStructSize)
+static void getFieldOffsets(const std::vector<int> &fields, std::vector<size_t> &offsets) {
+    size_t offset = 0;
+    offsets.resize(fields.size());
+    for (size_t i = 0; i < fields.size(); i++) {
+        offset = alignSize(offset, CV_ELEM_SIZE(fields[i]));
+        offsets[i] = offset;
+        offset += CV_ELEM_SIZE(fields[i]);
+    }
+}
+
+size_t FileStorage::Impl::readLazyData(const LazyData &data, size_t firstElem, const String &dst_fmt,
+                                       uchar *data0, size_t maxsz) {
+    std::vector<int> src_fields, dst_fields;
+    getFormatFields(data.dt.c_str(), src_fields);
+    getFormatFields(dst_fmt.c_str(), dst_fields);
+    size_t esz = fs::calcStructSize(dst_fmt.c_str(), 0);
+    CV_Assert(!src_fields.empty() && !dst_fields.empty() && maxsz % esz == 0);
+    maxsz /= esz;
+    if (firstElem >= data.count || maxsz == 0)
+        return 0;
+
+    size_t i, count = std::min(data.count - firstElem, maxsz * dst_fields.size());
+    size_t src_idx = firstElem % src_fields.size();
+    int elem_type = dst_fields[0];
+    bool same_type = true;
+    for (i = 0; i < src_fields.size(); i++)
+        same_type = same_type && src_fields[i] == elem_type;
+    for (i = 0; i < dst_fields.size(); i++)
+        same_type = same_type && dst_fields[i] == elem_type;
+
+    const uchar *src = 0;
+    size_t src_size = 0;
+    std::vector<size_t> src_offsets;
+    Base64Decoder decoder;
+    if (data.raw) {
+        if (same_type) {
+            size_t elem_size = CV_ELEM_SIZE(elem_type);
+            memcpy(data0, data.raw + firstElem * elem_size, count * elem_size);
+            return count;
+        }
+        src_size = fs::calcStructSize(data.dt.c_str(), 0);
+        getFieldOffsets(src_fields, src_offsets);
+        src = data.raw + firstElem / src_fields.size() * src_size;
+    } else {
+        // restore the parser state at the beginning of the base64 data
+        setStrbufSegments(std::vector<std::pair<const char *, size_t> >(1,
+                          std::make_pair(data.src, (size_t) (mapping->data + mapping->size - data.src))));
+        gets();
+        decoder.init(parser, bufferStart() + data.ofs, data.indent);
+    }
+
+    try {
+        static const int one = 1;
+        if (!src) {
+            for (i = 0; i < src_fields.size(); i++)
+                src_size += CV_ELEM_SIZE(src_fields[i]);
+            size_t skip = ::base64::HEADER_SIZE + firstElem / src_fields.size() * src_size;
+            for (i = 0; i < src_idx; i++)
+                skip += CV_ELEM_SIZE(src_fields[i]);
+            CV_Assert(decoder.getBytes(0, skip) == skip);
+        }
+
+        if (!src && same_type && *(const uchar *) &one == 1) {
+            // base64 data is stored in little-endian order: decode it right into the destination
+            size_t nbytes = count * CV_ELEM_SIZE(elem_type);
+            CV_Assert(decoder.getBytes(data0, nbytes) == nbytes);
+        } else {
+            // element-wise conversion, the same as in FileNodeIterator::readRaw()
+            size_t offset = 0, dst_idx = 0;
+            for (i = 0; i < count; i++) {
+                int dst_type = dst_fields[dst_idx], src_type = src_fields[src_idx];
+                offset = alignSize(offset, CV_ELEM_SIZE(dst_type));
+                writeRawValue(data0 + offset, dst_type, src ? readRawValue(src + src_offsets[src_idx], src_type)
+                                                            : readBase64Value(decoder, src_type));
+                offset += CV_ELEM_SIZE(dst_type);
+                if (++src_idx == src_fields.size()) {
+                    src_idx = 0;
+                    if (src)
+                        src += src_size;
+                }
+                if (++dst_idx == dst_fields.size()) {
+                    data0 += esz;
+                    offset = dst_idx = 0;
+                }
+            }
+        }
+    }
+    catch (...) {
+        if (!data.raw)
+            setStrbufSegments(std::vector<std::pair<const char *, size_t> >());
+        throw;
+    }
+    if (!data.raw)
+        setStrbufSegments(std::vector<std::pair<const char *, size_t> >());
+    return count;
+}
+
+FileNode FileStorage::Impl::getLazyElement(const LazyData &data, size_t blockIdx, size_t ofs, size_t idx) {
+    CV_Assert(idx < data.count);
+    std::map<std::pair<size_t, size_t>, LazyElements>::const_iterator it =
+            lazy_elements.find(std::make_pair(blockIdx, ofs));
+    if (it == lazy_elements.end()) {
+        std::vector<int> fields;
+        getFormatFields(data.dt.c_str(), fields);
+        CV_Assert(!fields.empty() && data.count % fields.size() == 0);
+        LazyElements elems;
+        elems.structSize = 0;
+        for (size_t i = 0; i < fields.size(); i++) {
+            elems.fieldOfs.push_back(elems.structSize);
+            elems.structSize += fields[i] == CV_32F || fields[i] == CV_64F || fields[i] == CV_16F ? 1 + 8 : 1 + 4;
+        }
+        size_t i, nbytes = data.count / fields.size() * elems.structSize;
+        if (nbytes > (size_t) INT_MAX - 4)
+            CV_Error(Error::StsOutOfRange, "The sequence is too large to access its elements one by one");
+
+        std::vector<double> values(data.count);
+        CV_Assert(readLazyData(data, 0, "d", (uchar *) &values[0], values.size() * sizeof(double)) == data.count);
+
+        // the elements are stored in a separate sequence, which is appended to the root nodes like
+        // the nodes parsed by getLazyNode(). The whole sequence is placed into a single block.
+        FileNode root_nodes(fs_ext, 0, 0);
+        FileNode seq = addNode(root_nodes, std::string(), FileNode::NONE, 0, -1);
+        uchar *ptr = reserveNodeSpace(seq, 1 + 8 + nbytes);
+        *ptr++ = (uchar) FileNode::SEQ;
+        writeInt(ptr, (int) (4 + nbytes));
+        writeInt(ptr + 4, (int) data.count);
+        ptr += 8;
+        for (i = 0; i < data.count; i++) {
+            int elem_type = fields[i % fields.size()];
+            if (elem_type == CV_32F || elem_type == CV_64F || elem_type == CV_16F) {
+                *ptr++ = (uchar) FileNode::REAL;
+                writeReal(ptr, values[i]);
+                ptr += 8;
+            } else {
+                *ptr++ = (uchar) FileNode::INT;
+                writeInt(ptr, cvRound(values[i]));
+                ptr += 4;
+            }
+        }
+        finalizeCollection(root_nodes);
+        elems.blockIdx = seq.blockIdx;
+        elems.ofs = seq.ofs + 1 + 8;
+        it = lazy_elements.insert(std::make_pair(std::make_pair(blockIdx, ofs), elems)).first;
+    }
+    const LazyElements &elems = it->second;
+    size_t nfields = elems.fieldOfs.size();
+    return FileNode(fs_ext, elems.blockIdx, elems.ofs + idx / nfields * elems.structSize + elems.fieldOfs[idx % nfields]);
+}
+
+#ifdef _WIN32
+#define CV_FS_FSEEK _fseeki64
+#elif defined CV_FS_HAVE_FILE_MAPPING
+#define CV_FS_FSEEK fseeko
+#else
+#define CV_FS_FSEEK fseek
+#endif
+
+void FileStorage::Impl::putBytes(const void *data, size_t len) {
+    CV_Assert(write_mode && file);
+    if (len > 0 && fwrite(data, 1, len, file) != len)
+        CV_Error(cv::Error::StsError, "Could not write to the file");
+}
+
+void FileStorage::Impl::patchBytes(size_t pos, const void *data, size_t len) {
+    CV_Assert(write_mode && file);
+    if (CV_FS_FSEEK(file, pos, SEEK_SET) != 0 || fwrite(data, 1, len, file) != len ||
+        CV_FS_FSEEK(file, 0, SEEK_END) != 0)
+        CV_Error(cv::Error::StsError, "Could not write to the file");
+}
+
+void FileStorage::Impl::addRawData(FileNode &collection, const char *dt, const uchar *data, size_t len,
+                                   bool reference) {
+    FileStorage_API *fs = this;
+    std::vector<int> fields;
+    getFormatFields(dt, fields);
+    size_t esz = fs::calcStructSize(dt, 0);
+    if (fields.empty() || esz == 0 || len % esz != 0)
+        CV_PARSE_ERROR_CPP("Invalid raw data");
+    size_t count = len / esz * fields.size();
+    if (count > (size_t) INT_MAX)
+        CV_PARSE_ERROR_CPP("Too many elements in the sequence");
+
+    convertToCollection(FileNode::SEQ, collection);
+    if (count == 0)
+        return;
+    if (reference) {
+        LazyData ldata = { 0, 0, 0, data, std::string(dt), count };
+        addLazyData(collection, ldata);
+        return;
+    }
+
+    std::vector<size_t> offsets;
+    getFieldOffsets(fields, offsets);
+    for (const uchar *ptr = data; ptr < data + len; ptr += esz) {
+        for (size_t i = 0; i < fields.size(); i++) {
+            int elem_type = fields[i];
+            double fval = readRawValue(ptr + offsets[i], elem_type);
+            if (elem_type == CV_32F || elem_type == CV_64F || elem_type == CV_16F) {
+                addNode(collection, std::string(), FileNode::REAL, &fval, -1);
+            } else {
+                int ival = cvRound(fval);
+                addNode(collection, std::string(), FileNode::INT, &ival, -1);
+            }
+        }
+    }
+}
+
+namespace {
+
+// keeps the file mapping while the matrix is used
+class FileStorageMappingAllocator CV_FINAL : public MatAllocator
+{
+public:
+    UMatData* allocate(int, const int*, int, void*, size_t*, AccessFlag, UMatUsageFlags) const CV_OVERRIDE
+    {
+        // only the matrices that wrap the mapped file are bound to this allocator, the matrices
+        // allocated from them (Mat::create() of a new size, copies) use the default allocator
+        CV_Error(cv::Error::StsNotImplemented,
+                 "The allocator of the mapped FileStorage data can't allocate new matrices");
+    }
+
+    bool allocate(UMatData* u, AccessFlag, UMatUsageFlags) const CV_OVERRIDE
+    {
+        return u != 0;
+    }
+
+    void deallocate(UMatData* u) const CV_OVERRIDE
+    {
+        if (!u)
+            return;
+        CV_Assert(u->urefcount == 0);
+        CV_Assert(u->refcount == 0);
+        delete (Ptr<FileStorageMapping>*) u->userdata;
+        delete u;
+    }
+};
+
+static FileStorageMappingAllocator& getFileStorageMappingAllocator()
+{
+    CV_SINGLETON_LAZY_INIT_REF(FileStorageMappingAllocator, new FileStorageMappingAllocator())
+}
+
+} // namespace
+
+bool FileStorage::Impl::wrapRawData(const FileNode &node, int type, int dims, const int *sizes, Mat &m) {
+    if (!(flags & FileStorage::MAP_DATA) || lazy_data.empty() || !mapping || !node.isSeq())
+        return false;
+    size_t blockIdx = node.blockIdx, ofs = node.ofs + 1 + (node.isNamed() ? 4 : 0) + 8;
+    normalizeNodeOfs(blockIdx, ofs);
+    std::map<std::pair<size_t, size_t>, LazyData>::const_iterator it =
+            lazy_data.find(std::make_pair(blockIdx, ofs));
+    if (it == lazy_data.end() || !it->second.raw)
+        return false;
+    const LazyData &data = it->second;
+
+    std::vector<int> fields;
+    getFormatFields(data.dt.c_str(), fields);
+    size_t i, total = CV_MAT_CN(type);
+    for (i = 0; i < fields.size(); i++)
+        if (fields[i] != CV_MAT_DEPTH(type))
+            return false;
+    for (i = 0; i < (size_t) dims; i++)
+        total *= sizes[i];
+    if (total != data.count || ((size_t) data.raw & (CV_ELEM_SIZE1(type) - 1)) != 0)
+        return false;
+
+    Mat wrapped(dims, sizes, type, (void *) data.raw);
+    UMatData *u = new UMatData(&getFileStorageMappingAllocator());
+    u->data = u->origdata = (uchar *) data.raw;
+    u->size = total * CV_ELEM_SIZE1(type);
+    u->userdata = new Ptr<FileStorageMapping>(mapping);
+    u->refcount = 1;
+    wrapped.u = u;
+    m = wrapped;
+    return true;
+}
+
 void FileStorage::Impl::parseError(const char *func_name, const std::string &err_msg, const char *source_file,
                                    int source_line) {
     std::string msg = format("%s(%d): %s", filename.c_str(), lineno, err_msg.c_str());
@@ -1888,6 +2941,8 @@ void FileStorage::release()
 
 FileNode FileStorage::root(int i) const
 {
+    if( !p.empty() )
+        p->parseAllLazy();
     if( p.empty() || p->roots.empty() || i < 0 || i >= (int)p->roots.size() )
         return FileNode();
 
@@ -1953,6 +3008,8 @@ FileNode FileStorage::operator [](const char* key) const
 
 FileNode FileStorage::operator [](const std::string& key) const
 {
+    if (p->lazy_pending)
+        return p->getLazyNode(key);
     FileNode res;
     for (size_t i = 0; i < p->roots.size(); i++)
     {
@@ -2480,6 +3537,13 @@ FileNodeIterator& FileNodeIterator::operator=(const FileNodeIterator& it)
 
 FileNode FileNodeIterator::operator *() const
 {
+    if( fs && idx < nodeNElems && !fs->lazy_data.empty() )
+    {
+        // the iterator stays at the placeholder of the lazy array, the elements are created on demand
+        const FileStorage::Impl::LazyData* data = fs->findLazyData(blockIdx, ofs, nodeNElems);
+        if( data )
+            return fs->getLazyElement(*data, blockIdx, ofs, idx);
+    }
     return FileNode(idx < nodeNElems ? fs : NULL, blockIdx, ofs);
 }
 
@@ -2487,6 +3551,8 @@ FileNodeIterator& FileNodeIterator::operator ++ ()
 {
     if( idx == nodeNElems || !fs )
         return *this;
+    if( !fs->lazy_data.empty() && fs->findLazyData(blockIdx, ofs, nodeNElems) )
+        return *this += 1;
     idx++;
     FileNode n(fs, blockIdx, ofs);
     ofs += n.rawSize();
@@ -2508,6 +3574,19 @@ FileNodeIterator FileNodeIterator::operator ++ (int)
 FileNodeIterator& FileNodeIterator::operator += (int _ofs)
 {
     CV_Assert( _ofs >= 0 );
+    if( fs && idx < nodeNElems && _ofs > 0 && !fs->lazy_data.empty() &&
+        fs->findLazyData(blockIdx, ofs, nodeNElems) )
+    {
+        idx += std::min((size_t)_ofs, nodeNElems - idx);
+        if( idx == nodeNElems )
+        {
+            // skip the placeholder, so that the iterator is equal to FileNode::end()
+            ofs++;
+            fs->normalizeNodeOfs(blockIdx, ofs);
+            blockSize = fs->fs_data_blksz[blockIdx];
+        }
+        return *this;
+    }
     for( ; _ofs > 0; _ofs-- )
         this->operator ++();
     return *this;
@@ -2515,6 +3594,23 @@ FileNodeIterator& FileNodeIterator::operator += (int _ofs)
 
 FileNodeIterator& FileNodeIterator::readRaw( const String& fmt, void* _data0, size_t maxsz)
 {
+    if( fs && idx < nodeNElems && !fs->lazy_data.empty() )
+    {
+        const FileStorage::Impl::LazyData* data = fs->findLazyData(blockIdx, ofs, nodeNElems);
+        if( data )
+        {
+            idx += fs->readLazyData(*data, idx, fmt, (uchar*)_data0, maxsz);
+            if( idx == nodeNElems )
+            {
+                // skip the placeholder, so that the iterator is equal to FileNode::end()
+                ofs++;
+                fs->normalizeNodeOfs(blockIdx, ofs);
+                blockSize = fs->fs_data_blksz[blockIdx];
+            }
+            return *this;
+        }
+    }
+
     if( fs && idx < nodeNElems )
     {
         uchar* data0 = (uchar*)_data0;
@@ -44,6 +44,11 @@ enum
 #define CV_FS_MAX_LEN 4096
 #define CV_FS_MAX_FMT_PAIRS  128
 
+// FileStorage::FORMAT_BINARY
+#define CV_FS_BINARY_SIGNATURE "OCVFSBIN"
+#define CV_FS_BINARY_VERSION 1
+#define CV_FS_BINARY_ALIGN 64
+
 /****************************************************************************************\
 *                            Common macros and type definitions                          *
 \****************************************************************************************/
@@ -160,6 +165,14 @@ public:
     virtual double strtod(char* ptr, char** endptr) = 0;
 
     virtual char* parseBase64(char* ptr, int indent, FileNode& collection) = 0;
+
+    // FileStorage::FORMAT_BINARY
+    virtual void putBytes( const void* data, size_t len ) = 0;
+    virtual void patchBytes( size_t pos, const void* data, size_t len ) = 0;
+    // appends array of 'dt' structures to the sequence. If 'reference' is true (the sequence must be empty),
+    // the elements are not copied into the nodes, the data must stay valid while the storage is opened
+    virtual void addRawData( FileNode& collection, const char* dt, const uchar* data, size_t len, bool reference ) = 0;
+
     CV_NORETURN
     virtual void parseError(const char* funcname, const std::string& msg,
                             const char* filename, int lineno) = 0;
@@ -197,6 +210,11 @@ public:
     virtual void writeScalar(const char* key, const char* value) = 0;
     virtual void writeComment(const char* comment, bool eol_comment) = 0;
     virtual void startNextStream() = 0;
+    virtual void writeRawData(const char* dt, const void* data, size_t len)
+    {
+        CV_UNUSED(dt); CV_UNUSED(data); CV_UNUSED(len);
+        CV_Error(cv::Error::StsNotImplemented, "Only the binary FileStorage emitter writes raw data blocks (XML/YAML/JSON emit elements)");
+    }
 };
 
 class FileStorageParser
@@ -215,6 +233,9 @@ Ptr<FileStorageParser> createXMLParser(FileStorage_API* fs);
 Ptr<FileStorageParser> createYAMLParser(FileStorage_API* fs);
 Ptr<FileStorageParser> createJSONParser(FileStorage_API* fs);
 
+Ptr<FileStorageEmitter> createBinaryEmitter(FileStorage_API* fs);
+Ptr<FileStorageParser> createBinaryParser(FileStorage_API* fs, const char* data, size_t size);
+
 }
 
 #endif // SRC_PERSISTENCE_HPP
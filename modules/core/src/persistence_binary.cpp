@@ -0,0 +1,381 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html
+
+#include "precomp.hpp"
+#include "persistence.hpp"
+
+/*
+ FileStorage::FORMAT_BINARY layout. All numbers are stored in little-endian byte order,
+ all records start at 8-byte aligned file offsets.
+
+   header:  "OCVFSBIN" signature, uint32 version, uint32 reserved
+   document: list of records terminated by END record, documents follow each other up to the end of file
+
+   record:  uint8 tag, uint8 flags (FileNode::FLOW), uint16 reserved, uint32 key length,
+            key characters (padded with zeros to 8 bytes), value:
+     INT:       int32, 4 zero bytes
+     REAL:      float64
+     STRING:    uint64 length, characters (padded to 8 bytes)
+     SEQ, MAP:  nested records terminated by END record
+     RAW:       uint64 size of the data in bytes, uint32 format length, uint32 reserved, format string
+                (see FileStorage::writeRaw), padding up to CV_FS_BINARY_ALIGN-aligned file offset,
+                the data (padded to 8 bytes)
+     END:       no value
+
+ Consecutive FileStorage::writeRaw() calls with the same format are merged into a single RAW record,
+ so the whole data of Mat is stored as a single aligned block, which is used in-place on reading.
+*/
+
+namespace cv
+{
+
+enum
+{
+    CV_FS_BINARY_HEADER_SIZE = 16,
+    CV_FS_BINARY_RECORD_SIZE = 8
+};
+
+enum BinaryTag
+{
+    BINARY_END = 0,
+    BINARY_INT = FileNode::INT,
+    BINARY_REAL = FileNode::REAL,
+    BINARY_STRING = FileNode::STRING,
+    BINARY_SEQ = FileNode::SEQ,
+    BINARY_MAP = FileNode::MAP,
+    BINARY_RAW = 6
+};
+
+static inline bool isLittleEndianHost()
+{
+    static const int one = 1;
+    return *(const uchar*)&one == 1;
+}
+
+class BinaryEmitter : public FileStorageEmitter
+{
+public:
+    BinaryEmitter(FileStorage_API* _fs) : fs(_fs), pos(0), rawSizePos(0), rawSize(0)
+    {
+        if( !isLittleEndianHost() )
+            CV_Error( cv::Error::StsNotImplemented, "FileStorage::FORMAT_BINARY is not supported on big-endian platforms" );
+
+        uchar header[CV_FS_BINARY_HEADER_SIZE] = {0};
+        memcpy( header, CV_FS_BINARY_SIGNATURE, 8 );
+        uint32_t version = CV_FS_BINARY_VERSION;
+        memcpy( header + 8, &version, 4 );
+        put( header, sizeof(header) );
+    }
+    virtual ~BinaryEmitter() {}
+
+    FStructData startWriteStruct( const FStructData& parent, const char* key,
+                                  int struct_flags, const char* type_name=0 )
+    {
+        CV_UNUSED(type_name);
+        struct_flags = (struct_flags & (FileNode::TYPE_MASK|FileNode::FLOW)) | FileNode::EMPTY;
+        if( !FileNode::isCollection(struct_flags))
+            CV_Error( cv::Error::StsBadArg,
+                     "Some collection type - FileNode::SEQ or FileNode::MAP, must be specified" );
+
+        putRecord( parent.flags, FileNode::isMap(struct_flags) ? BINARY_MAP : BINARY_SEQ,
+                   struct_flags & FileNode::FLOW, key );
+        return FStructData( std::string(), struct_flags, 0 );
+    }
+
+    void endWriteStruct( const FStructData& )
+    {
+        closeRawData();
+        uchar record[CV_FS_BINARY_RECORD_SIZE] = {0};
+        record[0] = (uchar)BINARY_END;
+        put( record, sizeof(record) );
+    }
+
+    void write( const char* key, int value )
+    {
+        putRecord( fs->getCurrentStruct().flags, BINARY_INT, 0, key );
+        uchar buf[8] = {0};
+        memcpy( buf, &value, sizeof(value) );
+        put( buf, sizeof(buf) );
+    }
+
+    void write( const char* key, double value )
+    {
+        putRecord( fs->getCurrentStruct().flags, BINARY_REAL, 0, key );
+        put( &value, sizeof(value) );
+    }
+
+    void write( const char* key, const char* value, bool )
+    {
+        if( !value )
+            CV_Error( cv::Error::StsNullPtr, "Null string pointer" );
+        putRecord( fs->getCurrentStruct().flags, BINARY_STRING, 0, key );
+        uint64_t len = strlen(value);
+        put( &len, sizeof(len) );
+        put( value, (size_t)len );
+        pad( 8 );
+    }
+
+    void writeScalar( const char* key, const char* value )
+    {
+        write( key, value ? value : "", false );
+    }
+
+    void writeComment( const char*, bool )
+    {
+        // comments are not stored
+    }
+
+    void startNextStream()
+    {
+        // the previous document is terminated by endWriteStruct() of the root collection
+    }
+
+    void writeRawData( const char* dt, const void* data, size_t len )
+    {
+        if( rawSizePos > 0 && rawDt == dt )
+        {
+            put( data, len );
+            rawSize += len;
+            return;
+        }
+        if( len == 0 )
+            return;
+
+        putRecord( FileNode::SEQ, BINARY_RAW, 0, 0 );
+        rawSizePos = pos;
+        uint64_t size = 0;
+        put( &size, sizeof(size) );
+        uint32_t dtlen[2] = { (uint32_t)strlen(dt), 0 };
+        put( dtlen, sizeof(dtlen) );
+        put( dt, dtlen[0] );
+        pad( CV_FS_BINARY_ALIGN );
+        put( data, len );
+        rawSize = len;
+        rawDt = dt;
+    }
+
+protected:
+    void put( const void* data, size_t len )
+    {
+        fs->putBytes( data, len );
+        pos += len;
+    }
+
+    void pad( size_t alignment )
+    {
+        static const uchar zeros[CV_FS_BINARY_ALIGN] = {0};
+        put( zeros, alignSize(pos, (int)alignment) - pos );
+    }
+
+    void closeRawData()
+    {
+        if( rawSizePos == 0 )
+            return;
+        pad( 8 );
+        uint64_t size = rawSize;
+        fs->patchBytes( rawSizePos, &size, sizeof(size) );
+        rawSizePos = 0;
+        rawSize = 0;
+        rawDt.clear();
+    }
+
+    void putRecord( int parent_flags, int tag, int flags, const char* key )
+    {
+        closeRawData();
+
+        if( key && key[0] == '\0' )
+            key = 0;
+        if( tag != BINARY_RAW && FileNode::isCollection(parent_flags) &&
+            (FileNode::isMap(parent_flags) ^ (key != 0)) )
+            CV_Error( cv::Error::StsBadArg, "An attempt to add element without a key to a map, "
+                     "or add element with key to sequence" );
+
+        size_t keylen = key ? strlen(key) : 0;
+        if( keylen > CV_FS_MAX_LEN )
+            CV_Error( cv::Error::StsBadArg, "The key is too long" );
+
+        uchar record[CV_FS_BINARY_RECORD_SIZE] = {0};
+        record[0] = (uchar)tag;
+        record[1] = (uchar)flags;
+        uint32_t keylen32 = (uint32_t)keylen;
+        memcpy( record + 4, &keylen32, 4 );
+        put( record, sizeof(record) );
+        if( keylen > 0 )
+        {
+            put( key, keylen );
+            pad( 8 );
+        }
+        fs->setNonEmpty();
+    }
+
+    FileStorage_API* fs;
+    size_t pos;
+    size_t rawSizePos; //!< position of the size field of the last RAW record, if it may be continued
+    size_t rawSize;
+    std::string rawDt;
+};
+
+
+class BinaryParser : public FileStorageParser
+{
+public:
+    BinaryParser(FileStorage_API* _fs, const char* _data, size_t _size)
+        : fs(_fs), data((const uchar*)_data), size(_size)
+    {
+    }
+    virtual ~BinaryParser() {}
+
+    bool getBase64Row(char*, int, char*&, char*&)
+    {
+        return false;
+    }
+
+    bool parse( char* )
+    {
+        if( !isLittleEndianHost() )
+            CV_Error( cv::Error::StsNotImplemented, "FileStorage::FORMAT_BINARY is not supported on big-endian platforms" );
+        if( size < CV_FS_BINARY_HEADER_SIZE || memcmp(data, CV_FS_BINARY_SIGNATURE, 8) != 0 )
+            CV_PARSE_ERROR_CPP( "Invalid file signature" );
+        uint32_t version = 0;
+        memcpy( &version, data + 8, 4 );
+        if( version != CV_FS_BINARY_VERSION )
+            CV_PARSE_ERROR_CPP( "Unsupported version of the binary format" );
+
+        FileNode root_collection(fs->getFS(), 0, 0);
+        size_t pos = CV_FS_BINARY_HEADER_SIZE;
+        while( pos < size )
+        {
+            FileNode root_node = fs->addNode(root_collection, std::string(), FileNode::NONE);
+            pos = parseCollection( pos, root_node );
+            fs->finalizeCollection( root_node );
+        }
+        return true;
+    }
+
+protected:
+    struct Record
+    {
+        int tag;
+        std::string key;
+    };
+
+    void check( size_t pos, size_t len ) const
+    {
+        if( pos > size || len > size - pos )
+            CV_PARSE_ERROR_CPP( "Unexpected end of file" );
+    }
+
+    size_t readRecord( size_t pos, Record& record ) const
+    {
+        check( pos, CV_FS_BINARY_RECORD_SIZE );
+        uint32_t keylen = 0;
+        record.tag = data[pos];
+        memcpy( &keylen, data + pos + 4, 4 );
+        pos += CV_FS_BINARY_RECORD_SIZE;
+        if( keylen > CV_FS_MAX_LEN )
+            CV_PARSE_ERROR_CPP( "The key is too long" );
+        check( pos, keylen );
+        record.key.assign( (const char*)data + pos, keylen );
+        return alignSize( pos + keylen, 8 );
+    }
+
+    size_t parseCollection( size_t pos, FileNode& node )
+    {
+        Record record;
+        for(;;)
+        {
+            pos = readRecord( pos, record );
+            if( record.tag == BINARY_END )
+                return pos;
+
+            if( record.tag == BINARY_RAW )
+            {
+                check( pos, 16 );
+                uint64_t nbytes = 0;
+                uint32_t dtlen = 0;
+                memcpy( &nbytes, data + pos, 8 );
+                memcpy( &dtlen, data + pos + 8, 4 );
+                pos += 16;
+                check( pos, dtlen );
+                if( dtlen == 0 || dtlen > CV_FS_MAX_FMT_PAIRS*4 )
+                    CV_PARSE_ERROR_CPP( "Invalid format of the raw data" );
+                std::string dt( (const char*)data + pos, dtlen );
+                pos = alignSize( pos + dtlen, CV_FS_BINARY_ALIGN );
+                check( pos, (size_t)nbytes );
+                const uchar* rawdata = data + pos;
+                pos = alignSize( pos + (size_t)nbytes, 8 );
+
+                if( node.isMap() )
+                    CV_PARSE_ERROR_CPP( "Map element should have a name" );
+
+                // the data is used in-place, if it is the only element of the sequence
+                Record next;
+                readRecord( pos, next );
+                bool reference = next.tag == BINARY_END && node.size() == 0;
+                fs->addRawData( node, dt.c_str(), rawdata, (size_t)nbytes, reference );
+                continue;
+            }
+
+            FileNode child = fs->addNode( node, record.key, FileNode::NONE );
+            switch( record.tag )
+            {
+            case BINARY_INT:
+            {
+                check( pos, 8 );
+                int ival = 0;
+                memcpy( &ival, data + pos, 4 );
+                child.setValue( FileNode::INT, &ival );
+                pos += 8;
+                break;
+            }
+            case BINARY_REAL:
+            {
+                check( pos, 8 );
+                double fval = 0;
+                memcpy( &fval, data + pos, 8 );
+                child.setValue( FileNode::REAL, &fval );
+                pos += 8;
+                break;
+            }
+            case BINARY_STRING:
+            {
+                check( pos, 8 );
+                uint64_t len = 0;
+                memcpy( &len, data + pos, 8 );
+                pos += 8;
+                check( pos, (size_t)len );
+                if( len > (uint64_t)INT_MAX )
+                    CV_PARSE_ERROR_CPP( "The string is too long" );
+                child.setValue( FileNode::STRING, data + pos, (int)len );
+                pos = alignSize( pos + (size_t)len, 8 );
+                break;
+            }
+            case BINARY_SEQ:
+            case BINARY_MAP:
+                fs->convertToCollection( record.tag, child );
+                pos = parseCollection( pos, child );
+                fs->finalizeCollection( child );
+                break;
+            default:
+                CV_PARSE_ERROR_CPP( "Unknown record type" );
+            }
+        }
+    }
+
+    FileStorage_API* fs;
+    const uchar* data;
+    size_t size;
+};
+
+Ptr<FileStorageEmitter> createBinaryEmitter(FileStorage_API* fs)
+{
+    return makePtr<BinaryEmitter>(fs);
+}
+
+Ptr<FileStorageParser> createBinaryParser(FileStorage_API* fs, const char* data, size_t size)
+{
+    return makePtr<BinaryParser>(fs, data, size);
+}
+
+}
@@ -8,6 +8,7 @@
 #include "persistence.hpp"
 #include "persistence_base64_encoding.hpp"
 #include <unordered_map>
+#include <map>
 #include <iterator>
 
 
@@ -20,6 +21,8 @@ enum Base64State{
     InUse,
 };
 
+class FileStorageMapping;
+
 class cv::FileStorage::Impl : public FileStorage_API
 {
 public:
@@ -151,6 +154,12 @@ public:
 
         double getFloat64();
 
+        // copies up to len decoded bytes to dst (skips them if dst is NULL), returns the number of bytes
+        size_t getBytes(uchar* dst, size_t len);
+
+        // consumes the rest of the base64 sequence without decoding, returns the number of remaining bytes
+        size_t skipToEnd();
+
         bool endOfStream() const;
         char* getPtr() const;
     protected:
@@ -167,6 +176,62 @@ public:
 
     char* parseBase64(char* ptr, int indent, FileNode& collection);
 
+    // FileStorage::LAZY mode
+    struct LazyNode
+    {
+        size_t begin, end; //!< text range of the top-level node in the mapped file
+        bool parsed;
+        FileNode node;
+    };
+
+    // array which is not expanded into the nodes: base64 sequence in FileStorage::LAZY mode (see parseBase64)
+    // or raw data of FileStorage::FORMAT_BINARY (see addRawData)
+    struct LazyData
+    {
+        const char* src;   //!< mapped text of the line where the base64 data starts
+        int ofs, indent;   //!< parser state on that line
+        const uchar* raw;  //!< mapped raw data, if not NULL, the fields above are not used
+        std::string dt;
+        size_t count;      //!< number of elements
+    };
+
+    // nodes of the elements of a LazyData array, which are created on the first access to an element
+    struct LazyElements
+    {
+        size_t blockIdx, ofs;         //!< the first element node
+        size_t structSize;            //!< size of the element nodes of one structure of LazyData::dt
+        std::vector<size_t> fieldOfs; //!< offsets of the element nodes of the structure fields
+    };
+
+    bool mapFile();
+
+    bool buildLazyIndex();
+
+    void setStrbufSegments(const std::vector<std::pair<const char*, size_t> >& segments);
+
+    FileNode getLazyNode(const std::string& key);
+
+    void parseAllLazy();
+
+    void addLazyData(FileNode& collection, const LazyData& data);
+
+    const LazyData* findLazyData(size_t blockIdx, size_t ofs, size_t count) const;
+
+    size_t readLazyData(const LazyData& data, size_t firstElem, const String& fmt, uchar* data0, size_t maxsz);
+
+    FileNode getLazyElement(const LazyData& data, size_t blockIdx, size_t ofs, size_t idx);
+
+    // FileStorage::FORMAT_BINARY
+    void putBytes(const void* data, size_t len);
+
+    void patchBytes(size_t pos, const void* data, size_t len);
+
+    void addRawData(FileNode& collection, const char* dt, const uchar* data, size_t len, bool reference);
+
+    // in FileStorage::MAP_DATA mode creates matrix header for the raw data of the node (without copying),
+    // returns false if it is not possible
+    bool wrapRawData(const FileNode& node, int type, int dims, const int* sizes, Mat& m);
+
     void parseError( const char* func_name, const std::string& err_msg, const char* source_file, int source_line );
 
     const uchar* getNodePtr(size_t blockIdx, size_t ofs) const;
@@ -223,7 +288,18 @@ public:
     char* strbuf;
     size_t strbufsize;
     size_t strbufpos;
+    std::vector<std::pair<const char*, size_t> > strbufsegs;
+    size_t strbufseg;
+    const char* strbufline;
     int lineno;
+
+    bool lazy_mode;
+    bool lazy_pending; //!< top-level nodes are indexed, but the whole file has not been parsed yet
+    size_t lazy_ofs;   //!< text start (after BOM)
+    Ptr<FileStorageMapping> mapping;
+    std::unordered_map<std::string, LazyNode> lazy_index;
+    std::map<std::pair<size_t, size_t>, LazyData> lazy_data;
+    std::map<std::pair<size_t, size_t>, LazyElements> lazy_elements;
 };
 
 }
@@ -368,6 +368,9 @@ bool __termination;  // skip some cleanups, because process is terminating
 
 cv::Mutex& getInitializationMutex();
 
+// first-touch of fresh Mat buffers from worker threads, see OPENCV_MAT_FIRST_TOUCH_THRESHOLD
+void matFirstTouchHint(void* data, size_t size);
+
 #define CV_SINGLETON_LAZY_INIT_(TYPE, INITIALIZER, RET_VALUE) \
     static TYPE* const instance = INITIALIZER; \
     return RET_VALUE;
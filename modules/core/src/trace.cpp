@@ -97,6 +97,23 @@ static bool param_synchronizeOpenCL = utils::getConfigurationParameterBool("OPEN
 static bool param_ITT_registerParentScope = utils::getConfigurationParameterBool("OPENCV_TRACE_ITT_PARENT", false);
 #endif
 
+// Aggregated statistics mode (independent from trace files / ITT)
+static std::atomic<bool> g_statisticsEnabled(utils::getConfigurationParameterBool("OPENCV_TRACE_STATISTICS", false));
+static std::atomic<int> g_statisticsEpoch(0);
+static size_t param_statisticsEvents = utils::getConfigurationParameterSizeT("OPENCV_TRACE_STATISTICS_EVENTS", 0);
+
+static inline bool isStatisticsActive()
+{
+    return g_statisticsEnabled.load(std::memory_order_relaxed) && !cv::__termination;
+}
+
+// global_location_id => location, guarded by getInitializationMutex()
+static std::vector<const Region::LocationStaticStorage*>& getRegisteredLocations()
+{
+    static std::vector<const Region::LocationStaticStorage*> locations;
+    return locations;
+}
+
 static const char* _spaces(int count)
 {
     static const char buf[64] =
@@ -237,6 +254,12 @@ Region::LocationExtraData::LocationExtraData(const LocationStaticStorage& locati
     CV_UNUSED(location);
     static int g_location_id_counter = 0;
     global_location_id = CV_XADD(&g_location_id_counter, 1) + 1;
+    {
+        std::vector<const Region::LocationStaticStorage*>& locations = getRegisteredLocations();
+        if (locations.size() <= (size_t)global_location_id)
+            locations.resize(global_location_id + 1, NULL);
+        locations[global_location_id] = &location;
+    }
     CV_LOG("Register location: " << global_location_id << " (" << (void*)&location << ")"
             << std::endl << "    file: " << location.filename
             << std::endl << "    line: " << location.line
@@ -281,6 +304,115 @@ Region::LocationExtraData::LocationExtraData(const LocationStaticStorage& locati
 }
 
 
+RegionStatisticsThreadLocal::RegionStatisticsThreadLocal() :
+    epoch(-1),
+    depth(0),
+    events(NULL),
+    eventsCapacity(0),
+    eventsCount(0)
+{
+    for (int i = 0; i < MAX_BLOCKS; i++)
+        blocks[i].store(NULL, std::memory_order_relaxed);
+}
+
+RegionStatisticsThreadLocal::~RegionStatisticsThreadLocal()
+{
+    for (int i = 0; i < MAX_BLOCKS; i++)
+        delete[] blocks[i].load(std::memory_order_relaxed);
+    delete[] events;
+}
+
+RegionCounters* RegionStatisticsThreadLocal::getCounters(int locationId)
+{
+    const int blockIdx = locationId / BLOCK_SIZE;
+    if (locationId <= 0 || blockIdx >= MAX_BLOCKS)
+        return NULL;
+    RegionCounters* block = blocks[blockIdx].load(std::memory_order_relaxed);
+    if (!block)
+    {
+        block = new RegionCounters[BLOCK_SIZE];
+        blocks[blockIdx].store(block, std::memory_order_release);
+    }
+    return &block[locationId % BLOCK_SIZE];
+}
+
+void RegionStatisticsThreadLocal::reset(int newEpoch)
+{
+    for (int i = 0; i < MAX_BLOCKS; i++)
+    {
+        RegionCounters* block = blocks[i].load(std::memory_order_relaxed);
+        if (block)
+            for (int j = 0; j < BLOCK_SIZE; j++)
+                block[j].reset();
+    }
+    if (!events && param_statisticsEvents > 0)
+    {
+        events = new RegionEvent[param_statisticsEvents];
+        eventsCapacity = param_statisticsEvents;
+    }
+    eventsCount.store(0, std::memory_order_release);
+    epoch.store(newEpoch, std::memory_order_release);
+}
+
+void RegionStatisticsThreadLocal::leave(int64 endTicks)
+{
+    CV_DbgAssert(depth > 0);
+    const StackEntry& e = stack[--depth];
+    const int64 duration = endTicks - e.beginTicks;
+    RegionCounters& c = *e.counters;
+    c.calls.store(c.calls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    c.totalTicks.store(c.totalTicks.load(std::memory_order_relaxed) + duration, std::memory_order_relaxed);
+    if (duration > c.maxTicks.load(std::memory_order_relaxed))
+        c.maxTicks.store(duration, std::memory_order_relaxed);
+    if (events)
+    {
+        const uint64 n = eventsCount.load(std::memory_order_relaxed);
+        RegionEvent& ev = events[n % eventsCapacity];
+        ev.beginTicks.store(e.beginTicks, std::memory_order_relaxed);
+        ev.durationTicks.store(duration, std::memory_order_relaxed);
+        ev.locationId.store(e.locationId, std::memory_order_relaxed);
+        eventsCount.store(n + 1, std::memory_order_release);
+    }
+}
+
+static bool statisticsRegionEnter(Region& region, const Region::LocationStaticStorage& location, bool closePreviousRegion)
+{
+    RegionStatisticsThreadLocal& s = getTraceManager().tls.getRef().statistics;
+    const int epoch = g_statisticsEpoch.load(std::memory_order_acquire);
+    if (s.epoch.load(std::memory_order_relaxed) != epoch)
+        s.reset(epoch);
+
+    if (closePreviousRegion && s.depth > 0 && s.depth <= RegionStatisticsThreadLocal::MAX_DEPTH)
+    {
+        // CV_TRACE_REGION_NEXT() without trace stack: close the previous named region of the same scope
+        RegionStatisticsThreadLocal::StackEntry& top = s.stack[s.depth - 1];
+        if ((top.flags & REGION_FLAG_FUNCTION) == 0)
+        {
+            top.region->implFlags &= ~REGION_FLAG__STATISTICS;
+            s.leave(getTickCount());
+        }
+    }
+
+    if (s.depth >= RegionStatisticsThreadLocal::MAX_DEPTH)
+        return false;
+    if (s.depth > 0 && (s.stack[s.depth - 1].flags & REGION_FLAG_SKIP_NESTED))
+        return false;
+
+    const int locationId = Region::LocationExtraData::init(location)->global_location_id;
+    RegionCounters* counters = s.getCounters(locationId);
+    if (!counters)
+        return false;
+
+    RegionStatisticsThreadLocal::StackEntry& e = s.stack[s.depth++];
+    e.region = &region;
+    e.counters = counters;
+    e.locationId = locationId;
+    e.flags = location.flags;
+    e.beginTicks = getTickCount();
+    return true;
+}
+
+
 Region::Impl::Impl(TraceManagerThreadLocal& ctx, Region* parentRegion_, Region& region_, const LocationStaticStorage& location_, int64 beginTimestamp_) :
     location(location_),
     region(region_),
@@ -451,6 +583,8 @@ Region::Region(const LocationStaticStorage& location) :
     if (!TraceManager::isActivated())
     {
         CV_LOG("Trace is disabled. Bailout");
+        if (isStatisticsActive() && statisticsRegionEnter(*this, location, (location.flags & REGION_FLAG_REGION_NEXT) != 0))
+            implFlags |= REGION_FLAG__STATISTICS;
         return;
     }
 
@@ -471,6 +605,9 @@ Region::Region(const LocationStaticStorage& location) :
         }
     }
 
+    if (isStatisticsActive() && statisticsRegionEnter(*this, location, false))
+        implFlags |= REGION_FLAG__STATISTICS;
+
     int parentChildren = 0;
     if (parentRegion && parentRegion->pImpl)
     {
@@ -599,6 +736,15 @@ void Region::destroy()
 {
     CV_DbgAssert(implFlags != 0);
 
+    if (implFlags & REGION_FLAG__STATISTICS)
+    {
+        implFlags &= ~REGION_FLAG__STATISTICS;
+        if (!cv::__termination)
+            getTraceManager().tls.getRef().statistics.leave(getTickCount());
+        if (implFlags == 0)
+            return;
+    }
+
     TraceManagerThreadLocal& ctx = getTraceManager().tls.getRef();
     CV_LOG(_spaces(ctx.getCurrentDepth()*4) << "Region::destruct(): " << (void*)this << " pImpl=" << pImpl << " implFlags=" << implFlags << ' ' << (ctx.stackTopLocation() ? ctx.stackTopLocation()->name : "<unknown>"));
 
@@ -1140,6 +1286,140 @@ void traceArg(const TraceArg& arg, double value)
 #endif
 }
 
+void traceBytes(size_t bytes)
+{
+    if (!isStatisticsActive())
+        return;
+    RegionStatisticsThreadLocal& s = getTraceManager().tls.getRef().statistics;
+    if (s.depth > 0)
+    {
+        RegionCounters& c = *s.stack[s.depth - 1].counters;
+        c.bytes.store(c.bytes.load(std::memory_order_relaxed) + bytes, std::memory_order_relaxed);
+    }
+}
+
+namespace {
+
+struct ThreadEvents
+{
+    int threadID;
+    std::vector<int64> beginTicks;
+    std::vector<int64> durationTicks;
+    std::vector<int> locationIds;
+};
+
+static void gatherStatistics(std::vector<TraceRegionStatistics>& stats, std::vector<ThreadEvents>* events)
+{
+    stats.clear();
+    std::vector<TraceManagerThreadLocal*> threads_ctx;
+    getTraceManager().tls.gather(threads_ctx);
+    const int epoch = g_statisticsEpoch.load(std::memory_order_acquire);
+
+    std::vector<const Region::LocationStaticStorage*> locations;
+    {
+        cv::AutoLock lock(cv::getInitializationMutex());
+        locations = getRegisteredLocations();
+    }
+    struct Totals
+    {
+        uint64 calls;
+        int64 totalTicks;
+        int64 maxTicks;
+        uint64 bytes;
+    };
+    std::vector<Totals> total(locations.size(), Totals());
+    for (size_t i = 0; i < threads_ctx.size(); i++)
+    {
+        TraceManagerThreadLocal* ctx = threads_ctx[i];
+        if (!ctx)
+            continue;
+        RegionStatisticsThreadLocal& s = ctx->statistics;
+        if (s.epoch.load(std::memory_order_acquire) != epoch)
+            continue;  // thread has no records after the last reset
+        for (size_t id = 1; id < locations.size(); id++)
+        {
+            RegionCounters* block = s.blocks[id / RegionStatisticsThreadLocal::BLOCK_SIZE].load(std::memory_order_acquire);
+            if (!block)
+                continue;
+            const RegionCounters& src = block[id % RegionStatisticsThreadLocal::BLOCK_SIZE];
+            Totals& dst = total[id];
+            dst.calls += src.calls.load(std::memory_order_relaxed);
+            dst.totalTicks += src.totalTicks.load(std::memory_order_relaxed);
+            dst.maxTicks = std::max(dst.maxTicks, (int64)src.maxTicks.load(std::memory_order_relaxed));
+            dst.bytes += src.bytes.load(std::memory_order_relaxed);
+        }
+        if (events && s.events)
+        {
+            // owner thread may overwrite entries during copying: drop entries which could be reused
+            const uint64 count1 = s.eventsCount.load(std::memory_order_acquire);
+            const uint64 first = count1 > s.eventsCapacity ? count1 - s.eventsCapacity : 0;
+            ThreadEvents te;
+            te.threadID = ctx->threadID;
+            for (uint64 k = first; k < count1; k++)
+            {
+                const RegionEvent& ev = s.events[k % s.eventsCapacity];
+                te.beginTicks.push_back(ev.beginTicks.load(std::memory_order_relaxed));
+                te.durationTicks.push_back(ev.durationTicks.load(std::memory_order_relaxed));
+                te.locationIds.push_back(ev.locationId.load(std::memory_order_relaxed));
+            }
+            const uint64 count2 = s.eventsCount.load(std::memory_order_acquire);
+            if (count2 < count1)
+                continue;  // concurrent reset
+            // entry 'count2' may be written right now: it reuses slot of 'count2 - eventsCapacity'
+            const uint64 firstValid = count2 >= s.eventsCapacity ? count2 - s.eventsCapacity + 1 : 0;
+            const size_t skip = (size_t)(std::min(std::max(firstValid, first), count1) - first);
+            te.beginTicks.erase(te.beginTicks.begin(), te.beginTicks.begin() + skip);
+            te.durationTicks.erase(te.durationTicks.begin(), te.durationTicks.begin() + skip);
+            te.locationIds.erase(te.locationIds.begin(), te.locationIds.begin() + skip);
+            events->push_back(te);
+        }
+    }
+
+    const double tickFreq = getTickFrequency();
+    for (size_t id = 1; id < locations.size(); id++)
+    {
+        const Totals& c = total[id];
+        if (!locations[id] || c.calls == 0)
+            continue;
+        TraceRegionStatistics r;
+        r.name = locations[id]->name;
+        r.filename = locations[id]->filename;
+        r.line = locations[id]->line;
+        r.calls = c.calls;
+        r.totalTime = c.totalTicks / tickFreq;
+        r.maxTime = c.maxTicks / tickFreq;
+        r.bytes = c.bytes;
+        stats.push_back(r);
+    }
+    struct CompareTime
+    {
+        bool operator()(const TraceRegionStatistics& a, const TraceRegionStatistics& b) const { return a.totalTime > b.totalTime; }
+    };
+    std::sort(stats.begin(), stats.end(), CompareTime());
+}
+
+static std::string jsonEscape(const std::string& str)
+{
+    std::string result;
+    result.reserve(str.size());
+    for (size_t i = 0; i < str.size(); i++)
+    {
+        const char c = str[i];
+        if (c == '"' || c == '\\')
+        {
+            result += '\\';
+            result += c;
+        }
+        else if ((unsigned char)c < 0x20)
+            result += cv::format("\\u%04x", (int)c);
+        else
+            result += c;
+    }
+    return result;
+}
+
+} // namespace
+
 #else
 
 Region::Region(const LocationStaticStorage&) : pImpl(NULL), implFlags(0) {}
@@ -1149,7 +1429,88 @@ void traceArg(const TraceArg&, const char*) {}
 void traceArg(const TraceArg&, int) {};
 void traceArg(const TraceArg&, int64) {};
 void traceArg(const TraceArg&, double) {};
+void traceBytes(size_t) {}
+
+#endif
+
+} // namespace details
+
+#ifdef OPENCV_TRACE
+
+void setStatisticsEnabled(bool enabled)
+{
+    details::g_statisticsEnabled.store(enabled);
+}
+
+bool isStatisticsEnabled()
+{
+    return details::g_statisticsEnabled.load();
+}
+
+void getStatistics(std::vector<TraceRegionStatistics>& stats)
+{
+    details::gatherStatistics(stats, NULL);
+}
+
+void resetStatistics()
+{
+    details::g_statisticsEpoch++;
+}
+
+bool writeChromeTrace(const std::string& filename)
+{
+    std::vector<TraceRegionStatistics> stats;
+    std::vector<details::ThreadEvents> events;
+    details::gatherStatistics(stats, &events);
+
+    std::vector<const details::Region::LocationStaticStorage*> locations;
+    {
+        cv::AutoLock lock(cv::getInitializationMutex());
+        locations = details::getRegisteredLocations();
+    }
+
+    std::ofstream out(filename.c_str(), std::ios::trunc);
+    if (!out.is_open())
+        return false;
+    const double ticksToUs = 1e6 / getTickFrequency();
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    for (size_t t = 0; t < events.size(); t++)
+    {
+        const details::ThreadEvents& te = events[t];
+        out << (first ? "\n" : ",\n") << cv::format("{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"OpenCV thread %d\"}}", te.threadID, te.threadID);
+        first = false;
+        for (size_t k = 0; k < te.locationIds.size(); k++)
+        {
+            const int id = te.locationIds[k];
+            if (id <= 0 || (size_t)id >= locations.size() || !locations[id])
+                continue;
+            out << ",\n{\"ph\":\"X\",\"cat\":\"opencv\",\"pid\":1,\"tid\":" << te.threadID
+                << ",\"name\":\"" << details::jsonEscape(locations[id]->name) << "\""
+                << cv::format(",\"ts\":%.3f,\"dur\":%.3f}", (te.beginTicks[k] - details::g_zero_timestamp) * ticksToUs, te.durationTicks[k] * ticksToUs);
+        }
+    }
+    out << "\n],\n\"opencvStatistics\":[";
+    for (size_t i = 0; i < stats.size(); i++)
+    {
+        const TraceRegionStatistics& r = stats[i];
+        out << (i == 0 ? "\n" : ",\n")
+            << "{\"name\":\"" << details::jsonEscape(r.name) << "\",\"file\":\"" << details::jsonEscape(r.filename) << "\""
+            << cv::format(",\"line\":%d,\"calls\":%llu,\"totalTime\":%.9f,\"maxTime\":%.9f,\"bytes\":%llu}",
+                    r.line, (unsigned long long)r.calls, r.totalTime, r.maxTime, (unsigned long long)r.bytes);
+    }
+    out << "\n]}\n";
+    return !out.fail();
+}
+
+#else
+
+void setStatisticsEnabled(bool) {}
+bool isStatisticsEnabled() { return false; }
+void getStatistics(std::vector<TraceRegionStatistics>& stats) { stats.clear(); }
+void resetStatistics() {}
+bool writeChromeTrace(const std::string&) { return false; }
 
 #endif
 
-}}}} // namespace
+}}} // namespace
@@ -2477,4 +2477,171 @@ TEST(Core_Magnitude, regression_19506)
 }
 
 
+
+// dst(y, x)[c] = src(sy, sx)[order[c]], see the description of REORDER_* flags
+static void reorderImageReference(const Mat& src, Mat& dst, int flags, const std::vector<int>& order)
+{
+    const bool transposed = (flags & REORDER_TRANSPOSE) != 0;
+    const int rows = transposed ? src.cols : src.rows, cols = transposed ? src.rows : src.cols;
+    const int cn = order.empty() ? src.channels() : (int)order.size();
+    const size_t esz1 = src.elemSize1();
+    dst.create(rows, cols, CV_MAKETYPE(src.depth(), cn));
+    for (int y = 0; y < rows; y++)
+        for (int x = 0; x < cols; x++)
+        {
+            int ty = (flags & REORDER_FLIP_VERTICAL) ? rows - 1 - y : y;
+            int tx = (flags & REORDER_FLIP_HORIZONTAL) ? cols - 1 - x : x;
+            int sy = transposed ? tx : ty, sx = transposed ? ty : tx;
+            for (int c = 0; c < cn; c++)
+                memcpy(dst.ptr(y, x) + c*esz1, src.ptr(sy, sx) + (order.empty() ? c : order[c])*esz1, esz1);
+        }
+}
+
+static Mat randomImage(Size sz, int type)
+{
+    Mat m(sz, type);
+    cvtest::randUni(theRNG(), m, Scalar::all(0), Scalar::all(100));
+    return m;
+}
+
+typedef testing::TestWithParam<tuple<perf::MatType, Size> > Core_ReorderImage;
+
+TEST_P(Core_ReorderImage, orientation)
+{
+    const int type = get<0>(GetParam());
+    const Size sz = get<1>(GetParam());
+    Mat big = randomImage(Size(sz.width + 3, sz.height + 2), type);
+    Mat src = big(Rect(1, 1, sz.width, sz.height));
+    for (int flags = 0; flags < 8; flags++)
+    {
+        Mat dst, ref;
+        reorderImage(src, dst, flags);
+        reorderImageReference(src, ref, flags, std::vector<int>());
+        ASSERT_EQ(0, cvtest::norm(dst, ref, NORM_INF)) << "flags=" << flags;
+    }
+
+    Mat dst, ref;
+    cv::transpose(src, dst);
+    reorderImageReference(src, ref, REORDER_TRANSPOSE, std::vector<int>());
+    EXPECT_EQ(0, cvtest::norm(dst, ref, NORM_INF));
+    cv::rotate(src, dst, ROTATE_90_CLOCKWISE);
+    reorderImageReference(src, ref, REORDER_ROTATE_90_CLOCKWISE, std::vector<int>());
+    EXPECT_EQ(0, cvtest::norm(dst, ref, NORM_INF));
+    cv::rotate(src, dst, ROTATE_90_COUNTERCLOCKWISE);
+    reorderImageReference(src, ref, REORDER_ROTATE_90_COUNTERCLOCKWISE, std::vector<int>());
+    EXPECT_EQ(0, cvtest::norm(dst, ref, NORM_INF));
+    cv::flip(src, dst, -1);
+    reorderImageReference(src, ref, REORDER_ROTATE_180, std::vector<int>());
+    EXPECT_EQ(0, cvtest::norm(dst, ref, NORM_INF));
+}
+
+TEST_P(Core_ReorderImage, planar)
+{
+    const int type = get<0>(GetParam());
+    const Size sz = get<1>(GetParam());
+    const int cn = CV_MAT_CN(type);
+    Mat src = randomImage(sz, type);
+    std::vector<int> order;
+    for (int c = cn - 1; c >= 0; c--)
+        order.push_back(c);
+
+    for (int flags = 0; flags < 8; flags++)
+    {
+        Mat blob, ref;
+        reorderImage(src, blob, flags | REORDER_TO_PLANAR, order);
+        reorderImageReference(src, ref, flags, order);
+        ASSERT_EQ(4, blob.dims);
+        ASSERT_EQ(cn, blob.size[1]);
+        std::vector<Mat> planes;
+        split(ref, planes);
+        for (int c = 0; c < cn; c++)
+        {
+            Mat plane(ref.size(), CV_MAT_DEPTH(type), blob.ptr(0, c));
+            ASSERT_EQ(0, cvtest::norm(plane, planes[c], NORM_INF)) << "flags=" << flags << " c=" << c;
+        }
+
+        // and back
+        Mat dst, ref2;
+        reorderImage(blob, dst, flags | REORDER_FROM_PLANAR, order);
+        reorderImageReference(ref, ref2, flags, order);
+        ASSERT_EQ(0, cvtest::norm(dst, ref2, NORM_INF)) << "flags=" << flags;
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Core_ReorderImage, testing::Combine(
+    testing::Values(CV_8UC1, CV_8UC3, CV_8UC4, CV_16UC1, CV_16UC3, CV_32FC1, CV_32FC3, CV_32FC4, CV_64FC1),
+    testing::Values(Size(7, 5), Size(64, 48), Size(517, 263))
+));
+
+TEST(Core_ReorderImageChannels, accuracy)
+{
+    Mat src = randomImage(Size(101, 37), CV_8UC4);
+    std::vector<int> order;
+    order.push_back(2); order.push_back(2); order.push_back(0);
+    Mat dst, ref;
+    reorderImage(src, dst, REORDER_ROTATE_90_CLOCKWISE, order);
+    reorderImageReference(src, ref, REORDER_ROTATE_90_CLOCKWISE, order);
+    EXPECT_EQ(CV_8UC3, dst.type());
+    EXPECT_EQ(0, cvtest::norm(dst, ref, NORM_INF));
+
+    std::vector<int> bad(1, 4);
+    EXPECT_THROW(reorderImage(src, dst, 0, bad), cv::Exception);
+}
+
+TEST(Core_ReorderImageStrided, accuracy)
+{
+    // a row into a column of a wider matrix: the destination elements are not adjacent
+    Mat src(1, 37, CV_16UC3), big(40, 9, CV_16UC3, Scalar::all(7));
+    randu(src, 0, 65536);
+    Mat dst = big(Rect(5, 2, 1, 37)), ref = big.clone();
+    for (int i = 0; i < src.cols; i++)
+        ref.at<Vec3w>(i + 2, 5) = src.at<Vec3w>(0, i);
+
+    cv::transpose(src, dst);
+    EXPECT_EQ(dst.data, big.ptr(2, 5));
+    EXPECT_EQ(0, cvtest::norm(ref, big, NORM_INF));
+
+    Mat diag = big.diag();
+    cv::flip(Mat(9, 1, CV_16UC3, Scalar::all(3)), diag, -1);
+    EXPECT_EQ(Vec3w(3, 3, 3), big.at<Vec3w>(8, 8));
+}
+
+TEST(Core_TransposeND, permutations)
+{
+    const int sz[] = { 3, 17, 35, 4 };
+    const int types[] = { CV_8UC1, CV_16UC1, CV_8UC3, CV_32FC1, CV_64FC1, CV_32FC3 };
+    for (size_t t = 0; t < sizeof(types)/sizeof(types[0]); t++)
+    {
+        const int type = types[t];
+        Mat src(4, sz, type);
+        cvtest::randUni(theRNG(), src, Scalar::all(0), Scalar::all(100));
+        std::vector<int> order(4);
+        for (int i = 0; i < 4; i++)
+            order[i] = i;
+        do
+        {
+            Mat dst;
+            transposeND(src, order, dst);
+            ASSERT_EQ(4, dst.dims);
+            const size_t esz = src.elemSize();
+            int idx[4], sidx[4];
+            for (idx[0] = 0; idx[0] < dst.size[0]; idx[0]++)
+            for (idx[1] = 0; idx[1] < dst.size[1]; idx[1]++)
+            for (idx[2] = 0; idx[2] < dst.size[2]; idx[2]++)
+            for (idx[3] = 0; idx[3] < dst.size[3]; idx[3]++)
+            {
+                for (int i = 0; i < 4; i++)
+                    sidx[order[i]] = idx[i];
+                ASSERT_EQ(0, memcmp(dst.ptr(idx), src.ptr(sidx), esz))
+                    << "type=" << type << " order=" << Mat(order).t();
+            }
+        }
+        while (std::next_permutation(order.begin(), order.end()));
+    }
+
+    Mat src(4, sz, CV_32F), dst;
+    std::vector<int> bad(4, 0);
+    EXPECT_THROW(transposeND(src, bad, dst), cv::Exception);
+}
+
 }} // namespace
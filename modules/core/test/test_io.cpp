@@ -1919,4 +1919,263 @@ TEST(Core_InputOutput, FileStorage_16F_json)
 }
 
 
+// the elements of the sequences which are not expanded into nodes at reading are accessed one by one
+static void check_seq_elements(const FileNode& node, const std::vector<int>& v)
+{
+    ASSERT_EQ(v.size(), node.size());
+    EXPECT_TRUE(node[0].isInt());
+    EXPECT_EQ(v[0], (int)node[0]);
+    EXPECT_EQ(v[500], (int)node[500]);
+    EXPECT_EQ(v.back(), (int)node[(int)v.size() - 1]);
+
+    size_t count = 0, mismatches = 0;
+    for (const FileNode& elem : node)
+    {
+        if (count >= v.size() || (int)elem != v[count])
+            mismatches++;
+        count++;
+    }
+    EXPECT_EQ(v.size(), count);
+    EXPECT_EQ(0u, mismatches);
+
+    FileNodeIterator it = node.begin();
+    it += 1000;
+    EXPECT_EQ(v[1000], (int)*it);
+    it++;
+    EXPECT_TRUE(it == node.end());
+    it += 1;
+    EXPECT_TRUE(it == node.end());
+
+    // the data is still read in one go
+    std::vector<int> v_result;
+    node >> v_result;
+    EXPECT_EQ(v, v_result);
+}
+
+static void test_lazy_read(const std::string& ext)
+{
+    const std::string fname = cv::tempfile(ext.c_str());
+    Mat m(64, 48, CV_32FC3), m2(17, 5, CV_16SC1);
+    randu(m, Scalar::all(-100), Scalar::all(100));
+    randu(m2, Scalar::all(-1000), Scalar::all(1000));
+    std::vector<int> v(1001);
+    for (size_t i = 0; i < v.size(); i++)
+        v[i] = (int)(i * 7) - 300;
+    {
+        FileStorage fs(fname, FileStorage::WRITE_BASE64);
+        fs << "scalar" << 42;
+        fs << "name" << "lazy";
+        fs << "seq" << "[" << 1 << 2 << 3 << "]";
+        fs << "m" << m;
+        fs << "v" << v;
+        fs << "nested" << "{" << "m2" << m2 << "x" << 1.5 << "}";
+        fs << "last" << -1;
+    }
+
+    FileStorage fs(fname, FileStorage::READ + FileStorage::LAZY);
+    ASSERT_TRUE(fs.isOpened());
+    EXPECT_EQ(-1, (int)fs["last"]);
+    EXPECT_TRUE(fs["missing"].empty());
+
+    Mat m_result, m2_result;
+    fs["m"] >> m_result;
+    EXPECT_EQ(m.type(), m_result.type());
+    EXPECT_EQ(0, cvtest::norm(m, m_result, NORM_INF));
+
+    FileNode nested = fs["nested"];
+    ASSERT_TRUE(nested.isMap());
+    nested["m2"] >> m2_result;
+    EXPECT_EQ(0, cvtest::norm(m2, m2_result, NORM_INF));
+    EXPECT_EQ(1.5, (double)nested["x"]);
+
+    std::vector<int> v_result;
+    fs["v"] >> v_result;
+    EXPECT_EQ(v, v_result);
+    std::vector<double> vd_result; // element-wise conversion
+    fs["v"] >> vd_result;
+    ASSERT_EQ(v.size(), vd_result.size());
+    EXPECT_EQ(v.back(), (int)vd_result.back());
+    FileNode v_node = fs["v"];
+    EXPECT_EQ(v.size(), v_node.size());
+    int v_part[3] = {};
+    FileNodeIterator it = v_node.begin();
+    it.readRaw("i", v_part, sizeof(v_part));
+    EXPECT_EQ(v[2], v_part[2]);
+    it.readRaw("i", v_part, sizeof(v_part));
+    EXPECT_EQ(v[3], v_part[0]);
+    check_seq_elements(v_node, v);
+    FileNode m_data = fs["m"]["data"];
+    ASSERT_EQ(m.total() * m.channels(), m_data.size());
+    EXPECT_TRUE(m_data[7].isReal());
+    EXPECT_EQ(m.ptr<float>()[7], (float)m_data[7]);
+
+    EXPECT_EQ(42, (int)fs["scalar"]);
+    EXPECT_EQ("lazy", (std::string)fs["name"]);
+    EXPECT_EQ(3u, fs["seq"].size());
+
+    // the whole file is parsed on the first access to the root node
+    FileNode root = fs.root();
+    EXPECT_EQ(7u, root.size());
+    EXPECT_EQ(42, (int)fs["scalar"]);
+    fs["m"] >> m_result;
+    EXPECT_EQ(0, cvtest::norm(m, m_result, NORM_INF));
+    fs.release();
+
+    EXPECT_EQ(0, remove(fname.c_str()));
+}
+
+TEST(Core_InputOutput, FileStorage_lazy_xml) { test_lazy_read(".xml"); }
+TEST(Core_InputOutput, FileStorage_lazy_yml) { test_lazy_read(".yml"); }
+TEST(Core_InputOutput, FileStorage_lazy_json) { test_lazy_read(".json"); }
+
+TEST(Core_InputOutput, FileStorage_lazy_parse_on_access)
+{
+    const char* content[][2] = {
+        { ".yml", "%YAML:1.0\n---\na: 1\nbroken: { b: 2\n" },
+        { ".json", "{\n    \"a\": 1,\n    \"broken\": [ 1, 2, xyz ]\n}\n" },
+        { ".xml", "<?xml version=\"1.0\"?>\n<opencv_storage>\n<a>1</a>\n<broken><b>2</c></broken>\n</opencv_storage>\n" }
+    };
+    for (int i = 0; i < 3; i++)
+    {
+        SCOPED_TRACE(content[i][0]);
+        const std::string fname = cv::tempfile(content[i][0]);
+        {
+            std::ofstream f(fname.c_str());
+            f << content[i][1];
+        }
+        EXPECT_ANY_THROW(FileStorage(fname, FileStorage::READ));
+
+        FileStorage fs(fname, FileStorage::READ + FileStorage::LAZY);
+        ASSERT_TRUE(fs.isOpened());
+        EXPECT_EQ(1, (int)fs["a"]);
+        EXPECT_ANY_THROW(fs["broken"]);
+        fs.release();
+        EXPECT_EQ(0, remove(fname.c_str()));
+    }
+}
+
+TEST(Core_InputOutput, FileStorage_binary)
+{
+    const std::string fname = cv::tempfile(".bin");
+    Mat big(100, 120, CV_8UC3), m(big, Rect(3, 5, 71, 43)), m2(17, 5, CV_16SC1);
+    randu(big, Scalar::all(0), Scalar::all(255));
+    randu(m2, Scalar::all(-1000), Scalar::all(1000));
+    int sizes[] = { 3, 4, 5 };
+    Mat nd(3, sizes, CV_64FC2);
+    randu(nd, Scalar::all(-1), Scalar::all(1));
+    SparseMat sm(Mat::eye(10, 10, CV_32F) * 3);
+    std::vector<int> v(1001);
+    for (size_t i = 0; i < v.size(); i++)
+        v[i] = (int)(i * 7) - 300;
+    std::vector<Point2f> pts(3, Point2f(1.5f, -2.f));
+    {
+        FileStorage fs(fname, FileStorage::WRITE + FileStorage::FORMAT_BINARY);
+        ASSERT_TRUE(fs.isOpened());
+        fs << "scalar" << 42 << "real" << 0.25;
+        fs << "name" << "binary storage";
+        fs << "seq" << "[" << 1 << "two" << 3.5 << "]";
+        fs << "m" << m << "nd" << nd << "sm" << sm;
+        fs << "v" << v << "pts" << pts;
+        fs << "nested" << "{" << "m2" << m2 << "empty" << "[" << "]" << "}";
+        fs.writeComment("ignored");
+        fs << "last" << -1;
+    }
+    EXPECT_ANY_THROW(FileStorage(fname, FileStorage::APPEND + FileStorage::FORMAT_BINARY));
+    EXPECT_ANY_THROW(FileStorage(fname, FileStorage::WRITE + FileStorage::MEMORY + FileStorage::FORMAT_BINARY));
+
+    Mat m_result, m2_result, nd_result, sm_dense;
+    SparseMat sm_result;
+    {
+        FileStorage fs(fname, FileStorage::READ);
+        ASSERT_TRUE(fs.isOpened());
+        EXPECT_EQ(FileStorage::FORMAT_BINARY, fs.getFormat());
+        EXPECT_EQ(42, (int)fs["scalar"]);
+        EXPECT_EQ(0.25, (double)fs["real"]);
+        EXPECT_EQ("binary storage", (std::string)fs["name"]);
+        FileNode seq = fs["seq"];
+        ASSERT_EQ(3u, seq.size());
+        EXPECT_EQ(1, (int)seq[0]);
+        EXPECT_EQ("two", (std::string)seq[1]);
+        EXPECT_EQ(3.5, (double)seq[2]);
+
+        fs["m"] >> m_result;
+        EXPECT_EQ(m.type(), m_result.type());
+        EXPECT_EQ(0, cvtest::norm(m, m_result, NORM_INF));
+        fs["nd"] >> nd_result;
+        EXPECT_EQ(0, cvtest::norm(nd, nd_result, NORM_INF));
+        fs["sm"] >> sm_result;
+        sm_result.convertTo(sm_dense, CV_32F);
+        EXPECT_EQ(0, cvtest::norm(Mat::eye(10, 10, CV_32F) * 3, sm_dense, NORM_INF));
+
+        std::vector<int> v_result;
+        fs["v"] >> v_result;
+        EXPECT_EQ(v, v_result);
+        std::vector<double> vd_result; // element-wise conversion
+        fs["v"] >> vd_result;
+        ASSERT_EQ(v.size(), vd_result.size());
+        EXPECT_EQ(v.back(), (int)vd_result.back());
+        int v_part[3] = {};
+        FileNodeIterator it = fs["v"].begin();
+        it.readRaw("i", v_part, sizeof(v_part));
+        it.readRaw("i", v_part, sizeof(v_part));
+        EXPECT_EQ(v[3], v_part[0]);
+        check_seq_elements(fs["v"], v);
+        std::vector<Point2f> pts_result;
+        fs["pts"] >> pts_result;
+        EXPECT_EQ(pts, pts_result);
+        EXPECT_EQ(pts[1].y, (float)fs["pts"][3]);
+
+        FileNode nested = fs["nested"];
+        ASSERT_TRUE(nested.isMap());
+        nested["m2"] >> m2_result;
+        EXPECT_EQ(0, cvtest::norm(m2, m2_result, NORM_INF));
+        EXPECT_TRUE(nested["empty"].isSeq());
+        EXPECT_EQ(0u, nested["empty"].size());
+        EXPECT_EQ(-1, (int)fs["last"]);
+
+        // each read gives an own copy of the data by default
+        Mat m_result2;
+        fs["m"] >> m_result2;
+        EXPECT_NE(m_result.data, m_result2.data);
+        m_result2.setTo(Scalar::all(0));
+        EXPECT_EQ(0, cvtest::norm(m, m_result, NORM_INF));
+
+        // pre-allocated matrix is filled
+        Mat m2_prealloc(m2.size(), m2.type());
+        uchar* m2_data = m2_prealloc.data;
+        nested["m2"] >> m2_prealloc;
+        EXPECT_EQ(m2_data, m2_prealloc.data);
+        EXPECT_EQ(0, cvtest::norm(m2, m2_prealloc, NORM_INF));
+    }
+    {
+        // the matrix data is not copied in FileStorage::MAP_DATA mode
+        FileStorage fs(fname, FileStorage::READ + FileStorage::MAP_DATA);
+        ASSERT_TRUE(fs.isOpened());
+        Mat m_result2;
+        m_result.release();
+        nd_result.release();
+        fs["m"] >> m_result;
+        fs["m"] >> m_result2;
+        EXPECT_EQ(m_result.data, m_result2.data);
+        EXPECT_EQ(0, (int)((size_t)m_result.data % 64));
+        EXPECT_EQ(0, cvtest::norm(m, m_result, NORM_INF));
+        fs["nd"] >> nd_result;
+        EXPECT_EQ(0, cvtest::norm(nd, nd_result, NORM_INF));
+    }
+    // the mapped data stays valid after the storage is released, modifications do not affect the file
+    EXPECT_EQ(0, cvtest::norm(m, m_result, NORM_INF));
+    m_result.setTo(Scalar::all(0));
+    {
+        FileStorage fs(fname, FileStorage::READ + FileStorage::LAZY + FileStorage::MAP_DATA);
+        EXPECT_EQ(FileStorage::FORMAT_BINARY, fs.getFormat());
+        fs["m"] >> m_result;
+        EXPECT_EQ(0, cvtest::norm(m, m_result, NORM_INF));
+    }
+    m_result.release();
+    nd_result.release();
+    m2_result.release();
+    EXPECT_EQ(0, remove(fname.c_str()));
+}
+
+
 }} // namespace
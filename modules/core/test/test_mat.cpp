@@ -10,6 +10,7 @@
 #endif
 
 #include "opencv2/core/cuda.hpp"
+#include "opencv2/core/utils/mat_pool.hpp"
 
 namespace opencv_test { namespace {
 
@@ -2449,4 +2450,62 @@ TEST(Mat, reverse_iterator_19967)
 
 }
 
+TEST(Mat, pool_allocator)
+{
+    MatAllocator* pool = Mat::getPoolAllocator();
+    ASSERT_TRUE(pool != NULL);
+    cv::utils::trimMatPool();
+    cv::utils::resetMatPoolStatistics();
+
+    uchar* firstData = NULL;
+    {
+        Mat m1;
+        m1.allocator = pool;
+        m1.create(480, 640, CV_8UC3);
+        firstData = m1.data;
+        m1.setTo(Scalar::all(1));
+    }
+    cv::utils::MatPoolStatistics stats = cv::utils::getMatPoolStatistics();
+    EXPECT_EQ(0u, stats.hits);
+    EXPECT_EQ(1u, stats.misses);
+    EXPECT_EQ(1u, stats.residentBuffers);
+    EXPECT_LE((size_t)640 * 480 * 3, stats.residentBytes);
+    EXPECT_EQ(stats.residentBytes, pool->getBufferPoolController()->getReservedSize());
+
+    {
+        // same size class, reuses cached buffer
+        Mat m2;
+        m2.allocator = pool;
+        m2.create(481, 640, CV_8UC3);
+        EXPECT_EQ(firstData, m2.data);
+        EXPECT_EQ(0u, cv::utils::getMatPoolStatistics().residentBuffers);
+    }
+    stats = cv::utils::getMatPoolStatistics();
+    EXPECT_EQ(1u, stats.hits);
+    EXPECT_EQ(1u, stats.misses);
+
+    cv::utils::trimMatPool();
+    stats = cv::utils::getMatPoolStatistics();
+    EXPECT_EQ(0u, stats.residentBuffers);
+    EXPECT_EQ(0u, stats.residentBytes);
+}
+
+TEST(Mat, pool_allocator_operations)
+{
+    MatAllocator* pool = Mat::getPoolAllocator();
+    MatAllocator* prev = Mat::getDefaultAllocator();
+    Mat::setDefaultAllocator(pool);
+    Mat src(123, 321, CV_8UC3), dst, ref;
+    randu(src, 0, 255);
+    for (int i = 0; i < 10; i++)
+    {
+        Mat tmp;
+        src.convertTo(tmp, CV_32F, 1.0 / 255);
+        tmp.convertTo(dst, CV_8U, 255);
+    }
+    Mat::setDefaultAllocator(prev);
+    EXPECT_EQ(0, cvtest::norm(src, dst, NORM_INF));
+    cv::utils::trimMatPool();
+}
+
 }} // namespace
@@ -2977,6 +2977,115 @@ TEST(Core_KMeans, bad_input)
     }
 }
 
+// K well separated clusters of N/K points each
+static void generateKMeansClusters(RNG& rng, int N, int K, int dims, Mat& data, Mat& gt_labels)
+{
+    Mat centers(K, dims, CV_32F);
+    rng.fill(centers, RNG::UNIFORM, -100, 100);
+    data.create(N, dims, CV_32F);
+    gt_labels.create(N, 1, CV_32S);
+    rng.fill(data, RNG::NORMAL, 0, 1);
+    for (int i = 0; i < N; i++)
+    {
+        int k = i % K;
+        gt_labels.at<int>(i) = k;
+        data.row(i) += centers.row(k);
+    }
+}
+
+// checks that the labels split the data exactly as gt_labels
+static void checkKMeansLabels(const Mat& labels, const Mat& gt_labels, int K)
+{
+    std::vector<int> gt2label(K, -1), label2gt(K, -1);
+    for (int i = 0; i < labels.rows; i++)
+    {
+        int l = labels.at<int>(i), g = gt_labels.at<int>(i);
+        ASSERT_TRUE(l >= 0 && l < K);
+        if (gt2label[g] < 0 && label2gt[l] < 0)
+        {
+            gt2label[g] = l;
+            label2gt[l] = g;
+        }
+        ASSERT_EQ(gt2label[g], l) << "sample " << i;
+        ASSERT_EQ(label2gt[l], g) << "sample " << i;
+    }
+}
+
+TEST(Core_KMeans, parallel_centers)
+{
+    RNG& rng = theRNG();
+    const int N = 4000, K = 20, dims = 8;
+    Mat data, gt_labels, labels, centers;
+    generateKMeansClusters(rng, N, K, dims, data, gt_labels);
+    double compactness = kmeans(data, K, labels, TermCriteria(TermCriteria::COUNT + TermCriteria::EPS, 30, 0),
+                                3, KMEANS_PARALLEL_CENTERS, centers);
+    ASSERT_EQ(K, centers.rows);
+    checkKMeansLabels(labels, gt_labels, K);
+    // ~ dims per sample for the normally distributed clusters
+    EXPECT_LT(compactness, 1.2*N*dims);
+}
+
+TEST(Core_KMeans, mini_batch)
+{
+    RNG& rng = theRNG();
+    const int N = 20000, K = 10, dims = 4;
+    Mat data, gt_labels, labels, centers;
+    generateKMeansClusters(rng, N, K, dims, data, gt_labels);
+    double compactness = kmeans(data, K, labels, TermCriteria(TermCriteria::COUNT, 50, 0),
+                                3, KMEANS_PARALLEL_CENTERS | KMEANS_MINI_BATCH, centers);
+    ASSERT_EQ(K, centers.rows);
+    checkKMeansLabels(labels, gt_labels, K);
+    EXPECT_LT(compactness, 1.2*N*dims);
+
+    double expected = 0;
+    for (int i = 0; i < N; i++)
+        expected += cvtest::norm(data.row(i), centers.row(labels.at<int>(i)), NORM_L2SQR);
+    EXPECT_NEAR(expected, compactness, expected*1e-6);
+}
+
+typedef testing::TestWithParam<int> Core_KMeans_Hamming;
+
+TEST_P(Core_KMeans_Hamming, accuracy)
+{
+    RNG& rng = theRNG();
+    const int flags = GetParam();
+    const int N = 3000, K = 12, dims = 32;
+    Mat prototypes(K, dims, CV_8U), data(N, dims, CV_8U), gt_labels(N, 1, CV_32S), labels, centers;
+    rng.fill(prototypes, RNG::UNIFORM, 0, 256);
+    for (int i = 0; i < N; i++)
+    {
+        int k = i % K;
+        gt_labels.at<int>(i) = k;
+        prototypes.row(k).copyTo(data.row(i));
+        // flip a few random bits
+        for (int j = 0; j < 8; j++)
+        {
+            int bit = rng.uniform(0, dims*8);
+            data.at<uchar>(i, bit / 8) ^= (uchar)(1 << (bit % 8));
+        }
+    }
+    double compactness = kmeans(data, K, labels, TermCriteria(TermCriteria::COUNT, 30, 0), 3, flags, centers);
+    ASSERT_EQ(CV_8U, centers.type());
+    ASSERT_EQ(K, centers.rows);
+    checkKMeansLabels(labels, gt_labels, K);
+
+    double expected = 0;
+    for (int i = 0; i < N; i++)
+    {
+        int l = labels.at<int>(i);
+        expected += cvtest::norm(data.row(i), centers.row(l), NORM_HAMMING);
+        if (!(flags & KMEANS_MINI_BATCH))
+        {
+            EXPECT_EQ(0, cvtest::norm(centers.row(l), prototypes.row(gt_labels.at<int>(i)), NORM_HAMMING));
+        }
+    }
+    EXPECT_EQ(expected, compactness);
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Core_KMeans_Hamming,
+                        testing::Values((int)KMEANS_RANDOM_CENTERS, (int)KMEANS_PP_CENTERS, (int)KMEANS_PARALLEL_CENTERS,
+                                        (int)(KMEANS_PARALLEL_CENTERS | KMEANS_MINI_BATCH)));
+
 TEST(CovariationMatrixVectorOfMat, accuracy)
 {
     unsigned int col_problem_size = 8, row_problem_size = 8, vector_size = 16;
@@ -3228,6 +3337,132 @@ TEST(Core_Solve, Matx_4_4)
     EXPECT_LE(cvtest::norm(iA*A, Matx<float, 4, 4>::eye(), NORM_L2), 1e-3);
 }
 
+TEST(Core_SolveBatch, Matx33f)
+{
+    RNG& rng = theRNG();
+    const int N = 37; // not a multiple of the vector width
+    std::vector<Matx33f> A(N), X;
+    std::vector<Matx31f> b(N), x;
+    for (int i = 0; i < N; i++)
+    {
+        rng.fill(A[i], RNG::UNIFORM, -1, 1);
+        A[i] += Matx33f::eye()*3;
+        rng.fill(b[i], RNG::UNIFORM, -1, 1);
+    }
+    Mat status;
+    ASSERT_TRUE(cv::solveBatch(A, b, x, status));
+    ASSERT_TRUE(cv::invertBatch(A, X));
+    ASSERT_EQ(N, (int)x.size());
+    ASSERT_EQ(N, (int)X.size());
+    EXPECT_EQ(N, countNonZero(status));
+    for (int i = 0; i < N; i++)
+    {
+        Matx31f x0;
+        cv::solve(A[i], b[i], x0);
+        EXPECT_LE(cvtest::norm(x[i], x0, NORM_INF), 1e-5) << i;
+        EXPECT_LE(cvtest::norm(X[i], A[i].inv(), NORM_INF), 1e-5) << i;
+    }
+}
+
+TEST(Core_SolveBatch, Mat3D_64F_singular)
+{
+    RNG& rng = theRNG();
+    const int N = 11, n = 6;
+    int sz[] = { N, n, n };
+    int bsz[] = { N, n, 2 };
+    Mat A(3, sz, CV_64F), B(3, bsz, CV_64F), X, iA, status, istatus;
+    rng.fill(A, RNG::UNIFORM, -1, 1);
+    rng.fill(B, RNG::UNIFORM, -1, 1);
+    // make the 5th matrix singular
+    Mat A5(n, n, CV_64F, A.ptr(5));
+    A5.row(1).copyTo(A5.row(3));
+
+    EXPECT_FALSE(cv::solveBatch(A, B, X, status));
+    EXPECT_FALSE(cv::invertBatch(A, iA, istatus));
+    ASSERT_EQ(3, X.dims);
+    EXPECT_EQ(N, X.size[0]); EXPECT_EQ(n, X.size[1]); EXPECT_EQ(2, X.size[2]);
+    for (int i = 0; i < N; i++)
+    {
+        Mat Ai(n, n, CV_64F, A.ptr(i)), Bi(n, 2, CV_64F, B.ptr(i));
+        Mat Xi(n, 2, CV_64F, X.ptr(i)), iAi(n, n, CV_64F, iA.ptr(i)), X0, iA0;
+        bool ok = cv::solve(Ai, Bi, X0);
+        EXPECT_EQ(i != 5, ok) << i;
+        EXPECT_EQ((int)ok, (int)status.at<uchar>(i)) << i;
+        EXPECT_EQ((int)ok, (int)istatus.at<uchar>(i)) << i;
+        if (!ok)
+        {
+            EXPECT_EQ(0, countNonZero(Xi));
+            EXPECT_EQ(0, countNonZero(iAi));
+            continue;
+        }
+        cv::invert(Ai, iA0);
+        EXPECT_LE(cvtest::norm(Xi, X0, NORM_INF | NORM_RELATIVE), 1e-9) << i;
+        EXPECT_LE(cvtest::norm(iAi, iA0, NORM_INF | NORM_RELATIVE), 1e-9) << i;
+    }
+}
+
+TEST(Core_SolveBatch, MatVector_Cholesky_and_SVD)
+{
+    RNG& rng = theRNG();
+    const int N = 19, n = 4;
+    std::vector<Mat> A(N), B(N), X, Xsvd;
+    for (int i = 0; i < N; i++)
+    {
+        Mat R(n, n, CV_32F);
+        rng.fill(R, RNG::UNIFORM, -1, 1);
+        A[i] = R*R.t() + Mat::eye(n, n, CV_32F);
+        B[i].create(n, 2, CV_32F);
+        rng.fill(B[i], RNG::UNIFORM, -1, 1);
+    }
+    ASSERT_TRUE(cv::solveBatch(A, B, X, noArray(), DECOMP_CHOLESKY));
+    ASSERT_TRUE(cv::solveBatch(A, B, Xsvd, noArray(), DECOMP_SVD));
+    ASSERT_EQ(N, (int)X.size());
+    ASSERT_EQ(N, (int)Xsvd.size());
+    for (int i = 0; i < N; i++)
+    {
+        Mat X0;
+        cv::solve(A[i], B[i], X0, DECOMP_CHOLESKY);
+        EXPECT_LE(cvtest::norm(X[i], X0, NORM_INF | NORM_RELATIVE), 1e-4) << i;
+        EXPECT_LE(cvtest::norm(Xsvd[i], X0, NORM_INF | NORM_RELATIVE), 1e-4) << i;
+    }
+}
+
+TEST(Core_SVDecompBatch, accuracy)
+{
+    RNG& rng = theRNG();
+    const int N = 9;
+    std::vector<Matx33f> S(N);
+    std::vector<Matx31f> w;
+    std::vector<Matx33f> u, vt;
+    int sz[] = { N, 4, 3 };
+    Mat A(3, sz, CV_64F), wA, uA, vtA;
+    rng.fill(A, RNG::UNIFORM, -1, 1);
+    for (int i = 0; i < N; i++)
+        rng.fill(S[i], RNG::UNIFORM, -1, 1);
+
+    cv::SVDecompBatch(S, w, u, vt);
+    cv::SVDecompBatch(A, wA, uA, vtA, SVD::FULL_UV);
+    ASSERT_EQ(N, (int)w.size());
+    ASSERT_EQ(N, (int)u.size());
+    ASSERT_EQ(N, (int)vt.size());
+    ASSERT_EQ(3, uA.dims);
+    EXPECT_EQ(4, uA.size[1]); EXPECT_EQ(4, uA.size[2]);
+    EXPECT_EQ(3, vtA.size[1]); EXPECT_EQ(3, vtA.size[2]);
+    for (int i = 0; i < N; i++)
+    {
+        Mat w0, u0, vt0;
+        cv::SVDecomp(S[i], w0, u0, vt0);
+        EXPECT_LE(cvtest::norm(Mat(w[i]), w0, NORM_INF), 1e-6) << i;
+        EXPECT_LE(cvtest::norm(Mat(u[i]), u0, NORM_INF), 1e-6) << i;
+        EXPECT_LE(cvtest::norm(Mat(vt[i]), vt0, NORM_INF), 1e-6) << i;
+
+        cv::SVDecomp(Mat(4, 3, CV_64F, A.ptr(i)), w0, u0, vt0, SVD::FULL_UV);
+        EXPECT_LE(cvtest::norm(Mat(3, 1, CV_64F, wA.ptr(i)), w0, NORM_INF), 1e-12) << i;
+        EXPECT_LE(cvtest::norm(Mat(4, 4, CV_64F, uA.ptr(i)), u0, NORM_INF), 1e-12) << i;
+        EXPECT_LE(cvtest::norm(Mat(3, 3, CV_64F, vtA.ptr(i)), vt0, NORM_INF), 1e-12) << i;
+    }
+}
+
 softdouble naiveExp(softdouble x)
 {
     int exponent = x.getExp();
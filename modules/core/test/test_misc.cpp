@@ -3,6 +3,14 @@
 // of this distribution and at http://opencv.org/license.html.
 #include "test_precomp.hpp"
 #include <cmath>
+#include "opencv2/core/utils/thread_pool.hpp"
+#include "opencv2/core/utils/thread_pool.private.hpp"
+
+#if defined(CV_CXX11) && !defined(OPENCV_DISABLE_THREAD_SUPPORT)
+#include <atomic>
+#include <chrono>
+#include <thread>
+#endif
 
 namespace opencv_test { namespace {
 
@@ -243,6 +251,201 @@ TEST(Core_Parallel, propagate_exceptions)
     }, cv::Exception);
 }
 
+// Switches the built-in thread pool to the work-stealing mode with a few workers even on single-core machines
+class ThreadPoolWorkStealingScope
+{
+public:
+    ThreadPoolWorkStealingScope() : prevMode(cv::utils::getThreadPoolWorkStealing()), prevThreads(cv::getNumThreads())
+    {
+        const char* framework = cv::currentParallelFramework();
+        if (!framework || std::string(framework) != "pthreads" || !cv::utils::setThreadPoolWorkStealing(true))
+            throw SkipTestException("Built-in thread pool is not available");
+        cv::setNumThreads(std::max(prevThreads, 4));
+    }
+    ~ThreadPoolWorkStealingScope()
+    {
+        cv::utils::setThreadPoolWorkStealing(prevMode);
+        cv::setNumThreads(prevThreads);
+    }
+private:
+    bool prevMode;
+    int prevThreads;
+};
+
+#if defined(CV_CXX11) && !defined(OPENCV_DISABLE_THREAD_SUPPORT)
+static void testConcurrentCallers()
+{
+    const int ncallers = 4;
+    std::vector<int> errors(ncallers, 0);
+    std::vector<std::thread> callers;
+    for (int t = 0; t < ncallers; t++)
+    {
+        callers.push_back(std::thread([t, &errors]() {
+            for (int iter = 0; iter < 20; iter++)
+            {
+                Mat dst(1000 + t, 100, CV_8SC1, Scalar::all(0));
+                parallel_for_(cv::Range(0, dst.rows), ThrowErrorParallelLoopBody(dst, -1));
+                if (countNonZero(dst) != (int)dst.total())
+                    errors[t]++;
+            }
+        }));
+    }
+    for (size_t t = 0; t < callers.size(); t++)
+        callers[t].join();
+    for (int t = 0; t < ncallers; t++)
+        EXPECT_EQ(0, errors[t]) << "caller=" << t;
+}
+
+TEST(Core_Parallel, concurrent_callers)
+{
+    testConcurrentCallers();
+}
+
+TEST(Core_Parallel, concurrent_callers_work_stealing)
+{
+    ThreadPoolWorkStealingScope scope;
+    ASSERT_TRUE(cv::utils::getThreadPoolWorkStealing());
+    testConcurrentCallers();
+}
+#endif
+
+TEST(Core_Parallel, thread_pool_statistics)
+{
+    cv::utils::resetThreadPoolStatistics();
+    Mat dst(1000, 100, CV_8SC1, Scalar::all(0));
+    parallel_for_(cv::Range(0, dst.rows), ThrowErrorParallelLoopBody(dst, -1));
+    EXPECT_EQ((int)dst.total(), countNonZero(dst));
+
+    std::vector<cv::utils::ThreadPoolWorkerStatistics> stats;
+    if (!cv::utils::getThreadPoolStatistics(stats))
+        throw SkipTestException("Built-in thread pool is not available");
+    for (size_t i = 0; i < stats.size(); i++)
+    {
+        EXPECT_EQ((int)i, stats[i].workerId);
+        EXPECT_LE(stats[i].stolenJobs, stats[i].executedJobs);
+        EXPECT_LE(stats[i].executedTasks, (uint64_t)dst.rows);
+        EXPECT_GE(stats[i].busyTime, 0.0);
+        EXPECT_GE(stats[i].idleTime, 0.0);
+    }
+}
+
+#if defined(CV_CXX11) && !defined(OPENCV_DISABLE_THREAD_SUPPORT)
+// Waits for the condition, but not longer than 2 seconds, so the test fails instead of hanging
+template<typename Cond> static bool waitFor(Cond cond)
+{
+    for (int i = 0; i < 2000 && !cond(); i++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    return cond();
+}
+
+// Stripes of the job are blocked until the job is released
+class BlockingParallelLoopBody : public cv::ParallelLoopBody
+{
+public:
+    BlockingParallelLoopBody(std::atomic<int>& entered, std::atomic<bool>& released) : entered_(entered), released_(released) {}
+    void operator()(const cv::Range& r) const
+    {
+        entered_ += r.size();
+        waitFor([this]() { return released_.load(); });
+    }
+protected:
+    std::atomic<int>& entered_;
+    std::atomic<bool>& released_;
+};
+
+TEST(Core_Parallel, thread_pool_statistics_work_stealing)
+{
+    ThreadPoolWorkStealingScope scope;
+    cv::setNumThreads(4);  // 3 workers: the tickets of the 2-stripe jobs below go to every worker in turn
+    testConcurrentCallers();
+    cv::utils::resetThreadPoolStatistics();
+
+    // one worker is blocked by a job of another caller thread
+    std::atomic<int> blockedStripes(0);
+    std::atomic<bool> unblock(false);
+    std::thread blocker([&blockedStripes, &unblock]() {
+        parallel_for_(cv::Range(0, 2), BlockingParallelLoopBody(blockedStripes, unblock));
+    });
+    ASSERT_TRUE(waitFor([&blockedStripes]() { return blockedStripes == 2; }));
+
+    // When the ticket of a 2-stripe job is queued to the blocked worker, the first stripe waits
+    // for the second one, which is taken by the worker woken by the next job: it steals the ticket.
+    std::vector<cv::utils::ThreadPoolWorkerStatistics> stats;
+    uint64_t stolenJobs = 0;
+    for (int attempt = 0; attempt < 6 && stolenJobs == 0; attempt++)
+    {
+        std::atomic<int> waiting(0);
+        std::atomic<bool> done(false);
+        std::thread caller([&waiting, &done]() {
+            parallel_for_(cv::Range(0, 2), BlockingParallelLoopBody(waiting, done));
+        });
+        waitFor([&waiting]() { return waiting > 0; });
+        Mat dst(2, 100, CV_8SC1, Scalar::all(0));
+        parallel_for_(cv::Range(0, dst.rows), ThrowErrorParallelLoopBody(dst, -1));
+        EXPECT_EQ((int)dst.total(), countNonZero(dst));
+        waitFor([&waiting]() { return waiting == 2; });
+        done = true;
+        caller.join();
+
+        ASSERT_TRUE(cv::utils::getThreadPoolStatistics(stats));
+        stolenJobs = 0;
+        for (size_t i = 0; i < stats.size(); i++)
+            stolenJobs += stats[i].stolenJobs;
+    }
+    unblock = true;
+    blocker.join();
+
+    ASSERT_TRUE(cv::utils::getThreadPoolStatistics(stats));
+    ASSERT_EQ(3u, stats.size());
+    uint64_t executedJobs = 0;
+    double idleTime = 0;
+    stolenJobs = 0;
+    for (size_t i = 0; i < stats.size(); i++)
+    {
+        EXPECT_LE(stats[i].stolenJobs, stats[i].executedJobs);
+        EXPECT_GE(stats[i].busyTime, 0.0);
+        executedJobs += stats[i].executedJobs;
+        stolenJobs += stats[i].stolenJobs;
+        idleTime += stats[i].idleTime;
+    }
+    EXPECT_GT(executedJobs, 0u);
+    EXPECT_GT(stolenJobs, 0u);
+    EXPECT_GT(idleTime, 0.0);
+}
+#endif
+
+TEST(Core_Parallel, thread_pool_affinity)
+{
+    const cv::utils::ThreadPoolAffinity prev = cv::utils::getThreadPoolAffinity();
+    const cv::utils::ThreadPoolAffinity modes[] = {
+        cv::utils::THREAD_POOL_AFFINITY_CORES, cv::utils::THREAD_POOL_AFFINITY_NUMA, cv::utils::THREAD_POOL_AFFINITY_NONE
+    };
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++)
+    {
+        SCOPED_TRACE(cv::format("mode=%d", (int)modes[m]));
+        if (!cv::utils::setThreadPoolAffinity(modes[m]))
+            continue;
+        EXPECT_EQ(modes[m], cv::utils::getThreadPoolAffinity());
+        Mat dst(1000, 100, CV_8SC1, Scalar::all(0));
+        parallel_for_(cv::Range(0, dst.rows), ThrowErrorParallelLoopBody(dst, -1));
+        EXPECT_EQ((int)dst.total(), countNonZero(dst));
+    }
+    cv::utils::setThreadPoolAffinity(prev);
+}
+
+TEST(Core_Parallel, first_touch)
+{
+    std::vector<uchar> buf(5 * 4096 + 123, (uchar)1);
+    for (size_t ofs = 0; ofs < 3; ofs++)
+    {
+        cv::utils::parallelFirstTouch(&buf[ofs], buf.size() - ofs);
+    }
+    EXPECT_EQ(0, buf[0]);
+    EXPECT_EQ(0, buf[1]);
+    EXPECT_GE(std::count(buf.begin(), buf.end(), (uchar)0), 6);
+    EXPECT_GE(std::count(buf.begin(), buf.end(), (uchar)1), (int)buf.size() - 3 * 7);
+}
+
 TEST(Core_Version, consistency)
 {
     // this test verifies that OpenCV version loaded in runtime
@@ -1561,4 +1561,97 @@ TEST(Core_Arithm, scalar_handling_19599)  // https://github.com/opencv/opencv/is
     EXPECT_EQ(1, c.rows);
 }
 
+typedef testing::TestWithParam<perf::MatType> Core_MatExpr_Fused;
+
+TEST_P(Core_MatExpr_Fused, chain)
+{
+    const int type = GetParam(), depth = CV_MAT_DEPTH(type);
+    const double eps = depth <= CV_32S ? 0 : depth == CV_32F ? 1e-5 : 1e-12;
+    RNG& rng = theRNG();
+    Mat a(17, 113, type), b(17, 113, type), c(17, 113, type), d(17, 113, type);
+    rng.fill(a, RNG::UNIFORM, 0, 100);
+    rng.fill(b, RNG::UNIFORM, 0, 100);
+    rng.fill(c, RNG::UNIFORM, 0, 50);
+    rng.fill(d, RNG::UNIFORM, 1, 4);
+
+    MatExpr e = (a*0.5 + b*0.25 - c).mul(d);
+    // the operands are not evaluated into temporary matrices
+    EXPECT_TRUE(e.a.empty() && e.b.empty());
+    Mat res = e, t1, t2, ref;
+    cv::addWeighted(a, 0.5, b, 0.25, 0, t1);
+    cv::subtract(t1, c, t2);
+    cv::multiply(t2, d, ref);
+    EXPECT_LE(cvtest::norm(ref, res, NORM_INF | NORM_RELATIVE), eps);
+
+    // per-channel scalars, division and absolute value
+    Scalar s(1, -2, 3, -4);
+    res = (a.mul(b, 0.5) + s) / (abs(c) + 1);
+    cv::multiply(a, b, t1, 0.5);
+    cv::add(t1, s, t1);
+    cv::absdiff(c, Scalar(), t2);
+    cv::add(t2, Scalar(1), t2);
+    cv::divide(t1, t2, ref);
+    EXPECT_LE(cvtest::norm(ref, res, NORM_INF | NORM_RELATIVE), eps);
+
+    // sub-matrix of the fused expression
+    Rect roi(5, 3, 50, 7);
+    res = (a + b.mul(c))(roi);
+    cv::multiply(b, c, t1);
+    cv::add(a, t1, ref);
+    EXPECT_EQ(0, cvtest::norm(ref(roi), res, NORM_INF));
+
+    // the result overwrites one of the operands
+    Mat a0 = a.clone();
+    a = (a - b.mul(c)) * 0.5;
+    cv::multiply(b, c, t1);
+    cv::subtract(a0, t1, t2);
+    t2.convertTo(ref, -1, 0.5);
+    EXPECT_LE(cvtest::norm(ref, a, NORM_INF | NORM_RELATIVE), eps);
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Core_MatExpr_Fused,
+    testing::Values(CV_8UC1, CV_8UC3, CV_16SC1, CV_16UC4, CV_32SC1, CV_32FC1, CV_32FC3, CV_64FC1));
+
+TEST(Core_MatExpr, fused_compare_and_conversion)
+{
+    RNG& rng = theRNG();
+    Mat a(31, 47, CV_8UC1), b(31, 47, CV_8UC1);
+    rng.fill(a, RNG::UNIFORM, 0, 256);
+    rng.fill(b, RNG::UNIFORM, 0, 256);
+
+    // comparison results are combined with the saturation of 8-bit values
+    Mat res = (a > 100) + (b <= 50), t1, t2, ref;
+    cv::compare(a, 100, t1, CMP_GT);
+    cv::compare(b, 50, t2, CMP_LE);
+    cv::add(t1, t2, ref);
+    EXPECT_EQ(0, cvtest::norm(ref, res, NORM_INF));
+
+    // conversion of the result to another type
+    Mat_<float> resf = a.mul(b, 1./16) + 3;
+    cv::multiply(a, b, t1, 1./16);
+    cv::add(t1, Scalar(3), t2);
+    t2.convertTo(ref, CV_32F);
+    EXPECT_EQ(0, cvtest::norm(ref, resf, NORM_INF));
+
+    // the last operation is computed directly in the type of the allocated destination
+    resf = a.mul(b, 1./16) + 3;
+    t1.convertTo(ref, CV_32F, 1, 3);
+    EXPECT_EQ(0, cvtest::norm(ref, resf, NORM_INF));
+
+    // chains longer than MatExprGraph can hold are split
+    Mat x(31, 47, CV_32FC1), y(31, 47, CV_32FC1);
+    rng.fill(x, RNG::UNIFORM, 0.5, 1);
+    rng.fill(y, RNG::UNIFORM, 0.5, 1);
+    MatExpr e = x.mul(y);
+    ref = x.mul(y);
+    for (int i = 0; i < 40; i++)
+    {
+        e = e.mul(y) + x*0.1;
+        cv::multiply(ref, y, t1);
+        cv::scaleAdd(x, 0.1, t1, ref);
+    }
+    res = e;
+    EXPECT_LE(cvtest::norm(ref, res, NORM_INF | NORM_RELATIVE), 1e-5);
+}
+
 }} // namespace
@@ -501,5 +501,65 @@ TEST_P(BufferArea, bad)
 
 INSTANTIATE_TEST_CASE_P(/**/, BufferArea, testing::Values(true, false));
 
+static void traceStatisticsTestRegion(size_t bytes)
+{
+    CV_TRACE_REGION("traceStatisticsTestRegion");
+    CV_TRACE_BYTES(bytes);
+}
+
+static const cv::utils::trace::TraceRegionStatistics* findTraceRegion(const std::vector<cv::utils::trace::TraceRegionStatistics>& stats, const std::string& name)
+{
+    for (size_t i = 0; i < stats.size(); i++)
+    {
+        if (stats[i].name.find(name) != std::string::npos)
+            return &stats[i];
+    }
+    return NULL;
+}
+
+TEST(Trace, statistics)
+{
+    const bool prev = cv::utils::trace::isStatisticsEnabled();
+    cv::utils::trace::setStatisticsEnabled(true);
+    if (!cv::utils::trace::isStatisticsEnabled())
+        throw SkipTestException("Trace support is not available");
+    cv::utils::trace::resetStatistics();
+
+    for (int i = 0; i < 10; i++)
+        traceStatisticsTestRegion(100);
+    Mat src(100, 100, CV_8UC1, Scalar::all(1)), dst;
+    src.convertTo(dst, CV_32F);
+
+    std::vector<cv::utils::trace::TraceRegionStatistics> stats;
+    cv::utils::trace::getStatistics(stats);
+
+    const cv::utils::trace::TraceRegionStatistics* r = findTraceRegion(stats, "traceStatisticsTestRegion");
+    ASSERT_TRUE(r != NULL);
+    EXPECT_EQ(10u, r->calls);
+    EXPECT_EQ(1000u, r->bytes);
+    EXPECT_GE(r->maxTime, 0.0);
+    EXPECT_LE(r->maxTime, r->totalTime);
+
+    r = findTraceRegion(stats, "Mat::convertTo");
+    ASSERT_TRUE(r != NULL);
+    EXPECT_EQ(1u, r->calls);
+    EXPECT_EQ((uint64)(100 * 100 * (1 + 4)), r->bytes);
+
+    const std::string filename = cv::tempfile(".json");
+    EXPECT_TRUE(cv::utils::trace::writeChromeTrace(filename));
+    std::ifstream f(filename.c_str());
+    std::string content((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+    f.close();
+    remove(filename.c_str());
+    EXPECT_NE(std::string::npos, content.find("\"traceEvents\""));
+    EXPECT_NE(std::string::npos, content.find("traceStatisticsTestRegion"));
+
+    cv::utils::trace::resetStatistics();
+    cv::utils::trace::getStatistics(stats);
+    EXPECT_TRUE(findTraceRegion(stats, "traceStatisticsTestRegion") == NULL);
+
+    cv::utils::trace::setStatisticsEnabled(prev);
+}
+
 
 }} // namespace
@@ -94,7 +94,8 @@ CV__DNN_INLINE_NS_BEGIN
         DNN_TARGET_FPGA,  //!< FPGA device with CPU fallbacks using Inference Engine's Heterogeneous plugin.
         DNN_TARGET_CUDA,
         DNN_TARGET_CUDA_FP16,
-        DNN_TARGET_HDDL
+        DNN_TARGET_HDDL,
+        DNN_TARGET_CPU_FP16  //!< CPU with the weights of convolution and fully connected layers stored in half precision.
     };
 
     CV_EXPORTS std::vector< std::pair<Backend, Target> > getAvailableBackends();
@@ -585,6 +586,16 @@ CV__DNN_INLINE_NS_BEGIN
          */
         CV_WRAP Net quantize(InputArrayOfArrays calibData, int inputsDtype, int outputsDtype);
 
+        /** @brief Returns a new Net with the same layers and settings, which shares the weights with this one.
+         *  @details The new network has its own layers, inputs and intermediate blobs, so it can run forward()
+         *  concurrently with this network in another thread (a single Net must not be used by several threads
+         *  at once). The weight blobs are not copied. The weights prepared by the layers for computations
+         *  (e.g. the repacked convolution weights fused with the following batch normalization) are kept
+         *  once for all the networks which prepare them equally, i.e. with the same input shapes and settings.
+         *  Changes of the weights by setParam() are not propagated to the other networks.
+         */
+        CV_WRAP Net cloneWithSharedWeights() const;
+
         /** @brief Returns input scale and zeropoint for a quantized Net.
          *  @param scales output parameter for returning input scales.
          *  @param zeropoints output parameter for returning input zeropoints.
@@ -634,6 +645,7 @@ CV__DNN_INLINE_NS_BEGIN
          * | DNN_TARGET_CUDA        |                    |                              |                    |                 + |
          * | DNN_TARGET_CUDA_FP16   |                    |                              |                    |                 + |
          * | DNN_TARGET_HDDL        |                    |                            + |                    |                   |
+         * | DNN_TARGET_CPU_FP16    |                  + |                              |                    |                   |
          */
         CV_WRAP void setPreferableTarget(int targetId);
 
@@ -778,11 +790,49 @@ CV__DNN_INLINE_NS_BEGIN
                                           CV_OUT std::vector<size_t>& weights,
                                           CV_OUT std::vector<size_t>& blobs) const; // FIXIT: CV_WRAP
 
+        /** @brief Computes the static memory plan of the intermediate blobs.
+         * @param netInputShapes vector of shapes for all net inputs.
+         * @param peakBlobs output parameter to store the size in bytes of the single buffer which holds
+         * all the intermediate blobs (the net inputs are not included).
+         * @param layerIds output vector to save the layer ID of every planned blob.
+         * @param blobIds output vector to save the index of every planned blob in its layer:
+         * the outputs go first, then the internal buffers.
+         * @param offsets output vector to save the offsets of the planned blobs in the buffer, in bytes.
+         * @param sizes output vector to save the sizes of the planned blobs, in bytes.
+         * @details The blobs are placed according to their lifetimes, so the ones which are never used
+         * at the same time share memory. The outputs of the layers computed in-place take no memory
+         * and are not listed. The same plan is used by forward() unless the memory optimizations are
+         * disabled by the OPENCV_DNN_DISABLE_MEMORY_OPTIMIZATIONS environment variable.
+         */
+        void getMemoryConsumption(const std::vector<MatShape>& netInputShapes,
+                                  CV_OUT size_t& peakBlobs,
+                                  CV_OUT std::vector<int>& layerIds,
+                                  CV_OUT std::vector<int>& blobIds,
+                                  CV_OUT std::vector<size_t>& offsets,
+                                  CV_OUT std::vector<size_t>& sizes) const; // FIXIT: CV_WRAP
+
         /** @brief Enables or disables layer fusion in the network.
          * @param fusion true to enable the fusion, false to disable. The fusion is enabled by default.
          */
         CV_WRAP void enableFusion(bool fusion);
 
+        /** @brief Enables or disables the Winograd compute branch of 3x3 convolutions on CPU.
+         * @param useWinograd true to enable the Winograd compute branch. The default is true.
+         * @details Winograd F(4x4, 3x3) needs about 2.25x fewer multiplications than the direct convolution
+         * at the cost of slightly different rounding of the results.
+         */
+        CV_WRAP void enableWinograd(bool useWinograd);
+
+        /** @brief Sets the number of the input shapes the network keeps allocated.
+         * @param size maximal number of the sets of input shapes (including the current one). The default is 1.
+         * @details Normally a change of the input shapes (e.g. of the batch size) makes the network
+         * allocate its intermediate blobs and set up the layers again. With the size greater than 1
+         * the network keeps the state for the last used shapes, so switching back to them requires
+         * no setup. Every kept state owns its intermediate blobs while the weights are shared.
+         * Only the DNN_BACKEND_OPENCV backend with the DNN_TARGET_CPU target is supported.
+         */
+        CV_WRAP void setShapeCacheSize(int size);
+
         /** @brief Returns overall time for inference and timings (in ticks) for layers.
          *
          * Indexes in returned vector correspond to layers ids. Some layers can be fused with others,
@@ -1071,6 +1121,84 @@ CV__DNN_INLINE_NS_BEGIN
                                    const Scalar& mean = Scalar(), bool swapRB=false, bool crop=false,
                                    int ddepth=CV_32F);
 
+    /**
+     * @brief Enum of data layout for model inference.
+     * @see Image2BlobParams
+     */
+    enum DataLayout
+    {
+        DNN_LAYOUT_NCHW = 0, //!< OpenCV data layout for 2D data, batch x channels x height x width.
+        DNN_LAYOUT_NHWC = 1, //!< Tensorflow-like data layout for 2D data, batch x height x width x channels.
+    };
+
+    /**
+     * @brief Enum of image processing mode.
+     * @see Image2BlobParams
+     */
+    enum ImagePaddingMode
+    {
+        DNN_PMODE_NULL = 0,        //!< Default. Resize to required input size without extra processing.
+        DNN_PMODE_CROP_CENTER = 1, //!< Resize keeping the aspect ratio so that the image covers the required size, then crop the center.
+    };
+
+    /** @brief Processing params of image to blob.
+     *
+     * It includes all possible image processing operations and corresponding parameters.
+     * blobFromImageWithParams() applies all of them in a single pass over the images: the resized pixels are
+     * normalized, converted and written to the blob directly, without intermediate images.
+     *
+     * @note
+     * The output values are computed as (input - mean) * scalefactor, so per-channel mean/std normalization
+     * is done with @p mean equal to the channel means and @p scalefactor equal to 1/std.
+     * Both are given in the order of the output channels (i.e. after the swap when @p swapRB is true).
+     */
+    struct CV_EXPORTS_W_SIMPLE Image2BlobParams
+    {
+        CV_WRAP Image2BlobParams();
+        CV_WRAP Image2BlobParams(const Scalar& scalefactor, const Size& size = Size(), const Scalar& mean = Scalar(),
+                                 bool swapRB = false, int ddepth = CV_32F, DataLayout datalayout = DNN_LAYOUT_NCHW,
+                                 ImagePaddingMode mode = DNN_PMODE_NULL);
+
+        CV_PROP_RW Scalar scalefactor;           //!< scalefactor multiplier for input image values.
+        CV_PROP_RW Size size;                    //!< Spatial size for output image.
+        CV_PROP_RW Scalar mean;                  //!< Scalar with mean values which are subtracted from channels.
+        CV_PROP_RW bool swapRB;                  //!< Flag which indicates that swap first and last channels
+        CV_PROP_RW int ddepth;                   //!< Depth of output blob. Choose CV_32F or CV_8U.
+        CV_PROP_RW DataLayout datalayout;        //!< Order of output dimensions. Choose DNN_LAYOUT_NCHW or DNN_LAYOUT_NHWC.
+        CV_PROP_RW ImagePaddingMode paddingmode; //!< Image padding mode. @see ImagePaddingMode.
+    };
+
+    /** @brief Creates 4-dimensional blob from image with given params.
+     *
+     *  @details This function is an extension of @ref blobFromImage to meet more image preprocess needs.
+     *  Given input image and preprocessing parameters, the function resizes the image (bilinear interpolation),
+     *  swaps the channels, subtracts the mean, scales and converts the values and writes them to the blob
+     *  of the requested layout in one pass, in parallel.
+     *
+     *  @param image input image (all with 1-, 3- or 4-channels, CV_8U or CV_32F).
+     *  @param param struct of Image2BlobParams, contains all parameters needed by processing of image to blob.
+     *  @return 4-dimensional Mat.
+     */
+    CV_EXPORTS_W Mat blobFromImageWithParams(InputArray image, const Image2BlobParams& param = Image2BlobParams());
+
+    /** @overload */
+    CV_EXPORTS_W void blobFromImageWithParams(InputArray image, OutputArray blob, const Image2BlobParams& param = Image2BlobParams());
+
+    /** @brief Creates 4-dimensional blob from series of images with given params.
+     *
+     *  @details This function is an extension of @ref blobFromImages to meet more image preprocess needs.
+     *  The images are processed by the same single pass as in blobFromImageWithParams(), the batch is split
+     *  into row stripes of all the images, which are processed in parallel.
+     *
+     *  @param images input image (all with 1-, 3- or 4-channels, CV_8U or CV_32F).
+     *  @param param struct of Image2BlobParams, contains all parameters needed by processing of image to blob.
+     *  @returns 4-dimensional Mat.
+     */
+    CV_EXPORTS_W Mat blobFromImagesWithParams(InputArrayOfArrays images, const Image2BlobParams& param = Image2BlobParams());
+
+    /** @overload */
+    CV_EXPORTS_W void blobFromImagesWithParams(InputArrayOfArrays images, OutputArray blob, const Image2BlobParams& param = Image2BlobParams());
+
     /** @brief Parse a 4D blob and output the images it contains as 2D arrays through a simpler data structure
      *  (std::vector<cv::Mat>).
      *  @param[in] blob_ 4 dimensional array (images, channels, height, width) in floating point precision (CV_32F) from
@@ -891,4 +891,56 @@ INSTANTIATE_TEST_CASE_P(/**/, Conv, Combine(
     dnnBackendsAndTargets(false, false)  // defined in ../test/test_common.hpp
 ));
 
+// 3x3 convolutions with unit strides computed by Winograd F(4x4, 3x3) and by the direct (im2row-based) path
+typedef TestBaseWithParam<tuple<Vec4i, int, bool> > Conv_Winograd;
+
+PERF_TEST_P_(Conv_Winograd, conv3x3)
+{
+    Vec4i inpShape = get<0>(GetParam());
+    int outChannels = get<1>(GetParam());
+    bool useWinograd = get<2>(GetParam());
+
+    int sz[] = {outChannels, inpShape[1], 3, 3};
+    Mat weights(4, &sz[0], CV_32F), bias(1, outChannels, CV_32F);
+    randu(weights, -1.0f, 1.0f);
+    randu(bias, -1.0f, 1.0f);
+
+    LayerParams lp;
+    lp.set("kernel_size", 3);
+    lp.set("pad", 1);
+    lp.set("num_output", outChannels);
+    lp.set("bias_term", true);
+    lp.type = "Convolution";
+    lp.name = "testLayer";
+    lp.blobs.push_back(weights);
+    lp.blobs.push_back(bias);
+
+    Mat input(4, &inpShape[0], CV_32F);
+    randu(input, -1.0f, 1.0f);
+
+    Net net;
+    net.addLayerToPrev(lp.name, lp.type, lp);
+    net.setInput(input);
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+    net.setPreferableTarget(DNN_TARGET_CPU);
+    net.enableWinograd(useWinograd);
+
+    // warmup
+    Mat output = net.forward();
+
+    TEST_CYCLE()
+    {
+        Mat res = net.forward();
+    }
+
+    SANITY_CHECK_NOTHING();
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Conv_Winograd, Combine(
+    Values(Vec4i(1, 64, 112, 112), Vec4i(1, 128, 56, 56), Vec4i(1, 256, 28, 28), Vec4i(1, 512, 14, 14),
+           Vec4i(4, 256, 14, 14), Vec4i(1, 16, 150, 150)),
+    Values(64, 256),
+    testing::Bool()
+));
+
 } // namespace
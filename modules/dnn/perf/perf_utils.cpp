@@ -0,0 +1,70 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "perf_precomp.hpp"
+#include <opencv2/imgproc.hpp>
+
+namespace opencv_test {
+
+typedef TestBaseWithParam<tuple<Size, int> > Utils_blobFromImages;
+
+PERF_TEST_P_(Utils_blobFromImages, fused)
+{
+    Size srcSize = get<0>(GetParam());
+    int batch = get<1>(GetParam());
+    std::vector<Mat> images(batch);
+    for (int i = 0; i < batch; i++)
+    {
+        images[i].create(srcSize, CV_8UC3);
+        randu(images[i], 0, 256);
+    }
+    Image2BlobParams param(Scalar(1/58.4, 1/57.1, 1/57.4), Size(224, 224), Scalar(123.7, 116.3, 103.5), true);
+    Mat blob;
+
+    TEST_CYCLE() blobFromImagesWithParams(images, blob, param);
+
+    SANITY_CHECK_NOTHING();
+}
+
+// the same preprocessing done by separate full frame passes
+PERF_TEST_P_(Utils_blobFromImages, separate_passes)
+{
+    Size srcSize = get<0>(GetParam());
+    int batch = get<1>(GetParam());
+    std::vector<Mat> images(batch);
+    for (int i = 0; i < batch; i++)
+    {
+        images[i].create(srcSize, CV_8UC3);
+        randu(images[i], 0, 256);
+    }
+    const Scalar mean(123.7, 116.3, 103.5), stddev(58.4, 57.1, 57.4);
+    int sz[] = { batch, 3, 224, 224 };
+    Mat blob(4, sz, CV_32F);
+
+    TEST_CYCLE()
+    {
+        for (int i = 0; i < batch; i++)
+        {
+            Mat resized, rgb, f;
+            resize(images[i], resized, Size(224, 224));
+            cvtColor(resized, rgb, COLOR_BGR2RGB);
+            rgb.convertTo(f, CV_32F);
+            cv::subtract(f, mean, f);
+            cv::divide(f, stddev, f);
+            std::vector<Mat> planes;
+            for (int c = 0; c < 3; c++)
+                planes.push_back(Mat(224, 224, CV_32F, blob.ptr<float>(i, c)));
+            split(f, planes);
+        }
+    }
+
+    SANITY_CHECK_NOTHING();
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Utils_blobFromImages, Combine(
+    Values(Size(640, 480), Size(1920, 1080)),
+    Values(1, 8)
+));
+
+} // namespace
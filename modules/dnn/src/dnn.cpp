@@ -54,6 +54,7 @@
 #include "halide_scheduler.hpp"
 
 #include <set>
+#include <list>
 #include <algorithm>
 #include <iostream>
 #include <sstream>
@@ -233,6 +234,7 @@ private:
 #endif
 
         backends.push_back(std::make_pair(DNN_BACKEND_OPENCV, DNN_TARGET_CPU));
+        backends.push_back(std::make_pair(DNN_BACKEND_OPENCV, DNN_TARGET_CPU_FP16));
 
 #ifdef HAVE_VULKAN
         if (haveVulkan())
@@ -294,147 +296,6 @@ namespace
     };
 }
 
-Mat blobFromImage(InputArray image, double scalefactor, const Size& size,
-                  const Scalar& mean, bool swapRB, bool crop, int ddepth)
-{
-    CV_TRACE_FUNCTION();
-    Mat blob;
-    blobFromImage(image, blob, scalefactor, size, mean, swapRB, crop, ddepth);
-    return blob;
-}
-
-void blobFromImage(InputArray image, OutputArray blob, double scalefactor,
-                   const Size& size, const Scalar& mean, bool swapRB, bool crop, int ddepth)
-{
-    CV_TRACE_FUNCTION();
-    std::vector<Mat> images(1, image.getMat());
-    blobFromImages(images, blob, scalefactor, size, mean, swapRB, crop, ddepth);
-}
-
-Mat blobFromImages(InputArrayOfArrays images, double scalefactor, Size size,
-                   const Scalar& mean, bool swapRB, bool crop, int ddepth)
-{
-    CV_TRACE_FUNCTION();
-    Mat blob;
-    blobFromImages(images, blob, scalefactor, size, mean, swapRB, crop, ddepth);
-    return blob;
-}
-
-void blobFromImages(InputArrayOfArrays images_, OutputArray blob_, double scalefactor,
-                    Size size, const Scalar& mean_, bool swapRB, bool crop, int ddepth)
-{
-    CV_TRACE_FUNCTION();
-    CV_CheckType(ddepth, ddepth == CV_32F || ddepth == CV_8U, "Blob depth should be CV_32F or CV_8U");
-    if (ddepth == CV_8U)
-    {
-        CV_CheckEQ(scalefactor, 1.0, "Scaling is not supported for CV_8U blob depth");
-        CV_Assert(mean_ == Scalar() && "Mean subtraction is not supported for CV_8U blob depth");
-    }
-
-    std::vector<Mat> images;
-    images_.getMatVector(images);
-    CV_Assert(!images.empty());
-    for (size_t i = 0; i < images.size(); i++)
-    {
-        Size imgSize = images[i].size();
-        if (size == Size())
-            size = imgSize;
-        if (size != imgSize)
-        {
-            if(crop)
-            {
-              float resizeFactor = std::max(size.width / (float)imgSize.width,
-                                            size.height / (float)imgSize.height);
-              resize(images[i], images[i], Size(), resizeFactor, resizeFactor, INTER_LINEAR);
-              Rect crop(Point(0.5 * (images[i].cols - size.width),
-                              0.5 * (images[i].rows - size.height)),
-                        size);
-              images[i] = images[i](crop);
-            }
-            else
-              resize(images[i], images[i], size, 0, 0, INTER_LINEAR);
-        }
-        if(images[i].depth() == CV_8U && ddepth == CV_32F)
-            images[i].convertTo(images[i], CV_32F);
-        Scalar mean = mean_;
-        if (swapRB)
-            std::swap(mean[0], mean[2]);
-
-        images[i] -= mean;
-        images[i] *= scalefactor;
-    }
-
-    size_t nimages = images.size();
-    Mat image0 = images[0];
-    int nch = image0.channels();
-    CV_Assert(image0.dims == 2);
-    if (nch == 3 || nch == 4)
-    {
-        int sz[] = { (int)nimages, nch, image0.rows, image0.cols };
-        blob_.create(4, sz, ddepth);
-        Mat blob = blob_.getMat();
-        Mat ch[4];
-
-        for(size_t i = 0; i < nimages; i++ )
-        {
-            const Mat& image = images[i];
-            CV_Assert(image.depth() == blob_.depth());
-            nch = image.channels();
-            CV_Assert(image.dims == 2 && (nch == 3 || nch == 4));
-            CV_Assert(image.size() == image0.size());
-
-            for( int j = 0; j < nch; j++ )
-                ch[j] = Mat(image.rows, image.cols, ddepth, blob.ptr((int)i, j));
-            if(swapRB)
-                std::swap(ch[0], ch[2]);
-            split(image, ch);
-        }
-    }
-    else
-    {
-       CV_Assert(nch == 1);
-       int sz[] = { (int)nimages, 1, image0.rows, image0.cols };
-       blob_.create(4, sz, ddepth);
-       Mat blob = blob_.getMat();
-
-       for(size_t i = 0; i < nimages; i++ )
-       {
-           const Mat& image = images[i];
-           CV_Assert(image.depth() == blob_.depth());
-           nch = image.channels();
-           CV_Assert(image.dims == 2 && (nch == 1));
-           CV_Assert(image.size() == image0.size());
-
-           image.copyTo(Mat(image.rows, image.cols, ddepth, blob.ptr((int)i, 0)));
-       }
-    }
-}
-
-void imagesFromBlob(const cv::Mat& blob_, OutputArrayOfArrays images_)
-{
-    CV_TRACE_FUNCTION();
-
-    //A blob is a 4 dimensional matrix in floating point precision
-    //blob_[0] = batchSize = nbOfImages
-    //blob_[1] = nbOfChannels
-    //blob_[2] = height
-    //blob_[3] = width
-    CV_Assert(blob_.depth() == CV_32F);
-    CV_Assert(blob_.dims == 4);
-
-    images_.create(cv::Size(1, blob_.size[0]), blob_.depth());
-
-    std::vector<Mat> vectorOfChannels(blob_.size[1]);
-    for (int n = 0; n <  blob_.size[0]; ++n)
-    {
-        for (int c = 0; c < blob_.size[1]; ++c)
-        {
-            vectorOfChannels[c] = getPlane(blob_, n, c);
-        }
-        cv::merge(vectorOfChannels, images_.getMatRef(n));
-    }
-}
-
 #ifdef HAVE_OPENCL
 class OpenCLBackendWrapper : public BackendWrapper
 {
@@ -919,6 +780,14 @@ public:
         CV_Assert(refIt != refCounter.end());
         CV_Assert(refIt->second > 0);
         refIt->second -= 1;
+
+        // while planning, the memory of the blob becomes free after the current layer
+        if (refIt->second == 0 && planStep >= 0)
+        {
+            std::map<LayerPin, int>::iterator blockIt = blockIds.find(refIt->first);
+            if (blockIt != blockIds.end())
+                blocks[blockIt->second].end = planStep;
+        }
     }
 
     void releaseReferences(const std::vector<LayerPin>& pins)
@@ -931,49 +800,157 @@ public:
 
     void reuseOrCreate(const MatShape& shape, const LayerPin& lp, Mat& dst, const int& dtype)
     {
-        if (!DNN_DISABLE_MEMORY_OPTIMIZATIONS)
+        std::map<LayerPin, int>::const_iterator blockIt = blockIds.find(lp);
+        if (blockIt != blockIds.end())
+        {
+            const Block& block = blocks[blockIt->second];
+            CV_Assert(total(shape)*CV_ELEM_SIZE(dtype) <= block.size);
+            // the header shares the reference counter of the arena, like the submatrices do,
+            // so the blobs returned to the user stay valid after reallocation
+            dst = Mat(shape, dtype, arena.ptr() + block.offset);
+            dst.u = arena.u;
+            dst.addref();
+            dst.datastart = arena.datastart;
+            dst.datalimit = arena.datalimit;
+        }
+        else
         {
-            Mat bestBlob;
-            LayerPin bestBlobPin;
+            // if dst already has been allocated with total(shape) elements,
+            // it won't be recreated and pointer of dst.data remains the same.
+            dst.create(shape, dtype);
+        }
+        addHost(lp);
+    }
+
+    // Memory planning. planBlobsForLayer() is called for every layer in the allocation order
+    // and makes the same in-place decisions as allocateBlobsForLayer(), but only records the size
+    // and the lifetime (in steps of the allocation order) of every blob that needs memory.
+    // packBlocks() then places the blobs into a single arena, so the blobs that are never alive
+    // at the same time share memory. The network inputs are not planned.
+    void planBlobsForLayer(const LayerData& ld, const LayerShapes& layerShapes, int dtype)
+    {
+        CV_TRACE_FUNCTION();
 
-            std::map<LayerPin, Mat>::iterator hostIt;
-            std::map<LayerPin, int>::iterator refIt;
+        const ShapesVec& outShapes = layerShapes.out,
+                internalShapes = layerShapes.internal;
+        const size_t numOutputs = std::max((size_t)1, outShapes.size());
+        planStep++;
+
+        std::vector<LayerPin> pinsForInternalBlobs;
+        for (size_t i = 0; i < internalShapes.size(); i++)
+        {
+            if (total(internalShapes[i]))
+                pinsForInternalBlobs.push_back(LayerPin(ld.id, numOutputs + i));
+        }
+        addReferences(pinsForInternalBlobs);
 
-            const int targetTotal = total(shape);
-            int bestBlobTotal = INT_MAX;
+        bool inPlace = layerShapes.supportInPlace && ld.inputBlobsId.size() == 1 &&
+                       numReferences(ld.inputBlobsId[0]) == 1;
 
-            for (hostIt = memHosts.begin(); hostIt != memHosts.end(); ++hostIt)
+        ShapesVec shapes(outShapes);
+        shapes.insert(shapes.end(), internalShapes.begin(), internalShapes.end());
+        for (size_t i = 0; i < shapes.size(); i++)
+        {
+            if (!total(shapes[i]))
+                continue;
+            LayerPin blobPin(ld.id, i);
+            if (i < outShapes.size() && inPlace)
+                reuse(ld.inputBlobsId[0], blobPin);
+            else
             {
-                refIt = refCounter.find(hostIt->first);
-                // Use only blobs that had references before because if not,
-                // it might be used as output.
-                if (refIt != refCounter.end() && refIt->second == 0)
+                if (ld.id != 0)
                 {
-                    Mat& unusedBlob = hostIt->second;
-                    if (unusedBlob.total() >= targetTotal &&
-                        unusedBlob.total() < bestBlobTotal &&
-                        unusedBlob.type() == dtype)
-                    {
-                        bestBlobPin = hostIt->first;
-                        bestBlob = unusedBlob;
-                        bestBlobTotal = unusedBlob.total();
-                    }
+                    Block block;
+                    block.pin = blobPin;
+                    block.size = alignSize(total(shapes[i])*CV_ELEM_SIZE(dtype), BLOCK_ALIGN);
+                    block.start = planStep;
+                    block.end = INT_MAX;
+                    block.offset = 0;
+                    blockIds[blobPin] = (int)blocks.size();
+                    blocks.push_back(block);
                 }
+                addHost(blobPin);
             }
-            if (!bestBlob.empty())
+        }
+
+        releaseReferences(ld.inputBlobsId);
+        releaseReferences(pinsForInternalBlobs);
+    }
+
+    // Greedy-by-size packing: the blocks are placed from the largest one, each into the smallest gap
+    // between the already placed blocks with overlapping lifetimes, or after the last of them.
+    // Clears the reference counters for the following allocation pass.
+    void packBlocks()
+    {
+        CV_TRACE_FUNCTION();
+
+        std::vector<int> order(blocks.size());
+        for (size_t i = 0; i < order.size(); i++)
+            order[i] = (int)i;
+        std::sort(order.begin(), order.end(), BlockGreater(blocks));
+
+        arenaSize = 0;
+        std::vector<int> placed;
+        std::vector<std::pair<size_t, size_t> > busy;
+        for (size_t i = 0; i < order.size(); i++)
+        {
+            Block& block = blocks[order[i]];
+            busy.clear();
+            for (size_t j = 0; j < placed.size(); j++)
             {
-                reuse(bestBlobPin, lp);
-                dst = bestBlob.reshape(1, 1).colRange(0, targetTotal).reshape(1, shape);
-                return;
+                const Block& other = blocks[placed[j]];
+                if (other.start <= block.end && block.start <= other.end)
+                    busy.push_back(std::make_pair(other.offset, other.offset + other.size));
             }
+            std::sort(busy.begin(), busy.end());
+
+            size_t offset = 0, bestOffset = 0, bestGap = std::numeric_limits<size_t>::max();
+            bool found = false;
+            for (size_t j = 0; j < busy.size(); j++)
+            {
+                if (busy[j].first >= offset + block.size && busy[j].first - offset < bestGap)
+                {
+                    bestOffset = offset;
+                    bestGap = busy[j].first - offset;
+                    found = true;
+                }
+                offset = std::max(offset, busy[j].second);
+            }
+            block.offset = found ? bestOffset : offset;
+            arenaSize = std::max(arenaSize, block.offset + block.size);
+            placed.push_back(order[i]);
         }
 
+        planStep = -1;
+        refCounter.clear();
+        reuseMap.clear();
+    }
+
+    // Allocates the memory for the planned blobs.
+    void allocateArena()
+    {
+        // the rows limit the arena size by INT_MAX*ARENA_ROW bytes instead of INT_MAX
+        enum { ARENA_ROW = 1 << 12 };
+        if (arenaSize > 0)
+            arena.create((int)divUp(arenaSize, (size_t)ARENA_ROW), ARENA_ROW, CV_8U);
+        else
+            arena.release();
+    }
+
+    // Returns the peak memory of the planned blobs and the blobs placement.
+    size_t getPlan(std::vector<LayerPin>* pins = 0, std::vector<size_t>* offsets = 0,
+                   std::vector<size_t>* sizes = 0) const
+    {
+        for (size_t i = 0; i < blocks.size(); i++)
         {
-            // if dst already has been allocated with total(shape) elements,
-            // it won't be recreated and pointer of dst.data remains the same.
-            dst.create(shape, dtype);
-            addHost(lp, dst);
+            if (pins)
+                pins->push_back(blocks[i].pin);
+            if (offsets)
+                offsets->push_back(blocks[i].offset);
+            if (sizes)
+                sizes->push_back(blocks[i].size);
         }
+        return arenaSize;
     }
 
     void allocateBlobsForLayer(LayerData &ld, const LayerShapes& layerShapes,
@@ -1055,36 +1032,151 @@ public:
     }
 
     // Clear internal state. Calls before an every reallocation.
+    // The arena is kept, so its memory is reused if the new plan has the same size.
     void reset()
     {
         CV_TRACE_FUNCTION();
 
         refCounter.clear();
         reuseMap.clear();
-        memHosts.clear();
+        blocks.clear();
+        blockIds.clear();
+        arenaSize = 0;
+        planStep = -1;
     }
 
 private:
+    // the planned blobs start at the cache line boundaries
+    enum { BLOCK_ALIGN = 64 };
+
+    struct Block
+    {
+        LayerPin pin;
+        size_t size;
+        // the steps of the allocation order when the blob is created and released
+        int start, end;
+        size_t offset;
+    };
+
+    struct BlockGreater
+    {
+        BlockGreater(const std::vector<Block>& blocks_) : blocks(blocks_) {}
+        bool operator()(int a, int b) const
+        {
+            return blocks[a].size > blocks[b].size ||
+                   (blocks[a].size == blocks[b].size && blocks[a].start < blocks[b].start);
+        }
+        const std::vector<Block>& blocks;
+    };
+
     // Register allocated memory.
-    void addHost(const LayerPin& lp, const Mat& mat)
+    void addHost(const LayerPin& lp)
     {
-        CV_Assert(memHosts.find(lp) == memHosts.end());
+        CV_Assert(reuseMap.find(lp) == reuseMap.end());
         reuseMap[lp] = lp;
-        memHosts[lp] = mat;
     }
 
     std::map<LayerPin, int> refCounter;
     // Maps pin to origin blob (for whom memory was allocated firstly).
     // For origin blobs key == value.
     std::map<LayerPin, LayerPin> reuseMap;
-    std::map<LayerPin, Mat> memHosts;
+
+    std::vector<Block> blocks;
+    std::map<LayerPin, int> blockIds;
+    Mat arena;
+    size_t arenaSize = 0;
+    // the current step of planning, -1 outside of it
+    int planStep = -1;
+};
+
+// The prepared weights of the layers (see detail::PreparedWeightsLayer), which are shared
+// by a network and its clones created with Net::cloneWithSharedWeights(), by layer names.
+// A layer may have several versions of the prepared weights at once, e.g. when the networks
+// use different targets or fusion settings, so a layer takes the stored version equal to its
+// weights if there is any, otherwise its weights are stored as a new version. The versions
+// which are not used by any layer anymore (the store keeps the only reference to them)
+// are dropped when the weights of the layer are prepared again.
+struct SharedWeights
+{
+    static bool equal(const Mat& a, const Mat& b)
+    {
+        if (a.type() != b.type() || a.size != b.size)
+            return false;
+        if (a.empty() || (a.data == b.data && a.step == b.step))
+            return true;
+        if (a.isContinuous() && b.isContinuous())
+            return memcmp(a.data, b.data, a.total()*a.elemSize()) == 0;
+        CV_Assert(a.dims == 2);
+        for (int i = 0; i < a.rows; i++)
+        {
+            if (memcmp(a.ptr(i), b.ptr(i), a.cols*a.elemSize()) != 0)
+                return false;
+        }
+        return true;
+    }
+
+    static bool equal(const std::vector<Mat>& a, const std::vector<Mat>& b)
+    {
+        if (a.size() != b.size())
+            return false;
+        for (size_t i = 0; i < a.size(); i++)
+        {
+            if (!equal(a[i], b[i]))
+                return false;
+        }
+        return true;
+    }
+
+    static bool isUsed(const std::vector<Mat>& weights)
+    {
+        for (size_t i = 0; i < weights.size(); i++)
+        {
+            if (weights[i].u && weights[i].u->refcount > 1)
+                return true;
+        }
+        return false;
+    }
+
+    void share(const String& name, detail::PreparedWeightsLayer& layer)
+    {
+        std::vector<Mat> weights;
+        layer.getPreparedWeights(weights);
+
+        AutoLock lock(mutex);
+        std::vector<std::vector<Mat> >& versions = layers[name];
+        for (size_t i = 0; i < versions.size(); )
+        {
+            // only share() adds the references to the stored weights, so they can't appear concurrently
+            if (!isUsed(versions[i]))
+                versions.erase(versions.begin() + i);
+            else
+                i++;
+        }
+        if (!weights.empty())
+        {
+            for (size_t i = 0; i < versions.size(); i++)
+            {
+                if (equal(versions[i], weights))
+                {
+                    layer.setPreparedWeights(versions[i]);
+                    return;
+                }
+            }
+            versions.push_back(weights);
+        }
+        if (versions.empty())
+            layers.erase(name);
+    }
+
+    Mutex mutex;
+    std::map<String, std::vector<std::vector<Mat> > > layers;
 };
 
 static Ptr<BackendWrapper> wrapMat(int backendId, int targetId, cv::Mat& m)
 {
     if (backendId == DNN_BACKEND_OPENCV)
     {
-        if (targetId == DNN_TARGET_CPU)
+        if (IS_DNN_CPU_TARGET(targetId))
             return Ptr<BackendWrapper>();
 #ifdef HAVE_OPENCL
         else if (IS_DNN_OPENCL_TARGET(targetId))
@@ -1180,11 +1272,13 @@ struct Net::Impl : public detail::NetImplBase
         netWasAllocated = false;
         netWasQuantized = false;
         fusion = true;
+        useWinograd = true;
         isAsync = false;
         preferableBackend = DNN_BACKEND_DEFAULT;
         preferableTarget = DNN_TARGET_CPU;
         skipInfEngineInit = false;
         hasDynamicShapes = false;
+        shapeCacheSize = 1;
     }
 
     Ptr<DataLayer> netInputLayer;
@@ -1205,8 +1299,21 @@ struct Net::Impl : public detail::NetImplBase
     bool netWasAllocated;
     bool netWasQuantized;
     bool fusion;
+    bool useWinograd;
     bool isAsync;
     std::vector<int64> layersTimings;
+    Ptr<SharedWeights> sharedWeights;
+
+    // Allocated state of the network prepared for the specific input shapes
+    struct Plan
+    {
+        ShapesVec shapes;
+        std::vector<LayerPin> blobsToKeep;
+        MapIdToLayerData layers;
+    };
+    std::list<Plan> plans;  // the most recently used ones go first
+    ShapesVec planShapes;  // input shapes the current state is allocated for
+    int shapeCacheSize;
     Mat output_blob;
 
 #ifdef HAVE_CUDA
@@ -1224,7 +1331,7 @@ struct Net::Impl : public detail::NetImplBase
 
     Ptr<BackendWrapper> wrap(Mat& host)
     {
-        if (preferableBackend == DNN_BACKEND_OPENCV && preferableTarget == DNN_TARGET_CPU)
+        if (preferableBackend == DNN_BACKEND_OPENCV && IS_DNN_CPU_TARGET(preferableTarget))
             return Ptr<BackendWrapper>();
 
         MatShape shape(host.dims);
@@ -1342,6 +1449,13 @@ struct Net::Impl : public detail::NetImplBase
     {
         CV_TRACE_FUNCTION();
 
+        plans.clear();
+        planShapes.clear();
+        clearLayers();
+    }
+
+    void clearLayers()
+    {
         MapIdToLayerData::iterator it;
         for (it = layers.begin(); it != layers.end(); it++)
         {
@@ -1380,7 +1494,7 @@ struct Net::Impl : public detail::NetImplBase
 #endif
 
         CV_Assert(preferableBackend != DNN_BACKEND_OPENCV ||
-                  preferableTarget == DNN_TARGET_CPU ||
+                  IS_DNN_CPU_TARGET(preferableTarget) ||
                   preferableTarget == DNN_TARGET_OPENCL ||
                   preferableTarget == DNN_TARGET_OPENCL_FP16);
         CV_Assert(preferableBackend != DNN_BACKEND_HALIDE ||
@@ -1450,11 +1564,15 @@ struct Net::Impl : public detail::NetImplBase
                 preferableTarget = DNN_TARGET_CPU;
             }
 
-            clear();
+            if (!netWasAllocated && switchPlan(blobsToKeep_))
+                return;
+
+            clearLayers();
 
             this->blobsToKeep = blobsToKeep_;
 
             allocateLayers(blobsToKeep_);
+            sharePreparedWeights();
 
             MapIdToLayerData::iterator it = layers.find(0);
             CV_Assert(it != layers.end());
@@ -1473,6 +1591,9 @@ struct Net::Impl : public detail::NetImplBase
             }
 
             netWasAllocated = true;
+            planShapes.clear();
+            for (size_t i = 0; i < layers[0].outputBlobs.size(); i++)
+                planShapes.push_back(shape(layers[0].outputBlobs[i]));
 
             if (dumpLevel)
             {
@@ -1481,6 +1602,103 @@ struct Net::Impl : public detail::NetImplBase
         }
     }
 
+    // Stores the state allocated for the previous input shapes of the network and switches
+    // to the one for the current shapes. It is either taken from the cache (returns true if
+    // it is ready to use) or made of new layer instances which refer to the same weights.
+    bool switchPlan(const std::vector<LayerPin>& blobsToKeep_)
+    {
+        CV_TRACE_FUNCTION();
+
+        if (shapeCacheSize <= 1 || planShapes.empty() ||
+            preferableBackend != DNN_BACKEND_OPENCV || !IS_DNN_CPU_TARGET(preferableTarget))
+            return false;
+
+        ShapesVec inputShapes;
+        for (size_t i = 0; i < layers[0].outputBlobs.size(); i++)
+            inputShapes.push_back(shape(layers[0].outputBlobs[i]));
+        if (inputShapes == planShapes)
+            return false;
+
+        if (!sharedWeights)
+        {
+            sharedWeights = makePtr<SharedWeights>();
+            sharePreparedWeights();
+        }
+
+        plans.push_front(Plan());
+        Plan& prev = plans.front();
+        prev.shapes = planShapes;
+        prev.blobsToKeep = blobsToKeep;
+        prev.layers.swap(layers);
+        planShapes.clear();
+        const LayerData& prevInput = prev.layers[0];
+
+        bool ready = false;
+        std::list<Plan>::iterator it = plans.begin();
+        for (++it; it != plans.end() && it->shapes != inputShapes; ++it) {}
+        if (it != plans.end())
+        {
+            // the pointers to the blobs stay valid as the nodes of the map are not moved
+            layers.swap(it->layers);
+            blobsToKeep = it->blobsToKeep;
+            plans.erase(it);
+
+            LayerData& inp = layers[0];
+            CV_Assert(inp.outputBlobs.size() == prevInput.outputBlobs.size());
+            for (size_t i = 0; i < inp.outputBlobs.size(); i++)
+                inp.outputBlobs[i] = prevInput.outputBlobs[i];
+            netInputLayer->finalize(std::vector<Mat>(), inp.outputBlobs);
+            inp.skip = netInputLayer->skip;
+
+            planShapes = inputShapes;
+            ready = blobsToKeep == blobsToKeep_;
+        }
+        else
+        {
+            for (MapIdToLayerData::const_iterator lit = prev.layers.begin(); lit != prev.layers.end(); ++lit)
+            {
+                const LayerData& src = lit->second;
+                if (src.id == 0)
+                {
+                    layers.insert(*lit);
+                    continue;
+                }
+                LayerParams params = src.params;
+                if (src.layerInstance)
+                    params.blobs = src.layerInstance->blobs;
+                LayerData& dst = layers.insert(std::make_pair(src.id, LayerData(src.id, src.name, src.type, src.dtype, params))).first->second;
+                dst.inputBlobsId = src.inputBlobsId;
+                dst.inputLayersId = src.inputLayersId;
+                dst.requiredOutputs = src.requiredOutputs;
+                dst.consumers = src.consumers;
+            }
+        }
+        // the shapes of the layers of the stored state were updated to the current inputs by setInput()
+        if (hasDynamicShapes)
+            updateLayersShapes();
+
+        while (plans.size() >= (size_t)shapeCacheSize)
+            plans.pop_back();
+        netWasAllocated = ready;
+        return ready;
+    }
+
+    // Converts the prepared weights of the layers to the precision of the target and replaces
+    // them with the equal ones of the networks sharing weights with this one.
+    void sharePreparedWeights()
+    {
+        int depth = preferableBackend == DNN_BACKEND_OPENCV && preferableTarget == DNN_TARGET_CPU_FP16 ? CV_16F : CV_32F;
+        for (MapIdToLayerData::iterator it = layers.begin(); it != layers.end(); ++it)
+        {
+            Ptr<detail::PreparedWeightsLayer> layer = it->second.layerInstance.dynamicCast<detail::PreparedWeightsLayer>();
+            if (!layer)
+                continue;
+            layer->convertPreparedWeights(depth);
+            if (sharedWeights)
+                sharedWeights->share(it->second.name, *layer);
+        }
+    }
+
     int getLayerId(const String &layerName)
     {
         std::map<String, int>::iterator it = layerNameToId.find(layerName);
@@ -1604,7 +1822,7 @@ struct Net::Impl : public detail::NetImplBase
         CV_TRACE_FUNCTION();
         if (preferableBackend == DNN_BACKEND_OPENCV)
         {
-            CV_Assert(preferableTarget == DNN_TARGET_CPU || IS_DNN_OPENCL_TARGET(preferableTarget));
+            CV_Assert(IS_DNN_CPU_TARGET(preferableTarget) || IS_DNN_OPENCL_TARGET(preferableTarget));
         }
         else if (preferableBackend == DNN_BACKEND_HALIDE)
             initHalideBackend();
@@ -2549,6 +2767,9 @@ struct Net::Impl : public detail::NetImplBase
             {
                 inps[i] = *ld.inputBlobs[i];
             }
+            Ptr<detail::WinogradLayer> winoLayer = layerPtr.dynamicCast<detail::WinogradLayer>();
+            if (!winoLayer.empty())
+                winoLayer->setUseWinograd(useWinograd);
             layerPtr->finalize(inps, ld.outputBlobs);
             layerPtr->preferableTarget = preferableTarget;
 #if 0
@@ -3133,6 +3354,65 @@ struct Net::Impl : public detail::NetImplBase
         }
     }
 
+    void addBlobReferences(BlobManager& manager, int numInputs, const std::vector<LayerPin>& blobsToKeep_)
+    {
+        // Fake references to input blobs.
+        for (int i = 0; i < numInputs; ++i)
+            manager.addReference(LayerPin(0, i));
+        for (MapIdToLayerData::iterator it = layers.begin(); it != layers.end(); ++it)
+        {
+            const LayerData& ld = it->second;
+            manager.addReferences(ld.inputBlobsId);
+        }
+
+        for (int i = 0; i < blobsToKeep_.size(); i++)
+        {
+            manager.addReference(blobsToKeep_[i]);
+        }
+    }
+
+    // The order of allocateLayer() calls: the parent layers go before their consumers
+    void getAllocationOrder(int lid, std::set<int>& visited, std::vector<int>& order)
+    {
+        if (!visited.insert(lid).second)
+            return;
+        const LayerData& ld = layers[lid];
+        std::set<int> parents;
+        for (size_t i = 0; i < ld.inputBlobsId.size(); i++)
+            parents.insert(ld.inputBlobsId[i].lid);
+        for (std::set<int>::iterator i = parents.begin(); i != parents.end(); i++)
+            getAllocationOrder(*i, visited, order);
+        order.push_back(lid);
+    }
+
+    // Plans the memory of the intermediate blobs, see BlobManager::planBlobsForLayer()
+    void planMemory(BlobManager& manager, const LayersShapesMap& layersShapes,
+                    const std::vector<LayerPin>& blobsToKeep_)
+    {
+        CV_TRACE_FUNCTION();
+
+        LayersShapesMap::const_iterator inputShapesIt = layersShapes.find(0);
+        CV_Assert(inputShapesIt != layersShapes.end());
+        addBlobReferences(manager, (int)inputShapesIt->second.out.size(), blobsToKeep_);
+
+        std::set<int> visited;
+        std::vector<int> order;
+        for (MapIdToLayerData::iterator it = layers.begin(); it != layers.end(); it++)
+            getAllocationOrder(it->first, visited, order);
+
+        for (size_t i = 0; i < order.size(); i++)
+        {
+            const LayerData& ld = layers[order[i]];
+            LayersShapesMap::const_iterator layerShapesIt = layersShapes.find(ld.id);
+            CV_Assert(layerShapesIt != layersShapes.end());
+            int dtype = ld.dtype;
+            if (preferableBackend == DNN_BACKEND_OPENCV && preferableTarget == DNN_TARGET_OPENCL_FP16 && dtype == CV_32F)
+                dtype = CV_16S;
+            manager.planBlobsForLayer(ld, layerShapesIt->second, dtype);
+        }
+        manager.packBlocks();
+    }
+
     void allocateLayers(const std::vector<LayerPin>& blobsToKeep_)
     {
         CV_TRACE_FUNCTION();
@@ -3159,6 +3439,11 @@ struct Net::Impl : public detail::NetImplBase
         getLayersShapes(inputShapes, layersShapes);
 
         blobManager.reset();
+        if (!DNN_DISABLE_MEMORY_OPTIMIZATIONS)
+        {
+            planMemory(blobManager, layersShapes, blobsToKeep_);
+            blobManager.allocateArena();
+        }
         backendWrappers.clear();
 
         for(auto& layer : layers)
@@ -3169,19 +3454,7 @@ struct Net::Impl : public detail::NetImplBase
             ld.internalBlobsWrappers.clear();
         }
 
-        // Fake references to input blobs.
-        for (int i = 0; i < layers[0].outputBlobs.size(); ++i)
-            blobManager.addReference(LayerPin(0, i));
-        for (it = layers.begin(); it != layers.end(); ++it)
-        {
-            const LayerData& ld = it->second;
-            blobManager.addReferences(ld.inputBlobsId);
-        }
-
-        for (int i = 0; i < blobsToKeep_.size(); i++)
-        {
-            blobManager.addReference(blobsToKeep_[i]);
-        }
+        addBlobReferences(blobManager, (int)layers[0].outputBlobs.size(), blobsToKeep_);
 
         for (it = layers.begin(); it != layers.end(); it++)
         {
@@ -3659,7 +3932,7 @@ struct Net::Impl : public detail::NetImplBase
                                            "the #%d was requested", ld.name.c_str(),
                                            ld.outputBlobs.size(), pin.oid));
         }
-        if (preferableTarget != DNN_TARGET_CPU)
+        if (!IS_DNN_CPU_TARGET(preferableTarget))
         {
             CV_Assert(!ld.outputBlobsWrappers.empty() && !ld.outputBlobsWrappers[pin.oid].empty());
             // Transfer data to CPU if it's require.
@@ -3695,7 +3968,7 @@ struct Net::Impl : public detail::NetImplBase
                                            "the #%d was requested", ld.name.c_str(),
                                            (int)ld.outputBlobs.size(), (int)pin.oid));
         }
-        if (preferableTarget != DNN_TARGET_CPU)
+        if (!IS_DNN_CPU_TARGET(preferableTarget))
         {
             CV_Assert(!ld.outputBlobsWrappers.empty() && !ld.outputBlobsWrappers[pin.oid].empty());
             // Transfer data to CPU if it's require.
@@ -4102,6 +4375,58 @@ void Net::connect(int outLayerId, int outNum, int inpLayerId, int inpNum)
     impl->connect(outLayerId, outNum, inpLayerId, inpNum);
 }
 
+Net Net::cloneWithSharedWeights() const
+{
+    CV_TRACE_FUNCTION();
+
+    if (!impl->sharedWeights)
+    {
+        impl->sharedWeights = makePtr<SharedWeights>();
+        if (impl->netWasAllocated)
+            impl->sharePreparedWeights();
+    }
+
+    Net dstNet;
+    Impl& dst = *dstNet.impl;
+    dst.sharedWeights = impl->sharedWeights;
+    dst.netWasQuantized = impl->netWasQuantized;
+    dst.hasDynamicShapes = impl->hasDynamicShapes;
+    dst.halideConfigFile = impl->halideConfigFile;
+    dst.skipInfEngineInit = impl->skipInfEngineInit;
+    dstNet.setInputsNames(impl->netInputLayer->outNames);
+    dst.netInputLayer->shapes = impl->netInputLayer->shapes;
+    dst.layers[0].dtype = impl->layers[0].dtype;
+    dst.layers[0].params = impl->layers[0].params;
+    dstNet.setPreferableBackend(impl->preferableBackend);
+    dstNet.setPreferableTarget(impl->preferableTarget);
+    dstNet.enableFusion(impl->fusion);
+    dstNet.enableWinograd(impl->useWinograd);
+    dst.shapeCacheSize = impl->shapeCacheSize;
+
+    // the layers are created from the same parameters and the current weights of the instances
+    // (Net::setParam() replaces only them), so they refer to the same weight blobs
+    std::map<int, int> layerIds;
+    layerIds[0] = 0;
+    for (Impl::MapIdToLayerData::const_iterator it = impl->layers.begin(); it != impl->layers.end(); ++it)
+    {
+        const LayerData& ld = it->second;
+        if (ld.id == 0)
+            continue;
+        LayerParams params = ld.params;
+        if (ld.layerInstance)
+            params.blobs = ld.layerInstance->blobs;
+        int newLid = dstNet.addLayer(ld.name, ld.type, ld.dtype, params);
+        layerIds[ld.id] = newLid;
+        for (size_t i = 0; i < ld.inputBlobsId.size(); i++)
+        {
+            const LayerPin& pin = ld.inputBlobsId[i];
+            CV_Assert(layerIds.count(pin.lid));
+            dstNet.connect(layerIds[pin.lid], pin.oid, newLid, (int)i);
+        }
+    }
+    return dstNet;
+}
+
 void Net::connect(String _outPin, String _inPin)
 {
     CV_TRACE_FUNCTION();
@@ -4197,7 +4522,7 @@ void Net::forward(OutputArrayOfArrays outputBlobs, const String& outputName)
     }
     else if (outputBlobs.isMatVector())
     {
-        if (impl->preferableTarget != DNN_TARGET_CPU)
+        if (!IS_DNN_CPU_TARGET(impl->preferableTarget))
         {
             for (int i = 0; i < ld.outputBlobsWrappers.size(); ++i)
             {
@@ -4719,6 +5044,8 @@ void Net::setParam(LayerId layer, int numParam, const Mat &blob)
     CV_Assert(numParam < (int)layerBlobs.size());
     //we don't make strong checks, use this function carefully
     layerBlobs[numParam] = blob;
+    // the stored states refer to the previous weights
+    impl->plans.clear();
 }
 
 int Net::getLayerId(const String &layer)
@@ -4968,6 +5295,7 @@ string Net::Impl::dump()
             case DNN_TARGET_FPGA: out << "FPGA"; colorId = 4; break;
             case DNN_TARGET_CUDA: out << "CUDA"; colorId = 5; break;
             case DNN_TARGET_CUDA_FP16: out << "CUDA_FP16"; colorId = 6; break;
+            case DNN_TARGET_CPU_FP16: out << "CPU_FP16"; colorId = layerBackend.empty() ? 0 : 5; break;
             // don't use default:
         }
         CV_Assert(colorId < colors.size());
@@ -5327,6 +5655,31 @@ void Net::getMemoryConsumption(const MatShape& netInputShape, std::vector<int>&
                          weights, blobs);
 }
 
+void Net::getMemoryConsumption(const std::vector<MatShape>& netInputShapes,
+                               size_t& peakBlobs, std::vector<int>& layerIds, std::vector<int>& blobIds,
+                               std::vector<size_t>& offsets, std::vector<size_t>& sizes) const
+{
+    CV_TRACE_FUNCTION();
+
+    layerIds.clear();
+    blobIds.clear();
+    offsets.clear();
+    sizes.clear();
+
+    Impl::LayersShapesMap layersShapes;
+    impl->getLayersShapes(netInputShapes, layersShapes);
+
+    BlobManager planner;
+    impl->planMemory(planner, layersShapes, std::vector<LayerPin>());
+    std::vector<LayerPin> pins;
+    peakBlobs = planner.getPlan(&pins, &offsets, &sizes);
+    for (size_t i = 0; i < pins.size(); i++)
+    {
+        layerIds.push_back(pins[i].lid);
+        blobIds.push_back(pins[i].oid);
+    }
+}
+
 void Net::enableFusion(bool fusion)
 {
     if( impl->fusion != fusion )
@@ -5336,6 +5689,23 @@ void Net::enableFusion(bool fusion)
     }
 }
 
+void Net::enableWinograd(bool useWinograd)
+{
+    if( impl->useWinograd != useWinograd )
+    {
+        impl->useWinograd = useWinograd;
+        impl->clear();
+    }
+}
+
+void Net::setShapeCacheSize(int size)
+{
+    CV_CheckGE(size, 1, "");
+    impl->shapeCacheSize = size;
+    while (impl->plans.size() >= (size_t)size)
+        impl->plans.pop_back();
+}
+
 void Net::setHalideScheduler(const String& scheduler)
 {
     CV_TRACE_FUNCTION();
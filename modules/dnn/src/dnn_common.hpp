@@ -13,6 +13,7 @@
 namespace cv { namespace dnn {
 CV__DNN_INLINE_NS_BEGIN
 #define IS_DNN_OPENCL_TARGET(id) (id == DNN_TARGET_OPENCL || id == DNN_TARGET_OPENCL_FP16)
+#define IS_DNN_CPU_TARGET(id) (id == DNN_TARGET_CPU || id == DNN_TARGET_CPU_FP16)
 Mutex& getInitializationMutex();
 void initializeLayerFactory();
 
@@ -68,6 +69,31 @@ private:
     std::unordered_map<std::string, std::unordered_set<std::string>> layers;
 };
 
+// Interface of the layers which prepare their weights for computations (repack them, fuse
+// the following layers into them etc). The networks created by Net::cloneWithSharedWeights()
+// keep a single copy of the equal prepared weights, so after the setup of the layer
+// they must be neither modified in-place nor reused as an output of Mat::create().
+class PreparedWeightsLayer
+{
+public:
+    virtual ~PreparedWeightsLayer() {}
+    virtual void getPreparedWeights(std::vector<Mat>& weights) const = 0;
+    // replaces the prepared weights with the equal ones of the same layer of another network
+    virtual void setPreparedWeights(const std::vector<Mat>& weights) = 0;
+    // converts the final (i.e. fused) prepared weights to the depth the target computes with:
+    // CV_16F for DNN_TARGET_CPU_FP16 and CV_32F otherwise
+    virtual void convertPreparedWeights(int depth) = 0;
+};
+
+// The convolution layers which can compute 3x3 kernels with the Winograd algorithm.
+// The network passes its Net::enableWinograd() setting before the layer is finalized.
+class WinogradLayer
+{
+public:
+    virtual ~WinogradLayer() {}
+    virtual void setUseWinograd(bool useWinograd) = 0;
+};
+
 struct NetImplBase
 {
     const int networkId;  // network global identifier
@@ -0,0 +1,506 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+
+#include <opencv2/core/hal/intrin.hpp>
+#include <opencv2/dnn/shape_utils.hpp>
+
+#include <type_traits>
+
+/*
+Image to blob conversion.
+
+blobFromImageWithParams() resizes, swaps the channels, normalizes and converts the images and
+writes them to the blob in a single pass: every output row is interpolated from (at most) two
+horizontally resized source rows, which are kept in small per-thread buffers, and the result is
+stored into the channel planes (NCHW) or the interleaved rows (NHWC) of the blob directly.
+
+The interpolation uses the coordinates and the weights of cv::resize with INTER_LINEAR, so the
+result matches resize() for floating-point images. For 8-bit images the interpolation is done in
+floating point, while resize() rounds the 8-bit result, so the values may differ by one quantization
+step (before the scaling).
+*/
+
+namespace cv {
+namespace dnn {
+CV__DNN_INLINE_NS_BEGIN
+
+Image2BlobParams::Image2BlobParams()
+    : scalefactor(Scalar::all(1.0)), size(Size()), mean(Scalar()), swapRB(false), ddepth(CV_32F),
+      datalayout(DNN_LAYOUT_NCHW), paddingmode(DNN_PMODE_NULL)
+{}
+
+Image2BlobParams::Image2BlobParams(const Scalar& scalefactor_, const Size& size_, const Scalar& mean_, bool swapRB_,
+                                   int ddepth_, DataLayout datalayout_, ImagePaddingMode mode_)
+    : scalefactor(scalefactor_), size(size_), mean(mean_), swapRB(swapRB_), ddepth(ddepth_),
+      datalayout(datalayout_), paddingmode(mode_)
+{}
+
+namespace {
+
+// Source sample positions of one output axis, the same as in cv::resize with INTER_LINEAR:
+// the output pixel d is interpolated between the source pixels ofs[d] and ofs[d] + 1 (clamped)
+// with the weight alpha[d] of the second one.
+struct ResizeAxis
+{
+    std::vector<int> ofs;
+    std::vector<float> alpha;
+    bool identity;
+
+    void init(int ssize, int dsize, int dofs, double scale)
+    {
+        ofs.resize(dsize);
+        alpha.resize(dsize);
+        identity = scale == 1.0 && dofs == 0;
+        for (int d = 0; d < dsize; d++)
+        {
+            float f = (float)((d + dofs + 0.5)*scale - 0.5);
+            int s = cvFloor(f);
+            f -= s;
+            if (s < 0)
+                s = 0, f = 0.f;
+            if (s >= ssize - 1)
+                s = ssize - 1, f = 0.f;
+            ofs[d] = s;
+            alpha[d] = f;
+        }
+    }
+};
+
+struct ImageResizeTab
+{
+    ResizeAxis x, y;
+};
+
+static void initResizeTab(const Mat& image, Size size, ImagePaddingMode mode, ImageResizeTab& tab)
+{
+    Size ssize = image.size();
+    if (mode == DNN_PMODE_CROP_CENTER && ssize != size)
+    {
+        // resize keeping the aspect ratio to cover the output, then take the central part
+        double f = std::max(size.width / (float)ssize.width, size.height / (float)ssize.height);
+        Size rsize(saturate_cast<int>(ssize.width*f), saturate_cast<int>(ssize.height*f));
+        tab.x.init(ssize.width, size.width, (rsize.width - size.width)/2, 1./f);
+        tab.y.init(ssize.height, size.height, (rsize.height - size.height)/2, 1./f);
+    }
+    else
+    {
+        tab.x.init(ssize.width, size.width, 0, 1./((double)size.width/ssize.width));
+        tab.y.init(ssize.height, size.height, 0, 1./((double)size.height/ssize.height));
+    }
+}
+
+template<typename T> static inline void convertRow(const T* src, float* dst, int len)
+{
+    for (int i = 0; i < len; i++)
+        dst[i] = (float)src[i];
+}
+
+template<> inline void convertRow(const uchar* src, float* dst, int len)
+{
+    int i = 0;
+#if CV_SIMD
+    const int VECSZ = v_float32::nlanes;
+    for (; i <= len - VECSZ*4; i += VECSZ*4)
+    {
+        v_uint16 w0, w1;
+        v_expand(vx_load(src + i), w0, w1);
+        v_uint32 d0, d1, d2, d3;
+        v_expand(w0, d0, d1);
+        v_expand(w1, d2, d3);
+        v_store(dst + i, v_cvt_f32(v_reinterpret_as_s32(d0)));
+        v_store(dst + i + VECSZ, v_cvt_f32(v_reinterpret_as_s32(d1)));
+        v_store(dst + i + VECSZ*2, v_cvt_f32(v_reinterpret_as_s32(d2)));
+        v_store(dst + i + VECSZ*3, v_cvt_f32(v_reinterpret_as_s32(d3)));
+    }
+#endif
+    for (; i < len; i++)
+        dst[i] = (float)src[i];
+}
+
+#if CV_SIMD128
+template<typename T> static inline v_float32x4 loadPixel4(const T* src);
+template<> inline v_float32x4 loadPixel4(const uchar* src) { return v_cvt_f32(v_reinterpret_as_s32(v_load_expand_q(src))); }
+template<> inline v_float32x4 loadPixel4(const float* src) { return v_load(src); }
+#endif
+
+// horizontal pass of the bilinear resize, with the float conversion;
+// dst should have space for one more pixel
+template<typename T, int cn> static void resizeRow(const T* src, const ResizeAxis& x, float* dst, int swidth)
+{
+    int width = (int)x.ofs.size(), d = 0;
+#if CV_SIMD128
+    if (cn == 3 || cn == 4)
+    {
+        // a 3-channel pixel is processed as 4 values, the last pixel of the row is not read this way
+        int send = cn == 4 ? swidth : swidth - 1;
+        for (; d < width; d++, dst += cn)
+        {
+            int s0 = x.ofs[d], s1 = s0 + 1;
+            if (s1 >= send)
+                break;
+            v_float32x4 a1 = v_setall_f32(x.alpha[d]), a0 = v_setall_f32(1.f - x.alpha[d]);
+            v_store(dst, loadPixel4(src + s0*cn)*a0 + loadPixel4(src + s1*cn)*a1);
+        }
+    }
+#endif
+    for (; d < width; d++, dst += cn)
+    {
+        int s0 = x.ofs[d], s1 = std::min(s0 + 1, swidth - 1);
+        float a1 = x.alpha[d], a0 = 1.f - a1;
+        const T* S0 = src + s0*cn;
+        const T* S1 = src + s1*cn;
+        for (int c = 0; c < cn; c++)
+            dst[c] = S0[c]*a0 + S1[c]*a1;
+    }
+}
+
+template<typename DT> static inline void storeValue(DT* dst, float v) { *dst = saturate_cast<DT>(v); }
+template<> inline void storeValue(float* dst, float v) { *dst = v; }
+
+/*
+Vertical pass of the bilinear resize, normalization and output of one row.
+dst[c] is the first element of the output channel c in the row and dststep is the distance between
+neighbor pixels of the channel (1 for the planar layout and cn for the interleaved one).
+*/
+template<typename DT, int cn> static void normalizeRow(const float* row0, const float* row1, float b1, int width,
+                                                       const int* order, const float* mean, const float* scale,
+                                                       DT** dst, int dststep)
+{
+    float b0 = 1.f - b1;
+    int x = 0;
+#if CV_SIMD
+    if (std::is_same<DT, float>::value)
+    {
+        const int VECSZ = v_float32::nlanes;
+        v_float32 vb0 = vx_setall_f32(b0), vb1 = vx_setall_f32(b1);
+        v_float32 vmean[4], vscale[4];
+        for (int c = 0; c < cn; c++)
+        {
+            vmean[c] = vx_setall_f32(mean[c]);
+            vscale[c] = vx_setall_f32(scale[c]);
+        }
+        for (; x <= width - VECSZ; x += VECSZ)
+        {
+            v_float32 s[4], v[4];
+            if (cn == 1)
+                s[0] = vx_load(row0 + x);
+            else if (cn == 3)
+                v_load_deinterleave(row0 + x*cn, s[0], s[1], s[2]);
+            else
+                v_load_deinterleave(row0 + x*cn, s[0], s[1], s[2], s[3]);
+            if (row1)
+            {
+                v_float32 t[4];
+                if (cn == 1)
+                    t[0] = vx_load(row1 + x);
+                else if (cn == 3)
+                    v_load_deinterleave(row1 + x*cn, t[0], t[1], t[2]);
+                else
+                    v_load_deinterleave(row1 + x*cn, t[0], t[1], t[2], t[3]);
+                for (int c = 0; c < cn; c++)
+                    s[c] = s[c]*vb0 + t[c]*vb1;
+            }
+            for (int c = 0; c < cn; c++)
+                v[c] = (s[order[c]] - vmean[c])*vscale[c];
+            if (dststep == 1)
+            {
+                for (int c = 0; c < cn; c++)
+                    v_store((float*)dst[c] + x, v[c]);
+            }
+            else if (cn == 3)
+                v_store_interleave((float*)dst[0] + x*cn, v[0], v[1], v[2]);
+            else if (cn == 4)
+                v_store_interleave((float*)dst[0] + x*cn, v[0], v[1], v[2], v[3]);
+            else
+                v_store((float*)dst[0] + x, v[0]);
+        }
+    }
+#endif
+    for (; x < width; x++)
+    {
+        float s[4];
+        const float* S0 = row0 + x*cn;
+        for (int c = 0; c < cn; c++)
+            s[c] = S0[c];
+        if (row1)
+        {
+            const float* S1 = row1 + x*cn;
+            for (int c = 0; c < cn; c++)
+                s[c] = s[c]*b0 + S1[c]*b1;
+        }
+        for (int c = 0; c < cn; c++)
+            storeValue(dst[c] + x*dststep, (s[order[c]] - mean[c])*scale[c]);
+    }
+}
+
+class Image2BlobInvoker : public ParallelLoopBody
+{
+public:
+    enum { STRIPE_HEIGHT = 16 };
+
+    Image2BlobInvoker(const std::vector<Mat>& images_, const std::vector<ImageResizeTab>& tabs_, Mat& blob_,
+                      const Image2BlobParams& param_)
+        : images(images_), tabs(tabs_), blob(blob_), param(param_)
+    {
+        cn = images[0].channels();
+        size = param.size;
+        nstripes = (size.height + STRIPE_HEIGHT - 1)/STRIPE_HEIGHT;
+
+        // the mean and the scale are given for the output channels, while
+        // (following blobFromImages) the first and the last ones are swapped with the input channels
+        Scalar srcMean = param.mean, srcScale = param.scalefactor;
+        if (param.swapRB)
+        {
+            std::swap(srcMean[0], srcMean[2]);
+            std::swap(srcScale[0], srcScale[2]);
+        }
+        for (int c = 0; c < 4; c++)
+            order[c] = c;
+        if (param.swapRB && cn >= 3)
+            std::swap(order[0], order[2]);
+        for (int c = 0; c < cn; c++)
+        {
+            mean[c] = (float)srcMean[order[c]];
+            scale[c] = (float)srcScale[order[c]];
+        }
+    }
+
+    int total() const { return (int)images.size()*nstripes; }
+
+    void operator()(const Range& range) const CV_OVERRIDE
+    {
+        int depth = images[0].depth(), ddepth = blob.depth();
+        if (depth == CV_8U && ddepth == CV_8U)
+            run<uchar, uchar>(range);
+        else if (depth == CV_8U)
+            run<uchar, float>(range);
+        else
+            run<float, float>(range);
+    }
+
+private:
+    template<typename T, typename DT> void run(const Range& range) const
+    {
+        switch (cn)
+        {
+        case 1: run<T, DT, 1>(range); break;
+        case 3: run<T, DT, 3>(range); break;
+        case 4: run<T, DT, 4>(range); break;
+        default: CV_Error(Error::StsNotImplemented, "");
+        }
+    }
+
+    template<typename T, typename DT, int CN> void run(const Range& range) const
+    {
+        int rowSize = size.width*CN;
+        AutoBuffer<float> _buf((rowSize + CN)*2);
+        float* buf[2] = { _buf.data(), _buf.data() + rowSize + CN };
+        bool nchw = param.datalayout == DNN_LAYOUT_NCHW;
+
+        for (int task = range.start; task < range.end; task++)
+        {
+            int i = task / nstripes, stripe = task % nstripes;
+            const Mat& image = images[i];
+            const ImageResizeTab& tab = tabs[i];
+            int y0 = stripe*STRIPE_HEIGHT, y1 = std::min(y0 + STRIPE_HEIGHT, size.height);
+            int cached[2] = { -1, -1 };
+
+            // source row sy, horizontally resized and converted to float;
+            // the buffer holding the row 'keep' is not reused
+            auto getRow = [&](int sy, int keep) -> const float*
+            {
+                const T* src = image.ptr<T>(sy);
+                if (tab.x.identity && std::is_same<T, float>::value)
+                    return (const float*)src;
+                if (cached[0] == sy || cached[1] == sy)
+                    return buf[cached[0] == sy ? 0 : 1];
+                int k = cached[0] == keep ? 1 : cached[1] == keep ? 0 : cached[0] < cached[1] ? 0 : 1;
+                cached[k] = sy;
+                if (tab.x.identity)
+                    convertRow(src, buf[k], rowSize);
+                else
+                    resizeRow<T, CN>(src, tab.x, buf[k], image.cols);
+                return buf[k];
+            };
+
+            for (int y = y0; y < y1; y++)
+            {
+                int sy0 = tab.y.ofs[y], sy1 = std::min(sy0 + 1, image.rows - 1);
+                float b1 = tab.y.alpha[y];
+                bool blend = b1 != 0.f && sy1 != sy0;
+                const float* row0 = getRow(sy0, blend ? sy1 : -1);
+                const float* row1 = blend ? getRow(sy1, sy0) : 0;
+                DT* dst[4];
+                int dststep;
+                if (nchw)
+                {
+                    for (int c = 0; c < CN; c++)
+                        dst[c] = blob.ptr<DT>(i, c) + (size_t)y*size.width;
+                    dststep = 1;
+                }
+                else
+                {
+                    for (int c = 0; c < CN; c++)
+                        dst[c] = blob.ptr<DT>(i, y) + c;
+                    dststep = CN;
+                }
+                normalizeRow<DT, CN>(row0, row1, b1, size.width, order, mean, scale, dst, dststep);
+            }
+        }
+    }
+
+    const std::vector<Mat>& images;
+    const std::vector<ImageResizeTab>& tabs;
+    Mat& blob;
+    const Image2BlobParams& param;
+    Size size;
+    int cn, nstripes;
+    int order[4];
+    float mean[4], scale[4];
+};
+
+}  // namespace
+
+void blobFromImagesWithParams(InputArrayOfArrays images_, OutputArray blob_, const Image2BlobParams& param_)
+{
+    CV_TRACE_FUNCTION();
+    Image2BlobParams param = param_;
+    CV_CheckType(param.ddepth, param.ddepth == CV_32F || param.ddepth == CV_8U, "Blob depth should be CV_32F or CV_8U");
+    CV_Check(param.datalayout, param.datalayout == DNN_LAYOUT_NCHW || param.datalayout == DNN_LAYOUT_NHWC,
+                 "Blob layout should be DNN_LAYOUT_NCHW or DNN_LAYOUT_NHWC");
+    if (param.ddepth == CV_8U)
+    {
+        CV_Assert(param.scalefactor == Scalar::all(1.0) && "Scaling is not supported for CV_8U blob depth");
+        CV_Assert(param.mean == Scalar() && "Mean subtraction is not supported for CV_8U blob depth");
+    }
+
+    std::vector<Mat> images;
+    images_.getMatVector(images);
+    CV_Assert(!images.empty());
+
+    const Mat& image0 = images[0];
+    int nch = image0.channels();
+    CV_Check(nch, nch == 1 || nch == 3 || nch == 4, "Images should have 1, 3 or 4 channels");
+    if (param.size == Size())
+        param.size = image0.size();
+    CV_Assert(param.size.area() > 0);
+
+    std::vector<ImageResizeTab> tabs(images.size());
+    for (size_t i = 0; i < images.size(); i++)
+    {
+        const Mat& image = images[i];
+        CV_Assert(image.dims == 2 && !image.empty());
+        CV_CheckEQ(image.channels(), nch, "All images should have the same number of channels");
+        CV_CheckDepth(image.depth(), image.depth() == image0.depth(), "All images should have the same depth");
+        CV_CheckDepth(image.depth(), image.depth() == CV_8U || (image.depth() == CV_32F && param.ddepth == CV_32F),
+                      "Images should be CV_8U, or CV_32F for CV_32F blob depth");
+        initResizeTab(image, param.size, param.paddingmode, tabs[i]);
+    }
+
+    int nimages = (int)images.size();
+    if (param.datalayout == DNN_LAYOUT_NCHW)
+    {
+        int sz[] = { nimages, nch, param.size.height, param.size.width };
+        blob_.create(4, sz, param.ddepth);
+    }
+    else
+    {
+        int sz[] = { nimages, param.size.height, param.size.width, nch };
+        blob_.create(4, sz, param.ddepth);
+    }
+    Mat blob = blob_.getMat();
+
+    Image2BlobInvoker invoker(images, tabs, blob, param);
+    parallel_for_(Range(0, invoker.total()), invoker);
+}
+
+Mat blobFromImagesWithParams(InputArrayOfArrays images, const Image2BlobParams& param)
+{
+    CV_TRACE_FUNCTION();
+    Mat blob;
+    blobFromImagesWithParams(images, blob, param);
+    return blob;
+}
+
+void blobFromImageWithParams(InputArray image, OutputArray blob, const Image2BlobParams& param)
+{
+    CV_TRACE_FUNCTION();
+    std::vector<Mat> images(1, image.getMat());
+    blobFromImagesWithParams(images, blob, param);
+}
+
+Mat blobFromImageWithParams(InputArray image, const Image2BlobParams& param)
+{
+    CV_TRACE_FUNCTION();
+    Mat blob;
+    blobFromImageWithParams(image, blob, param);
+    return blob;
+}
+
+Mat blobFromImage(InputArray image, double scalefactor, const Size& size,
+                  const Scalar& mean, bool swapRB, bool crop, int ddepth)
+{
+    CV_TRACE_FUNCTION();
+    Mat blob;
+    blobFromImage(image, blob, scalefactor, size, mean, swapRB, crop, ddepth);
+    return blob;
+}
+
+void blobFromImage(InputArray image, OutputArray blob, double scalefactor,
+                   const Size& size, const Scalar& mean, bool swapRB, bool crop, int ddepth)
+{
+    CV_TRACE_FUNCTION();
+    std::vector<Mat> images(1, image.getMat());
+    blobFromImages(images, blob, scalefactor, size, mean, swapRB, crop, ddepth);
+}
+
+Mat blobFromImages(InputArrayOfArrays images, double scalefactor, Size size,
+                   const Scalar& mean, bool swapRB, bool crop, int ddepth)
+{
+    CV_TRACE_FUNCTION();
+    Mat blob;
+    blobFromImages(images, blob, scalefactor, size, mean, swapRB, crop, ddepth);
+    return blob;
+}
+
+void blobFromImages(InputArrayOfArrays images, OutputArray blob, double scalefactor,
+                    Size size, const Scalar& mean, bool swapRB, bool crop, int ddepth)
+{
+    CV_TRACE_FUNCTION();
+    if (ddepth == CV_8U)
+        CV_CheckEQ(scalefactor, 1.0, "Scaling is not supported for CV_8U blob depth");
+    Image2BlobParams param(Scalar::all(scalefactor), size, mean, swapRB, ddepth, DNN_LAYOUT_NCHW,
+                           crop ? DNN_PMODE_CROP_CENTER : DNN_PMODE_NULL);
+    blobFromImagesWithParams(images, blob, param);
+}
+
+void imagesFromBlob(const cv::Mat& blob_, OutputArrayOfArrays images_)
+{
+    CV_TRACE_FUNCTION();
+
+    //A blob is a 4 dimensional matrix in floating point precision
+    //blob_[0] = batchSize = nbOfImages
+    //blob_[1] = nbOfChannels
+    //blob_[2] = height
+    //blob_[3] = width
+    CV_Assert(blob_.depth() == CV_32F);
+    CV_Assert(blob_.dims == 4);
+
+    images_.create(cv::Size(1, blob_.size[0]), blob_.depth());
+
+    std::vector<Mat> vectorOfChannels(blob_.size[1]);
+    for (int n = 0; n <  blob_.size[0]; ++n)
+    {
+        for (int c = 0; c < blob_.size[1]; ++c)
+        {
+            vectorOfChannels[c] = getPlane(blob_, n, c);
+        }
+        cv::merge(vectorOfChannels, images_.getMatRef(n));
+    }
+}
+
+CV__DNN_INLINE_NS_END
+}}  // namespace cv::dnn
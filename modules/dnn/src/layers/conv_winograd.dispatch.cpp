@@ -0,0 +1,335 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+// Winograd F(4x4, 3x3) convolution:
+//   Y = A^T [ (G g G^T) .* (B^T d B) ] A
+// where g is a 3x3 kernel, d is a 6x6 input tile and Y is the corresponding 4x4 output tile.
+// The elementwise product summed over the input channels becomes 36 independent GEMMs.
+
+#include "../precomp.hpp"
+#include "conv_winograd.hpp"
+
+#include "conv_winograd.simd.hpp"
+#include "layers/conv_winograd.simd_declarations.hpp" // defines CV_CPU_DISPATCH_MODES_ALL=AVX512_SKX,AVX2,...,BASELINE based on CMakeLists.txt content
+
+namespace cv {
+namespace dnn {
+
+enum { WINO_STEP = 4, WINO_SIZE = 6, WINO_AREA = WINO_SIZE*WINO_SIZE, WINO_TILE_BLOCK = 48 };
+
+// G g G^T for a 3x3 kernel, the result is stored with the given step between the 36 elements
+static void winogradKernelTransform(const float* g, float* u, size_t ustep)
+{
+    float t[WINO_SIZE][3];
+    for( int j = 0; j < 3; j++ )
+    {
+        float g0 = g[j], g1 = g[3 + j], g2 = g[6 + j];
+        t[0][j] = g0*0.25f;
+        t[1][j] = (g0 + g1 + g2)*(-1.f/6);
+        t[2][j] = (g0 - g1 + g2)*(-1.f/6);
+        t[3][j] = g0*(1.f/24) + g1*(1.f/12) + g2*(1.f/6);
+        t[4][j] = g0*(1.f/24) - g1*(1.f/12) + g2*(1.f/6);
+        t[5][j] = g2;
+    }
+    for( int i = 0; i < WINO_SIZE; i++, u += ustep*WINO_SIZE )
+    {
+        float g0 = t[i][0], g1 = t[i][1], g2 = t[i][2];
+        u[0] = g0*0.25f;
+        u[ustep] = (g0 + g1 + g2)*(-1.f/6);
+        u[ustep*2] = (g0 - g1 + g2)*(-1.f/6);
+        u[ustep*3] = g0*(1.f/24) + g1*(1.f/12) + g2*(1.f/6);
+        u[ustep*4] = g0*(1.f/24) - g1*(1.f/12) + g2*(1.f/6);
+        u[ustep*5] = g2;
+    }
+}
+
+// B^T d B for a 6x6 input tile, the result is stored with the given step between the 36 elements
+static inline void winogradInputTransform(const float d[WINO_AREA], float* v, size_t vstep)
+{
+    float t[WINO_AREA];
+    for( int j = 0; j < WINO_SIZE; j++ )
+    {
+        float d0 = d[j], d1 = d[6 + j], d2 = d[12 + j], d3 = d[18 + j], d4 = d[24 + j], d5 = d[30 + j];
+        t[j] = 4*d0 - 5*d2 + d4;
+        t[6 + j] = d3 + d4 - 4*(d1 + d2);
+        t[12 + j] = d4 - d3 + 4*(d1 - d2);
+        t[18 + j] = d4 - d2 + 2*(d3 - d1);
+        t[24 + j] = d4 - d2 - 2*(d3 - d1);
+        t[30 + j] = 4*d1 - 5*d3 + d5;
+    }
+    for( int i = 0; i < WINO_SIZE; i++, v += vstep*WINO_SIZE )
+    {
+        const float* r = t + i*WINO_SIZE;
+        v[0] = 4*r[0] - 5*r[2] + r[4];
+        v[vstep] = r[3] + r[4] - 4*(r[1] + r[2]);
+        v[vstep*2] = r[4] - r[3] + 4*(r[1] - r[2]);
+        v[vstep*3] = r[4] - r[2] + 2*(r[3] - r[1]);
+        v[vstep*4] = r[4] - r[2] - 2*(r[3] - r[1]);
+        v[vstep*5] = 4*r[1] - 5*r[3] + r[5];
+    }
+}
+
+// A^T m A plus the bias and the leaky ReLU (slope == 1 means no activation),
+// the 36 elements of m are taken with the given step
+static inline void winogradOutputTransform(const float* m, size_t mstep, float bias, float slope,
+                                           float y[WINO_STEP*WINO_STEP])
+{
+    float t[WINO_STEP][WINO_SIZE];
+    for( int j = 0; j < WINO_SIZE; j++ )
+    {
+        float m0 = m[mstep*j], m1 = m[mstep*(6 + j)], m2 = m[mstep*(12 + j)];
+        float m3 = m[mstep*(18 + j)], m4 = m[mstep*(24 + j)], m5 = m[mstep*(30 + j)];
+        float s12 = m1 + m2, d12 = m1 - m2, s34 = m3 + m4, d34 = m3 - m4;
+        t[0][j] = m0 + s12 + s34;
+        t[1][j] = d12 + 2*d34;
+        t[2][j] = s12 + 4*s34;
+        t[3][j] = d12 + 8*d34 + m5;
+    }
+    for( int i = 0; i < WINO_STEP; i++, y += WINO_STEP )
+    {
+        const float* r = t[i];
+        float s12 = r[1] + r[2], d12 = r[1] - r[2], s34 = r[3] + r[4], d34 = r[3] - r[4];
+        float y0 = r[0] + s12 + s34 + bias, y1 = d12 + 2*d34 + bias;
+        float y2 = s12 + 4*s34 + bias, y3 = d12 + 8*d34 + r[5] + bias;
+        y[0] = std::max(y0, 0.f) + std::min(y0, 0.f)*slope;
+        y[1] = std::max(y1, 0.f) + std::min(y1, 0.f)*slope;
+        y[2] = std::max(y2, 0.f) + std::min(y2, 0.f)*slope;
+        y[3] = std::max(y3, 0.f) + std::min(y3, 0.f)*slope;
+    }
+}
+
+static void winogradGemm(const float* wptr, size_t wstep, const float* inptr, size_t inpstep,
+                         float* outptr, size_t outstep, int Cin, int Cout, int ntiles)
+{
+    CV_CPU_DISPATCH(winogradGemm, (wptr, wstep, inptr, inpstep, outptr, outstep, Cin, Cout, ntiles),
+                    CV_CPU_DISPATCH_MODES_ALL);
+}
+
+void winogradTransformWeights(const Mat& weights, int inpCn, Mat& winoWeights)
+{
+    CV_TRACE_FUNCTION();
+    const int outCn = weights.rows;
+    CV_CheckTypeEQ(weights.type(), CV_32FC1, "");
+    CV_CheckGE(weights.cols, inpCn*9, "");
+
+    // the layout is [36][outCn][inpCn], so the inner GEMM loops go over the input channels
+    winoWeights.create(WINO_AREA, outCn*inpCn, CV_32F);
+    const size_t ustep = winoWeights.step1();
+    for( int c = 0; c < outCn; c++ )
+    {
+        const float* wptr = weights.ptr<float>(c);
+        float* uptr = winoWeights.ptr<float>() + (size_t)c*inpCn;
+        for( int i = 0; i < inpCn; i++ )
+            winogradKernelTransform(wptr + i*9, uptr + i, ustep);
+    }
+}
+
+// The tiles of all the images in the batch are processed together, in the blocks of WINO_TILE_BLOCK tiles.
+// When there are enough blocks, every stripe runs all the three stages for its own blocks, so the transformed
+// data stays in cache. Otherwise (small feature maps) each stage is parallelized over the channels.
+class WinogradConvInvoker : public ParallelLoopBody
+{
+public:
+    enum Mode { BLOCKS, INPUT_STAGE, MULTIPLY_STAGE, OUTPUT_STAGE };
+
+    WinogradConvInvoker(const Mat& input, Mat& output, const Mat& winoWeights,
+                        const std::vector<float>& biasvec, const std::vector<float>& reluslope,
+                        const ActivationLayer* activ, int pad_t, int pad_l, Mat& buf)
+        : input_(input), output_(output), winoWeights_(winoWeights), biasvec_(biasvec),
+          reluslope_(reluslope), activ_(reluslope.empty() ? activ : 0), pad_t_(pad_t), pad_l_(pad_l)
+    {
+        inpCn_ = input.size[1];
+        height_ = input.size[2];
+        width_ = input.size[3];
+        outCn_ = output.size[1];
+        outHeight_ = output.size[2];
+        outWidth_ = output.size[3];
+        tilesX_ = (outWidth_ + WINO_STEP - 1)/WINO_STEP;
+        imgTiles_ = ((outHeight_ + WINO_STEP - 1)/WINO_STEP)*tilesX_;
+        ntiles_ = input.size[0]*imgTiles_;
+        nblocks_ = (ntiles_ + WINO_TILE_BLOCK - 1)/WINO_TILE_BLOCK;
+
+        int nthreads = std::max(getNumThreads(), 1);
+        mode_ = nblocks_ >= nthreads ? BLOCKS : INPUT_STAGE;
+        nstripes_ = mode_ == BLOCKS ? nthreads : 1;
+        tstride_ = mode_ == BLOCKS ? (int)WINO_TILE_BLOCK : ntiles_;
+        vstep_ = pointStep(inpCn_);
+        mstep_ = pointStep(outCn_);
+        bufsize_ = (vstep_ + mstep_)*WINO_AREA;
+        buf.create(1, (int)(bufsize_*nstripes_), CV_32F);
+        buf_ = buf.ptr<float>();
+    }
+
+    // the matrices of the 36 points are placed an odd number of cache lines apart, otherwise
+    // the transforms access them with the same cache set for the power-of-2 channel counts
+    size_t pointStep(int cn) const
+    {
+        size_t step = alignSize((size_t)cn*tstride_, 16);
+        return (step/16) % 2 == 0 ? step + 16 : step;
+    }
+
+    // B^T d B for the tiles [t0, t1) and the input channels [c0, c1), V[36][inpCn][tstride_]
+    void transformInput(int t0, int t1, int c0, int c1, float* vbuf) const
+    {
+        float d[WINO_AREA];
+        for( int c = c0; c < c1; c++ )
+        {
+            float* vptr = vbuf + (size_t)c*tstride_;
+            for( int t = t0; t < t1; t++ )
+            {
+                int n = t / imgTiles_, ty = (t % imgTiles_) / tilesX_, tx = t % tilesX_;
+                const float* inptr = input_.ptr<float>(n, c);
+                int y0 = ty*WINO_STEP - pad_t_, x0 = tx*WINO_STEP - pad_l_;
+                int dy0 = std::max(-y0, 0), dy1 = std::min(height_ - y0, (int)WINO_SIZE);
+                int dx0 = std::max(-x0, 0), dx1 = std::min(width_ - x0, (int)WINO_SIZE);
+                if( dy0 == 0 && dy1 == WINO_SIZE && dx0 == 0 && dx1 == WINO_SIZE )
+                {
+                    for( int i = 0; i < WINO_SIZE; i++ )
+                    {
+                        const float* sptr = inptr + (size_t)(y0 + i)*width_ + x0;
+                        for( int j = 0; j < WINO_SIZE; j++ )
+                            d[i*WINO_SIZE + j] = sptr[j];
+                    }
+                }
+                else
+                {
+                    for( int i = 0; i < WINO_AREA; i++ )
+                        d[i] = 0.f;
+                    for( int i = dy0; i < dy1; i++ )
+                    {
+                        const float* sptr = inptr + (size_t)(y0 + i)*width_ + x0;
+                        for( int j = dx0; j < dx1; j++ )
+                            d[i*WINO_SIZE + j] = sptr[j];
+                    }
+                }
+                winogradInputTransform(d, vptr + (t - t0), vstep_);
+            }
+        }
+    }
+
+    // M[k] = U[k]*V[k] for ntiles tiles starting from the column tofs of the buffers, M[36][outCn][tstride_]
+    void multiply(int k, int tofs, int ntiles, const float* vbuf, float* mbuf) const
+    {
+        winogradGemm(winoWeights_.ptr<float>(k), (size_t)inpCn_,
+                     vbuf + vstep_*k + tofs, (size_t)tstride_,
+                     mbuf + mstep_*k + tofs, (size_t)tstride_,
+                     inpCn_, outCn_, ntiles);
+    }
+
+    // A^T m A plus the bias and the fused activation for the tiles [t0, t1) and the output channels [c0, c1)
+    void transformOutput(int t0, int t1, int c0, int c1, const float* mbuf) const
+    {
+        float ybuf[WINO_TILE_BLOCK*WINO_STEP*WINO_STEP];
+        for( int c = c0; c < c1; c++ )
+        {
+            const float* mptr = mbuf + (size_t)c*tstride_;
+            float bias = biasvec_[c], slope = reluslope_.empty() ? 1.f : reluslope_[c];
+            for( int tb = t0; tb < t1; tb += WINO_TILE_BLOCK )
+            {
+                int tb1 = std::min(tb + (int)WINO_TILE_BLOCK, t1);
+                int len = (tb1 - tb)*WINO_STEP*WINO_STEP;
+                for( int t = tb; t < tb1; t++ )
+                {
+                    winogradOutputTransform(mptr + (t - t0), mstep_, bias, slope,
+                                            ybuf + (t - tb)*WINO_STEP*WINO_STEP);
+                }
+                if( activ_ )
+                    activ_->forwardSlice(ybuf, ybuf, len, len, c, c + 1);
+
+                for( int t = tb; t < tb1; t++ )
+                {
+                    const float* y = ybuf + (t - tb)*WINO_STEP*WINO_STEP;
+                    int n = t / imgTiles_, ty = (t % imgTiles_) / tilesX_, tx = t % tilesX_;
+                    int y0 = ty*WINO_STEP, x0 = tx*WINO_STEP;
+                    int dy = std::min(outHeight_ - y0, (int)WINO_STEP), dx = std::min(outWidth_ - x0, (int)WINO_STEP);
+                    float* outptr = output_.ptr<float>(n, c) + (size_t)y0*outWidth_ + x0;
+                    for( int i = 0; i < dy; i++, outptr += outWidth_ )
+                        for( int j = 0; j < dx; j++ )
+                            outptr[j] = y[i*WINO_STEP + j];
+                }
+            }
+        }
+    }
+
+    void operator()(const Range& r) const CV_OVERRIDE
+    {
+        if( mode_ == BLOCKS )
+        {
+            for( int s = r.start; s < r.end; s++ )
+            {
+                float* vbuf = buf_ + bufsize_*s;
+                float* mbuf = vbuf + vstep_*WINO_AREA;
+                int b0 = (int)((int64)nblocks_*s/nstripes_), b1 = (int)((int64)nblocks_*(s + 1)/nstripes_);
+                for( int b = b0; b < b1; b++ )
+                {
+                    int t0 = b*WINO_TILE_BLOCK, t1 = std::min(t0 + (int)WINO_TILE_BLOCK, ntiles_);
+                    transformInput(t0, t1, 0, inpCn_, vbuf);
+                    for( int k = 0; k < WINO_AREA; k++ )
+                        multiply(k, 0, t1 - t0, vbuf, mbuf);
+                    transformOutput(t0, t1, 0, outCn_, mbuf);
+                }
+            }
+        }
+        else if( mode_ == INPUT_STAGE )
+            transformInput(0, ntiles_, r.start, r.end, buf_);
+        else if( mode_ == MULTIPLY_STAGE )
+        {
+            for( int task = r.start; task < r.end; task++ )
+            {
+                int k = task / nblocks_, tofs = (task % nblocks_)*WINO_TILE_BLOCK;
+                multiply(k, tofs, std::min(ntiles_ - tofs, (int)WINO_TILE_BLOCK),
+                         buf_, buf_ + vstep_*WINO_AREA);
+            }
+        }
+        else
+            transformOutput(0, ntiles_, r.start, r.end, buf_ + vstep_*WINO_AREA);
+    }
+
+    void run()
+    {
+        if( mode_ == BLOCKS )
+        {
+            parallel_for_(Range(0, nstripes_), *this, nstripes_);
+            return;
+        }
+        mode_ = INPUT_STAGE;
+        parallel_for_(Range(0, inpCn_), *this);
+        mode_ = MULTIPLY_STAGE;
+        parallel_for_(Range(0, WINO_AREA*nblocks_), *this);
+        mode_ = OUTPUT_STAGE;
+        parallel_for_(Range(0, outCn_), *this);
+    }
+
+private:
+    const Mat& input_;
+    Mat& output_;
+    const Mat& winoWeights_;
+    const std::vector<float>& biasvec_;
+    const std::vector<float>& reluslope_;
+    const ActivationLayer* activ_;
+    int pad_t_, pad_l_;
+    int inpCn_, height_, width_, outCn_, outHeight_, outWidth_;
+    int tilesX_, imgTiles_, ntiles_, nblocks_;
+    Mode mode_;
+    int nstripes_, tstride_;
+    size_t vstep_, mstep_, bufsize_;
+    float* buf_;
+};
+
+void runWinograd3x3(const Mat& input, Mat& output, const Mat& winoWeights,
+                    const std::vector<float>& biasvec, const std::vector<float>& reluslope,
+                    const ActivationLayer* activ, int pad_t, int pad_l, Mat& buf)
+{
+    CV_TRACE_FUNCTION();
+    CV_Assert_N(input.dims == 4, output.dims == 4, input.size[0] == output.size[0],
+                input.type() == CV_32F, output.type() == CV_32F,
+                input.isContinuous(), output.isContinuous(),
+                winoWeights.rows == WINO_AREA,
+                winoWeights.cols == input.size[1]*output.size[1],
+                biasvec.size() >= (size_t)output.size[1]);
+    CV_Assert(reluslope.empty() || reluslope.size() >= (size_t)output.size[1]);
+    WinogradConvInvoker(input, output, winoWeights, biasvec, reluslope, activ, pad_t, pad_l, buf).run();
+}
+
+}} // namespace cv::dnn
@@ -0,0 +1,21 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#ifndef OPENCV_DNN_LAYERS_CONV_WINOGRAD_HPP
+#define OPENCV_DNN_LAYERS_CONV_WINOGRAD_HPP
+
+namespace cv {
+namespace dnn {
+
+// Winograd F(4x4, 3x3) convolution for 3x3 kernels with unit strides and dilations.
+// The weights (one row per output channel) are transformed once, buf is reused between the calls.
+void winogradTransformWeights(const Mat& weights, int inpCn, Mat& winoWeights);
+
+void runWinograd3x3(const Mat& input, Mat& output, const Mat& winoWeights,
+                    const std::vector<float>& biasvec, const std::vector<float>& reluslope,
+                    const ActivationLayer* activ, int pad_t, int pad_l, Mat& buf);
+
+}} // namespace cv::dnn
+
+#endif // OPENCV_DNN_LAYERS_CONV_WINOGRAD_HPP
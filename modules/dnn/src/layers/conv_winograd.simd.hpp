@@ -0,0 +1,103 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "opencv2/core/hal/intrin.hpp"
+
+namespace cv {
+namespace dnn {
+CV_CPU_OPTIMIZATION_NAMESPACE_BEGIN
+
+// Multiplies the transformed weights by the transformed input tiles for one of the 36 points of
+// the Winograd F(4x4, 3x3) domain:
+//   outptr[c*outstep + t] = sum_i wptr[c*wstep + i]*inptr[i*inpstep + t], 0 <= c < Cout, 0 <= t < ntiles
+void winogradGemm(const float* wptr, size_t wstep, const float* inptr, size_t inpstep,
+                  float* outptr, size_t outstep, int Cin, int Cout, int ntiles);
+
+#ifndef CV_CPU_OPTIMIZATION_DECLARATIONS_ONLY
+
+void winogradGemm(const float* wptr, size_t wstep, const float* inptr, size_t inpstep,
+                  float* outptr, size_t outstep, int Cin, int Cout, int ntiles)
+{
+    for( int c = 0; c < Cout; c += 4 )
+    {
+        // the last incomplete group of output channels recomputes the last channel;
+        // the duplicated rows produce the same values, so the repeated stores are harmless
+        const float* wptr0 = wptr + wstep*c;
+        const float* wptr1 = c + 1 < Cout ? wptr0 + wstep : wptr0;
+        const float* wptr2 = c + 2 < Cout ? wptr1 + wstep : wptr1;
+        const float* wptr3 = c + 3 < Cout ? wptr2 + wstep : wptr2;
+        float* outptr0 = outptr + outstep*c;
+        float* outptr1 = c + 1 < Cout ? outptr0 + outstep : outptr0;
+        float* outptr2 = c + 2 < Cout ? outptr1 + outstep : outptr1;
+        float* outptr3 = c + 3 < Cout ? outptr2 + outstep : outptr2;
+        int t = 0;
+
+#if CV_SIMD
+        const int VECSZ = v_float32::nlanes;
+        for( ; t <= ntiles - VECSZ*3; t += VECSZ*3 )
+        {
+            v_float32 s00 = vx_setzero_f32(), s01 = s00, s02 = s00;
+            v_float32 s10 = s00, s11 = s00, s12 = s00;
+            v_float32 s20 = s00, s21 = s00, s22 = s00;
+            v_float32 s30 = s00, s31 = s00, s32 = s00;
+            const float* rptr = inptr + t;
+            for( int i = 0; i < Cin; i++, rptr += inpstep )
+            {
+                v_float32 r0 = vx_load(rptr), r1 = vx_load(rptr + VECSZ), r2 = vx_load(rptr + VECSZ*2);
+                v_float32 w = vx_setall_f32(wptr0[i]);
+                s00 = v_fma(w, r0, s00); s01 = v_fma(w, r1, s01); s02 = v_fma(w, r2, s02);
+                w = vx_setall_f32(wptr1[i]);
+                s10 = v_fma(w, r0, s10); s11 = v_fma(w, r1, s11); s12 = v_fma(w, r2, s12);
+                w = vx_setall_f32(wptr2[i]);
+                s20 = v_fma(w, r0, s20); s21 = v_fma(w, r1, s21); s22 = v_fma(w, r2, s22);
+                w = vx_setall_f32(wptr3[i]);
+                s30 = v_fma(w, r0, s30); s31 = v_fma(w, r1, s31); s32 = v_fma(w, r2, s32);
+            }
+            v_store(outptr0 + t, s00); v_store(outptr0 + t + VECSZ, s01); v_store(outptr0 + t + VECSZ*2, s02);
+            v_store(outptr1 + t, s10); v_store(outptr1 + t + VECSZ, s11); v_store(outptr1 + t + VECSZ*2, s12);
+            v_store(outptr2 + t, s20); v_store(outptr2 + t + VECSZ, s21); v_store(outptr2 + t + VECSZ*2, s22);
+            v_store(outptr3 + t, s30); v_store(outptr3 + t + VECSZ, s31); v_store(outptr3 + t + VECSZ*2, s32);
+        }
+        for( ; t <= ntiles - VECSZ; t += VECSZ )
+        {
+            v_float32 s0 = vx_setzero_f32(), s1 = s0, s2 = s0, s3 = s0;
+            const float* rptr = inptr + t;
+            for( int i = 0; i < Cin; i++, rptr += inpstep )
+            {
+                v_float32 r = vx_load(rptr);
+                s0 = v_fma(vx_setall_f32(wptr0[i]), r, s0);
+                s1 = v_fma(vx_setall_f32(wptr1[i]), r, s1);
+                s2 = v_fma(vx_setall_f32(wptr2[i]), r, s2);
+                s3 = v_fma(vx_setall_f32(wptr3[i]), r, s3);
+            }
+            v_store(outptr0 + t, s0);
+            v_store(outptr1 + t, s1);
+            v_store(outptr2 + t, s2);
+            v_store(outptr3 + t, s3);
+        }
+#endif
+        for( ; t < ntiles; t++ )
+        {
+            float s0 = 0.f, s1 = 0.f, s2 = 0.f, s3 = 0.f;
+            const float* rptr = inptr + t;
+            for( int i = 0; i < Cin; i++, rptr += inpstep )
+            {
+                float r = *rptr;
+                s0 += wptr0[i]*r;
+                s1 += wptr1[i]*r;
+                s2 += wptr2[i]*r;
+                s3 += wptr3[i]*r;
+            }
+            outptr0[t] = s0;
+            outptr1[t] = s1;
+            outptr2[t] = s2;
+            outptr3[t] = s3;
+        }
+    }
+}
+
+#endif // CV_CPU_OPTIMIZATION_DECLARATIONS_ONLY
+
+CV_CPU_OPTIMIZATION_NAMESPACE_END
+}} // namespace
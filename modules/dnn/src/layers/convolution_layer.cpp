@@ -42,6 +42,8 @@
 
 #include "../precomp.hpp"
 #include "layers_common.hpp"
+#include "conv_winograd.hpp"
+#include "gemm_fp16.hpp"
 #include "../op_cuda.hpp"
 #include "../op_halide.hpp"
 #include "../op_inf_engine.hpp"
@@ -242,14 +244,17 @@ public:
 #define IS_POWER_LAYER(layer) \
             (!layer.empty() && !layer->type.compare("Power"))
 //TODO: simultaneously convolution and bias addition for cache optimization
-class ConvolutionLayerImpl CV_FINAL : public BaseConvolutionLayerImpl
+class ConvolutionLayerImpl CV_FINAL : public BaseConvolutionLayerImpl, public detail::PreparedWeightsLayer,
+                                      public detail::WinogradLayer
 {
 public:
-    enum { VEC_ALIGN = 8, DFT_TYPE = CV_32F };
+    enum { VEC_ALIGN = 8, DFT_TYPE = CV_32F, WINO_MIN_CN = 16 };
     Mat weightsMat;
+    Mat winoWeights, winoBuf;
     std::vector<float> biasvec;
     std::vector<float> reluslope;
     Ptr<ActivationLayer> activ;
+    bool useWinograd;
 
 #ifdef HAVE_OPENCL
     Ptr<OCL4DNNConvSpatial<float> > convolutionOp;
@@ -272,6 +277,7 @@ public:
 
     ConvolutionLayerImpl(const LayerParams &params) : BaseConvolutionLayerImpl(params)
     {
+        useWinograd = true;
 #ifdef HAVE_OPENCL
         newActiv = false;
         activType = OCL4DNN_CONV_FUSED_ACTIV_NONE;
@@ -423,6 +429,11 @@ public:
 
         weightsMultipliers.assign(numOutput, 1.0);
 
+        winoWeights.release();
+        winoBuf.release();
+        if (isWinogradApplicable(inputs[0]))
+            winogradTransformWeights(weightsMat, inputs[0].size[1], winoWeights);
+
         Mat biasMat = hasBias() ? blobs[1].reshape(1, numOutput) : Mat();
         biasvec.resize(numOutput+2);
         if( biasMat.empty() )
@@ -447,6 +458,20 @@ public:
 #endif
     }
 
+    // Winograd F(4x4, 3x3) is used for 3x3 convolutions with unit strides and dilations and constant weights.
+    // The transform overhead is not paid back for the layers with few channels.
+    bool isWinogradApplicable(const Mat& input) const
+    {
+        if (!useWinograd || blobs.empty() || input.dims != 4 || input.type() != CV_32F || kernel_size.size() != 2)
+            return false;
+        for (int i = 0; i < 2; i++)
+        {
+            if (kernel_size[i] != 3 || strides[i] != 1 || dilations[i] != 1)
+                return false;
+        }
+        return blobs[0].size[1] == input.size[1] && input.size[1] >= WINO_MIN_CN && numOutput >= WINO_MIN_CN;
+    }
+
     bool setActivation(const Ptr<ActivationLayer>& layer) CV_OVERRIDE
     {
         if ((!activ.empty() && !layer.empty()) || blobs.empty())
@@ -624,6 +649,52 @@ public:
                 biasvec[i] += b.at<float>(i);
         }
         biasvec[outCn] = biasvec[outCn+1] = biasvec[outCn-1];
+
+        if (!w.empty() && !winoWeights.empty())
+            winogradTransformWeights(weightsMat, blobs[0].size[1], winoWeights);
+    }
+
+    void setUseWinograd(bool useWinograd_) CV_OVERRIDE
+    {
+        useWinograd = useWinograd_;
+    }
+
+    // finalize() always allocates new weightsMat (or takes blobs[0]) and winoWeights,
+    // so fuseWeights() never changes the shared ones
+    void getPreparedWeights(std::vector<Mat>& weights) const CV_OVERRIDE
+    {
+        weights.clear();
+        if (!blobs.empty())
+        {
+            weights.push_back(weightsMat);
+            weights.push_back(winoWeights);
+        }
+    }
+
+    void setPreparedWeights(const std::vector<Mat>& weights) CV_OVERRIDE
+    {
+        CV_Assert(weights.size() == 2);
+        weightsMat = weights[0];
+        winoWeights = weights[1];
+    }
+
+    // finalize() prepares the weights in fp32, so only the conversion to fp16 is needed
+    void convertPreparedWeights(int depth) CV_OVERRIDE
+    {
+#ifdef HAVE_TENGINE
+        return;  // Tengine takes the fp32 weights
+#endif
+        if (blobs.empty() || weightsMat.depth() == depth)
+            return;
+        CV_CheckDepthEQ(depth, CV_16F, "");
+        CV_CheckDepthEQ(weightsMat.depth(), CV_32F, "");
+        // keep the row alignment and the zero padding of the fp32 weights
+        Mat wm(weightsMat.rows, (int)weightsMat.step1(), CV_32F, weightsMat.data, weightsMat.step);
+        Mat wm16;
+        wm.convertTo(wm16, CV_16F);
+        weightsMat = wm16.colRange(0, weightsMat.cols);
+        // the Winograd branch would need the fp32 transformed weights
+        winoWeights.release();
     }
 
     virtual Ptr<BackendNode> initVkCom(const std::vector<Ptr<BackendWrapper> > &inputs) CV_OVERRIDE
@@ -943,13 +1014,12 @@ public:
                        weights.rows == output.size[1],
                        weights.cols == (input.size[1]/ngroups)*karea,
                        input.type() == output.type(),
-                       input.type() == weights.type(),
                        input.type() == CV_32FC1,
                        input.isContinuous(),
                        output.isContinuous(),
                        biasvec.size() == (size_t)output.size[1]+2);
             CV_Check(weights.step1(), weights.step1() % VEC_ALIGN == 0, "");
-            CV_CheckType(weights.type(), CV_32FC1, "");
+            CV_CheckType(weights.type(), weights.type() == CV_32FC1 || weights.type() == CV_16FC1, "");
             ParallelConv p;
 
             p.input_ = &input;
@@ -1099,7 +1169,10 @@ public:
 
             const float* data_inp0_ = input_->ptr<float>();
             const int* ofstab = &ofstab_[0];
-            const float* wptr_orig_ = weights_->ptr<float>();
+            // the weights are either in fp32 or in fp16 (DNN_TARGET_CPU_FP16)
+            const float* wptr_orig_ = weights_->depth() == CV_32F ? weights_->ptr<float>() : 0;
+            const float16_t* wptr16_orig_ = weights_->depth() == CV_16F ? weights_->ptr<float16_t>() : 0;
+            float dwbuf[9];
             size_t wstep = weights_->step1();
             const float* biasptr_ = &biasvec_->at(0);
             const float* reluptr_ = reluslope_->empty() ? 0 : &reluslope_->at(0);
@@ -1138,7 +1211,8 @@ public:
                 const float* data_inp0 = data_inp0_ + subsampleIdx*inpPlaneSize*inpCn;
                 float* data_out0 = data_out0_ + subsampleIdx*outPlaneSize*outCn;
                 int startOutCn = (subsampleIdx % ngroups)*outCn;
-                const float* wptr_orig = wptr_orig_ + wstep*startOutCn;
+                const float* wptr_orig = wptr_orig_ ? wptr_orig_ + wstep*startOutCn : 0;
+                const float16_t* wptr16_orig = wptr16_orig_ ? wptr16_orig_ + wstep*startOutCn : 0;
                 const float* biasptr = biasptr_ + startOutCn;
 
                 for( int cn0 = 0; cn0 < inpCn; cn0 += blk_size_cn )
@@ -1146,7 +1220,15 @@ public:
                     int cn1 = std::min(cn0 + blk_size_cn, inpCn);
                     int ncn = cn1 - cn0, vsz = karea*ncn;
                     int vsz_a = (int)alignSize(vsz, valign);
-                    const float* wptr = wptr_orig + cn0*karea;
+                    const float* wptr = wptr_orig ? wptr_orig + cn0*karea : 0;
+                    const float16_t* wptr16 = wptr16_orig ? wptr16_orig + cn0*karea : 0;
+                    if (depthWiseConvolution && wptr16)
+                    {
+                        // a depth-wise kernel is small enough to be expanded to fp32 in place
+                        for( k = 0; k < karea; k++ )
+                            dwbuf[k] = (float)wptr16[k];
+                        wptr = dwbuf;
+                    }
                     // we apply [Channels][P]ReLU (if any) during the final pass only.
                     const float* relu = cn1 == inpCn && reluptr_ ? reluptr_ + startOutCn : 0;
 
@@ -1538,6 +1620,10 @@ public:
 
                         // now compute dot product of the weights
                         // and im2row-transformed part of the tensor
+                        if(wptr16)
+                            fastConvFP16(wptr16, wstep, biasptr, rowbuf0, data_out0 + ofs0,
+                                         outShape, bsz, vsz, vsz_a, relu, cn0 == 0);
+                        else
                     #if CV_TRY_AVX512_SKX
                         /* AVX512 convolution requires an alignment of 16, and ROI is only there for larger vector sizes */
                         if(useAVX512)
@@ -2008,10 +2094,18 @@ public:
         if(false == tengine_ret)
 #endif
         {
-            int nstripes = std::max(getNumThreads(), 1);
+            if (!winoWeights.empty())
+            {
+                runWinograd3x3(inputs[0], outputs[0], winoWeights, biasvec, reluslope, activ.get(),
+                               (int)pads_begin[0], (int)pads_begin[1], winoBuf);
+            }
+            else
+            {
+                int nstripes = std::max(getNumThreads(), 1);
 
-            ParallelConv::run(inputs[0], outputs[0], weightsMat, biasvec, reluslope,
-                            kernel_size, strides, pads_begin, pads_end, dilations, activ.get(), ngroups, nstripes);
+                ParallelConv::run(inputs[0], outputs[0], weightsMat, biasvec, reluslope,
+                                kernel_size, strides, pads_begin, pads_end, dilations, activ.get(), ngroups, nstripes);
+            }
         }
 #if CV_SSE3
         _MM_SET_FLUSH_ZERO_MODE(ftzMode);
@@ -2161,7 +2255,7 @@ public:
     }
 };
 
-class DeConvolutionLayerImpl CV_FINAL : public BaseConvolutionLayerImpl
+class DeConvolutionLayerImpl CV_FINAL : public BaseConvolutionLayerImpl, public detail::PreparedWeightsLayer
 {
 public:
     Mat weightsMat, biasesMat;
@@ -2324,13 +2418,14 @@ public:
             pad = Size(pads_begin[1], pads_begin[0]);
         }
 
+        // the prepared weights are recomputed from scratch, because the previous ones may be fused
+        // with the following layers or shared with another network; the bias is always copied,
+        // because fuseWeights() changes it in-place
         weightsMultipliers.assign(numOutput, 1.0);
-        if (weightsMat.empty())
-        {
-            transpose(blobs[0].reshape(1, blobs[0].size[0]), weightsMat);
-            biasesMat = hasBias() ? blobs[1].reshape(1, numOutput)
-                                  : Mat::zeros(numOutput, 1, CV_32F);
-        }
+        weightsMat.release();
+        transpose(blobs[0].reshape(1, blobs[0].size[0]), weightsMat);
+        biasesMat = hasBias() ? blobs[1].reshape(1, numOutput).clone()
+                              : Mat::zeros(numOutput, 1, CV_32F);
     }
 
     void fuseWeights(const Mat& w_, const Mat& b_) CV_OVERRIDE
@@ -2344,8 +2439,9 @@ public:
 
         if (!w.empty())
         {
-            transpose(blobs[0].reshape(1, blobs[0].size[0]), weightsMat);
-            weightsMat = weightsMat.reshape(1, numOutput);
+            Mat wm;
+            transpose(blobs[0].reshape(1, blobs[0].size[0]), wm);
+            weightsMat = wm.reshape(1, numOutput);
             for (int i = 0; i < numOutput; ++i)
             {
                 double wi = w.at<float>(i);
@@ -2362,6 +2458,20 @@ public:
         }
     }
 
+    void getPreparedWeights(std::vector<Mat>& weights) const CV_OVERRIDE
+    {
+        weights.assign(1, weightsMat);
+    }
+
+    void setPreparedWeights(const std::vector<Mat>& weights) CV_OVERRIDE
+    {
+        CV_Assert(weights.size() == 1);
+        weightsMat = weights[0];
+    }
+
+    // the deconvolution keeps the fp32 weights on all the targets
+    void convertPreparedWeights(int) CV_OVERRIDE {}
+
     class MatMulInvoker : public ParallelLoopBody
     {
     public:
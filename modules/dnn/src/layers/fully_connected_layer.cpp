@@ -42,6 +42,7 @@
 
 #include "../precomp.hpp"
 #include "layers_common.hpp"
+#include "gemm_fp16.hpp"
 #include "../op_cuda.hpp"
 #include "../op_halide.hpp"
 #include "../op_inf_engine.hpp"
@@ -65,7 +66,7 @@ namespace cv
 namespace dnn
 {
 
-class FullyConnectedLayerImpl CV_FINAL : public InnerProductLayer
+class FullyConnectedLayerImpl CV_FINAL : public InnerProductLayer, public detail::PreparedWeightsLayer
 {
 public:
     enum { VEC_ALIGN = 8 };
@@ -154,6 +155,33 @@ public:
                 backendId == DNN_BACKEND_INFERENCE_ENGINE_NGRAPH) && axis == 1);
     }
 
+    void getPreparedWeights(std::vector<Mat>& weights) const CV_OVERRIDE
+    {
+        weights.clear();
+        if (!blobs.empty())
+            weights.push_back(weightsMat);
+    }
+
+    void setPreparedWeights(const std::vector<Mat>& weights) CV_OVERRIDE
+    {
+        CV_Assert(weights.size() == 1);
+        weightsMat = weights[0];
+    }
+
+    void convertPreparedWeights(int depth) CV_OVERRIDE
+    {
+        if (blobs.empty() || weightsMat.depth() == depth)
+            return;
+        CV_Assert(depth == CV_16F || depth == CV_32F);
+        // the fp32 weights are restored from the original blob to not lose the precision
+        Mat src = depth == CV_32F ? blobs[0] : weightsMat;
+        int vecsize = weightsMat.cols;
+        int vecsize_aligned = (int)alignSize(vecsize, VEC_ALIGN);
+        Mat weightsBuf(weightsMat.rows, vecsize_aligned, depth, Scalar::all(0.));
+        weightsMat = weightsBuf.colRange(0, vecsize);
+        src.convertTo(weightsMat, depth);
+    }
+
     virtual bool setActivation(const Ptr<ActivationLayer>& layer) CV_OVERRIDE
     {
         if (activ.empty() || layer.empty())
@@ -175,8 +203,8 @@ public:
         {
             CV_Assert( srcMat.dims == 2 && srcMat.cols == weights.cols &&
                        dstMat.rows == srcMat.rows && dstMat.cols == weights.rows &&
-                       srcMat.type() == weights.type() && weights.type() == dstMat.type() &&
-                       srcMat.type() == CV_32F &&
+                       srcMat.type() == dstMat.type() && srcMat.type() == CV_32F &&
+                       (weights.type() == CV_32F || weights.type() == CV_16F) &&
                        (biasMat.empty() || (biasMat.type() == srcMat.type() &&
                                            biasMat.isContinuous() && (int)biasMat.total() == dstMat.cols)) );
 
@@ -226,6 +254,9 @@ public:
 
                 memcpy(sptr, sptr_, vecsize*sizeof(sptr[0]));
 
+                if( weights->depth() == CV_16F )
+                    fastGEMM1TFP16( sptr, weights->ptr<float16_t>(delta), wstep, biasptr, dptr, nw, vecsize);
+                else
             #if CV_TRY_AVX512_SKX
                 if( useAVX512 )
                     opt_AVX512_SKX::fastGEMM1T( sptr, wptr, wstep, biasptr, dptr, nw, vecsize);
@@ -0,0 +1,31 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "../precomp.hpp"
+#include "gemm_fp16.hpp"
+
+#include "gemm_fp16.simd.hpp"
+#include "layers/gemm_fp16.simd_declarations.hpp" // defines CV_CPU_DISPATCH_MODES_ALL=AVX512_SKX,AVX2,...,BASELINE based on CMakeLists.txt content
+
+namespace cv {
+namespace dnn {
+
+void fastGEMM1TFP16(const float* vec, const float16_t* weights, size_t wstep,
+                    const float* bias, float* dst, int nvecs, int vecsize)
+{
+    CV_CPU_DISPATCH(fastGEMM1TFP16, (vec, weights, wstep, bias, dst, nvecs, vecsize),
+                    CV_CPU_DISPATCH_MODES_ALL);
+}
+
+void fastConvFP16(const float16_t* weights, size_t wstep, const float* bias,
+                  const float* rowbuf, float* output, const int* outShape,
+                  int blockSize, int vecsize, int vecsize_aligned,
+                  const float* relu, bool initOutput)
+{
+    CV_CPU_DISPATCH(fastConvFP16, (weights, wstep, bias, rowbuf, output, outShape, blockSize,
+                                   vecsize, vecsize_aligned, relu, initOutput),
+                    CV_CPU_DISPATCH_MODES_ALL);
+}
+
+}} // namespace cv::dnn
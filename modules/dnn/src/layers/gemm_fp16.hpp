@@ -0,0 +1,26 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#ifndef OPENCV_DNN_LAYERS_GEMM_FP16_HPP
+#define OPENCV_DNN_LAYERS_GEMM_FP16_HPP
+
+namespace cv {
+namespace dnn {
+
+// Kernels of DNN_TARGET_CPU_FP16: the weights are stored in half precision,
+// they are expanded to fp32 on load and the products are accumulated in fp32.
+
+// dst[i] = dot(vec, weights row i) + bias[i], 0 <= i < nvecs
+void fastGEMM1TFP16(const float* vec, const float16_t* weights, size_t wstep,
+                    const float* bias, float* dst, int nvecs, int vecsize);
+
+// The same as fastConv() for the weights in half precision
+void fastConvFP16(const float16_t* weights, size_t wstep, const float* bias,
+                  const float* rowbuf, float* output, const int* outShape,
+                  int blockSize, int vecsize, int vecsize_aligned,
+                  const float* relu, bool initOutput);
+
+}} // namespace cv::dnn
+
+#endif // OPENCV_DNN_LAYERS_GEMM_FP16_HPP
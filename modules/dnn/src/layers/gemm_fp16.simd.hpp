@@ -0,0 +1,166 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "opencv2/core/hal/intrin.hpp"
+
+namespace cv {
+namespace dnn {
+CV_CPU_OPTIMIZATION_NAMESPACE_BEGIN
+
+// dst[i] = dot(vec, weights[i*wstep : i*wstep + vecsize]) + bias[i], 0 <= i < nvecs
+void fastGEMM1TFP16(const float* vec, const float16_t* weights, size_t wstep,
+                    const float* bias, float* dst, int nvecs, int vecsize);
+
+// output[c*outPlaneSize + j] = [output[c*outPlaneSize + j] +] bias[c] (if initOutput) +
+//     dot(weights[c*wstep : c*wstep + vecsize], rowbuf[j*vecsize_aligned : j*vecsize_aligned + vecsize]),
+// followed by the leaky ReLU with the per-channel slopes relu[c] (if relu != 0),
+// 0 <= c < outShape[1], 0 <= j < blockSize
+void fastConvFP16(const float16_t* weights, size_t wstep, const float* bias,
+                  const float* rowbuf, float* output, const int* outShape,
+                  int blockSize, int vecsize, int vecsize_aligned,
+                  const float* relu, bool initOutput);
+
+#ifndef CV_CPU_OPTIMIZATION_DECLARATIONS_ONLY
+
+void fastGEMM1TFP16(const float* vec, const float16_t* weights, size_t wstep,
+                    const float* bias, float* dst, int nvecs, int vecsize)
+{
+    int i = 0;
+#if CV_SIMD
+    const int VECSZ = v_float32::nlanes;
+    for( ; i <= nvecs - 4; i += 4 )
+    {
+        const float16_t* wptr0 = weights + i*wstep;
+        const float16_t* wptr1 = wptr0 + wstep;
+        const float16_t* wptr2 = wptr1 + wstep;
+        const float16_t* wptr3 = wptr2 + wstep;
+        v_float32 vs0 = vx_setzero_f32(), vs1 = vs0, vs2 = vs0, vs3 = vs0;
+        int k = 0;
+        for( ; k <= vecsize - VECSZ; k += VECSZ )
+        {
+            v_float32 v = vx_load(vec + k);
+            vs0 = v_fma(vx_load_expand(wptr0 + k), v, vs0);
+            vs1 = v_fma(vx_load_expand(wptr1 + k), v, vs1);
+            vs2 = v_fma(vx_load_expand(wptr2 + k), v, vs2);
+            vs3 = v_fma(vx_load_expand(wptr3 + k), v, vs3);
+        }
+        float s0 = v_reduce_sum(vs0), s1 = v_reduce_sum(vs1);
+        float s2 = v_reduce_sum(vs2), s3 = v_reduce_sum(vs3);
+        for( ; k < vecsize; k++ )
+        {
+            float v = vec[k];
+            s0 += v*(float)wptr0[k];
+            s1 += v*(float)wptr1[k];
+            s2 += v*(float)wptr2[k];
+            s3 += v*(float)wptr3[k];
+        }
+        dst[i] = s0 + bias[i];
+        dst[i + 1] = s1 + bias[i + 1];
+        dst[i + 2] = s2 + bias[i + 2];
+        dst[i + 3] = s3 + bias[i + 3];
+    }
+#endif
+    for( ; i < nvecs; i++ )
+    {
+        const float16_t* wptr = weights + i*wstep;
+        float s = bias[i];
+        for( int k = 0; k < vecsize; k++ )
+            s += vec[k]*(float)wptr[k];
+        dst[i] = s;
+    }
+    vx_cleanup();
+}
+
+void fastConvFP16(const float16_t* weights, size_t wstep, const float* bias,
+                  const float* rowbuf, float* output, const int* outShape,
+                  int blockSize, int vecsize, int vecsize_aligned,
+                  const float* relu, bool initOutput)
+{
+    int outCn = outShape[1];
+    size_t outPlaneSize = outShape[2]*outShape[3];
+    for( int i = 0; i < outCn; i += 2 )
+    {
+        // the odd number of output channels: the last one is computed twice
+        const float16_t* wptr0 = weights + i*wstep;
+        const float16_t* wptr1 = i + 1 < outCn ? wptr0 + wstep : wptr0;
+        float* outptr0 = output + i*outPlaneSize;
+        float* outptr1 = i + 1 < outCn ? outptr0 + outPlaneSize : outptr0;
+        float bias0 = bias[i], bias1 = i + 1 < outCn ? bias[i + 1] : bias0;
+        float r0 = relu ? relu[i] : 1.f, r1 = relu && i + 1 < outCn ? relu[i + 1] : r0;
+
+        int j = 0;
+        for( ; j <= blockSize - 4; j += 4 )
+        {
+            const float* rptr0 = rowbuf + j*vecsize_aligned;
+            const float* rptr1 = rptr0 + vecsize_aligned;
+            const float* rptr2 = rptr1 + vecsize_aligned;
+            const float* rptr3 = rptr2 + vecsize_aligned;
+            float s[2][4] = {};
+            int k = 0;
+#if CV_SIMD
+            const int VECSZ = v_float32::nlanes;
+            v_float32 vs00 = vx_setzero_f32(), vs01 = vs00, vs02 = vs00, vs03 = vs00;
+            v_float32 vs10 = vs00, vs11 = vs00, vs12 = vs00, vs13 = vs00;
+            for( ; k <= vecsize - VECSZ; k += VECSZ )
+            {
+                v_float32 w0 = vx_load_expand(wptr0 + k), w1 = vx_load_expand(wptr1 + k);
+                v_float32 x0 = vx_load(rptr0 + k), x1 = vx_load(rptr1 + k);
+                v_float32 x2 = vx_load(rptr2 + k), x3 = vx_load(rptr3 + k);
+                vs00 = v_fma(w0, x0, vs00); vs01 = v_fma(w0, x1, vs01);
+                vs02 = v_fma(w0, x2, vs02); vs03 = v_fma(w0, x3, vs03);
+                vs10 = v_fma(w1, x0, vs10); vs11 = v_fma(w1, x1, vs11);
+                vs12 = v_fma(w1, x2, vs12); vs13 = v_fma(w1, x3, vs13);
+            }
+            s[0][0] = v_reduce_sum(vs00); s[0][1] = v_reduce_sum(vs01);
+            s[0][2] = v_reduce_sum(vs02); s[0][3] = v_reduce_sum(vs03);
+            s[1][0] = v_reduce_sum(vs10); s[1][1] = v_reduce_sum(vs11);
+            s[1][2] = v_reduce_sum(vs12); s[1][3] = v_reduce_sum(vs13);
+#endif
+            for( ; k < vecsize; k++ )
+            {
+                float w0 = (float)wptr0[k], w1 = (float)wptr1[k];
+                float x0 = rptr0[k], x1 = rptr1[k], x2 = rptr2[k], x3 = rptr3[k];
+                s[0][0] += w0*x0; s[0][1] += w0*x1; s[0][2] += w0*x2; s[0][3] += w0*x3;
+                s[1][0] += w1*x0; s[1][1] += w1*x1; s[1][2] += w1*x2; s[1][3] += w1*x3;
+            }
+            for( int t = 0; t < 4; t++ )
+            {
+                float y0 = s[0][t] + (initOutput ? bias0 : outptr0[j + t]);
+                float y1 = s[1][t] + (initOutput ? bias1 : outptr1[j + t]);
+                if( relu )
+                {
+                    y0 = y0 > 0.f ? y0 : y0*r0;
+                    y1 = y1 > 0.f ? y1 : y1*r1;
+                }
+                outptr0[j + t] = y0;
+                outptr1[j + t] = y1;
+            }
+        }
+        for( ; j < blockSize; j++ )
+        {
+            const float* rptr = rowbuf + j*vecsize_aligned;
+            float s0 = initOutput ? bias0 : outptr0[j];
+            float s1 = initOutput ? bias1 : outptr1[j];
+            for( int k = 0; k < vecsize; k++ )
+            {
+                float x = rptr[k];
+                s0 += (float)wptr0[k]*x;
+                s1 += (float)wptr1[k]*x;
+            }
+            if( relu )
+            {
+                s0 = s0 > 0.f ? s0 : s0*r0;
+                s1 = s1 > 0.f ? s1 : s1*r1;
+            }
+            outptr0[j] = s0;
+            outptr1[j] = s1;
+        }
+    }
+    vx_cleanup();
+}
+
+#endif // CV_CPU_OPTIMIZATION_DECLARATIONS_ONLY
+
+CV_CPU_OPTIMIZATION_NAMESPACE_END
+}} // namespace cv::dnn
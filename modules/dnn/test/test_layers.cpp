@@ -1849,6 +1849,69 @@ TEST(Layer_Test_Convolution, relu_fusion)
     normAssert(input, output);
 }
 
+// 3x3 convolution with fused BatchNorm and leaky ReLU: Winograd F(4x4, 3x3) against the direct computation
+typedef testing::TestWithParam<tuple<Vec4i, int, int> > Layer_Test_Convolution_Winograd;
+TEST_P(Layer_Test_Convolution_Winograd, Accuracy)
+{
+    Vec4i inpShape = get<0>(GetParam());
+    int outCn = get<1>(GetParam());
+    int pad = get<2>(GetParam());
+    int inpCn = inpShape[1];
+
+    Net net;
+    {
+        LayerParams lp;
+        lp.set("kernel_size", 3);
+        lp.set("pad", pad);
+        lp.set("num_output", outCn);
+        lp.set("bias_term", true);
+        lp.type = "Convolution";
+        lp.name = "testConv";
+
+        int weightsShape[] = {outCn, inpCn, 3, 3};
+        Mat weights(4, &weightsShape[0], CV_32F), bias(1, outCn, CV_32F);
+        randu(weights, -1.0f, 1.0f);
+        randu(bias, -1.0f, 1.0f);
+        lp.blobs.push_back(weights);
+        lp.blobs.push_back(bias);
+        net.addLayerToPrev(lp.name, lp.type, lp);
+    }
+    {
+        LayerParams lp;
+        lp.type = "BatchNorm";
+        lp.name = "testBatchNorm";
+        Mat mean(1, outCn, CV_32F), var(1, outCn, CV_32F);
+        randu(mean, -1.0f, 1.0f);
+        randu(var, 0.5f, 2.0f);
+        lp.blobs.push_back(mean);
+        lp.blobs.push_back(var);
+        net.addLayerToPrev(lp.name, lp.type, lp);
+    }
+    {
+        LayerParams lp;
+        lp.set("negative_slope", 0.1f);
+        lp.type = "ReLU";
+        lp.name = "testReLU";
+        net.addLayerToPrev(lp.name, lp.type, lp);
+    }
+    Mat input(4, &inpShape[0], CV_32F);
+    randu(input, -1.0f, 1.0f);
+    net.setInput(input);
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+
+    net.enableWinograd(false);
+    Mat ref = net.forward().clone();
+    net.enableWinograd(true);
+    Mat out = net.forward();
+    normAssert(ref, out, "", 2e-5, 2e-4);
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Layer_Test_Convolution_Winograd, Combine(
+/*input shape*/ Values(Vec4i(1, 16, 16, 16), Vec4i(1, 32, 13, 17), Vec4i(2, 24, 7, 9), Vec4i(1, 64, 3, 5)),
+/*outCn*/       Values(16, 19, 64),
+/*pad*/         Values(0, 1, 2)
+));
+
 typedef testing::TestWithParam<tuple<bool, tuple<Backend, Target> > > Layer_Test_Eltwise_unequal;
 TEST_P(Layer_Test_Eltwise_unequal, accuracy_input_0_truncate)
 {
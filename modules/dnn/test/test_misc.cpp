@@ -9,6 +9,8 @@
 #include <opencv2/core/ocl.hpp>
 #include <opencv2/core/opencl/ocl_defs.hpp>
 #include <opencv2/dnn/layer.details.hpp>  // CV_DNN_REGISTER_LAYER_CLASS
+#include "../src/dnn_common.hpp"  // detail::PreparedWeightsLayer
+#include <thread>
 
 namespace opencv_test { namespace {
 
@@ -39,6 +41,125 @@ TEST(blobFromImage, allocated)
     ASSERT_EQ(blobData, blob.data);
 }
 
+// reference: separate resize, channel swap, normalization and layout passes
+static Mat blobFromImageReference(const Mat& image, const Image2BlobParams& param)
+{
+    Mat img;
+    image.convertTo(img, CV_32F);
+    Size size = param.size == Size() ? img.size() : param.size;
+    if (img.size() != size)
+    {
+        if (param.paddingmode == DNN_PMODE_CROP_CENTER)
+        {
+            float f = std::max(size.width / (float)img.cols, size.height / (float)img.rows);
+            cv::resize(img, img, Size(), f, f, INTER_LINEAR);
+            img = img(Rect((img.cols - size.width)/2, (img.rows - size.height)/2, size.width, size.height)).clone();
+        }
+        else
+            cv::resize(img, img, size, 0, 0, INTER_LINEAR);
+    }
+    std::vector<Mat> ch;
+    split(img, ch);
+    int cn = (int)ch.size();
+    Scalar mean = param.mean, scale = param.scalefactor;
+    if (param.swapRB && cn >= 3)
+        std::swap(ch[0], ch[2]);
+    else if (param.swapRB)
+    {
+        // blobFromImages swaps the mean values regardless of the number of channels
+        std::swap(mean[0], mean[2]);
+        std::swap(scale[0], scale[2]);
+    }
+    for (int c = 0; c < cn; c++)
+        ch[c] = (ch[c] - mean[c])*scale[c];
+    Mat blob;
+    if (param.datalayout == DNN_LAYOUT_NCHW)
+    {
+        int sz[] = { 1, cn, size.height, size.width };
+        blob.create(4, sz, CV_32F);
+        for (int c = 0; c < cn; c++)
+            ch[c].copyTo(Mat(size, CV_32F, blob.ptr<float>(0, c)));
+    }
+    else
+    {
+        int sz[] = { 1, size.height, size.width, cn };
+        blob.create(4, sz, CV_32F);
+        merge(ch, img);
+        img.copyTo(Mat(size, CV_32FC(cn), blob.ptr<float>()));
+    }
+    if (param.ddepth != CV_32F)
+        blob.convertTo(blob, param.ddepth);
+    return blob;
+}
+
+typedef testing::TestWithParam<tuple<int, int, int> > blobFromImageWithParams_Fused;
+
+TEST_P(blobFromImageWithParams_Fused, accuracy)
+{
+    int type = get<0>(GetParam());
+    DataLayout layout = (DataLayout)get<1>(GetParam());
+    ImagePaddingMode mode = (ImagePaddingMode)get<2>(GetParam());
+    const Size sizes[] = { Size(123, 77), Size(64, 48), Size(300, 40), Size(19, 11) };
+    RNG& rng = theRNG();
+
+    for (size_t i = 0; i < sizeof(sizes)/sizeof(sizes[0]); i++)
+    {
+        Mat img(Size(97, 61), type);
+        randu(img, 0, 256);
+        Image2BlobParams param(Scalar(0.017, 0.018, 0.0175, 0.02), sizes[i], Scalar(124, 117, 104, 50),
+                               rng.uniform(0, 2) == 1, CV_32F, layout, mode);
+        SCOPED_TRACE(cv::format("size=%dx%d swapRB=%d", param.size.width, param.size.height, (int)param.swapRB));
+
+        Mat blob = blobFromImageWithParams(img, param);
+        Mat ref = blobFromImageReference(img, param);
+        ASSERT_EQ(ref.size, blob.size);
+        EXPECT_LE(cvtest::norm(blob, ref, NORM_INF), 1e-4);
+
+        if (CV_MAT_DEPTH(type) == CV_8U)
+        {
+            param.ddepth = CV_8U;
+            param.mean = Scalar();
+            param.scalefactor = Scalar::all(1.0);
+            blob = blobFromImageWithParams(img, param);
+            ref = blobFromImageReference(img, param);
+            EXPECT_LE(cvtest::norm(blob, ref, NORM_INF), 1);
+        }
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, blobFromImageWithParams_Fused, Combine(
+    Values(CV_8UC1, CV_8UC3, CV_8UC4, CV_32FC3),
+    Values((int)DNN_LAYOUT_NCHW, (int)DNN_LAYOUT_NHWC),
+    Values((int)DNN_PMODE_NULL, (int)DNN_PMODE_CROP_CENTER)
+));
+
+TEST(blobFromImages, batch_fused)
+{
+    std::vector<Mat> images;
+    images.push_back(Mat(480, 640, CV_8UC3));
+    images.push_back(Mat(300, 200, CV_8UC3));
+    images.push_back(Mat(224, 224, CV_8UC3));
+    for (size_t i = 0; i < images.size(); i++)
+        randu(images[i], 0, 256);
+
+    const Scalar mean(104, 117, 123);
+    for (int crop = 0; crop < 2; crop++)
+    {
+        Mat blob = blobFromImages(images, 1.0/255, Size(224, 224), mean, true, crop != 0);
+        ASSERT_EQ(4, blob.dims);
+        ASSERT_EQ(3, blob.size[0]);
+        Image2BlobParams param(Scalar::all(1.0/255), Size(224, 224), mean, true, CV_32F, DNN_LAYOUT_NCHW,
+                               crop ? DNN_PMODE_CROP_CENTER : DNN_PMODE_NULL);
+        for (int i = 0; i < (int)images.size(); i++)
+        {
+            Mat ref = blobFromImageReference(images[i], param);
+            int sz[] = { 1, 3, 224, 224 };
+            Mat plane(4, sz, CV_32F, blob.ptr<float>(i));
+            EXPECT_LE(cvtest::norm(plane, ref, NORM_INF), 1e-5) << "image=" << i << " crop=" << crop;
+        }
+    }
+}
+
 TEST(imagesFromBlob, Regression)
 {
     int nbOfImages = 8;
@@ -441,6 +562,339 @@ TEST(Net, forwardAndRetrieve)
     normAssert(outBlobs[0][1], inp.rowRange(2, 4), "second part");
 }
 
+static LayerParams convParams(const std::string& name, int inpCn, int outCn, RNG& rng)
+{
+    LayerParams lp;
+    lp.name = name;
+    lp.type = "Convolution";
+    lp.set("kernel_size", 3);
+    lp.set("pad", 1);
+    lp.set("num_output", outCn);
+    lp.set("bias_term", false);
+    int wsz[] = {outCn, inpCn, 3, 3};
+    Mat weights(4, wsz, CV_32F);
+    rng.fill(weights, RNG::UNIFORM, -0.5, 0.5);
+    lp.blobs.push_back(weights);
+    return lp;
+}
+
+// the weights which the layer computes with, e.g. the convolution weights fused with the batch normalization
+static std::vector<Mat> getPreparedWeights(Net& net, int layerId)
+{
+    Ptr<cv::dnn::detail::PreparedWeightsLayer> layer = net.getLayer(layerId).dynamicCast<cv::dnn::detail::PreparedWeightsLayer>();
+    std::vector<Mat> weights;
+    if (layer)
+        layer->getPreparedWeights(weights);
+    return weights;
+}
+
+TEST(Net, memoryPlan)
+{
+    const int channels[] = {3, 8, 16, 4, 12, 6};
+    const int nconvs = (int)(sizeof(channels)/sizeof(channels[0])) - 1;
+    RNG& rng = theRNG();
+    std::vector<LayerParams> params;
+    for (int i = 0; i < nconvs; i++)
+        params.push_back(convParams(cv::format("conv%d", i), channels[i], channels[i + 1], rng));
+
+    int inpSize[] = {1, channels[0], 20, 24};
+    Mat inp(4, inpSize, CV_32F);
+    randu(inp, -1, 1);
+
+    // the reference goes layer by layer, through separate networks
+    Mat ref = inp;
+    for (int i = 0; i < nconvs; i++)
+    {
+        Net net;
+        net.addLayerToPrev(params[i].name, params[i].type, params[i]);
+        net.setPreferableBackend(DNN_BACKEND_OPENCV);
+        net.setInput(ref);
+        ref = net.forward().clone();
+    }
+
+    Mat out;
+    {
+        Net net;
+        std::vector<int> ids;
+        for (int i = 0; i < nconvs; i++)
+            ids.push_back(net.addLayerToPrev(params[i].name, params[i].type, params[i]));
+        net.setPreferableBackend(DNN_BACKEND_OPENCV);
+
+        size_t peak = 0;
+        std::vector<int> layerIds, blobIds;
+        std::vector<size_t> offsets, sizes;
+        net.getMemoryConsumption(std::vector<MatShape>(1, MatShape(inpSize, inpSize + 4)), peak, layerIds, blobIds, offsets, sizes);
+        ASSERT_EQ((size_t)nconvs, layerIds.size());
+        ASSERT_EQ(layerIds.size(), blobIds.size());
+        ASSERT_EQ(layerIds.size(), offsets.size());
+        ASSERT_EQ(layerIds.size(), sizes.size());
+
+        size_t totalSize = 0;
+        std::map<int, int> blockOfLayer;
+        for (size_t i = 0; i < layerIds.size(); i++)
+        {
+            EXPECT_EQ(0, blobIds[i]);
+            EXPECT_LE(offsets[i] + sizes[i], peak);
+            EXPECT_GE(sizes[i], (size_t)channels[std::find(ids.begin(), ids.end(), layerIds[i]) - ids.begin() + 1]*20*24*sizeof(float));
+            totalSize += sizes[i];
+            blockOfLayer[layerIds[i]] = (int)i;
+        }
+        // the input and the output of every convolution are alive at the same time, but only them
+        size_t maxAlive = 0;
+        for (int i = 1; i < nconvs; i++)
+        {
+            int a = blockOfLayer[ids[i - 1]], b = blockOfLayer[ids[i]];
+            EXPECT_TRUE(offsets[a] + sizes[a] <= offsets[b] || offsets[b] + sizes[b] <= offsets[a]) << "conv" << i;
+            maxAlive = std::max(maxAlive, sizes[a] + sizes[b]);
+        }
+        EXPECT_LT(peak, totalSize);
+        EXPECT_EQ(maxAlive, peak);
+
+        net.setInput(inp);
+        out = net.forward();
+    }
+    // the output stays valid after the network is released
+    normAssert(ref, out);
+}
+
+TEST(Net, cloneWithSharedWeights)
+{
+    RNG& rng = theRNG();
+    Net net;
+    std::vector<int> ids;
+    LayerParams lp = convParams("conv0", 3, 16, rng);
+    ids.push_back(net.addLayerToPrev(lp.name, lp.type, lp));
+    {
+        LayerParams bn;
+        bn.name = "bn";
+        bn.type = "BatchNorm";
+        Mat mean(1, 16, CV_32F), var(1, 16, CV_32F);
+        randu(mean, -1.0f, 1.0f);
+        randu(var, 0.5f, 2.0f);
+        bn.blobs.push_back(mean);
+        bn.blobs.push_back(var);
+        ids.push_back(net.addLayerToPrev(bn.name, bn.type, bn));
+    }
+    lp = convParams("conv1", 16, 16, rng);
+    ids.push_back(net.addLayerToPrev(lp.name, lp.type, lp));
+    {
+        LayerParams fc;
+        fc.name = "fc";
+        fc.type = "InnerProduct";
+        fc.set("num_output", 10);
+        fc.set("bias_term", false);
+        Mat weights(10, 16*12*12, CV_32F);
+        randu(weights, -0.1f, 0.1f);
+        fc.blobs.push_back(weights);
+        ids.push_back(net.addLayerToPrev(fc.name, fc.type, fc));
+    }
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+    // the clones take the weights replaced by setParam()
+    Mat weights = net.getParam(ids[2]).clone();
+    randu(weights, -0.5f, 0.5f);
+    net.setParam(ids[2], 0, weights);
+
+    const int nclones = 3;
+    int inpSize[] = {2, 3, 12, 12};
+    std::vector<Mat> inps(nclones), refs(nclones);
+    for (int i = 0; i < nclones; i++)
+    {
+        inps[i].create(4, inpSize, CV_32F);
+        randu(inps[i], -1.0f, 1.0f);
+        net.setInput(inps[i]);
+        refs[i] = net.forward().clone();
+    }
+
+    std::vector<Net> clones;
+    for (int i = 0; i < nclones; i++)
+        clones.push_back(net.cloneWithSharedWeights());
+    for (int i = 0; i < nclones; i++)
+    {
+        for (size_t j = 0; j < ids.size(); j++)
+        {
+            Ptr<Layer> src = net.getLayer(ids[j]), dst = clones[i].getLayer(ids[j]);
+            ASSERT_EQ(src->name, dst->name);
+            ASSERT_EQ(src->blobs.size(), dst->blobs.size());
+            for (size_t k = 0; k < src->blobs.size(); k++)
+                EXPECT_EQ(src->blobs[k].data, dst->blobs[k].data) << src->name;
+        }
+    }
+
+    std::vector<Mat> outs(nclones);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < nclones; i++)
+    {
+        threads.push_back(std::thread([&clones, &inps, &outs, i]() {
+            for (int iter = 0; iter < 3; iter++)
+            {
+                clones[i].setInput(inps[i]);
+                outs[i] = clones[i].forward().clone();
+            }
+        }));
+    }
+    for (size_t i = 0; i < threads.size(); i++)
+        threads[i].join();
+
+    for (int i = 0; i < nclones; i++)
+        normAssert(refs[i], outs[i]);
+
+    // the prepared weights are kept once: conv0 fused with bn, conv1 and fc
+    const int preparedIds[] = {ids[0], ids[2], ids[3]};
+    for (int j = 0; j < 3; j++)
+    {
+        std::vector<Mat> src = getPreparedWeights(net, preparedIds[j]);
+        ASSERT_FALSE(src.empty());
+        for (int i = 0; i < nclones; i++)
+        {
+            std::vector<Mat> dst = getPreparedWeights(clones[i], preparedIds[j]);
+            ASSERT_EQ(src.size(), dst.size());
+            for (size_t k = 0; k < src.size(); k++)
+                EXPECT_EQ(src[k].data, dst[k].data) << net.getLayer(preparedIds[j])->name << " " << k;
+        }
+    }
+    EXPECT_NE(net.getParam(ids[0]).data, getPreparedWeights(net, ids[0])[0].data);
+
+    // the source network is still usable
+    net.setInput(inps[0]);
+    normAssert(refs[0], net.forward());
+
+    // the networks computing in fp16 share the fp16 weights
+    net.setPreferableTarget(DNN_TARGET_CPU_FP16);
+    net.forward();
+    clones[0].setPreferableTarget(DNN_TARGET_CPU_FP16);
+    clones[0].forward();
+    for (int j = 0; j < 3; j++)
+    {
+        std::vector<Mat> src = getPreparedWeights(net, preparedIds[j]);
+        std::vector<Mat> dst = getPreparedWeights(clones[0], preparedIds[j]);
+        ASSERT_EQ(src.size(), dst.size());
+        EXPECT_EQ(CV_16F, src[0].depth());
+        for (size_t k = 0; k < src.size(); k++)
+            EXPECT_EQ(src[k].data, dst[k].data) << net.getLayer(preparedIds[j])->name << " " << k;
+    }
+
+    // the weights prepared again by the source network are shared with its new clones,
+    // the old clones keep the previous ones
+    weights = net.getParam(ids[0]).clone();
+    randu(weights, -0.5f, 0.5f);
+    net.setParam(ids[0], 0, weights);
+    net.setPreferableTarget(DNN_TARGET_CPU);
+    net.setInput(inps[1]);
+    Mat ref = net.forward().clone();
+    Net clone = net.cloneWithSharedWeights();
+    clone.setInput(inps[1]);
+    normAssert(ref, clone.forward());
+    EXPECT_EQ(getPreparedWeights(net, ids[0])[0].data, getPreparedWeights(clone, ids[0])[0].data);
+    EXPECT_NE(getPreparedWeights(net, ids[0])[0].data, getPreparedWeights(clones[1], ids[0])[0].data);
+    clones[1].setInput(inps[1]);
+    normAssert(refs[1], clones[1].forward());
+}
+
+TEST(Net, shapeCache)
+{
+    RNG& rng = theRNG();
+    std::vector<LayerParams> params;
+    params.push_back(convParams("conv0", 3, 8, rng));
+    params.push_back(LayerParams());
+    params.back().name = "relu";
+    params.back().type = "ReLU";
+    params.push_back(convParams("conv1", 8, 16, rng));
+
+    Net net, refNet;
+    for (size_t i = 0; i < params.size(); i++)
+    {
+        net.addLayerToPrev(params[i].name, params[i].type, params[i]);
+        refNet.addLayerToPrev(params[i].name, params[i].type, params[i]);
+    }
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+    refNet.setPreferableBackend(DNN_BACKEND_OPENCV);
+    net.setShapeCacheSize(2);
+
+    int inpSizes[][4] = {{1, 3, 8, 10}, {4, 3, 8, 10}, {2, 3, 11, 7}};
+    const int nshapes = (int)(sizeof(inpSizes)/sizeof(inpSizes[0]));
+    std::vector<Mat> inps(nshapes);
+    for (int i = 0; i < nshapes; i++)
+    {
+        inps[i].create(4, inpSizes[i], CV_32F);
+        randu(inps[i], -1.0f, 1.0f);
+    }
+
+    const int order[] = {0, 1, 0, 1, 2, 1, 0, 0};
+    std::map<int, uchar*> outData;
+    std::map<int, Ptr<Layer> > convs;
+    for (size_t k = 0; k < sizeof(order)/sizeof(order[0]); k++)
+    {
+        int i = order[k];
+        refNet.setInput(inps[i]);
+        Mat ref = refNet.forward();
+
+        net.setInput(inps[i]);
+        Mat out = net.forward();
+        normAssert(ref, out);
+
+        // the state prepared for the same shapes is reused until it is pushed out of the cache
+        bool cached = k > 0 && i == order[k - 1];
+        for (size_t j = 0; j < k && !cached; j++)
+            cached = order[j] == i && (k - j == 2 || k - j == 1);
+        if (cached)
+        {
+            EXPECT_EQ(outData[i], out.data) << k;
+            EXPECT_EQ(convs[i], net.getLayer("conv1")) << k;
+        }
+        else if (k > 0)
+        {
+            // the new state has its own layers
+            EXPECT_NE(convs[order[k - 1]], net.getLayer("conv1")) << k;
+        }
+        outData[i] = out.data;
+        convs[i] = net.getLayer("conv1");
+        EXPECT_EQ(params[2].blobs[0].data, convs[i]->blobs[0].data);
+    }
+}
+
+TEST(Net, cpuFP16)
+{
+    std::vector<Target> targets = getAvailableTargets(DNN_BACKEND_OPENCV);
+    ASSERT_TRUE(std::find(targets.begin(), targets.end(), DNN_TARGET_CPU_FP16) != targets.end());
+
+    RNG& rng = theRNG();
+    std::vector<LayerParams> params;
+    params.push_back(convParams("conv0", 3, 16, rng));
+    params.push_back(LayerParams());
+    params.back().name = "relu";
+    params.back().type = "ReLU";
+    params.push_back(convParams("dwconv", 1, 16, rng));
+    params.back().set("group", 16);
+    params.push_back(convParams("conv1", 16, 20, rng));
+    params.push_back(LayerParams());
+    params.back().name = "fc";
+    params.back().type = "InnerProduct";
+    params.back().set("num_output", 10);
+    params.back().set("bias_term", false);
+    params.back().blobs.push_back(Mat(10, 20*9*20, CV_32F));
+    rng.fill(params.back().blobs[0], RNG::UNIFORM, -0.05, 0.05);
+
+    Net net;
+    for (size_t i = 0; i < params.size(); i++)
+        net.addLayerToPrev(params[i].name, params[i].type, params[i]);
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+
+    int inpSize[] = {2, 3, 9, 20};
+    Mat inp(4, inpSize, CV_32F);
+    randu(inp, -1.0f, 1.0f);
+    net.setInput(inp);
+    Mat ref = net.forward().clone();
+
+    net.setPreferableTarget(DNN_TARGET_CPU_FP16);
+    Mat out = net.forward();
+    normAssert(ref, out, "CPU_FP16", 2e-3, 5e-3);
+
+    // the fp32 weights are restored back
+    net.setPreferableTarget(DNN_TARGET_CPU);
+    out = net.forward();
+    normAssert(ref, out, "CPU");
+}
+
 #ifdef HAVE_INF_ENGINE
 static const std::chrono::milliseconds async_timeout(10000);
 
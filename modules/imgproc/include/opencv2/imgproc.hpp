@@ -381,7 +381,12 @@ enum FloodFillFlags {
     /** If set, the function does not change the image ( newVal is ignored), and only fills the
     mask with the value specified in bits 8-16 of flags as described above. This option only make
     sense in function variants that have the mask parameter. */
-    FLOODFILL_MASK_ONLY   = 1 << 17
+    FLOODFILL_MASK_ONLY   = 1 << 17,
+    /** If set, large components are filled by several threads, band by band. The filled domain is
+    the same as without the flag. It only has effect on the fills that do not depend on the filling
+    order, that is, the fixed range fills and the fills of the pixels equal to the seed pixel (zero
+    loDiff and upDiff, no mask). Other fills are performed sequentially. */
+    FLOODFILL_PARALLEL    = 1 << 18
 };
 
 //! @} imgproc_misc
@@ -2790,6 +2795,95 @@ CV_EXPORTS_W void integral( InputArray src, OutputArray sum, int sdepth = -1 );
 CV_EXPORTS_AS(integral2) void integral( InputArray src, OutputArray sum,
                                         OutputArray sqsum, int sdepth = -1, int sqdepth = -1 );
 
+//! Tables of cv::IntegralImage in addition to the sum
+enum IntegralImageFlags {
+    INTEGRAL_SQSUM  = 1, //!< integral of the squared pixel values
+    INTEGRAL_TILTED = 2  //!< integral of the image rotated by 45 degrees
+};
+
+/** @brief Integral images that are updated incrementally.
+
+The object keeps the tables computed by #integral (the sum, and optionally the squared sum and the
+tilted sum, all of them in one pass over the pixels) and updates them when the image changes:
+
+- IntegralImage::update recomputes only the part of the tables that depends on a changed region of the
+  image: the rows of the region and the columns right of it for the sums (the rows below get a constant
+  correction), and the cone below the region for the tilted sum.
+- IntegralImage::append adds rows at the bottom of the image, e.g. lines of a line-scan camera. In the
+  rolling mode (windowRows > 0) only the last windowRows image rows are kept, so the memory stays
+  O(width*windowRows) for an endless stream of rows.
+
+In the rolling mode the first row of the tables is not necessarily zero: the tables are integrals starting
+from an earlier row, which is dropped later. The sums over rectangles (and over rotated rectangles in the
+tilted table) within the kept rows are not affected by it. The rows are numbered with 64-bit counters, see
+IntegralImage::getFirstRow, and the row coordinates of the rectangles are relative to the first kept row.
+
+@sa integral
+ */
+class CV_EXPORTS_W IntegralImage : public Algorithm
+{
+public:
+    /** @brief Computes the tables of the whole image, replacing the previous content.
+
+    @param image Input image, 8-bit or floating-point (32f or 64f), see #integral.
+     */
+    CV_WRAP virtual void compute(InputArray image) = 0;
+
+    /** @brief Updates the tables after the pixels of the image in roi have changed.
+
+    Not available in the rolling mode.
+    @param image The whole image after the change, of the same size and type as before.
+    @param roi Changed region of the image.
+     */
+    CV_WRAP virtual void update(InputArray image, const Rect& roi) = 0;
+
+    /** @brief Appends rows at the bottom of the image.
+
+    @param rows Rows of the same width and type as the image. The first call defines the width and the type.
+     */
+    CV_WRAP virtual void append(InputArray rows) = 0;
+
+    /** @brief Returns the integral of the kept image rows, see #integral.
+
+    The returned matrices share the data with the object, they are changed by the following updates.
+     */
+    CV_WRAP virtual void getSum(OutputArray sum) const = 0;
+    //! Returns the integral of the squared pixel values, see IntegralImage::getSum
+    CV_WRAP virtual void getSqsum(OutputArray sqsum) const = 0;
+    //! Returns the integral of the image rotated by 45 degrees, see IntegralImage::getSum
+    CV_WRAP virtual void getTilted(OutputArray tilted) const = 0;
+
+    /** @brief Returns the sum of the pixels in the rectangle.
+
+    @param rect Rectangle within the kept rows. Its rows are counted from the first kept row, so they are
+    image coordinates unless in the rolling mode, where the image row y is y - getFirstRow().
+     */
+    CV_WRAP virtual Scalar sum(const Rect& rect) const = 0;
+    //! Returns the sum of the squared pixel values in the rectangle, see IntegralImage::sum
+    CV_WRAP virtual Scalar sqsum(const Rect& rect) const = 0;
+
+    //! Returns the image row matching the first row of the tables
+    CV_WRAP virtual int64 getFirstRow() const = 0;
+    //! Returns the number of image rows processed so far
+    CV_WRAP virtual int64 getRows() const = 0;
+
+    /** @brief Sets the number of image rows processed so far, e.g. to continue the numbering of a line counter.
+
+    Only available in the rolling mode. The kept rows are dropped, the next appended row gets the index rows.
+     */
+    CV_WRAP virtual void setRows(int64 rows) = 0;
+};
+
+/** @brief Creates an IntegralImage.
+
+@param flags Tables computed in addition to the sum, a combination of #IntegralImageFlags.
+@param sdepth Depth of the sum and the tilted sum, see #integral.
+@param sqdepth Depth of the squared sum, see #integral.
+@param windowRows Number of the last image rows kept in the rolling mode, 0 to keep the whole image.
+ */
+CV_EXPORTS_W Ptr<IntegralImage> createIntegralImage(int flags = 0, int sdepth = -1, int sqdepth = -1,
+                                                    int windowRows = 0);
+
 //! @} imgproc_misc
 
 //! @addtogroup imgproc_motion
@@ -3307,9 +3401,13 @@ regions.
 (-1's pixels); for example, they can touch each other in the initial marker image passed to the
 function.
 
-@param image Input 8-bit 3-channel image.
+A batch of images can be passed as a vector of images together with a vector of markers of the
+same length. The images are then segmented in parallel, each one with the same result as a separate
+call.
+
+@param image Input 8-bit 3-channel image, or a vector of such images.
 @param markers Input/output 32-bit single-channel image (map) of markers. It should have the same
-size as image .
+size as image . For a batch, a vector of marker images, one per image.
 
 @sa findContours
  */
@@ -3561,6 +3659,32 @@ CV_EXPORTS int floodFill( InputOutputArray image,
                           Scalar loDiff = Scalar(), Scalar upDiff = Scalar(),
                           int flags = 4 );
 
+/** @brief Fills the connected components of several seed points.
+
+The function gives the same result as calling floodFill for every seed point in order, with the
+same image, mask and parameters, but validates the arguments, prepares the mask and allocates the
+internal buffers only once. It is intended for the cases where many small components are filled in
+one image, for example when labeling regions.
+
+@param image Input/output 1- or 3-channel, 8-bit, or floating-point image, see floodFill.
+@param mask Operation mask, see floodFill. It may be empty.
+@param seedPoints Starting points, filled in order.
+@param newVals New values of the repainted domains, either one for every seed point or a single
+value used for all of them.
+@param areas Optional output vector of the number of pixels repainted from every seed point. A seed
+point that belongs to an already repainted domain may repaint no pixels.
+@param rects Optional output vector of the minimum bounding rectangles of the repainted domains.
+@param loDiff Maximal lower brightness/color difference, see floodFill.
+@param upDiff Maximal upper brightness/color difference, see floodFill.
+@param flags Operation flags, see floodFill and #FloodFillFlags.
+@return The total number of repainted pixels.
+ */
+CV_EXPORTS int floodFill( InputOutputArray image, InputOutputArray mask,
+                          const std::vector<Point>& seedPoints, const std::vector<Scalar>& newVals,
+                          OutputArray areas = noArray(), OutputArray rects = noArray(),
+                          Scalar loDiff = Scalar(), Scalar upDiff = Scalar(),
+                          int flags = 4 );
+
 //! Performs linear blending of two images:
 //! \f[ \texttt{dst}(i,j) = \texttt{weights1}(i,j)*\texttt{src1}(i,j) + \texttt{weights2}(i,j)*\texttt{src2}(i,j) \f]
 //! @param src1 It has a type of CV_8UC(n) or CV_32FC(n), where n is a positive integer.
@@ -3693,6 +3817,40 @@ type for the input array should be either np.int32 or np.float32.
  */
 CV_EXPORTS_W Moments moments( InputArray array, bool binaryImage = false );
 
+/** @brief Calculates moments of a set of contours.
+
+The function computes the same moments as cv::moments does for every contour of the set. The
+contours are processed in parallel. Area and centroid of a contour are given by
+\f$|m_{00}|\f$ and \f$(m_{10}/m_{00}, m_{01}/m_{00})\f$ of its moments.
+
+@param contours Input contours, each one is stored as a vector or a \f$N \times 1\f$ array of
+2D points (Point or Point2f), e.g. the output of findContours.
+@param moments Output moments, one per contour.
+@param boundingRects Optional output bounding rectangles (std::vector<Rect>), one per contour.
+
+@sa moments, boundingRect, labelsMoments
+ */
+CV_EXPORTS void contoursMoments( InputArrayOfArrays contours, std::vector<Moments>& moments,
+                                 OutputArray boundingRects = noArray() );
+
+/** @brief Calculates moments of all regions of a label image in a single pass.
+
+For every label \f$l\f$ the function computes the moments of the binary mask `labels == l`. The
+image is scanned once by horizontal runs of equal labels, which are accumulated with closed-form
+sums, so the cost does not depend on the number of labels. It complements
+connectedComponentsWithStats with the higher order and central moments of the components.
+
+@param labels Single-channel 8-bit, 16-bit unsigned or 32-bit signed label image, e.g. the output
+of connectedComponents or watershed. Pixels with labels outside of [0, nlabels) are ignored.
+@param moments Output moments, one per label. Labels not present in the image get zero moments.
+@param boundingRects Optional output bounding rectangles (std::vector<Rect>), one per label.
+@param nlabels Number of labels. If it is negative, the maximum label plus one is used.
+
+@sa moments, contoursMoments, connectedComponentsWithStats
+ */
+CV_EXPORTS void labelsMoments( InputArray labels, std::vector<Moments>& moments,
+                               OutputArray boundingRects = noArray(), int nlabels = -1 );
+
 /** @brief Calculates seven Hu invariants.
 
 The function calculates seven Hu invariants (introduced in @cite Hu62; see also
@@ -3798,6 +3956,50 @@ is \f$W \times H\f$ and templ is \f$w \times h\f$ , then result is \f$(W-w+1) \t
 CV_EXPORTS_W void matchTemplate( InputArray image, InputArray templ,
                                  OutputArray result, int method, InputArray mask = noArray() );
 
+/** @brief Template matcher, which keeps the spectra and the normalization terms of its templates.
+
+The matcher computes the same maps as #matchTemplate (without mask) for one or several templates.
+The spectra of the templates are computed once per image size and reused while the size of the
+matched images does not change, which is the case for video frames. The image blocks are processed
+in parallel. When several templates are matched at once by TemplateMatcher::matchAll, they share the
+spectra and the integrals of the image.
+
+The matcher can be used from several threads simultaneously.
+ */
+class CV_EXPORTS_W TemplateMatcher : public Algorithm
+{
+public:
+    /** @brief Compares the template against overlapped image regions.
+
+    @param image Image where the search is running. It must have the same type as the templates and
+    must not be smaller than any of them.
+    @param result Map of comparison results, see #matchTemplate.
+    @param index Index of the template.
+     */
+    CV_WRAP virtual void match(InputArray image, OutputArray result, int index = 0) = 0;
+
+    /** @brief Compares all the templates against overlapped image regions.
+
+    @param image Image where the search is running, see TemplateMatcher::match.
+    @param results Vector of maps of comparison results, one per template.
+     */
+    CV_WRAP virtual void matchAll(InputArray image, OutputArrayOfArrays results) = 0;
+
+    //! Returns the comparison method, see #TemplateMatchModes
+    CV_WRAP virtual int getMethod() const = 0;
+
+    //! Returns the number of templates
+    CV_WRAP virtual int getTemplatesCount() const = 0;
+};
+
+/** @brief Creates a TemplateMatcher.
+
+@param templs Searched template or a vector of templates. The templates must be 8-bit or 32-bit
+floating-point and have the same type, their sizes may differ.
+@param method Parameter specifying the comparison method, see #TemplateMatchModes
+ */
+CV_EXPORTS_W Ptr<TemplateMatcher> createTemplateMatcher(InputArrayOfArrays templs, int method);
+
 //! @}
 
 //! @addtogroup imgproc_shape
@@ -3887,6 +4089,9 @@ The function retrieves contours from the binary image using the algorithm @cite
 are a useful tool for shape analysis and object detection and recognition. See squares.cpp in the
 OpenCV sample directory.
 @note Since opencv 3.2 source image is not modified by this function.
+@note Large 8-bit images (1 Mpixel and more, see OPENCV_FINDCONTOURS_PARALLEL_MIN_PIXELS) are processed
+by horizontal bands in parallel when several threads are available. The contours, their order and
+the hierarchy are the same as of the single-threaded processing.
 
 @param image Source, an 8-bit single-channel image. Non-zero pixels are treated as 1's. Zero
 pixels remain 0's, so the image is treated as binary . You can use #compare, #inRange, #threshold ,
@@ -4785,6 +4990,68 @@ CV_EXPORTS_W double getFontScaleFromHeight(const int fontFace,
                                            const int pixelHeight,
                                            const int thickness = 1);
 
+/** @brief Collects drawing primitives and renders them in a single call.
+
+The primitives are drawn in the order they were added, and the result is the same as of the
+corresponding sequence of cv::line, cv::rectangle, cv::circle and cv::putText calls. The image is
+split into horizontal bands that are rendered in parallel, each band rasterizes only the primitives
+that overlap it. This is intended for overlays with many small primitives, e.g. detection boxes
+with labels:
+
+@code{.cpp}
+DrawingBatch batch;
+for (size_t i = 0; i < boxes.size(); i++)
+{
+    batch.rectangle(boxes[i], Scalar(0, 255, 0), 2);
+    batch.putText(labels[i], boxes[i].tl() - Point(0, 4), FONT_HERSHEY_SIMPLEX, 0.5, Scalar(0, 255, 0));
+}
+batch.draw(frame);
+@endcode
+
+The batch does not depend on the image, so it can be drawn into several images.
+*/
+class CV_EXPORTS_W DrawingBatch
+{
+public:
+    CV_WRAP DrawingBatch();
+
+    /** @brief Adds a line segment, see cv::line */
+    CV_WRAP void line(Point pt1, Point pt2, const Scalar& color,
+                      int thickness = 1, int lineType = LINE_8, int shift = 0);
+
+    /** @brief Adds a rectangle, see cv::rectangle */
+    CV_WRAP void rectangle(Rect rec, const Scalar& color,
+                           int thickness = 1, int lineType = LINE_8, int shift = 0);
+
+    /** @brief Adds rectangles drawn with the same color and style, see cv::rectangle */
+    CV_WRAP void rectangles(const std::vector<Rect>& recs, const Scalar& color,
+                            int thickness = 1, int lineType = LINE_8, int shift = 0);
+
+    /** @brief Adds a circle, see cv::circle */
+    CV_WRAP void circle(Point center, int radius, const Scalar& color,
+                        int thickness = 1, int lineType = LINE_8, int shift = 0);
+
+    /** @brief Adds a text string, see cv::putText */
+    CV_WRAP void putText(const String& text, Point org, int fontFace, double fontScale, Scalar color,
+                         int thickness = 1, int lineType = LINE_8, bool bottomLeftOrigin = false);
+
+    /** @brief Removes all the primitives */
+    CV_WRAP void clear();
+
+    /** @brief Returns the number of primitives */
+    CV_WRAP size_t size() const;
+
+    /** @brief Draws all the primitives into the image
+
+    @param img Image, of any type accepted by the individual drawing functions.
+    */
+    CV_WRAP void draw(InputOutputArray img) const;
+
+    struct Impl;
+protected:
+    Ptr<Impl> p;
+};
+
 /** @brief Line iterator
 
 The class is used to iterate over all the pixels on the raster line
@@ -84,6 +84,42 @@ PERF_TEST_P(TestFindContoursFF, findContours,
     SANITY_CHECK_NOTHING();
 }
 
+typedef TestBaseWithParam< tuple<Size, RetrMode, bool> > TestFindContoursParallel;
+
+// large masks: the serial scanner (single thread) vs the band-parallel one
+PERF_TEST_P(TestFindContoursParallel, findContours,
+    Combine(
+        Values(sz1080p, sz2160p), // image size
+        RetrMode::all(), // retrieval mode
+        testing::Bool() // parallel
+    )
+)
+{
+    Size img_size = get<0>(GetParam());
+    int retr_mode = get<1>(GetParam());
+    bool parallel = get<2>(GetParam());
+
+    RNG rng;
+    Mat img = Mat::zeros(img_size, CV_8UC1);
+    // a large part with holes, which crosses all the bands, and small blobs around
+    ellipse(img, Point(img.cols/2, img.rows/2), Size(img.cols/3, img.rows*2/5), 0., 0., 360., Scalar(255), -1);
+    for (int i = 0; i < img_size.area() / 4000; i++)
+    {
+        Point center((unsigned)rng % img.cols, (unsigned)rng % img.rows);
+        Size axes(((unsigned)rng % 49 + 2)/2, ((unsigned)rng % 49 + 2)/2);
+        ellipse(img, center, axes, (unsigned)rng % 180, 0., 360., Scalar(i % 2 ? 0 : 255), -1);
+    }
+    vector< vector<Point> > contours;
+    vector<Vec4i> hierarchy;
+
+    if (!parallel)
+        declare.tbb_threads(1);
+
+    TEST_CYCLE() findContours( img, contours, hierarchy, retr_mode, CHAIN_APPROX_SIMPLE );
+
+    SANITY_CHECK_NOTHING();
+}
+
 typedef TestBaseWithParam< tuple<MatDepth, int> > TestBoundingRect;
 
 PERF_TEST_P(TestBoundingRect, BoundingRect,
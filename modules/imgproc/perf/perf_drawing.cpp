@@ -0,0 +1,84 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "perf_precomp.hpp"
+
+namespace opencv_test {
+
+// an overlay of detection boxes with labels
+static void makeDetections(int n, Size sz, std::vector<Rect>& boxes, std::vector<String>& labels)
+{
+    RNG rng(12345);
+    boxes.resize(n);
+    labels.resize(n);
+    for (int i = 0; i < n; i++)
+    {
+        Size boxSize(rng.uniform(20, 200), rng.uniform(20, 200));
+        boxes[i] = Rect(Point(rng.uniform(0, sz.width - boxSize.width), rng.uniform(20, sz.height - boxSize.height)), boxSize);
+        labels[i] = cv::format("person %d%%", rng.uniform(50, 100));
+    }
+}
+
+typedef perf::TestBaseWithParam<tuple<int, int> > Drawing_Detections;
+
+PERF_TEST_P_(Drawing_Detections, batch)
+{
+    int n = get<0>(GetParam()), lineType = get<1>(GetParam());
+    Mat img(sz1080p, CV_8UC3, Scalar::all(0));
+    std::vector<Rect> boxes;
+    std::vector<String> labels;
+    makeDetections(n, img.size(), boxes, labels);
+
+    TEST_CYCLE()
+    {
+        DrawingBatch batch;
+        batch.rectangles(boxes, Scalar(0, 255, 0), 2, lineType);
+        for (int i = 0; i < n; i++)
+            batch.putText(labels[i], boxes[i].tl() - Point(0, 4), FONT_HERSHEY_SIMPLEX, 0.5, Scalar(0, 255, 0), 1, lineType);
+        batch.draw(img);
+    }
+
+    SANITY_CHECK_NOTHING();
+}
+
+PERF_TEST_P_(Drawing_Detections, sequential)
+{
+    int n = get<0>(GetParam()), lineType = get<1>(GetParam());
+    Mat img(sz1080p, CV_8UC3, Scalar::all(0));
+    std::vector<Rect> boxes;
+    std::vector<String> labels;
+    makeDetections(n, img.size(), boxes, labels);
+
+    TEST_CYCLE()
+    {
+        for (int i = 0; i < n; i++)
+        {
+            rectangle(img, boxes[i], Scalar(0, 255, 0), 2, lineType);
+            putText(img, labels[i], boxes[i].tl() - Point(0, 4), FONT_HERSHEY_SIMPLEX, 0.5, Scalar(0, 255, 0), 1, lineType);
+        }
+    }
+
+    SANITY_CHECK_NOTHING();
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Drawing_Detections, testing::Combine(
+    testing::Values(100, 1000),
+    testing::Values((int)LINE_8, (int)LINE_AA)
+));
+
+PERF_TEST_P(Size_MatType, fillRectangle, testing::Combine(
+    testing::Values(szVGA, sz1080p),
+    testing::Values(CV_8UC1, CV_8UC3, CV_8UC4)
+))
+{
+    Size sz = get<0>(GetParam());
+    int type = get<1>(GetParam());
+    Mat img(sz, type, Scalar::all(0));
+
+    TEST_CYCLE() rectangle(img, Rect(Point(1, 1), sz - Size(2, 2)), Scalar(10, 20, 30, 40), FILLED);
+
+    SANITY_CHECK_NOTHING();
+}
+
+} // namespace
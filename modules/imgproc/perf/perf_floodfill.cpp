@@ -67,4 +67,76 @@ PERF_TEST_P(Size_Source_Fl, floodFill1, Combine(
     SANITY_CHECK_NOTHING();
 }
 
+typedef perf::TestBaseWithParam<bool> FloodFill_Seeds;
+
+PERF_TEST_P(FloodFill_Seeds, multipleSeeds, testing::Bool())
+{
+    bool batch = GetParam();
+    Mat image0(480, 640, CV_8UC1, Scalar::all(0)), image;
+    RNG& rng = theRNG();
+    std::vector<Point> seeds;
+    std::vector<Scalar> vals;
+    for (int i = 0; i < 2000; i++)
+    {
+        Point pt(rng.uniform(0, image0.cols), rng.uniform(0, image0.rows));
+        circle(image0, pt, 5, Scalar::all(255), 1);
+        seeds.push_back(pt);
+        vals.push_back(Scalar::all(i % 200 + 1));
+    }
+    Mat mask0 = Mat::zeros(image0.rows + 2, image0.cols + 2, CV_8UC1), mask;
+    int flags = 4 | FLOODFILL_FIXED_RANGE;
+
+    for (; next(); )
+    {
+        image0.copyTo(image);
+        mask0.copyTo(mask);
+        startTimer();
+        if (batch)
+            cv::floodFill(image, mask, seeds, vals, noArray(), noArray(), Scalar::all(2), Scalar::all(2), flags);
+        else
+        {
+            for (size_t i = 0; i < seeds.size(); i++)
+                cv::floodFill(image, mask, seeds[i], vals[i], 0, Scalar::all(2), Scalar::all(2), flags);
+        }
+        stopTimer();
+    }
+    SANITY_CHECK_NOTHING();
+}
+
+typedef tuple<Size, bool, bool> Size_FixedRange_Parallel_t;
+typedef perf::TestBaseWithParam<Size_FixedRange_Parallel_t> Size_FixedRange_Parallel;
+
+PERF_TEST_P(Size_FixedRange_Parallel, floodFillLarge, Combine(
+    testing::Values(sz1080p, sz2160p),
+    testing::Bool(), // fixed range or simple fill
+    testing::Bool()  // parallel
+    ))
+{
+    Size sz = get<0>(GetParam());
+    bool fixedRange = get<1>(GetParam());
+    bool parallel = get<2>(GetParam());
+
+    // a large component with obstacles
+    Mat image0(sz, CV_8UC1, Scalar::all(10)), image;
+    RNG& rng = theRNG();
+    for (int i = 0; i < sz.area() / 20000; i++)
+        circle(image0, Point(rng.uniform(100, sz.width), rng.uniform(100, sz.height)), rng.uniform(5, 50), Scalar::all(200), 2);
+    Mat mask;
+    int flags = 4 | (fixedRange ? FLOODFILL_FIXED_RANGE : 0) | (parallel ? FLOODFILL_PARALLEL : 0);
+    Scalar diff = fixedRange ? Scalar::all(5) : Scalar();
+    int area = 0;
+
+    for (; next(); )
+    {
+        image0.copyTo(image);
+        if (fixedRange)
+            mask = Mat::zeros(sz.height + 2, sz.width + 2, CV_8UC1);
+        startTimer();
+        area = cv::floodFill(image, mask, Point(0, 0), Scalar::all(100), 0, diff, diff, flags);
+        stopTimer();
+    }
+    EXPECT_GT(area, sz.area() / 2);
+    SANITY_CHECK_NOTHING();
+}
+
 } // namespace
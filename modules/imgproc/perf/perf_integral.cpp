@@ -136,4 +136,54 @@ PERF_TEST_P( Size_MatType_OutMatDepth, integral_sqsum_tilted,
     SANITY_CHECK(tilted, 1e-6, tilted.depth() > CV_32S ? ERROR_RELATIVE : ERROR_ABSOLUTE);
 }
 
+typedef perf::TestBaseWithParam<tuple<Size, MatType, int> > IntegralImage_update;
+
+PERF_TEST_P(IntegralImage_update, roi,
+            testing::Combine(
+                testing::Values(szVGA, sz1080p),
+                testing::Values(CV_8UC1, CV_8UC3),
+                testing::Values(16, 64)
+                )
+            )
+{
+    Size sz = get<0>(GetParam());
+    int matType = get<1>(GetParam());
+    int roiSize = get<2>(GetParam());
+
+    Mat src(sz, matType);
+    declare.in(src, WARMUP_RNG);
+    Ptr<IntegralImage> ii = createIntegralImage(INTEGRAL_SQSUM);
+    ii->compute(src);
+    Rect roi(sz.width - roiSize*2, sz.height - roiSize*2, roiSize, roiSize);
+
+    TEST_CYCLE() ii->update(src, roi);
+
+    SANITY_CHECK_NOTHING();
+}
+
+typedef perf::TestBaseWithParam<tuple<Size, MatType> > IntegralImage_rolling;
+
+PERF_TEST_P(IntegralImage_rolling, appendRow,
+            testing::Combine(
+                testing::Values(szVGA, sz1080p),
+                testing::Values(CV_8UC1, CV_8UC3)
+                )
+            )
+{
+    Size sz = get<0>(GetParam());
+    int matType = get<1>(GetParam());
+
+    Mat src(sz, matType);
+    declare.in(src, WARMUP_RNG);
+    Ptr<IntegralImage> ii = createIntegralImage(INTEGRAL_SQSUM, -1, -1, 32);
+
+    TEST_CYCLE()
+    {
+        for (int y = 0; y < sz.height; y++)
+            ii->append(src.row(y));
+    }
+
+    SANITY_CHECK_NOTHING();
+}
+
 } // namespace
@@ -0,0 +1,55 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "perf_precomp.hpp"
+
+namespace opencv_test {
+
+typedef perf::TestBaseWithParam<Size> LSDFixture;
+
+PERF_TEST_P(LSDFixture, detect, testing::Values(szVGA, sz1080p, sz2160p))
+{
+    Size sz = GetParam();
+    Mat image(sz, CV_8UC1, Scalar::all(40));
+    RNG& rng = theRNG();
+    for (int i = 0; i < 200; i++)
+        line(image, Point(rng.uniform(0, sz.width), rng.uniform(0, sz.height)),
+             Point(rng.uniform(0, sz.width), rng.uniform(0, sz.height)), Scalar::all(200), 3);
+    Mat noise(sz, CV_8UC1);
+    randu(noise, 0, 16);
+    image += noise;
+
+    Ptr<LineSegmentDetector> detector = createLineSegmentDetector();
+    std::vector<Vec4f> lines;
+
+    TEST_CYCLE() detector->detect(image, lines);
+
+    SANITY_CHECK_NOTHING();
+}
+
+PERF_TEST(GeneralizedHoughBallard, detect)
+{
+    Mat templ = Mat::zeros(64, 64, CV_8UC1);
+    circle(templ, Point(32, 32), 20, Scalar::all(255), FILLED);
+    rectangle(templ, Rect(8, 28, 48, 8), Scalar::all(255), FILLED);
+
+    Mat image = Mat::zeros(sz1080p, CV_8UC1);
+    RNG& rng = theRNG();
+    for (int i = 0; i < 40; i++)
+    {
+        Rect r(rng.uniform(0, image.cols - templ.cols), rng.uniform(0, image.rows - templ.rows), templ.cols, templ.rows);
+        templ.copyTo(image(r), templ);
+    }
+
+    Ptr<GeneralizedHoughBallard> alg = createGeneralizedHoughBallard();
+    alg->setTemplate(templ);
+    alg->setVotesThreshold(60);
+    std::vector<Vec4f> positions;
+
+    TEST_CYCLE() alg->detect(image, positions);
+
+    SANITY_CHECK_NOTHING();
+}
+
+} // namespace
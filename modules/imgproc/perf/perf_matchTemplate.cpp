@@ -81,4 +81,63 @@ PERF_TEST_P(ImgSize_TmplSize_Method, matchTemplateBig,
     SANITY_CHECK(result, eps);
 }
 
+typedef tuple<MethodType, int> Method_TemplatesCount_t;
+typedef perf::TestBaseWithParam<Method_TemplatesCount_t> Method_TemplatesCount;
+
+// a set of fiducial templates matched against a frame: separate matchTemplate calls vs a cached matcher
+PERF_TEST_P(Method_TemplatesCount, matchTemplateLoop,
+            testing::Combine(
+                testing::Values(TM_CCORR, TM_CCOEFF_NORMED),
+                testing::Values(1, 4)
+                )
+    )
+{
+    int method = get<0>(GetParam());
+    int count = get<1>(GetParam());
+
+    Mat img(cv::Size(1280, 1024), CV_8UC1);
+    std::vector<Mat> templs(count);
+    std::vector<Mat> results(count);
+    declare.in(img, WARMUP_RNG);
+    for (int i = 0; i < count; i++)
+    {
+        templs[i].create(cv::Size(48, 48), CV_8UC1);
+        declare.in(templs[i], WARMUP_RNG);
+    }
+
+    TEST_CYCLE()
+    {
+        for (int i = 0; i < count; i++)
+            matchTemplate(img, templs[i], results[i], method);
+    }
+
+    SANITY_CHECK_NOTHING();
+}
+
+PERF_TEST_P(Method_TemplatesCount, TemplateMatcher,
+            testing::Combine(
+                testing::Values(TM_CCORR, TM_CCOEFF_NORMED),
+                testing::Values(1, 4)
+                )
+    )
+{
+    int method = get<0>(GetParam());
+    int count = get<1>(GetParam());
+
+    Mat img(cv::Size(1280, 1024), CV_8UC1);
+    std::vector<Mat> templs(count);
+    std::vector<Mat> results;
+    declare.in(img, WARMUP_RNG);
+    for (int i = 0; i < count; i++)
+    {
+        templs[i].create(cv::Size(48, 48), CV_8UC1);
+        declare.in(templs[i], WARMUP_RNG);
+    }
+    Ptr<TemplateMatcher> matcher = createTemplateMatcher(templs, method);
+
+    TEST_CYCLE() matcher->matchAll(img, results);
+
+    SANITY_CHECK_NOTHING();
+}
+
 } // namespace
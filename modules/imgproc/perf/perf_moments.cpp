@@ -38,4 +38,37 @@ PERF_TEST_P(MomentsFixture_val, Moments1,
     SANITY_CHECK_MOMENTS(m, 2e-4, ERROR_RELATIVE);
 }
 
+typedef perf::TestBaseWithParam<Size> LabelsMomentsFixture;
+
+PERF_TEST_P(LabelsMomentsFixture, labelsMoments, testing::Values(sz720p, sz1080p))
+{
+    Size srcSize = GetParam();
+    Mat src(srcSize, CV_8UC1), labels;
+    declare.in(src, WARMUP_RNG);
+    cv::threshold(src, src, 200, 255, THRESH_BINARY);
+    int n = connectedComponents(src, labels, 8, CV_32S);
+
+    std::vector<Moments> ms;
+    std::vector<Rect> rects;
+    TEST_CYCLE() labelsMoments(labels, ms, rects, n);
+
+    SANITY_CHECK_NOTHING();
+}
+
+PERF_TEST_P(LabelsMomentsFixture, contoursMoments, testing::Values(sz720p, sz1080p))
+{
+    Size srcSize = GetParam();
+    Mat src(srcSize, CV_8UC1);
+    declare.in(src, WARMUP_RNG);
+    cv::threshold(src, src, 200, 255, THRESH_BINARY);
+    std::vector<std::vector<Point> > contours;
+    findContours(src, contours, RETR_LIST, CHAIN_APPROX_NONE);
+
+    std::vector<Moments> ms;
+    std::vector<Rect> rects;
+    TEST_CYCLE() contoursMoments(contours, ms, rects);
+
+    SANITY_CHECK_NOTHING();
+}
+
 } // namespace
@@ -0,0 +1,53 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "perf_precomp.hpp"
+
+namespace opencv_test {
+
+typedef perf::TestBaseWithParam<tuple<Size, int> > Size_MaxLevel;
+
+PERF_TEST_P(Size_MaxLevel, pyrMeanShiftFiltering,
+            testing::Combine(testing::Values(szVGA, sz720p), testing::Values(0, 1)))
+{
+    Size sz = get<0>(GetParam());
+    int maxLevel = get<1>(GetParam());
+
+    Mat src(sz, CV_8UC3), dst(sz, CV_8UC3);
+    declare.in(src, WARMUP_RNG).out(dst);
+    GaussianBlur(src, src, Size(0, 0), 3);
+
+    TEST_CYCLE() pyrMeanShiftFiltering(src, dst, 10, 20, maxLevel);
+
+    SANITY_CHECK_NOTHING();
+}
+
+typedef perf::TestBaseWithParam<int> BatchSize;
+
+PERF_TEST_P(BatchSize, watershed, testing::Values(1, 8))
+{
+    int n = GetParam();
+    RNG& rng = theRNG();
+    std::vector<Mat> imgs(n), markers0(n), markers(n);
+    for (int i = 0; i < n; i++)
+    {
+        imgs[i].create(szVGA, CV_8UC3);
+        declare.in(imgs[i], WARMUP_RNG);
+        GaussianBlur(imgs[i], imgs[i], Size(0, 0), 3);
+        markers0[i] = Mat::zeros(szVGA, CV_32SC1);
+        for (int k = 1; k <= 50; k++)
+            circle(markers0[i], Point(rng.uniform(0, szVGA.width), rng.uniform(0, szVGA.height)), 3, Scalar::all(k), FILLED);
+    }
+
+    TEST_CYCLE()
+    {
+        for (int i = 0; i < n; i++)
+            markers0[i].copyTo(markers[i]);
+        watershed(imgs, markers);
+    }
+
+    SANITY_CHECK_NOTHING();
+}
+
+} // namespace
@@ -242,4 +242,50 @@ PERF_TEST_P(Size_MatType_dx_dy_Border3x3ROI, scharrViaSobelFilter,
     SANITY_CHECK(dst);
 }
 
+typedef tuple<Size, MatType, int> Size_MatType_KSize_t;
+typedef perf::TestBaseWithParam<Size_MatType_KSize_t> Size_MatType_KSize;
+
+PERF_TEST_P(Size_MatType_KSize, sepFilter2D_ksize,
+            testing::Combine(
+                testing::Values(sz1080p),
+                testing::Values(CV_8UC1, CV_32FC1, CV_32FC3),
+                testing::Values(3, 5, 7, 9, 11)
+            )
+          )
+{
+    Size size = get<0>(GetParam());
+    int type = get<1>(GetParam());
+    int ksize = get<2>(GetParam());
+
+    Mat src(size, type), dst(size, type);
+    Mat kernel = getGaussianKernel(ksize, 0, CV_32F);
+
+    declare.in(src, WARMUP_RNG).out(dst);
+
+    TEST_CYCLE() sepFilter2D(src, dst, -1, kernel, kernel);
+
+    SANITY_CHECK_NOTHING();
+}
+
+PERF_TEST_P(Size_MatType_KSize, sobelFilter_ksize,
+            testing::Combine(
+                testing::Values(sz1080p),
+                testing::Values(CV_16S, CV_32F),
+                testing::Values(5, 7)
+            )
+          )
+{
+    Size size = get<0>(GetParam());
+    int ddepth = get<1>(GetParam());
+    int ksize = get<2>(GetParam());
+
+    Mat src(size, CV_8U), dst(size, ddepth);
+
+    declare.in(src, WARMUP_RNG).out(dst);
+
+    TEST_CYCLE() Sobel(src, dst, ddepth, 1, 0, ksize);
+
+    SANITY_CHECK_NOTHING();
+}
+
 } // namespace
@@ -40,6 +40,9 @@
 //M*/
 #include "precomp.hpp"
 #include "opencv2/core/hal/intrin.hpp"
+#include "opencv2/core/utils/configuration.private.hpp"
+
+#include <map>
 
 using namespace cv;
 
@@ -1816,6 +1819,357 @@ cvFindContours( void*  img,  CvMemStorage*  storage,
     return cvFindContours_Impl(img, storage, firstContour, cntHeaderSize, mode, method, offset, 1);
 }
 
+/*
+   Parallel variant of the border following. The image is cut into horizontal bands
+   which are traced concurrently in the CV_RETR_TREE mode. The contours of the components
+   that do not touch a cut are final. The components crossing the cuts are traced once
+   more over the region they occupy, where all the other components are erased and every
+   erased subtree, which may be enclosed by them, is replaced by a single pixel placed at
+   its start point; this pixel receives the parent of the whole subtree. Since both passes
+   discover the contours in raster order, the result (including the order of contours and
+   the hierarchy of any retrieval mode) is the same as of the serial algorithm.
+*/
+namespace cv
+{
+
+struct ContourNode
+{
+    int64 key;                  /* raster position where the contour was discovered */
+    int parent;                 /* parent contour index, -1 for the frame */
+    bool is_hole;
+    Rect rect;                  /* bounding rectangle, bordered image coordinates */
+    Point pos;                  /* discovery position, bordered image coordinates */
+    std::vector<Point> pts;
+};
+
+/* traces all the contours of a bordered 0/1 image, appending them in discovery order */
+static void
+icvTraceContourTree( Mat& img, int method, Point offset, Point pos_offset,
+                     std::vector<ContourNode>& nodes )
+{
+    MemStorage storage(cvCreateMemStorage());
+    CvMat cimg = cvMat(img);
+    CvContourScanner scanner = cvStartFindContours_Impl( &cimg, storage, sizeof(CvContour),
+                                                         CV_RETR_TREE, method, cvPoint(offset), 0 );
+    try
+    {
+        for( int idx = 0;; idx++ )
+        {
+            CvSeq* seq = cvFindNextContour( scanner );
+            if( !seq )
+                break;
+            const _CvContourInfo* cinfo = scanner->l_cinfo;
+            ((CvContour*)seq)->color = idx;
+
+            nodes.push_back(ContourNode());
+            ContourNode& node = nodes.back();
+            node.is_hole = cinfo->is_hole != 0;
+            node.parent = cinfo->parent == &scanner->frame_info ? -1 :
+                ((CvContour*)cinfo->parent->contour)->color;
+            node.rect = Rect(cinfo->rect.x, cinfo->rect.y, cinfo->rect.width, cinfo->rect.height) + pos_offset;
+            node.pos = Point(cinfo->origin.x + cinfo->is_hole, cinfo->origin.y) + pos_offset;
+            node.key = 0;
+            node.pts.resize(seq->total);
+            if( seq->total > 0 )
+                cvCvtSeqToArray( seq, &node.pts[0] );
+        }
+    }
+    catch(...)
+    {
+        cvEndFindContours( &scanner );
+        throw;
+    }
+    cvEndFindContours( &scanner );
+}
+
+struct ContourBand
+{
+    int y0, y1;                 /* rows of the bordered image */
+    bool clear_above, clear_below;  /* no component crosses the cut */
+    std::vector<ContourNode> nodes;
+    std::vector<uchar> dirty;   /* the contour belongs to a component crossing a cut */
+};
+
+class FindContoursBandInvoker : public ParallelLoopBody
+{
+public:
+    FindContoursBandInvoker( Mat& _img, std::vector<ContourBand>& _bands, int _method, Point _offset )
+        : img(_img), bands(_bands), method(_method), offset(_offset) {}
+
+    void operator()( const Range& range ) const CV_OVERRIDE
+    {
+        for( int b = range.start; b < range.end; b++ )
+        {
+            ContourBand& band = bands[b];
+            int h = band.y1 - band.y0;
+            Mat buf(h + 2, img.cols, CV_8U);
+            buf.row(0).setTo(Scalar::all(0));
+            buf.row(h + 1).setTo(Scalar::all(0));
+            img.rowRange(band.y0, band.y1).copyTo(buf.rowRange(1, h + 1));
+
+            icvTraceContourTree( buf, method, offset + Point(0, band.y0 - 1),
+                                 Point(0, band.y0 - 1), band.nodes );
+
+            size_t i, n = band.nodes.size();
+            band.dirty.assign(n, 0);
+            for( i = 0; i < n; i++ )
+            {
+                const ContourNode& node = band.nodes[i];
+                if( node.is_hole )
+                    band.dirty[i] = band.dirty[node.parent];
+                else
+                    band.dirty[i] = (!band.clear_above && node.rect.y == band.y0) ||
+                                    (!band.clear_below && node.rect.y + node.rect.height == band.y1);
+            }
+        }
+    }
+
+private:
+    Mat& img;
+    std::vector<ContourBand>& bands;
+    int method;
+    Point offset;
+};
+
+/* erases the clean components within the region of crossing ones and puts the placeholders */
+class FindContoursEraseInvoker : public ParallelLoopBody
+{
+public:
+    FindContoursEraseInvoker( Mat& _img, std::vector<ContourBand>& _bands, Rect _inner )
+        : img(_img), bands(_bands), inner(_inner) {}
+
+    void operator()( const Range& range ) const CV_OVERRIDE
+    {
+        Rect outer(inner.x - 1, inner.y - 1, inner.width + 2, inner.height + 2);
+        for( int b = range.start; b < range.end; b++ )
+        {
+            const ContourBand& band = bands[b];
+            Mat rows = img.rowRange(band.y0, band.y1);
+            size_t i, n = band.nodes.size();
+            for( i = 0; i < n; i++ )
+            {
+                const ContourNode& node = band.nodes[i];
+                if( !node.is_hole && !band.dirty[i] && (node.rect & outer).area() > 0 )
+                    floodFill( rows, node.pos - Point(0, band.y0), Scalar::all(0), 0,
+                               Scalar(), Scalar(), 8 );
+            }
+            for( i = 0; i < n; i++ )
+            {
+                const ContourNode& node = band.nodes[i];
+                if( !node.is_hole && !band.dirty[i] && inner.contains(node.pos) &&
+                    (node.parent < 0 || band.dirty[node.parent]) )
+                    img.at<uchar>(node.pos) = 1;
+            }
+        }
+    }
+
+private:
+    Mat& img;
+    std::vector<ContourBand>& bands;
+    Rect inner;
+};
+
+static bool
+icvCompareContourKeys( const std::pair<int64, int>& a, const std::pair<int64, int>& b )
+{
+    return a.first > b.first;
+}
+
+/* image is the bordered copy of the source image */
+static bool
+icvFindContoursParallel( Mat& image, OutputArrayOfArrays _contours, OutputArray _hierarchy,
+                         int mode, int method, Point offset )
+{
+    static const size_t minPixels = utils::getConfigurationParameterSizeT(
+        "OPENCV_FINDCONTOURS_PARALLEL_MIN_PIXELS", (size_t)1 << 20);
+    const int minBandHeight = 64;
+
+    int nthreads = getNumThreads();
+    int height = image.rows - 2;
+    if( nthreads <= 1 || image.type() != CV_8UC1 || mode < CV_RETR_EXTERNAL || mode > CV_RETR_TREE ||
+        method < CV_CHAIN_APPROX_NONE || method > CV_CHAIN_APPROX_TC89_KCOS ||
+        (size_t)height * (image.cols - 2) < minPixels || height < minBandHeight * 2 )
+        return false;
+
+    threshold( image, image, 0, 1, THRESH_BINARY );
+
+    /* place the cuts right below empty rows where possible: nothing crosses such cuts */
+    int nbands = std::min(nthreads, height / minBandHeight);
+    int window = std::min(height / nbands / 4, 32);
+    std::vector<ContourBand> bands(nbands);
+    int y0 = 1;
+    bool clear = true;
+    for( int b = 0; b < nbands; b++ )
+    {
+        ContourBand& band = bands[b];
+        band.y0 = y0;
+        band.clear_above = clear;
+        int y1 = height + 1;
+        clear = true;
+        if( b < nbands - 1 )
+        {
+            y1 = 1 + (int)((int64)height * (b + 1) / nbands);
+            clear = false;
+            for( int d = 0; d <= window && !clear; d++ )
+            {
+                for( int s = -1; s <= 1 && !clear; s += 2 )
+                {
+                    int y = y1 - 1 + d*s;
+                    if( y > y0 && y < height && countNonZero(image.row(y)) == 0 )
+                    {
+                        y1 = y + 1;
+                        clear = true;
+                    }
+                }
+            }
+        }
+        band.y1 = y1;
+        band.clear_below = clear;
+        y0 = y1;
+    }
+
+    parallel_for_( Range(0, nbands), FindContoursBandInvoker(image, bands, method, offset) );
+
+    int b;
+    size_t i;
+    Rect inner;
+    for( b = 0; b < nbands; b++ )
+    {
+        const ContourBand& band = bands[b];
+        for( i = 0; i < band.nodes.size(); i++ )
+            if( band.dirty[i] && !band.nodes[i].is_hole )
+                inner = inner.area() > 0 ? (inner | band.nodes[i].rect) : band.nodes[i].rect;
+    }
+
+    /* retrace the crossing components */
+    std::vector<ContourNode> subnodes;
+    if( inner.area() > 0 )
+    {
+        parallel_for_( Range(0, nbands), FindContoursEraseInvoker(image, bands, inner) );
+
+        Rect roi(inner.x - 1, inner.y - 1, inner.width + 2, inner.height + 2);
+        Mat sub = image(roi);
+        icvTraceContourTree( sub, method, offset + roi.tl(), roi.tl(), subnodes );
+    }
+
+    /* gather the final contours; the parents of the erased subtrees are resolved below */
+    std::vector<ContourNode> nodes;
+    std::map<int64, int> placeholders;
+    int64 keyStep = image.cols;
+    for( b = 0; b < nbands; b++ )
+    {
+        ContourBand& band = bands[b];
+        std::vector<int> index(band.nodes.size(), -1);
+        for( i = 0; i < band.nodes.size(); i++ )
+        {
+            if( band.dirty[i] )
+                continue;
+            ContourNode& node = band.nodes[i];
+            int parent = node.parent;
+            index[i] = (int)nodes.size();
+            node.parent = parent >= 0 && !band.dirty[parent] ? index[parent] : -1;
+            node.key = node.pos.y * keyStep + node.pos.x;
+            if( !node.is_hole && (parent < 0 || band.dirty[parent]) && inner.contains(node.pos) )
+                placeholders[node.key] = index[i];
+            nodes.push_back(ContourNode());
+            std::swap(nodes.back(), node);
+        }
+    }
+
+    std::vector<int> subindex(subnodes.size(), -1);
+    for( i = 0; i < subnodes.size(); i++ )
+    {
+        ContourNode& node = subnodes[i];
+        int parent = node.parent >= 0 ? subindex[node.parent] : -1;
+        node.key = node.pos.y * keyStep + node.pos.x;
+        std::map<int64, int>::const_iterator it = node.is_hole ? placeholders.end() :
+            placeholders.find(node.key);
+        if( it != placeholders.end() )
+        {
+            nodes[it->second].parent = parent;
+            continue;
+        }
+        subindex[i] = (int)nodes.size();
+        node.parent = parent;
+        nodes.push_back(ContourNode());
+        std::swap(nodes.back(), node);
+    }
+
+    /* rebuild the tree of the requested mode: the serial scanner prepends every new contour
+       to the children of its parent, and the output is the depth-first traversal of the tree */
+    int total = (int)nodes.size();
+    std::vector<std::vector<std::pair<int64, int> > > children(total + 1);
+    for( int k = 0; k < total; k++ )
+    {
+        const ContourNode& node = nodes[k];
+        int parent = node.parent;
+        if( mode == CV_RETR_EXTERNAL && (parent >= 0 || node.is_hole) )
+            continue;
+        if( mode == CV_RETR_LIST || (mode == CV_RETR_CCOMP && !node.is_hole) )
+            parent = -1;
+        children[parent >= 0 ? parent : total].push_back(std::make_pair(node.key, k));
+    }
+
+    std::vector<int> order, pos(total, -1), stack;
+    order.reserve(total);
+    stack.push_back(total);
+    while( !stack.empty() )
+    {
+        int k = stack.back();
+        stack.pop_back();
+        if( k < total )
+        {
+            pos[k] = (int)order.size();
+            order.push_back(k);
+        }
+        std::vector<std::pair<int64, int> >& c = children[k];
+        std::sort(c.begin(), c.end(), icvCompareContourKeys);
+        for( size_t j = c.size(); j > 0; j-- )
+            stack.push_back(c[j - 1].second);
+    }
+
+    int count = (int)order.size();
+    if( count == 0 )
+    {
+        _contours.clear();
+        return true;
+    }
+    _contours.create(count, 1, 0, -1, true);
+    for( int k = 0; k < count; k++ )
+    {
+        const std::vector<Point>& pts = nodes[order[k]].pts;
+        _contours.create((int)pts.size(), 1, CV_32SC2, k, true);
+        Mat ci = _contours.getMat(k);
+        CV_Assert( ci.isContinuous() );
+        if( !pts.empty() )
+            memcpy( ci.ptr(), &pts[0], pts.size()*sizeof(pts[0]) );
+    }
+
+    if( _hierarchy.needed() )
+    {
+        _hierarchy.create(1, count, CV_32SC4, -1, true);
+        Vec4i* hierarchy = _hierarchy.getMat().ptr<Vec4i>();
+        std::fill(hierarchy, hierarchy + count, Vec4i(-1, -1, -1, -1));
+        for( int k = 0; k <= total; k++ )
+        {
+            const std::vector<std::pair<int64, int> >& c = children[k];
+            int parent = k < total ? pos[k] : -1;
+            for( size_t j = 0; j < c.size(); j++ )
+            {
+                Vec4i& h = hierarchy[pos[c[j].second]];
+                h[0] = j + 1 < c.size() ? pos[c[j + 1].second] : -1;
+                h[1] = j > 0 ? pos[c[j - 1].second] : -1;
+                h[3] = parent;
+            }
+            if( parent >= 0 && !c.empty() )
+                hierarchy[parent][2] = pos[c[0].second];
+        }
+    }
+    return true;
+}
+
+}
+
 void cv::findContours( InputArray _image, OutputArrayOfArrays _contours,
                    OutputArray _hierarchy, int mode, int method, Point offset )
 {
@@ -1838,11 +2192,14 @@ void cv::findContours( InputArray _image, OutputArrayOfArrays _contours,
     {
         image = image0;
     }
+    if( _hierarchy.needed() )
+        _hierarchy.clear();
+    if( method != CV_LINK_RUNS &&
+        icvFindContoursParallel(image, _contours, _hierarchy, mode, method, offset0 + offset) )
+        return;
     MemStorage storage(cvCreateMemStorage());
     CvMat _cimage = cvMat(image);
     CvSeq* _ccontours = 0;
-    if( _hierarchy.needed() )
-        _hierarchy.clear();
     cvFindContours_Impl(&_cimage, storage, &_ccontours, sizeof(CvContour), mode, method, cvPoint(offset0 + offset), 0);
     if( !_ccontours )
     {
@@ -39,6 +39,7 @@
 //
 //M*/
 #include "precomp.hpp"
+#include "opencv2/core/hal/intrin.hpp"
 
 namespace cv
 {
@@ -60,18 +61,18 @@ struct PolyEdge
 static void
 CollectPolyEdges( Mat& img, const Point2l* v, int npts,
                   std::vector<PolyEdge>& edges, const void* color, int line_type,
-                  int shift, Point offset=Point() );
+                  int shift, Point offset, Range rows );
 
 static void
-FillEdgeCollection( Mat& img, std::vector<PolyEdge>& edges, const void* color );
+FillEdgeCollection( Mat& img, std::vector<PolyEdge>& edges, const void* color, Range rows );
 
 static void
 PolyLine( Mat& img, const Point2l* v, int npts, bool closed,
-          const void* color, int thickness, int line_type, int shift );
+          const void* color, int thickness, int line_type, int shift, Range rows );
 
 static void
 FillConvexPoly( Mat& img, const Point2l* v, int npts,
-                const void* color, int line_type, int shift );
+                const void* color, int line_type, int shift, Range rows );
 
 /****************************************************************************************\
 *                                   Lines                                                *
@@ -259,9 +260,11 @@ void LineIterator::init( const Mat* img, Rect rect, Point pt1_, Point pt2_, int
     }
 }
 
+// the internal drawing functions below compute the geometry for the whole image, but only write
+// the image rows in the range `rows` (Range::all() for all the rows)
 static void
 Line( Mat& img, Point pt1, Point pt2,
-      const void* _color, int connectivity = 8 )
+      const void* _color, int connectivity, Range rows )
 {
     if( connectivity == 0 )
         connectivity = 8;
@@ -273,7 +276,16 @@ Line( Mat& img, Point pt1, Point pt2,
     int pix_size = (int)img.elemSize();
     const uchar* color = (const uchar*)_color;
 
-    if( pix_size == 3 )
+    if( rows.start > 0 || rows.end < img.rows )
+    {
+        for( i = 0; i < count; i++, ++iterator )
+        {
+            int y = iterator.pos().y;
+            if( rows.start <= y && y < rows.end )
+                memcpy( *iterator, color, pix_size );
+        }
+    }
+    else if( pix_size == 3 )
     {
         for( i = 0; i < count; i++, ++iterator )
         {
@@ -312,7 +324,7 @@ static const int FilterTable[] = {
 };
 
 static void
-LineAA( Mat& img, Point2l pt1, Point2l pt2, const void* color )
+LineAA( Mat& img, Point2l pt1, Point2l pt2, const void* color, Range rows )
 {
     int64 dx, dy;
     int ecount, scount = 0;
@@ -330,10 +342,14 @@ LineAA( Mat& img, Point2l pt1, Point2l pt2, const void* color )
 
     if( !((nch == 1 || nch == 3 || nch == 4) && img.depth() == CV_8U) )
     {
-        Line(img, Point((int)(pt1.x>>XY_SHIFT), (int)(pt1.y>>XY_SHIFT)), Point((int)(pt2.x>>XY_SHIFT), (int)(pt2.y>>XY_SHIFT)), color);
+        Line(img, Point((int)(pt1.x>>XY_SHIFT), (int)(pt1.y>>XY_SHIFT)), Point((int)(pt2.x>>XY_SHIFT), (int)(pt2.y>>XY_SHIFT)), color, 8, rows);
         return;
     }
 
+    int ylo = std::max(rows.start, 0), yrows = std::min(rows.end, img.rows) - ylo;
+    if( yrows <= 0 )
+        return;
+
     size.width <<= XY_SHIFT;
     size.height <<= XY_SHIFT;
     if( !clipLine( size, pt1, pt2 ))
@@ -445,15 +461,15 @@ LineAA( Mat& img, Point2l pt1, Point2l pt2, const void* color )
                 int a, dist = (pt1.y >> (XY_SHIFT - 5)) & 31;
 
                 a = (ep_corr * FilterTable[dist + 32] >> 8) & 0xff;
-                if( (unsigned)y < (unsigned)size0.height )
+                if( (unsigned)(y - ylo) < (unsigned)yrows )
                     ICV_PUT_POINT(x, y)
 
                 a = (ep_corr * FilterTable[dist] >> 8) & 0xff;
-                if( (unsigned)(y+1) < (unsigned)size0.height )
+                if( (unsigned)(y+1 - ylo) < (unsigned)yrows )
                     ICV_PUT_POINT(x, y+1)
 
                 a = (ep_corr * FilterTable[63 - dist] >> 8) & 0xff;
-                if( (unsigned)(y+2) < (unsigned)size0.height )
+                if( (unsigned)(y+2 - ylo) < (unsigned)yrows )
                     ICV_PUT_POINT(x, y+2)
             }
         }
@@ -463,7 +479,7 @@ LineAA( Mat& img, Point2l pt1, Point2l pt2, const void* color )
 
             for( ; ecount >= 0; y++, pt1.x += x_step, scount++, ecount-- )
             {
-                if( (unsigned)y >= (unsigned)size0.height )
+                if( (unsigned)(y - ylo) >= (unsigned)yrows )
                     continue;
                 int x = (int)((pt1.x >> XY_SHIFT) - 1);
                 int ep_corr = ep_table[(((scount >= 2) + 1) & (scount | 2)) * 3 +
@@ -511,15 +527,15 @@ LineAA( Mat& img, Point2l pt1, Point2l pt2, const void* color )
                 int a, dist = (pt1.y >> (XY_SHIFT - 5)) & 31;
 
                 a = (ep_corr * FilterTable[dist + 32] >> 8) & 0xff;
-                if( (unsigned)y < (unsigned)size0.height )
+                if( (unsigned)(y - ylo) < (unsigned)yrows )
                     ICV_PUT_POINT(x, y)
 
                 a = (ep_corr * FilterTable[dist] >> 8) & 0xff;
-                if( (unsigned)(y+1) < (unsigned)size0.height )
+                if( (unsigned)(y+1 - ylo) < (unsigned)yrows )
                     ICV_PUT_POINT(x, y+1)
 
                 a = (ep_corr * FilterTable[63 - dist] >> 8) & 0xff;
-                if( (unsigned)(y+2) < (unsigned)size0.height )
+                if( (unsigned)(y+2 - ylo) < (unsigned)yrows )
                     ICV_PUT_POINT(x, y+2)
             }
         }
@@ -529,7 +545,7 @@ LineAA( Mat& img, Point2l pt1, Point2l pt2, const void* color )
 
             for( ; ecount >= 0; y++, pt1.x += x_step, scount++, ecount-- )
             {
-                if( (unsigned)y >= (unsigned)size0.height )
+                if( (unsigned)(y - ylo) >= (unsigned)yrows )
                     continue;
                 int x = (int)((pt1.x >> XY_SHIFT) - 1);
                 int ep_corr = ep_table[(((scount >= 2) + 1) & (scount | 2)) * 3 +
@@ -588,15 +604,15 @@ LineAA( Mat& img, Point2l pt1, Point2l pt2, const void* color )
                 int a, dist = (pt1.y >> (XY_SHIFT - 5)) & 31;
 
                 a = (ep_corr * FilterTable[dist + 32] >> 8) & 0xff;
-                if( (unsigned)y < (unsigned)size0.height )
+                if( (unsigned)(y - ylo) < (unsigned)yrows )
                     ICV_PUT_POINT(x, y)
 
                 a = (ep_corr * FilterTable[dist] >> 8) & 0xff;
-                if( (unsigned)(y+1) < (unsigned)size0.height )
+                if( (unsigned)(y+1 - ylo) < (unsigned)yrows )
                     ICV_PUT_POINT(x, y+1)
 
                 a = (ep_corr * FilterTable[63 - dist] >> 8) & 0xff;
-                if( (unsigned)(y+2) < (unsigned)size0.height )
+                if( (unsigned)(y+2 - ylo) < (unsigned)yrows )
                     ICV_PUT_POINT(x, y+2)
             }
         }
@@ -606,7 +622,7 @@ LineAA( Mat& img, Point2l pt1, Point2l pt2, const void* color )
 
             for( ; ecount >= 0; y++, pt1.x += x_step, scount++, ecount-- )
             {
-                if( (unsigned)y >= (unsigned)size0.height )
+                if( (unsigned)(y - ylo) >= (unsigned)yrows )
                     continue;
                 int x = (int)((pt1.x >> XY_SHIFT) - 1);
                 int ep_corr = ep_table[(((scount >= 2) + 1) & (scount | 2)) * 3 +
@@ -632,7 +648,7 @@ LineAA( Mat& img, Point2l pt1, Point2l pt2, const void* color )
 
 
 static void
-Line2( Mat& img, Point2l pt1, Point2l pt2, const void* color)
+Line2( Mat& img, Point2l pt1, Point2l pt2, const void* color, Range rows )
 {
     int64 dx, dy;
     int ecount;
@@ -647,6 +663,7 @@ Line2( Mat& img, Point2l pt1, Point2l pt2, const void* color)
     uchar *ptr = img.ptr(), *tptr;
     size_t step = img.step;
     Size size = img.size();
+    int ylo = std::max(rows.start, 0), yhi = std::min(rows.end, size.height);
 
     //assert( img && (nch == 1 || nch == 3) && img.depth() == CV_8U );
 
@@ -699,7 +716,7 @@ Line2( Mat& img, Point2l pt1, Point2l pt2, const void* color)
         #define  ICV_PUT_POINT(_x,_y)   \
         x = (_x); y = (_y);             \
         if( 0 <= x && x < size.width && \
-            0 <= y && y < size.height ) \
+            ylo <= y && y < yhi )       \
         {                               \
             tptr = ptr + y*step + x*3;  \
             tptr[0] = (uchar)cb;        \
@@ -742,7 +759,7 @@ Line2( Mat& img, Point2l pt1, Point2l pt2, const void* color)
         #define  ICV_PUT_POINT(_x,_y) \
         x = (_x); y = (_y);           \
         if( 0 <= x && x < size.width && \
-            0 <= y && y < size.height ) \
+            ylo <= y && y < yhi )       \
         {                           \
             tptr = ptr + y*step + x;\
             tptr[0] = (uchar)cb;    \
@@ -783,7 +800,7 @@ Line2( Mat& img, Point2l pt1, Point2l pt2, const void* color)
         #define  ICV_PUT_POINT(_x,_y)   \
         x = (_x); y = (_y);             \
         if( 0 <= x && x < size.width && \
-            0 <= y && y < size.height ) \
+            ylo <= y && y < yhi )       \
         {                               \
             tptr = ptr + y*step + x*pix_size;\
             for( j = 0; j < pix_size; j++ ) \
@@ -1010,7 +1027,7 @@ void ellipse2Poly( Point2d center, Size2d axes, int angle,
 static void
 EllipseEx( Mat& img, Point2l center, Size2l axes,
            int angle, int arc_start, int arc_end,
-           const void* color, int thickness, int line_type )
+           const void* color, int thickness, int line_type, Range rows )
 {
     axes.width = std::abs(axes.width), axes.height = std::abs(axes.height);
     int delta = (int)((std::max(axes.width,axes.height)+(XY_ONE>>1))>>XY_SHIFT);
@@ -1041,15 +1058,15 @@ EllipseEx( Mat& img, Point2l center, Size2l axes,
     }
 
     if( thickness >= 0 )
-        PolyLine( img, &v[0], (int)v.size(), false, color, thickness, line_type, XY_SHIFT );
+        PolyLine( img, &v[0], (int)v.size(), false, color, thickness, line_type, XY_SHIFT, rows );
     else if( arc_end - arc_start >= 360 )
-        FillConvexPoly( img, &v[0], (int)v.size(), color, line_type, XY_SHIFT );
+        FillConvexPoly( img, &v[0], (int)v.size(), color, line_type, XY_SHIFT, rows );
     else
     {
         v.push_back(center);
         std::vector<PolyEdge> edges;
-        CollectPolyEdges( img,  &v[0], (int)v.size(), edges, color, line_type, XY_SHIFT );
-        FillEdgeCollection( img, edges, color );
+        CollectPolyEdges( img,  &v[0], (int)v.size(), edges, color, line_type, XY_SHIFT, Point(), rows );
+        FillEdgeCollection( img, edges, color, rows );
     }
 }
 
@@ -1065,6 +1082,25 @@ static inline void ICV_HLINE_X(uchar* ptr, int xl, int xr, const uchar* color, i
     uchar* hline_ptr = hline_min_ptr;
     if (pix_size == 1)
       memset(hline_min_ptr, *color, hline_end_ptr-hline_min_ptr);
+#if CV_SIMD128
+    else if ((pix_size == 3 || pix_size == 4) && hline_end_ptr - hline_min_ptr >= 48 &&
+             hline_end_ptr - hline_min_ptr <= 1536)
+    {
+      // store the color repeated over 48 bytes (the common multiple of 3 and 16), no reads of the span;
+      // the longer spans are faster with the doubling memcpy below
+      uchar pattern[48];
+      for (int k = 0; k < 48; k += pix_size)
+        memcpy(pattern + k, color, pix_size);
+      v_uint8x16 v0 = v_load(pattern), v1 = v_load(pattern + 16), v2 = v_load(pattern + 32);
+      for (; hline_ptr + 48 <= hline_end_ptr; hline_ptr += 48)
+      {
+        v_store(hline_ptr, v0);
+        v_store(hline_ptr + 16, v1);
+        v_store(hline_ptr + 32, v2);
+      }
+      memcpy(hline_ptr, pattern, hline_end_ptr - hline_ptr);
+    }
+#endif
     else//if (pix_size != 1)
     {
       if (hline_min_ptr < hline_end_ptr)
@@ -1091,7 +1127,7 @@ static inline void ICV_HLINE(uchar* ptr, int xl, int xr, const void* color, int
 
 /* filling convex polygon. v - array of vertices, ntps - number of points */
 static void
-FillConvexPoly( Mat& img, const Point2l* v, int npts, const void* color, int line_type, int shift )
+FillConvexPoly( Mat& img, const Point2l* v, int npts, const void* color, int line_type, int shift, Range rows )
 {
     struct
     {
@@ -1149,13 +1185,13 @@ FillConvexPoly( Mat& img, const Point2l* v, int npts, const void* color, int lin
                 pt0.y = (int)(p0.y >> XY_SHIFT);
                 pt1.x = (int)(p.x >> XY_SHIFT);
                 pt1.y = (int)(p.y >> XY_SHIFT);
-                Line( img, pt0, pt1, color, line_type );
+                Line( img, pt0, pt1, color, line_type, rows );
             }
             else
-                Line2( img, p0, p, color );
+                Line2( img, p0, p, color, rows );
         }
         else
-            LineAA( img, p0, p, color );
+            LineAA( img, p0, p, color, rows );
         p0 = p;
     }
 
@@ -1164,10 +1200,12 @@ FillConvexPoly( Mat& img, const Point2l* v, int npts, const void* color, int lin
     ymin = (ymin + delta) >> shift;
     ymax = (ymax + delta) >> shift;
 
-    if( npts < 3 || (int)xmax < 0 || (int)ymax < 0 || (int)xmin >= size.width || (int)ymin >= size.height )
+    int ylo = std::max(rows.start, 0), yhi = std::min(rows.end, size.height);
+    if( npts < 3 || (int)xmax < 0 || (int)ymax < ylo || (int)xmin >= size.width || (int)ymin >= yhi )
         return;
 
     ymax = MIN( ymax, size.height - 1 );
+    int yend = std::min( (int)ymax, yhi - 1 );
     edge[0].idx = edge[1].idx = imin;
 
     edge[0].ye = edge[1].ye = y = (int)ymin;
@@ -1222,7 +1260,7 @@ FillConvexPoly( Mat& img, const Point2l* v, int npts, const void* color, int lin
         if (edges < 0)
             break;
 
-        if (y >= 0)
+        if (y >= ylo)
         {
             int left = 0, right = 1;
             if (edge[0].x > edge[1].x)
@@ -1251,7 +1289,7 @@ FillConvexPoly( Mat& img, const Point2l* v, int npts, const void* color, int lin
         edge[1].x += edge[1].dx;
         ptr += img.step;
     }
-    while( ++y <= (int)ymax );
+    while( ++y <= yend );
 }
 
 
@@ -1259,7 +1297,7 @@ FillConvexPoly( Mat& img, const Point2l* v, int npts, const void* color, int lin
 
 static void
 CollectPolyEdges( Mat& img, const Point2l* v, int count, std::vector<PolyEdge>& edges,
-                  const void* color, int line_type, int shift, Point offset )
+                  const void* color, int line_type, int shift, Point offset, Range rows )
 {
     int i, delta = offset.y + ((1 << shift) >> 1);
     Point2l pt0 = v[count-1], pt1;
@@ -1282,14 +1320,14 @@ CollectPolyEdges( Mat& img, const Point2l* v, int count, std::vector<PolyEdge>&
             t0.y = pt0.y; t1.y = pt1.y;
             t0.x = (pt0.x + (XY_ONE >> 1)) >> XY_SHIFT;
             t1.x = (pt1.x + (XY_ONE >> 1)) >> XY_SHIFT;
-            Line( img, t0, t1, color, line_type );
+            Line( img, t0, t1, color, line_type, rows );
         }
         else
         {
             t0.x = pt0.x; t1.x = pt1.x;
             t0.y = pt0.y << XY_SHIFT;
             t1.y = pt1.y << XY_SHIFT;
-            LineAA( img, t0, t1, color );
+            LineAA( img, t0, t1, color, rows );
         }
 
         if( pt0.y == pt1.y )
@@ -1324,7 +1362,7 @@ struct CmpEdges
 /**************** helper macros and functions for sequence/contour processing ***********/
 
 static void
-FillEdgeCollection( Mat& img, std::vector<PolyEdge>& edges, const void* color )
+FillEdgeCollection( Mat& img, std::vector<PolyEdge>& edges, const void* color, Range rows )
 {
     PolyEdge tmp;
     int i, y, total = (int)edges.size();
@@ -1333,6 +1371,7 @@ FillEdgeCollection( Mat& img, std::vector<PolyEdge>& edges, const void* color )
     int y_max = INT_MIN, y_min = INT_MAX;
     int64 x_max = 0xFFFFFFFFFFFFFFFF, x_min = 0x7FFFFFFFFFFFFFFF;
     int pix_size = (int)img.elemSize();
+    int ylo = std::max(rows.start, 0), yhi = std::min(rows.end, size.height);
 
     if( total < 2 )
         return;
@@ -1364,14 +1403,14 @@ FillEdgeCollection( Mat& img, std::vector<PolyEdge>& edges, const void* color )
     i = 0;
     tmp.next = 0;
     e = &edges[i];
-    y_max = MIN( y_max, size.height );
+    y_max = MIN( y_max, yhi );
 
     for( y = e->y0; y < y_max; y++ )
     {
         PolyEdge *last, *prelast, *keep_prelast;
         int sort_flag = 0;
         int draw = 0;
-        int clipline = y < 0;
+        int clipline = y < ylo;
 
         prelast = &tmp;
         last = tmp.next;
@@ -1473,15 +1512,16 @@ FillEdgeCollection( Mat& img, std::vector<PolyEdge>& edges, const void* color )
 
 /* draws simple or filled circle */
 static void
-Circle( Mat& img, Point center, int radius, const void* color, int fill )
+Circle( Mat& img, Point center, int radius, const void* color, int fill, Range rows )
 {
     Size size = img.size();
+    int ylo = std::max(rows.start, 0), yhi = std::min(rows.end, size.height), yrows = yhi - ylo;
     size_t step = img.step;
     int pix_size = (int)img.elemSize();
     uchar* ptr = img.ptr();
     int err = 0, dx = radius, dy = 0, plus = 1, minus = (radius << 1) - 1;
     int inside = center.x >= radius && center.x < size.width - radius &&
-        center.y >= radius && center.y < size.height - radius;
+        center.y >= ylo + radius && center.y < yhi - radius;
 
     #define ICV_PUT_POINT( ptr, x )     \
         memcpy( ptr + (x)*pix_size, color, pix_size );
@@ -1526,7 +1566,7 @@ Circle( Mat& img, Point center, int radius, const void* color, int fill )
                 ICV_HLINE( tptr1, x21, x22, color, pix_size );
             }
         }
-        else if( x11 < size.width && x12 >= 0 && y21 < size.height && y22 >= 0 )
+        else if( x11 < size.width && x12 >= 0 && y21 < yhi && y22 >= ylo )
         {
             if( fill )
             {
@@ -1534,7 +1574,7 @@ Circle( Mat& img, Point center, int radius, const void* color, int fill )
                 x12 = MIN( x12, size.width - 1 );
             }
 
-            if( (unsigned)y11 < (unsigned)size.height )
+            if( (unsigned)(y11 - ylo) < (unsigned)yrows )
             {
                 uchar *tptr = ptr + y11 * step;
 
@@ -1549,7 +1589,7 @@ Circle( Mat& img, Point center, int radius, const void* color, int fill )
                     ICV_HLINE( tptr, x11, x12, color, pix_size );
             }
 
-            if( (unsigned)y12 < (unsigned)size.height )
+            if( (unsigned)(y12 - ylo) < (unsigned)yrows )
             {
                 uchar *tptr = ptr + y12 * step;
 
@@ -1572,7 +1612,7 @@ Circle( Mat& img, Point center, int radius, const void* color, int fill )
                     x22 = MIN( x22, size.width - 1 );
                 }
 
-                if( (unsigned)y21 < (unsigned)size.height )
+                if( (unsigned)(y21 - ylo) < (unsigned)yrows )
                 {
                     uchar *tptr = ptr + y21 * step;
 
@@ -1587,7 +1627,7 @@ Circle( Mat& img, Point center, int radius, const void* color, int fill )
                         ICV_HLINE( tptr, x21, x22, color, pix_size );
                 }
 
-                if( (unsigned)y22 < (unsigned)size.height )
+                if( (unsigned)(y22 - ylo) < (unsigned)yrows )
                 {
                     uchar *tptr = ptr + y22 * step;
 
@@ -1620,7 +1660,7 @@ Circle( Mat& img, Point center, int radius, const void* color, int fill )
 
 static void
 ThickLine( Mat& img, Point2l p0, Point2l p1, const void* color,
-           int thickness, int line_type, int flags, int shift )
+           int thickness, int line_type, int flags, int shift, Range rows )
 {
     static const double INV_XY_ONE = 1./XY_ONE;
 
@@ -1639,13 +1679,13 @@ ThickLine( Mat& img, Point2l p0, Point2l p1, const void* color,
                 p0.y = (p0.y + (XY_ONE>>1)) >> XY_SHIFT;
                 p1.x = (p1.x + (XY_ONE>>1)) >> XY_SHIFT;
                 p1.y = (p1.y + (XY_ONE>>1)) >> XY_SHIFT;
-                Line( img, p0, p1, color, line_type );
+                Line( img, p0, p1, color, line_type, rows );
             }
             else
-                Line2( img, p0, p1, color );
+                Line2( img, p0, p1, color, rows );
         }
         else
-            LineAA( img, p0, p1, color );
+            LineAA( img, p0, p1, color, rows );
     }
     else
     {
@@ -1670,7 +1710,7 @@ ThickLine( Mat& img, Point2l p0, Point2l p1, const void* color,
             pt[3].x = p1.x + dp.x;
             pt[3].y = p1.y + dp.y;
 
-            FillConvexPoly( img, pt, 4, color, line_type, XY_SHIFT );
+            FillConvexPoly( img, pt, 4, color, line_type, XY_SHIFT, rows );
         }
 
         for( i = 0; i < 2; i++ )
@@ -1682,12 +1722,12 @@ ThickLine( Mat& img, Point2l p0, Point2l p1, const void* color,
                     Point center;
                     center.x = (int)((p0.x + (XY_ONE>>1)) >> XY_SHIFT);
                     center.y = (int)((p0.y + (XY_ONE>>1)) >> XY_SHIFT);
-                    Circle( img, center, (thickness + (XY_ONE>>1)) >> XY_SHIFT, color, 1 );
+                    Circle( img, center, (thickness + (XY_ONE>>1)) >> XY_SHIFT, color, 1, rows );
                 }
                 else
                 {
                     EllipseEx( img, p0, Size2l(thickness, thickness),
-                               0, 0, 360, color, -1, line_type );
+                               0, 0, 360, color, -1, line_type, rows );
                 }
             }
             p0 = p1;
@@ -1699,7 +1739,7 @@ ThickLine( Mat& img, Point2l p0, Point2l p1, const void* color,
 static void
 PolyLine( Mat& img, const Point2l* v, int count, bool is_closed,
           const void* color, int thickness,
-          int line_type, int shift )
+          int line_type, int shift, Range rows )
 {
     if( !v || count <= 0 )
         return;
@@ -1713,7 +1753,7 @@ PolyLine( Mat& img, const Point2l* v, int count, bool is_closed,
     for( i = !is_closed; i < count; i++ )
     {
         Point2l p = v[i];
-        ThickLine( img, p0, p, color, thickness, line_type, flags, shift );
+        ThickLine( img, p0, p, color, thickness, line_type, flags, shift, rows );
         p0 = p;
         flags = 2;
     }
@@ -1784,6 +1824,44 @@ void drawMarker(InputOutputArray img, Point position, const Scalar& color, int m
     }
 }
 
+static void
+Rectangle( Mat& img, Point pt1, Point pt2, const void* color,
+           int thickness, int lineType, int shift, Range rows )
+{
+    Point2l pt[4];
+
+    pt[0] = pt1;
+    pt[1].x = pt2.x;
+    pt[1].y = pt1.y;
+    pt[2] = pt2;
+    pt[3].x = pt1.x;
+    pt[3].y = pt2.y;
+
+    if( thickness >= 0 )
+        PolyLine( img, pt, 4, true, color, thickness, lineType, shift, rows );
+    else
+        FillConvexPoly( img, pt, 4, color, lineType, shift, rows );
+}
+
+
+static void
+CircleEx( Mat& img, Point center, int radius, const void* color,
+          int thickness, int line_type, int shift, Range rows )
+{
+    if( thickness > 1 || line_type != LINE_8 || shift > 0 )
+    {
+        Point2l _center(center);
+        int64 _radius(radius);
+        _center.x <<= XY_SHIFT - shift;
+        _center.y <<= XY_SHIFT - shift;
+        _radius <<= XY_SHIFT - shift;
+        EllipseEx( img, _center, Size2l(_radius, _radius),
+                   0, 0, 360, color, thickness, line_type, rows );
+    }
+    else
+        Circle( img, center, radius, color, thickness < 0, rows );
+}
+
 /****************************************************************************************\
 *                              External functions                                        *
 \****************************************************************************************/
@@ -1803,7 +1881,7 @@ void line( InputOutputArray _img, Point pt1, Point pt2, const Scalar& color,
 
     double buf[4];
     scalarToRawData( color, buf, img.type(), 0 );
-    ThickLine( img, pt1, pt2, buf, thickness, line_type, 3, shift );
+    ThickLine( img, pt1, pt2, buf, thickness, line_type, 3, shift, Range::all() );
 }
 
 void arrowedLine(InputOutputArray img, Point pt1, Point pt2, const Scalar& color,
@@ -1842,20 +1920,7 @@ void rectangle( InputOutputArray _img, Point pt1, Point pt2,
 
     double buf[4];
     scalarToRawData(color, buf, img.type(), 0);
-
-    Point2l pt[4];
-
-    pt[0] = pt1;
-    pt[1].x = pt2.x;
-    pt[1].y = pt1.y;
-    pt[2] = pt2;
-    pt[3].x = pt1.x;
-    pt[3].y = pt2.y;
-
-    if( thickness >= 0 )
-        PolyLine( img, pt, 4, true, buf, thickness, lineType, shift );
-    else
-        FillConvexPoly( img, pt, 4, buf, lineType, shift );
+    Rectangle( img, pt1, pt2, buf, thickness, lineType, shift, Range::all() );
 }
 
 
@@ -1886,19 +1951,7 @@ void circle( InputOutputArray _img, Point center, int radius,
 
     double buf[4];
     scalarToRawData(color, buf, img.type(), 0);
-
-    if( thickness > 1 || line_type != LINE_8 || shift > 0 )
-    {
-        Point2l _center(center);
-        int64 _radius(radius);
-        _center.x <<= XY_SHIFT - shift;
-        _center.y <<= XY_SHIFT - shift;
-        _radius <<= XY_SHIFT - shift;
-        EllipseEx( img, _center, Size2l(_radius, _radius),
-                   0, 0, 360, buf, thickness, line_type );
-    }
-    else
-        Circle( img, center, radius, buf, thickness < 0 );
+    CircleEx( img, center, radius, buf, thickness, line_type, shift, Range::all() );
 }
 
 
@@ -1930,7 +1983,7 @@ void ellipse( InputOutputArray _img, Point center, Size axes,
     _axes.height <<= XY_SHIFT - shift;
 
     EllipseEx( img, _center, _axes, _angle, _start_angle,
-               _end_angle, buf, thickness, line_type );
+               _end_angle, buf, thickness, line_type, Range::all() );
 }
 
 void ellipse(InputOutputArray _img, const RotatedRect& box, const Scalar& color,
@@ -1958,7 +2011,7 @@ void ellipse(InputOutputArray _img, const RotatedRect& box, const Scalar& color,
               cvRound(box.size.height));
     axes.width  = (axes.width  << (XY_SHIFT - 1)) + cvRound((box.size.width - axes.width)*(XY_ONE>>1));
     axes.height = (axes.height << (XY_SHIFT - 1)) + cvRound((box.size.height - axes.height)*(XY_ONE>>1));
-    EllipseEx( img, center, axes, _angle, 0, 360, buf, thickness, lineType );
+    EllipseEx( img, center, axes, _angle, 0, 360, buf, thickness, lineType, Range::all() );
 }
 
 void fillConvexPoly( InputOutputArray _img, const Point* pts, int npts,
@@ -1978,7 +2031,7 @@ void fillConvexPoly( InputOutputArray _img, const Point* pts, int npts,
     CV_Assert( 0 <= shift && shift <=  XY_SHIFT );
     scalarToRawData(color, buf, img.type(), 0);
     std::vector<Point2l> _pts(pts, pts + npts);
-    FillConvexPoly( img, _pts.data(), npts, buf, line_type, shift );
+    FillConvexPoly( img, _pts.data(), npts, buf, line_type, shift, Range::all() );
 }
 
 void fillPoly( InputOutputArray _img, const Point** pts, const int* npts, int ncontours,
@@ -2007,10 +2060,10 @@ void fillPoly( InputOutputArray _img, const Point** pts, const int* npts, int nc
     for (i = 0; i < ncontours; i++)
     {
         std::vector<Point2l> _pts(pts[i], pts[i] + npts[i]);
-        CollectPolyEdges(img, _pts.data(), npts[i], edges, buf, line_type, shift, offset);
+        CollectPolyEdges(img, _pts.data(), npts[i], edges, buf, line_type, shift, offset, Range::all());
     }
 
-    FillEdgeCollection(img, edges, buf);
+    FillEdgeCollection(img, edges, buf, Range::all());
 }
 
 void polylines( InputOutputArray _img, const Point* const* pts, const int* npts, int ncontours, bool isClosed,
@@ -2033,7 +2086,7 @@ void polylines( InputOutputArray _img, const Point* const* pts, const int* npts,
     for( int i = 0; i < ncontours; i++ )
     {
         std::vector<Point2l> _pts(pts[i], pts[i]+npts[i]);
-        PolyLine( img, _pts.data(), npts[i], isClosed, buf, thickness, line_type, shift );
+        PolyLine( img, _pts.data(), npts[i], isClosed, buf, thickness, line_type, shift, Range::all() );
     }
 }
 
@@ -2253,29 +2306,15 @@ inline void readCheck(int &c, int &i, const String &text, int fontFace)
 
 extern const char* g_HersheyGlyphs[];
 
-void putText( InputOutputArray _img, const String& text, Point org,
-              int fontFace, double fontScale, Scalar color,
-              int thickness, int line_type, bool bottomLeftOrigin )
-
+static void
+PutText( Mat& img, const String& text, Point org, int fontFace, double fontScale,
+         const void* color, int thickness, int line_type, bool bottomLeftOrigin, Range rows )
 {
-    CV_INSTRUMENT_REGION();
-
-    if ( text.empty() )
-    {
-        return;
-    }
-    Mat img = _img.getMat();
     const int* ascii = getFontData(fontFace);
 
-    double buf[4];
-    scalarToRawData(color, buf, img.type(), 0);
-
     int base_line = -(ascii[0] & 15);
     int hscale = cvRound(fontScale*XY_ONE), vscale = hscale;
 
-    if( line_type == CV_AA && img.depth() != CV_8U )
-        line_type = 8;
-
     if( bottomLeftOrigin )
         vscale = -vscale;
 
@@ -2304,7 +2343,7 @@ void putText( InputOutputArray _img, const String& text, Point org,
             if( *ptr == ' ' || !*ptr )
             {
                 if( pts.size() > 1 )
-                    PolyLine( img, &pts[0], (int)pts.size(), false, buf, thickness, line_type, XY_SHIFT );
+                    PolyLine( img, &pts[0], (int)pts.size(), false, color, thickness, line_type, XY_SHIFT, rows );
                 if( !*ptr++ )
                     break;
                 pts.resize(0);
@@ -2321,6 +2360,28 @@ void putText( InputOutputArray _img, const String& text, Point org,
     }
 }
 
+void putText( InputOutputArray _img, const String& text, Point org,
+              int fontFace, double fontScale, Scalar color,
+              int thickness, int line_type, bool bottomLeftOrigin )
+
+{
+    CV_INSTRUMENT_REGION();
+
+    if ( text.empty() )
+    {
+        return;
+    }
+    Mat img = _img.getMat();
+
+    double buf[4];
+    scalarToRawData(color, buf, img.type(), 0);
+
+    if( line_type == CV_AA && img.depth() != CV_8U )
+        line_type = 8;
+
+    PutText( img, text, org, fontFace, fontScale, buf, thickness, line_type, bottomLeftOrigin, Range::all() );
+}
+
 Size getTextSize( const String& text, int fontFace, double fontScale, int thickness, int* _base_line)
 {
     Size size;
@@ -2362,6 +2423,220 @@ double getFontScaleFromHeight(const int fontFace, const int pixelHeight, const i
     return static_cast<double>(pixelHeight - static_cast<double>((thickness + 1)) / 2.0) / static_cast<double>(cap_line + base_line);
 }
 
+/****************************************************************************************\
+*                                  Batched drawing                                       *
+\****************************************************************************************/
+
+struct DrawingBatch::Impl
+{
+    enum { LINE = 0, RECTANGLE = 1, CIRCLE = 2, TEXT = 3 };
+
+    struct Primitive
+    {
+        int kind;
+        Point pt1, pt2;
+        int radius;
+        Scalar color;
+        int thickness, lineType, shift;
+        int fontFace, text;
+        double fontScale;
+        bool bottomLeftOrigin;
+        // the rows [y0, y1) that may be touched by the primitive
+        int y0, y1;
+    };
+
+    void add(Primitive& prim, int64 ymin, int64 ymax, int64 margin)
+    {
+        // the bounds are in the fixed-point coordinates, the margin is in pixels
+        ymin = (ymin >> prim.shift) - margin;
+        ymax = (ymax >> prim.shift) + margin + 1;
+        prim.y0 = (int)std::max(std::min(ymin, (int64)INT_MAX), (int64)INT_MIN);
+        prim.y1 = (int)std::max(std::min(ymax, (int64)INT_MAX), (int64)INT_MIN);
+        prims.push_back(prim);
+    }
+
+    void draw(Mat& img, const Primitive& prim, const double* buf, Range rows) const
+    {
+        int lineType = prim.lineType;
+        if( lineType == CV_AA && img.depth() != CV_8U )
+            lineType = 8;
+
+        switch( prim.kind )
+        {
+        case LINE:
+            ThickLine( img, prim.pt1, prim.pt2, buf, prim.thickness, lineType, 3, prim.shift, rows );
+            break;
+        case RECTANGLE:
+            Rectangle( img, prim.pt1, prim.pt2, buf, prim.thickness, lineType, prim.shift, rows );
+            break;
+        case CIRCLE:
+            CircleEx( img, prim.pt1, prim.radius, buf, prim.thickness, lineType, prim.shift, rows );
+            break;
+        default:
+            PutText( img, texts[prim.text], prim.pt1, prim.fontFace, prim.fontScale, buf,
+                     prim.thickness, lineType, prim.bottomLeftOrigin, rows );
+        }
+    }
+
+    std::vector<Primitive> prims;
+    std::vector<String> texts;
+};
+
+namespace
+{
+
+class DrawingBatchInvoker : public ParallelLoopBody
+{
+public:
+    DrawingBatchInvoker(const DrawingBatch::Impl& _impl, Mat& _img, const std::vector<double>& _colors, int _nbands)
+        : impl(_impl), img(_img), colors(_colors), nbands(_nbands) {}
+
+    void operator()(const Range& range) const CV_OVERRIDE
+    {
+        for( int band = range.start; band < range.end; band++ )
+        {
+            // the band rows are written only by this band, the whole image is used for the geometry
+            Range rows(band*img.rows/nbands, (band + 1)*img.rows/nbands);
+            if( nbands == 1 )
+                rows = Range::all();
+            for( size_t i = 0; i < impl.prims.size(); i++ )
+            {
+                const DrawingBatch::Impl::Primitive& prim = impl.prims[i];
+                if( prim.y1 <= rows.start || prim.y0 >= rows.end )
+                    continue;
+                impl.draw(img, prim, &colors[i*4], rows);
+            }
+        }
+    }
+
+private:
+    const DrawingBatch::Impl& impl;
+    Mat& img;
+    const std::vector<double>& colors;
+    int nbands;
+};
+
+}
+
+DrawingBatch::DrawingBatch() : p(makePtr<Impl>())
+{
+}
+
+void DrawingBatch::line(Point pt1, Point pt2, const Scalar& color,
+                        int thickness, int lineType, int shift)
+{
+    CV_Assert( 0 < thickness && thickness <= MAX_THICKNESS );
+    CV_Assert( 0 <= shift && shift <= XY_SHIFT );
+
+    Impl::Primitive prim = Impl::Primitive();
+    prim.kind = Impl::LINE;
+    prim.pt1 = pt1;
+    prim.pt2 = pt2;
+    prim.color = color;
+    prim.thickness = thickness;
+    prim.lineType = lineType;
+    prim.shift = shift;
+    p->add(prim, std::min(pt1.y, pt2.y), std::max(pt1.y, pt2.y), thickness/2 + 3);
+}
+
+void DrawingBatch::rectangle(Rect rec, const Scalar& color,
+                             int thickness, int lineType, int shift)
+{
+    CV_Assert( thickness <= MAX_THICKNESS );
+    CV_Assert( 0 <= shift && shift <= XY_SHIFT );
+
+    if( rec.empty() )
+        return;
+    Impl::Primitive prim = Impl::Primitive();
+    prim.kind = Impl::RECTANGLE;
+    prim.pt1 = rec.tl();
+    prim.pt2 = rec.br() - Point(1<<shift, 1<<shift);
+    prim.color = color;
+    prim.thickness = thickness;
+    prim.lineType = lineType;
+    prim.shift = shift;
+    p->add(prim, std::min(prim.pt1.y, prim.pt2.y), std::max(prim.pt1.y, prim.pt2.y), std::max(thickness, 0)/2 + 3);
+}
+
+void DrawingBatch::rectangles(const std::vector<Rect>& recs, const Scalar& color,
+                              int thickness, int lineType, int shift)
+{
+    p->prims.reserve(p->prims.size() + recs.size());
+    for( size_t i = 0; i < recs.size(); i++ )
+        rectangle(recs[i], color, thickness, lineType, shift);
+}
+
+void DrawingBatch::circle(Point center, int radius, const Scalar& color,
+                          int thickness, int lineType, int shift)
+{
+    CV_Assert( radius >= 0 && thickness <= MAX_THICKNESS &&
+        0 <= shift && shift <= XY_SHIFT );
+
+    Impl::Primitive prim = Impl::Primitive();
+    prim.kind = Impl::CIRCLE;
+    prim.pt1 = center;
+    prim.radius = radius;
+    prim.color = color;
+    prim.thickness = thickness;
+    prim.lineType = lineType;
+    prim.shift = shift;
+    p->add(prim, (int64)center.y - radius, (int64)center.y + radius, std::max(thickness, 0)/2 + 3);
+}
+
+void DrawingBatch::putText(const String& text, Point org, int fontFace, double fontScale, Scalar color,
+                           int thickness, int lineType, bool bottomLeftOrigin)
+{
+    getFontData(fontFace);
+    if( text.empty() )
+        return;
+
+    Impl::Primitive prim = Impl::Primitive();
+    prim.kind = Impl::TEXT;
+    prim.pt1 = org;
+    prim.fontFace = fontFace;
+    prim.fontScale = fontScale;
+    prim.text = (int)p->texts.size();
+    prim.color = color;
+    prim.thickness = thickness;
+    prim.lineType = lineType;
+    prim.bottomLeftOrigin = bottomLeftOrigin;
+    p->texts.push_back(text);
+    // the glyph coordinates are within [-50, 44] font units, and the baseline shift within 15 units
+    int64 extent = (int64)std::ceil(65*std::abs(fontScale));
+    p->add(prim, (int64)org.y - extent, (int64)org.y + extent, std::max(thickness, 0)/2 + 3);
+}
+
+void DrawingBatch::clear()
+{
+    p->prims.clear();
+    p->texts.clear();
+}
+
+size_t DrawingBatch::size() const
+{
+    return p->prims.size();
+}
+
+void DrawingBatch::draw(InputOutputArray _img) const
+{
+    CV_INSTRUMENT_REGION();
+
+    Mat img = _img.getMat();
+    size_t n = p->prims.size();
+    if( img.empty() || n == 0 )
+        return;
+
+    std::vector<double> colors(n*4);
+    for( size_t i = 0; i < n; i++ )
+        scalarToRawData(p->prims[i].color, &colors[i*4], img.type(), 0);
+
+    // the primitives spanning several bands are traversed by each of them, so the bands are
+    // only as many as needed to keep the threads busy
+    int nthreads = getNumThreads();
+    int nbands = nthreads > 1 ? std::max(std::min(nthreads*2, img.rows/32), 1) : 1;
+    parallel_for_(Range(0, nbands), DrawingBatchInvoker(*p, img, colors, nbands), nbands);
+}
+
 }
 
 void cv::fillConvexPoly(InputOutputArray img, InputArray _points,
@@ -2618,7 +2893,7 @@ cvDrawContours( void* _img, CvSeq* contour,
                 {
                     prev_code = code;
                     if( thickness >= 0 )
-                        cv::ThickLine( img, prev_pt, pt, clr, thickness, line_type, 2, 0 );
+                        cv::ThickLine( img, prev_pt, pt, clr, thickness, line_type, 2, 0, cv::Range::all() );
                     else
                         pts.push_back(pt);
                     prev_pt = pt;
@@ -2631,10 +2906,10 @@ cvDrawContours( void* _img, CvSeq* contour,
             if( thickness >= 0 )
                 cv::ThickLine( img, prev_pt,
                     cv::Point(((CvChain*)contour)->origin) + offset,
-                    clr, thickness, line_type, 2, 0 );
+                    clr, thickness, line_type, 2, 0, cv::Range::all() );
             else
                 cv::CollectPolyEdges(img, &pts[0], (int)pts.size(),
-                                     edges, ext_buf, line_type, 0, offset);
+                                     edges, ext_buf, line_type, 0, offset, cv::Range::all());
         }
         else if( CV_IS_SEQ_POLYLINE( contour ))
         {
@@ -2653,19 +2928,19 @@ cvDrawContours( void* _img, CvSeq* contour,
                 { CvPoint pt_ = CV_STRUCT_INITIALIZER; CV_READ_SEQ_ELEM(pt_, reader); pt2 = pt_; }
                 pt2 += offset;
                 if( thickness >= 0 )
-                    cv::ThickLine( img, pt1, pt2, clr, thickness, line_type, 2, shift );
+                    cv::ThickLine( img, pt1, pt2, clr, thickness, line_type, 2, shift, cv::Range::all() );
                 else
                     pts.push_back(pt2);
                 pt1 = pt2;
             }
             if( thickness < 0 )
                 cv::CollectPolyEdges( img, &pts[0], (int)pts.size(),
-                                      edges, ext_buf, line_type, 0, cv::Point() );
+                                      edges, ext_buf, line_type, 0, cv::Point(), cv::Range::all() );
         }
     }
 
     if( thickness < 0 )
-        cv::FillEdgeCollection( img, edges, ext_buf );
+        cv::FillEdgeCollection( img, edges, ext_buf, cv::Range::all() );
 
     if( h_next && contour0 )
         contour0->h_next = h_next;
@@ -1385,6 +1385,20 @@ static bool replacementSepFilter(int stype, int dtype, int ktype,
     return success;
 }
 
+// The separable filter keeps the last kernel height rows of the row filter output in a ring buffer,
+// which the column filter reads. Wide images are processed in vertical strips, so that the ring
+// buffer of a strip stays in the L1 cache.
+enum { SEP_FILTER_RING_BUFFER_SIZE = 1 << 15, SEP_FILTER_MIN_STRIP_WIDTH = 128 };
+
+static int sepFilterStripWidth(const FilterEngine& f, int width)
+{
+    int rowSize = (f.ksize.height + 3)*(int)CV_ELEM_SIZE(f.bufType);
+    if( f.ksize.height == 1 || width*rowSize <= SEP_FILTER_RING_BUFFER_SIZE*3/2 )
+        return width;
+    int stripWidth = std::max((SEP_FILTER_RING_BUFFER_SIZE/rowSize) & -16, (int)SEP_FILTER_MIN_STRIP_WIDTH);
+    return stripWidth*3/2 < width ? stripWidth : width;
+}
+
 static void ocvSepFilter(int stype, int dtype, int ktype,
                          uchar* src_data, size_t src_step, uchar* dst_data, size_t dst_step,
                          int width, int height, int full_width, int full_height,
@@ -1400,8 +1414,33 @@ static void ocvSepFilter(int stype, int dtype, int ktype,
                                                       delta, borderType & ~BORDER_ISOLATED);
     Mat src(Size(width, height), stype, src_data, src_step);
     Mat dst(Size(width, height), dtype, dst_data, dst_step);
-    f->apply(src, dst, Size(full_width, full_height), Point(offset_x, offset_y));
-};
+
+    // a strip must not overwrite the source pixels read by the neighbor strips
+    const uchar* src_start = src_data - offset_y*src_step - offset_x*CV_ELEM_SIZE(stype);
+    const uchar* src_end = src_start + full_height*src_step;
+    bool overlap = dst_data < src_end && src_start < dst_data + height*dst_step;
+    int stripWidth = overlap ? width : sepFilterStripWidth(*f, width);
+    if( stripWidth >= width )
+    {
+        f->apply(src, dst, Size(full_width, full_height), Point(offset_x, offset_y));
+        return;
+    }
+
+    // the strips only depend on the image and the kernels, so does the result
+    int nstrips = (width + stripWidth - 1)/stripWidth;
+    parallel_for_(Range(0, nstrips), [&](const Range& range)
+    {
+        Ptr<FilterEngine> sf = range.start == 0 ? f :
+            createSeparableLinearFilter(stype, dtype, kernelX, kernelY, Point(anchor_x, anchor_y),
+                                        delta, borderType & ~BORDER_ISOLATED);
+        for( int s = range.start; s < range.end; s++ )
+        {
+            int x0 = s*stripWidth, x1 = std::min(x0 + stripWidth, width);
+            Mat dstStrip = dst.colRange(x0, x1);
+            sf->apply(src.colRange(x0, x1), dstStrip, Size(full_width, full_height), Point(offset_x + x0, offset_y));
+        }
+    });
+}
 
 //===================================================================
 //       HAL functions
@@ -2407,6 +2407,354 @@ struct FilterVec_32f
     float delta;
 };
 
+/////////////////////////// fixed size symmetrical/asymmetrical kernels ///////////////////////////
+
+// The kernel size is a compile-time constant, so the loops over the taps are fully unrolled and
+// the coefficients stay in registers. Symmetrical kernels add the mirrored taps first, asymmetrical
+// kernels subtract them, which halves the number of multiplications.
+
+template<int ksize> struct SymmRowFixedVec_8u32s
+{
+    enum { ksize2 = ksize/2, npairs = ksize2/2 + 1 };
+
+    SymmRowFixedVec_8u32s() { smallValues = false; symmetrical = true; }
+    SymmRowFixedVec_8u32s( const Mat& _kernel, int _symmetryType )
+    {
+        CV_Assert( (int)_kernel.total() == ksize );
+        symmetrical = (_symmetryType & KERNEL_SYMMETRICAL) != 0;
+        smallValues = true;
+        const int* kx = _kernel.ptr<int>() + ksize2;
+        int c[npairs*2] = {0};
+        for( int k = 0; k <= ksize2; k++ )
+        {
+            if( kx[k] < SHRT_MIN || kx[k] > SHRT_MAX )
+                smallValues = false;
+            c[k] = kx[k];
+        }
+        // the taps k and k+1 are multiplied at once by v_dotprod
+        for( int k = 0; k < npairs; k++ )
+            coeffs[k] = (c[k*2] & 0xFFFF) | (c[k*2 + 1] << 16);
+    }
+
+    int operator()(const uchar* _src, uchar* _dst, int width, int cn) const
+    {
+        CV_INSTRUMENT_REGION();
+
+        int i = 0;
+        if( !smallValues )
+            return 0;
+        const uchar* src = _src + ksize2*cn;
+        int* dst = (int*)_dst;
+        width *= cn;
+
+        v_int16 f[npairs];
+        for( int k = 0; k < npairs; k++ )
+            f[k] = v_reinterpret_as_s16(vx_setall_s32(coeffs[k]));
+
+        for( ; i <= width - v_uint16::nlanes; i += v_uint16::nlanes, src += v_uint16::nlanes )
+        {
+            v_int16 x[npairs*2];
+            x[0] = v_reinterpret_as_s16(vx_load_expand(src));
+            for( int k = 1; k < npairs*2; k++ )
+            {
+                if( k > ksize2 )
+                    x[k] = vx_setzero_s16();
+                else if( symmetrical )
+                    x[k] = v_reinterpret_as_s16(vx_load_expand(src + k*cn) + vx_load_expand(src - k*cn));
+                else
+                    x[k] = v_reinterpret_as_s16(vx_load_expand(src + k*cn)) - v_reinterpret_as_s16(vx_load_expand(src - k*cn));
+            }
+            v_int32 s0 = vx_setzero_s32(), s1 = vx_setzero_s32();
+            for( int k = 0; k < npairs; k++ )
+            {
+                v_int16 z0, z1;
+                v_zip(x[k*2], x[k*2 + 1], z0, z1);
+                s0 += v_dotprod(z0, f[k]);
+                s1 += v_dotprod(z1, f[k]);
+            }
+            v_store(dst + i, s0);
+            v_store(dst + i + v_int32::nlanes, s1);
+        }
+        return i;
+    }
+
+    int coeffs[npairs];
+    bool smallValues, symmetrical;
+};
+
+template<int ksize> struct SymmRowFixedVec_32f
+{
+    enum { ksize2 = ksize/2 };
+
+    SymmRowFixedVec_32f() { symmetrical = true; }
+    SymmRowFixedVec_32f( const Mat& _kernel, int _symmetryType )
+    {
+        CV_Assert( (int)_kernel.total() == ksize );
+        symmetrical = (_symmetryType & KERNEL_SYMMETRICAL) != 0;
+        const float* kx = _kernel.ptr<float>() + ksize2;
+        for( int k = 0; k <= ksize2; k++ )
+            coeffs[k] = kx[k];
+    }
+
+    int operator()(const uchar* _src, uchar* _dst, int width, int cn) const
+    {
+        CV_INSTRUMENT_REGION();
+
+        int i = 0;
+        const float* src = (const float*)_src + ksize2*cn;
+        float* dst = (float*)_dst;
+        width *= cn;
+
+        v_float32 f[ksize2 + 1];
+        for( int k = 0; k <= ksize2; k++ )
+            f[k] = vx_setall_f32(coeffs[k]);
+
+        if( symmetrical )
+        {
+            for( ; i <= width - 2*v_float32::nlanes; i += 2*v_float32::nlanes, src += 2*v_float32::nlanes )
+            {
+                v_float32 s0 = vx_load(src) * f[0];
+                v_float32 s1 = vx_load(src + v_float32::nlanes) * f[0];
+                for( int k = 1; k <= ksize2; k++ )
+                {
+                    s0 = v_muladd(vx_load(src + k*cn) + vx_load(src - k*cn), f[k], s0);
+                    s1 = v_muladd(vx_load(src + k*cn + v_float32::nlanes) + vx_load(src - k*cn + v_float32::nlanes), f[k], s1);
+                }
+                v_store(dst + i, s0);
+                v_store(dst + i + v_float32::nlanes, s1);
+            }
+            for( ; i <= width - v_float32::nlanes; i += v_float32::nlanes, src += v_float32::nlanes )
+            {
+                v_float32 s0 = vx_load(src) * f[0];
+                for( int k = 1; k <= ksize2; k++ )
+                    s0 = v_muladd(vx_load(src + k*cn) + vx_load(src - k*cn), f[k], s0);
+                v_store(dst + i, s0);
+            }
+        }
+        else
+        {
+            for( ; i <= width - 2*v_float32::nlanes; i += 2*v_float32::nlanes, src += 2*v_float32::nlanes )
+            {
+                v_float32 s0 = (vx_load(src + cn) - vx_load(src - cn)) * f[1];
+                v_float32 s1 = (vx_load(src + cn + v_float32::nlanes) - vx_load(src - cn + v_float32::nlanes)) * f[1];
+                for( int k = 2; k <= ksize2; k++ )
+                {
+                    s0 = v_muladd(vx_load(src + k*cn) - vx_load(src - k*cn), f[k], s0);
+                    s1 = v_muladd(vx_load(src + k*cn + v_float32::nlanes) - vx_load(src - k*cn + v_float32::nlanes), f[k], s1);
+                }
+                v_store(dst + i, s0);
+                v_store(dst + i + v_float32::nlanes, s1);
+            }
+            for( ; i <= width - v_float32::nlanes; i += v_float32::nlanes, src += v_float32::nlanes )
+            {
+                v_float32 s0 = (vx_load(src + cn) - vx_load(src - cn)) * f[1];
+                for( int k = 2; k <= ksize2; k++ )
+                    s0 = v_muladd(vx_load(src + k*cn) - vx_load(src - k*cn), f[k], s0);
+                v_store(dst + i, s0);
+            }
+        }
+        return i;
+    }
+
+    float coeffs[ksize2 + 1];
+    bool symmetrical;
+};
+
+template<int ksize> struct SymmColumnFixedVec_32s8u
+{
+    enum { ksize2 = ksize/2 };
+
+    SymmColumnFixedVec_32s8u() { symmetrical = true; delta = 0; }
+    SymmColumnFixedVec_32s8u( const Mat& _kernel, int _symmetryType, int _bits, double _delta )
+    {
+        CV_Assert( (int)_kernel.total() == ksize );
+        symmetrical = (_symmetryType & KERNEL_SYMMETRICAL) != 0;
+        const int* ky = _kernel.ptr<int>() + ksize2;
+        for( int k = 0; k <= ksize2; k++ )
+            coeffs[k] = (float)(ky[k]*(1./(1 << _bits)));
+        delta = (float)(_delta/(1 << _bits));
+    }
+
+    int operator()(const uchar** _src, uchar* dst, int width) const
+    {
+        CV_INSTRUMENT_REGION();
+
+        int i = 0;
+        const int** src = (const int**)_src;
+        v_float32 f[ksize2 + 1];
+        for( int k = 0; k <= ksize2; k++ )
+            f[k] = vx_setall_f32(coeffs[k]);
+        v_float32 d4 = vx_setall_f32(delta);
+
+        for( ; i <= width - v_uint16::nlanes; i += v_uint16::nlanes )
+        {
+            v_float32 s0, s1;
+            if( symmetrical )
+            {
+                s0 = v_muladd(v_cvt_f32(vx_load(src[0] + i)), f[0], d4);
+                s1 = v_muladd(v_cvt_f32(vx_load(src[0] + i + v_int32::nlanes)), f[0], d4);
+                for( int k = 1; k <= ksize2; k++ )
+                {
+                    s0 = v_muladd(v_cvt_f32(vx_load(src[k] + i) + vx_load(src[-k] + i)), f[k], s0);
+                    s1 = v_muladd(v_cvt_f32(vx_load(src[k] + i + v_int32::nlanes) + vx_load(src[-k] + i + v_int32::nlanes)), f[k], s1);
+                }
+            }
+            else
+            {
+                s0 = s1 = d4;
+                for( int k = 1; k <= ksize2; k++ )
+                {
+                    s0 = v_muladd(v_cvt_f32(vx_load(src[k] + i) - vx_load(src[-k] + i)), f[k], s0);
+                    s1 = v_muladd(v_cvt_f32(vx_load(src[k] + i + v_int32::nlanes) - vx_load(src[-k] + i + v_int32::nlanes)), f[k], s1);
+                }
+            }
+            v_pack_u_store(dst + i, v_pack(v_round(s0), v_round(s1)));
+        }
+        return i;
+    }
+
+    float coeffs[ksize2 + 1];
+    float delta;
+    bool symmetrical;
+};
+
+template<int ksize> struct SymmColumnFixedVec_32s16s
+{
+    enum { ksize2 = ksize/2 };
+
+    SymmColumnFixedVec_32s16s() { symmetrical = true; delta = 0; }
+    SymmColumnFixedVec_32s16s( const Mat& _kernel, int _symmetryType, int, double _delta )
+    {
+        CV_Assert( (int)_kernel.total() == ksize );
+        symmetrical = (_symmetryType & KERNEL_SYMMETRICAL) != 0;
+        const int* ky = _kernel.ptr<int>() + ksize2;
+        for( int k = 0; k <= ksize2; k++ )
+            coeffs[k] = ky[k];
+        delta = saturate_cast<int>(_delta);
+    }
+
+    // the same integer arithmetic as the scalar code, so the results are bit-exact
+    int operator()(const uchar** _src, uchar* _dst, int width) const
+    {
+        CV_INSTRUMENT_REGION();
+
+        int i = 0;
+        const int** src = (const int**)_src;
+        short* dst = (short*)_dst;
+        v_int32 f[ksize2 + 1];
+        for( int k = 0; k <= ksize2; k++ )
+            f[k] = vx_setall_s32(coeffs[k]);
+        v_int32 d4 = vx_setall_s32(delta);
+
+        for( ; i <= width - v_int16::nlanes; i += v_int16::nlanes )
+        {
+            v_int32 s0, s1;
+            if( symmetrical )
+            {
+                s0 = vx_load(src[0] + i) * f[0] + d4;
+                s1 = vx_load(src[0] + i + v_int32::nlanes) * f[0] + d4;
+                for( int k = 1; k <= ksize2; k++ )
+                {
+                    s0 += (vx_load(src[k] + i) + vx_load(src[-k] + i)) * f[k];
+                    s1 += (vx_load(src[k] + i + v_int32::nlanes) + vx_load(src[-k] + i + v_int32::nlanes)) * f[k];
+                }
+            }
+            else
+            {
+                s0 = s1 = d4;
+                for( int k = 1; k <= ksize2; k++ )
+                {
+                    s0 += (vx_load(src[k] + i) - vx_load(src[-k] + i)) * f[k];
+                    s1 += (vx_load(src[k] + i + v_int32::nlanes) - vx_load(src[-k] + i + v_int32::nlanes)) * f[k];
+                }
+            }
+            v_store(dst + i, v_pack(s0, s1));
+        }
+        return i;
+    }
+
+    int coeffs[ksize2 + 1];
+    int delta;
+    bool symmetrical;
+};
+
+template<int ksize> struct SymmColumnFixedVec_32f
+{
+    enum { ksize2 = ksize/2 };
+
+    SymmColumnFixedVec_32f() { symmetrical = true; delta = 0; }
+    SymmColumnFixedVec_32f( const Mat& _kernel, int _symmetryType, int, double _delta )
+    {
+        CV_Assert( (int)_kernel.total() == ksize );
+        symmetrical = (_symmetryType & KERNEL_SYMMETRICAL) != 0;
+        const float* ky = _kernel.ptr<float>() + ksize2;
+        for( int k = 0; k <= ksize2; k++ )
+            coeffs[k] = ky[k];
+        delta = (float)_delta;
+    }
+
+    int operator()(const uchar** _src, uchar* _dst, int width) const
+    {
+        CV_INSTRUMENT_REGION();
+
+        int i = 0;
+        const float** src = (const float**)_src;
+        float* dst = (float*)_dst;
+        v_float32 f[ksize2 + 1];
+        for( int k = 0; k <= ksize2; k++ )
+            f[k] = vx_setall_f32(coeffs[k]);
+        v_float32 d4 = vx_setall_f32(delta);
+
+        for( ; i <= width - 2*v_float32::nlanes; i += 2*v_float32::nlanes )
+        {
+            v_float32 s0, s1;
+            if( symmetrical )
+            {
+                s0 = v_muladd(vx_load(src[0] + i), f[0], d4);
+                s1 = v_muladd(vx_load(src[0] + i + v_float32::nlanes), f[0], d4);
+                for( int k = 1; k <= ksize2; k++ )
+                {
+                    s0 = v_muladd(vx_load(src[k] + i) + vx_load(src[-k] + i), f[k], s0);
+                    s1 = v_muladd(vx_load(src[k] + i + v_float32::nlanes) + vx_load(src[-k] + i + v_float32::nlanes), f[k], s1);
+                }
+            }
+            else
+            {
+                s0 = s1 = d4;
+                for( int k = 1; k <= ksize2; k++ )
+                {
+                    s0 = v_muladd(vx_load(src[k] + i) - vx_load(src[-k] + i), f[k], s0);
+                    s1 = v_muladd(vx_load(src[k] + i + v_float32::nlanes) - vx_load(src[-k] + i + v_float32::nlanes), f[k], s1);
+                }
+            }
+            v_store(dst + i, s0);
+            v_store(dst + i + v_float32::nlanes, s1);
+        }
+        for( ; i <= width - v_float32::nlanes; i += v_float32::nlanes )
+        {
+            v_float32 s0;
+            if( symmetrical )
+            {
+                s0 = v_muladd(vx_load(src[0] + i), f[0], d4);
+                for( int k = 1; k <= ksize2; k++ )
+                    s0 = v_muladd(vx_load(src[k] + i) + vx_load(src[-k] + i), f[k], s0);
+            }
+            else
+            {
+                s0 = d4;
+                for( int k = 1; k <= ksize2; k++ )
+                    s0 = v_muladd(vx_load(src[k] + i) - vx_load(src[-k] + i), f[k], s0);
+            }
+            v_store(dst + i, s0);
+        }
+        return i;
+    }
+
+    float coeffs[ksize2 + 1];
+    float delta;
+    bool symmetrical;
+};
+
 #else
 
 typedef RowNoVec RowVec_8u32s;
@@ -2424,6 +2772,11 @@ typedef SymmColumnSmallNoVec SymmColumnSmallVec_32f;
 typedef FilterNoVec FilterVec_8u;
 typedef FilterNoVec FilterVec_8u16s;
 typedef FilterNoVec FilterVec_32f;
+template<int> using SymmRowFixedVec_8u32s = SymmRowSmallNoVec;
+template<int> using SymmRowFixedVec_32f = SymmRowSmallNoVec;
+template<int> using SymmColumnFixedVec_32s8u = ColumnNoVec;
+template<int> using SymmColumnFixedVec_32s16s = ColumnNoVec;
+template<int> using SymmColumnFixedVec_32f = ColumnNoVec;
 
 #endif
 
@@ -2991,6 +3344,43 @@ template<typename ST, typename DT> struct FixedPtCastEx
 };
 
 
+template<typename ST, typename DT, template<int> class VecOp>
+static Ptr<BaseRowFilter> makeSymmRowFixedFilter(const Mat& kernel, int anchor, int symmetryType)
+{
+    switch( kernel.rows + kernel.cols - 1 )
+    {
+    case 7:
+        return makePtr<RowFilter<ST, DT, VecOp<7> > >(kernel, anchor, VecOp<7>(kernel, symmetryType));
+    case 9:
+        return makePtr<RowFilter<ST, DT, VecOp<9> > >(kernel, anchor, VecOp<9>(kernel, symmetryType));
+    case 11:
+        return makePtr<RowFilter<ST, DT, VecOp<11> > >(kernel, anchor, VecOp<11>(kernel, symmetryType));
+    }
+    return Ptr<BaseRowFilter>();
+}
+
+template<class CastOp, template<int> class VecOp>
+static Ptr<BaseColumnFilter> makeSymmColumnFixedFilter(const Mat& kernel, int anchor, double delta,
+                                                       int symmetryType, const CastOp& castOp, int bits)
+{
+    switch( kernel.rows + kernel.cols - 1 )
+    {
+    case 5:
+        return makePtr<SymmColumnFilter<CastOp, VecOp<5> > >
+            (kernel, anchor, delta, symmetryType, castOp, VecOp<5>(kernel, symmetryType, bits, delta));
+    case 7:
+        return makePtr<SymmColumnFilter<CastOp, VecOp<7> > >
+            (kernel, anchor, delta, symmetryType, castOp, VecOp<7>(kernel, symmetryType, bits, delta));
+    case 9:
+        return makePtr<SymmColumnFilter<CastOp, VecOp<9> > >
+            (kernel, anchor, delta, symmetryType, castOp, VecOp<9>(kernel, symmetryType, bits, delta));
+    case 11:
+        return makePtr<SymmColumnFilter<CastOp, VecOp<11> > >
+            (kernel, anchor, delta, symmetryType, castOp, VecOp<11>(kernel, symmetryType, bits, delta));
+    }
+    return Ptr<BaseColumnFilter>();
+}
+
 Ptr<BaseRowFilter> getLinearRowFilter(
         int srcType, int bufType,
         const Mat& kernel, int anchor,
@@ -3014,6 +3404,16 @@ Ptr<BaseRowFilter> getLinearRowFilter(
             return makePtr<SymmRowSmallFilter<float, float, SymmRowSmallVec_32f> >
                 (kernel, anchor, symmetryType, SymmRowSmallVec_32f(kernel, symmetryType));
     }
+    else if( (symmetryType & (KERNEL_SYMMETRICAL|KERNEL_ASYMMETRICAL)) != 0 )
+    {
+        Ptr<BaseRowFilter> f;
+        if( sdepth == CV_8U && ddepth == CV_32S )
+            f = makeSymmRowFixedFilter<uchar, int, SymmRowFixedVec_8u32s>(kernel, anchor, symmetryType);
+        else if( sdepth == CV_32F && ddepth == CV_32F )
+            f = makeSymmRowFixedFilter<float, float, SymmRowFixedVec_32f>(kernel, anchor, symmetryType);
+        if( f )
+            return f;
+    }
 
     if( sdepth == CV_8U && ddepth == CV_32S )
         return makePtr<RowFilter<uchar, int, RowVec_8u32s> >
@@ -3102,6 +3502,21 @@ Ptr<BaseColumnFilter> getLinearColumnFilter(
                     (kernel, anchor, delta, symmetryType, Cast<float, float>(),
                     SymmColumnSmallVec_32f(kernel, symmetryType, 0, delta));
         }
+        else
+        {
+            Ptr<BaseColumnFilter> f;
+            if( ddepth == CV_8U && sdepth == CV_32S )
+                f = makeSymmColumnFixedFilter<FixedPtCastEx<int, uchar>, SymmColumnFixedVec_32s8u>
+                    (kernel, anchor, delta, symmetryType, FixedPtCastEx<int, uchar>(bits), bits);
+            else if( ddepth == CV_16S && sdepth == CV_32S && bits == 0 )
+                f = makeSymmColumnFixedFilter<Cast<int, short>, SymmColumnFixedVec_32s16s>
+                    (kernel, anchor, delta, symmetryType, Cast<int, short>(), bits);
+            else if( ddepth == CV_32F && sdepth == CV_32F )
+                f = makeSymmColumnFixedFilter<Cast<float, float>, SymmColumnFixedVec_32f>
+                    (kernel, anchor, delta, symmetryType, Cast<float, float>(), bits);
+            if( f )
+                return f;
+        }
         if( ddepth == CV_8U && sdepth == CV_32S )
             return makePtr<SymmColumnFilter<FixedPtCastEx<int, uchar>, SymmColumnVec_32s8u> >
                 (kernel, anchor, delta, symmetryType, FixedPtCastEx<int, uchar>(bits),
@@ -448,181 +448,483 @@ floodFillGrad_CnIR( Mat& image, Mat& msk,
         region->rect.height = YMax - YMin + 1;
     }
 }
-
-}
-
 /****************************************************************************************\
-*                                    External Functions                                  *
+*                                   Parallel Floodfill                                   *
 \****************************************************************************************/
 
-int cv::floodFill( InputOutputArray _image, InputOutputArray _mask,
-                  Point seedPoint, Scalar newVal, Rect* rect,
-                  Scalar loDiff, Scalar upDiff, int flags )
+// The pixel predicates of the fills whose domain does not depend on the filling order:
+// the simple fill and the fixed range fill. The domain is the connected component of the
+// pixels satisfying the predicate, so it can be grown in horizontal bands independently.
+
+template<typename _Tp>
+struct FFillSimplePixel
 {
-    CV_INSTRUMENT_REGION();
+    typedef _Tp* Row;
 
-    ConnectedComp comp;
-    std::vector<FFillSegment> buffer;
+    FFillSimplePixel(Mat& _image, _Tp _val0, _Tp _newVal) : image(_image), val0(_val0), newVal(_newVal) {}
+    Row row(int y) const { return image.ptr<_Tp>(y); }
+    bool fillable(Row r, int x) const { return r[x] == val0; }
+    void fill(Row r, int x) const { r[x] = newVal; }
 
-    if( rect )
-        *rect = Rect();
+    Mat& image;
+    _Tp val0, newVal;
+};
 
-    int i;
-    union {
-        uchar b[4];
-        int i[4];
-        float f[4];
-        double _[4];
-    } nv_buf;
-    nv_buf._[0] = nv_buf._[1] = nv_buf._[2] = nv_buf._[3] = 0;
+template<typename _Tp, class Diff>
+struct FFillRangePixel
+{
+    struct Row { _Tp* img; uchar* mask; };
 
-    struct { Vec3b b; Vec3i i; Vec3f f; } ld_buf, ud_buf;
-    Mat img = _image.getMat(), mask;
-    if( !_mask.empty() )
-        mask = _mask.getMat();
-    Size size = img.size();
+    FFillRangePixel(Mat& _image, Mat& _mask, _Tp _val0, _Tp _newVal, uchar _newMaskVal,
+                    Diff _diff, bool _fillImage)
+        : image(_image), mask(_mask), val0(_val0), newVal(_newVal), newMaskVal(_newMaskVal),
+          diff(_diff), fillImage(_fillImage) {}
+    Row row(int y) const
+    {
+        Row r = { image.ptr<_Tp>(y), mask.ptr<uchar>(y + 1) + 1 };
+        return r;
+    }
+    bool fillable(const Row& r, int x) const { return !r.mask[x] && diff(r.img + x, &val0); }
+    void fill(const Row& r, int x) const
+    {
+        r.mask[x] = newMaskVal;
+        if( fillImage )
+            r.img[x] = newVal;
+    }
+
+    Mat& image;
+    Mat& mask;
+    _Tp val0, newVal;
+    uchar newMaskVal;
+    Diff diff;
+    bool fillImage;
+};
+
+// a filled run of the row y, found from the run [prevl, prevr] of the row y - dir
+struct FFillRun
+{
+    FFillRun(int _y, int _l, int _r, int _prevl, int _prevr, int _dir)
+        : y(_y), l(_l), r(_r), prevl(_prevl), prevr(_prevr), dir(_dir) {}
+    int y, l, r, prevl, prevr, dir;
+};
 
-    int type = img.type();
-    int depth = img.depth();
-    int cn = img.channels();
+enum { FFILL_BAND_HEIGHT = 64 };
 
-    if ( (cn != 1) && (cn != 3) )
+struct FFillBand
+{
+    FFillBand() : area(0), XMin(INT_MAX), XMax(-1), YMin(INT_MAX), YMax(-1) {}
+    std::vector<FFillRun> pending;  // ranges of this band to scan from the runs of the neighbor bands
+    std::vector<FFillRun> up, down; // ranges of the neighbor bands to scan from the runs of this band
+    int area, XMin, XMax, YMin, YMax;
+};
+
+template<class Pixel>
+class FloodFillBandInvoker : public ParallelLoopBody
+{
+public:
+    FloodFillBandInvoker(const Pixel& _pix, Size _size, int _connectivity8, Point _seed,
+                         std::vector<FFillBand>& _bands, const std::vector<int>& _active)
+        : pix(_pix), size(_size), connectivity8(_connectivity8), seed(_seed),
+          bands(_bands), active(_active) {}
+
+    void operator()(const Range& range) const CV_OVERRIDE
     {
-        CV_Error( CV_StsBadArg, "Number of channels in input image must be 1 or 3" );
-    }
+        std::vector<FFillRun> stack;
+        for( int k = range.start; k < range.end; k++ )
+        {
+            int b = active[k];
+            FFillBand& band = bands[b];
+            int y0 = b*FFILL_BAND_HEIGHT, y1 = std::min(y0 + FFILL_BAND_HEIGHT, size.height);
+
+            stack.clear();
+            if( y0 <= seed.y && seed.y < y1 )
+                scanRow(seed.y, seed.x, seed.x, seed.x + 1, seed.x, UP, stack);
+            for( size_t i = 0; i < band.pending.size(); i++ )
+            {
+                const FFillRun& run = band.pending[i];
+                scanRow(run.y + run.dir, run.prevl, run.prevr, run.l, run.r, run.dir, stack);
+            }
+            band.pending.clear();
 
-    const int connectivity = flags & 255;
-    if( connectivity != 0 && connectivity != 4 && connectivity != 8 )
-        CV_Error( CV_StsBadFlag, "Connectivity must be 4, 0(=4) or 8" );
+            while( !stack.empty() )
+            {
+                FFillRun run = stack.back();
+                stack.pop_back();
+
+                band.area += run.r - run.l + 1;
+                band.XMin = std::min(band.XMin, run.l);
+                band.XMax = std::max(band.XMax, run.r);
+                band.YMin = std::min(band.YMin, run.y);
+                band.YMax = std::max(band.YMax, run.y);
+
+                // away from the parent run the whole neighborhood is scanned,
+                // towards it only the part not covered by the parent run
+                int L = run.l - connectivity8, R = run.r + connectivity8;
+                spread(run, run.dir, L, R, y0, y1, band, stack);
+                spread(run, -run.dir, L, run.prevl - 1, y0, y1, band, stack);
+                spread(run, -run.dir, run.prevr + 1, R, y0, y1, band, stack);
+            }
+        }
+    }
 
-    bool is_simple = mask.empty() && (flags & FLOODFILL_MASK_ONLY) == 0;
+private:
+    // scans [left, right] of the row next to the run in the direction dir,
+    // or passes the run to the neighbor band if the row belongs to it
+    void spread(const FFillRun& run, int dir, int left, int right, int y0, int y1,
+                FFillBand& band, std::vector<FFillRun>& stack) const
+    {
+        int y = run.y + dir;
+        if( left > right || (unsigned)y >= (unsigned)size.height )
+            return;
+        if( y < y0 || y >= y1 )
+        {
+            // the range to scan is kept in place of the parent run
+            (y < y0 ? band.up : band.down).push_back(FFillRun(run.y, run.l, run.r, left, right, dir));
+            return;
+        }
+        scanRow(y, left, right, run.l, run.r, dir, stack);
+    }
 
-    for( i = 0; i < cn; i++ )
+    // fills the runs of the row y intersecting [left, right] and pushes them to the stack
+    void scanRow(int y, int left, int right, int prevl, int prevr, int dir, std::vector<FFillRun>& stack) const
     {
-        if( loDiff[i] < 0 || upDiff[i] < 0 )
-            CV_Error( CV_StsBadArg, "lo_diff and up_diff must be non-negative" );
-        is_simple = is_simple && fabs(loDiff[i]) < DBL_EPSILON && fabs(upDiff[i]) < DBL_EPSILON;
+        // a local copy, so that the compiler does not reload it after every written pixel
+        const Pixel p(pix);
+        const typename Pixel::Row r = p.row(y);
+        const int width = size.width;
+        left = std::max(left, 0);
+        right = std::min(right, width - 1);
+        for( int i = left; i <= right; i++ )
+        {
+            if( p.fillable(r, i) )
+            {
+                int j = i;
+                p.fill(r, i);
+                while( j > 0 && p.fillable(r, j - 1) )
+                    p.fill(r, --j);
+                while( i < width - 1 && p.fillable(r, i + 1) )
+                    p.fill(r, ++i);
+                stack.push_back(FFillRun(y, j, i, prevl, prevr, dir));
+            }
+        }
     }
 
-    if( (unsigned)seedPoint.x >= (unsigned)size.width ||
-       (unsigned)seedPoint.y >= (unsigned)size.height )
-        CV_Error( CV_StsOutOfRange, "Seed point is outside of image" );
+    const Pixel& pix;
+    Size size;
+    int connectivity8;
+    Point seed;
+    std::vector<FFillBand>& bands;
+    const std::vector<int>& active;
+};
 
-    scalarToRawData( newVal, &nv_buf, type, 0);
-    size_t buffer_size = MAX( size.width, size.height ) * 2;
-    buffer.resize( buffer_size );
+// Grows the component in every band reached so far in parallel, then passes the runs
+// touching the band borders to the neighbor bands, until no band has anything to grow.
+template<class Pixel>
+static void
+floodFillBands_CnIR( const Pixel& pix, Size size, Point seed, ConnectedComp* region, int flags )
+{
+    int nbands = (size.height + FFILL_BAND_HEIGHT - 1) / FFILL_BAND_HEIGHT;
+    int _8_connectivity = (flags & 255) == 8;
+    std::vector<FFillBand> bands(nbands);
+    std::vector<int> active(1, seed.y / FFILL_BAND_HEIGHT);
 
-    if( is_simple )
+    for( Point pt = seed; !active.empty(); pt = Point(-1, -1) )
     {
-        size_t elem_size = img.elemSize();
-        const uchar* seed_ptr = img.ptr(seedPoint.y) + elem_size*seedPoint.x;
+        parallel_for_(Range(0, (int)active.size()),
+                      FloodFillBandInvoker<Pixel>(pix, size, _8_connectivity, pt, bands, active));
 
-        size_t k = 0;
-        for(; k < elem_size; k++)
-            if (seed_ptr[k] != nv_buf.b[k])
-                break;
-
-        if( k != elem_size )
+        for( size_t k = 0; k < active.size(); k++ )
         {
-            if( type == CV_8UC1 )
-                floodFill_CnIR(img, seedPoint, nv_buf.b[0], &comp, flags, &buffer);
-            else if( type == CV_8UC3 )
-                floodFill_CnIR(img, seedPoint, Vec3b(nv_buf.b), &comp, flags, &buffer);
-            else if( type == CV_32SC1 )
-                floodFill_CnIR(img, seedPoint, nv_buf.i[0], &comp, flags, &buffer);
-            else if( type == CV_32FC1 )
-                floodFill_CnIR(img, seedPoint, nv_buf.f[0], &comp, flags, &buffer);
-            else if( type == CV_32SC3 )
-                floodFill_CnIR(img, seedPoint, Vec3i(nv_buf.i), &comp, flags, &buffer);
-            else if( type == CV_32FC3 )
-                floodFill_CnIR(img, seedPoint, Vec3f(nv_buf.f), &comp, flags, &buffer);
-            else
-                CV_Error( CV_StsUnsupportedFormat, "" );
-            if( rect )
-                *rect = comp.rect;
-            return comp.area;
+            int b = active[k];
+            if( b > 0 )
+                bands[b - 1].pending.insert(bands[b - 1].pending.end(), bands[b].up.begin(), bands[b].up.end());
+            if( b < nbands - 1 )
+                bands[b + 1].pending.insert(bands[b + 1].pending.end(), bands[b].down.begin(), bands[b].down.end());
+            bands[b].up.clear();
+            bands[b].down.clear();
         }
+
+        active.clear();
+        for( int b = 0; b < nbands; b++ )
+            if( !bands[b].pending.empty() )
+                active.push_back(b);
     }
 
-    if( mask.empty() )
+    int area = 0, XMin = INT_MAX, XMax = -1, YMin = INT_MAX, YMax = -1;
+    for( int b = 0; b < nbands; b++ )
     {
-        Mat tempMask( size.height + 2, size.width + 2, CV_8UC1 );
-        tempMask.setTo(Scalar::all(0));
-        mask = tempMask;
+        const FFillBand& band = bands[b];
+        area += band.area;
+        XMin = std::min(XMin, band.XMin);
+        XMax = std::max(XMax, band.XMax);
+        YMin = std::min(YMin, band.YMin);
+        YMax = std::max(YMax, band.YMax);
     }
-    else
+
+    region->pt = seed;
+    region->area = area;
+    if( area > 0 )
+        region->rect = Rect(XMin, YMin, XMax - XMin + 1, YMax - YMin + 1);
+}
+
+/****************************************************************************************\
+*                                  Floodfill Dispatcher                                  *
+\****************************************************************************************/
+
+// Validates the arguments and prepares the buffers and the mask once for any number of seeds.
+// Every fill gives the same result as a separate floodFill call with the same arguments.
+class FloodFillImpl
+{
+public:
+    FloodFillImpl( const Mat& _img, const Mat& _mask, const Scalar& loDiff, const Scalar& upDiff, int _flags )
+        : img(_img), mask(_mask), flags(_flags), tempMask(_mask.empty())
     {
-        CV_Assert( mask.rows == size.height+2 && mask.cols == size.width+2 );
-        CV_Assert( mask.type() == CV_8U );
-    }
+        type = img.type();
+        depth = img.depth();
+        cn = img.channels();
+        Size size = img.size();
+
+        if ( (cn != 1) && (cn != 3) )
+        {
+            CV_Error( CV_StsBadArg, "Number of channels in input image must be 1 or 3" );
+        }
+
+        const int connectivity = flags & 255;
+        if( connectivity != 0 && connectivity != 4 && connectivity != 8 )
+            CV_Error( CV_StsBadFlag, "Connectivity must be 4, 0(=4) or 8" );
+
+        is_simple = mask.empty() && (flags & FLOODFILL_MASK_ONLY) == 0;
+
+        for( int i = 0; i < cn; i++ )
+        {
+            if( loDiff[i] < 0 || upDiff[i] < 0 )
+                CV_Error( CV_StsBadArg, "lo_diff and up_diff must be non-negative" );
+            is_simple = is_simple && fabs(loDiff[i]) < DBL_EPSILON && fabs(upDiff[i]) < DBL_EPSILON;
+        }
+
+        if( !mask.empty() )
+        {
+            CV_Assert( mask.rows == size.height+2 && mask.cols == size.width+2 );
+            CV_Assert( mask.type() == CV_8U );
+            initMaskBorder();
+        }
+
+        if( depth == CV_8U )
+            for( int i = 0; i < cn; i++ )
+            {
+                ld_buf.b[i] = saturate_cast<uchar>(cvFloor(loDiff[i]));
+                ud_buf.b[i] = saturate_cast<uchar>(cvFloor(upDiff[i]));
+            }
+        else if( depth == CV_32S )
+            for( int i = 0; i < cn; i++ )
+            {
+                ld_buf.i[i] = cvFloor(loDiff[i]);
+                ud_buf.i[i] = cvFloor(upDiff[i]);
+            }
+        else if( depth == CV_32F )
+            for( int i = 0; i < cn; i++ )
+            {
+                ld_buf.f[i] = (float)loDiff[i];
+                ud_buf.f[i] = (float)upDiff[i];
+            }
+        else
+            CV_Error( CV_StsUnsupportedFormat, "" );
 
-    memset( mask.ptr(), 1, mask.cols );
-    memset( mask.ptr(mask.rows-1), 1, mask.cols );
+        newMaskVal = (uchar)((flags & 0xff00) == 0 ? 1 : ((flags >> 8) & 255));
+        // the floating range domain depends on the filling order, it is always filled sequentially
+        parallel = (flags & FLOODFILL_PARALLEL) != 0 && (is_simple || (flags & FLOODFILL_FIXED_RANGE) != 0);
+        buffer.resize( MAX( size.width, size.height ) * 2 );
+    }
 
-    for( i = 1; i <= size.height; i++ )
+    int fill( Point seedPoint, const Scalar& newVal, Rect* rect )
     {
-        mask.at<uchar>(i, 0) = mask.at<uchar>(i, mask.cols-1) = (uchar)1;
+        ConnectedComp comp;
+        Size size = img.size();
+
+        if( rect )
+            *rect = Rect();
+
+        if( (unsigned)seedPoint.x >= (unsigned)size.width ||
+           (unsigned)seedPoint.y >= (unsigned)size.height )
+            CV_Error( CV_StsOutOfRange, "Seed point is outside of image" );
+
+        union {
+            uchar b[4];
+            int i[4];
+            float f[4];
+            double _[4];
+        } nv_buf;
+        nv_buf._[0] = nv_buf._[1] = nv_buf._[2] = nv_buf._[3] = 0;
+        scalarToRawData( newVal, &nv_buf, type, 0);
+
+        if( is_simple )
+        {
+            size_t elem_size = img.elemSize();
+            const uchar* seed_ptr = img.ptr(seedPoint.y) + elem_size*seedPoint.x;
+
+            size_t k = 0;
+            for(; k < elem_size; k++)
+                if (seed_ptr[k] != nv_buf.b[k])
+                    break;
+
+            if( k != elem_size )
+            {
+                if( type == CV_8UC1 )
+                    fillSimple(seedPoint, nv_buf.b[0], comp);
+                else if( type == CV_8UC3 )
+                    fillSimple(seedPoint, Vec3b(nv_buf.b), comp);
+                else if( type == CV_32SC1 )
+                    fillSimple(seedPoint, nv_buf.i[0], comp);
+                else if( type == CV_32FC1 )
+                    fillSimple(seedPoint, nv_buf.f[0], comp);
+                else if( type == CV_32SC3 )
+                    fillSimple(seedPoint, Vec3i(nv_buf.i), comp);
+                else if( type == CV_32FC3 )
+                    fillSimple(seedPoint, Vec3f(nv_buf.f), comp);
+                else
+                    CV_Error( CV_StsUnsupportedFormat, "" );
+                if( rect )
+                    *rect = comp.rect;
+                return comp.area;
+            }
+        }
+
+        if( mask.empty() )
+        {
+            mask.create( size.height + 2, size.width + 2, CV_8UC1 );
+            mask.setTo(Scalar::all(0));
+            initMaskBorder();
+        }
+
+        if( type == CV_8UC1 )
+            fillGrad<uchar, int>(seedPoint, nv_buf.b[0], Diff8uC1(ld_buf.b[0], ud_buf.b[0]), comp);
+        else if( type == CV_8UC3 )
+            fillGrad<Vec3b, Vec3i>(seedPoint, Vec3b(nv_buf.b), Diff8uC3(ld_buf.b, ud_buf.b), comp);
+        else if( type == CV_32SC1 )
+            fillGrad<int, int>(seedPoint, nv_buf.i[0], Diff32sC1(ld_buf.i[0], ud_buf.i[0]), comp);
+        else if( type == CV_32SC3 )
+            fillGrad<Vec3i, Vec3i>(seedPoint, Vec3i(nv_buf.i), Diff32sC3(ld_buf.i, ud_buf.i), comp);
+        else if( type == CV_32FC1 )
+            fillGrad<float, float>(seedPoint, nv_buf.f[0], Diff32fC1(ld_buf.f[0], ud_buf.f[0]), comp);
+        else if( type == CV_32FC3 )
+            fillGrad<Vec3f, Vec3f>(seedPoint, Vec3f(nv_buf.f), Diff32fC3(ld_buf.f, ud_buf.f), comp);
+        else
+            CV_Error(CV_StsUnsupportedFormat, "");
+
+        // a separate call would start from a clean temporary mask
+        if( tempMask && comp.area > 0 )
+            mask(comp.rect + Point(1, 1)).setTo(Scalar::all(0));
+
+        if( rect )
+            *rect = comp.rect;
+        return comp.area;
     }
 
-    if( depth == CV_8U )
-        for( i = 0; i < cn; i++ )
+private:
+    void initMaskBorder()
+    {
+        memset( mask.ptr(), 1, mask.cols );
+        memset( mask.ptr(mask.rows-1), 1, mask.cols );
+
+        for( int i = 1; i < mask.rows - 1; i++ )
         {
-            ld_buf.b[i] = saturate_cast<uchar>(cvFloor(loDiff[i]));
-            ud_buf.b[i] = saturate_cast<uchar>(cvFloor(upDiff[i]));
+            mask.at<uchar>(i, 0) = mask.at<uchar>(i, mask.cols-1) = (uchar)1;
         }
-    else if( depth == CV_32S )
-        for( i = 0; i < cn; i++ )
+    }
+
+    template<typename _Tp>
+    void fillSimple( Point seedPoint, _Tp newVal, ConnectedComp& comp )
+    {
+        if( parallel )
+            floodFillBands_CnIR(FFillSimplePixel<_Tp>(img, img.at<_Tp>(seedPoint), newVal),
+                                img.size(), seedPoint, &comp, flags);
+        else
+            floodFill_CnIR(img, seedPoint, newVal, &comp, flags, &buffer);
+    }
+
+    template<typename _Tp, typename _WTp, class Diff>
+    void fillGrad( Point seedPoint, _Tp newVal, Diff diff, ConnectedComp& comp )
+    {
+        if( parallel )
         {
-            ld_buf.i[i] = cvFloor(loDiff[i]);
-            ud_buf.i[i] = cvFloor(upDiff[i]);
+            // the seed pixel must not be masked, as in the sequential fill
+            if( mask.at<uchar>(seedPoint.y + 1, seedPoint.x + 1) )
+                return;
+            floodFillBands_CnIR(FFillRangePixel<_Tp, Diff>(img, mask, img.at<_Tp>(seedPoint), newVal, newMaskVal,
+                                                           diff, (flags & FLOODFILL_MASK_ONLY) == 0),
+                                img.size(), seedPoint, &comp, flags);
+            comp.label = newMaskVal;
         }
-    else if( depth == CV_32F )
-        for( i = 0; i < cn; i++ )
+        else
+            floodFillGrad_CnIR<_Tp, uchar, _WTp, Diff>(img, mask, seedPoint, newVal, newMaskVal,
+                                                       diff, &comp, flags, &buffer);
+    }
+
+    Mat img, mask;
+    int flags, type, depth, cn;
+    bool is_simple, tempMask, parallel;
+    uchar newMaskVal;
+    struct { Vec3b b; Vec3i i; Vec3f f; } ld_buf, ud_buf;
+    std::vector<FFillSegment> buffer;
+};
+
+}
+
+/****************************************************************************************\
+*                                    External Functions                                  *
+\****************************************************************************************/
+
+int cv::floodFill( InputOutputArray _image, InputOutputArray _mask,
+                  Point seedPoint, Scalar newVal, Rect* rect,
+                  Scalar loDiff, Scalar upDiff, int flags )
+{
+    CV_INSTRUMENT_REGION();
+
+    Mat img = _image.getMat(), mask;
+    if( !_mask.empty() )
+        mask = _mask.getMat();
+
+    FloodFillImpl ffill(img, mask, loDiff, upDiff, flags);
+    return ffill.fill(seedPoint, newVal, rect);
+}
+
+
+int cv::floodFill( InputOutputArray _image, InputOutputArray _mask,
+                  const std::vector<Point>& seedPoints, const std::vector<Scalar>& newVals,
+                  OutputArray _areas, OutputArray _rects,
+                  Scalar loDiff, Scalar upDiff, int flags )
+{
+    CV_INSTRUMENT_REGION();
+
+    size_t nseeds = seedPoints.size();
+    CV_Assert( newVals.size() == 1 || newVals.size() == nseeds );
+
+    Mat img = _image.getMat(), mask;
+    if( !_mask.empty() )
+        mask = _mask.getMat();
+
+    std::vector<int> areas(nseeds);
+    std::vector<Rect> rects(nseeds);
+    int total = 0;
+    if( nseeds > 0 )
+    {
+        FloodFillImpl ffill(img, mask, loDiff, upDiff, flags);
+        for( size_t i = 0; i < nseeds; i++ )
         {
-            ld_buf.f[i] = (float)loDiff[i];
-            ud_buf.f[i] = (float)upDiff[i];
+            areas[i] = ffill.fill(seedPoints[i], newVals[newVals.size() == 1 ? 0 : i], &rects[i]);
+            total += areas[i];
         }
-    else
-        CV_Error( CV_StsUnsupportedFormat, "" );
-
-    uchar newMaskVal = (uchar)((flags & 0xff00) == 0 ? 1 : ((flags >> 8) & 255));
-
-    if( type == CV_8UC1 )
-        floodFillGrad_CnIR<uchar, uchar, int, Diff8uC1>(
-                img, mask, seedPoint, nv_buf.b[0], newMaskVal,
-                Diff8uC1(ld_buf.b[0], ud_buf.b[0]),
-                &comp, flags, &buffer);
-    else if( type == CV_8UC3 )
-        floodFillGrad_CnIR<Vec3b, uchar, Vec3i, Diff8uC3>(
-                img, mask, seedPoint, Vec3b(nv_buf.b), newMaskVal,
-                Diff8uC3(ld_buf.b, ud_buf.b),
-                &comp, flags, &buffer);
-    else if( type == CV_32SC1 )
-        floodFillGrad_CnIR<int, uchar, int, Diff32sC1>(
-                img, mask, seedPoint, nv_buf.i[0], newMaskVal,
-                Diff32sC1(ld_buf.i[0], ud_buf.i[0]),
-                &comp, flags, &buffer);
-    else if( type == CV_32SC3 )
-        floodFillGrad_CnIR<Vec3i, uchar, Vec3i, Diff32sC3>(
-                img, mask, seedPoint, Vec3i(nv_buf.i), newMaskVal,
-                Diff32sC3(ld_buf.i, ud_buf.i),
-                &comp, flags, &buffer);
-    else if( type == CV_32FC1 )
-        floodFillGrad_CnIR<float, uchar, float, Diff32fC1>(
-                img, mask, seedPoint, nv_buf.f[0], newMaskVal,
-                Diff32fC1(ld_buf.f[0], ud_buf.f[0]),
-                &comp, flags, &buffer);
-    else if( type == CV_32FC3 )
-        floodFillGrad_CnIR<Vec3f, uchar, Vec3f, Diff32fC3>(
-                img, mask, seedPoint, Vec3f(nv_buf.f), newMaskVal,
-                Diff32fC3(ld_buf.f, ud_buf.f),
-                &comp, flags, &buffer);
-    else
-        CV_Error(CV_StsUnsupportedFormat, "");
+    }
 
-    if( rect )
-        *rect = comp.rect;
-    return comp.area;
+    if( _areas.needed() )
+        Mat(areas).copyTo(_areas);
+    if( _rects.needed() )
+    {
+        _rects.create((int)nseeds, 1, CV_32SC4, -1, true);
+        if( nseeds > 0 )
+            Mat(rects).reshape(4).copyTo(_rects);
+    }
+    return total;
 }
 
 
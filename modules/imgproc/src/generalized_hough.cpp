@@ -59,6 +59,16 @@ namespace
         return fabs(v) > std::numeric_limits<float>::epsilon();
     }
 
+    // number of partial accumulators for a parallel voting over nitems work items,
+    // their total size is limited to 64Mb of votes
+    int votingStripes(size_t accumSize, int nitems)
+    {
+        const size_t maxTotal = (size_t)1 << 24;
+        size_t n = (size_t)std::max(std::min(getNumThreads(), nitems), 1);
+        n = std::min(n, std::max(maxTotal / std::max(accumSize, (size_t)1), (size_t)1));
+        return (int)n;
+    }
+
     class GeneralizedHoughBase
     {
     protected:
@@ -432,36 +442,57 @@ namespace
         const int rows = hist_.rows - 2;
         const int cols = hist_.cols - 2;
 
-        for (int y = 0; y < imageSize_.height; ++y)
-        {
-            const uchar* edgesRow = imageEdges_.ptr(y);
-            const float* dxRow = imageDx_.ptr<float>(y);
-            const float* dyRow = imageDy_.ptr<float>(y);
+        // every stripe of rows votes into its own accumulator, they are summed at the end
+        const int nstripes = votingStripes(hist_.total(), imageSize_.height);
+        std::vector<Mat> hists(nstripes);
+        hists[0] = hist_;
 
-            for (int x = 0; x < imageSize_.width; ++x)
+        parallel_for_(Range(0, nstripes), [&](const Range& range)
+        {
+            for (int s = range.start; s < range.end; ++s)
             {
-                const Point p(x, y);
+                Mat& hist = hists[s];
+                if (hist.empty())
+                    hist = Mat::zeros(hist_.size(), CV_32SC1);
 
-                if (edgesRow[x] && (notNull(dyRow[x]) || notNull(dxRow[x])))
-                {
-                    const float theta = fastAtan2(dyRow[x], dxRow[x]);
-                    const int n = cvRound(theta * thetaScale);
+                const int y0 = imageSize_.height * s / nstripes;
+                const int y1 = imageSize_.height * (s + 1) / nstripes;
 
-                    const std::vector<Point>& r_row = r_table_[n];
+                for (int y = y0; y < y1; ++y)
+                {
+                    const uchar* edgesRow = imageEdges_.ptr(y);
+                    const float* dxRow = imageDx_.ptr<float>(y);
+                    const float* dyRow = imageDy_.ptr<float>(y);
 
-                    for (size_t j = 0; j < r_row.size(); ++j)
+                    for (int x = 0; x < imageSize_.width; ++x)
                     {
-                        Point c = p - r_row[j];
+                        const Point p(x, y);
+
+                        if (edgesRow[x] && (notNull(dyRow[x]) || notNull(dxRow[x])))
+                        {
+                            const float theta = fastAtan2(dyRow[x], dxRow[x]);
+                            const int n = cvRound(theta * thetaScale);
+
+                            const std::vector<Point>& r_row = r_table_[n];
 
-                        c.x = cvRound(c.x * idp);
-                        c.y = cvRound(c.y * idp);
+                            for (size_t j = 0; j < r_row.size(); ++j)
+                            {
+                                Point c = p - r_row[j];
 
-                        if (c.x >= 0 && c.x < cols && c.y >= 0 && c.y < rows)
-                            ++hist_.at<int>(c.y + 1, c.x + 1);
+                                c.x = cvRound(c.x * idp);
+                                c.y = cvRound(c.y * idp);
+
+                                if (c.x >= 0 && c.x < cols && c.y >= 0 && c.y < rows)
+                                    ++hist.at<int>(c.y + 1, c.x + 1);
+                            }
+                        }
                     }
                 }
             }
-        }
+        });
+
+        for (int s = 1; s < nstripes; ++s)
+            add(hist_, hists[s], hist_);
     }
 
     void GeneralizedHoughBallardImpl::findPosInHist()
@@ -694,38 +725,67 @@ namespace
         features.resize(levels_ + 1);
         std::for_each(features.begin(), features.end(), [=](std::vector<Feature>& e) { e.clear(); e.reserve(maxBufferSize_); });
 
-        for (size_t i = 0; i < points.size(); ++i)
-        {
-            ContourPoint p1 = points[i];
+        // the pairs are collected by stripes of the first point and concatenated in order,
+        // so every bin keeps the same first maxBufferSize_ features as a sequential pass
+        const int npoints = static_cast<int>(points.size());
+        const int nstripes = votingStripes((levels_ + 1) * (size_t)maxBufferSize_ * sizeof(Feature) / sizeof(int), npoints);
+        std::vector< std::vector< std::vector<Feature> > > stripeFeatures(nstripes);
 
-            for (size_t j = 0; j < points.size(); ++j)
+        parallel_for_(Range(0, nstripes), [&](const Range& range)
+        {
+            for (int s = range.start; s < range.end; ++s)
             {
-                ContourPoint p2 = points[j];
+                std::vector< std::vector<Feature> >& sf = s == 0 ? features : stripeFeatures[s];
+                sf.resize(levels_ + 1);
+
+                const int i0 = static_cast<int>((int64)npoints * s / nstripes);
+                const int i1 = static_cast<int>((int64)npoints * (s + 1) / nstripes);
 
-                if (angleEq(p1.theta - p2.theta, xi_, angleEpsilon_))
+                for (int i = i0; i < i1; ++i)
                 {
-                    const Point2d d = p1.pos - p2.pos;
+                    ContourPoint p1 = points[i];
 
-                    Feature f;
+                    for (size_t j = 0; j < points.size(); ++j)
+                    {
+                        ContourPoint p2 = points[j];
+
+                        if (angleEq(p1.theta - p2.theta, xi_, angleEpsilon_))
+                        {
+                            const Point2d d = p1.pos - p2.pos;
+
+                            Feature f;
 
-                    f.p1 = p1;
-                    f.p2 = p2;
+                            f.p1 = p1;
+                            f.p2 = p2;
 
-                    f.alpha12 = clampAngle(fastAtan2((float)d.y, (float)d.x) - p1.theta);
-                    f.d12 = norm(d);
+                            f.alpha12 = clampAngle(fastAtan2((float)d.y, (float)d.x) - p1.theta);
+                            f.d12 = norm(d);
 
-                    if (f.d12 > maxDist)
-                        continue;
+                            if (f.d12 > maxDist)
+                                continue;
 
-                    f.r1 = p1.pos - center;
-                    f.r2 = p2.pos - center;
+                            f.r1 = p1.pos - center;
+                            f.r2 = p2.pos - center;
 
-                    const int n = cvRound(f.alpha12 * alphaScale);
+                            const int n = cvRound(f.alpha12 * alphaScale);
 
-                    if (features[n].size() < static_cast<size_t>(maxBufferSize_))
-                        features[n].push_back(f);
+                            if (sf[n].size() < static_cast<size_t>(maxBufferSize_))
+                                sf[n].push_back(f);
+                        }
+                    }
                 }
             }
+        });
+
+        for (int s = 1; s < nstripes; ++s)
+        {
+            for (int n = 0; n <= levels_; ++n)
+            {
+                const std::vector<Feature>& src = stripeFeatures[s][n];
+                std::vector<Feature>& dst = features[n];
+                const size_t count = std::min(src.size(), static_cast<size_t>(maxBufferSize_) - dst.size());
+                dst.insert(dst.end(), src.begin(), src.begin() + count);
+            }
         }
     }
 
@@ -771,29 +831,45 @@ namespace
         const double iAngleStep = 1.0 / angleStep_;
         const int angleRange = cvCeil((maxAngle_ - minAngle_) * iAngleStep);
 
-        std::vector<int> OHist(angleRange + 1, 0);
-        for (int i = 0; i <= levels_; ++i)
-        {
-            const std::vector<Feature>& templRow = templFeatures_[i];
-            const std::vector<Feature>& imageRow = imageFeatures_[i];
+        // the levels are interleaved between the stripes, every stripe has its own histogram
+        const int nstripes = votingStripes(angleRange + 1, levels_ + 1);
+        std::vector< std::vector<int> > hists(nstripes, std::vector<int>(angleRange + 1, 0));
 
-            for (size_t j = 0; j < templRow.size(); ++j)
+        parallel_for_(Range(0, nstripes), [&](const Range& range)
+        {
+            for (int s = range.start; s < range.end; ++s)
             {
-                Feature templF = templRow[j];
+                std::vector<int>& OHist = hists[s];
 
-                for (size_t k = 0; k < imageRow.size(); ++k)
+                for (int i = s; i <= levels_; i += nstripes)
                 {
-                    Feature imF = imageRow[k];
+                    const std::vector<Feature>& templRow = templFeatures_[i];
+                    const std::vector<Feature>& imageRow = imageFeatures_[i];
 
-                    const double angle = clampAngle(imF.p1.theta - templF.p1.theta);
-                    if (angle >= minAngle_ && angle <= maxAngle_)
+                    for (size_t j = 0; j < templRow.size(); ++j)
                     {
-                        const int n = cvRound((angle - minAngle_) * iAngleStep);
-                        ++OHist[n];
+                        Feature templF = templRow[j];
+
+                        for (size_t k = 0; k < imageRow.size(); ++k)
+                        {
+                            Feature imF = imageRow[k];
+
+                            const double angle = clampAngle(imF.p1.theta - templF.p1.theta);
+                            if (angle >= minAngle_ && angle <= maxAngle_)
+                            {
+                                const int n = cvRound((angle - minAngle_) * iAngleStep);
+                                ++OHist[n];
+                            }
+                        }
                     }
                 }
             }
-        }
+        });
+
+        std::vector<int>& OHist = hists[0];
+        for (int s = 1; s < nstripes; ++s)
+            for (int n = 0; n <= angleRange; ++n)
+                OHist[n] += hists[s][n];
 
         angles_.clear();
 
@@ -819,35 +895,49 @@ namespace
         const double iScaleStep = 1.0 / scaleStep_;
         const int scaleRange = cvCeil((maxScale_ - minScale_) * iScaleStep);
 
-        std::vector<int> SHist(scaleRange + 1, 0);
+        const int nstripes = votingStripes(scaleRange + 1, levels_ + 1);
+        std::vector< std::vector<int> > hists(nstripes, std::vector<int>(scaleRange + 1, 0));
 
-        for (int i = 0; i <= levels_; ++i)
+        parallel_for_(Range(0, nstripes), [&](const Range& range)
         {
-            const std::vector<Feature>& templRow = templFeatures_[i];
-            const std::vector<Feature>& imageRow = imageFeatures_[i];
-
-            for (size_t j = 0; j < templRow.size(); ++j)
+            for (int stripe = range.start; stripe < range.end; ++stripe)
             {
-                Feature templF = templRow[j];
+                std::vector<int>& SHist = hists[stripe];
 
-                templF.p1.theta += angle;
-
-                for (size_t k = 0; k < imageRow.size(); ++k)
+                for (int i = stripe; i <= levels_; i += nstripes)
                 {
-                    Feature imF = imageRow[k];
+                    const std::vector<Feature>& templRow = templFeatures_[i];
+                    const std::vector<Feature>& imageRow = imageFeatures_[i];
 
-                    if (angleEq(imF.p1.theta, templF.p1.theta, angleEpsilon_))
+                    for (size_t j = 0; j < templRow.size(); ++j)
                     {
-                        const double scale = imF.d12 / templF.d12;
-                        if (scale >= minScale_ && scale <= maxScale_)
+                        Feature templF = templRow[j];
+
+                        templF.p1.theta += angle;
+
+                        for (size_t k = 0; k < imageRow.size(); ++k)
                         {
-                            const int s = cvRound((scale - minScale_) * iScaleStep);
-                            ++SHist[s];
+                            Feature imF = imageRow[k];
+
+                            if (angleEq(imF.p1.theta, templF.p1.theta, angleEpsilon_))
+                            {
+                                const double scale = imF.d12 / templF.d12;
+                                if (scale >= minScale_ && scale <= maxScale_)
+                                {
+                                    const int s = cvRound((scale - minScale_) * iScaleStep);
+                                    ++SHist[s];
+                                }
+                            }
                         }
                     }
                 }
             }
-        }
+        });
+
+        std::vector<int>& SHist = hists[0];
+        for (int stripe = 1; stripe < nstripes; ++stripe)
+            for (int s = 0; s <= scaleRange; ++s)
+                SHist[s] += hists[stripe][s];
 
         scales_.clear();
 
@@ -876,48 +966,62 @@ namespace
         const int histRows = cvCeil(imageSize_.height * idp);
         const int histCols = cvCeil(imageSize_.width * idp);
 
-        Mat DHist(histRows + 2, histCols + 2, CV_32SC1, Scalar::all(0));
+        const int nstripes = votingStripes((size_t)(histRows + 2) * (histCols + 2), levels_ + 1);
+        std::vector<Mat> hists(nstripes);
 
-        for (int i = 0; i <= levels_; ++i)
+        parallel_for_(Range(0, nstripes), [&](const Range& range)
         {
-            const std::vector<Feature>& templRow = templFeatures_[i];
-            const std::vector<Feature>& imageRow = imageFeatures_[i];
-
-            for (size_t j = 0; j < templRow.size(); ++j)
+            for (int s = range.start; s < range.end; ++s)
             {
-                Feature templF = templRow[j];
+                Mat& DHist = hists[s];
+                DHist = Mat::zeros(histRows + 2, histCols + 2, CV_32SC1);
 
-                templF.p1.theta += angle;
+                for (int i = s; i <= levels_; i += nstripes)
+                {
+                    const std::vector<Feature>& templRow = templFeatures_[i];
+                    const std::vector<Feature>& imageRow = imageFeatures_[i];
 
-                templF.r1 *= scale;
-                templF.r2 *= scale;
+                    for (size_t j = 0; j < templRow.size(); ++j)
+                    {
+                        Feature templF = templRow[j];
 
-                templF.r1 = Point2d(cosVal * templF.r1.x - sinVal * templF.r1.y, sinVal * templF.r1.x + cosVal * templF.r1.y);
-                templF.r2 = Point2d(cosVal * templF.r2.x - sinVal * templF.r2.y, sinVal * templF.r2.x + cosVal * templF.r2.y);
+                        templF.p1.theta += angle;
 
-                for (size_t k = 0; k < imageRow.size(); ++k)
-                {
-                    Feature imF = imageRow[k];
+                        templF.r1 *= scale;
+                        templF.r2 *= scale;
 
-                    if (angleEq(imF.p1.theta, templF.p1.theta, angleEpsilon_))
-                    {
-                        Point2d c1, c2;
+                        templF.r1 = Point2d(cosVal * templF.r1.x - sinVal * templF.r1.y, sinVal * templF.r1.x + cosVal * templF.r1.y);
+                        templF.r2 = Point2d(cosVal * templF.r2.x - sinVal * templF.r2.y, sinVal * templF.r2.x + cosVal * templF.r2.y);
 
-                        c1 = imF.p1.pos - templF.r1;
-                        c1 *= idp;
+                        for (size_t k = 0; k < imageRow.size(); ++k)
+                        {
+                            Feature imF = imageRow[k];
+
+                            if (angleEq(imF.p1.theta, templF.p1.theta, angleEpsilon_))
+                            {
+                                Point2d c1, c2;
+
+                                c1 = imF.p1.pos - templF.r1;
+                                c1 *= idp;
 
-                        c2 = imF.p2.pos - templF.r2;
-                        c2 *= idp;
+                                c2 = imF.p2.pos - templF.r2;
+                                c2 *= idp;
 
-                        if (fabs(c1.x - c2.x) > 1 || fabs(c1.y - c2.y) > 1)
-                            continue;
+                                if (fabs(c1.x - c2.x) > 1 || fabs(c1.y - c2.y) > 1)
+                                    continue;
 
-                        if (c1.y >= 0 && c1.y < histRows && c1.x >= 0 && c1.x < histCols)
-                            ++DHist.at<int>(cvRound(c1.y) + 1, cvRound(c1.x) + 1);
+                                if (c1.y >= 0 && c1.y < histRows && c1.x >= 0 && c1.x < histCols)
+                                    ++DHist.at<int>(cvRound(c1.y) + 1, cvRound(c1.x) + 1);
+                            }
+                        }
                     }
                 }
             }
-        }
+        });
+
+        Mat& DHist = hists[0];
+        for (int s = 1; s < nstripes; ++s)
+            add(DHist, hists[s], DHist);
 
         for(int y = 0; y < histRows; ++y)
         {
@@ -2593,6 +2593,7 @@ void cv::warpAffine( InputArray _src, OutputArray _dst,
     _dst.create( dsize.empty() ? src.size() : dsize, src.type() );
     Mat dst = _dst.getMat();
     CV_Assert( src.cols > 0 && src.rows > 0 );
+    CV_TRACE_BYTES(src.total() * src.elemSize() + dst.total() * dst.elemSize());
     if( dst.data == src.data )
         src = src.clone();
 
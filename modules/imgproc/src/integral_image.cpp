@@ -0,0 +1,447 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+
+/*
+Incrementally updated integral images.
+
+The tables are computed row by row from the previous rows: the row Y of the sum is the row Y-1 plus
+the prefix sums of the image row Y-1, and the row Y of the tilted sum follows from the rows Y-1 and Y-2:
+
+    T(X,Y) = T(X-1,Y-1) + T(X+1,Y-1) - T(X,Y-2) + I(X-1,Y-1) + I(X-1,Y-2),   0 < X < W
+    T(0,Y) = T(1,Y-1)
+    T(W,Y) = T(W-1,Y-1) + I(W-1,Y-1) + I(W-1,Y-2)
+
+so the pixels of the changed region only affect the table values right of and below them (sums), or in
+the cone of width growing by one per row below them (tilted sum), and only those are recomputed.
+*/
+
+namespace cv
+{
+
+namespace
+{
+
+typedef void (*IntegralSumRowFunc)(const uchar* src, uchar* sum, const uchar* prevSum,
+                                   uchar* sqsum, const uchar* prevSqsum, int x0, int width, int cn);
+typedef void (*IntegralTiltedRowFunc)(const uchar* src1, const uchar* src2, uchar* tilted,
+                                      const uchar* prev1, const uchar* prev2, int lo, int hi, int width, int cn);
+
+// computes the columns (x0, width] of the row of the sum (and of the squared sum) from the image row
+template<typename T, typename ST, typename QT> static void
+integralSumRow(const uchar* _src, uchar* _sum, const uchar* _prevSum,
+               uchar* _sqsum, const uchar* _prevSqsum, int x0, int width, int cn)
+{
+    const T* src = (const T*)_src;
+    ST* sum = (ST*)_sum + cn;
+    const ST* prevSum = (const ST*)_prevSum + cn;
+    QT* sqsum = (QT*)_sqsum + cn;
+    const QT* prevSqsum = (const QT*)_prevSqsum + cn;
+    width *= cn;
+    x0 *= cn;
+
+    for (int k = 0; k < cn; k++)
+    {
+        ST s = 0;
+        QT sq = 0;
+        int x = k;
+        if (_sqsum)
+        {
+            for (; x < x0; x += cn)
+            {
+                T it = src[x];
+                s += it;
+                sq += (QT)it*it;
+            }
+            for (; x < width; x += cn)
+            {
+                T it = src[x];
+                s += it;
+                sq += (QT)it*it;
+                sum[x] = prevSum[x] + s;
+                sqsum[x] = prevSqsum[x] + sq;
+            }
+        }
+        else
+        {
+            for (; x < x0; x += cn)
+                s += src[x];
+            for (; x < width; x += cn)
+            {
+                s += src[x];
+                sum[x] = prevSum[x] + s;
+            }
+        }
+    }
+}
+
+// computes the columns [lo, hi] of the row Y of the tilted sum from the rows Y-1, Y-2 of the table and
+// of the image; prev2 and src2 are null for the first row
+template<typename T, typename ST> static void
+integralTiltedRow(const uchar* _src1, const uchar* _src2, uchar* _tilted,
+                  const uchar* _prev1, const uchar* _prev2, int lo, int hi, int width, int cn)
+{
+    const T* src1 = (const T*)_src1;
+    const T* src2 = (const T*)_src2;
+    ST* tilted = (ST*)_tilted;
+    const ST* prev1 = (const ST*)_prev1;
+    const ST* prev2 = (const ST*)_prev2;
+
+    for (int X = lo; X <= hi; X++)
+    {
+        for (int k = 0; k < cn; k++)
+        {
+            int i = X*cn + k;
+            ST t;
+            if (X == 0)
+                t = prev1[i + cn];
+            else
+            {
+                t = prev1[i - cn] + src1[i - cn];
+                if (src2)
+                    t += src2[i - cn];
+                if (X < width)
+                {
+                    t += prev1[i + cn];
+                    if (prev2)
+                        t -= prev2[i];
+                }
+            }
+            tilted[i] = t;
+        }
+    }
+}
+
+static double tableValue(const Mat& m, int y, int x)
+{
+    switch (m.depth())
+    {
+    case CV_32S: return m.ptr<int>(y)[x];
+    case CV_32F: return m.ptr<float>(y)[x];
+    default: return m.ptr<double>(y)[x];
+    }
+}
+
+class IntegralImageImpl CV_FINAL : public IntegralImage
+{
+public:
+    IntegralImageImpl(int flags_, int sdepth_, int sqdepth_, int windowRows_)
+        : flags(flags_), sdepth0(sdepth_), sqdepth0(sqdepth_), windowRows(windowRows_),
+          type(-1), width(0), total(0), stored(0), sumRowFunc(0), tiltedRowFunc(0)
+    {
+        CV_Assert((flags & ~(INTEGRAL_SQSUM | INTEGRAL_TILTED)) == 0);
+        CV_Assert(windowRows >= 0);
+    }
+
+    void compute(InputArray _image) CV_OVERRIDE
+    {
+        CV_INSTRUMENT_REGION();
+
+        Mat image = _image.getMat();
+        CV_Assert(!image.empty() && image.dims == 2);
+        init(image.type(), image.cols);
+        if (windowRows > 0)
+        {
+            total = 0;
+            append(image);
+            return;
+        }
+
+        reserve(image.rows);
+        total = stored = image.rows;
+        Mat sum = sumBuf.rowRange(0, stored + 1), sqsum, tilted;
+        if (flags & INTEGRAL_SQSUM)
+            sqsum = sqsumBuf.rowRange(0, stored + 1);
+        if (flags & INTEGRAL_TILTED)
+        {
+            tilted = tiltedBuf.rowRange(0, stored + 1);
+            image.row(image.rows - 1).copyTo(imageBuf);
+        }
+        integral(image, sum, sqsum.empty() ? _OutputArray() : _OutputArray(sqsum),
+                 tilted.empty() ? _OutputArray() : _OutputArray(tilted), sdepth, sqdepth);
+    }
+
+    void update(InputArray _image, const Rect& roi) CV_OVERRIDE
+    {
+        CV_INSTRUMENT_REGION();
+
+        CV_CheckEQ(windowRows, 0, "Update of a region is not available in the rolling mode");
+        Mat image = _image.getMat();
+        CV_CheckTypeEQ(image.type(), type, "");
+        CV_Assert(image.cols == width && image.rows == stored);
+
+        Rect r = roi & Rect(0, 0, width, stored);
+        if (r.empty())
+            return;
+        int x0 = r.x, y0 = r.y, y1 = r.y + r.height, cn = CV_MAT_CN(type);
+        bool hasSqsum = (flags & INTEGRAL_SQSUM) != 0;
+
+        // the rows of the region are recomputed right of it, the rows below it change by the same values
+        // as the last row of the region
+        Range cols((x0 + 1)*cn, (width + 1)*cn);
+        Mat sumDelta, sqsumDelta;
+        if (y1 < stored)
+        {
+            sumBuf.row(y1).reshape(1, 1).colRange(cols).copyTo(sumDelta);
+            if (hasSqsum)
+                sqsumBuf.row(y1).reshape(1, 1).colRange(cols).copyTo(sqsumDelta);
+        }
+        for (int Y = y0 + 1; Y <= y1; Y++)
+            sumRowFunc(image.ptr(Y - 1), sumBuf.ptr(Y), sumBuf.ptr(Y - 1),
+                       hasSqsum ? sqsumBuf.ptr(Y) : 0, hasSqsum ? sqsumBuf.ptr(Y - 1) : 0, x0, width, cn);
+        if (y1 < stored)
+        {
+            subtract(sumBuf.row(y1).reshape(1, 1).colRange(cols), sumDelta, sumDelta);
+            if (hasSqsum)
+                subtract(sqsumBuf.row(y1).reshape(1, 1).colRange(cols), sqsumDelta, sqsumDelta);
+            parallel_for_(Range(y1 + 1, stored + 1), [&](const Range& range)
+            {
+                for (int Y = range.start; Y < range.end; Y++)
+                {
+                    Mat row = sumBuf.row(Y).reshape(1, 1).colRange(cols);
+                    add(row, sumDelta, row);
+                    if (hasSqsum)
+                    {
+                        row = sqsumBuf.row(Y).reshape(1, 1).colRange(cols);
+                        add(row, sqsumDelta, row);
+                    }
+                }
+            });
+        }
+
+        if (flags & INTEGRAL_TILTED)
+        {
+            for (int Y = y0 + 1; Y <= stored; Y++)
+            {
+                int lo = std::max(x0 + 1 - (Y - y0), 0);
+                int hi = std::min(x0 + r.width + (Y - y0), width);
+                tiltedRowFunc(image.ptr(Y - 1), Y >= 2 ? image.ptr(Y - 2) : 0, tiltedBuf.ptr(Y),
+                              tiltedBuf.ptr(Y - 1), Y >= 2 ? tiltedBuf.ptr(Y - 2) : 0, lo, hi, width, cn);
+            }
+            image.row(stored - 1).copyTo(imageBuf);
+        }
+    }
+
+    void append(InputArray _rows) CV_OVERRIDE
+    {
+        CV_INSTRUMENT_REGION();
+
+        Mat rows = _rows.getMat();
+        if (rows.empty())
+            return;
+        CV_Assert(rows.dims == 2);
+        if (type < 0)
+            init(rows.type(), rows.cols);
+        CV_CheckTypeEQ(rows.type(), type, "");
+        CV_CheckEQ(rows.cols, width, "");
+
+        int i = 0;
+        if (windowRows > 0 && rows.rows > windowRows)
+        {
+            // only the last rows are kept
+            i = rows.rows - windowRows;
+            total += i;
+            stored = 0;
+        }
+        else if (windowRows == 0)
+            reserve(stored + rows.rows);
+        for (; i < rows.rows; i++)
+            appendRow(rows.ptr(i));
+    }
+
+    void getSum(OutputArray sum) const CV_OVERRIDE { getTable(sumBuf, sum); }
+    void getSqsum(OutputArray sqsum) const CV_OVERRIDE { getTable(sqsumBuf, sqsum); }
+    void getTilted(OutputArray tilted) const CV_OVERRIDE { getTable(tiltedBuf, tilted); }
+
+    Scalar sum(const Rect& rect) const CV_OVERRIDE { return boxSum(sumBuf, rect); }
+
+    Scalar sqsum(const Rect& rect) const CV_OVERRIDE
+    {
+        CV_Assert(flags & INTEGRAL_SQSUM);
+        return boxSum(sqsumBuf, rect);
+    }
+
+    int64 getFirstRow() const CV_OVERRIDE { return total - keptRows(); }
+    int64 getRows() const CV_OVERRIDE { return total; }
+
+    void setRows(int64 rows) CV_OVERRIDE
+    {
+        CV_CheckGT(windowRows, 0, "The number of rows can be set only in the rolling mode");
+        CV_Assert(rows >= 0);
+        total = rows;
+        stored = 0;
+    }
+
+private:
+    void init(int type_, int width_)
+    {
+        int depth = CV_MAT_DEPTH(type_);
+        sdepth = sdepth0 <= 0 ? (depth == CV_8U ? CV_32S : CV_64F) : CV_MAT_DEPTH(sdepth0);
+        sqdepth = sqdepth0 <= 0 ? CV_64F : CV_MAT_DEPTH(sqdepth0);
+
+#define INTEGRAL_FUNCS(T, ST, QT) \
+        sumRowFunc = integralSumRow<T, ST, QT>, tiltedRowFunc = integralTiltedRow<T, ST>
+
+        if (depth == CV_8U && sdepth == CV_32S && sqdepth == CV_64F)
+            INTEGRAL_FUNCS(uchar, int, double);
+        else if (depth == CV_8U && sdepth == CV_32S && sqdepth == CV_32F)
+            INTEGRAL_FUNCS(uchar, int, float);
+        else if (depth == CV_8U && sdepth == CV_32S && sqdepth == CV_32S)
+            INTEGRAL_FUNCS(uchar, int, int);
+        else if (depth == CV_8U && sdepth == CV_32F && sqdepth == CV_64F)
+            INTEGRAL_FUNCS(uchar, float, double);
+        else if (depth == CV_8U && sdepth == CV_32F && sqdepth == CV_32F)
+            INTEGRAL_FUNCS(uchar, float, float);
+        else if (depth == CV_8U && sdepth == CV_64F && sqdepth == CV_64F)
+            INTEGRAL_FUNCS(uchar, double, double);
+        else if (depth == CV_16U && sdepth == CV_64F && sqdepth == CV_64F)
+            INTEGRAL_FUNCS(ushort, double, double);
+        else if (depth == CV_16S && sdepth == CV_64F && sqdepth == CV_64F)
+            INTEGRAL_FUNCS(short, double, double);
+        else if (depth == CV_32F && sdepth == CV_32F && sqdepth == CV_64F)
+            INTEGRAL_FUNCS(float, float, double);
+        else if (depth == CV_32F && sdepth == CV_32F && sqdepth == CV_32F)
+            INTEGRAL_FUNCS(float, float, float);
+        else if (depth == CV_32F && sdepth == CV_64F && sqdepth == CV_64F)
+            INTEGRAL_FUNCS(float, double, double);
+        else if (depth == CV_64F && sdepth == CV_64F && sqdepth == CV_64F)
+            INTEGRAL_FUNCS(double, double, double);
+        else
+            CV_Error(Error::StsUnsupportedFormat, "");
+#undef INTEGRAL_FUNCS
+
+        type = type_;
+        width = width_;
+        // the number of processed rows is kept, it can be set by setRows() before the first row
+        stored = 0;
+        sumBuf.release();
+        sqsumBuf.release();
+        tiltedBuf.release();
+        imageBuf.release();
+        if (windowRows > 0)
+        {
+            // the rows are added until the buffers are full, then the last rows are moved to the beginning
+            allocate(windowRows*2);
+            imageBuf.create(windowRows*2, width, type);
+        }
+    }
+
+    void allocate(int rows)
+    {
+        int cn = CV_MAT_CN(type);
+        Mat sum = Mat::zeros(rows + 1, width + 1, CV_MAKETYPE(sdepth, cn));
+        if (stored > 0)
+            sumBuf.rowRange(0, stored + 1).copyTo(sum.rowRange(0, stored + 1));
+        sumBuf = sum;
+        if (flags & INTEGRAL_SQSUM)
+        {
+            Mat sqsum = Mat::zeros(rows + 1, width + 1, CV_MAKETYPE(sqdepth, cn));
+            if (stored > 0)
+                sqsumBuf.rowRange(0, stored + 1).copyTo(sqsum.rowRange(0, stored + 1));
+            sqsumBuf = sqsum;
+        }
+        if (flags & INTEGRAL_TILTED)
+        {
+            Mat tilted = Mat::zeros(rows + 1, width + 1, CV_MAKETYPE(sdepth, cn));
+            if (stored > 0)
+                tiltedBuf.rowRange(0, stored + 1).copyTo(tilted.rowRange(0, stored + 1));
+            tiltedBuf = tilted;
+        }
+    }
+
+    void reserve(int rows)
+    {
+        if (sumBuf.rows < rows + 1)
+            allocate(std::max(rows, (sumBuf.rows - 1)*2));
+    }
+
+    // computes the row stored + 1 of the tables, prev is the previous image row (or null)
+    void computeRow(const uchar* src, const uchar* prev)
+    {
+        int Y = stored + 1, cn = CV_MAT_CN(type);
+        bool hasSqsum = (flags & INTEGRAL_SQSUM) != 0;
+        sumRowFunc(src, sumBuf.ptr(Y), sumBuf.ptr(Y - 1),
+                   hasSqsum ? sqsumBuf.ptr(Y) : 0, hasSqsum ? sqsumBuf.ptr(Y - 1) : 0, 0, width, cn);
+        if (flags & INTEGRAL_TILTED)
+            tiltedRowFunc(src, prev, tiltedBuf.ptr(Y), tiltedBuf.ptr(Y - 1),
+                          prev ? tiltedBuf.ptr(Y - 2) : 0, 0, width, width, cn);
+        stored++;
+    }
+
+    void appendRow(const uchar* src)
+    {
+        if (windowRows == 0)
+        {
+            const uchar* prev = stored > 0 && !imageBuf.empty() ? imageBuf.ptr() : 0;
+            computeRow(src, prev);
+            if (flags & INTEGRAL_TILTED)
+                Mat(1, width, type, (void*)src).copyTo(imageBuf);
+        }
+        else
+        {
+            if (stored == imageBuf.rows)
+            {
+                // keep windowRows - 1 last rows, the tables are computed from the first of them
+                int keep = windowRows - 1;
+                imageBuf.rowRange(stored - keep, stored).copyTo(imageBuf.rowRange(0, keep));
+                stored = 0;
+                for (int i = 0; i < keep; i++)
+                    computeRow(imageBuf.ptr(i), i > 0 ? imageBuf.ptr(i - 1) : 0);
+            }
+            Mat(1, width, type, (void*)src).copyTo(imageBuf.row(stored));
+            computeRow(imageBuf.ptr(stored), stored > 0 ? imageBuf.ptr(stored - 1) : 0);
+        }
+        total++;
+    }
+
+    int keptRows() const
+    {
+        return windowRows > 0 ? std::min(stored, windowRows) : stored;
+    }
+
+    void getTable(const Mat& buf, OutputArray dst) const
+    {
+        if (buf.empty() || type < 0)
+        {
+            dst.release();
+            return;
+        }
+        dst.assign(buf.rowRange(stored - keptRows(), stored + 1));
+    }
+
+    Scalar boxSum(const Mat& buf, const Rect& rect) const
+    {
+        int kept = keptRows(), offset = stored - kept;
+        CV_Assert(0 <= rect.x && 0 <= rect.width && rect.x + rect.width <= width);
+        CV_Assert(0 <= rect.y && 0 <= rect.height && rect.y + rect.height <= kept);
+        int y1 = rect.y + offset, y2 = rect.y + rect.height + offset;
+        int cn = CV_MAT_CN(type), x1 = rect.x*cn, x2 = (rect.x + rect.width)*cn;
+        Scalar s;
+        for (int k = 0; k < std::min(cn, 4); k++)
+            s[k] = tableValue(buf, y2, x2 + k) - tableValue(buf, y1, x2 + k) -
+                   tableValue(buf, y2, x1 + k) + tableValue(buf, y1, x1 + k);
+        return s;
+    }
+
+    int flags, sdepth0, sqdepth0, windowRows;
+    int type, sdepth, sqdepth, width;
+    // the number of image rows processed (unbounded in the rolling mode) and the number of them in the tables
+    int64 total;
+    int stored;
+    // the tables of the stored rows (the first row is zero or matches a dropped image row);
+    // the stored image rows in the rolling mode or the last image row otherwise
+    Mat sumBuf, sqsumBuf, tiltedBuf, imageBuf;
+    IntegralSumRowFunc sumRowFunc;
+    IntegralTiltedRowFunc tiltedRowFunc;
+};
+
+} // namespace
+
+Ptr<IntegralImage> createIntegralImage(int flags, int sdepth, int sqdepth, int windowRows)
+{
+    return makePtr<IntegralImageImpl>(flags, sdepth, sqdepth, windowRows);
+}
+
+} // namespace cv
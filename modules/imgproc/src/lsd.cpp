@@ -62,6 +62,10 @@
 
 #define NOTUSED     0   // Label for pixels not used in yet.
 #define USED        1   // Label for pixels already used in detection.
+#define RESERVED    2   // Label for pixels of a region left for the sequential pass.
+
+#define TILE_SIZE   256 // Size of the tiles, whose regions are grown in parallel.
+#define PARALLEL_MIN_AREA (1 << 20) // Minimal area of the scaled image to grow regions in tiles.
 
 #define RELATIVE_ERROR_FACTOR 100.0
 
@@ -279,6 +283,17 @@ private:
         double p;                 // probability of a point with angle within 'prec'
     };
 
+    struct Segment
+    {
+        size_t order;             // index of the seed point in ordered_points
+        Vec4f line;
+        double width;
+        double prec;
+        double nfa;
+    };
+
+    enum { REGION_NONE = 0, REGION_LINE = 1, REGION_ESCAPED = 2 };
+
     LineSegmentDetectorImpl& operator= (const LineSegmentDetectorImpl&); // to quiet MSVC
 
 /**
@@ -309,6 +324,22 @@ private:
  */
     void ll_angle(const double& threshold, const unsigned int& n_bins);
 
+/**
+ * Grow a region from the seed point s and try to approximate it with a line segment.
+ *
+ * @param s             Starting point for the region.
+ * @param bounds        The area the region may occupy.
+ * @param prec          Angle tolerance.
+ * @param p             Probability of a point with angle within 'prec'.
+ * @param min_reg_size  Minimal number of points in a meaningful region.
+ * @param reg           Return: The points of the region.
+ * @param seg           Return: The line segment, if one is found.
+ * @return              REGION_LINE if a segment is found, REGION_ESCAPED if the region
+ *                      reaches outside of bounds, REGION_NONE otherwise.
+ */
+    int detectRegion(const Point2i& s, const Rect& bounds, const double prec, const double p,
+                     const size_t min_reg_size, std::vector<RegionPoint>& reg, Segment& seg);
+
 /**
  * Grow a region starting from point s with a defined precision,
  * returning the containing points size and the angle of the gradients.
@@ -317,9 +348,11 @@ private:
  * @param reg       Return: Vector of points, that are part of the region
  * @param reg_angle Return: The mean angle of the region.
  * @param prec      The precision by which each region angle should be aligned to the mean.
+ * @param bounds    The area the region may occupy. Pixels outside of it are not accessed.
+ * @return          False if an aligned point outside of bounds was met, the growing is stopped then.
  */
-    void region_grow(const Point2i& s, std::vector<RegionPoint>& reg,
-                     double& reg_angle, const double& prec);
+    bool region_grow(const Point2i& s, std::vector<RegionPoint>& reg,
+                     double& reg_angle, const double& prec, const Rect& bounds);
 
 /**
  * Finds the bounding rotated rectangle of a region.
@@ -347,7 +380,8 @@ private:
  * 'reduce_region_radius' is called to try to satisfy this condition.
  */
     bool refine(std::vector<RegionPoint>& reg, double reg_angle,
-                const double prec, double p, rect& rec, const double& density_th);
+                const double prec, double p, rect& rec, const double& density_th,
+                const Rect& bounds, bool& escaped);
 
 /**
  * Reduce the region size, by elimination the points far from the starting point, until that leads to
@@ -387,6 +421,12 @@ public:
     {
         return (n1.norm > n2.norm);
     }
+
+    // Compare seed order
+    static inline bool compare_order( const Segment& s1, const Segment& s2 )
+    {
+        return (s1.order < s2.order);
+    }
 };
 
 /////////////////////////////////////////////////////////////////////////////////////////
@@ -471,61 +511,165 @@ void LineSegmentDetectorImpl::flsd(std::vector<Vec4f>& lines,
     LOG_NT = 5 * (log10(double(img_width)) + log10(double(img_height))) / 2 + log10(11.0);
     const size_t min_reg_size = size_t(-LOG_NT/log10(p)); // minimal number of points in region that can give a meaningful event
 
-    // // Initialize region only when needed
-    // Mat region = Mat::zeros(scaled_image.size(), CV_8UC1);
     used = Mat_<uchar>::zeros(scaled_image.size()); // zeros = NOTUSED
-    std::vector<RegionPoint> reg;
+    const Rect image_rect(0, 0, img_width, img_height);
+    std::vector<Segment> segments;
 
-    // Search for line segments
-    for(size_t i = 0, points_size = ordered_points.size(); i < points_size; ++i)
+    if ((int64)img_width * img_height < PARALLEL_MIN_AREA)
     {
-        const Point2i& point = ordered_points[i].p;
-        if((used.at<uchar>(point) == NOTUSED) && (angles.at<double>(point) != NOTDEF))
+        // Search for line segments
+        std::vector<RegionPoint> reg;
+        for(size_t i = 0, points_size = ordered_points.size(); i < points_size; ++i)
         {
-            double reg_angle;
-            region_grow(ordered_points[i].p, reg, reg_angle, prec);
-
-            // Ignore small regions
-            if(reg.size() < min_reg_size) { continue; }
+            const Point2i& point = ordered_points[i].p;
+            if((used.at<uchar>(point) == NOTUSED) && (angles.at<double>(point) != NOTDEF))
+            {
+                Segment seg;
+                if(detectRegion(point, image_rect, prec, p, min_reg_size, reg, seg) == REGION_LINE)
+                {
+                    seg.order = i;
+                    segments.push_back(seg);
+                }
+            }
+        }
+    }
+    else
+    {
+        // Every tile grows the regions of its seeds in parallel, as long as they stay inside the tile.
+        // The regions reaching other tiles are reserved and grown afterwards, in the order of their seeds.
+        // The tiling does not depend on the number of threads, so neither does the result.
+        const int tiles_x = (img_width + TILE_SIZE - 1) / TILE_SIZE;
+        const int tiles_y = (img_height + TILE_SIZE - 1) / TILE_SIZE;
+        const int ntiles = tiles_x * tiles_y;
+
+        std::vector< std::vector<int> > tile_seeds(ntiles);
+        for(size_t i = 0, points_size = ordered_points.size(); i < points_size; ++i)
+        {
+            const Point2i& point = ordered_points[i].p;
+            if(angles.at<double>(point) != NOTDEF)
+                tile_seeds[(point.y / TILE_SIZE) * tiles_x + point.x / TILE_SIZE].push_back((int)i);
+        }
 
-            // Construct rectangular approximation for the region
-            rect rec;
-            region2rect(reg, reg_angle, prec, p, rec);
+        std::vector< std::vector<Segment> > tile_segments(ntiles);
+        std::vector< std::vector<int> > tile_deferred(ntiles);
 
-            double log_nfa = -1;
-            if(doRefine > LSD_REFINE_NONE)
+        parallel_for_(Range(0, ntiles), [&](const Range& range)
+        {
+            std::vector<RegionPoint> reg;
+            for(int t = range.start; t < range.end; ++t)
             {
-                // At least REFINE_STANDARD lvl.
-                if(!refine(reg, reg_angle, prec, p, rec, DENSITY_TH)) { continue; }
-
-                if(doRefine >= LSD_REFINE_ADV)
+                const Rect bounds = Rect((t % tiles_x) * TILE_SIZE, (t / tiles_x) * TILE_SIZE,
+                                         TILE_SIZE, TILE_SIZE) & image_rect;
+                const std::vector<int>& seeds = tile_seeds[t];
+                for(size_t k = 0; k < seeds.size(); ++k)
                 {
-                    // Compute NFA
-                    log_nfa = rect_improve(rec);
-                    if(log_nfa <= LOG_EPS) { continue; }
+                    const Point2i& point = ordered_points[seeds[k]].p;
+                    const uchar state = used.at<uchar>(point);
+                    if(state == RESERVED) { tile_deferred[t].push_back(seeds[k]); }
+                    if(state != NOTUSED) { continue; }
+
+                    Segment seg;
+                    int res = detectRegion(point, bounds, prec, p, min_reg_size, reg, seg);
+                    if(res == REGION_LINE)
+                    {
+                        seg.order = seeds[k];
+                        tile_segments[t].push_back(seg);
+                    }
+                    else if(res == REGION_ESCAPED)
+                    {
+                        for(size_t j = 0; j < reg.size(); ++j)
+                            *(reg[j].used) = RESERVED;
+                        tile_deferred[t].push_back(seeds[k]);
+                    }
                 }
             }
-            // Found new line
+        });
 
-            // Add the offset
-            rec.x1 += 0.5; rec.y1 += 0.5;
-            rec.x2 += 0.5; rec.y2 += 0.5;
+        std::vector<int> deferred;
+        for(int t = 0; t < ntiles; ++t)
+        {
+            segments.insert(segments.end(), tile_segments[t].begin(), tile_segments[t].end());
+            deferred.insert(deferred.end(), tile_deferred[t].begin(), tile_deferred[t].end());
+        }
+        std::sort(deferred.begin(), deferred.end());
+
+        used.setTo(NOTUSED, used == RESERVED);
+        std::vector<RegionPoint> reg;
+        for(size_t k = 0; k < deferred.size(); ++k)
+        {
+            const Point2i& point = ordered_points[deferred[k]].p;
+            if(used.at<uchar>(point) != NOTUSED) { continue; }
 
-            // scale the result values if a sub-sampling was performed
-            if(SCALE != 1)
+            Segment seg;
+            if(detectRegion(point, image_rect, prec, p, min_reg_size, reg, seg) == REGION_LINE)
             {
-                rec.x1 /= SCALE; rec.y1 /= SCALE;
-                rec.x2 /= SCALE; rec.y2 /= SCALE;
-                rec.width /= SCALE;
+                seg.order = deferred[k];
+                segments.push_back(seg);
             }
+        }
+
+        std::sort(segments.begin(), segments.end(), compare_order);
+    }
+
+    //Store the relevant data
+    for(size_t i = 0; i < segments.size(); ++i)
+    {
+        const Segment& seg = segments[i];
+        lines.push_back(seg.line);
+        if(w_needed) widths.push_back(seg.width);
+        if(p_needed) precisions.push_back(seg.prec);
+        if(n_needed && doRefine >= LSD_REFINE_ADV) nfas.push_back(seg.nfa);
+    }
+}
+
+int LineSegmentDetectorImpl::detectRegion(const Point2i& s, const Rect& bounds, const double prec, const double p,
+                                          const size_t min_reg_size, std::vector<RegionPoint>& reg, Segment& seg)
+{
+    double reg_angle;
+    if(!region_grow(s, reg, reg_angle, prec, bounds)) { return REGION_ESCAPED; }
 
-            //Store the relevant data
-            lines.push_back(Vec4f(float(rec.x1), float(rec.y1), float(rec.x2), float(rec.y2)));
-            if(w_needed) widths.push_back(rec.width);
-            if(p_needed) precisions.push_back(rec.p);
-            if(n_needed && doRefine >= LSD_REFINE_ADV) nfas.push_back(log_nfa);
+    // Ignore small regions
+    if(reg.size() < min_reg_size) { return REGION_NONE; }
+
+    // Construct rectangular approximation for the region
+    rect rec;
+    region2rect(reg, reg_angle, prec, p, rec);
+
+    double log_nfa = -1;
+    if(doRefine > LSD_REFINE_NONE)
+    {
+        // At least REFINE_STANDARD lvl.
+        bool escaped = false;
+        bool refined = refine(reg, reg_angle, prec, p, rec, DENSITY_TH, bounds, escaped);
+        if(escaped) { return REGION_ESCAPED; }
+        if(!refined) { return REGION_NONE; }
+
+        if(doRefine >= LSD_REFINE_ADV)
+        {
+            // Compute NFA
+            log_nfa = rect_improve(rec);
+            if(log_nfa <= LOG_EPS) { return REGION_NONE; }
         }
     }
+    // Found new line
+
+    // Add the offset
+    rec.x1 += 0.5; rec.y1 += 0.5;
+    rec.x2 += 0.5; rec.y2 += 0.5;
+
+    // scale the result values if a sub-sampling was performed
+    if(SCALE != 1)
+    {
+        rec.x1 /= SCALE; rec.y1 /= SCALE;
+        rec.x2 /= SCALE; rec.y2 /= SCALE;
+        rec.width /= SCALE;
+    }
+
+    seg.line = Vec4f(float(rec.x1), float(rec.y1), float(rec.x2), float(rec.y2));
+    seg.width = rec.width;
+    seg.prec = rec.p;
+    seg.nfa = log_nfa;
+    return REGION_LINE;
 }
 
 void LineSegmentDetectorImpl::ll_angle(const double& threshold,
@@ -542,58 +686,98 @@ void LineSegmentDetectorImpl::ll_angle(const double& threshold,
     angles.row(img_height - 1).setTo(NOTDEF);
     angles.col(img_width - 1).setTo(NOTDEF);
 
-    // Computing gradient for remaining pixels
-    double max_grad = -1;
-    for(int y = 0; y < img_height - 1; ++y)
+    // Computing gradient for remaining pixels, the stripes of rows are processed in parallel
+    const int nstripes = std::max(std::min(getNumThreads(), (img_height - 1) / 64), 1);
+    std::vector<double> stripe_max_grad(nstripes, -1);
+    parallel_for_(Range(0, nstripes), [&](const Range& range)
     {
-        const uchar* scaled_image_row = scaled_image.ptr<uchar>(y);
-        const uchar* next_scaled_image_row = scaled_image.ptr<uchar>(y+1);
-        double* angles_row = angles.ptr<double>(y);
-        double* modgrad_row = modgrad.ptr<double>(y);
-        for(int x = 0; x < img_width-1; ++x)
+        for(int s = range.start; s < range.end; ++s)
         {
-            int DA = next_scaled_image_row[x + 1] - scaled_image_row[x];
-            int BC = scaled_image_row[x + 1] - next_scaled_image_row[x];
-            int gx = DA + BC;    // gradient x component
-            int gy = DA - BC;    // gradient y component
-            double norm = std::sqrt((gx * gx + gy * gy) / 4.0); // gradient norm
-
-            modgrad_row[x] = norm;    // store gradient
-
-            if (norm <= threshold)  // norm too small, gradient no defined
+            double max_grad = -1;
+            const int y0 = (img_height - 1) * s / nstripes, y1 = (img_height - 1) * (s + 1) / nstripes;
+            for(int y = y0; y < y1; ++y)
             {
-                angles_row[x] = NOTDEF;
+                const uchar* scaled_image_row = scaled_image.ptr<uchar>(y);
+                const uchar* next_scaled_image_row = scaled_image.ptr<uchar>(y+1);
+                double* angles_row = angles.ptr<double>(y);
+                double* modgrad_row = modgrad.ptr<double>(y);
+                for(int x = 0; x < img_width-1; ++x)
+                {
+                    int DA = next_scaled_image_row[x + 1] - scaled_image_row[x];
+                    int BC = scaled_image_row[x + 1] - next_scaled_image_row[x];
+                    int gx = DA + BC;    // gradient x component
+                    int gy = DA - BC;    // gradient y component
+                    double norm = std::sqrt((gx * gx + gy * gy) / 4.0); // gradient norm
+
+                    modgrad_row[x] = norm;    // store gradient
+
+                    if (norm <= threshold)  // norm too small, gradient no defined
+                    {
+                        angles_row[x] = NOTDEF;
+                    }
+                    else
+                    {
+                        angles_row[x] = fastAtan2(float(gx), float(-gy)) * DEG_TO_RADS;  // gradient angle computation
+                        if (norm > max_grad) { max_grad = norm; }
+                    }
+                }
             }
-            else
+            stripe_max_grad[s] = max_grad;
+        }
+    });
+    double max_grad = *std::max_element(stripe_max_grad.begin(), stripe_max_grad.end());
+
+    double bin_coef = (max_grad > 0) ? double(n_bins - 1) / max_grad : 0; // If all image is smooth, max_grad <= 0
+    if ((int64)img_width * img_height < PARALLEL_MIN_AREA)
+    {
+        // Compute histogram of gradient values
+        ordered_points.reserve((size_t)(img_width - 1) * (img_height - 1));
+        for(int y = 0; y < img_height - 1; ++y)
+        {
+            const double* modgrad_row = modgrad.ptr<double>(y);
+            for(int x = 0; x < img_width - 1; ++x)
             {
-                angles_row[x] = fastAtan2(float(gx), float(-gy)) * DEG_TO_RADS;  // gradient angle computation
-                if (norm > max_grad) { max_grad = norm; }
+                normPoint _point;
+                int i = int(modgrad_row[x] * bin_coef);
+                _point.p = Point(x, y);
+                _point.norm = i;
+                ordered_points.push_back(_point);
             }
-
         }
+
+        // Sort
+        std::sort(ordered_points.begin(), ordered_points.end(), compare_norm);
+        return;
     }
 
-    // Compute histogram of gradient values
-    double bin_coef = (max_grad > 0) ? double(n_bins - 1) / max_grad : 0; // If all image is smooth, max_grad <= 0
+    // Pseudo-order the points by the gradient norm with a bucket sort: the strongest
+    // gradients come first, the points of the same bin stay in raster order
+    std::vector<int> bin_start(n_bins + 1, 0);
+    for(int y = 0; y < img_height - 1; ++y)
+    {
+        const double* modgrad_row = modgrad.ptr<double>(y);
+        for(int x = 0; x < img_width - 1; ++x)
+            bin_start[n_bins - int(modgrad_row[x] * bin_coef)]++;
+    }
+    for(unsigned int i = 0; i < n_bins; ++i)
+        bin_start[i + 1] += bin_start[i];
+
+    ordered_points.resize(bin_start[n_bins]);
     for(int y = 0; y < img_height - 1; ++y)
     {
         const double* modgrad_row = modgrad.ptr<double>(y);
         for(int x = 0; x < img_width - 1; ++x)
         {
-            normPoint _point;
             int i = int(modgrad_row[x] * bin_coef);
+            normPoint& _point = ordered_points[bin_start[n_bins - 1 - i]++];
             _point.p = Point(x, y);
             _point.norm = i;
-            ordered_points.push_back(_point);
         }
     }
-
-    // Sort
-    std::sort(ordered_points.begin(), ordered_points.end(), compare_norm);
 }
 
-void LineSegmentDetectorImpl::region_grow(const Point2i& s, std::vector<RegionPoint>& reg,
-                                      double& reg_angle, const double& prec)
+bool LineSegmentDetectorImpl::region_grow(const Point2i& s, std::vector<RegionPoint>& reg,
+                                      double& reg_angle, const double& prec, const Rect& bounds)
 {
     reg.clear();
 
@@ -624,10 +808,18 @@ void LineSegmentDetectorImpl::region_grow(const Point2i& s, std::vector<RegionPo
             const double* modgrad_row = modgrad.ptr<double>(yy);
             for(int xx = xx_min; xx <= xx_max; ++xx)
             {
+                if(!bounds.contains(Point(xx, yy)))
+                {
+                    // The point may belong to another tile, the region is left to the sequential pass
+                    if(isAligned(xx, yy, reg_angle, prec)) { return false; }
+                    continue;
+                }
                 uchar& is_used = used_row[xx];
                 if(is_used != USED &&
                    (isAligned(xx, yy, reg_angle, prec)))
                 {
+                    // The region joins one already left for the sequential pass
+                    if(is_used == RESERVED) { return false; }
                     const double& angle = angles_row[xx];
                     // Add point
                     is_used = USED;
@@ -648,6 +840,7 @@ void LineSegmentDetectorImpl::region_grow(const Point2i& s, std::vector<RegionPo
             }
         }
     }
+    return true;
 }
 
 void LineSegmentDetectorImpl::region2rect(const std::vector<RegionPoint>& reg,
@@ -747,7 +940,8 @@ double LineSegmentDetectorImpl::get_theta(const std::vector<RegionPoint>& reg, c
 }
 
 bool LineSegmentDetectorImpl::refine(std::vector<RegionPoint>& reg, double reg_angle,
-                                 const double prec, double p, rect& rec, const double& density_th)
+                                 const double prec, double p, rect& rec, const double& density_th,
+                                 const Rect& bounds, bool& escaped)
 {
     double density = double(reg.size()) / (dist(rec.x1, rec.y1, rec.x2, rec.y2) * rec.width);
 
@@ -778,7 +972,11 @@ bool LineSegmentDetectorImpl::refine(std::vector<RegionPoint>& reg, double reg_a
     double tau = 2.0 * sqrt((s_sum - 2.0 * mean_angle * sum) / double(n) + mean_angle * mean_angle);
 
     // Try new region
-    region_grow(Point(reg[0].x, reg[0].y), reg, reg_angle, tau);
+    if (!region_grow(Point(reg[0].x, reg[0].y), reg, reg_angle, tau, bounds))
+    {
+        escaped = true;
+        return false;
+    }
 
     if (reg.size() < 2) { return false; }
 
@@ -357,6 +357,102 @@ static void momentsInTile( const Mat& img, double* moments )
 
 typedef void (*MomentsInTileFunc)(const Mat& img, double* moments);
 
+// shifts the moments of a tile located at (x, y) to the image origin and adds them to m
+static inline void accumulateTileMoments( double* m, const double* mom, double x, double y )
+{
+    double xm = x * mom[0], ym = y * mom[0];
+
+    // + m00 ( = m00' )
+    m[0] += mom[0];
+
+    // + m10 ( = m10' + x*m00' )
+    m[1] += mom[1] + xm;
+
+    // + m01 ( = m01' + y*m00' )
+    m[2] += mom[2] + ym;
+
+    // + m20 ( = m20' + 2*x*m10' + x*x*m00' )
+    m[3] += mom[3] + x * (mom[1] * 2 + xm);
+
+    // + m11 ( = m11' + x*m01' + y*m10' + x*y*m00' )
+    m[4] += mom[4] + x * (mom[2] + ym) + y * mom[1];
+
+    // + m02 ( = m02' + 2*y*m01' + y*y*m00' )
+    m[5] += mom[5] + y * (mom[2] * 2 + ym);
+
+    // + m30 ( = m30' + 3*x*m20' + 3*x*x*m10' + x*x*x*m00' )
+    m[6] += mom[6] + x * (3. * mom[3] + x * (3. * mom[1] + xm));
+
+    // + m21 ( = m21' + x*(2*m11' + 2*y*m10' + x*m01' + x*y*m00') + y*m20')
+    m[7] += mom[7] + x * (2 * (mom[4] + y * mom[1]) + x * (mom[2] + ym)) + y * mom[3];
+
+    // + m12 ( = m12' + y*(2*m11' + 2*x*m01' + y*m10' + x*y*m00') + x*m02')
+    m[8] += mom[8] + y * (2 * (mom[4] + x * mom[2]) + y * (mom[1] + xm)) + x * mom[5];
+
+    // + m03 ( = m03' + 3*y*m02' + 3*y*y*m01' + y*y*y*m00' )
+    m[9] += mom[9] + y * (3. * mom[5] + y * (3. * mom[2] + ym));
+}
+
+// computes the moments of each row of tiles in the range
+class MomentsInvoker : public ParallelLoopBody
+{
+public:
+    MomentsInvoker( const Mat& _src, MomentsInTileFunc _func, bool _binary, int _tileSize, double* _rowmom )
+        : src(_src), func(_func), binary(_binary), tileSize(_tileSize), rowmom(_rowmom)
+    {
+        CV_Assert( tileSize <= 32 );
+    }
+
+    void operator()( const Range& range ) const CV_OVERRIDE
+    {
+        uchar nzbuf[32*32];
+        Size size = src.size();
+
+        for( int i = range.start; i < range.end; i++ )
+        {
+            int y = i*tileSize;
+            double* m = rowmom + i*10;
+            Size tsz;
+            tsz.height = std::min(tileSize, size.height - y);
+
+            for( int k = 0; k < 10; k++ )
+                m[k] = 0;
+
+            for( int x = 0; x < size.width; x += tileSize )
+            {
+                tsz.width = std::min(tileSize, size.width - x);
+                Mat tile(src, Rect(x, y, tsz.width, tsz.height));
+
+                if( binary )
+                {
+                    Mat tmp(tsz, CV_8U, nzbuf);
+                    compare( tile, 0, tmp, CMP_NE );
+                    tile = tmp;
+                }
+
+                double mom[10];
+                func( tile, mom );
+
+                if( binary )
+                {
+                    double s = 1./255;
+                    for( int k = 0; k < 10; k++ )
+                        mom[k] *= s;
+                }
+
+                accumulateTileMoments( m, mom, x, y );
+            }
+        }
+    }
+
+private:
+    Mat src;
+    MomentsInTileFunc func;
+    bool binary;
+    int tileSize;
+    double* rowmom;
+};
+
 Moments::Moments()
 {
     m00 = m10 = m01 = m20 = m11 = m02 = m30 = m21 = m12 = m03 =
@@ -567,7 +663,6 @@ cv::Moments cv::moments( InputArray _src, bool binary )
 
     const int TILE_SIZE = 32;
     MomentsInTileFunc func = 0;
-    uchar nzbuf[TILE_SIZE*TILE_SIZE];
     Moments m;
     int type = _src.type(), depth = CV_MAT_DEPTH(type), cn = CV_MAT_CN(type);
     Size size = _src.size();
@@ -601,73 +696,220 @@ cv::Moments cv::moments( InputArray _src, bool binary )
     else
         CV_Error( CV_StsUnsupportedFormat, "" );
 
-    Mat src0(mat);
+    // every row of tiles is accumulated separately and the rows are summed in order,
+    // so the result does not depend on the number of threads
+    int ntiles = (size.height + TILE_SIZE - 1)/TILE_SIZE;
+    AutoBuffer<double> rowmom(ntiles*10);
+    MomentsInvoker body(mat, func, binary, TILE_SIZE, rowmom.data());
+    parallel_for_(Range(0, ntiles), body, (double)size.area()/(1 << 16));
 
-    for( int y = 0; y < size.height; y += TILE_SIZE )
-    {
-        Size tileSize;
-        tileSize.height = std::min(TILE_SIZE, size.height - y);
+    double mom[10] = {0,0,0,0,0,0,0,0,0,0};
+    for( int i = 0; i < ntiles; i++ )
+        for( int k = 0; k < 10; k++ )
+            mom[k] += rowmom[i*10 + k];
+
+    m.m00 = mom[0]; m.m10 = mom[1]; m.m01 = mom[2];
+    m.m20 = mom[3]; m.m11 = mom[4]; m.m02 = mom[5];
+    m.m30 = mom[6]; m.m21 = mom[7]; m.m12 = mom[8]; m.m03 = mom[9];
 
-        for( int x = 0; x < size.width; x += TILE_SIZE )
+    completeMomentState( &m );
+    return m;
+}
+
+namespace cv
+{
+
+class ContoursMomentsInvoker : public ParallelLoopBody
+{
+public:
+    ContoursMomentsInvoker( const std::vector<Mat>& _contours, Moments* _moments, Rect* _rects )
+        : contours(_contours), moments(_moments), rects(_rects) {}
+
+    void operator()( const Range& range ) const CV_OVERRIDE
+    {
+        for( int i = range.start; i < range.end; i++ )
         {
-            tileSize.width = std::min(TILE_SIZE, size.width - x);
-            Mat src(src0, cv::Rect(x, y, tileSize.width, tileSize.height));
+            const Mat& contour = contours[i];
+            moments[i] = contour.empty() ? Moments() : contourMoments(contour);
+            if( rects )
+                rects[i] = contour.empty() ? Rect() : boundingRect(contour);
+        }
+    }
 
-            if( binary )
-            {
-                cv::Mat tmp(tileSize, CV_8U, nzbuf);
-                cv::compare( src, 0, tmp, CV_CMP_NE );
-                src = tmp;
-            }
+private:
+    const std::vector<Mat>& contours;
+    Moments* moments;
+    Rect* rects;
+};
 
-            double mom[10];
-            func( src, mom );
+// sums of x^k over a run of pixels [a, b): S1 = sum x, S2 = sum x^2, S3 = sum x^3
+static inline void runPowerSums( int64 a, int64 b, double& s1, double& s2, double& s3 )
+{
+    int64 sa1 = a*(a - 1)/2, sb1 = b*(b - 1)/2;
+    double fa = (double)a, fb = (double)b;
+    s1 = (double)(sb1 - sa1);
+    s2 = (fb - 1)*fb*(2*fb - 1)/6 - (fa - 1)*fa*(2*fa - 1)/6;
+    s3 = (double)sb1*sb1 - (double)sa1*sa1;
+}
+
+template<typename T>
+class LabelsMomentsInvoker : public ParallelLoopBody
+{
+public:
+    LabelsMomentsInvoker( const Mat& _labels, int _nlabels, int _nstripes, double* _mom, int* _bbox )
+        : labels(_labels), nlabels(_nlabels), nstripes(_nstripes), mom(_mom), bbox(_bbox) {}
 
-            if(binary)
+    void operator()( const Range& range ) const CV_OVERRIDE
+    {
+        int width = labels.cols, height = labels.rows;
+        for( int s = range.start; s < range.end; s++ )
+        {
+            int y0 = (int)((int64)height*s/nstripes), y1 = (int)((int64)height*(s + 1)/nstripes);
+            double* m = mom + (size_t)s*nlabels*10;
+            int* b = bbox + (size_t)s*nlabels*4;
+
+            for( int y = y0; y < y1; y++ )
             {
-                double s = 1./255;
-                for( int k = 0; k < 10; k++ )
-                    mom[k] *= s;
+                const T* row = labels.ptr<T>(y);
+                double fy = y, fy2 = fy*fy, fy3 = fy2*fy;
+
+                for( int x = 0; x < width; )
+                {
+                    T lval = row[x];
+                    int l = (int)lval, x0 = x;
+                    while( ++x < width && row[x] == lval )
+                        ;
+                    if( l < 0 || l >= nlabels )
+                        continue;
+
+                    double n = x - x0, s1, s2, s3;
+                    runPowerSums(x0, x, s1, s2, s3);
+
+                    double* ml = m + l*10;
+                    ml[0] += n;        // m00
+                    ml[1] += s1;       // m10
+                    ml[2] += n*fy;     // m01
+                    ml[3] += s2;       // m20
+                    ml[4] += s1*fy;    // m11
+                    ml[5] += n*fy2;    // m02
+                    ml[6] += s3;       // m30
+                    ml[7] += s2*fy;    // m21
+                    ml[8] += s1*fy2;   // m12
+                    ml[9] += n*fy3;    // m03
+
+                    int* bl = b + l*4;
+                    bl[0] = std::min(bl[0], x0);
+                    bl[1] = std::min(bl[1], y);
+                    bl[2] = std::max(bl[2], x - 1);
+                    bl[3] = std::max(bl[3], y);
+                }
             }
+        }
+    }
 
-            double xm = x * mom[0], ym = y * mom[0];
+private:
+    Mat labels;
+    int nlabels, nstripes;
+    double* mom;
+    int* bbox;
+};
 
-            // accumulate moments computed in each tile
+}
 
-            // + m00 ( = m00' )
-            m.m00 += mom[0];
+void cv::contoursMoments( InputArrayOfArrays _contours, std::vector<Moments>& moments, OutputArray _boundingRects )
+{
+    CV_INSTRUMENT_REGION();
 
-            // + m10 ( = m10' + x*m00' )
-            m.m10 += mom[1] + xm;
+    int i, ncontours = (int)_contours.total();
+    std::vector<Mat> contours(ncontours);
+    for( i = 0; i < ncontours; i++ )
+    {
+        contours[i] = _contours.getMat(i);
+        CV_Assert( contours[i].empty() || contours[i].checkVector(2) >= 0 );
+    }
 
-            // + m01 ( = m01' + y*m00' )
-            m.m01 += mom[2] + ym;
+    moments.resize(ncontours);
+    Mat rects;
+    if( _boundingRects.needed() )
+    {
+        _boundingRects.create(ncontours, 1, CV_32SC4, -1, true);
+        rects = _boundingRects.getMat();
+    }
+    if( ncontours == 0 )
+        return;
+
+    ContoursMomentsInvoker body(contours, &moments[0], rects.empty() ? 0 : rects.ptr<Rect>());
+    parallel_for_(Range(0, ncontours), body, ncontours/64.);
+}
 
-            // + m20 ( = m20' + 2*x*m10' + x*x*m00' )
-            m.m20 += mom[3] + x * (mom[1] * 2 + xm);
+void cv::labelsMoments( InputArray _labels, std::vector<Moments>& moments, OutputArray _boundingRects, int nlabels )
+{
+    CV_INSTRUMENT_REGION();
 
-            // + m11 ( = m11' + x*m01' + y*m10' + x*y*m00' )
-            m.m11 += mom[4] + x * (mom[2] + ym) + y * mom[1];
+    Mat labels = _labels.getMat();
+    int depth = labels.depth();
+    CV_Assert( labels.dims == 2 && labels.channels() == 1 &&
+               (depth == CV_8U || depth == CV_16U || depth == CV_32S) );
 
-            // + m02 ( = m02' + 2*y*m01' + y*y*m00' )
-            m.m02 += mom[5] + y * (mom[2] * 2 + ym);
+    if( nlabels < 0 )
+    {
+        double maxVal = -1;
+        if( !labels.empty() )
+            minMaxIdx(labels, 0, &maxVal);
+        nlabels = (int)maxVal + 1;
+    }
 
-            // + m30 ( = m30' + 3*x*m20' + 3*x*x*m10' + x*x*x*m00' )
-            m.m30 += mom[6] + x * (3. * mom[3] + x * (3. * mom[1] + xm));
+    // every stripe keeps its own accumulators, so their number is limited by the amount of labels
+    int nstripes = std::max(std::min(std::min(getNumThreads(), labels.rows/16), (1 << 20)/std::max(nlabels, 1)), 1);
+    AutoBuffer<double> mom((size_t)nstripes*nlabels*10 + 1);
+    AutoBuffer<int> bbox((size_t)nstripes*nlabels*4 + 1);
+    for( size_t k = 0; k < (size_t)nstripes*nlabels; k++ )
+    {
+        for( int j = 0; j < 10; j++ )
+            mom[k*10 + j] = 0;
+        bbox[k*4] = bbox[k*4 + 1] = INT_MAX;
+        bbox[k*4 + 2] = bbox[k*4 + 3] = INT_MIN;
+    }
 
-            // + m21 ( = m21' + x*(2*m11' + 2*y*m10' + x*m01' + x*y*m00') + y*m20')
-            m.m21 += mom[7] + x * (2 * (mom[4] + y * mom[1]) + x * (mom[2] + ym)) + y * mom[3];
+    if( !labels.empty() && nlabels > 0 )
+    {
+        Range range(0, nstripes);
+        if( depth == CV_8U )
+            parallel_for_(range, LabelsMomentsInvoker<uchar>(labels, nlabels, nstripes, mom.data(), bbox.data()));
+        else if( depth == CV_16U )
+            parallel_for_(range, LabelsMomentsInvoker<ushort>(labels, nlabels, nstripes, mom.data(), bbox.data()));
+        else
+            parallel_for_(range, LabelsMomentsInvoker<int>(labels, nlabels, nstripes, mom.data(), bbox.data()));
+    }
 
-            // + m12 ( = m12' + y*(2*m11' + 2*x*m01' + y*m10' + x*y*m00') + x*m02')
-            m.m12 += mom[8] + y * (2 * (mom[4] + x * mom[2]) + y * (mom[1] + xm)) + x * mom[5];
+    moments.resize(nlabels);
+    Rect* rects = 0;
+    Mat rectsMat;
+    if( _boundingRects.needed() )
+    {
+        _boundingRects.create(nlabels, 1, CV_32SC4, -1, true);
+        rectsMat = _boundingRects.getMat();
+        rects = rectsMat.ptr<Rect>();
+    }
 
-            // + m03 ( = m03' + 3*y*m02' + 3*y*y*m01' + y*y*y*m00' )
-            m.m03 += mom[9] + y * (3. * mom[5] + y * (3. * mom[2] + ym));
+    for( int l = 0; l < nlabels; l++ )
+    {
+        double m[10] = {0,0,0,0,0,0,0,0,0,0};
+        int b[4] = { INT_MAX, INT_MAX, INT_MIN, INT_MIN };
+        for( int s = 0; s < nstripes; s++ )
+        {
+            const double* ms = mom.data() + ((size_t)s*nlabels + l)*10;
+            const int* bs = bbox.data() + ((size_t)s*nlabels + l)*4;
+            for( int k = 0; k < 10; k++ )
+                m[k] += ms[k];
+            b[0] = std::min(b[0], bs[0]); b[1] = std::min(b[1], bs[1]);
+            b[2] = std::max(b[2], bs[2]); b[3] = std::max(b[3], bs[3]);
         }
-    }
 
-    completeMomentState( &m );
-    return m;
+        moments[l] = Moments(m[0], m[1], m[2], m[3], m[4], m[5], m[6], m[7], m[8], m[9]);
+        if( rects )
+            rects[l] = m[0] > 0 ? Rect(b[0], b[1], b[2] - b[0] + 1, b[3] - b[1] + 1) : Rect();
+    }
 }
 
 
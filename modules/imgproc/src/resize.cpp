@@ -4077,6 +4077,7 @@ void cv::resize( InputArray _src, OutputArray _dst, Size dsize,
     Mat src = _src.getMat();
     _dst.create(dsize, src.type());
     Mat dst = _dst.getMat();
+    CV_TRACE_BYTES(src.total() * src.elemSize() + dst.total() * dst.elemSize());
 
     if (dsize == ssize)
     {
@@ -41,6 +41,7 @@
 //M*/
 
 #include "precomp.hpp"
+#include "opencv2/core/hal/intrin.hpp"
 
 /****************************************************************************************\
 *                                       Watershed                                        *
@@ -82,13 +83,9 @@ allocWSNodes( std::vector<WSNode>& storage )
     return sz;
 }
 
-}
-
 
-void cv::watershed( InputArray _src, InputOutputArray _markers )
+static void watershedImpl( const Mat& src, Mat& dst )
 {
-    CV_INSTRUMENT_REGION();
-
     // Labels for pixels
     const int IN_QUEUE = -2; // Pixel visited
     const int WSHED = -1; // Pixel belongs to watershed
@@ -96,7 +93,6 @@ void cv::watershed( InputArray _src, InputOutputArray _markers )
     // possible bit values = 2^8
     const int NQ = 256;
 
-    Mat src = _src.getMat(), dst = _markers.getMat();
     Size size = src.size();
 
     // Vector of every created node
@@ -158,9 +154,6 @@ void cv::watershed( InputArray _src, InputOutputArray _markers )
         assert( 0 <= diff && diff <= 255 );  \
     }
 
-    CV_Assert( src.type() == CV_8UC3 && dst.type() == CV_32SC1 );
-    CV_Assert( src.size() == dst.size() );
-
     // Current pixel in input image
     const uchar* img = src.ptr();
     // Step size to next row in input image
@@ -325,11 +318,230 @@ void cv::watershed( InputArray _src, InputOutputArray _markers )
 }
 
 
+// segments a batch of images, each one is flooded sequentially
+class WatershedInvoker : public ParallelLoopBody
+{
+public:
+    WatershedInvoker( const std::vector<Mat>& _src, std::vector<Mat>& _markers )
+        : src(_src), markers(_markers) {}
+
+    void operator()( const Range& range ) const CV_OVERRIDE
+    {
+        for( int i = range.start; i < range.end; i++ )
+            watershedImpl( src[i], markers[i] );
+    }
+
+private:
+    const std::vector<Mat>& src;
+    std::vector<Mat>& markers;
+};
+
+}
+
+
+void cv::watershed( InputArray _src, InputOutputArray _markers )
+{
+    CV_INSTRUMENT_REGION();
+
+    if( _src.isMatVector() )
+    {
+        std::vector<Mat> src, markers;
+        _src.getMatVector(src);
+        _markers.getMatVector(markers);
+        CV_Assert( src.size() == markers.size() );
+        for( size_t i = 0; i < src.size(); i++ )
+        {
+            CV_Assert( src[i].type() == CV_8UC3 && markers[i].type() == CV_32SC1 );
+            CV_Assert( src[i].size() == markers[i].size() );
+        }
+
+        parallel_for_(Range(0, (int)src.size()), WatershedInvoker(src, markers));
+        return;
+    }
+
+    Mat src = _src.getMat(), dst = _markers.getMat();
+    CV_Assert( src.type() == CV_8UC3 && dst.type() == CV_32SC1 );
+    CV_Assert( src.size() == dst.size() );
+
+    watershedImpl( src, dst );
+}
+
+
 /****************************************************************************************\
 *                                         Meanshift                                      *
 \****************************************************************************************/
 
 
+namespace cv
+{
+
+#if CV_SIMD128
+// accumulates the pixels of a window row which are within the color radius, returns the first unprocessed pixel
+static int meanShiftRow_SIMD( const uchar* ptr, int x, int maxx, int c0, int c1, int c2, int isr2,
+                              int& s0, int& s1, int& s2, int& sx, int& count )
+{
+    v_int16x8 vc0 = v_setall_s16((short)c0), vc1 = v_setall_s16((short)c1), vc2 = v_setall_s16((short)c2);
+    v_int32x4 vr = v_setall_s32(isr2), z = v_setzero_s32();
+    v_int32x4 vs0 = z, vs1 = z, vs2 = z, vsx = z, vcount = z;
+    v_int32x4 vx = v_int32x4(x, x + 1, x + 2, x + 3), delta = v_setall_s32(4);
+
+    for( ; x + 16 <= maxx + 1; x += 16, ptr += 48 )
+    {
+        v_uint8x16 b0, b1, b2;
+        v_load_deinterleave(ptr, b0, b1, b2);
+        v_uint16x8 t0[2], t1[2], t2[2];
+        v_expand(b0, t0[0], t0[1]);
+        v_expand(b1, t1[0], t1[1]);
+        v_expand(b2, t2[0], t2[1]);
+
+        for( int k = 0; k < 2; k++ )
+        {
+            v_int16x8 d0 = v_reinterpret_as_s16(t0[k]) - vc0;
+            v_int16x8 d1 = v_reinterpret_as_s16(t1[k]) - vc1;
+            v_int16x8 d2 = v_reinterpret_as_s16(t2[k]) - vc2;
+            v_int32x4 q0[2], q1[2], q2[2];
+            v_mul_expand(d0, d0, q0[0], q0[1]);
+            v_mul_expand(d1, d1, q1[0], q1[1]);
+            v_mul_expand(d2, d2, q2[0], q2[1]);
+
+            v_uint32x4 u0[2], u1[2], u2[2];
+            v_expand(t0[k], u0[0], u0[1]);
+            v_expand(t1[k], u1[0], u1[1]);
+            v_expand(t2[k], u2[0], u2[1]);
+
+            for( int h = 0; h < 2; h++ )
+            {
+                v_int32x4 inside = (q0[h] + q1[h] + q2[h]) <= vr;
+                vs0 += v_reinterpret_as_s32(u0[h]) & inside;
+                vs1 += v_reinterpret_as_s32(u1[h]) & inside;
+                vs2 += v_reinterpret_as_s32(u2[h]) & inside;
+                vsx += vx & inside;
+                vcount -= inside;
+                vx += delta;
+            }
+        }
+    }
+
+    s0 += v_reduce_sum(vs0);
+    s1 += v_reduce_sum(vs1);
+    s2 += v_reduce_sum(vs2);
+    sx += v_reduce_sum(vsx);
+    count += v_reduce_sum(vcount);
+    return x;
+}
+#endif
+
+// runs the meanshift iterations for the pixels of a pyramid layer, the rows are independent
+class MeanShiftInvoker : public ParallelLoopBody
+{
+public:
+    MeanShiftInvoker( const Mat& _src, Mat& _dst, const Mat& _mask, float _sp, int _isr2,
+                      const int* _tab, const TermCriteria& termcrit )
+        : src(_src), dst(_dst), mask(_mask), sp(_sp), isr2(_isr2), tab(_tab),
+          maxCount(termcrit.maxCount), epsilon(termcrit.epsilon) {}
+
+    void operator()( const Range& range ) const CV_OVERRIDE
+    {
+        int width = src.cols, height = src.rows;
+        int sstep = (int)src.step;
+
+        for( int i = range.start; i < range.end; i++ )
+        {
+            const uchar* sptr = src.ptr(i);
+            uchar* dptr = dst.ptr(i);
+            const uchar* mrow = mask.empty() ? NULL : mask.ptr(i);
+
+            for( int j = 0; j < width; j++, sptr += 3, dptr += 3 )
+            {
+                int x0 = j, y0 = i, x1, y1, iter;
+                int c0, c1, c2;
+
+                if( mrow && !mrow[j] )
+                    continue;
+
+                c0 = sptr[0], c1 = sptr[1], c2 = sptr[2];
+
+                // iterate meanshift procedure
+                for( iter = 0; iter < maxCount; iter++ )
+                {
+                    const uchar* ptr;
+                    int x, y, count = 0;
+                    int minx, miny, maxx, maxy;
+                    int s0 = 0, s1 = 0, s2 = 0, sx = 0, sy = 0;
+                    double icount;
+                    int stop_flag;
+
+                    //mean shift: process pixels in window (p-sigmaSp)x(p+sigmaSp)
+                    minx = cvRound(x0 - sp); minx = MAX(minx, 0);
+                    miny = cvRound(y0 - sp); miny = MAX(miny, 0);
+                    maxx = cvRound(x0 + sp); maxx = MIN(maxx, width-1);
+                    maxy = cvRound(y0 + sp); maxy = MIN(maxy, height-1);
+                    ptr = sptr + (miny - i)*sstep + (minx - j)*3;
+
+                    for( y = miny; y <= maxy; y++, ptr += sstep - (maxx-minx+1)*3 )
+                    {
+                        int row_count = 0;
+                        x = minx;
+                        #if CV_SIMD128
+                        int xend = meanShiftRow_SIMD(ptr, x, maxx, c0, c1, c2, isr2, s0, s1, s2, sx, row_count);
+                        ptr += (xend - x)*3;
+                        x = xend;
+                        #endif
+                        for( ; x <= maxx; x++, ptr += 3 )
+                        {
+                            int t0 = ptr[0], t1 = ptr[1], t2 = ptr[2];
+                            if( tab[t0-c0+255] + tab[t1-c1+255] + tab[t2-c2+255] <= isr2 )
+                            {
+                                s0 += t0; s1 += t1; s2 += t2;
+                                sx += x; row_count++;
+                            }
+                        }
+                        count += row_count;
+                        sy += y*row_count;
+                    }
+
+                    if( count == 0 )
+                        break;
+
+                    icount = 1./count;
+                    x1 = cvRound(sx*icount);
+                    y1 = cvRound(sy*icount);
+                    s0 = cvRound(s0*icount);
+                    s1 = cvRound(s1*icount);
+                    s2 = cvRound(s2*icount);
+
+                    stop_flag = (x0 == x1 && y0 == y1) || std::abs(x1-x0) + std::abs(y1-y0) +
+                        tab[s0 - c0 + 255] + tab[s1 - c1 + 255] +
+                        tab[s2 - c2 + 255] <= epsilon;
+
+                    x0 = x1; y0 = y1;
+                    c0 = s0; c1 = s1; c2 = s2;
+
+                    if( stop_flag )
+                        break;
+                }
+
+                dptr[0] = (uchar)c0;
+                dptr[1] = (uchar)c1;
+                dptr[2] = (uchar)c2;
+            }
+        }
+    }
+
+private:
+    Mat src;
+    Mat& dst;
+    Mat mask;
+    float sp;
+    int isr2;
+    const int* tab;
+    int maxCount;
+    double epsilon;
+};
+
+}
+
+
 void cv::pyrMeanShiftFiltering( InputArray _src, OutputArray _dst,
                                 double sp0, double sr, int max_level,
                                 TermCriteria termcrit )
@@ -405,8 +617,6 @@ void cv::pyrMeanShiftFiltering( InputArray _src, OutputArray _dst,
     {
         cv::Mat src = src_pyramid[level];
         cv::Size size = src.size();
-        const uchar* sptr = src.ptr();
-        int sstep = (int)src.step;
         uchar* dptr;
         int dstep;
         float sp = (float)(sp0 / (1 << level));
@@ -437,113 +647,9 @@ void cv::pyrMeanShiftFiltering( InputArray _src, OutputArray _dst,
             cv::dilate( m, m, cv::Mat() );
         }
 
-        dptr = dst_pyramid[level].ptr();
-        dstep = (int)dst_pyramid[level].step;
-
-        for( i = 0; i < size.height; i++, sptr += sstep - size.width*3,
-                                          dptr += dstep - size.width*3
-        )
-        {
-            uchar* mask = m.empty() ? NULL : m.ptr(i);
-            for( j = 0; j < size.width; j++, sptr += 3, dptr += 3 )
-            {
-                int x0 = j, y0 = i, x1, y1, iter;
-                int c0, c1, c2;
-
-                if( mask && !mask[j] )
-                    continue;
-
-                c0 = sptr[0], c1 = sptr[1], c2 = sptr[2];
-
-                // iterate meanshift procedure
-                for( iter = 0; iter < termcrit.maxCount; iter++ )
-                {
-                    const uchar* ptr;
-                    int x, y, count = 0;
-                    int minx, miny, maxx, maxy;
-                    int s0 = 0, s1 = 0, s2 = 0, sx = 0, sy = 0;
-                    double icount;
-                    int stop_flag;
-
-                    //mean shift: process pixels in window (p-sigmaSp)x(p+sigmaSp)
-                    minx = cvRound(x0 - sp); minx = MAX(minx, 0);
-                    miny = cvRound(y0 - sp); miny = MAX(miny, 0);
-                    maxx = cvRound(x0 + sp); maxx = MIN(maxx, size.width-1);
-                    maxy = cvRound(y0 + sp); maxy = MIN(maxy, size.height-1);
-                    ptr = sptr + (miny - i)*sstep + (minx - j)*3;
-
-                    for( y = miny; y <= maxy; y++, ptr += sstep - (maxx-minx+1)*3 )
-                    {
-                        int row_count = 0;
-                        x = minx;
-                        #if CV_ENABLE_UNROLLED
-                        for( ; x + 3 <= maxx; x += 4, ptr += 12 )
-                        {
-                            int t0 = ptr[0], t1 = ptr[1], t2 = ptr[2];
-                            if( tab[t0-c0+255] + tab[t1-c1+255] + tab[t2-c2+255] <= isr2 )
-                            {
-                                s0 += t0; s1 += t1; s2 += t2;
-                                sx += x; row_count++;
-                            }
-                            t0 = ptr[3], t1 = ptr[4], t2 = ptr[5];
-                            if( tab[t0-c0+255] + tab[t1-c1+255] + tab[t2-c2+255] <= isr2 )
-                            {
-                                s0 += t0; s1 += t1; s2 += t2;
-                                sx += x+1; row_count++;
-                            }
-                            t0 = ptr[6], t1 = ptr[7], t2 = ptr[8];
-                            if( tab[t0-c0+255] + tab[t1-c1+255] + tab[t2-c2+255] <= isr2 )
-                            {
-                                s0 += t0; s1 += t1; s2 += t2;
-                                sx += x+2; row_count++;
-                            }
-                            t0 = ptr[9], t1 = ptr[10], t2 = ptr[11];
-                            if( tab[t0-c0+255] + tab[t1-c1+255] + tab[t2-c2+255] <= isr2 )
-                            {
-                                s0 += t0; s1 += t1; s2 += t2;
-                                sx += x+3; row_count++;
-                            }
-                        }
-                        #endif
-                        for( ; x <= maxx; x++, ptr += 3 )
-                        {
-                            int t0 = ptr[0], t1 = ptr[1], t2 = ptr[2];
-                            if( tab[t0-c0+255] + tab[t1-c1+255] + tab[t2-c2+255] <= isr2 )
-                            {
-                                s0 += t0; s1 += t1; s2 += t2;
-                                sx += x; row_count++;
-                            }
-                        }
-                        count += row_count;
-                        sy += y*row_count;
-                    }
-
-                    if( count == 0 )
-                        break;
-
-                    icount = 1./count;
-                    x1 = cvRound(sx*icount);
-                    y1 = cvRound(sy*icount);
-                    s0 = cvRound(s0*icount);
-                    s1 = cvRound(s1*icount);
-                    s2 = cvRound(s2*icount);
-
-                    stop_flag = (x0 == x1 && y0 == y1) || std::abs(x1-x0) + std::abs(y1-y0) +
-                        tab[s0 - c0 + 255] + tab[s1 - c1 + 255] +
-                        tab[s2 - c2 + 255] <= termcrit.epsilon;
-
-                    x0 = x1; y0 = y1;
-                    c0 = s0; c1 = s1; c2 = s2;
-
-                    if( stop_flag )
-                        break;
-                }
-
-                dptr[0] = (uchar)c0;
-                dptr[1] = (uchar)c1;
-                dptr[2] = (uchar)c2;
-            }
-        }
+        parallel_for_(Range(0, size.height),
+                      MeanShiftInvoker(src, dst_pyramid[level], m, sp, isr2, tab, termcrit),
+                      (double)size.area()/(1 << 14));
     }
 }
 
@@ -563,88 +563,66 @@ static bool ocl_matchTemplate( InputArray _img, InputArray _templ, OutputArray _
 
 #include "opencv2/core/hal/hal.hpp"
 
-void crossCorr( const Mat& img, const Mat& _templ, Mat& corr,
-                Point anchor, double delta, int borderType )
+/* block decomposition of the correlation */
+struct CrossCorrPlan
+{
+    Size blocksize, dftsize;
+    int maxDepth;
+};
+
+static CrossCorrPlan makeCrossCorrPlan( Size corrSize, Size templSize, int maxDepth )
 {
     const double blockScale = 4.5;
     const int minBlockSize = 256;
-    std::vector<uchar> buf;
-
-    Mat templ = _templ;
-    int depth = img.depth(), cn = img.channels();
-    int tdepth = templ.depth(), tcn = templ.channels();
-    int cdepth = corr.depth(), ccn = corr.channels();
-
-    CV_Assert( img.dims <= 2 && templ.dims <= 2 && corr.dims <= 2 );
-
-    if( depth != tdepth && tdepth != std::max(CV_32F, depth) )
-    {
-        _templ.convertTo(templ, std::max(CV_32F, depth));
-        tdepth = templ.depth();
-    }
 
-    CV_Assert( depth == tdepth || tdepth == CV_32F);
-    CV_Assert( corr.rows <= img.rows + templ.rows - 1 &&
-               corr.cols <= img.cols + templ.cols - 1 );
+    CrossCorrPlan plan;
+    Size& blocksize = plan.blocksize;
+    Size& dftsize = plan.dftsize;
+    plan.maxDepth = maxDepth;
 
-    CV_Assert( ccn == 1 || delta == 0 );
-
-    int maxDepth = depth > CV_8S ? CV_64F : std::max(std::max(CV_32F, tdepth), cdepth);
-    Size blocksize, dftsize;
-
-    blocksize.width = cvRound(templ.cols*blockScale);
-    blocksize.width = std::max( blocksize.width, minBlockSize - templ.cols + 1 );
-    blocksize.width = std::min( blocksize.width, corr.cols );
-    blocksize.height = cvRound(templ.rows*blockScale);
-    blocksize.height = std::max( blocksize.height, minBlockSize - templ.rows + 1 );
-    blocksize.height = std::min( blocksize.height, corr.rows );
+    blocksize.width = cvRound(templSize.width*blockScale);
+    blocksize.width = std::max( blocksize.width, minBlockSize - templSize.width + 1 );
+    blocksize.width = std::min( blocksize.width, corrSize.width );
+    blocksize.height = cvRound(templSize.height*blockScale);
+    blocksize.height = std::max( blocksize.height, minBlockSize - templSize.height + 1 );
+    blocksize.height = std::min( blocksize.height, corrSize.height );
 
-    dftsize.width = std::max(getOptimalDFTSize(blocksize.width + templ.cols - 1), 2);
-    dftsize.height = getOptimalDFTSize(blocksize.height + templ.rows - 1);
+    dftsize.width = std::max(getOptimalDFTSize(blocksize.width + templSize.width - 1), 2);
+    dftsize.height = getOptimalDFTSize(blocksize.height + templSize.height - 1);
     if( dftsize.width <= 0 || dftsize.height <= 0 )
         CV_Error( CV_StsOutOfRange, "the input arrays are too big" );
 
     // recompute block size
-    blocksize.width = dftsize.width - templ.cols + 1;
-    blocksize.width = MIN( blocksize.width, corr.cols );
-    blocksize.height = dftsize.height - templ.rows + 1;
-    blocksize.height = MIN( blocksize.height, corr.rows );
-
-    Mat dftTempl( dftsize.height*tcn, dftsize.width, maxDepth );
-    Mat dftImg( dftsize, maxDepth );
-
-    int i, k, bufSize = 0;
-    if( tcn > 1 && tdepth != maxDepth )
-        bufSize = templ.cols*templ.rows*CV_ELEM_SIZE(tdepth);
-
-    if( cn > 1 && depth != maxDepth )
-        bufSize = std::max( bufSize, (blocksize.width + templ.cols - 1)*
-            (blocksize.height + templ.rows - 1)*CV_ELEM_SIZE(depth));
-
-    if( (ccn > 1 || cn > 1) && cdepth != maxDepth )
-        bufSize = std::max( bufSize, blocksize.width*blocksize.height*CV_ELEM_SIZE(cdepth));
-
-    buf.resize(bufSize);
-
-    Ptr<hal::DFT2D> c = hal::DFT2D::create(dftsize.width, dftsize.height, dftTempl.depth(), 1, 1, CV_HAL_DFT_IS_INPLACE, templ.rows);
+    blocksize.width = dftsize.width - templSize.width + 1;
+    blocksize.width = MIN( blocksize.width, corrSize.width );
+    blocksize.height = dftsize.height - templSize.height + 1;
+    blocksize.height = MIN( blocksize.height, corrSize.height );
+    return plan;
+}
 
-    // compute DFT of each template plane
-    for( k = 0; k < tcn; k++ )
+/* computes DFT of each template plane, the planes are stacked vertically */
+static void templateSpectrum( const Mat& templ, const CrossCorrPlan& plan, Mat& dftTempl )
+{
+    const Size& dftsize = plan.dftsize;
+    int tcn = templ.channels();
+    dftTempl.create( dftsize.height*tcn, dftsize.width, plan.maxDepth );
+
+    Ptr<hal::DFT2D> c = hal::DFT2D::create(dftsize.width, dftsize.height, plan.maxDepth, 1, 1,
+                                           CV_HAL_DFT_IS_INPLACE, templ.rows);
+    Mat plane;
+    for( int k = 0; k < tcn; k++ )
     {
         int yofs = k*dftsize.height;
-        Mat src = templ;
         Mat dst(dftTempl, Rect(0, yofs, dftsize.width, dftsize.height));
         Mat dst1(dftTempl, Rect(0, yofs, templ.cols, templ.rows));
 
         if( tcn > 1 )
         {
-            src = tdepth == maxDepth ? dst1 : Mat(templ.size(), tdepth, &buf[0]);
-            int pairs[] = {k, 0};
-            mixChannels(&templ, 1, &src, 1, pairs, 1);
+            extractChannel(templ, plane, k);
+            plane.convertTo(dst1, dst1.depth());
         }
-
-        if( dst1.data != src.data )
-            src.convertTo(dst1, dst1.depth());
+        else
+            templ.convertTo(dst1, dst1.depth());
 
         if( dst.cols > templ.cols )
         {
@@ -653,110 +631,184 @@ void crossCorr( const Mat& img, const Mat& _templ, Mat& corr,
         }
         c->apply(dst.data, (int)dst.step, dst.data, (int)dst.step);
     }
+}
 
-    int tileCountX = (corr.cols + blocksize.width - 1)/blocksize.width;
-    int tileCountY = (corr.rows + blocksize.height - 1)/blocksize.height;
-    int tileCount = tileCountX * tileCountY;
-
-    Size wholeSize = img.size();
-    Point roiofs(0,0);
-    Mat img0 = img;
-
-    if( !(borderType & BORDER_ISOLATED) )
+/*
+   Correlates the image with one or several templates, whose spectra were computed with the same plan.
+   Every image block is transformed once for all the templates; the blocks are processed in parallel.
+*/
+class CrossCorrInvoker : public ParallelLoopBody
+{
+public:
+    CrossCorrInvoker( const Mat& _img, const Mat* _spectra, Mat* _corr, int _ncorr,
+                      Size _templSize, Size _corrSize, const CrossCorrPlan& _plan,
+                      Point _anchor, double _delta, int _borderType )
+        : img0(_img), spectra(_spectra), corr(_corr), ncorr(_ncorr), templSize(_templSize),
+          corrSize(_corrSize), plan(_plan), anchor(_anchor), delta(_delta), borderType(_borderType)
     {
-        img.locateROI(wholeSize, roiofs);
-        img0.adjustROI(roiofs.y, wholeSize.height-img.rows-roiofs.y,
-                       roiofs.x, wholeSize.width-img.cols-roiofs.x);
+        roiofs = Point(0, 0);
+        if( !(borderType & BORDER_ISOLATED) )
+        {
+            Size wholeSize;
+            _img.locateROI(wholeSize, roiofs);
+            img0.adjustROI(roiofs.y, wholeSize.height-_img.rows-roiofs.y,
+                           roiofs.x, wholeSize.width-_img.cols-roiofs.x);
+        }
+        borderType |= BORDER_ISOLATED;
+        tileCountX = (corrSize.width + plan.blocksize.width - 1)/plan.blocksize.width;
+        int tileCountY = (corrSize.height + plan.blocksize.height - 1)/plan.blocksize.height;
+        tileCount = tileCountX * tileCountY;
     }
-    borderType |= BORDER_ISOLATED;
 
-    Ptr<hal::DFT2D> cF, cR;
-    int f = CV_HAL_DFT_IS_INPLACE;
-    int f_inv = f | CV_HAL_DFT_INVERSE | CV_HAL_DFT_SCALE;
-    cF = hal::DFT2D::create(dftsize.width, dftsize.height, maxDepth, 1, 1, f, blocksize.height + templ.rows - 1);
-    cR = hal::DFT2D::create(dftsize.width, dftsize.height, maxDepth, 1, 1, f_inv, blocksize.height);
+    int tiles() const { return tileCount; }
 
-    // calculate correlation by blocks
-    for( i = 0; i < tileCount; i++ )
+    void operator()( const Range& range ) const CV_OVERRIDE
     {
-        int x = (i%tileCountX)*blocksize.width;
-        int y = (i/tileCountX)*blocksize.height;
-
-        Size bsz(std::min(blocksize.width, corr.cols - x),
-                 std::min(blocksize.height, corr.rows - y));
-        Size dsz(bsz.width + templ.cols - 1, bsz.height + templ.rows - 1);
-        int x0 = x - anchor.x + roiofs.x, y0 = y - anchor.y + roiofs.y;
-        int x1 = std::max(0, x0), y1 = std::max(0, y0);
-        int x2 = std::min(img0.cols, x0 + dsz.width);
-        int y2 = std::min(img0.rows, y0 + dsz.height);
-        Mat src0(img0, Range(y1, y2), Range(x1, x2));
-        Mat dst(dftImg, Rect(0, 0, dsz.width, dsz.height));
-        Mat dst1(dftImg, Rect(x1-x0, y1-y0, x2-x1, y2-y1));
-        Mat cdst(corr, Rect(x, y, bsz.width, bsz.height));
-
-        for( k = 0; k < cn; k++ )
+        const Size& blocksize = plan.blocksize;
+        const Size& dftsize = plan.dftsize;
+        const int maxDepth = plan.maxDepth;
+        const int cn = img0.channels(), tcn = spectra[0].rows / dftsize.height;
+        const int ccn = corr[0].channels(), cdepth = corr[0].depth();
+
+        Mat dftImg( dftsize.height*cn, dftsize.width, maxDepth );
+        Mat acc( dftsize, maxDepth ), prod( dftsize, maxDepth ), plane, cplane;
+
+        Ptr<hal::DFT2D> cF, cR;
+        int f = CV_HAL_DFT_IS_INPLACE;
+        int f_inv = f | CV_HAL_DFT_INVERSE | CV_HAL_DFT_SCALE;
+        cF = hal::DFT2D::create(dftsize.width, dftsize.height, maxDepth, 1, 1, f, blocksize.height + templSize.height - 1);
+        cR = hal::DFT2D::create(dftsize.width, dftsize.height, maxDepth, 1, 1, f_inv, blocksize.height);
+
+        for( int i = range.start; i < range.end; i++ )
         {
-            Mat src = src0;
-            dftImg = Scalar::all(0);
-
-            if( cn > 1 )
+            int x = (i%tileCountX)*blocksize.width;
+            int y = (i/tileCountX)*blocksize.height;
+
+            Size bsz(std::min(blocksize.width, corrSize.width - x),
+                     std::min(blocksize.height, corrSize.height - y));
+            Size dsz(bsz.width + templSize.width - 1, bsz.height + templSize.height - 1);
+            int x0 = x - anchor.x + roiofs.x, y0 = y - anchor.y + roiofs.y;
+            int x1 = std::max(0, x0), y1 = std::max(0, y0);
+            int x2 = std::min(img0.cols, x0 + dsz.width);
+            int y2 = std::min(img0.rows, y0 + dsz.height);
+            Mat src0(img0, Range(y1, y2), Range(x1, x2));
+            bool fullBlock = bsz.height == blocksize.height;
+
+            // spectra of the image block planes
+            for( int k = 0; k < cn; k++ )
             {
-                src = depth == maxDepth ? dst1 : Mat(y2-y1, x2-x1, depth, &buf[0]);
-                int pairs[] = {k, 0};
-                mixChannels(&src0, 1, &src, 1, pairs, 1);
-            }
+                Mat spec(dftImg, Rect(0, k*dftsize.height, dftsize.width, dftsize.height));
+                Mat dst(spec, Rect(0, 0, dsz.width, dsz.height));
+                Mat dst1(spec, Rect(x1-x0, y1-y0, x2-x1, y2-y1));
+                spec = Scalar::all(0);
 
-            if( dst1.data != src.data )
-                src.convertTo(dst1, dst1.depth());
+                if( cn > 1 )
+                {
+                    extractChannel(src0, plane, k);
+                    plane.convertTo(dst1, maxDepth);
+                }
+                else
+                    src0.convertTo(dst1, maxDepth);
 
-            if( x2 - x1 < dsz.width || y2 - y1 < dsz.height )
-                copyMakeBorder(dst1, dst, y1-y0, dst.rows-dst1.rows-(y1-y0),
-                               x1-x0, dst.cols-dst1.cols-(x1-x0), borderType);
+                if( x2 - x1 < dsz.width || y2 - y1 < dsz.height )
+                    copyMakeBorder(dst1, dst, y1-y0, dst.rows-dst1.rows-(y1-y0),
+                                   x1-x0, dst.cols-dst1.cols-(x1-x0), borderType);
 
-            if (bsz.height == blocksize.height)
-                cF->apply(dftImg.data, (int)dftImg.step, dftImg.data, (int)dftImg.step);
-            else
-                dft( dftImg, dftImg, 0, dsz.height );
+                if( fullBlock )
+                    cF->apply(spec.data, (int)spec.step, spec.data, (int)spec.step);
+                else
+                    dft( spec, spec, 0, dsz.height );
+            }
 
-            Mat dftTempl1(dftTempl, Rect(0, tcn > 1 ? k*dftsize.height : 0,
-                                         dftsize.width, dftsize.height));
-            mulSpectrums(dftImg, dftTempl1, dftImg, 0, true);
+            for( int t = 0; t < ncorr; t++ )
+            {
+                Rect r = Rect(x, y, bsz.width, bsz.height) & Rect(Point(), corr[t].size());
+                if( r.empty() )
+                    continue;
+                Mat cdst(corr[t], r);
 
-            if (bsz.height == blocksize.height)
-                cR->apply(dftImg.data, (int)dftImg.step, dftImg.data, (int)dftImg.step);
-            else
-                dft( dftImg, dftImg, DFT_INVERSE + DFT_SCALE, bsz.height );
+                // the planes are either correlated separately or summed up in the frequency domain
+                for( int k = 0; k < cn; k++ )
+                {
+                    Mat spec(dftImg, Rect(0, k*dftsize.height, dftsize.width, dftsize.height));
+                    Mat tspec(spectra[t], Rect(0, tcn > 1 ? k*dftsize.height : 0, dftsize.width, dftsize.height));
+                    if( ccn == 1 && k > 0 )
+                    {
+                        mulSpectrums(spec, tspec, prod, 0, true);
+                        add(acc, prod, acc);
+                    }
+                    else
+                        mulSpectrums(spec, tspec, acc, 0, true);
 
-            src = dftImg(Rect(0, 0, bsz.width, bsz.height));
+                    if( ccn == 1 && k < cn - 1 )
+                        continue;
 
-            if( ccn > 1 )
-            {
-                if( cdepth != maxDepth )
-                {
-                    Mat plane(bsz, cdepth, &buf[0]);
-                    src.convertTo(plane, cdepth, 1, delta);
-                    src = plane;
-                }
-                int pairs[] = {0, k};
-                mixChannels(&src, 1, &cdst, 1, pairs, 1);
-            }
-            else
-            {
-                if( k == 0 )
-                    src.convertTo(cdst, cdepth, 1, delta);
-                else
-                {
-                    if( maxDepth != cdepth )
+                    if( fullBlock )
+                        cR->apply(acc.data, (int)acc.step, acc.data, (int)acc.step);
+                    else
+                        dft( acc, acc, DFT_INVERSE + DFT_SCALE, bsz.height );
+
+                    Mat src = acc(Rect(0, 0, r.width, r.height));
+                    if( ccn > 1 )
                     {
-                        Mat plane(bsz, cdepth, &buf[0]);
-                        src.convertTo(plane, cdepth);
-                        src = plane;
+                        if( cdepth != maxDepth )
+                        {
+                            src.convertTo(cplane, cdepth, 1, delta);
+                            src = cplane;
+                        }
+                        int pairs[] = {0, k};
+                        mixChannels(&src, 1, &cdst, 1, pairs, 1);
                     }
-                    add(src, cdst, cdst);
+                    else
+                        src.convertTo(cdst, cdepth, 1, delta);
                 }
             }
         }
     }
+
+private:
+    Mat img0;
+    const Mat* spectra;
+    Mat* corr;
+    int ncorr;
+    Size templSize, corrSize;
+    CrossCorrPlan plan;
+    Point anchor, roiofs;
+    double delta;
+    int borderType;
+    int tileCountX, tileCount;
+};
+
+void crossCorr( const Mat& img, const Mat& _templ, Mat& corr,
+                Point anchor, double delta, int borderType )
+{
+    Mat templ = _templ;
+    int depth = img.depth();
+    int tdepth = templ.depth();
+    int cdepth = corr.depth(), ccn = corr.channels();
+
+    CV_Assert( img.dims <= 2 && templ.dims <= 2 && corr.dims <= 2 );
+
+    if( depth != tdepth && tdepth != std::max(CV_32F, depth) )
+    {
+        _templ.convertTo(templ, std::max(CV_32F, depth));
+        tdepth = templ.depth();
+    }
+
+    CV_Assert( depth == tdepth || tdepth == CV_32F);
+    CV_Assert( corr.rows <= img.rows + templ.rows - 1 &&
+               corr.cols <= img.cols + templ.cols - 1 );
+
+    CV_Assert( ccn == 1 || delta == 0 );
+
+    int maxDepth = depth > CV_8S ? CV_64F : std::max(std::max(CV_32F, tdepth), cdepth);
+    CrossCorrPlan plan = makeCrossCorrPlan(corr.size(), templ.size(), maxDepth);
+
+    Mat dftTempl;
+    templateSpectrum(templ, plan, dftTempl);
+
+    CrossCorrInvoker body(img, &dftTempl, &corr, 1, templ.size(), corr.size(), plan, anchor, delta, borderType);
+    parallel_for_(Range(0, body.tiles()), body);
 }
 
 static void matchTemplateMask( InputArray _img, InputArray _templ, OutputArray _result, int method, InputArray _mask )
@@ -903,129 +955,341 @@ static void matchTemplateMask( InputArray _img, InputArray _templ, OutputArray _
     }
 }
 
-static void common_matchTemplate( Mat& img, Mat& templ, Mat& result, int method, int cn )
+/* normalization terms of a template */
+struct MatchTemplateNorm
 {
-    if( method == CV_TM_CCORR )
-        return;
+    Size size;
+    Scalar mean;
+    double norm, sum2, invArea;
+    bool constant;              /* the template is constant, TM_CCOEFF_NORMED gives 1 everywhere */
+};
 
+static void computeMatchTemplateNorm( const Mat& templ, int method, MatchTemplateNorm& tn )
+{
     int numType = method == CV_TM_CCORR || method == CV_TM_CCORR_NORMED ? 0 :
                   method == CV_TM_CCOEFF || method == CV_TM_CCOEFF_NORMED ? 1 : 2;
-    bool isNormed = method == CV_TM_CCORR_NORMED ||
-                    method == CV_TM_SQDIFF_NORMED ||
-                    method == CV_TM_CCOEFF_NORMED;
-
-    double invArea = 1./((double)templ.rows * templ.cols);
 
-    Mat sum, sqsum;
-    Scalar templMean, templSdv;
-    double *q0 = 0, *q1 = 0, *q2 = 0, *q3 = 0;
-    double templNorm = 0, templSum2 = 0;
+    tn.size = templ.size();
+    tn.invArea = 1./((double)templ.rows * templ.cols);
+    tn.norm = tn.sum2 = 0;
+    tn.constant = false;
 
     if( method == CV_TM_CCOEFF )
     {
-        integral(img, sum, CV_64F);
-        templMean = mean(templ);
+        tn.mean = mean(templ);
+        return;
     }
-    else
-    {
-        integral(img, sum, sqsum, CV_64F);
-        meanStdDev( templ, templMean, templSdv );
-
-        templNorm = templSdv[0]*templSdv[0] + templSdv[1]*templSdv[1] + templSdv[2]*templSdv[2] + templSdv[3]*templSdv[3];
 
-        if( templNorm < DBL_EPSILON && method == CV_TM_CCOEFF_NORMED )
-        {
-            result = Scalar::all(1);
-            return;
-        }
+    Scalar templMean, templSdv;
+    meanStdDev( templ, templMean, templSdv );
 
-        templSum2 = templNorm + templMean[0]*templMean[0] + templMean[1]*templMean[1] + templMean[2]*templMean[2] + templMean[3]*templMean[3];
+    double templNorm = templSdv[0]*templSdv[0] + templSdv[1]*templSdv[1] + templSdv[2]*templSdv[2] + templSdv[3]*templSdv[3];
 
-        if( numType != 1 )
-        {
-            templMean = Scalar::all(0);
-            templNorm = templSum2;
-        }
+    if( templNorm < DBL_EPSILON && method == CV_TM_CCOEFF_NORMED )
+    {
+        tn.constant = true;
+        return;
+    }
 
-        templSum2 /= invArea;
-        templNorm = std::sqrt(templNorm);
-        templNorm /= std::sqrt(invArea); // care of accuracy here
+    double templSum2 = templNorm + templMean[0]*templMean[0] + templMean[1]*templMean[1] + templMean[2]*templMean[2] + templMean[3]*templMean[3];
 
-        CV_Assert(sqsum.data != NULL);
-        q0 = (double*)sqsum.data;
-        q1 = q0 + templ.cols*cn;
-        q2 = (double*)(sqsum.data + templ.rows*sqsum.step);
-        q3 = q2 + templ.cols*cn;
+    if( numType != 1 )
+    {
+        templMean = Scalar::all(0);
+        templNorm = templSum2;
     }
 
-    CV_Assert(sum.data != NULL);
-    double* p0 = (double*)sum.data;
-    double* p1 = p0 + templ.cols*cn;
-    double* p2 = (double*)(sum.data + templ.rows*sum.step);
-    double* p3 = p2 + templ.cols*cn;
+    templSum2 /= tn.invArea;
+    templNorm = std::sqrt(templNorm);
+    templNorm /= std::sqrt(tn.invArea); // care of accuracy here
 
-    int sumstep = sum.data ? (int)(sum.step / sizeof(double)) : 0;
-    int sqstep = sqsum.data ? (int)(sqsum.step / sizeof(double)) : 0;
+    tn.mean = templMean;
+    tn.norm = templNorm;
+    tn.sum2 = templSum2;
+}
 
-    int i, j, k;
+class MatchTemplateNormInvoker : public ParallelLoopBody
+{
+public:
+    MatchTemplateNormInvoker( const Mat& _sum, const Mat& _sqsum, const MatchTemplateNorm& _tn,
+                              int _method, int _cn, Mat& _result )
+        : sum(_sum), sqsum(_sqsum), tn(_tn), method(_method), cn(_cn), result(_result) {}
 
-    for( i = 0; i < result.rows; i++ )
+    void operator()( const Range& range ) const CV_OVERRIDE
     {
-        float* rrow = result.ptr<float>(i);
-        int idx = i * sumstep;
-        int idx2 = i * sqstep;
+        int numType = method == CV_TM_CCORR || method == CV_TM_CCORR_NORMED ? 0 :
+                      method == CV_TM_CCOEFF || method == CV_TM_CCOEFF_NORMED ? 1 : 2;
+        bool isNormed = method == CV_TM_CCORR_NORMED ||
+                        method == CV_TM_SQDIFF_NORMED ||
+                        method == CV_TM_CCOEFF_NORMED;
+
+        const double invArea = tn.invArea, templNorm = tn.norm, templSum2 = tn.sum2;
+        const Scalar& templMean = tn.mean;
+        const double *q0 = 0, *q1 = 0, *q2 = 0, *q3 = 0;
+
+        if( method != CV_TM_CCOEFF )
+        {
+            CV_Assert(sqsum.data != NULL);
+            q0 = (const double*)sqsum.data;
+            q1 = q0 + tn.size.width*cn;
+            q2 = (const double*)(sqsum.data + tn.size.height*sqsum.step);
+            q3 = q2 + tn.size.width*cn;
+        }
+
+        CV_Assert(sum.data != NULL);
+        const double* p0 = (const double*)sum.data;
+        const double* p1 = p0 + tn.size.width*cn;
+        const double* p2 = (const double*)(sum.data + tn.size.height*sum.step);
+        const double* p3 = p2 + tn.size.width*cn;
+
+        int sumstep = sum.data ? (int)(sum.step / sizeof(double)) : 0;
+        int sqstep = sqsum.data ? (int)(sqsum.step / sizeof(double)) : 0;
 
-        for( j = 0; j < result.cols; j++, idx += cn, idx2 += cn )
+        int i, j, k;
+
+        for( i = range.start; i < range.end; i++ )
         {
-            double num = rrow[j], t;
-            double wndMean2 = 0, wndSum2 = 0;
+            float* rrow = result.ptr<float>(i);
+            int idx = i * sumstep;
+            int idx2 = i * sqstep;
 
-            if( numType == 1 )
+            for( j = 0; j < result.cols; j++, idx += cn, idx2 += cn )
             {
-                for( k = 0; k < cn; k++ )
+                double num = rrow[j], t;
+                double wndMean2 = 0, wndSum2 = 0;
+
+                if( numType == 1 )
                 {
-                    t = p0[idx+k] - p1[idx+k] - p2[idx+k] + p3[idx+k];
-                    wndMean2 += t*t;
-                    num -= t*templMean[k];
-                }
+                    for( k = 0; k < cn; k++ )
+                    {
+                        t = p0[idx+k] - p1[idx+k] - p2[idx+k] + p3[idx+k];
+                        wndMean2 += t*t;
+                        num -= t*templMean[k];
+                    }
 
-                wndMean2 *= invArea;
-            }
+                    wndMean2 *= invArea;
+                }
 
-            if( isNormed || numType == 2 )
-            {
-                for( k = 0; k < cn; k++ )
+                if( isNormed || numType == 2 )
                 {
-                    t = q0[idx2+k] - q1[idx2+k] - q2[idx2+k] + q3[idx2+k];
-                    wndSum2 += t;
+                    for( k = 0; k < cn; k++ )
+                    {
+                        t = q0[idx2+k] - q1[idx2+k] - q2[idx2+k] + q3[idx2+k];
+                        wndSum2 += t;
+                    }
+
+                    if( numType == 2 )
+                    {
+                        num = wndSum2 - 2*num + templSum2;
+                        num = MAX(num, 0.);
+                    }
                 }
 
-                if( numType == 2 )
+                if( isNormed )
                 {
-                    num = wndSum2 - 2*num + templSum2;
-                    num = MAX(num, 0.);
+                    double diff2 = MAX(wndSum2 - wndMean2, 0);
+                    if (diff2 <= std::min(0.5, 10 * FLT_EPSILON * wndSum2))
+                        t = 0; // avoid rounding errors
+                    else
+                        t = std::sqrt(diff2)*templNorm;
+
+                    if( fabs(num) < t )
+                        num /= t;
+                    else if( fabs(num) < t*1.125 )
+                        num = num > 0 ? 1 : -1;
+                    else
+                        num = method != CV_TM_SQDIFF_NORMED ? 0 : 1;
                 }
+
+                rrow[j] = (float)num;
             }
+        }
+    }
 
-            if( isNormed )
-            {
-                double diff2 = MAX(wndSum2 - wndMean2, 0);
-                if (diff2 <= std::min(0.5, 10 * FLT_EPSILON * wndSum2))
-                    t = 0; // avoid rounding errors
-                else
-                    t = std::sqrt(diff2)*templNorm;
+private:
+    MatchTemplateNormInvoker& operator=(const MatchTemplateNormInvoker&);
 
-                if( fabs(num) < t )
-                    num /= t;
-                else if( fabs(num) < t*1.125 )
-                    num = num > 0 ? 1 : -1;
-                else
-                    num = method != CV_TM_SQDIFF_NORMED ? 0 : 1;
+    const Mat& sum;
+    const Mat& sqsum;
+    const MatchTemplateNorm& tn;
+    int method, cn;
+    Mat& result;
+};
+
+/* sum and sqsum are the integrals of the image (sqsum is not needed for TM_CCOEFF) */
+static void normalizeMatchTemplate( const Mat& sum, const Mat& sqsum, const MatchTemplateNorm& tn,
+                                    int method, int cn, Mat& result )
+{
+    if( method == CV_TM_CCORR )
+        return;
+
+    if( tn.constant )
+    {
+        result = Scalar::all(1);
+        return;
+    }
+
+    parallel_for_(Range(0, result.rows), MatchTemplateNormInvoker(sum, sqsum, tn, method, cn, result),
+                  result.total()/(double)(1 << 16));
+}
+
+static void common_matchTemplate( Mat& img, Mat& templ, Mat& result, int method, int cn )
+{
+    if( method == CV_TM_CCORR )
+        return;
+
+    MatchTemplateNorm tn;
+    computeMatchTemplateNorm(templ, method, tn);
+
+    Mat sum, sqsum;
+    if( !tn.constant )
+    {
+        if( method == CV_TM_CCOEFF )
+            integral(img, sum, CV_64F);
+        else
+            integral(img, sum, sqsum, CV_64F);
+    }
+    normalizeMatchTemplate(sum, sqsum, tn, method, cn, result);
+}
+
+class TemplateMatcherImpl CV_FINAL : public TemplateMatcher
+{
+public:
+    TemplateMatcherImpl( InputArrayOfArrays _templs, int _method ) : method(_method)
+    {
+        CV_Assert( CV_TM_SQDIFF <= method && method <= CV_TM_CCOEFF_NORMED );
+
+        if( _templs.isMatVector() || _templs.isUMatVector() )
+            _templs.getMatVector(templs);
+        else
+            templs.push_back(_templs.getMat());
+        CV_Assert( !templs.empty() );
+
+        int type = templs[0].type(), depth = CV_MAT_DEPTH(type);
+        CV_Assert( depth == CV_8U || depth == CV_32F );
+
+        norms.resize(templs.size());
+        maxSize = minSize = templs[0].size();
+        for( size_t i = 0; i < templs.size(); i++ )
+        {
+            Mat& templ = templs[i];
+            CV_Assert( !templ.empty() && templ.dims <= 2 && templ.type() == type );
+            templ = templ.clone();
+            computeMatchTemplateNorm(templ, method, norms[i]);
+            maxSize = Size(std::max(maxSize.width, templ.cols), std::max(maxSize.height, templ.rows));
+            minSize = Size(std::min(minSize.width, templ.cols), std::min(minSize.height, templ.rows));
+        }
+    }
+
+    void match( InputArray _image, OutputArray _result, int index ) CV_OVERRIDE
+    {
+        CV_INSTRUMENT_REGION();
+
+        CV_Assert( 0 <= index && index < (int)templs.size() );
+        Mat image = _image.getMat();
+        checkImage(image);
+
+        _result.create(corrSize(image, index), CV_32F);
+        Mat result = _result.getMat();
+        run(image, &index, 1, &result);
+    }
+
+    void matchAll( InputArray _image, OutputArrayOfArrays _results ) CV_OVERRIDE
+    {
+        CV_INSTRUMENT_REGION();
+
+        Mat image = _image.getMat();
+        checkImage(image);
+
+        int i, n = (int)templs.size();
+        std::vector<int> index(n);
+        std::vector<Mat> results(n);
+        _results.create(n, 1, CV_32F, -1, true);
+        for( i = 0; i < n; i++ )
+        {
+            index[i] = i;
+            _results.create(corrSize(image, i), CV_32F, i, true);
+            results[i] = _results.getMat(i);
+        }
+        run(image, &index[0], n, &results[0]);
+    }
+
+    int getMethod() const CV_OVERRIDE { return method; }
+    int getTemplatesCount() const CV_OVERRIDE { return (int)templs.size(); }
+
+private:
+    void checkImage( const Mat& image ) const
+    {
+        CV_Assert( image.type() == templs[0].type() && image.dims <= 2 );
+        CV_Assert( image.cols >= maxSize.width && image.rows >= maxSize.height );
+    }
+
+    Size corrSize( const Mat& image, int i ) const
+    {
+        return Size(image.cols - templs[i].cols + 1, image.rows - templs[i].rows + 1);
+    }
+
+    void run( const Mat& image, const int* index, int n, Mat* results )
+    {
+        // the spectra depend on the image size only, they are computed once for all the frames of the same size
+        CrossCorrPlan plan;
+        std::vector<Mat> spectra(n);
+        {
+            AutoLock lock(mutex);
+            if( cachedSize != image.size() )
+            {
+                int maxDepth = image.depth() > CV_8S ? CV_64F : CV_32F;
+                Size maxCorrSize(image.cols - minSize.width + 1, image.rows - minSize.height + 1);
+                cachedPlan = makeCrossCorrPlan(maxCorrSize, maxSize, maxDepth);
+                cachedSpectra.resize(templs.size());
+                for( size_t i = 0; i < templs.size(); i++ )
+                {
+                    cachedSpectra[i] = Mat();
+                    templateSpectrum(templs[i], cachedPlan, cachedSpectra[i]);
+                }
+                cachedSize = image.size();
             }
+            plan = cachedPlan;
+            for( int i = 0; i < n; i++ )
+                spectra[i] = cachedSpectra[index[i]];
+        }
 
-            rrow[j] = (float)num;
+        Size size;
+        bool needSum = false, needSqsum = false;
+        for( int i = 0; i < n; i++ )
+        {
+            size = Size(std::max(size.width, results[i].cols), std::max(size.height, results[i].rows));
+            needSum |= method != CV_TM_CCORR && !norms[index[i]].constant;
+            needSqsum |= method != CV_TM_CCORR && method != CV_TM_CCOEFF && !norms[index[i]].constant;
         }
+
+        CrossCorrInvoker body(image, &spectra[0], results, n, maxSize, size, plan, Point(), 0, 0);
+        parallel_for_(Range(0, body.tiles()), body);
+
+        // the integrals of the image are shared by all the templates
+        Mat sum, sqsum;
+        if( needSqsum )
+            integral(image, sum, sqsum, CV_64F);
+        else if( needSum )
+            integral(image, sum, CV_64F);
+        for( int i = 0; i < n; i++ )
+            normalizeMatchTemplate(sum, sqsum, norms[index[i]], method, image.channels(), results[i]);
     }
+
+    std::vector<Mat> templs;
+    std::vector<MatchTemplateNorm> norms;
+    int method;
+    Size maxSize, minSize;
+
+    Mutex mutex;
+    Size cachedSize;
+    CrossCorrPlan cachedPlan;
+    std::vector<Mat> cachedSpectra;
+};
+
+Ptr<TemplateMatcher> createTemplateMatcher( InputArrayOfArrays templs, int method )
+{
+    return makePtr<TemplateMatcherImpl>(templs, method);
 }
 }
 
@@ -534,6 +534,69 @@ TEST(Imgproc_FindContours, regression_4363_shared_nbd)
     }
 }
 
+static void checkParallelFindContours(const Mat& img)
+{
+    const int nthreads = cv::getNumThreads();
+    for (int mode = RETR_EXTERNAL; mode <= RETR_TREE; mode++)
+    {
+        for (int method = CHAIN_APPROX_NONE; method <= CHAIN_APPROX_TC89_KCOS; method++)
+        {
+            SCOPED_TRACE(cv::format("mode=%d method=%d", mode, method));
+            vector<vector<Point> > contours0, contours1;
+            vector<Vec4i> hierarchy0, hierarchy1;
+            cv::setNumThreads(1);
+            findContours(img, contours0, hierarchy0, mode, method, Point(3, -2));
+            cv::setNumThreads(4);
+            findContours(img, contours1, hierarchy1, mode, method, Point(3, -2));
+            cv::setNumThreads(nthreads);
+
+            ASSERT_EQ(contours0.size(), contours1.size());
+            ASSERT_TRUE(hierarchy0 == hierarchy1);
+            for (size_t i = 0; i < contours0.size(); i++)
+                ASSERT_TRUE(contours0[i] == contours1[i]) << "contour " << i;
+        }
+    }
+}
+
+TEST(Imgproc_FindContours, parallel_blobs)
+{
+    RNG& rng = theRNG();
+    Mat img = Mat::zeros(1100, 1000, CV_8UC1);
+    for (int i = 0; i < 400; i++)
+    {
+        Point center(rng.uniform(0, img.cols), rng.uniform(0, img.rows));
+        Size axes(rng.uniform(1, i < 40 ? 250 : 40), rng.uniform(1, i < 40 ? 250 : 40));
+        ellipse(img, center, axes, rng.uniform(0, 180), 0., 360., Scalar::all(i % 2 ? 0 : 255), i % 3 ? -1 : 3);
+    }
+    checkParallelFindContours(img);
+}
+
+TEST(Imgproc_FindContours, parallel_nested)
+{
+    RNG& rng = theRNG();
+    Mat img = Mat::zeros(1200, 1000, CV_8UC1);
+    for (int r = 590; r > 0; r -= 30)
+        circle(img, Point(500, 600), r, Scalar::all(r % 60 ? 0 : 255), -1);
+    // thin walls, diagonal connections and small components all over the bands
+    for (int i = 0; i < 3000; i++)
+        img.at<uchar>(rng.uniform(0, img.rows), rng.uniform(0, img.cols)) ^= 255;
+    for (int y = 100; y < 1100; y += 97)
+        line(img, Point(0, y), Point(img.cols - 1, y + 50), Scalar::all(128), 1);
+    rectangle(img, Rect(20, 5, 30, 1190), Scalar::all(255), 1);
+    checkParallelFindContours(img);
+}
+
+TEST(Imgproc_FindContours, parallel_noise)
+{
+    Mat noise(1100, 250, CV_8UC1), img = Mat::zeros(1100, 1000, CV_8UC1);
+    cvtest::randUni(theRNG(), noise, Scalar::all(0), Scalar::all(256));
+    cv::threshold(noise, img.colRange(500, 750), 140, 255, THRESH_BINARY);
+    // leave a few empty stripes, so some of the cuts are free of crossing components
+    img.rowRange(250, 300).setTo(Scalar::all(0));
+    img.rowRange(700, 701).setTo(Scalar::all(0));
+    checkParallelFindContours(img);
+}
+
 TEST(Imgproc_PointPolygonTest, regression_10222)
 {
     vector<Point> contour;
@@ -680,4 +680,96 @@ TEST(Drawing, fillpoly_circle)
     EXPECT_LT(diff_fp3, 1.);
 }
 
+// draws the same random primitives with DrawingBatch and with the individual functions
+static void drawRandomPrimitives(RNG& rng, Size sz, int n, DrawingBatch& batch, Mat& ref)
+{
+    static const int lineTypes[] = { LINE_4, LINE_8, LINE_AA };
+    for (int i = 0; i < n; i++)
+    {
+        int kind = rng.uniform(0, 4);
+        Scalar color(rng.uniform(0, 256), rng.uniform(0, 256), rng.uniform(0, 256), rng.uniform(0, 256));
+        int lineType = lineTypes[rng.uniform(0, 3)];
+        int shift = rng.uniform(0, 3);
+        int thickness = rng.uniform(1, 6);
+        Point pt1(rng.uniform(-20, sz.width + 20) << shift, rng.uniform(-20, sz.height + 20) << shift);
+        Point pt2 = pt1 + Point(rng.uniform(-200, 200), rng.uniform(-200, 200));
+        if (kind == 0)
+        {
+            batch.line(pt1, pt2, color, thickness, lineType, shift);
+            cv::line(ref, pt1, pt2, color, thickness, lineType, shift);
+        }
+        else if (kind == 1)
+        {
+            Rect r(pt1, Size(rng.uniform(1, 150), rng.uniform(1, 150)));
+            if (rng.uniform(0, 4) == 0)
+                thickness = FILLED;
+            batch.rectangle(r, color, thickness, lineType, shift);
+            cv::rectangle(ref, r, color, thickness, lineType, shift);
+        }
+        else if (kind == 2)
+        {
+            int radius = rng.uniform(0, 80 << shift);
+            if (rng.uniform(0, 4) == 0)
+                thickness = FILLED;
+            else if (rng.uniform(0, 2) == 0)
+                shift = 0, lineType = LINE_8, thickness = 1;
+            batch.circle(pt1, radius, color, thickness, lineType, shift);
+            cv::circle(ref, pt1, radius, color, thickness, lineType, shift);
+        }
+        else
+        {
+            Point org(pt1.x >> shift, pt1.y >> shift);
+            String text = cv::format("label %d", i);
+            double scale = rng.uniform(0.3, 2.);
+            bool flip = rng.uniform(0, 8) == 0;
+            batch.putText(text, org, FONT_HERSHEY_SIMPLEX, scale, color, thickness, lineType, flip);
+            cv::putText(ref, text, org, FONT_HERSHEY_SIMPLEX, scale, color, thickness, lineType, flip);
+        }
+    }
+}
+
+typedef testing::TestWithParam<MatType> Drawing_Batch;
+
+TEST_P(Drawing_Batch, same_as_sequential)
+{
+    const int type = GetParam();
+    RNG& rng = theRNG();
+    Size sz(640, 480);
+    Mat ref(sz, type), dst;
+    randu(ref, 0, 256);
+    ref.copyTo(dst);
+
+    DrawingBatch batch;
+    drawRandomPrimitives(rng, sz, 300, batch, ref);
+    EXPECT_EQ(300u, batch.size());
+
+    // the bands are used with more than one thread
+    int nthreads = getNumThreads();
+    setNumThreads(std::max(nthreads, 4));
+    batch.draw(dst);
+    setNumThreads(nthreads);
+    EXPECT_EQ(0, cvtest::norm(ref, dst, NORM_INF));
+
+    batch.clear();
+    EXPECT_EQ(0u, batch.size());
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Drawing_Batch, testing::Values(CV_8UC1, CV_8UC3, CV_8UC4, CV_32FC3));
+
+TEST(Drawing, fill_span_3_4_channels)
+{
+    for (int cn = 3; cn <= 4; cn++)
+    {
+        Mat img(20, 200, CV_8UC(cn), Scalar::all(0)), ref = img.clone();
+        Scalar color(10, 20, 30, 40);
+        for (int w = 1; w < 150; w += 7)
+        {
+            Rect r(3 + w % 11, 5, w, 10);
+            cv::rectangle(img, r, color, FILLED);
+            ref(r).setTo(color);
+            ASSERT_EQ(0, cvtest::norm(img, ref, NORM_INF)) << "cn=" << cn << " width=" << w;
+        }
+    }
+}
+
 }} // namespace
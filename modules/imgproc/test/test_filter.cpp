@@ -2356,4 +2356,117 @@ TEST(Imgproc, filter_empty_src_16857)
 }
 
 
+static Mat makeSepFilterTestKernel(RNG& rng, int ksize, int symmetry, int denom)
+{
+    // integer numerators divided by denom, so the kernels are exact in the fixed point paths
+    Mat_<float> kernel(ksize, 1);
+    int center = ksize/2, sum = 0;
+    for (int i = 1; i <= center; i++)
+    {
+        int v = rng.uniform(1, 8);
+        kernel(center - i) = (float)(symmetry == 0 ? v : -v)/denom;
+        kernel(center + i) = (float)v/denom;
+        sum += 2*v;
+    }
+    kernel(center) = symmetry == 0 ? (float)(denom - sum)/denom : 0.f;
+    return kernel;
+}
+
+static Mat sepFilterReference(const Mat& src, int ddepth, const Mat& kernelX, const Mat& kernelY)
+{
+    int kx = kernelX.rows, ky = kernelY.rows, cn = src.channels();
+    Mat src64f, border;
+    src.convertTo(src64f, CV_64F);
+    cv::copyMakeBorder(src64f, border, ky/2, ky/2, kx/2, kx/2, BORDER_REFLECT_101);
+    Mat kX, kY;
+    kernelX.convertTo(kX, CV_64F);
+    kernelY.convertTo(kY, CV_64F);
+    Mat dst(src.size(), CV_64FC(cn));
+    for (int y = 0; y < src.rows; y++)
+        for (int x = 0; x < src.cols*cn; x++)
+        {
+            double s = 0;
+            for (int i = 0; i < ky; i++)
+            {
+                const double* row = border.ptr<double>(y + i) + x;
+                double r = 0;
+                for (int j = 0; j < kx; j++)
+                    r += kX.at<double>(j)*row[j*cn];
+                s += kY.at<double>(i)*r;
+            }
+            dst.ptr<double>(y)[x] = s;
+        }
+    Mat result;
+    dst.convertTo(result, CV_MAKETYPE(ddepth, cn));
+    return result;
+}
+
+typedef testing::TestWithParam<tuple<int, int> > Imgproc_SepFilter2D_KernelSize;
+
+TEST_P(Imgproc_SepFilter2D_KernelSize, accuracy)
+{
+    const int ksize = get<0>(GetParam());
+    const int cn = get<1>(GetParam());
+    RNG& rng = theRNG();
+    // wide enough to be processed in several vertical strips
+    const Size sz(1100, 37);
+
+    Mat src8u(sz, CV_8UC(cn)), src32f(sz, CV_32FC(cn));
+    randu(src8u, 0, 256);
+    randu(src32f, -1.f, 1.f);
+
+    for (int symmetry = 0; symmetry < 2; symmetry++)
+    {
+        SCOPED_TRACE(symmetry == 0 ? "symmetric" : "asymmetric");
+        Mat kernelX = makeSepFilterTestKernel(rng, ksize, symmetry, 1);
+        Mat kernelY = makeSepFilterTestKernel(rng, ksize, 0, 1);
+        Mat dst;
+
+        // integer kernels: 8U -> 32S rows, 32S -> 16S columns
+        cv::sepFilter2D(src8u, dst, CV_16S, kernelX, kernelY);
+        EXPECT_EQ(0, cvtest::norm(dst, sepFilterReference(src8u, CV_16S, kernelX, kernelY), NORM_INF));
+
+        cv::sepFilter2D(src32f, dst, CV_32F, kernelX, kernelY);
+        Mat ref = sepFilterReference(src32f, CV_32F, kernelX, kernelY);
+        EXPECT_LE(cvtest::norm(dst, ref, NORM_INF), 1e-3);
+
+        // in-place filtering is not split into strips
+        Mat inplace = src32f.clone();
+        cv::sepFilter2D(inplace, inplace, CV_32F, kernelX, kernelY);
+        EXPECT_LE(cvtest::norm(inplace, dst, NORM_INF), 1e-4);
+    }
+
+    // smoothing kernels in 1/256 units: 8U -> 32S rows, 32S -> 8U columns
+    Mat kernelX = makeSepFilterTestKernel(rng, ksize, 0, 256);
+    Mat kernelY = makeSepFilterTestKernel(rng, ksize, 0, 256);
+    Mat dst;
+    cv::sepFilter2D(src8u, dst, CV_8U, kernelX, kernelY);
+    EXPECT_LE(cvtest::norm(dst, sepFilterReference(src8u, CV_8U, kernelX, kernelY), NORM_INF), 1);
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Imgproc_SepFilter2D_KernelSize, testing::Combine(
+                            testing::Values(3, 5, 7, 9, 11),
+                            testing::Values(1, 3)));
+
+TEST(Imgproc_Sobel, strips_large_ksize)
+{
+    Mat src(300, 2000, CV_8UC1);
+    randu(src, 0, 256);
+    for (int ksize = 5; ksize <= 7; ksize += 2)
+    {
+        Mat dst, ref, kx, ky;
+        cv::Sobel(src, dst, CV_16S, 1, 0, ksize);
+        getDerivKernels(kx, ky, 1, 0, ksize, false, CV_32F);
+        ref = sepFilterReference(src, CV_16S, kx, ky);
+        EXPECT_EQ(0, cvtest::norm(dst, ref, NORM_INF)) << "ksize=" << ksize;
+
+        Mat roiDst;
+        cv::Sobel(src(Rect(100, 20, 1700, 250)), roiDst, CV_16S, 1, 0, ksize);
+        // interior pixels use real neighbors of the ROI, compare them with the full image result
+        EXPECT_EQ(0, cvtest::norm(roiDst(Rect(ksize, ksize, 1700 - 2*ksize, 250 - 2*ksize)),
+                                  ref(Rect(100 + ksize, 20 + ksize, 1700 - 2*ksize, 250 - 2*ksize)), NORM_INF));
+    }
+}
+
+
 }} // namespace
@@ -541,5 +541,115 @@ TEST(Imgproc_FloodFill, maskValue)
     ASSERT_EQ(1, cvtest::norm(mask.rowRange(1, n-1).colRange(1, n-1), NORM_INF));
 }
 
+static Mat makeFloodFillTestImage(Size size, int type, RNG& rng)
+{
+    // blobs of a few values, so that the components are large and winding
+    Mat noise(size.height / 8 + 1, size.width / 8 + 1, CV_32F), img8u;
+    rng.fill(noise, RNG::UNIFORM, 0, 4);
+    resize(noise, noise, size, 0, 0, INTER_CUBIC);
+    noise.convertTo(img8u, CV_8U);
+    Mat img;
+    img8u.convertTo(img, CV_MAKETYPE(CV_MAT_DEPTH(type), 1), 10);
+    if (CV_MAT_CN(type) == 3)
+        cvtColor(img, img, COLOR_GRAY2BGR);
+    return img;
+}
+
+TEST(Imgproc_FloodFill, multipleSeeds)
+{
+    RNG& rng = TS::ptr()->get_rng();
+    const Size size(320, 240);
+    for (int iter = 0; iter < 12; iter++)
+    {
+        int type = iter % 2 ? CV_8UC3 : CV_32FC1;
+        int mode = (iter / 2) % 3; // simple, fixed range, floating range
+        bool useMask = iter >= 6;
+        int flags = (iter % 4 < 2 ? 4 : 8) | (mode == 1 ? FLOODFILL_FIXED_RANGE : 0) | (3 << 8);
+        Scalar diff = mode == 0 ? Scalar() : Scalar::all(10);
+
+        Mat img = makeFloodFillTestImage(size, type, rng);
+        Mat mask = useMask ? Mat::zeros(size.height + 2, size.width + 2, CV_8U) : Mat();
+        std::vector<Point> seeds;
+        std::vector<Scalar> vals;
+        for (int i = 0; i < 100; i++)
+        {
+            seeds.push_back(Point(rng.uniform(0, size.width), rng.uniform(0, size.height)));
+            vals.push_back(Scalar::all(rng.uniform(0, 50) * 5 + 1));
+        }
+
+        Mat img1 = img.clone(), mask1 = mask.clone();
+        std::vector<int> areas1;
+        std::vector<Rect> rects1;
+        int total1 = 0;
+        for (size_t i = 0; i < seeds.size(); i++)
+        {
+            Rect rect;
+            int area = useMask ? floodFill(img1, mask1, seeds[i], vals[i], &rect, diff, diff, flags)
+                               : floodFill(img1, seeds[i], vals[i], &rect, diff, diff, flags);
+            areas1.push_back(area);
+            rects1.push_back(rect);
+            total1 += area;
+        }
+
+        std::vector<int> areas;
+        std::vector<Rect> rects;
+        int total = floodFill(img, mask, seeds, vals, areas, rects, diff, diff, flags);
+
+        EXPECT_EQ(total1, total) << "iter " << iter;
+        EXPECT_EQ(areas1, areas) << "iter " << iter;
+        EXPECT_EQ(rects1, rects) << "iter " << iter;
+        EXPECT_EQ(0, cvtest::norm(img1, img, NORM_INF)) << "iter " << iter;
+        if (useMask)
+        {
+            EXPECT_EQ(0, cvtest::norm(mask1, mask, NORM_INF)) << "iter " << iter;
+        }
+    }
+}
+
+TEST(Imgproc_FloodFill, parallel)
+{
+    RNG& rng = TS::ptr()->get_rng();
+    const Size size(1000, 700);
+    const int types[] = { CV_8UC1, CV_8UC3, CV_32SC1, CV_32FC3 };
+    for (int iter = 0; iter < 16; iter++)
+    {
+        int type = types[iter % 4];
+        bool fixedRange = (iter / 4) % 2 != 0;
+        int flags = (iter / 8 ? 8 : 4) | (fixedRange ? FLOODFILL_FIXED_RANGE | (7 << 8) : 0);
+        Scalar diff = fixedRange ? Scalar::all(10) : Scalar();
+
+        Mat img = makeFloodFillTestImage(size, type, rng);
+        // nested rings with alternating gaps make the component wind across the bands back and forth
+        rectangle(img, Rect(180, 30, 640, 640), Scalar::all(0), FILLED);
+        for (int r = 20, k = 0; r <= 300; r += 40, k++)
+        {
+            rectangle(img, Rect(500 - r, 350 - r, 2*r, 2*r), Scalar::all(255), 3);
+            rectangle(img, Rect(k % 2 ? 500 - r - 3 : 500 + r - 3, 345, 7, 10), Scalar::all(0), FILLED);
+        }
+        Point seed(500, 350);
+
+        Mat img1 = img.clone();
+        Mat mask, mask1;
+        if (fixedRange)
+        {
+            mask = Mat::zeros(size.height + 2, size.width + 2, CV_8U);
+            line(mask, Point(0, 300), Point(size.width + 1, 320), Scalar(1), 2);
+            mask1 = mask.clone();
+        }
+
+        Rect rect, rect1;
+        int area1 = floodFill(img1, mask1, seed, Scalar::all(77), &rect1, diff, diff, flags);
+        int area = floodFill(img, mask, seed, Scalar::all(77), &rect, diff, diff, flags | FLOODFILL_PARALLEL);
+
+        EXPECT_GT(area1, 1000) << "iter " << iter;
+        EXPECT_EQ(area1, area) << "iter " << iter;
+        EXPECT_EQ(rect1, rect) << "iter " << iter;
+        EXPECT_EQ(0, cvtest::norm(img1, img, NORM_INF)) << "iter " << iter;
+        if (fixedRange)
+        {
+            EXPECT_EQ(0, cvtest::norm(mask1, mask, NORM_INF)) << "iter " << iter;
+        }
+    }
+}
+
 }} // namespace
-/* End of file. */
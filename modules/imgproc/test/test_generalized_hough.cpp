@@ -0,0 +1,102 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+#include "test_precomp.hpp"
+
+namespace opencv_test { namespace {
+
+static void makeGeneralizedHoughInput(Mat& templ, Mat& image, std::vector<Point>& centers)
+{
+    templ = Mat::zeros(48, 48, CV_8UC1);
+    const Point poly[] = { Point(6, 6), Point(40, 10), Point(30, 24), Point(42, 40), Point(8, 36) };
+    fillConvexPoly(templ, poly, 3, Scalar::all(255));
+    fillConvexPoly(templ, poly + 2, 3, Scalar::all(255));
+    fillConvexPoly(templ, std::vector<Point>{ poly[0], poly[2], poly[4] }, Scalar::all(255));
+
+    image = Mat::zeros(240, 320, CV_8UC1);
+    centers.clear();
+    centers.push_back(Point(70, 60));
+    centers.push_back(Point(230, 170));
+    for (size_t i = 0; i < centers.size(); i++)
+        templ.copyTo(image(Rect(centers[i].x - templ.cols/2, centers[i].y - templ.rows/2, templ.cols, templ.rows)));
+}
+
+static void detectWithThreads(const Ptr<GeneralizedHough>& alg, const Mat& image, int nthreads,
+                              std::vector<Vec4f>& positions, std::vector<Vec3i>& votes)
+{
+    const int prevThreads = getNumThreads();
+    setNumThreads(nthreads);
+    alg->detect(image, positions, votes);
+    setNumThreads(prevThreads);
+}
+
+TEST(Imgproc_GeneralizedHoughBallard, regression)
+{
+    Mat templ, image;
+    std::vector<Point> centers;
+    makeGeneralizedHoughInput(templ, image, centers);
+
+    Ptr<GeneralizedHoughBallard> alg = createGeneralizedHoughBallard();
+    alg->setVotesThreshold(40);
+    alg->setMinDist(30);
+    alg->setTemplate(templ);
+
+    std::vector<Vec4f> positions, positions1;
+    std::vector<Vec3i> votes, votes1;
+    detectWithThreads(alg, image, 4, positions, votes);
+    detectWithThreads(alg, image, 1, positions1, votes1);
+
+    // the partial accumulators sum up to the same votes
+    ASSERT_EQ(positions1.size(), positions.size());
+    for (size_t i = 0; i < positions.size(); i++)
+    {
+        EXPECT_EQ(positions1[i], positions[i]);
+        EXPECT_EQ(votes1[i], votes[i]);
+    }
+
+    for (size_t i = 0; i < centers.size(); i++)
+    {
+        bool found = false;
+        for (size_t j = 0; j < positions.size(); j++)
+            found = found || (std::abs(positions[j][0] - centers[i].x) <= 2 && std::abs(positions[j][1] - centers[i].y) <= 2);
+        EXPECT_TRUE(found) << centers[i];
+    }
+}
+
+TEST(Imgproc_GeneralizedHoughGuil, parallel)
+{
+    Mat templ, image;
+    std::vector<Point> centers;
+    makeGeneralizedHoughInput(templ, image, centers);
+
+    Ptr<GeneralizedHoughGuil> alg = createGeneralizedHoughGuil();
+    alg->setMinDist(30);
+    alg->setLevels(360);
+    alg->setDp(2);
+    alg->setMaxBufferSize(100);
+    alg->setMinAngle(0);
+    alg->setMaxAngle(360);
+    alg->setAngleStep(1);
+    alg->setAngleThresh(300);
+    alg->setMinScale(0.9);
+    alg->setMaxScale(1.1);
+    alg->setScaleStep(0.05);
+    alg->setScaleThresh(100);
+    alg->setPosThresh(10);
+    alg->setTemplate(templ);
+
+    std::vector<Vec4f> positions, positions1;
+    std::vector<Vec3i> votes, votes1;
+    detectWithThreads(alg, image, 4, positions, votes);
+    detectWithThreads(alg, image, 1, positions1, votes1);
+
+    ASSERT_FALSE(positions.empty());
+    ASSERT_EQ(positions1.size(), positions.size());
+    for (size_t i = 0; i < positions.size(); i++)
+    {
+        EXPECT_EQ(positions1[i], positions[i]);
+        EXPECT_EQ(votes1[i], votes[i]);
+    }
+}
+
+}} // namespace
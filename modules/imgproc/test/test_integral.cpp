@@ -0,0 +1,200 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "test_precomp.hpp"
+
+namespace opencv_test { namespace {
+
+// sum of the pixels in the upward triangle with the apex (ax, ay), the region of tilted(ax + 1, ay + 1)
+static Scalar tiltedTriangleSum(const Mat& img, int ax, int ay)
+{
+    Scalar s;
+    for (int y = 0; y <= ay; y++)
+        for (int x = std::max(ax - (ay - y), 0); x <= std::min(ax + (ay - y), img.cols - 1); x++)
+            for (int k = 0; k < img.channels(); k++)
+                s[k] += img.depth() == CV_8U ? img.ptr<uchar>(y)[x*img.channels() + k]
+                                             : img.ptr<float>(y)[x*img.channels() + k];
+    return s;
+}
+
+static Scalar tiltedValue(const Mat& tilted, int X, int Y)
+{
+    Scalar s;
+    for (int k = 0; k < tilted.channels(); k++)
+        s[k] = tilted.depth() == CV_32S ? tilted.ptr<int>(Y)[X*tilted.channels() + k]
+                                        : tilted.ptr<double>(Y)[X*tilted.channels() + k];
+    return s;
+}
+
+// checks the sums over rotated rectangles with the bottom apex (bx, by), which don't depend on the
+// rows above the top apex
+static void checkRotatedRects(const Ptr<IntegralImage>& ii, const Mat& img, RNG& rng)
+{
+    Mat tilted;
+    ii->getTilted(tilted);
+    int firstRow = (int)ii->getFirstRow(), rows = (int)ii->getRows();
+    for (int iter = 0; iter < 20; iter++)
+    {
+        int w = rng.uniform(0, 5), h = rng.uniform(0, 5);
+        if (w + h >= rows - firstRow)
+            continue;
+        int by = rng.uniform(firstRow + w + h, rows);
+        int bx = rng.uniform(w, img.cols - h);
+        int ax[] = { bx, bx - w, bx + h, bx - w + h }, ay[] = { by, by - w, by - h, by - w - h };
+        double sign[] = { 1, -1, -1, 1 };
+        Scalar expected, actual;
+        for (int i = 0; i < 4; i++)
+        {
+            expected += tiltedTriangleSum(img, ax[i], ay[i])*sign[i];
+            actual += tiltedValue(tilted, ax[i] + 1, ay[i] + 1 - firstRow)*sign[i];
+        }
+        ASSERT_LE(cv::norm(actual - expected, NORM_INF), 1e-9*(cv::norm(expected, NORM_INF) + 1))
+            << "bottom=(" << bx << ", " << by << ") w=" << w << " h=" << h << " first row=" << firstRow;
+    }
+}
+
+typedef testing::TestWithParam<MatType> Imgproc_IntegralImage;
+
+TEST_P(Imgproc_IntegralImage, update)
+{
+    const int type = GetParam();
+    const int sdepth = CV_MAT_DEPTH(type) == CV_8U ? CV_32S : CV_64F;
+    RNG& rng = theRNG();
+    Mat img(97, 131, type);
+    randu(img, 0, 256);
+
+    Ptr<IntegralImage> ii = createIntegralImage(INTEGRAL_SQSUM | INTEGRAL_TILTED, sdepth, CV_64F);
+    ii->compute(img);
+    for (int iter = 0; iter < 20; iter++)
+    {
+        Rect roi(rng.uniform(0, img.cols), rng.uniform(0, img.rows), rng.uniform(1, 40), rng.uniform(1, 40));
+        SCOPED_TRACE(cv::format("iter=%d roi=(%d, %d, %d, %d)", iter, roi.x, roi.y, roi.width, roi.height));
+        Mat patch = img(roi & Rect(0, 0, img.cols, img.rows));
+        randu(patch, 0, 256);
+        ii->update(img, roi);
+
+        Mat sum, sqsum, tilted, refSum, refSqsum, refTilted;
+        cv::integral(img, refSum, refSqsum, refTilted, sdepth, CV_64F);
+        ii->getSum(sum);
+        ii->getSqsum(sqsum);
+        ii->getTilted(tilted);
+        ASSERT_LE(cvtest::norm(sum, refSum, NORM_INF | NORM_RELATIVE), 1e-12);
+        ASSERT_LE(cvtest::norm(sqsum, refSqsum, NORM_INF | NORM_RELATIVE), 1e-12);
+        ASSERT_LE(cvtest::norm(tilted, refTilted, NORM_INF | NORM_RELATIVE), 1e-12);
+    }
+    Scalar expected = cv::sum(img(Rect(10, 20, 30, 40)));
+    EXPECT_LE(cv::norm(ii->sum(Rect(10, 20, 30, 40)) - expected, NORM_INF), 1e-9*cv::norm(expected, NORM_INF));
+}
+
+TEST_P(Imgproc_IntegralImage, append)
+{
+    const int type = GetParam();
+    RNG& rng = theRNG();
+    Mat img(150, 37, type);
+    randu(img, 0, 256);
+
+    Ptr<IntegralImage> ii = createIntegralImage(INTEGRAL_SQSUM | INTEGRAL_TILTED);
+    for (int y = 0; y < img.rows; )
+    {
+        int n = std::min(rng.uniform(1, 20), img.rows - y);
+        ii->append(img.rowRange(y, y + n));
+        y += n;
+    }
+    ASSERT_EQ(img.rows, ii->getRows());
+    ASSERT_EQ(0, ii->getFirstRow());
+
+    Mat sum, sqsum, tilted, refSum, refSqsum, refTilted;
+    cv::integral(img, refSum, refSqsum, refTilted);
+    ii->getSum(sum);
+    ii->getSqsum(sqsum);
+    ii->getTilted(tilted);
+    EXPECT_LE(cvtest::norm(sum, refSum, NORM_INF | NORM_RELATIVE), 1e-12);
+    EXPECT_LE(cvtest::norm(sqsum, refSqsum, NORM_INF | NORM_RELATIVE), 1e-12);
+    EXPECT_LE(cvtest::norm(tilted, refTilted, NORM_INF | NORM_RELATIVE), 1e-12);
+}
+
+TEST_P(Imgproc_IntegralImage, rolling)
+{
+    const int type = GetParam();
+    const int window = 16;
+    RNG& rng = theRNG();
+    Mat img(200, 41, type);
+    randu(img, 0, 256);
+
+    Ptr<IntegralImage> ii = createIntegralImage(INTEGRAL_SQSUM | INTEGRAL_TILTED, -1, -1, window);
+    for (int y = 0; y < img.rows; )
+    {
+        int n = std::min(rng.uniform(1, 2*window), img.rows - y);
+        ii->append(img.rowRange(y, y + n));
+        y += n;
+        SCOPED_TRACE(cv::format("rows=%d", y));
+        ASSERT_EQ(y, ii->getRows());
+        int firstRow = (int)ii->getFirstRow();
+        ASSERT_EQ(std::max(y - window, 0), firstRow);
+
+        Mat sum;
+        ii->getSum(sum);
+        ASSERT_EQ(Size(img.cols + 1, y - firstRow + 1), sum.size());
+
+        for (int iter = 0; iter < 10; iter++)
+        {
+            int y0 = rng.uniform(firstRow, y), y1 = rng.uniform(y0, y + 1);
+            int x0 = rng.uniform(0, img.cols), x1 = rng.uniform(x0, img.cols + 1);
+            Rect r(x0, y0, x1 - x0, y1 - y0);
+            Mat m = img(r), m64;
+            m.convertTo(m64, CV_64F);
+            Scalar s = cv::sum(m64), sq = cv::sum(m64.mul(m64));
+            // the rows of the rectangle are counted from the first kept row
+            r.y -= firstRow;
+            ASSERT_LE(cv::norm(ii->sum(r) - s, NORM_INF), 1e-9*(cv::norm(s, NORM_INF) + 1));
+            ASSERT_LE(cv::norm(ii->sqsum(r) - sq, NORM_INF), 1e-9*(cv::norm(sq, NORM_INF) + 1));
+        }
+        checkRotatedRects(ii, img.rowRange(0, y), rng);
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Imgproc_IntegralImage, testing::Values(CV_8UC1, CV_8UC3, CV_32FC1));
+
+TEST(Imgproc_IntegralImage_Rolling, noUpdate)
+{
+    Ptr<IntegralImage> ii = createIntegralImage(0, -1, -1, 8);
+    Mat img(10, 10, CV_8UC1, Scalar::all(1));
+    ii->compute(img);
+    EXPECT_THROW(ii->update(img, Rect(0, 0, 2, 2)), cv::Exception);
+    EXPECT_EQ(8, ii->getRows() - ii->getFirstRow());
+    EXPECT_EQ(Scalar(16), ii->sum(Rect(3, 2, 4, 4)));
+}
+
+TEST(Imgproc_IntegralImage_Rolling, rowCounterOverflow)
+{
+    const int window = 8;
+    const int64 start = (int64)INT_MAX - 20;
+    RNG& rng = theRNG();
+    Mat img(64, 13, CV_8UC1);
+    randu(img, 0, 256);
+
+    Ptr<IntegralImage> ii = createIntegralImage(INTEGRAL_SQSUM, -1, -1, window);
+    EXPECT_THROW(createIntegralImage()->setRows(start), cv::Exception);
+    ii->setRows(start);
+    EXPECT_EQ(start, ii->getRows());
+    EXPECT_EQ(start, ii->getFirstRow());
+    for (int y = 0; y < img.rows; y++)
+    {
+        ii->append(img.row(y));
+        SCOPED_TRACE(cv::format("row=%d", y));
+        // the counters pass INT_MAX without wrapping around
+        ASSERT_EQ(start + y + 1, ii->getRows());
+        ASSERT_EQ(start + std::max(y + 1 - window, 0), ii->getFirstRow());
+
+        int first = std::max(y + 1 - window, 0);
+        int y0 = rng.uniform(first, y + 1), y1 = rng.uniform(y0, y + 2);
+        Rect r(2, y0, 7, y1 - y0);
+        Scalar expected = cv::sum(img(r));
+        r.y -= first;
+        ASSERT_EQ(expected, ii->sum(r));
+    }
+    EXPECT_GT(ii->getFirstRow(), (int64)INT_MAX);
+}
+
+}} // namespace
@@ -402,4 +402,55 @@ TEST_F(Imgproc_LSD_Common, compareSegmentsVec4i)
     ASSERT_EQ(result2, 11);
 }
 
+TEST(Imgproc_LSD, tiles)
+{
+    // the image is large enough for the regions to be grown in tiles
+    Mat image(1500, 1600, CV_8UC1, Scalar::all(40));
+    RNG rng(LSD_TEST_SEED);
+    std::vector<Vec4i> drawn;
+    for (int i = 0; i < 25; i++)
+    {
+        Point b(rng.uniform(0, image.cols), rng.uniform(0, image.rows));
+        Point e(rng.uniform(0, image.cols), rng.uniform(0, image.rows));
+        if (cv::norm(b - e) < 400)
+            continue;
+        line(image, b, e, Scalar::all(200), 5);
+        drawn.push_back(Vec4i(b.x, b.y, e.x, e.y));
+    }
+    Mat noise(image.size(), CV_8UC1);
+    rng.fill(noise, RNG::UNIFORM, 0, 8);
+    image += noise;
+
+    Ptr<LineSegmentDetector> detector = createLineSegmentDetector(LSD_REFINE_STD);
+    const int nthreads = getNumThreads();
+    std::vector<Vec4f> lines1, lines;
+    setNumThreads(1);
+    detector->detect(image, lines1);
+    setNumThreads(nthreads > 1 ? nthreads : 4);
+    detector->detect(image, lines);
+    setNumThreads(nthreads);
+
+    // the tiling does not depend on the number of threads
+    ASSERT_EQ(lines1.size(), lines.size());
+    for (size_t i = 0; i < lines.size(); i++)
+        EXPECT_EQ(lines1[i], lines[i]);
+
+    // both edges of every drawn line crossing several tiles are found, possibly split at the crossings
+    for (size_t i = 0; i < drawn.size(); i++)
+    {
+        Point2f b((float)drawn[i][0], (float)drawn[i][1]), e((float)drawn[i][2], (float)drawn[i][3]);
+        Point2f dir = (e - b) * (1.f / (float)cv::norm(e - b));
+        double covered = 0;
+        for (size_t j = 0; j < lines.size(); j++)
+        {
+            Point2f p1(lines[j][0], lines[j][1]), p2(lines[j][2], lines[j][3]);
+            // distance of the segment ends to the drawn line
+            float d1 = std::abs((p1 - b).cross(dir)), d2 = std::abs((p2 - b).cross(dir));
+            if (d1 < 5 && d2 < 5)
+                covered += cv::norm(p2 - p1);
+        }
+        EXPECT_GT(covered, 1.5 * cv::norm(e - b)) << "line " << i;
+    }
+}
+
 }} // namespace
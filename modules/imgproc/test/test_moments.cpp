@@ -440,4 +440,113 @@ protected:
 
 TEST(Imgproc_ContourMoment, small) { CV_SmallContourMomentTest test; test.safe_run(); }
 
+TEST(Imgproc_Moments, parallel)
+{
+    Mat img(1200, 1000, CV_8UC1);
+    randu(img, 0, 256);
+    const int nthreads = getNumThreads();
+    for (int binary = 0; binary < 2; binary++)
+    {
+        setNumThreads(1);
+        Moments ref = moments(img, binary != 0);
+        setNumThreads(nthreads > 1 ? nthreads : 4);
+        Moments m = moments(img, binary != 0);
+        setNumThreads(nthreads);
+
+        // the tile rows are summed in the same order regardless of the number of threads
+        const double* pref = &ref.m00;
+        const double* pm = &m.m00;
+        for (int i = 0; i < (int)(sizeof(Moments)/sizeof(double)); i++)
+            EXPECT_EQ(pref[i], pm[i]) << "binary=" << binary << " i=" << i;
+    }
+}
+
+static void checkMoments(const Moments& ref, const Moments& m, double eps)
+{
+    const double* pref = &ref.m00;
+    const double* pm = &m.m00;
+    // spatial and central moments
+    for (int i = 0; i < 17; i++)
+        EXPECT_LE(std::abs(pref[i] - pm[i]), eps*std::max(std::abs(pref[i]), 1.)) << "i=" << i;
+}
+
+TEST(Imgproc_Moments, contoursMoments)
+{
+    Mat img = Mat::zeros(480, 640, CV_8UC1);
+    RNG& rng = theRNG();
+    for (int i = 0; i < 60; i++)
+    {
+        Point c(rng.uniform(0, img.cols), rng.uniform(0, img.rows));
+        ellipse(img, c, Size(rng.uniform(2, 40), rng.uniform(2, 40)), rng.uniform(0, 180), 0, 360, Scalar::all(255), FILLED);
+    }
+    std::vector<std::vector<Point> > contours;
+    findContours(img, contours, RETR_LIST, CHAIN_APPROX_SIMPLE);
+    contours.push_back(std::vector<Point>());
+    ASSERT_GT(contours.size(), 10u);
+
+    std::vector<Moments> ms;
+    std::vector<Rect> rects;
+    contoursMoments(contours, ms, rects);
+    ASSERT_EQ(contours.size(), ms.size());
+    ASSERT_EQ(contours.size(), rects.size());
+    for (size_t i = 0; i < contours.size(); i++)
+    {
+        SCOPED_TRACE(cv::format("contour %d", (int)i));
+        Moments ref = moments(contours[i]);
+        checkMoments(ref, ms[i], 0);
+        EXPECT_EQ(contours[i].empty() ? Rect() : boundingRect(contours[i]), rects[i]);
+    }
+}
+
+TEST(Imgproc_Moments, labelsMoments)
+{
+    Mat img = Mat::zeros(400, 600, CV_8UC1);
+    RNG& rng = theRNG();
+    for (int i = 0; i < 40; i++)
+    {
+        Point c(rng.uniform(0, img.cols), rng.uniform(0, img.rows));
+        circle(img, c, rng.uniform(1, 30), Scalar::all(255), FILLED);
+    }
+
+    img.row(0).setTo(0);
+    img(Rect(0, 0, 5, 5)).setTo(0);
+
+    Mat labels, stats, centroids;
+    int n = connectedComponentsWithStats(img, labels, stats, centroids, 8, CV_32S);
+    // a label outside of the range is ignored
+    labels(Rect(0, 0, 5, 5)).setTo(-1);
+
+    std::vector<Moments> ms;
+    std::vector<Rect> rects;
+    labelsMoments(labels, ms, rects);
+    ASSERT_EQ((size_t)n, ms.size());
+    ASSERT_EQ((size_t)n, rects.size());
+
+    for (int l = 0; l < n; l++)
+    {
+        SCOPED_TRACE(cv::format("label %d", l));
+        Mat mask = labels == l;
+        Moments ref = moments(mask, true);
+        checkMoments(ref, ms[l], 1e-9);
+        EXPECT_EQ(boundingRect(mask), rects[l]);
+        if (l > 0)
+        {
+            EXPECT_EQ(stats.at<int>(l, CC_STAT_AREA), cvRound(ms[l].m00));
+            EXPECT_NEAR(centroids.at<double>(l, 0), ms[l].m10/ms[l].m00, 1e-9);
+            EXPECT_NEAR(centroids.at<double>(l, 1), ms[l].m01/ms[l].m00, 1e-9);
+        }
+    }
+
+    // narrower label types and an explicit number of labels
+    Mat labels16;
+    labels.setTo(0, labels < 0);
+    labels.convertTo(labels16, CV_16U);
+    std::vector<Moments> ms16;
+    labelsMoments(labels16, ms16, noArray(), n + 2);
+    ASSERT_EQ((size_t)n + 2, ms16.size());
+    for (int l = 1; l < n; l++)
+        checkMoments(ms[l], ms16[l], 1e-12);
+    EXPECT_EQ(0., ms16[n + 1].m00);
+}
+
 }} // namespace
@@ -425,4 +425,74 @@ TEST(Imgproc_MatchTemplate, bug_9597) {
         cv::minMaxLoc(result, &minValue, NULL, NULL, NULL);
         ASSERT_GE(minValue, 0);
 }
+
+TEST(Imgproc_TemplateMatcher, accuracy)
+{
+    const int types[] = { CV_8UC1, CV_8UC3, CV_32FC1, CV_32FC3 };
+    RNG& rng = theRNG();
+    for (size_t ti = 0; ti < sizeof(types)/sizeof(types[0]); ti++)
+    {
+        int type = types[ti];
+        std::vector<Mat> templs(3);
+        templs[0].create(17, 23, type);
+        templs[1].create(40, 9, type);
+        templs[2].create(64, 64, type);
+        for (size_t i = 0; i < templs.size(); i++)
+            cvtest::randUni(rng, templs[i], Scalar::all(0), Scalar::all(255));
+
+        for (int method = TM_SQDIFF; method <= TM_CCOEFF_NORMED; method++)
+        {
+            SCOPED_TRACE(cv::format("type=%s method=%d", typeToString(type).c_str(), method));
+            Ptr<TemplateMatcher> matcher = createTemplateMatcher(templs, method);
+            ASSERT_EQ(3, matcher->getTemplatesCount());
+            ASSERT_EQ(method, matcher->getMethod());
+
+            // the second frame of the same size reuses the spectra, the third one has a different size
+            const Size sizes[] = { Size(700, 523), Size(700, 523), Size(301, 90) };
+            for (int k = 0; k < 3; k++)
+            {
+                Mat img(sizes[k], type);
+                cvtest::randUni(rng, img, Scalar::all(0), Scalar::all(255));
+                // the template is present in the image
+                templs[2].copyTo(img(Rect(31, 17, templs[2].cols, templs[2].rows)));
+
+                std::vector<Mat> results;
+                matcher->matchAll(img, results);
+                ASSERT_EQ(templs.size(), results.size());
+                for (size_t i = 0; i < templs.size(); i++)
+                {
+                    Mat ref, result;
+                    cv::matchTemplate(img, templs[i], ref, method);
+                    matcher->match(img, result, (int)i);
+                    // the unnormalized scores are differences of float sums bounded by area*cn*255^2
+                    double eps = method == TM_SQDIFF_NORMED || method == TM_CCORR_NORMED || method == TM_CCOEFF_NORMED ?
+                        1e-4 : 1e-6 * templs[i].total() * templs[i].channels() * 255 * 255;
+                    EXPECT_LE(cvtest::norm(ref, results[i], NORM_INF), eps) << "template " << i;
+                    EXPECT_LE(cvtest::norm(ref, result, NORM_INF), eps) << "template " << i;
+                }
+            }
+        }
+    }
+}
+
+TEST(Imgproc_TemplateMatcher, single)
+{
+    Mat img(480, 640, CV_8UC1), templ;
+    randu(img, 0, 256);
+    img(Rect(100, 200, 32, 24)).copyTo(templ);
+
+    Ptr<TemplateMatcher> matcher = createTemplateMatcher(templ, TM_CCOEFF_NORMED);
+    ASSERT_EQ(1, matcher->getTemplatesCount());
+    Mat result;
+    matcher->match(img, result);
+    ASSERT_EQ(Size(640 - 32 + 1, 480 - 24 + 1), result.size());
+    Point maxLoc;
+    cv::minMaxLoc(result, 0, 0, 0, &maxLoc);
+    EXPECT_EQ(Point(100, 200), maxLoc);
+
+    EXPECT_THROW(matcher->match(img, result, 1), cv::Exception);
+    EXPECT_THROW(matcher->match(Mat(480, 640, CV_32FC1), result), cv::Exception);
+    EXPECT_THROW(matcher->match(img(Rect(0, 0, 31, 100)), result), cv::Exception);
+}
+
 } // namespace
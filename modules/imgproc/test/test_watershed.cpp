@@ -128,3 +128,107 @@ TEST(Imgproc_Watershed, regression) { CV_WatershedTest test; test.safe_run(); }
 }} // namespace
 
 #endif
+
+namespace opencv_test { namespace {
+
+static void makeSegmentationInput(Size size, Mat& img, Mat& markers, int nseeds)
+{
+    RNG& rng = theRNG();
+    img.create(size, CV_8UC3);
+    randu(img, Scalar::all(0), Scalar::all(256));
+    GaussianBlur(img, img, Size(0, 0), 3);
+    markers = Mat::zeros(size, CV_32SC1);
+    for (int i = 1; i <= nseeds; i++)
+        circle(markers, Point(rng.uniform(0, size.width), rng.uniform(0, size.height)), 3, Scalar::all(i), FILLED);
+}
+
+TEST(Imgproc_Watershed, batch)
+{
+    std::vector<Mat> imgs(5), markers(5), ref(5);
+    for (size_t i = 0; i < imgs.size(); i++)
+    {
+        makeSegmentationInput(Size(160 + (int)i*17, 120), imgs[i], markers[i], 10);
+        ref[i] = markers[i].clone();
+        cv::watershed(imgs[i], ref[i]);
+    }
+
+    cv::watershed(imgs, markers);
+    for (size_t i = 0; i < imgs.size(); i++)
+        EXPECT_EQ(0, cvtest::norm(ref[i], markers[i], NORM_INF)) << "image " << i;
+
+    std::vector<Mat> wrong(4);
+    EXPECT_THROW(cv::watershed(imgs, wrong), cv::Exception);
+}
+
+// straightforward meanshift on a single layer
+static void meanShiftReference(const Mat& src, Mat& dst, int sp, double sr, int maxIter, double eps)
+{
+    int isr2 = cvRound(sr*sr);
+    dst.create(src.size(), src.type());
+    for (int i = 0; i < src.rows; i++)
+    {
+        for (int j = 0; j < src.cols; j++)
+        {
+            int x0 = j, y0 = i;
+            Vec3b c = src.at<Vec3b>(i, j);
+            int c0 = c[0], c1 = c[1], c2 = c[2];
+            for (int iter = 0; iter < maxIter; iter++)
+            {
+                int s0 = 0, s1 = 0, s2 = 0, sx = 0, sy = 0, count = 0;
+                for (int y = std::max(y0 - sp, 0); y <= std::min(y0 + sp, src.rows - 1); y++)
+                {
+                    for (int x = std::max(x0 - sp, 0); x <= std::min(x0 + sp, src.cols - 1); x++)
+                    {
+                        Vec3b t = src.at<Vec3b>(y, x);
+                        int d0 = t[0] - c0, d1 = t[1] - c1, d2 = t[2] - c2;
+                        if (d0*d0 + d1*d1 + d2*d2 <= isr2)
+                        {
+                            s0 += t[0]; s1 += t[1]; s2 += t[2];
+                            sx += x; sy += y; count++;
+                        }
+                    }
+                }
+                if (count == 0)
+                    break;
+                double icount = 1./count;
+                int x1 = cvRound(sx*icount), y1 = cvRound(sy*icount);
+                s0 = cvRound(s0*icount); s1 = cvRound(s1*icount); s2 = cvRound(s2*icount);
+                bool stop = (x0 == x1 && y0 == y1) || std::abs(x1 - x0) + std::abs(y1 - y0) +
+                    (s0 - c0)*(s0 - c0) + (s1 - c1)*(s1 - c1) + (s2 - c2)*(s2 - c2) <= eps;
+                x0 = x1; y0 = y1;
+                c0 = s0; c1 = s1; c2 = s2;
+                if (stop)
+                    break;
+            }
+            dst.at<Vec3b>(i, j) = Vec3b((uchar)c0, (uchar)c1, (uchar)c2);
+        }
+    }
+}
+
+TEST(Imgproc_PyrMeanShiftFiltering, reference)
+{
+    Mat img, markers, ref, dst;
+    makeSegmentationInput(Size(97, 83), img, markers, 0);
+    TermCriteria termcrit(TermCriteria::MAX_ITER + TermCriteria::EPS, 5, 1);
+
+    meanShiftReference(img, ref, 12, 20, termcrit.maxCount, termcrit.epsilon);
+    cv::pyrMeanShiftFiltering(img, dst, 12, 20, 0, termcrit);
+    EXPECT_EQ(0, cvtest::norm(ref, dst, NORM_INF));
+}
+
+TEST(Imgproc_PyrMeanShiftFiltering, parallel)
+{
+    Mat img, markers, ref, dst;
+    makeSegmentationInput(Size(320, 240), img, markers, 0);
+
+    const int nthreads = getNumThreads();
+    setNumThreads(1);
+    cv::pyrMeanShiftFiltering(img, ref, 10, 25, 2);
+    setNumThreads(nthreads > 1 ? nthreads : 4);
+    cv::pyrMeanShiftFiltering(img, dst, 10, 25, 2);
+    setNumThreads(nthreads);
+
+    EXPECT_EQ(0, cvtest::norm(ref, dst, NORM_INF));
+}
+
+}} // namespace